@@ -0,0 +1,137 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+/**
+ * Arduino核心API的主机(native)实现
+ * 提供项目用到的接口子集：String/Stream/Serial、时间、GPIO、LEDC、硬件定时器、
+ * FreeRTOS互斥量以及ESP对象。时间和外设均由NativeHAL模拟。
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+
+using std::min;
+using std::max;
+
+// ==========================
+// 通用宏
+// ==========================
+#define IRAM_ATTR
+#define ARDUINO_ISR_ATTR
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT          0x01
+#define OUTPUT         0x03
+#define PULLUP         0x04
+#define INPUT_PULLUP   0x05
+#define PULLDOWN       0x08
+#define INPUT_PULLDOWN 0x09
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+template <typename T, typename L, typename H>
+inline T constrain(T value, L low, H high) {
+    return value < low ? static_cast<T>(low) : (value > high ? static_cast<T>(high) : value);
+}
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// ==========================
+// 时间
+// ==========================
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// ==========================
+// GPIO
+// ==========================
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+// ==========================
+// LEDC PWM (esp32-hal-ledc)
+// ==========================
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolutionBits);
+void ledcWrite(uint8_t channel, uint32_t duty);
+uint32_t ledcRead(uint8_t channel);
+uint32_t ledcReadFreq(uint8_t channel);
+uint32_t ledcChangeFrequency(uint8_t channel, uint32_t freq, uint8_t resolutionBits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcDetachPin(uint8_t pin);
+
+// ==========================
+// 硬件定时器 (esp32-hal-timer)
+// ==========================
+struct hw_timer_s;
+typedef struct hw_timer_s hw_timer_t;
+
+hw_timer_t* timerBegin(uint8_t num, uint16_t divider, bool countUp);
+void timerEnd(hw_timer_t* timer);
+void timerAttachInterrupt(hw_timer_t* timer, void (*fn)(void), bool edge);
+void timerDetachInterrupt(hw_timer_t* timer);
+void timerAlarmWrite(hw_timer_t* timer, uint64_t alarmValue, bool autoreload);
+void timerAlarmEnable(hw_timer_t* timer);
+void timerAlarmDisable(hw_timer_t* timer);
+bool timerAlarmEnabled(hw_timer_t* timer);
+void timerRestart(hw_timer_t* timer);
+uint64_t timerRead(hw_timer_t* timer);
+void timerWrite(hw_timer_t* timer, uint64_t value);
+
+// ==========================
+// 芯片相关
+// ==========================
+bool setCpuFrequencyMhz(uint32_t cpuFreqMhz);
+uint32_t getCpuFrequencyMhz();
+float temperatureRead();
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+class EspClass {
+public:
+    uint32_t getHeapSize();
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getCpuFreqMHz() { return getCpuFrequencyMhz(); }
+    // x86上为TSC计数，其他平台为纳秒数
+    uint32_t getCycleCount();
+    const char* getChipModel() { return "ESP32-S3 (native)"; }
+    const char* getSdkVersion() { return "native"; }
+    void restart();
+};
+
+extern EspClass ESP;
+
+// Arduino入口
+void setup();
+void loop();
+
+#endif // NATIVE_ARDUINO_H
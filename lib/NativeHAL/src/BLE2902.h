@@ -0,0 +1,22 @@
+#ifndef NATIVE_BLE_2902_H
+#define NATIVE_BLE_2902_H
+
+#include "BLEDevice.h"
+
+/**
+ * 客户端特征值配置描述符(CCCD)
+ */
+class BLE2902 : public BLEDescriptor {
+public:
+    BLE2902() : BLEDescriptor("2902") {}
+    void setNotifications(bool flag) { notifications = flag; }
+    bool getNotifications() const { return notifications; }
+    void setIndications(bool flag) { indications = flag; }
+    bool getIndications() const { return indications; }
+
+private:
+    bool notifications = false;
+    bool indications = false;
+};
+
+#endif // NATIVE_BLE_2902_H
@@ -0,0 +1,459 @@
+#include "BLEDevice.h"
+#include "NativeHAL.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace {
+
+const uint16_t BLE_DEFAULT_MTU = 23;
+const uint16_t BLE_MAX_MTU = 517;
+const uint16_t ATT_HEADER_SIZE = 3;
+const esp_gatt_if_t NATIVE_GATTS_IF = 3;   // 仿真服务端注册的GATT接口
+
+std::recursive_mutex g_bleMutex;
+bool g_initialized = false;
+std::string g_deviceName;
+BLEServer* g_server = nullptr;
+BLEAdvertising g_advertising;
+uint16_t g_localMTU = BLE_DEFAULT_MTU;
+bool g_connected = false;
+uint16_t g_peerMTU = BLE_DEFAULT_MTU;
+std::vector<NativeHAL::BLENotification> g_notifications;
+uint16_t g_nextHandle = 1;
+gatts_event_handler g_customGattsHandler = nullptr;
+
+/**
+ * 当前连接下单个ATT包可承载的最大负载
+ */
+size_t maxAttributePayload() {
+    return static_cast<size_t>(g_peerMTU - ATT_HEADER_SIZE);
+}
+
+/**
+ * 与Arduino BLE库一致：服务端处理GATT事件之后调用自定义处理函数
+ */
+void dispatchCustomGattsEvent(esp_gatts_cb_event_t event, esp_ble_gatts_cb_param_t* param) {
+    gatts_event_handler handler;
+    {
+        std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+        handler = g_customGattsHandler;
+    }
+    if (handler) {
+        handler(event, NATIVE_GATTS_IF, param);
+    }
+}
+
+} // namespace
+
+// ==========================
+// BLECharacteristic
+// ==========================
+BLECharacteristic::BLECharacteristic(const char* uuid, uint32_t properties)
+    : uuid(uuid ? uuid : ""), properties(properties) {
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    handle = g_nextHandle++;
+}
+
+BLECharacteristic::~BLECharacteristic() {
+    for (auto* descriptor : descriptors) {
+        delete descriptor;
+    }
+}
+
+void BLECharacteristic::setValue(const uint8_t* data, size_t length) {
+    setValue(std::string(reinterpret_cast<const char*>(data), length));
+}
+
+void BLECharacteristic::setValue(const std::string& newValue) {
+    // 与Arduino BLE库一致：超过ESP_GATT_MAX_ATTR_LEN时记录错误，特征值不变
+    if (newValue.size() > ESP_GATT_MAX_ATTR_LEN) {
+        printf("[NativeHAL] BLECharacteristic::setValue: 长度%u超过%u，已忽略\n",
+               static_cast<unsigned>(newValue.size()), static_cast<unsigned>(ESP_GATT_MAX_ATTR_LEN));
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    value = newValue;
+}
+
+void BLECharacteristic::setValue(const char* newValue) {
+    setValue(std::string(newValue ? newValue : ""));
+}
+
+void BLECharacteristic::setValue(uint16_t& data16) {
+    setValue(reinterpret_cast<const uint8_t*>(&data16), sizeof(data16));
+}
+
+void BLECharacteristic::setValue(uint32_t& data32) {
+    setValue(reinterpret_cast<const uint8_t*>(&data32), sizeof(data32));
+}
+
+void BLECharacteristic::setValue(int& data32) {
+    setValue(reinterpret_cast<const uint8_t*>(&data32), sizeof(data32));
+}
+
+void BLECharacteristic::setValue(float& data32) {
+    setValue(reinterpret_cast<const uint8_t*>(&data32), sizeof(data32));
+}
+
+void BLECharacteristic::notify(bool isNotification) {
+    (void)isNotification;
+    BLECharacteristicCallbacks* callbacks = nullptr;
+    {
+        std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+        if (!g_connected) {
+            return;
+        }
+        // 与空口一致：超出 MTU-3 的部分被截断
+        std::string payload = value.substr(0, maxAttributePayload());
+        g_notifications.push_back({uuid, payload, NativeHAL::nowMicros()});
+        callbacks = pCallbacks;
+    }
+    if (callbacks) {
+        callbacks->onNotify(this);
+    }
+}
+
+void BLECharacteristic::addDescriptor(BLEDescriptor* descriptor) {
+    if (descriptor) {
+        descriptors.push_back(descriptor);
+    }
+}
+
+// ==========================
+// BLEService
+// ==========================
+BLEService::~BLEService() {
+    for (auto* characteristic : characteristics) {
+        delete characteristic;
+    }
+}
+
+BLECharacteristic* BLEService::createCharacteristic(const char* uuid, uint32_t properties) {
+    BLECharacteristic* characteristic = new BLECharacteristic(uuid, properties);
+    characteristics.push_back(characteristic);
+    return characteristic;
+}
+
+BLECharacteristic* BLEService::getCharacteristicByHandle(uint16_t handle) {
+    for (auto* characteristic : characteristics) {
+        if (characteristic->getHandle() == handle) {
+            return characteristic;
+        }
+    }
+    return nullptr;
+}
+
+BLECharacteristic* BLEService::getCharacteristic(const char* uuid) {
+    if (!uuid) return nullptr;
+    for (auto* characteristic : characteristics) {
+        if (characteristic->getUUIDString() == uuid) {
+            return characteristic;
+        }
+    }
+    return nullptr;
+}
+
+// ==========================
+// BLEServer
+// ==========================
+BLEServer::~BLEServer() {
+    for (auto* service : services) {
+        delete service;
+    }
+}
+
+BLEService* BLEServer::createService(const char* uuid) {
+    BLEService* service = new BLEService(uuid);
+    services.push_back(service);
+    return service;
+}
+
+BLEService* BLEServer::getServiceByUUID(const char* uuid) {
+    if (!uuid) return nullptr;
+    for (auto* service : services) {
+        if (service->getUUIDString() == uuid) {
+            return service;
+        }
+    }
+    return nullptr;
+}
+
+BLECharacteristic* BLEServer::findCharacteristic(const char* uuid) {
+    for (auto* service : services) {
+        BLECharacteristic* characteristic = service->getCharacteristic(uuid);
+        if (characteristic) {
+            return characteristic;
+        }
+    }
+    return nullptr;
+}
+
+BLECharacteristic* BLEServer::findCharacteristic(uint16_t handle) {
+    for (auto* service : services) {
+        BLECharacteristic* characteristic = service->getCharacteristicByHandle(handle);
+        if (characteristic) {
+            return characteristic;
+        }
+    }
+    return nullptr;
+}
+
+BLEAdvertising* BLEServer::getAdvertising() {
+    return &g_advertising;
+}
+
+void BLEServer::startAdvertising() {
+    g_advertising.start();
+}
+
+uint32_t BLEServer::getConnectedCount() const {
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    return g_connected ? 1 : 0;
+}
+
+uint16_t BLEServer::getPeerMTU(uint16_t connId) const {
+    (void)connId;
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    return g_peerMTU;
+}
+
+void BLEServer::disconnect(uint16_t connId) {
+    (void)connId;
+    NativeHAL::bleDisconnect();
+}
+
+// ==========================
+// BLEDevice
+// ==========================
+void BLEDevice::init(const std::string& deviceName) {
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    g_deviceName = deviceName;
+    g_initialized = true;
+}
+
+void BLEDevice::deinit(bool releaseMemory) {
+    (void)releaseMemory;
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    g_initialized = false;
+    g_connected = false;
+}
+
+BLEServer* BLEDevice::createServer() {
+    BLEServer* server;
+    {
+        std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+        if (!g_initialized) {
+            return nullptr;
+        }
+        // 与ESP32一致：每个设备只有一个GATT服务端，重复创建时替换旧实例
+        delete g_server;
+        g_server = new BLEServer();
+        server = g_server;
+    }
+    esp_ble_gatts_cb_param_t param;
+    memset(&param, 0, sizeof(param));
+    dispatchCustomGattsEvent(ESP_GATTS_REG_EVT, &param);
+    return server;
+}
+
+BLEServer* BLEDevice::getServer() {
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    return g_server;
+}
+
+BLEAdvertising* BLEDevice::getAdvertising() {
+    return &g_advertising;
+}
+
+void BLEDevice::startAdvertising() {
+    g_advertising.start();
+}
+
+void BLEDevice::stopAdvertising() {
+    g_advertising.stop();
+}
+
+void BLEDevice::setPower(esp_power_level_t powerLevel, esp_ble_power_type_t powerType) {
+    esp_ble_tx_power_set(powerType, powerLevel);
+}
+
+esp_err_t BLEDevice::setMTU(uint16_t mtu) {
+    if (mtu < BLE_DEFAULT_MTU || mtu > BLE_MAX_MTU) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    g_localMTU = mtu;
+    return ESP_OK;
+}
+
+uint16_t BLEDevice::getMTU() {
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    return g_localMTU;
+}
+
+bool BLEDevice::getInitialized() {
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    return g_initialized;
+}
+
+void BLEDevice::setCustomGattsHandler(gatts_event_handler handler) {
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    g_customGattsHandler = handler;
+}
+
+// ==========================
+// GATT服务端API
+// ==========================
+esp_err_t esp_ble_gatts_send_indicate(esp_gatt_if_t gatts_if, uint16_t conn_id, uint16_t attr_handle,
+                                      uint16_t value_len, uint8_t* value, bool need_confirm) {
+    (void)conn_id;
+    (void)need_confirm;
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    if (!g_server || !g_connected || gatts_if != NATIVE_GATTS_IF || (value_len > 0 && !value)) {
+        return ESP_FAIL;
+    }
+    BLECharacteristic* characteristic = g_server->findCharacteristic(attr_handle);
+    if (!characteristic) {
+        return ESP_FAIL;
+    }
+    size_t length = std::min<size_t>(value_len, maxAttributePayload());
+    g_notifications.push_back({characteristic->getUUIDString(),
+                               std::string(reinterpret_cast<const char*>(value), length), NativeHAL::nowMicros()});
+    return ESP_OK;
+}
+
+// ==========================
+// NativeHAL BLE客户端仿真
+// ==========================
+bool NativeHAL::bleConnect(uint16_t mtu) {
+    BLEServer* server;
+    BLEServerCallbacks* callbacks;
+    uint16_t negotiated;
+    {
+        std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+        if (!g_server || g_connected) {
+            return false;
+        }
+        g_connected = true;
+        g_advertising.stop();
+        // 协商结果取双方MTU的较小值
+        negotiated = std::min<uint16_t>(std::max<uint16_t>(mtu, BLE_DEFAULT_MTU), g_localMTU);
+        g_peerMTU = BLE_DEFAULT_MTU;
+        server = g_server;
+        callbacks = g_server->getCallbacks();
+    }
+
+    esp_ble_gatts_cb_param_t param;
+    memset(&param, 0, sizeof(param));
+    if (callbacks) {
+        callbacks->onConnect(server, &param);
+    }
+    dispatchCustomGattsEvent(ESP_GATTS_CONNECT_EVT, &param);
+
+    if (negotiated != BLE_DEFAULT_MTU) {
+        {
+            std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+            g_peerMTU = negotiated;
+        }
+        param.mtu.conn_id = 0;
+        param.mtu.mtu = negotiated;
+        if (callbacks) {
+            callbacks->onMtuChanged(server, &param);
+        }
+        dispatchCustomGattsEvent(ESP_GATTS_MTU_EVT, &param);
+    }
+    return true;
+}
+
+void NativeHAL::bleDisconnect() {
+    BLEServer* server;
+    BLEServerCallbacks* callbacks;
+    {
+        std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+        if (!g_server || !g_connected) {
+            return;
+        }
+        g_connected = false;
+        g_peerMTU = BLE_DEFAULT_MTU;
+        server = g_server;
+        callbacks = g_server->getCallbacks();
+    }
+    if (callbacks) {
+        callbacks->onDisconnect(server);
+    }
+    esp_ble_gatts_cb_param_t param;
+    memset(&param, 0, sizeof(param));
+    dispatchCustomGattsEvent(ESP_GATTS_DISCONNECT_EVT, &param);
+}
+
+bool NativeHAL::bleIsConnected() {
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    return g_connected;
+}
+
+uint16_t NativeHAL::bleGetMTU() {
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    return g_peerMTU;
+}
+
+bool NativeHAL::bleWrite(const char* uuid, const std::string& value) {
+    BLECharacteristic* characteristic;
+    {
+        std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+        if (!g_server || !g_connected) {
+            return false;
+        }
+        characteristic = g_server->findCharacteristic(uuid);
+        if (!characteristic ||
+            !(characteristic->getProperties() &
+              (BLECharacteristic::PROPERTY_WRITE | BLECharacteristic::PROPERTY_WRITE_NR))) {
+            return false;
+        }
+        // 单次写请求最大负载为 MTU-3
+        if (value.size() > maxAttributePayload()) {
+            return false;
+        }
+    }
+    characteristic->setValue(value);
+    if (characteristic->getCallbacks()) {
+        characteristic->getCallbacks()->onWrite(characteristic);
+    }
+    return true;
+}
+
+std::string NativeHAL::bleRead(const char* uuid) {
+    BLECharacteristic* characteristic;
+    {
+        std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+        if (!g_server || !g_connected) {
+            return std::string();
+        }
+        characteristic = g_server->findCharacteristic(uuid);
+        if (!characteristic || !(characteristic->getProperties() & BLECharacteristic::PROPERTY_READ)) {
+            return std::string();
+        }
+    }
+    if (characteristic->getCallbacks()) {
+        characteristic->getCallbacks()->onRead(characteristic);
+    }
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    // 单次读响应最大负载为 MTU-1，更长的值需要Read Blob，这里不做模拟
+    return characteristic->getValue().substr(0, static_cast<size_t>(g_peerMTU - 1));
+}
+
+std::vector<NativeHAL::BLENotification> NativeHAL::bleTakeNotifications() {
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    std::vector<BLENotification> result;
+    result.swap(g_notifications);
+    return result;
+}
+
+void NativeHAL::bleReset() {
+    std::lock_guard<std::recursive_mutex> lock(g_bleMutex);
+    g_connected = false;
+    g_peerMTU = BLE_DEFAULT_MTU;
+    g_notifications.clear();
+}
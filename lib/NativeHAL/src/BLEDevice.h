@@ -0,0 +1,179 @@
+#ifndef NATIVE_BLE_DEVICE_H
+#define NATIVE_BLE_DEVICE_H
+
+/**
+ * ESP32 BLE库的主机实现
+ * 接口与Arduino-ESP32 BLE库保持一致，客户端行为由NativeHAL::ble*()模拟
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "esp_bt.h"
+#include "esp_gatts_api.h"
+
+class BLEServer;
+class BLEService;
+class BLECharacteristic;
+class BLEAdvertising;
+
+typedef void (*gatts_event_handler)(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_if,
+                                    esp_ble_gatts_cb_param_t* param);
+
+/**
+ * 特征值描述符
+ */
+class BLEDescriptor {
+public:
+    explicit BLEDescriptor(const char* uuid) : uuid(uuid ? uuid : "") {}
+    virtual ~BLEDescriptor() = default;
+    std::string getUUIDString() const { return uuid; }
+
+private:
+    std::string uuid;
+};
+
+class BLECharacteristicCallbacks {
+public:
+    virtual ~BLECharacteristicCallbacks() = default;
+    virtual void onRead(BLECharacteristic* pCharacteristic) { (void)pCharacteristic; }
+    virtual void onWrite(BLECharacteristic* pCharacteristic) { (void)pCharacteristic; }
+    virtual void onNotify(BLECharacteristic* pCharacteristic) { (void)pCharacteristic; }
+};
+
+class BLECharacteristic {
+public:
+    static const uint32_t PROPERTY_READ      = 1 << 0;
+    static const uint32_t PROPERTY_WRITE     = 1 << 1;
+    static const uint32_t PROPERTY_NOTIFY    = 1 << 2;
+    static const uint32_t PROPERTY_BROADCAST = 1 << 3;
+    static const uint32_t PROPERTY_INDICATE  = 1 << 4;
+    static const uint32_t PROPERTY_WRITE_NR  = 1 << 5;
+
+    BLECharacteristic(const char* uuid, uint32_t properties = 0);
+    virtual ~BLECharacteristic();
+
+    void setValue(const uint8_t* data, size_t length);
+    void setValue(const std::string& value);
+    void setValue(const char* value);
+    void setValue(uint16_t& data16);
+    void setValue(uint32_t& data32);
+    void setValue(int& data32);
+    void setValue(float& data32);
+
+    std::string getValue() const { return value; }
+    uint8_t* getData() { return reinterpret_cast<uint8_t*>(&value[0]); }
+    size_t getLength() const { return value.size(); }
+
+    void notify(bool isNotification = true);
+    void indicate() { notify(false); }
+
+    void setCallbacks(BLECharacteristicCallbacks* callbacks) { pCallbacks = callbacks; }
+    BLECharacteristicCallbacks* getCallbacks() const { return pCallbacks; }
+    void addDescriptor(BLEDescriptor* descriptor);
+
+    std::string getUUIDString() const { return uuid; }
+    uint32_t getProperties() const { return properties; }
+    uint16_t getHandle() const { return handle; }
+
+private:
+    std::string uuid;
+    uint32_t properties;
+    uint16_t handle;
+    std::string value;
+    BLECharacteristicCallbacks* pCallbacks = nullptr;
+    std::vector<BLEDescriptor*> descriptors;
+};
+
+class BLEService {
+public:
+    explicit BLEService(const char* uuid) : uuid(uuid ? uuid : "") {}
+    ~BLEService();
+
+    BLECharacteristic* createCharacteristic(const char* uuid, uint32_t properties);
+    BLECharacteristic* getCharacteristic(const char* uuid);
+    BLECharacteristic* getCharacteristicByHandle(uint16_t handle);
+    void start() { started = true; }
+    void stop() { started = false; }
+    bool isStarted() const { return started; }
+    std::string getUUIDString() const { return uuid; }
+
+private:
+    std::string uuid;
+    bool started = false;
+    std::vector<BLECharacteristic*> characteristics;
+};
+
+class BLEServerCallbacks {
+public:
+    virtual ~BLEServerCallbacks() = default;
+    virtual void onConnect(BLEServer* pServer) { (void)pServer; }
+    virtual void onConnect(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) { (void)param; onConnect(pServer); }
+    virtual void onDisconnect(BLEServer* pServer) { (void)pServer; }
+    virtual void onMtuChanged(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) { (void)pServer; (void)param; }
+};
+
+class BLEServer {
+public:
+    BLEServer() = default;
+    ~BLEServer();
+
+    BLEService* createService(const char* uuid);
+    BLEService* getServiceByUUID(const char* uuid);
+    void setCallbacks(BLEServerCallbacks* callbacks) { pCallbacks = callbacks; }
+    BLEServerCallbacks* getCallbacks() const { return pCallbacks; }
+    BLEAdvertising* getAdvertising();
+    void startAdvertising();
+    uint32_t getConnectedCount() const;
+    uint16_t getConnId() const { return 0; }
+    uint16_t getPeerMTU(uint16_t connId) const;
+    void disconnect(uint16_t connId);
+
+    /**
+     * 按UUID在所有服务中查找特征值（仿真用）
+     */
+    BLECharacteristic* findCharacteristic(const char* uuid);
+    BLECharacteristic* findCharacteristic(uint16_t handle);
+
+private:
+    BLEServerCallbacks* pCallbacks = nullptr;
+    std::vector<BLEService*> services;
+};
+
+class BLEAdvertising {
+public:
+    void addServiceUUID(const char* uuid) { serviceUUIDs.push_back(uuid ? uuid : ""); }
+    void setScanResponse(bool enabled) { scanResponse = enabled; }
+    void setMinPreferred(uint16_t value) { (void)value; }
+    void setMaxPreferred(uint16_t value) { (void)value; }
+    void setMinInterval(uint16_t value) { minInterval = value; }
+    void setMaxInterval(uint16_t value) { maxInterval = value; }
+    void start() { advertising = true; }
+    void stop() { advertising = false; }
+    bool isAdvertising() const { return advertising; }
+
+private:
+    std::vector<std::string> serviceUUIDs;
+    bool scanResponse = false;
+    uint16_t minInterval = 0;
+    uint16_t maxInterval = 0;
+    bool advertising = false;
+};
+
+class BLEDevice {
+public:
+    static void init(const std::string& deviceName);
+    static void deinit(bool releaseMemory = false);
+    static BLEServer* createServer();
+    static BLEServer* getServer();
+    static BLEAdvertising* getAdvertising();
+    static void startAdvertising();
+    static void stopAdvertising();
+    static void setPower(esp_power_level_t powerLevel, esp_ble_power_type_t powerType = ESP_BLE_PWR_TYPE_DEFAULT);
+    static esp_err_t setMTU(uint16_t mtu);
+    static uint16_t getMTU();
+    static bool getInitialized();
+    static void setCustomGattsHandler(gatts_event_handler handler);
+};
+
+#endif // NATIVE_BLE_DEVICE_H
@@ -0,0 +1,6 @@
+#ifndef NATIVE_BLE_UTILS_H
+#define NATIVE_BLE_UTILS_H
+
+#include "BLEDevice.h"
+
+#endif // NATIVE_BLE_UTILS_H
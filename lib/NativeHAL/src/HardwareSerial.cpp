@@ -0,0 +1,173 @@
+#include "HardwareSerial.h"
+#include "NativeHAL.h"
+
+#include <cstdio>
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+HardwareSerial::HardwareSerial(uint8_t uartNum)
+    : uartNum(uartNum), baudRate(115200), lastRxArrivalUs(0), txBusyUntilUs(0) {
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin) {
+    (void)config;
+    (void)rxPin;
+    (void)txPin;
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    baudRate = baud > 0 ? baud : 115200;
+}
+
+void HardwareSerial::end() {
+    simReset();
+}
+
+uint32_t HardwareSerial::simCharTimeUs() const {
+    // 8N1：1起始位 + 8数据位 + 1停止位
+    return static_cast<uint32_t>((10ULL * 1000000ULL + baudRate - 1) / baudRate);
+}
+
+int HardwareSerial::available() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    uint64_t now = NativeHAL::nowMicros();
+    int count = 0;
+    for (const auto& rx : rxQueue) {
+        if (rx.arrivalUs > now) {
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+int HardwareSerial::read() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (rxQueue.empty() || rxQueue.front().arrivalUs > NativeHAL::nowMicros()) {
+        return -1;
+    }
+    uint8_t value = rxQueue.front().value;
+    rxQueue.pop_front();
+    return value;
+}
+
+int HardwareSerial::peek() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (rxQueue.empty() || rxQueue.front().arrivalUs > NativeHAL::nowMicros()) {
+        return -1;
+    }
+    return rxQueue.front().value;
+}
+
+size_t HardwareSerial::readBytes(uint8_t* buffer, size_t length) {
+    // 与Arduino一致：每个字节等待最多_timeout毫秒
+    size_t count = 0;
+    while (count < length) {
+        uint64_t nextArrival = UINT64_MAX;
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+            if (!rxQueue.empty()) {
+                nextArrival = rxQueue.front().arrivalUs;
+            }
+        }
+        uint64_t deadline = NativeHAL::nowMicros() + static_cast<uint64_t>(_timeout) * 1000ULL;
+        if (nextArrival > deadline) {
+            NativeHAL::waitUntilMicros(deadline);
+            break;
+        }
+        NativeHAL::waitUntilMicros(nextArrival);
+        int value = read();
+        if (value < 0) {
+            break;
+        }
+        buffer[count++] = static_cast<uint8_t>(value);
+    }
+    return count;
+}
+
+size_t HardwareSerial::write(uint8_t byte) {
+    return write(&byte, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (!buffer || size == 0) {
+        return 0;
+    }
+
+    if (uartNum == 0) {
+        fwrite(buffer, 1, size, stdout);
+        return size;
+    }
+
+    TxHandler handler;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        uint64_t now = NativeHAL::nowMicros();
+        uint64_t start = txBusyUntilUs > now ? txBusyUntilUs : now;
+        txBusyUntilUs = start + static_cast<uint64_t>(size) * simCharTimeUs();
+        txLog.insert(txLog.end(), buffer, buffer + size);
+        handler = txHandler;
+    }
+    if (handler) {
+        handler(buffer, size);
+    }
+    return size;
+}
+
+void HardwareSerial::flush() {
+    if (uartNum == 0) {
+        fflush(stdout);
+        return;
+    }
+    uint64_t busyUntil;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        busyUntil = txBusyUntilUs;
+    }
+    // 等待发送移位寄存器清空
+    NativeHAL::waitUntilMicros(busyUntil);
+}
+
+void HardwareSerial::onReceive(OnReceiveCb function, bool onlyOnTimeout) {
+    (void)onlyOnTimeout;
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    onReceiveCallback = function;
+}
+
+void HardwareSerial::simInject(const uint8_t* data, size_t length, uint32_t delayUs) {
+    OnReceiveCb callback;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        // 半双工总线：应答在本端发送结束之后才开始
+        uint64_t start = NativeHAL::nowMicros();
+        if (txBusyUntilUs > start) start = txBusyUntilUs;
+        if (lastRxArrivalUs > start) start = lastRxArrivalUs;
+        start += delayUs;
+
+        uint32_t charTime = simCharTimeUs();
+        for (size_t i = 0; i < length; i++) {
+            start += charTime;
+            rxQueue.push_back({data[i], start});
+        }
+        lastRxArrivalUs = start;
+        callback = onReceiveCallback;
+    }
+    if (callback && length > 0) {
+        callback();
+    }
+}
+
+std::vector<uint8_t> HardwareSerial::simTakeTx() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<uint8_t> result;
+    result.swap(txLog);
+    return result;
+}
+
+void HardwareSerial::simReset() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    rxQueue.clear();
+    txLog.clear();
+    lastRxArrivalUs = 0;
+    txBusyUntilUs = 0;
+}
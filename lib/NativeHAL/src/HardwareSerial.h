@@ -0,0 +1,108 @@
+#ifndef NATIVE_HARDWARE_SERIAL_H
+#define NATIVE_HARDWARE_SERIAL_H
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "Stream.h"
+
+#define SERIAL_8N1 0x800001c
+
+/**
+ * 模拟UART
+ * - 端口0输出到标准输出
+ * - 接收数据由测试注入，并按波特率计算每个字节的到达时间
+ * - 发送数据可交给模拟从机处理（如Modbus从站）
+ */
+class HardwareSerial : public Stream {
+public:
+    /**
+     * 发送数据回调，用于挂接模拟的对端设备
+     */
+    typedef std::function<void(const uint8_t* data, size_t length)> TxHandler;
+    
+    /**
+     * 接收数据回调（与ESP32 Arduino核心一致）
+     */
+    typedef std::function<void(void)> OnReceiveCb;
+    
+    explicit HardwareSerial(uint8_t uartNum);
+    
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+    void end();
+    
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t readBytes(uint8_t* buffer, size_t length) override;
+    using Stream::readBytes;
+    
+    size_t write(uint8_t byte) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    void flush() override;
+    
+    operator bool() const { return true; }
+    
+    /**
+     * 设置接收数据回调；模拟时在注入数据后调用
+     * @param function 回调
+     * @param onlyOnTimeout 仅在接收超时时回调（模拟时忽略）
+     */
+    void onReceive(OnReceiveCb function, bool onlyOnTimeout = false);
+    
+    // === 模拟接口 ===
+    
+    /**
+     * 注入接收数据
+     * @param data 数据
+     * @param length 数据长度
+     * @param delayUs 第一个字节开始传输前的静默时间(微秒)
+     */
+    void simInject(const uint8_t* data, size_t length, uint32_t delayUs = 0);
+    
+    /**
+     * 设置发送数据回调
+     */
+    void simSetTxHandler(TxHandler handler) { txHandler = handler; }
+    
+    /**
+     * 取出并清空已发送数据记录
+     */
+    std::vector<uint8_t> simTakeTx();
+    
+    /**
+     * 清空收发缓冲区
+     */
+    void simReset();
+    
+    /**
+     * 单个字符的传输时间(微秒)，按8N1共10位计算
+     */
+    uint32_t simCharTimeUs() const;
+    
+    unsigned long getBaudRate() const { return baudRate; }
+    
+private:
+    struct RxByte {
+        uint8_t value;
+        uint64_t arrivalUs;     // 该字节完整到达的时间
+    };
+    
+    uint8_t uartNum;
+    unsigned long baudRate;
+    std::deque<RxByte> rxQueue;
+    std::vector<uint8_t> txLog;
+    TxHandler txHandler;
+    OnReceiveCb onReceiveCallback;
+    uint64_t lastRxArrivalUs;
+    uint64_t txBusyUntilUs;
+    mutable std::recursive_mutex mutex;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif // NATIVE_HARDWARE_SERIAL_H
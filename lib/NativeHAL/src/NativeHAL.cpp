@@ -0,0 +1,701 @@
+#include "NativeHAL.h"
+#include "Arduino.h"
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <mutex>
+#include <random>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// ==========================
+// 时钟
+// ==========================
+namespace {
+
+std::atomic<bool> g_virtualClock{false};
+std::atomic<uint64_t> g_virtualMicros{0};
+std::atomic<uint32_t> g_autoAdvanceMicros{0};
+std::atomic<uint64_t> g_realOffsetMicros{0};  // 实时模式相对主机时钟的偏移，保证模式切换时时间不回退
+
+std::atomic<bool> g_exitRequested{false};
+std::atomic<int> g_exitCode{0};
+
+uint64_t realMicros() {
+    // 首次使用时确定起点，避免全局对象构造顺序问题（单例构造函数中可能已调用millis()）
+    static const auto g_realClockStart = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - g_realClockStart).count());
+}
+
+/**
+ * 实时模式下的当前时间
+ */
+uint64_t hostMicros() {
+    return realMicros() + g_realOffsetMicros;
+}
+
+// ==========================
+// GPIO
+// ==========================
+const uint8_t MAX_PINS = 64;
+
+struct PinState {
+    uint8_t mode = INPUT;
+    uint8_t outputLevel = LOW;
+    uint8_t inputLevel = LOW;
+    uint32_t writeCount = 0;
+};
+
+PinState g_pins[MAX_PINS];
+NativeHAL::PinWriteHook g_pinWriteHook;
+std::mutex g_gpioMutex;
+
+// ==========================
+// LEDC
+// ==========================
+const uint8_t LEDC_CHANNELS = 8;
+const uint8_t LEDC_MAX_RESOLUTION_BITS = 14;
+const uint32_t LEDC_SOURCE_CLOCK_HZ = 80000000;
+
+struct LEDCChannelState {
+    uint32_t frequency = 0;     // 0表示未配置
+    uint8_t resolutionBits = 0;
+    uint32_t duty = 0;
+    uint32_t writeCount = 0;
+};
+
+LEDCChannelState g_ledcChannels[LEDC_CHANNELS];
+int8_t g_ledcPinChannel[MAX_PINS];  // 引脚连接的通道，-1为未连接
+bool g_ledcPinMapReady = false;
+NativeHAL::LEDCWriteHook g_ledcWriteHook;
+std::mutex g_ledcMutex;
+
+/**
+ * 引脚-通道映射首次使用时初始化（需持有g_ledcMutex）
+ */
+void ensureLEDCPinMap() {
+    if (!g_ledcPinMapReady) {
+        for (auto& channel : g_ledcPinChannel) {
+            channel = -1;
+        }
+        g_ledcPinMapReady = true;
+    }
+}
+
+/**
+ * 与硬件一致：分频后的计数时钟不能超过源时钟
+ */
+bool validLEDCTiming(uint32_t freq, uint8_t resolutionBits) {
+    return freq > 0 && resolutionBits >= 1 && resolutionBits <= LEDC_MAX_RESOLUTION_BITS &&
+           (static_cast<uint64_t>(freq) << resolutionBits) <= LEDC_SOURCE_CLOCK_HZ;
+}
+
+// ==========================
+// 硬件定时器
+// ==========================
+const uint8_t MAX_HW_TIMERS = 4;
+const uint32_t APB_CLOCK_MHZ = 80;
+
+std::recursive_mutex g_timerMutex;
+thread_local bool t_inTimerService = false;
+std::atomic<uint32_t> g_isrViolations(0);
+
+} // namespace
+
+struct hw_timer_s {
+    bool inUse = false;
+    uint8_t num = 0;
+    uint16_t divider = 80;
+    uint64_t baseUs = 0;          // 计数器为0对应的时刻
+    uint64_t alarmTicks = 0;
+    bool autoreload = false;
+    bool alarmEnabled = false;
+    void (*isr)(void) = nullptr;
+
+    uint64_t ticksToMicros(uint64_t ticks) const {
+        return ticks * divider / APB_CLOCK_MHZ;
+    }
+    uint64_t dueMicros() const {
+        return baseUs + ticksToMicros(alarmTicks);
+    }
+};
+
+namespace {
+
+hw_timer_s g_timers[MAX_HW_TIMERS];
+
+/**
+ * 找出最早到期的定时器（需持有g_timerMutex）
+ */
+hw_timer_s* earliestTimer() {
+    hw_timer_s* earliest = nullptr;
+    for (auto& timer : g_timers) {
+        if (timer.inUse && timer.alarmEnabled && timer.isr) {
+            if (!earliest || timer.dueMicros() < earliest->dueMicros()) {
+                earliest = &timer;
+            }
+        }
+    }
+    return earliest;
+}
+
+/**
+ * 触发所有在limitUs之前到期的定时器
+ * 虚拟模式下先把时钟拨到到期时刻再调用ISR，使ISR内读取的时间精确
+ */
+void fireTimersUntil(uint64_t limitUs) {
+    if (t_inTimerService) {
+        return;  // ISR内部调用millis()等不再重入
+    }
+    t_inTimerService = true;
+    while (true) {
+        void (*isr)(void) = nullptr;
+        {
+            std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+            hw_timer_s* timer = earliestTimer();
+            if (!timer || timer->dueMicros() > limitUs) {
+                break;
+            }
+            uint64_t due = timer->dueMicros();
+            if (g_virtualClock && due > g_virtualMicros) {
+                g_virtualMicros = due;
+            }
+            isr = timer->isr;
+            if (timer->autoreload) {
+                timer->baseUs = due;
+                if (timer->alarmTicks == 0) {
+                    timer->alarmEnabled = false;  // 防止0周期死循环
+                }
+            } else {
+                timer->alarmEnabled = false;  // 单次告警触发后自动关闭，与硬件一致
+            }
+        }
+        isr();
+    }
+    t_inTimerService = false;
+}
+
+void advanceVirtual(uint64_t us) {
+    uint64_t target = g_virtualMicros + us;
+    fireTimersUntil(target);
+    uint64_t current = g_virtualMicros;
+    while (current < target && !g_virtualMicros.compare_exchange_weak(current, target)) {
+    }
+}
+
+} // namespace
+
+// ==========================
+// NativeHAL 时钟接口
+// ==========================
+void NativeHAL::useVirtualClock(bool enabled) {
+    if (enabled && !g_virtualClock) {
+        g_virtualMicros = hostMicros();
+    } else if (!enabled && g_virtualClock) {
+        uint64_t host = hostMicros();
+        if (g_virtualMicros > host) {
+            g_realOffsetMicros += g_virtualMicros - host;
+        }
+    }
+    g_virtualClock = enabled;
+}
+
+bool NativeHAL::isVirtualClock() {
+    return g_virtualClock;
+}
+
+uint64_t NativeHAL::nowMicros() {
+    return g_virtualClock ? g_virtualMicros.load() : hostMicros();
+}
+
+void NativeHAL::advanceMicros(uint64_t us) {
+    if (g_virtualClock) {
+        advanceVirtual(us);
+    } else {
+        waitUntilMicros(hostMicros() + us);
+    }
+}
+
+void NativeHAL::advanceMillis(uint32_t ms) {
+    advanceMicros(static_cast<uint64_t>(ms) * 1000ULL);
+}
+
+void NativeHAL::setMicros(uint64_t us) {
+    if (g_virtualClock && us > g_virtualMicros) {
+        // 直接跳转，不触发中间的定时器；之后按新时刻重新计算定时器基准
+        std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+        uint64_t delta = us - g_virtualMicros;
+        for (auto& timer : g_timers) {
+            if (timer.inUse) {
+                timer.baseUs += delta;
+            }
+        }
+        g_virtualMicros = us;
+    }
+}
+
+void NativeHAL::waitUntilMicros(uint64_t targetUs) {
+    if (g_virtualClock) {
+        uint64_t now = g_virtualMicros;
+        if (targetUs > now) {
+            advanceVirtual(targetUs - now);
+        }
+        return;
+    }
+
+    while (true) {
+        serviceTimers();
+        uint64_t now = hostMicros();
+        if (now >= targetUs) {
+            break;
+        }
+        uint64_t wakeUs = std::min(targetUs, nextTimerDueMicros());
+        if (wakeUs > now) {
+            std::this_thread::sleep_for(std::chrono::microseconds(wakeUs - now));
+        }
+    }
+}
+
+void NativeHAL::setAutoAdvanceMicros(uint32_t us) {
+    g_autoAdvanceMicros = us;
+}
+
+void NativeHAL::serviceTimers() {
+    fireTimersUntil(nowMicros());
+}
+
+bool NativeHAL::inISR() {
+    return t_inTimerService;
+}
+
+uint32_t NativeHAL::getISRViolationCount() {
+    return g_isrViolations.load();
+}
+
+void NativeHAL::reportISRViolation(const char* api) {
+    g_isrViolations++;
+    fprintf(stderr, "[NativeHAL] %s在中断上下文中调用（目标板上会触发断言）\n", api);
+}
+
+uint64_t NativeHAL::nextTimerDueMicros() {
+    std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+    hw_timer_s* timer = earliestTimer();
+    return timer ? timer->dueMicros() : UINT64_MAX;
+}
+
+// ==========================
+// NativeHAL GPIO接口
+// ==========================
+int NativeHAL::getPinLevel(uint8_t pin) {
+    if (pin >= MAX_PINS) return LOW;
+    std::lock_guard<std::mutex> lock(g_gpioMutex);
+    return g_pins[pin].outputLevel;
+}
+
+uint8_t NativeHAL::getPinMode(uint8_t pin) {
+    if (pin >= MAX_PINS) return 0;
+    std::lock_guard<std::mutex> lock(g_gpioMutex);
+    return g_pins[pin].mode;
+}
+
+uint32_t NativeHAL::getPinWriteCount(uint8_t pin) {
+    if (pin >= MAX_PINS) return 0;
+    std::lock_guard<std::mutex> lock(g_gpioMutex);
+    return g_pins[pin].writeCount;
+}
+
+void NativeHAL::setPinInputLevel(uint8_t pin, uint8_t level) {
+    if (pin >= MAX_PINS) return;
+    std::lock_guard<std::mutex> lock(g_gpioMutex);
+    g_pins[pin].inputLevel = level ? HIGH : LOW;
+}
+
+void NativeHAL::setPinWriteHook(PinWriteHook hook) {
+    std::lock_guard<std::mutex> lock(g_gpioMutex);
+    g_pinWriteHook = hook;
+}
+
+void NativeHAL::resetGPIO() {
+    std::lock_guard<std::mutex> lock(g_gpioMutex);
+    for (auto& pin : g_pins) {
+        pin = PinState();
+    }
+    g_pinWriteHook = nullptr;
+}
+
+// ==========================
+// NativeHAL LEDC接口
+// ==========================
+uint32_t NativeHAL::getLEDCDuty(uint8_t channel) {
+    if (channel >= LEDC_CHANNELS) return 0;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    return g_ledcChannels[channel].duty;
+}
+
+uint32_t NativeHAL::getLEDCFrequency(uint8_t channel) {
+    if (channel >= LEDC_CHANNELS) return 0;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    return g_ledcChannels[channel].frequency;
+}
+
+uint8_t NativeHAL::getLEDCResolution(uint8_t channel) {
+    if (channel >= LEDC_CHANNELS) return 0;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    return g_ledcChannels[channel].resolutionBits;
+}
+
+uint32_t NativeHAL::getLEDCWriteCount(uint8_t channel) {
+    if (channel >= LEDC_CHANNELS) return 0;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    return g_ledcChannels[channel].writeCount;
+}
+
+int NativeHAL::getLEDCPinChannel(uint8_t pin) {
+    if (pin >= MAX_PINS) return -1;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    ensureLEDCPinMap();
+    return g_ledcPinChannel[pin];
+}
+
+void NativeHAL::setLEDCWriteHook(LEDCWriteHook hook) {
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    g_ledcWriteHook = hook;
+}
+
+void NativeHAL::resetLEDC() {
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    for (auto& channel : g_ledcChannels) {
+        channel = LEDCChannelState();
+    }
+    g_ledcPinMapReady = false;
+    ensureLEDCPinMap();
+    g_ledcWriteHook = nullptr;
+}
+
+// ==========================
+// NativeHAL 进程接口
+// ==========================
+void NativeHAL::requestExit(int code) {
+    g_exitCode = code;
+    g_exitRequested = true;
+}
+
+bool NativeHAL::exitRequested() {
+    return g_exitRequested;
+}
+
+int NativeHAL::exitCode() {
+    return g_exitCode;
+}
+
+// ==========================
+// Arduino 时间API
+// ==========================
+unsigned long micros() {
+    if (g_virtualClock) {
+        uint32_t step = g_autoAdvanceMicros;
+        if (step > 0) {
+            advanceVirtual(step);
+        }
+    } else {
+        NativeHAL::serviceTimers();
+    }
+    return static_cast<unsigned long>(static_cast<uint32_t>(NativeHAL::nowMicros()));
+}
+
+unsigned long millis() {
+    if (g_virtualClock) {
+        uint32_t step = g_autoAdvanceMicros;
+        if (step > 0) {
+            advanceVirtual(step);
+        }
+    } else {
+        NativeHAL::serviceTimers();
+    }
+    // 与ESP32一致：32位毫秒计数，约49.7天回绕
+    return static_cast<unsigned long>(static_cast<uint32_t>(NativeHAL::nowMicros() / 1000ULL));
+}
+
+void delay(uint32_t ms) {
+    NativeHAL::advanceMicros(static_cast<uint64_t>(ms) * 1000ULL);
+}
+
+void delayMicroseconds(uint32_t us) {
+    NativeHAL::advanceMicros(us);
+}
+
+void yield() {
+    if (!g_virtualClock) {
+        NativeHAL::serviceTimers();
+        std::this_thread::yield();
+    }
+}
+
+int64_t esp_timer_get_time() {
+    return static_cast<int64_t>(NativeHAL::nowMicros());
+}
+
+// ==========================
+// Arduino GPIO API
+// ==========================
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= MAX_PINS) return;
+    std::lock_guard<std::mutex> lock(g_gpioMutex);
+    g_pins[pin].mode = mode;
+    if (mode == INPUT_PULLUP) {
+        g_pins[pin].inputLevel = HIGH;
+    } else if (mode == INPUT_PULLDOWN) {
+        g_pins[pin].inputLevel = LOW;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin >= MAX_PINS) return;
+    NativeHAL::PinWriteHook hook;
+    uint8_t level = val ? HIGH : LOW;
+    {
+        std::lock_guard<std::mutex> lock(g_gpioMutex);
+        g_pins[pin].outputLevel = level;
+        g_pins[pin].writeCount++;
+        hook = g_pinWriteHook;
+    }
+    if (hook) {
+        hook(pin, level, NativeHAL::nowMicros());
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    if (pin >= MAX_PINS) return LOW;
+    std::lock_guard<std::mutex> lock(g_gpioMutex);
+    const PinState& state = g_pins[pin];
+    // 输出模式下读回输出锁存值
+    return (state.mode & OUTPUT) == OUTPUT ? state.outputLevel : state.inputLevel;
+}
+
+// ==========================
+// Arduino LEDC API
+// ==========================
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolutionBits) {
+    if (channel >= LEDC_CHANNELS || !validLEDCTiming(freq, resolutionBits)) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    LEDCChannelState& state = g_ledcChannels[channel];
+    state.frequency = freq;
+    state.resolutionBits = resolutionBits;
+    state.duty = 0;
+    return freq;
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel >= LEDC_CHANNELS) return;
+    NativeHAL::LEDCWriteHook hook;
+    {
+        std::lock_guard<std::mutex> lock(g_ledcMutex);
+        LEDCChannelState& state = g_ledcChannels[channel];
+        if (state.frequency == 0) {
+            return;
+        }
+        // 与Arduino核心一致：占空比等于2^bits时为常高电平，更大的值按常高处理
+        uint32_t full = 1UL << state.resolutionBits;
+        state.duty = duty > full ? full : duty;
+        state.writeCount++;
+        hook = g_ledcWriteHook;
+        duty = state.duty;
+    }
+    if (hook) {
+        hook(channel, duty, NativeHAL::nowMicros());
+    }
+}
+
+uint32_t ledcRead(uint8_t channel) {
+    return NativeHAL::getLEDCDuty(channel);
+}
+
+uint32_t ledcReadFreq(uint8_t channel) {
+    return NativeHAL::getLEDCFrequency(channel);
+}
+
+uint32_t ledcChangeFrequency(uint8_t channel, uint32_t freq, uint8_t resolutionBits) {
+    if (channel >= LEDC_CHANNELS || !validLEDCTiming(freq, resolutionBits)) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    LEDCChannelState& state = g_ledcChannels[channel];
+    if (state.frequency == 0) {
+        return 0;
+    }
+    state.frequency = freq;
+    state.resolutionBits = resolutionBits;
+    return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    if (pin >= MAX_PINS || channel >= LEDC_CHANNELS) return;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    ensureLEDCPinMap();
+    g_ledcPinChannel[pin] = static_cast<int8_t>(channel);
+}
+
+void ledcDetachPin(uint8_t pin) {
+    if (pin >= MAX_PINS) return;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    ensureLEDCPinMap();
+    g_ledcPinChannel[pin] = -1;
+}
+
+// ==========================
+// 硬件定时器API
+// ==========================
+hw_timer_t* timerBegin(uint8_t num, uint16_t divider, bool countUp) {
+    (void)countUp;
+    if (num >= MAX_HW_TIMERS || divider == 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+    hw_timer_s& timer = g_timers[num];
+    timer = hw_timer_s();
+    timer.inUse = true;
+    timer.num = num;
+    timer.divider = divider;
+    timer.baseUs = NativeHAL::nowMicros();
+    return &timer;
+}
+
+void timerEnd(hw_timer_t* timer) {
+    if (!timer) return;
+    std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+    *timer = hw_timer_s();
+}
+
+void timerAttachInterrupt(hw_timer_t* timer, void (*fn)(void), bool edge) {
+    (void)edge;
+    if (!timer) return;
+    std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+    timer->isr = fn;
+}
+
+void timerDetachInterrupt(hw_timer_t* timer) {
+    if (!timer) return;
+    std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+    timer->isr = nullptr;
+}
+
+void timerAlarmWrite(hw_timer_t* timer, uint64_t alarmValue, bool autoreload) {
+    if (!timer) return;
+    std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+    timer->alarmTicks = alarmValue;
+    timer->autoreload = autoreload;
+}
+
+void timerAlarmEnable(hw_timer_t* timer) {
+    if (!timer) return;
+    std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+    timer->alarmEnabled = true;
+}
+
+void timerAlarmDisable(hw_timer_t* timer) {
+    if (!timer) return;
+    std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+    timer->alarmEnabled = false;
+}
+
+bool timerAlarmEnabled(hw_timer_t* timer) {
+    if (!timer) return false;
+    std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+    return timer->alarmEnabled;
+}
+
+void timerRestart(hw_timer_t* timer) {
+    if (!timer) return;
+    std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+    timer->baseUs = NativeHAL::nowMicros();
+}
+
+uint64_t timerRead(hw_timer_t* timer) {
+    if (!timer) return 0;
+    std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+    uint64_t elapsedUs = NativeHAL::nowMicros() - timer->baseUs;
+    return elapsedUs * APB_CLOCK_MHZ / timer->divider;
+}
+
+void timerWrite(hw_timer_t* timer, uint64_t value) {
+    if (!timer) return;
+    std::lock_guard<std::recursive_mutex> lock(g_timerMutex);
+    timer->baseUs = NativeHAL::nowMicros() - timer->ticksToMicros(value);
+}
+
+// ==========================
+// 芯片相关
+// ==========================
+namespace {
+uint32_t g_cpuFrequencyMhz = 240;
+std::mt19937 g_random(12345);
+}
+
+bool setCpuFrequencyMhz(uint32_t cpuFreqMhz) {
+    g_cpuFrequencyMhz = cpuFreqMhz;
+    return true;
+}
+
+uint32_t getCpuFrequencyMhz() {
+    return g_cpuFrequencyMhz;
+}
+
+float temperatureRead() {
+    return 40.0f;
+}
+
+long random(long howBig) {
+    if (howBig <= 0) return 0;
+    return static_cast<long>(g_random() % static_cast<unsigned long>(howBig));
+}
+
+long random(long howSmall, long howBig) {
+    if (howSmall >= howBig) return howSmall;
+    return howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) {
+    g_random.seed(static_cast<uint32_t>(seed));
+}
+
+EspClass ESP;
+
+uint32_t EspClass::getHeapSize() { return 327680; }
+uint32_t EspClass::getFreeHeap() { return 262144; }
+uint32_t EspClass::getMinFreeHeap() { return 262144; }
+uint32_t EspClass::getMaxAllocHeap() { return 131072; }
+
+uint32_t EspClass::getCycleCount() {
+#if defined(__x86_64__) || defined(__i386__)
+    return static_cast<uint32_t>(__rdtsc());
+#else
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void EspClass::restart() {
+    printf("[NativeHAL] ESP.restart() 调用，进程退出\n");
+    fflush(stdout);
+    exit(0);
+}
+
+// ==========================
+// 程序入口：与Arduino一致，先setup()后循环loop()
+// ==========================
+int main() {
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+    setup();
+    while (!NativeHAL::exitRequested()) {
+        loop();
+        yield();
+    }
+    fflush(stdout);
+    return NativeHAL::exitCode();
+}
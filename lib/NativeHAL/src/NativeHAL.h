@@ -0,0 +1,191 @@
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+/**
+ * 主机(native)仿真HAL控制接口
+ * 供主机测试驱动仿真外设：虚拟时钟、GPIO、LEDC、硬件定时器、NVS、RMT和BLE。
+ *
+ * 时钟有两种模式：
+ * - 实时模式（默认）：时间取自主机单调时钟，delay()真实休眠
+ * - 虚拟模式：时间只在delay()/advance*()时前进，定时器中断在精确到期时刻触发，
+ *   测试结果与主机负载无关、可重复
+ */
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "driver/rmt.h"
+
+class NativeHAL {
+public:
+    // ==========================
+    // 时钟
+    // ==========================
+
+    /**
+     * @brief 切换虚拟时钟模式
+     * @param enabled true 使用虚拟时钟，false 使用主机实时时钟
+     */
+    static void useVirtualClock(bool enabled);
+    static bool isVirtualClock();
+
+    /**
+     * @brief 当前时间（微秒，64位，不回绕）
+     */
+    static uint64_t nowMicros();
+
+    /**
+     * @brief 推进虚拟时间，期间到期的定时器按时间顺序触发
+     * @note 实时模式下等价于休眠相应时间
+     */
+    static void advanceMicros(uint64_t us);
+    static void advanceMillis(uint32_t ms);
+
+    /**
+     * @brief 将虚拟时间设置到指定时刻（只能向前），用于验证millis()回绕等场景
+     */
+    static void setMicros(uint64_t us);
+
+    /**
+     * @brief 阻塞直到指定时刻（虚拟模式直接推进时间）
+     */
+    static void waitUntilMicros(uint64_t targetUs);
+
+    /**
+     * @brief 设置每次调用millis()/micros()时虚拟时间自动前进的量
+     * 用于仿真"忙等"循环（如while(millis() < t)）不会在虚拟模式下死循环，默认0
+     */
+    static void setAutoAdvanceMicros(uint32_t us);
+
+    // ==========================
+    // GPIO
+    // ==========================
+    typedef std::function<void(uint8_t pin, uint8_t level, uint64_t timeUs)> PinWriteHook;
+
+    static int getPinLevel(uint8_t pin);
+    static uint8_t getPinMode(uint8_t pin);
+    static uint32_t getPinWriteCount(uint8_t pin);
+
+    /**
+     * @brief 设置输入引脚的外部电平（digitalRead返回该值）
+     */
+    static void setPinInputLevel(uint8_t pin, uint8_t level);
+
+    /**
+     * @brief 注册引脚写入钩子，每次digitalWrite时回调（带时间戳）
+     */
+    static void setPinWriteHook(PinWriteHook hook);
+    static void resetGPIO();
+
+    // ==========================
+    // LEDC
+    // ==========================
+    typedef std::function<void(uint8_t channel, uint32_t duty, uint64_t timeUs)> LEDCWriteHook;
+
+    static uint32_t getLEDCDuty(uint8_t channel);
+    static uint32_t getLEDCFrequency(uint8_t channel);
+    static uint8_t getLEDCResolution(uint8_t channel);
+    static uint32_t getLEDCWriteCount(uint8_t channel);
+
+    /**
+     * @brief 引脚连接的LEDC通道
+     * @return 通道号，未连接返回-1
+     */
+    static int getLEDCPinChannel(uint8_t pin);
+
+    /**
+     * @brief 注册占空比写入钩子，每次ledcWrite时回调（带时间戳）
+     */
+    static void setLEDCWriteHook(LEDCWriteHook hook);
+    static void resetLEDC();
+
+    // ==========================
+    // 硬件定时器
+    // ==========================
+
+    /**
+     * @brief 在实时模式下检查并触发到期的定时器中断
+     * @note millis()/micros()/delay()内部会自动调用
+     */
+    static void serviceTimers();
+
+    /**
+     * @brief 最近一个待触发的定时器到期时刻，无则返回UINT64_MAX
+     */
+    static uint64_t nextTimerDueMicros();
+
+    /**
+     * @brief 当前线程是否正在执行定时器中断回调（模拟中断上下文）
+     */
+    static bool inISR();
+
+    /**
+     * @brief 中断上下文中调用了只允许在任务中调用的FreeRTOS接口（目标板上会触发断言）的次数
+     */
+    static uint32_t getISRViolationCount();
+    static void reportISRViolation(const char* api);
+
+    // ==========================
+    // NVS
+    // ==========================
+    static void resetNVS();
+    static size_t getNVSEntryCount();
+    static uint32_t getNVSCommitCount();
+
+    // ==========================
+    // RMT
+    // ==========================
+    static std::vector<rmt_item32_t> getRMTItems(rmt_channel_t channel);
+    static uint32_t getRMTWriteCount(rmt_channel_t channel);
+
+    // ==========================
+    // BLE
+    // ==========================
+    struct BLENotification {
+        std::string uuid;
+        std::string value;
+        uint64_t timeUs;
+    };
+
+    /**
+     * @brief 模拟客户端连接
+     * @param mtu 协商后的ATT MTU（默认23，即每包20字节负载）
+     */
+    static bool bleConnect(uint16_t mtu = 23);
+    static void bleDisconnect();
+    static bool bleIsConnected();
+    static uint16_t bleGetMTU();
+
+    /**
+     * @brief 模拟客户端写特征值，触发onWrite回调
+     * @return false 特征值不存在
+     */
+    static bool bleWrite(const char* uuid, const std::string& value);
+
+    /**
+     * @brief 模拟客户端读特征值，先触发onRead回调再返回值（按MTU截断）
+     */
+    static std::string bleRead(const char* uuid);
+
+    /**
+     * @brief 取出并清空已发送的通知（负载按MTU-3截断，与空口一致）
+     */
+    static std::vector<BLENotification> bleTakeNotifications();
+    static void bleReset();
+
+    // ==========================
+    // 进程
+    // ==========================
+
+    /**
+     * @brief 请求退出主循环，main()以指定退出码返回
+     */
+    static void requestExit(int code);
+    static bool exitRequested();
+    static int exitCode();
+};
+
+#endif // NATIVE_HAL_H
@@ -0,0 +1,37 @@
+#include "Print.h"
+#include <cstdarg>
+#include <cstdio>
+#include <vector>
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char local[128];
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int len = vsnprintf(local, sizeof(local), format, copy);
+    va_end(copy);
+    
+    if (len < 0) {
+        va_end(args);
+        return 0;
+    }
+    
+    if (static_cast<size_t>(len) < sizeof(local)) {
+        va_end(args);
+        return write(local, len);
+    }
+    
+    std::vector<char> buffer(len + 1);
+    vsnprintf(buffer.data(), buffer.size(), format, args);
+    va_end(args);
+    return write(buffer.data(), len);
+}
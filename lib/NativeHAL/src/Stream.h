@@ -0,0 +1,32 @@
+#ifndef NATIVE_STREAM_H
+#define NATIVE_STREAM_H
+
+#include "Print.h"
+
+/**
+ * Arduino Stream的主机实现
+ */
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout() const { return _timeout; }
+    
+    virtual size_t readBytes(uint8_t* buffer, size_t length);
+    size_t readBytes(char* buffer, size_t length) { return readBytes(reinterpret_cast<uint8_t*>(buffer), length); }
+    String readString();
+    String readStringUntil(char terminator);
+
+protected:
+    /**
+     * 带超时的单字节读取，超时返回-1
+     */
+    int timedRead();
+    
+    unsigned long _timeout = 1000;
+};
+
+#endif // NATIVE_STREAM_H
@@ -0,0 +1,236 @@
+#include "WString.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+std::string unsignedToString(unsigned long long value, unsigned char base) {
+    if (base < 2 || base > 36) {
+        base = 10;
+    }
+    if (value == 0) {
+        return "0";
+    }
+    
+    char digits[65];
+    int pos = 64;
+    digits[pos] = '\0';
+    while (value > 0 && pos > 0) {
+        unsigned int digit = value % base;
+        digits[--pos] = static_cast<char>(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        value /= base;
+    }
+    return std::string(&digits[pos]);
+}
+
+std::string signedToString(long long value, unsigned char base) {
+    if (value < 0 && base == 10) {
+        return "-" + unsignedToString(static_cast<unsigned long long>(-(value + 1)) + 1, base);
+    }
+    return unsignedToString(static_cast<unsigned long long>(value), base);
+}
+
+std::string floatToString(double value, unsigned int decimalPlaces) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", static_cast<int>(decimalPlaces), value);
+    return std::string(buf);
+}
+
+} // namespace
+
+String::String(const char* cstr) : buffer(cstr ? cstr : "") {}
+
+String::String(char c) : buffer(1, c) {}
+
+String::String(unsigned char value, unsigned char base) : buffer(unsignedToString(value, base)) {}
+
+String::String(int value, unsigned char base) : buffer(signedToString(value, base)) {}
+
+String::String(unsigned int value, unsigned char base) : buffer(unsignedToString(value, base)) {}
+
+String::String(long value, unsigned char base) : buffer(signedToString(value, base)) {}
+
+String::String(unsigned long value, unsigned char base) : buffer(unsignedToString(value, base)) {}
+
+String::String(long long value, unsigned char base) : buffer(signedToString(value, base)) {}
+
+String::String(unsigned long long value, unsigned char base) : buffer(unsignedToString(value, base)) {}
+
+String::String(float value, unsigned int decimalPlaces) : buffer(floatToString(value, decimalPlaces)) {}
+
+String::String(double value, unsigned int decimalPlaces) : buffer(floatToString(value, decimalPlaces)) {}
+
+String& String::operator=(const char* cstr) {
+    buffer = cstr ? cstr : "";
+    return *this;
+}
+
+char String::charAt(unsigned int index) const {
+    return index < buffer.length() ? buffer[index] : '\0';
+}
+
+bool String::concat(const char* cstr) {
+    if (!cstr) {
+        return false;
+    }
+    buffer += cstr;
+    return true;
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+    if (!cstr) {
+        return false;
+    }
+    buffer.append(cstr, length);
+    return true;
+}
+
+bool String::equals(const char* cstr) const {
+    return buffer == (cstr ? cstr : "");
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+    if (buffer.length() != other.buffer.length()) {
+        return false;
+    }
+    for (size_t i = 0; i < buffer.length(); i++) {
+        if (tolower(static_cast<unsigned char>(buffer[i])) != tolower(static_cast<unsigned char>(other.buffer[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return buffer.compare(0, prefix.buffer.length(), prefix.buffer) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    if (suffix.buffer.length() > buffer.length()) {
+        return false;
+    }
+    return buffer.compare(buffer.length() - suffix.buffer.length(), suffix.buffer.length(), suffix.buffer) == 0;
+}
+
+int String::indexOf(char c, unsigned int fromIndex) const {
+    size_t pos = buffer.find(c, fromIndex);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+    size_t pos = buffer.find(str.buffer, fromIndex);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+}
+
+int String::lastIndexOf(char c) const {
+    size_t pos = buffer.rfind(c);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+}
+
+String String::substring(unsigned int beginIndex) const {
+    return substring(beginIndex, length());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) {
+        std::swap(beginIndex, endIndex);
+    }
+    if (beginIndex >= buffer.length()) {
+        return String();
+    }
+    endIndex = std::min<unsigned int>(endIndex, length());
+    return String(buffer.substr(beginIndex, endIndex - beginIndex));
+}
+
+void String::replace(const String& find, const String& replacement) {
+    if (find.buffer.empty()) {
+        return;
+    }
+    size_t pos = 0;
+    while ((pos = buffer.find(find.buffer, pos)) != std::string::npos) {
+        buffer.replace(pos, find.buffer.length(), replacement.buffer);
+        pos += replacement.buffer.length();
+    }
+}
+
+void String::remove(unsigned int index) {
+    if (index < buffer.length()) {
+        buffer.erase(index);
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index < buffer.length()) {
+        buffer.erase(index, count);
+    }
+}
+
+void String::toLowerCase() {
+    for (auto& c : buffer) {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+}
+
+void String::toUpperCase() {
+    for (auto& c : buffer) {
+        c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+}
+
+void String::trim() {
+    size_t begin = 0;
+    while (begin < buffer.length() && isspace(static_cast<unsigned char>(buffer[begin]))) {
+        begin++;
+    }
+    size_t end = buffer.length();
+    while (end > begin && isspace(static_cast<unsigned char>(buffer[end - 1]))) {
+        end--;
+    }
+    buffer = buffer.substr(begin, end - begin);
+}
+
+long String::toInt() const {
+    return strtol(buffer.c_str(), nullptr, 10);
+}
+
+float String::toFloat() const {
+    return strtof(buffer.c_str(), nullptr);
+}
+
+double String::toDouble() const {
+    return strtod(buffer.c_str(), nullptr);
+}
+
+String operator+(const String& lhs, const String& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const String& lhs, char rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const String& lhs, int rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, unsigned int rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, long rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, unsigned long rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, float rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, double rhs) { return lhs + String(rhs); }
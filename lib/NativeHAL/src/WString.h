@@ -0,0 +1,116 @@
+#ifndef NATIVE_WSTRING_H
+#define NATIVE_WSTRING_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Arduino String的主机实现
+ * 以std::string为存储，覆盖项目中用到的接口子集
+ */
+class String {
+public:
+    String() = default;
+    String(const char* cstr);
+    String(const std::string& str) : buffer(str) {}
+    String(const String& other) = default;
+    String(String&& other) noexcept = default;
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimalPlaces = 2);
+    explicit String(double value, unsigned int decimalPlaces = 2);
+    
+    String& operator=(const String& other) = default;
+    String& operator=(String&& other) noexcept = default;
+    String& operator=(const char* cstr);
+    
+    // 访问
+    const char* c_str() const { return buffer.c_str(); }
+    unsigned int length() const { return static_cast<unsigned int>(buffer.length()); }
+    bool isEmpty() const { return buffer.empty(); }
+    bool reserve(unsigned int size) { buffer.reserve(size); return true; }
+    char charAt(unsigned int index) const;
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return buffer[index]; }
+    
+    // 拼接
+    bool concat(const String& str) { buffer += str.buffer; return true; }
+    bool concat(const char* cstr);
+    bool concat(const char* cstr, unsigned int length);
+    bool concat(char c) { buffer += c; return true; }
+    bool concat(int value) { return concat(String(value)); }
+    bool concat(unsigned int value) { return concat(String(value)); }
+    bool concat(long value) { return concat(String(value)); }
+    bool concat(unsigned long value) { return concat(String(value)); }
+    bool concat(float value) { return concat(String(value)); }
+    bool concat(double value) { return concat(String(value)); }
+    
+    template <typename T>
+    String& operator+=(const T& value) { concat(value); return *this; }
+    
+    // 比较
+    int compareTo(const String& other) const { return buffer.compare(other.buffer); }
+    bool equals(const String& other) const { return buffer == other.buffer; }
+    bool equals(const char* cstr) const;
+    bool equalsIgnoreCase(const String& other) const;
+    bool startsWith(const String& prefix) const;
+    bool endsWith(const String& suffix) const;
+    bool operator==(const String& other) const { return equals(other); }
+    bool operator==(const char* cstr) const { return equals(cstr); }
+    bool operator!=(const String& other) const { return !equals(other); }
+    bool operator!=(const char* cstr) const { return !equals(cstr); }
+    bool operator<(const String& other) const { return compareTo(other) < 0; }
+    bool operator>(const String& other) const { return compareTo(other) > 0; }
+    
+    // 查找和截取
+    int indexOf(char c, unsigned int fromIndex = 0) const;
+    int indexOf(const String& str, unsigned int fromIndex = 0) const;
+    int lastIndexOf(char c) const;
+    String substring(unsigned int beginIndex) const;
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+    
+    // 修改
+    void replace(const String& find, const String& replacement);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+    
+    // 转换
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+    
+    const std::string& str() const { return buffer; }
+
+private:
+    std::string buffer;
+};
+
+/**
+ * 兼容ArduinoJson等库对拼接结果类型的引用
+ */
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& str) : String(str) {}
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+String operator+(const String& lhs, int rhs);
+String operator+(const String& lhs, unsigned int rhs);
+String operator+(const String& lhs, long rhs);
+String operator+(const String& lhs, unsigned long rhs);
+String operator+(const String& lhs, float rhs);
+String operator+(const String& lhs, double rhs);
+
+#endif // NATIVE_WSTRING_H
@@ -0,0 +1,6 @@
+#ifndef NATIVE_DRIVER_ADC_H
+#define NATIVE_DRIVER_ADC_H
+
+#include "../esp_err.h"
+
+#endif // NATIVE_DRIVER_ADC_H
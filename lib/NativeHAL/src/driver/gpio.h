@@ -0,0 +1,8 @@
+#ifndef NATIVE_DRIVER_GPIO_H
+#define NATIVE_DRIVER_GPIO_H
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_NC -1
+
+#endif // NATIVE_DRIVER_GPIO_H
@@ -0,0 +1,92 @@
+#include "rmt.h"
+#include "../NativeHAL.h"
+
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct RMTChannelState {
+    bool configured = false;
+    bool installed = false;
+    rmt_config_t config{};
+    std::vector<rmt_item32_t> lastItems;
+    uint32_t writeCount = 0;
+};
+
+RMTChannelState g_channels[RMT_CHANNEL_MAX];
+std::mutex g_rmtMutex;
+
+bool validChannel(rmt_channel_t channel) {
+    return channel >= RMT_CHANNEL_0 && channel < RMT_CHANNEL_MAX;
+}
+
+} // namespace
+
+esp_err_t rmt_config(const rmt_config_t* rmtParam) {
+    if (!rmtParam || !validChannel(rmtParam->channel)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(g_rmtMutex);
+    g_channels[rmtParam->channel].config = *rmtParam;
+    g_channels[rmtParam->channel].configured = true;
+    return ESP_OK;
+}
+
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t rxBufSize, int intrAllocFlags) {
+    (void)rxBufSize;
+    (void)intrAllocFlags;
+    if (!validChannel(channel)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(g_rmtMutex);
+    if (g_channels[channel].installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    g_channels[channel].installed = true;
+    return ESP_OK;
+}
+
+esp_err_t rmt_driver_uninstall(rmt_channel_t channel) {
+    if (!validChannel(channel)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(g_rmtMutex);
+    g_channels[channel] = RMTChannelState();
+    return ESP_OK;
+}
+
+esp_err_t rmt_write_items(rmt_channel_t channel, const rmt_item32_t* rmtItem, int itemNum, bool waitTxDone) {
+    (void)waitTxDone;
+    if (!validChannel(channel) || !rmtItem || itemNum <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(g_rmtMutex);
+    if (!g_channels[channel].installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    g_channels[channel].lastItems.assign(rmtItem, rmtItem + itemNum);
+    g_channels[channel].writeCount++;
+    return ESP_OK;
+}
+
+esp_err_t rmt_wait_tx_done(rmt_channel_t channel, uint32_t waitTime) {
+    (void)waitTime;
+    return validChannel(channel) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+std::vector<rmt_item32_t> NativeHAL::getRMTItems(rmt_channel_t channel) {
+    if (!validChannel(channel)) {
+        return {};
+    }
+    std::lock_guard<std::mutex> lock(g_rmtMutex);
+    return g_channels[channel].lastItems;
+}
+
+uint32_t NativeHAL::getRMTWriteCount(rmt_channel_t channel) {
+    if (!validChannel(channel)) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(g_rmtMutex);
+    return g_channels[channel].writeCount;
+}
@@ -0,0 +1,40 @@
+#ifndef NATIVE_ESP_BT_H
+#define NATIVE_ESP_BT_H
+
+#include "esp_err.h"
+
+typedef enum {
+    ESP_BLE_PWR_TYPE_CONN_HDL0 = 0,
+    ESP_BLE_PWR_TYPE_CONN_HDL1,
+    ESP_BLE_PWR_TYPE_CONN_HDL2,
+    ESP_BLE_PWR_TYPE_CONN_HDL3,
+    ESP_BLE_PWR_TYPE_CONN_HDL4,
+    ESP_BLE_PWR_TYPE_CONN_HDL5,
+    ESP_BLE_PWR_TYPE_CONN_HDL6,
+    ESP_BLE_PWR_TYPE_CONN_HDL7,
+    ESP_BLE_PWR_TYPE_CONN_HDL8,
+    ESP_BLE_PWR_TYPE_ADV,
+    ESP_BLE_PWR_TYPE_SCAN,
+    ESP_BLE_PWR_TYPE_DEFAULT,
+    ESP_BLE_PWR_TYPE_NUM
+} esp_ble_power_type_t;
+
+typedef enum {
+    ESP_PWR_LVL_N12 = 0,
+    ESP_PWR_LVL_N9,
+    ESP_PWR_LVL_N6,
+    ESP_PWR_LVL_N3,
+    ESP_PWR_LVL_N0,
+    ESP_PWR_LVL_P3,
+    ESP_PWR_LVL_P6,
+    ESP_PWR_LVL_P9,
+    ESP_PWR_LVL_INVALID = 0xFF
+} esp_power_level_t;
+
+inline esp_err_t esp_ble_tx_power_set(esp_ble_power_type_t powerType, esp_power_level_t powerLevel) {
+    (void)powerType;
+    (void)powerLevel;
+    return ESP_OK;
+}
+
+#endif // NATIVE_ESP_BT_H
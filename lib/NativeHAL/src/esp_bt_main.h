@@ -0,0 +1,6 @@
+#ifndef NATIVE_ESP_BT_MAIN_H
+#define NATIVE_ESP_BT_MAIN_H
+
+#include "esp_err.h"
+
+#endif // NATIVE_ESP_BT_MAIN_H
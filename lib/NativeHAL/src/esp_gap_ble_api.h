@@ -0,0 +1,6 @@
+#ifndef NATIVE_ESP_GAP_BLE_API_H
+#define NATIVE_ESP_GAP_BLE_API_H
+
+#include "esp_bt.h"
+
+#endif // NATIVE_ESP_GAP_BLE_API_H
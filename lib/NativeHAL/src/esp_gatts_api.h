@@ -0,0 +1,47 @@
+#ifndef NATIVE_ESP_GATTS_API_H
+#define NATIVE_ESP_GATTS_API_H
+
+#include <cstdint>
+#include "esp_err.h"
+
+typedef uint8_t esp_gatt_if_t;
+#define ESP_GATT_IF_NONE 0xff
+
+// 特征值的最大长度（与ESP-IDF一致），Arduino BLE库拒绝更长的setValue()
+#define ESP_GATT_MAX_ATTR_LEN 600
+
+/**
+ * GATT服务端事件（仅保留主机仿真产生的事件）
+ */
+typedef enum {
+    ESP_GATTS_REG_EVT = 0,
+    ESP_GATTS_MTU_EVT = 4,
+    ESP_GATTS_CONNECT_EVT = 14,
+    ESP_GATTS_DISCONNECT_EVT = 15
+} esp_gatts_cb_event_t;
+
+/**
+ * GATT服务端回调参数（仅保留主机仿真用到的字段）
+ */
+typedef union {
+    struct gatts_connect_evt_param {
+        uint16_t conn_id;
+    } connect;
+    struct gatts_disconnect_evt_param {
+        uint16_t conn_id;
+        int reason;
+    } disconnect;
+    struct gatts_mtu_evt_param {
+        uint16_t conn_id;
+        uint16_t mtu;
+    } mtu;
+} esp_ble_gatts_cb_param_t;
+
+/**
+ * 直接发送通知/指示，不修改特征值（负载按MTU-3截断，与空口一致）
+ * @return 未连接、接口或句柄无效时返回ESP_FAIL
+ */
+esp_err_t esp_ble_gatts_send_indicate(esp_gatt_if_t gatts_if, uint16_t conn_id, uint16_t attr_handle,
+                                      uint16_t value_len, uint8_t* value, bool need_confirm);
+
+#endif // NATIVE_ESP_GATTS_API_H
@@ -0,0 +1,17 @@
+#ifndef NATIVE_ESP_PM_H
+#define NATIVE_ESP_PM_H
+
+#include "esp_err.h"
+
+typedef struct {
+    int max_freq_mhz;
+    int min_freq_mhz;
+    bool light_sleep_enable;
+} esp_pm_config_t;
+
+inline esp_err_t esp_pm_configure(const void* config) {
+    (void)config;
+    return ESP_OK;
+}
+
+#endif // NATIVE_ESP_PM_H
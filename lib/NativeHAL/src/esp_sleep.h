@@ -0,0 +1,44 @@
+#ifndef NATIVE_ESP_SLEEP_H
+#define NATIVE_ESP_SLEEP_H
+
+/**
+ * 睡眠相关接口的主机桩：仅记录调用，深度睡眠直接结束进程
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include "esp_err.h"
+
+typedef enum {
+    ESP_PD_DOMAIN_RTC_PERIPH,
+    ESP_PD_DOMAIN_RTC_SLOW_MEM,
+    ESP_PD_DOMAIN_RTC_FAST_MEM,
+    ESP_PD_DOMAIN_XTAL,
+    ESP_PD_DOMAIN_MAX
+} esp_sleep_pd_domain_t;
+
+typedef enum {
+    ESP_PD_OPTION_OFF,
+    ESP_PD_OPTION_ON,
+    ESP_PD_OPTION_AUTO
+} esp_sleep_pd_option_t;
+
+inline esp_err_t esp_sleep_pd_config(esp_sleep_pd_domain_t domain, esp_sleep_pd_option_t option) {
+    (void)domain;
+    (void)option;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeInUs) {
+    (void)timeInUs;
+    return ESP_OK;
+}
+
+inline void esp_deep_sleep_start() {
+    printf("[NativeHAL] esp_deep_sleep_start() 调用，进程退出\n");
+    fflush(stdout);
+    exit(0);
+}
+
+#endif // NATIVE_ESP_SLEEP_H
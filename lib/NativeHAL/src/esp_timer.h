@@ -0,0 +1,11 @@
+#ifndef NATIVE_ESP_TIMER_H
+#define NATIVE_ESP_TIMER_H
+
+#include <cstdint>
+
+/**
+ * 自启动以来的微秒数（64位），由NativeHAL时钟提供
+ */
+int64_t esp_timer_get_time();
+
+#endif // NATIVE_ESP_TIMER_H
@@ -0,0 +1,9 @@
+#ifndef NATIVE_ESP_WIFI_H
+#define NATIVE_ESP_WIFI_H
+
+#include "esp_err.h"
+
+inline esp_err_t esp_wifi_stop() { return ESP_OK; }
+inline esp_err_t esp_wifi_deinit() { return ESP_OK; }
+
+#endif // NATIVE_ESP_WIFI_H
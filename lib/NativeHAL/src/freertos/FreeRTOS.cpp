@@ -0,0 +1,165 @@
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+#include "../Arduino.h"
+#include "../NativeHAL.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct NativeSemaphore {
+    std::timed_mutex mutex;
+
+    // 二值信号量
+    bool binary = false;
+    std::mutex stateMutex;
+    std::condition_variable givenCondition;
+    bool available = false;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new NativeSemaphore();
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+    NativeSemaphore* semaphore = new NativeSemaphore();
+    semaphore->binary = true;
+    return semaphore;
+}
+
+namespace {
+
+bool tryTakeBinary(NativeSemaphore* semaphore) {
+    std::lock_guard<std::mutex> lock(semaphore->stateMutex);
+    if (!semaphore->available) {
+        return false;
+    }
+    semaphore->available = false;
+    return true;
+}
+
+/**
+ * 二值信号量的等待：超时按NativeHAL时钟计算
+ * 虚拟时钟下逐个推进到下一个定时器到期时刻（定时器回调可能释放信号量），
+ * 实时模式下在条件变量上等待，并在定时器到期时处理定时器回调
+ */
+BaseType_t takeBinary(NativeSemaphore* semaphore, TickType_t ticksToWait) {
+    if (tryTakeBinary(semaphore)) {
+        return pdTRUE;
+    }
+    if (ticksToWait == 0) {
+        return pdFALSE;
+    }
+
+    uint64_t deadline = ticksToWait == portMAX_DELAY
+        ? UINT64_MAX : NativeHAL::nowMicros() + static_cast<uint64_t>(ticksToWait) * portTICK_PERIOD_MS * 1000ULL;
+    for (;;) {
+        if (tryTakeBinary(semaphore)) {
+            return pdTRUE;
+        }
+        uint64_t now = NativeHAL::nowMicros();
+        if (now >= deadline) {
+            return pdFALSE;
+        }
+
+        uint64_t wake = std::min(deadline, NativeHAL::nextTimerDueMicros());
+        if (NativeHAL::isVirtualClock() && wake != UINT64_MAX) {
+            NativeHAL::waitUntilMicros(wake);
+            continue;
+        }
+
+        // 实时模式，或虚拟时钟下无限等待且没有定时器：只能等其他线程释放
+        uint64_t waitMicros = wake == UINT64_MAX ? 1000 : wake - now;
+        {
+            std::unique_lock<std::mutex> lock(semaphore->stateMutex);
+            semaphore->givenCondition.wait_for(lock, std::chrono::microseconds(waitMicros),
+                                               [semaphore]() { return semaphore->available; });
+        }
+        NativeHAL::serviceTimers();
+    }
+}
+
+} // namespace
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    delete semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    if (!semaphore) {
+        return pdFALSE;
+    }
+    if (semaphore->binary) {
+        return takeBinary(semaphore, ticksToWait);
+    }
+    if (ticksToWait == portMAX_DELAY) {
+        semaphore->mutex.lock();
+        return pdTRUE;
+    }
+    if (ticksToWait == 0) {
+        return semaphore->mutex.try_lock() ? pdTRUE : pdFALSE;
+    }
+    return semaphore->mutex.try_lock_for(std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS))
+        ? pdTRUE : pdFALSE;
+}
+
+namespace {
+
+BaseType_t give(SemaphoreHandle_t semaphore) {
+    if (!semaphore) {
+        return pdFALSE;
+    }
+    if (semaphore->binary) {
+        std::lock_guard<std::mutex> lock(semaphore->stateMutex);
+        if (semaphore->available) {
+            return pdFALSE;
+        }
+        semaphore->available = true;
+        semaphore->givenCondition.notify_one();
+        return pdTRUE;
+    }
+    semaphore->mutex.unlock();
+    return pdTRUE;
+}
+
+} // namespace
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    // 与目标板一致：xSemaphoreGive只能在任务中调用，中断中应使用xSemaphoreGiveFromISR
+    if (NativeHAL::inISR()) {
+        NativeHAL::reportISRViolation("xSemaphoreGive");
+    }
+    return give(semaphore);
+}
+
+BaseType_t xPortInIsrContext() {
+    return NativeHAL::inISR() ? pdTRUE : pdFALSE;
+}
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+    while (mux->locked.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+    mux->locked.store(false, std::memory_order_release);
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+    return give(semaphore);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks * portTICK_PERIOD_MS);
+}
+
+TickType_t xTaskGetTickCount() {
+    return static_cast<TickType_t>(millis());
+}
@@ -0,0 +1,41 @@
+#ifndef NATIVE_FREERTOS_H
+#define NATIVE_FREERTOS_H
+
+#include <atomic>
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define portMAX_DELAY       ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS  ((TickType_t)1)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+#define pdTRUE              ((BaseType_t)1)
+#define pdFALSE             ((BaseType_t)0)
+#define pdPASS              pdTRUE
+#define pdFAIL              pdFALSE
+
+// 临界区：ESP32上为关中断加跨核自旋锁，主机上用自旋锁模拟
+struct portMUX_TYPE {
+    std::atomic<bool> locked;
+    portMUX_TYPE(bool initial = false) : locked(initial) {}
+};
+
+#define portMUX_INITIALIZER_UNLOCKED {false}
+
+void vPortEnterCritical(portMUX_TYPE* mux);
+void vPortExitCritical(portMUX_TYPE* mux);
+
+#define portENTER_CRITICAL(mux)         vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)          vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux)     vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)      vPortExitCritical(mux)
+#define portYIELD_FROM_ISR(...)
+#define portENTER_CRITICAL_SAFE(mux)    vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_SAFE(mux)     vPortExitCritical(mux)
+
+// 是否在中断上下文中：主机上为是否正在执行模拟的定时器中断回调
+BaseType_t xPortInIsrContext();
+
+#endif // NATIVE_FREERTOS_H
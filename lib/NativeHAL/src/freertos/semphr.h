@@ -0,0 +1,21 @@
+#ifndef NATIVE_FREERTOS_SEMPHR_H
+#define NATIVE_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+/**
+ * FreeRTOS信号量的主机实现
+ * 互斥量基于std::timed_mutex，超时按真实时间计算，与虚拟时钟无关；
+ * 二值信号量的超时按NativeHAL时钟计算，虚拟时钟下等待期间推进时间并触发定时器
+ */
+struct NativeSemaphore;
+typedef NativeSemaphore* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateBinary();
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higherPriorityTaskWoken);
+
+#endif // NATIVE_FREERTOS_SEMPHR_H
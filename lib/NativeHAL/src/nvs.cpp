@@ -0,0 +1,260 @@
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "NativeHAL.h"
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class EntryType : uint8_t { U8, U16, U32, U64, STR, BLOB };
+
+struct Entry {
+    EntryType type;
+    std::vector<uint8_t> data;
+};
+
+const size_t NVS_KEY_NAME_MAX_SIZE = 16;  // 含结束符
+
+std::mutex g_nvsMutex;
+bool g_initialized = false;
+std::map<std::string, Entry> g_entries;                  // "namespace/key" -> 值
+std::map<nvs_handle_t, std::pair<std::string, bool>> g_handles;  // 句柄 -> (命名空间, 可写)
+nvs_handle_t g_nextHandle = 1;
+uint32_t g_commitCount = 0;
+
+/**
+ * 解析句柄和键名，返回完整键（需持有g_nvsMutex）
+ */
+esp_err_t resolveKey(nvs_handle_t handle, const char* key, bool needWrite, std::string& fullKey) {
+    auto it = g_handles.find(handle);
+    if (it == g_handles.end()) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (!key || strlen(key) == 0 || strlen(key) >= NVS_KEY_NAME_MAX_SIZE) {
+        return ESP_ERR_NVS_INVALID_NAME;
+    }
+    if (needWrite && !it->second.second) {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+    fullKey = it->second.first + "/" + key;
+    return ESP_OK;
+}
+
+esp_err_t setValue(nvs_handle_t handle, const char* key, EntryType type, const void* data, size_t length) {
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    std::string fullKey;
+    esp_err_t err = resolveKey(handle, key, true, fullKey);
+    if (err != ESP_OK) {
+        return err;
+    }
+    Entry& entry = g_entries[fullKey];
+    entry.type = type;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    entry.data.assign(bytes, bytes + length);
+    return ESP_OK;
+}
+
+esp_err_t getFixed(nvs_handle_t handle, const char* key, EntryType type, void* out, size_t length) {
+    if (!out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    std::string fullKey;
+    esp_err_t err = resolveKey(handle, key, false, fullKey);
+    if (err != ESP_OK) {
+        return err;
+    }
+    auto it = g_entries.find(fullKey);
+    if (it == g_entries.end()) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (it->second.type != type) {
+        return ESP_ERR_NVS_TYPE_MISMATCH;
+    }
+    memcpy(out, it->second.data.data(), length);
+    return ESP_OK;
+}
+
+esp_err_t getVariable(nvs_handle_t handle, const char* key, EntryType type, void* out, size_t* length) {
+    if (!length) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    std::string fullKey;
+    esp_err_t err = resolveKey(handle, key, false, fullKey);
+    if (err != ESP_OK) {
+        return err;
+    }
+    auto it = g_entries.find(fullKey);
+    if (it == g_entries.end()) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (it->second.type != type) {
+        return ESP_ERR_NVS_TYPE_MISMATCH;
+    }
+    size_t required = it->second.data.size();
+    if (!out) {
+        // 与IDF一致：out为空时只返回所需长度
+        *length = required;
+        return ESP_OK;
+    }
+    if (*length < required) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(out, it->second.data.data(), required);
+    *length = required;
+    return ESP_OK;
+}
+
+} // namespace
+
+esp_err_t nvs_flash_init() {
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    g_initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase() {
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    g_entries.clear();
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_deinit() {
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    g_initialized = false;
+    g_handles.clear();
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char* namespaceName, nvs_open_mode_t openMode, nvs_handle_t* outHandle) {
+    if (!namespaceName || !outHandle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    if (!g_initialized) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    if (strlen(namespaceName) == 0 || strlen(namespaceName) >= NVS_KEY_NAME_MAX_SIZE) {
+        return ESP_ERR_NVS_INVALID_NAME;
+    }
+    nvs_handle_t handle = g_nextHandle++;
+    g_handles[handle] = std::make_pair(std::string(namespaceName), openMode == NVS_READWRITE);
+    *outHandle = handle;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) {
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    g_handles.erase(handle);
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    if (g_handles.find(handle) == g_handles.end()) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    g_commitCount++;
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key) {
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    std::string fullKey;
+    esp_err_t err = resolveKey(handle, key, true, fullKey);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return g_entries.erase(fullKey) > 0 ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle) {
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    auto it = g_handles.find(handle);
+    if (it == g_handles.end()) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    std::string prefix = it->second.first + "/";
+    for (auto entry = g_entries.begin(); entry != g_entries.end();) {
+        if (entry->first.compare(0, prefix.size(), prefix) == 0) {
+            entry = g_entries.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char* key, uint8_t value) {
+    return setValue(handle, key, EntryType::U8, &value, sizeof(value));
+}
+
+esp_err_t nvs_set_u16(nvs_handle_t handle, const char* key, uint16_t value) {
+    return setValue(handle, key, EntryType::U16, &value, sizeof(value));
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char* key, uint32_t value) {
+    return setValue(handle, key, EntryType::U32, &value, sizeof(value));
+}
+
+esp_err_t nvs_set_u64(nvs_handle_t handle, const char* key, uint64_t value) {
+    return setValue(handle, key, EntryType::U64, &value, sizeof(value));
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char* key, const char* value) {
+    if (!value) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return setValue(handle, key, EntryType::STR, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length) {
+    if (!value && length > 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return setValue(handle, key, EntryType::BLOB, value, length);
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char* key, uint8_t* outValue) {
+    return getFixed(handle, key, EntryType::U8, outValue, sizeof(*outValue));
+}
+
+esp_err_t nvs_get_u16(nvs_handle_t handle, const char* key, uint16_t* outValue) {
+    return getFixed(handle, key, EntryType::U16, outValue, sizeof(*outValue));
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char* key, uint32_t* outValue) {
+    return getFixed(handle, key, EntryType::U32, outValue, sizeof(*outValue));
+}
+
+esp_err_t nvs_get_u64(nvs_handle_t handle, const char* key, uint64_t* outValue) {
+    return getFixed(handle, key, EntryType::U64, outValue, sizeof(*outValue));
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char* key, char* outValue, size_t* length) {
+    return getVariable(handle, key, EntryType::STR, outValue, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* outValue, size_t* length) {
+    return getVariable(handle, key, EntryType::BLOB, outValue, length);
+}
+
+void NativeHAL::resetNVS() {
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    g_entries.clear();
+    g_commitCount = 0;
+}
+
+size_t NativeHAL::getNVSEntryCount() {
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    return g_entries.size();
+}
+
+uint32_t NativeHAL::getNVSCommitCount() {
+    std::lock_guard<std::mutex> lock(g_nvsMutex);
+    return g_commitCount;
+}
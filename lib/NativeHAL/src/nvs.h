@@ -0,0 +1,41 @@
+#ifndef NATIVE_NVS_H
+#define NATIVE_NVS_H
+
+/**
+ * NVS的主机实现：内存中的键值存储，进程退出后丢失
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include "esp_err.h"
+
+typedef uint32_t nvs_handle_t;
+typedef nvs_handle_t nvs_handle;
+
+typedef enum {
+    NVS_READONLY,
+    NVS_READWRITE
+} nvs_open_mode_t;
+typedef nvs_open_mode_t nvs_open_mode;
+
+esp_err_t nvs_open(const char* namespaceName, nvs_open_mode_t openMode, nvs_handle_t* outHandle);
+void nvs_close(nvs_handle_t handle);
+esp_err_t nvs_commit(nvs_handle_t handle);
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key);
+esp_err_t nvs_erase_all(nvs_handle_t handle);
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char* key, uint8_t value);
+esp_err_t nvs_set_u16(nvs_handle_t handle, const char* key, uint16_t value);
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char* key, uint32_t value);
+esp_err_t nvs_set_u64(nvs_handle_t handle, const char* key, uint64_t value);
+esp_err_t nvs_set_str(nvs_handle_t handle, const char* key, const char* value);
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length);
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char* key, uint8_t* outValue);
+esp_err_t nvs_get_u16(nvs_handle_t handle, const char* key, uint16_t* outValue);
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char* key, uint32_t* outValue);
+esp_err_t nvs_get_u64(nvs_handle_t handle, const char* key, uint64_t* outValue);
+esp_err_t nvs_get_str(nvs_handle_t handle, const char* key, char* outValue, size_t* length);
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* outValue, size_t* length);
+
+#endif // NATIVE_NVS_H
@@ -0,0 +1,6 @@
+#ifndef NATIVE_SOC_RTC_H
+#define NATIVE_SOC_RTC_H
+
+#include <cstdint>
+
+#endif // NATIVE_SOC_RTC_H
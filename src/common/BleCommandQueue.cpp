@@ -0,0 +1,90 @@
+#include "BleCommandQueue.h"
+
+size_t BleCommandAck::encode(const BleCommandAck& ack, uint8_t* buffer, size_t size) {
+    if (buffer == nullptr || size < SIZE) {
+        return 0;
+    }
+    buffer[0] = (uint8_t)ack.id;
+    buffer[1] = (uint8_t)(ack.id >> 8);
+    buffer[2] = ack.target;
+    buffer[3] = static_cast<uint8_t>(ack.result);
+    for (uint8_t i = 0; i < 4; i++) {
+        buffer[4 + i] = (uint8_t)(ack.latencyMicros >> (8 * i));
+    }
+    return SIZE;
+}
+
+bool BleCommandAck::decode(const uint8_t* data, size_t length, BleCommandAck& ack) {
+    if (data == nullptr || length < SIZE) {
+        return false;
+    }
+    ack.id = (uint16_t)(data[0] | ((uint16_t)data[1] << 8));
+    ack.target = data[2];
+    ack.result = static_cast<Result>(data[3]);
+    ack.latencyMicros = (uint32_t)data[4] | ((uint32_t)data[5] << 8) | ((uint32_t)data[6] << 16) |
+                        ((uint32_t)data[7] << 24);
+    return true;
+}
+
+BleCommandQueue::BleCommandQueue()
+    : nextId(0)
+    , rejected(0)
+    , maxLatencyMicros(0) {
+}
+
+bool BleCommandQueue::enqueue(uint8_t target, const uint8_t* data, size_t length, uint16_t& id) {
+    id = nextId.fetch_add(1, std::memory_order_relaxed);
+    if (data == nullptr || length > BLE_COMMAND_MAX_LENGTH) {
+        reject(id, target, length);
+        return false;
+    }
+
+    uint64_t now = MonotonicClock::nowMicros();
+    bool pushed = queue.pushWith([id, target, data, length, now](BleCommand& command) {
+        command.id = id;
+        command.target = target;
+        command.length = (uint16_t)length;
+        command.receivedMicros = now;
+        memcpy(command.data, data, length);
+        command.data[length] = '\0';
+    });
+    if (!pushed) {
+        reject(id, target, length);
+    }
+    return pushed;
+}
+
+void BleCommandQueue::rejectInvalid(uint8_t target, size_t length, const char* detail, uint16_t& id) {
+    id = nextId.fetch_add(1, std::memory_order_relaxed);
+    reject(id, target, length, BleCommandRejection::Reason::INVALID, detail);
+}
+
+void BleCommandQueue::reject(uint16_t id, uint8_t target, size_t length,
+                             BleCommandRejection::Reason reason, const char* detail) {
+    rejected.fetch_add(1, std::memory_order_relaxed);
+    BleCommandRejection rejection;
+    rejection.id = id;
+    rejection.target = target;
+    rejection.length = length > 0xFFFF ? 0xFFFF : (uint16_t)length;
+    rejection.reason = reason;
+    rejection.detail = detail;
+    rejections.push(rejection);
+}
+
+BleCommandQueue::Statistics BleCommandQueue::getStatistics() const {
+    LockFreeRingBuffer<BleCommand, BLE_COMMAND_QUEUE_CAPACITY>::Statistics queueStats = queue.getStatistics();
+    Statistics stats;
+    stats.rejected = rejected.load(std::memory_order_relaxed);
+    // 队列满和内容无效的写入已计入rejected
+    stats.received = queueStats.pushed + stats.rejected;
+    stats.processed = queueStats.popped;
+    stats.highWatermark = queueStats.highWatermark;
+    stats.maxLatencyMicros = maxLatencyMicros.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void BleCommandQueue::resetStatistics() {
+    queue.resetStatistics();
+    rejected.store(0, std::memory_order_relaxed);
+    maxLatencyMicros.store(0, std::memory_order_relaxed);
+}
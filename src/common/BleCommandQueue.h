@@ -0,0 +1,181 @@
+#ifndef BLE_COMMAND_QUEUE_H
+#define BLE_COMMAND_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "Config.h"
+#include "LockFreeRingBuffer.h"
+#include "MonotonicClock.h"
+
+/**
+ * 一次BLE写入（复制自特征值，'\0'结尾）
+ */
+struct BleCommand {
+    uint16_t id;                // 写入编号（确认通知中返回）
+    uint8_t target;             // 写入的特征值，由使用者定义
+    uint16_t length;
+    uint64_t receivedMicros;    // 收到写入的时刻（MonotonicClock）
+    char data[BLE_COMMAND_MAX_LENGTH + 1];
+};
+
+/**
+ * 被拒绝的写入，由主循环记录错误并确认
+ */
+struct BleCommandRejection {
+    enum class Reason : uint8_t {
+        BUSY = 0,       // 队列已满或内容过长，确认为忙
+        INVALID = 1     // 内容无效（如分块写入出错），确认为失败
+    };
+
+    uint16_t id;
+    uint8_t target;
+    uint16_t length;
+    Reason reason;
+    const char* detail;         // 无效原因（静态字符串，可为nullptr）
+};
+
+/**
+ * 写入确认（BLE通知，与硬件无关）
+ *
+ * 固定布局，小端序，共8字节，默认MTU下一次通知即可传输：
+ *   偏移 长度 字段
+ *    0    2   写入编号（每次写入加1，包括被拒绝的写入）
+ *    2    1   写入的特征值（由使用者定义）
+ *    3    1   结果（BleCommandAck::Result）
+ *    4    4   从收到写入到开始执行的时间（微秒）
+ */
+struct BleCommandAck {
+    static const size_t SIZE = 8;
+
+    enum class Result : uint8_t {
+        OK = 0,         // 已执行（经外部总线的写入在完成后才确认）
+        FAILED = 1,     // 内容无效或执行失败
+        BUSY = 2        // 队列已满或内容过长，未执行，客户端可稍后重试
+    };
+
+    uint16_t id;
+    uint8_t target;
+    Result result;
+    uint32_t latencyMicros;
+
+    /**
+     * 编码
+     * @return 写入的字节数，缓冲区不足时返回0
+     */
+    static size_t encode(const BleCommandAck& ack, uint8_t* buffer, size_t size);
+
+    /**
+     * 解码
+     * @return 长度是否有效
+     */
+    static bool decode(const uint8_t* data, size_t length, BleCommandAck& ack);
+};
+
+/**
+ * BLE写入命令队列（与硬件无关）
+ *
+ * BLE写入回调只把内容复制进预先分配的槽位并唤醒主循环，由主循环调用process()执行。
+ * 保存NVS、MODBUS事务和生成JSON都不在BLE协议栈的回调中进行，不会拖慢协议栈导致连接超时。
+ * - enqueue()可在任意任务中调用，不阻塞、不分配内存；内容过长或队列满时立即失败
+ * - process()只能由主循环调用，每次最多执行maxCommands条，单次调用的耗时有上限
+ * - 每次写入都分配一个编号（包括被拒绝的写入），使用者据此发送确认通知
+ * - 被拒绝的写入记录在另一个无锁队列中，由主循环调用processRejected()取出、记录错误并确认，
+ *   BLE回调不访问确认特征值和错误信息；拒绝记录也满时不再记录（仍计入rejected），客户端按超时重试
+ */
+class BleCommandQueue {
+public:
+    /**
+     * 队列统计
+     */
+    struct Statistics {
+        uint32_t received;          // 收到的写入数
+        uint32_t processed;         // 已执行数
+        uint32_t rejected;          // 内容无效、过长或队列满被拒绝数
+        uint32_t highWatermark;     // 最大深度
+        uint32_t maxLatencyMicros;  // 从收到写入到开始执行的最长时间
+    };
+
+    BleCommandQueue();
+
+    /**
+     * 复制写入内容并入队（BLE任务调用）
+     * @param target 写入的特征值
+     * @param data 写入内容
+     * @param length 内容长度（不超过BLE_COMMAND_MAX_LENGTH）
+     * @param id 分配给该写入的编号（入队失败时也会分配）
+     * @return 是否入队成功；失败时记录为被拒绝的写入
+     */
+    bool enqueue(uint8_t target, const uint8_t* data, size_t length, uint16_t& id);
+
+    /**
+     * 记录内容无效、未能入队的写入（BLE任务调用）
+     * @param target 写入的特征值
+     * @param length 写入长度
+     * @param detail 无效原因，必须是静态字符串（主循环稍后读取）
+     * @param id 分配给该写入的编号
+     */
+    void rejectInvalid(uint8_t target, size_t length, const char* detail, uint16_t& id);
+
+    /**
+     * 按收到的顺序执行队列中的写入（仅主循环调用）
+     * @param handler 执行函数，参数为(const BleCommand& command, uint32_t latencyMicros)
+     * @param maxCommands 本次最多执行的条数
+     * @return 执行的条数
+     */
+    template <typename Handler>
+    uint32_t process(Handler handler, uint32_t maxCommands = BLE_COMMAND_MAX_PER_UPDATE) {
+        return queue.drain([this, &handler](BleCommand& command) {
+            uint64_t waited = MonotonicClock::nowMicros() - command.receivedMicros;
+            uint32_t latencyMicros = waited > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)waited;
+            if (latencyMicros > maxLatencyMicros.load(std::memory_order_relaxed)) {
+                maxLatencyMicros.store(latencyMicros, std::memory_order_relaxed);
+            }
+            handler(command, latencyMicros);
+        }, maxCommands);
+    }
+
+    /**
+     * 取出被拒绝的写入（仅主循环调用）
+     * @param handler 处理函数，参数为(const BleCommandRejection& rejection)
+     * @return 取出的条数
+     */
+    template <typename Handler>
+    uint32_t processRejected(Handler handler) {
+        return rejections.drain([&handler](BleCommandRejection& rejection) {
+            handler(rejection);
+        });
+    }
+
+    /**
+     * 是否有待执行的写入
+     */
+    bool hasPending() const { return !queue.empty(); }
+
+    /**
+     * 是否有待确认的被拒绝写入
+     */
+    bool hasRejected() const { return !rejections.empty(); }
+    uint32_t size() const { return queue.size(); }
+    static uint32_t capacity() { return BLE_COMMAND_QUEUE_CAPACITY; }
+
+    /**
+     * 丢弃待执行的写入（仅主循环调用）
+     * @return 丢弃的条数
+     */
+    uint32_t clear() { return queue.clear(); }
+
+    Statistics getStatistics() const;
+    void resetStatistics();
+
+private:
+    void reject(uint16_t id, uint8_t target, size_t length,
+                BleCommandRejection::Reason reason = BleCommandRejection::Reason::BUSY, const char* detail = nullptr);
+
+    LockFreeRingBuffer<BleCommand, BLE_COMMAND_QUEUE_CAPACITY> queue;
+    LockFreeRingBuffer<BleCommandRejection, BLE_COMMAND_QUEUE_CAPACITY> rejections;
+    std::atomic<uint16_t> nextId;
+    std::atomic<uint32_t> rejected;
+    std::atomic<uint32_t> maxLatencyMicros;     // 只由主循环更新
+};
+
+#endif // BLE_COMMAND_QUEUE_H
@@ -0,0 +1,152 @@
+#include "ChunkedTransfer.h"
+#include "../drivers/ModbusCRC.h"
+#include <string.h>
+
+namespace {
+
+void put16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+uint16_t get16(const uint8_t* p) {
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+} // namespace
+
+// ==========================
+// ChunkEncoder
+// ==========================
+ChunkEncoder::ChunkEncoder(const uint8_t* message, size_t length, uint8_t transferId, size_t maxFrameSize)
+    : message(message)
+    , length(length)
+    , maxPayload(maxFrameSize > ChunkFrame::HEADER_SIZE ? maxFrameSize - ChunkFrame::HEADER_SIZE : 0)
+    , offset(0)
+    , index(0)
+    , chunkCount(0)
+    , crc(0)
+    , transferId(transferId)
+    , valid(false) {
+    if (message == nullptr || length == 0 || length > ChunkFrame::MAX_MESSAGE_SIZE || maxPayload == 0) {
+        return;
+    }
+    size_t count = (length + maxPayload - 1) / maxPayload;
+    if (count > 0xFFFF) {
+        return;
+    }
+    chunkCount = (uint16_t)count;
+    crc = ModbusCRC::calculate(message, length);
+    valid = true;
+}
+
+size_t ChunkEncoder::next(uint8_t* buffer, size_t size) {
+    if (!valid || offset >= length) {
+        return 0;
+    }
+    size_t payload = length - offset;
+    if (payload > maxPayload) {
+        payload = maxPayload;
+    }
+    if (buffer == nullptr || size < ChunkFrame::HEADER_SIZE + payload) {
+        return 0;
+    }
+
+    buffer[0] = ChunkFrame::MARKER;
+    buffer[1] = transferId;
+    put16(&buffer[2], index);
+    put16(&buffer[4], (uint16_t)length);
+    put16(&buffer[6], crc);
+    memcpy(&buffer[ChunkFrame::HEADER_SIZE], message + offset, payload);
+
+    offset += payload;
+    index++;
+    return ChunkFrame::HEADER_SIZE + payload;
+}
+
+// ==========================
+// ChunkAssembler
+// ==========================
+ChunkAssembler::ChunkAssembler(uint8_t* buffer, size_t capacity)
+    : buffer(buffer)
+    , capacity(capacity)
+    , active(false)
+    , transferId(0)
+    , expectedIndex(0)
+    , totalLength(0)
+    , crc(0)
+    , received(0)
+    , completedLength(0)
+    , completedCount(0)
+    , errorCount(0)
+    , lastError("") {
+    if (buffer != nullptr && capacity > 0) {
+        buffer[0] = '\0';
+    }
+}
+
+void ChunkAssembler::reset() {
+    active = false;
+    received = 0;
+    expectedIndex = 0;
+}
+
+ChunkAssembler::Result ChunkAssembler::accept(const uint8_t* data, size_t length) {
+    completedLength = 0;
+    if (!ChunkFrame::isFrame(data, length)) {
+        return fail("帧头无效");
+    }
+
+    uint8_t id = data[1];
+    uint16_t index = get16(&data[2]);
+    uint16_t total = get16(&data[4]);
+    uint16_t frameCrc = get16(&data[6]);
+    const uint8_t* payload = data + ChunkFrame::HEADER_SIZE;
+    size_t payloadLength = length - ChunkFrame::HEADER_SIZE;
+
+    if (index == 0) {
+        // 新消息：丢弃未完成的消息
+        if (total == 0 || buffer == nullptr || total >= capacity) {
+            return fail("消息长度超出重组缓冲区");
+        }
+        active = true;
+        transferId = id;
+        expectedIndex = 0;
+        totalLength = total;
+        crc = frameCrc;
+        received = 0;
+    } else if (!active) {
+        return fail("缺少首帧");
+    } else if (id != transferId || total != totalLength || frameCrc != crc) {
+        return fail("帧不属于当前消息");
+    } else if (index != expectedIndex) {
+        return fail("帧序号不连续");
+    }
+
+    if (payloadLength == 0 || received + payloadLength > totalLength) {
+        return fail("帧负载长度无效");
+    }
+    memcpy(buffer + received, payload, payloadLength);
+    received += payloadLength;
+    expectedIndex++;
+
+    if (received < totalLength) {
+        return Result::INCOMPLETE;
+    }
+
+    active = false;
+    if (ModbusCRC::calculate(buffer, totalLength) != crc) {
+        return fail("CRC校验失败");
+    }
+    buffer[totalLength] = '\0';
+    completedLength = totalLength;
+    completedCount++;
+    return Result::COMPLETE;
+}
+
+ChunkAssembler::Result ChunkAssembler::fail(const char* error) {
+    reset();
+    lastError = error;
+    errorCount++;
+    return Result::ERROR;
+}
@@ -0,0 +1,147 @@
+#ifndef CHUNKED_TRANSFER_H
+#define CHUNKED_TRANSFER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * BLE分块传输帧（与硬件无关）
+ *
+ * 超过一个ATT包负载（MTU-3）的消息拆成多帧，通过同一特征值依次写入或通知。小端序，每帧8字节帧头：
+ *   偏移 长度 字段
+ *    0    1   标记（ChunkFrame::MARKER，UTF-8中不会出现，据此与未分块的文本区分）
+ *    1    1   传输编号（每条消息加1，回绕）
+ *    2    2   帧序号（从0开始）
+ *    4    2   消息总长度
+ *    6    2   整条消息的CRC16（MODBUS多项式，见ModbusCRC）
+ *    8    -   负载
+ * 帧必须按序号顺序到达；序号0开始新消息（丢弃未完成的消息），收齐总长度后校验CRC。
+ */
+struct ChunkFrame {
+    static const uint8_t MARKER = 0xFE;
+    static const size_t HEADER_SIZE = 8;
+    static const size_t MAX_MESSAGE_SIZE = 0xFFFF;
+
+    /**
+     * 判断数据是否为分块帧
+     */
+    static bool isFrame(const uint8_t* data, size_t length) {
+        return data != nullptr && length >= HEADER_SIZE && data[0] == MARKER;
+    }
+};
+
+/**
+ * 分块发送：按帧大小把消息依次编码为帧
+ *
+ *   ChunkEncoder encoder(json, length, transferId++, mtu - 3);
+ *   uint8_t frame[BLE_LOCAL_MTU];
+ *   size_t frameLength;
+ *   while ((frameLength = encoder.next(frame, sizeof(frame))) > 0) {
+ *       esp_ble_gatts_send_indicate(gattsIf, connId, characteristic->getHandle(), frameLength, frame, false);
+ *   }
+ */
+class ChunkEncoder {
+public:
+    /**
+     * @param message 消息（编码期间必须保持有效）
+     * @param length 消息长度（1 ~ ChunkFrame::MAX_MESSAGE_SIZE）
+     * @param transferId 传输编号
+     * @param maxFrameSize 单帧最大长度（含帧头），通常为MTU-3
+     */
+    ChunkEncoder(const uint8_t* message, size_t length, uint8_t transferId, size_t maxFrameSize);
+
+    /**
+     * 消息长度和帧大小是否有效
+     */
+    bool isValid() const { return valid; }
+    uint16_t getChunkCount() const { return chunkCount; }
+
+    /**
+     * 是否还有未编码的帧
+     */
+    bool hasNext() const { return valid && offset < length; }
+
+    /**
+     * 编码下一帧
+     * @param buffer 输出缓冲区
+     * @param size 缓冲区大小
+     * @return 帧长度；已全部编码、参数无效或缓冲区不足时为0
+     */
+    size_t next(uint8_t* buffer, size_t size);
+
+private:
+    const uint8_t* message;
+    size_t length;
+    size_t maxPayload;
+    size_t offset;
+    uint16_t index;
+    uint16_t chunkCount;
+    uint16_t crc;
+    uint8_t transferId;
+    bool valid;
+};
+
+/**
+ * 分块接收：在调用者提供的定长缓冲区中重组消息（不分配堆内存）
+ */
+class ChunkAssembler {
+public:
+    enum class Result : uint8_t {
+        INCOMPLETE = 0,     // 帧已接收，等待后续帧
+        COMPLETE = 1,       // 消息完整且CRC正确，可通过getData()读取
+        ERROR = 2           // 帧无效，未完成的消息已丢弃，原因见getLastError()
+    };
+
+    /**
+     * @param buffer 重组缓冲区
+     * @param capacity 缓冲区大小；消息最长capacity-1字节（完成后末尾写入'\0'，可直接作为字符串使用）
+     */
+    ChunkAssembler(uint8_t* buffer, size_t capacity);
+
+    /**
+     * 接收一帧
+     * @param data 帧数据（含帧头）
+     * @param length 帧长度
+     * @return 接收结果
+     */
+    Result accept(const uint8_t* data, size_t length);
+
+    /**
+     * 丢弃未完成的消息
+     */
+    void reset();
+
+    /**
+     * 是否正在接收消息（已收到序号0但尚未收齐）
+     */
+    bool isActive() const { return active; }
+
+    /**
+     * 最近完成的消息，在下一次accept()之前有效
+     */
+    const uint8_t* getData() const { return buffer; }
+    const char* getText() const { return reinterpret_cast<const char*>(buffer); }
+    size_t getLength() const { return completedLength; }
+
+    const char* getLastError() const { return lastError; }
+    uint32_t getCompletedCount() const { return completedCount; }
+    uint32_t getErrorCount() const { return errorCount; }
+
+private:
+    Result fail(const char* error);
+
+    uint8_t* buffer;
+    size_t capacity;
+    bool active;
+    uint8_t transferId;
+    uint16_t expectedIndex;
+    uint16_t totalLength;
+    uint16_t crc;
+    size_t received;
+    size_t completedLength;
+    uint32_t completedCount;
+    uint32_t errorCount;
+    const char* lastError;
+};
+
+#endif // CHUNKED_TRANSFER_H
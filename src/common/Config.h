@@ -28,6 +28,18 @@
 // 电机控制配置
 #define MOTOR_ON LOW   // 电机开启电平（低电平启动）
 #define MOTOR_OFF HIGH // 电机关闭电平（默认高电平）
+#define MOTOR_PHASE_TIMER_GRACE_MICROS 2000 // 相位定时器到期后仍未切换时，主循环兜底切换前的等待时间（微秒）
+#define MOTOR_MIN_RUN_DURATION_MS 10        // 最短运行时长（毫秒）
+#define MOTOR_MAX_DURATION_MS 604800000UL   // 运行/停止时长上限（毫秒，7天）
+
+// 电机PWM输出配置（输出方式为PWM时MOTOR_PIN由LEDC驱动，占空比按MOTOR_ON电平计算）
+#define MOTOR_PWM_CHANNEL 0                 // LEDC通道
+#define MOTOR_PWM_RESOLUTION_BITS 10        // 占空比分辨率（位）
+#define MOTOR_PWM_DEFAULT_FREQUENCY 1000    // 默认PWM频率 (Hz)
+#define MOTOR_PWM_MIN_FREQUENCY 10          // PWM频率下限 (Hz)
+#define MOTOR_PWM_MAX_FREQUENCY 40000       // PWM频率上限 (Hz，10位分辨率下LEDC最高约78kHz)
+#define MOTOR_PWM_MAX_SOFT_TIME_MS 6553500UL  // 缓启动/缓停止时间上限（毫秒，与调速器的0.1s×65535一致）
+#define MOTOR_PWM_RAMP_INTERVAL_MICROS 10000  // 缓启动/缓停止期间更新占空比的间隔（微秒）
 
 // 日志配置
 #define LOG_BUFFER_SIZE 512              // 日志缓冲区大小
@@ -38,6 +50,20 @@
 #define LOG_SHOW_LEVEL true              // 是否显示日志级别
 #define LOG_SHOW_TAG true                // 是否显示标签
 
+// 事件配置
+#define EVENT_QUEUE_CAPACITY 64     // 异步事件队列容量（必须为2的幂）
+#define EVENT_URGENT_QUEUE_CAPACITY 16  // 紧急事件队列容量（必须为2的幂）
+#define EVENT_PROCESS_BUDGET_US 2000    // 每次processEvents()的默认时间预算（微秒，0为不限）
+#define EVENT_TEXT_SIZE 16          // 事件内联文本负载长度（含结尾'\0'）
+#define EVENT_MESSAGE_MAX_LENGTH 96 // 事件消息格式化后的最大长度
+#define EVENT_MAX_LISTENERS 32      // 监听器总数上限
+#define EVENT_MAX_LISTENERS_PER_TYPE 16            // 单个事件类型的监听器上限
+#define EVENT_LISTENER_INLINE_SIZE (4 * sizeof(void*)) // 监听器内联存储大小，容纳std::function或小捕获的lambda
+
+// 主循环调度配置
+#define SCHEDULER_MODBUS_POLL_MICROS 1000      // MODBUS事务进行中时的轮询间隔（微秒）
+#define SCHEDULER_OVERRUN_THRESHOLD_MICROS 2000 // 任务执行晚于截止时间超过该值计为超期（微秒）
+
 // BLE配置
 #define BLE_DEVICE_NAME "ESP32-Motor-Control"
 // BLE UUID定义 - 与需求文档保持一致
@@ -47,26 +73,65 @@
 #define BLE_SYSTEM_CONTROL_CHAR_UUID "4f9a9c2e-6b1a-4b5e-8b2a-c1c2c3c4c5c8"
 #define BLE_STATUS_QUERY_CHAR_UUID "5f9a9c2e-6b1a-4b5e-8b2a-c1c2c3c4c5c9"
 #define BLE_SPEED_CONTROLLER_CONFIG_CHAR_UUID "6f9a9c2e-6b1a-4b5e-8b2a-c1c2c3c4c5ca"
+#define BLE_DIAGNOSTICS_CHAR_UUID "7f9a9c2e-6b1a-4b5e-8b2a-c1c2c3c4c5cb"
+#define BLE_PROGRAM_CHAR_UUID "8f9a9c2e-6b1a-4b5e-8b2a-c1c2c3c4c5cc"
+#define BLE_STATUS_BINARY_CHAR_UUID "9f9a9c2e-6b1a-4b5e-8b2a-c1c2c3c4c5cd"
+#define BLE_COMMAND_ACK_CHAR_UUID "af9a9c2e-6b1a-4b5e-8b2a-c1c2c3c4c5ce"
+
+// BLE状态通知（变化驱动，只发送变化的字段）
+#define BLE_STATUS_MIN_NOTIFY_INTERVAL_MS 200    // 两次状态通知的最小间隔（毫秒），期间的变化合并发送
+#define BLE_STATUS_MAX_NOTIFY_INTERVAL_MS 10000  // 无变化时的心跳间隔（毫秒）
+#define BLE_STATUS_KEYFRAME_INTERVAL 20          // 每N次增量通知后发送一次完整状态
+
+// BLE MTU与分块传输（超过MTU-3的通知/写入按ChunkFrame分块）
+#define BLE_LOCAL_MTU 512                 // 本机支持的ATT MTU，由客户端发起协商，取双方的较小值
+#define BLE_CHUNK_MAX_MESSAGE_SIZE 1024   // 分块写入/通知的最大消息长度（缓冲区预先分配）
+#define BLE_NOTIFY_PENDING_SLOTS 3        // 同时发送中的分块通知数（状态查询、调速器配置、电机程序各一条）
+#define BLE_NOTIFY_FRAMES_PER_BATCH 4     // 分块通知每批最多连续发送的帧数
+#define BLE_NOTIFY_BATCH_INTERVAL_MICROS 15000 // 两批分块通知之间的间隔（微秒，约一个连接间隔）
+
+// BLE写入命令队列（写入回调只复制内容，由主循环执行并发送确认通知）
+#define BLE_COMMAND_QUEUE_CAPACITY 8                        // 队列容量（必须为2的幂）
+#define BLE_COMMAND_MAX_LENGTH BLE_CHUNK_MAX_MESSAGE_SIZE   // 单条写入的最大长度（含分块写入重组后的消息）
+#define BLE_COMMAND_MAX_PER_UPDATE 4                        // 主循环每次最多执行的写入数
 
 // Modbus RTU 配置
 #define MODBUS_RX_PIN 8        // RX引脚
 #define MODBUS_TX_PIN 9        // TX引脚
 #define MODBUS_BAUD_RATE 9600  // 波特率
 #define MODBUS_SLAVE_ADDRESS 0x01  // 从机地址
+#define MODBUS_SETPOINT_EMIT_INTERVAL_MS 100  // 频率/占空比斜坡期间两次写入的最小间隔（毫秒）
+
+// 电机输出方式
+enum class MotorOutputMode : uint8_t
+{
+    SWITCH = 0, // GPIO开关输出，调速由MODBUS调速器完成
+    PWM = 1     // LEDC直接输出PWM，带缓启动/缓停止
+};
 
 // 配置参数结构体
 struct MotorConfig
 {
-    uint32_t runDuration;  // 运行时长 (秒)
-    uint32_t stopDuration; // 停止时长 (秒)
-    uint32_t cycleCount;   // 循环次数 (0表示无限循环)
-    bool autoStart;        // 是否自动启动
+    uint32_t runDurationMs;     // 运行时长 (毫秒)
+    uint32_t stopDurationMs;    // 停止时长 (毫秒，0表示持续运行)
+    uint32_t cycleCount;        // 循环次数 (0表示无限循环)
+    bool autoStart;             // 是否自动启动
+    MotorOutputMode outputMode; // 输出方式
+    uint32_t pwmFrequency;      // PWM频率 (Hz)
+    uint8_t pwmDutyCycle;       // PWM运行占空比 (0-100%)
+    uint32_t softStartMs;       // PWM缓启动时间 (毫秒，占空比从0升到100%的时间)
+    uint32_t softStopMs;        // PWM缓停止时间 (毫秒，占空比从100%降到0的时间)
 
     // 构造函数
-    MotorConfig() : runDuration(5),  // 默认5秒
-                    stopDuration(2), // 默认2秒
-                    cycleCount(0),   // 默认无限循环
-                    autoStart(true)  // 默认自动启动
+    MotorConfig() : runDurationMs(5000),  // 默认5秒
+                    stopDurationMs(2000), // 默认2秒
+                    cycleCount(0),        // 默认无限循环
+                    autoStart(true),      // 默认自动启动
+                    outputMode(MotorOutputMode::SWITCH),
+                    pwmFrequency(MOTOR_PWM_DEFAULT_FREQUENCY),
+                    pwmDutyCycle(100),
+                    softStartMs(0),
+                    softStopMs(0)
     {
     }
 };
@@ -0,0 +1,195 @@
+#include "DeadlineScheduler.h"
+#include <string.h>
+
+DeadlineScheduler::DeadlineScheduler(Clock clock, uint32_t overrunThresholdMicros)
+    : _clock(clock), _overrunThresholdMicros(overrunThresholdMicros), _taskCount(0), _pass(0),
+      _runningTask(INVALID_TASK) {
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        _tasks[i].name = nullptr;
+        _tasks[i].deadline = 0;
+        _tasks[i].inUse = false;
+        _tasks[i].scheduled = false;
+        _tasks[i].woken = false;
+        _tasks[i].lastPass = 0;
+        memset(&_tasks[i].stats, 0, sizeof(_tasks[i].stats));
+    }
+}
+
+int8_t DeadlineScheduler::addTask(const char* name, TaskFunction function, uint32_t firstDelayMicros) {
+    if (!function) {
+        return INVALID_TASK;
+    }
+
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        Task& task = _tasks[i];
+        // 正在执行的任务刚删除自己时，其函数对象还不能覆盖
+        if (task.inUse || static_cast<int8_t>(i) == _runningTask) {
+            continue;
+        }
+        task.name = name != nullptr ? name : "";
+        task.function = function;
+        task.inUse = true;
+        task.scheduled = false;
+        task.woken = false;
+        task.lastPass = _pass;
+        memset(&task.stats, 0, sizeof(task.stats));
+        _taskCount++;
+        runAfter(static_cast<int8_t>(i), firstDelayMicros);
+        return static_cast<int8_t>(i);
+    }
+    return INVALID_TASK;
+}
+
+bool DeadlineScheduler::removeTask(int8_t taskId) {
+    if (!isValid(taskId)) {
+        return false;
+    }
+
+    Task& task = _tasks[taskId];
+    task.inUse = false;
+    task.scheduled = false;
+    // 正在执行的任务删除自己时，函数对象在返回后才释放
+    if (taskId != _runningTask) {
+        task.function = nullptr;
+    }
+    _taskCount--;
+    return true;
+}
+
+bool DeadlineScheduler::runAfter(int8_t taskId, uint32_t delayMicros) {
+    if (!isValid(taskId)) {
+        return false;
+    }
+
+    Task& task = _tasks[taskId];
+    if (delayMicros == NO_DEADLINE) {
+        task.scheduled = false;
+        return true;
+    }
+    if (delayMicros > MAX_DELAY_MICROS) {
+        delayMicros = MAX_DELAY_MICROS;
+    }
+    task.deadline = _clock() + delayMicros;
+    task.scheduled = true;
+    task.woken = delayMicros == 0;
+    return true;
+}
+
+void DeadlineScheduler::wakeAll() {
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        if (_tasks[i].inUse && static_cast<int8_t>(i) != _runningTask) {
+            runAfter(static_cast<int8_t>(i), 0);
+        }
+    }
+}
+
+uint32_t DeadlineScheduler::runDue() {
+    _pass++;
+
+    for (;;) {
+        // 选出本轮尚未执行、已到期且截止时间最早的任务
+        uint32_t now = _clock();
+        Task* earliest = nullptr;
+        for (uint8_t i = 0; i < MAX_TASKS; i++) {
+            Task& task = _tasks[i];
+            if (!task.inUse || !task.scheduled || task.lastPass == _pass || !isDue(task.deadline, now)) {
+                continue;
+            }
+            if (earliest == nullptr || static_cast<int32_t>(task.deadline - earliest->deadline) < 0) {
+                earliest = &task;
+            }
+        }
+        if (earliest == nullptr) {
+            break;
+        }
+        runTask(*earliest, now);
+    }
+
+    return getMicrosUntilNextDeadline();
+}
+
+void DeadlineScheduler::runTask(Task& task, uint32_t now) {
+    int8_t taskId = static_cast<int8_t>(&task - _tasks);
+    uint32_t lateness = now - task.deadline;
+    bool woken = task.woken;
+
+    task.lastPass = _pass;
+    task.scheduled = false;
+    task.woken = false;
+
+    _runningTask = taskId;
+    uint32_t delay = task.function(now);
+    _runningTask = INVALID_TASK;
+    uint32_t runMicros = _clock() - now;
+
+    if (!task.inUse) {
+        // 执行期间被删除
+        task.function = nullptr;
+        return;
+    }
+
+    TaskStatistics& stats = task.stats;
+    stats.runs++;
+    stats.totalRunMicros += runMicros;
+    if (runMicros > stats.maxRunMicros) {
+        stats.maxRunMicros = runMicros;
+    }
+    if (!woken) {
+        if (lateness > stats.maxLatenessMicros) {
+            stats.maxLatenessMicros = lateness;
+        }
+        if (lateness > _overrunThresholdMicros) {
+            stats.overruns++;
+        }
+    }
+
+    // 执行期间被wake()/runAfter()重新安排时保留较早的截止时间
+    if (delay != NO_DEADLINE) {
+        if (delay > MAX_DELAY_MICROS) {
+            delay = MAX_DELAY_MICROS;
+        }
+        uint32_t deadline = now + delay;
+        if (!task.scheduled || static_cast<int32_t>(deadline - task.deadline) < 0) {
+            task.deadline = deadline;
+            task.scheduled = true;
+            task.woken = false;
+        }
+    }
+}
+
+uint32_t DeadlineScheduler::getMicrosUntilNextDeadline() const {
+    uint32_t now = _clock();
+    uint32_t wait = NO_DEADLINE;
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        const Task& task = _tasks[i];
+        if (!task.inUse || !task.scheduled) {
+            continue;
+        }
+        if (isDue(task.deadline, now)) {
+            return 0;
+        }
+        uint32_t remaining = task.deadline - now;
+        if (remaining < wait) {
+            wait = remaining;
+        }
+    }
+    return wait;
+}
+
+bool DeadlineScheduler::getStatistics(int8_t taskId, TaskStatistics& stats) const {
+    if (!isValid(taskId)) {
+        return false;
+    }
+    stats = _tasks[taskId].stats;
+    return true;
+}
+
+const char* DeadlineScheduler::getTaskName(int8_t taskId) const {
+    return isValid(taskId) ? _tasks[taskId].name : nullptr;
+}
+
+void DeadlineScheduler::resetStatistics() {
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        memset(&_tasks[i].stats, 0, sizeof(_tasks[i].stats));
+    }
+}
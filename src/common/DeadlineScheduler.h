@@ -0,0 +1,120 @@
+#ifndef DEADLINE_SCHEDULER_H
+#define DEADLINE_SCHEDULER_H
+
+#include <stdint.h>
+#include <functional>
+
+/**
+ * 基于截止时间的协作式调度器（与硬件无关）
+ *
+ * 每个任务执行后返回距下次执行的时间，runDue()按截止时间顺序执行所有到期任务，
+ * 并返回距最早截止时间的间隔，由调用者据此休眠（或被事件提前唤醒后调用wake()）。
+ * 时钟通过构造参数注入，主机测试可使用虚拟时钟。时间为32位微秒，按回绕安全的方式比较，
+ * 单次延迟不超过2^31微秒（约35分钟）。
+ *
+ * 统计每个任务的执行次数、执行耗时和相对截止时间的延迟，延迟超过阈值计为一次超期。
+ */
+class DeadlineScheduler {
+public:
+    static const uint8_t MAX_TASKS = 8;
+    static const int8_t INVALID_TASK = -1;
+
+    // 任务返回此值表示没有截止时间，只在wake()/wakeAll()后执行
+    static const uint32_t NO_DEADLINE = 0xFFFFFFFF;
+    static const uint32_t MAX_DELAY_MICROS = 0x7FFFFFFF;
+    static const uint32_t DEFAULT_OVERRUN_THRESHOLD_MICROS = 1000;
+
+    typedef uint32_t (*Clock)();
+
+    /**
+     * 任务函数
+     * @param nowMicros 本次执行开始的时刻
+     * @return 距下次执行的微秒数，或NO_DEADLINE
+     */
+    typedef std::function<uint32_t(uint32_t nowMicros)> TaskFunction;
+
+    /**
+     * 任务统计
+     */
+    struct TaskStatistics {
+        uint32_t runs;                  // 执行次数
+        uint32_t overruns;              // 执行时刻晚于截止时间超过阈值的次数
+        uint32_t maxLatenessMicros;     // 相对截止时间的最大延迟
+        uint32_t maxRunMicros;          // 单次最长执行耗时
+        uint32_t totalRunMicros;        // 累计执行耗时
+    };
+
+    /**
+     * @param clock 当前时刻（微秒）
+     * @param overrunThresholdMicros 计为超期的延迟阈值
+     */
+    explicit DeadlineScheduler(Clock clock, uint32_t overrunThresholdMicros = DEFAULT_OVERRUN_THRESHOLD_MICROS);
+
+    /**
+     * 添加任务
+     * @param name 任务名（静态字符串，只保存指针）
+     * @param firstDelayMicros 首次执行前的延迟，NO_DEADLINE表示等待唤醒
+     * @return 任务ID，任务表已满或函数为空时返回INVALID_TASK
+     */
+    int8_t addTask(const char* name, TaskFunction function, uint32_t firstDelayMicros = 0);
+    bool removeTask(int8_t taskId);
+
+    /**
+     * 把任务的截止时间设为从现在起delayMicros之后（NO_DEADLINE表示取消）
+     * 只会提前或推迟到指定时刻，不在本轮runDue()中重复执行已执行过的任务
+     */
+    bool runAfter(int8_t taskId, uint32_t delayMicros);
+
+    // 立即到期
+    bool wake(int8_t taskId) { return runAfter(taskId, 0); }
+
+    // 所有任务立即到期（正在执行的任务除外）
+    void wakeAll();
+
+    /**
+     * 按截止时间顺序执行所有到期任务，每个任务每次调用最多执行一次
+     * @return 距最早截止时间的微秒数；0表示已有任务再次到期，NO_DEADLINE表示没有截止时间
+     */
+    uint32_t runDue();
+
+    /**
+     * 距最早截止时间的微秒数，不执行任务
+     */
+    uint32_t getMicrosUntilNextDeadline() const;
+
+    bool getStatistics(int8_t taskId, TaskStatistics& stats) const;
+    const char* getTaskName(int8_t taskId) const;
+    uint8_t getTaskCount() const { return _taskCount; }
+    void resetStatistics();
+
+private:
+    struct Task {
+        const char* name;
+        TaskFunction function;
+        uint32_t deadline;
+        bool inUse;
+        bool scheduled;         // 有截止时间
+        bool woken;             // 由唤醒而非截止时间到期，不统计延迟
+        uint32_t lastPass;      // 最近一次执行所在的runDue()轮次
+        TaskStatistics stats;
+    };
+
+    static bool isDue(uint32_t deadline, uint32_t now) {
+        return static_cast<int32_t>(deadline - now) <= 0;
+    }
+
+    bool isValid(int8_t taskId) const {
+        return taskId >= 0 && taskId < MAX_TASKS && _tasks[taskId].inUse;
+    }
+
+    void runTask(Task& task, uint32_t now);
+
+    Clock _clock;
+    uint32_t _overrunThresholdMicros;
+    Task _tasks[MAX_TASKS];
+    uint8_t _taskCount;
+    uint32_t _pass;
+    int8_t _runningTask;
+};
+
+#endif // DEADLINE_SCHEDULER_H
@@ -1,9 +1,145 @@
 #include "EventManager.h"
 #include <algorithm>
+#include "WakeSignal.h"
 
 EventManager* EventManager::instance = nullptr;
 
-EventManager::EventManager() : isInitialized(false), queueMutex(nullptr) {}
+namespace {
+
+// 内置来源名，下标与EventSource一致
+const char* const BUILTIN_SOURCE_NAMES[] = {
+    "Unknown",
+    "MainController",
+    "MotorController",
+    "MotorBLEServer",
+    "LEDController",
+    "ConfigManager"
+};
+
+const uint8_t BUILTIN_SOURCE_COUNT = static_cast<uint8_t>(EventSource::FIRST_DYNAMIC);
+
+static_assert(sizeof(BUILTIN_SOURCE_NAMES) / sizeof(BUILTIN_SOURCE_NAMES[0]) == BUILTIN_SOURCE_COUNT,
+              "内置来源名与EventSource不一致");
+
+// 复制字符串并在UTF-8字符边界处截断
+void copyText(char* dest, size_t size, const char* src) {
+    size_t length = strlen(src);
+    if (length >= size) {
+        length = size - 1;
+        while (length > 0 && (static_cast<uint8_t>(src[length]) & 0xC0) == 0x80) {
+            length--;
+        }
+    }
+    memcpy(dest, src, length);
+    dest[length] = '\0';
+}
+
+} // namespace
+
+EventData::EventData(EventType t, const String& src, const String& msg, int32_t val, void* ext)
+    : EventData(t, EventManager::getInstance().internSource(src.c_str()), nullptr, val, ext) {
+    if (msg.length() > 0) {
+        withText(msg.c_str());
+    }
+}
+
+EventData& EventData::withInts(int32_t arg0, int32_t arg1) {
+    payloadType = EventPayloadType::INT;
+    payload.ints[0] = arg0;
+    payload.ints[1] = arg1;
+    return *this;
+}
+
+EventData& EventData::withFloats(float arg0, float arg1) {
+    payloadType = EventPayloadType::FLOAT;
+    payload.floats[0] = arg0;
+    payload.floats[1] = arg1;
+    return *this;
+}
+
+EventData& EventData::withText(const char* text) {
+    payloadType = EventPayloadType::TEXT;
+    copyText(payload.text, sizeof(payload.text), text ? text : "");
+    return *this;
+}
+
+bool EventData::hasMessage() const {
+    return (format != nullptr && format[0] != '\0') ||
+           (payloadType == EventPayloadType::TEXT && payload.text[0] != '\0');
+}
+
+size_t EventData::formatMessage(char* buffer, size_t size) const {
+    if (buffer == nullptr || size == 0) {
+        return 0;
+    }
+    
+    int length = 0;
+    if (format == nullptr) {
+        // 没有格式时只输出文本负载
+        length = snprintf(buffer, size, "%s", payloadType == EventPayloadType::TEXT ? payload.text : "");
+    } else {
+        switch (payloadType) {
+            case EventPayloadType::INT:
+                length = snprintf(buffer, size, format, static_cast<long>(payload.ints[0]),
+                                  static_cast<long>(payload.ints[1]));
+                break;
+            case EventPayloadType::FLOAT:
+                length = snprintf(buffer, size, format, static_cast<double>(payload.floats[0]),
+                                  static_cast<double>(payload.floats[1]));
+                break;
+            case EventPayloadType::TEXT:
+                length = snprintf(buffer, size, format, payload.text);
+                break;
+            default:
+                length = snprintf(buffer, size, "%s", format);
+                break;
+        }
+    }
+    
+    if (length < 0) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    return static_cast<size_t>(length) < size ? length : size - 1;
+}
+
+String EventData::getMessage() const {
+    char buffer[EVENT_MESSAGE_MAX_LENGTH];
+    formatMessage(buffer, sizeof(buffer));
+    return String(buffer);
+}
+
+const char* EventData::getSourceName() const {
+    return EventManager::getInstance().getSourceName(source);
+}
+
+EventManager::EventManager()
+    : dispatchDepth(0), pendingRemoval(false), pendingMask(0), coalescedAccepted(0), coalescedDispatched(0),
+      coalescedMerged(0), budgetStops(0), isInitialized(false), sourceCount(0), sourceMutex(nullptr) {
+    static_assert(EVENT_TYPE_COUNT <= 32, "pendingMask按位标记事件类型");
+    
+    for (uint8_t i = 0; i < EVENT_MAX_LISTENERS; i++) {
+        listenerSlots[i].generation = 0;
+        listenerSlots[i].type = EventType::CUSTOM_EVENT;
+        listenerSlots[i].inUse = false;
+        listenerSlots[i].active = false;
+    }
+    memset(listenerCounts, 0, sizeof(listenerCounts));
+    
+    for (uint8_t i = 0; i < EVENT_TYPE_COUNT; i++) {
+        coalescingPolicies[i].store(static_cast<uint8_t>(EventCoalescing::KEEP_ALL), std::memory_order_relaxed);
+        priorities[i].store(static_cast<uint8_t>(EventPriority::NORMAL), std::memory_order_relaxed);
+        eventCounts[i].store(0, std::memory_order_relaxed);
+    }
+    // 状态类事件只关心最新值；错误和停机优先于其他事件分发
+    setEventPolicy(EventType::MOTOR_SPEED_CHANGED, EventCoalescing::KEEP_LATEST, EventPriority::NORMAL);
+    setEventPolicy(EventType::LED_STATE_CHANGED, EventCoalescing::KEEP_LATEST, EventPriority::NORMAL);
+    setEventPolicy(EventType::ERROR_OCCURRED, EventCoalescing::KEEP_ALL, EventPriority::URGENT);
+    setEventPolicy(EventType::MOTOR_STOP, EventCoalescing::KEEP_ALL, EventPriority::URGENT);
+    setEventPolicy(EventType::SYSTEM_SHUTDOWN, EventCoalescing::KEEP_ALL, EventPriority::URGENT);
+    
+    sourceMutex = xSemaphoreCreateMutex();
+}
 
 EventManager& EventManager::getInstance() {
     if (instance == nullptr) {
@@ -17,55 +153,128 @@ bool EventManager::initialize() {
         return true;
     }
     
-    queueMutex = xSemaphoreCreateMutex();
-    if (queueMutex == nullptr) {
-        return false;
-    }
-    
     isInitialized = true;
     return true;
 }
 
 void EventManager::cleanup() {
-    if (queueMutex != nullptr) {
-        vSemaphoreDelete(queueMutex);
-        queueMutex = nullptr;
+    for (uint8_t i = 0; i < EVENT_MAX_LISTENERS; i++) {
+        if (listenerSlots[i].active) {
+            deactivateSlot(listenerSlots[i]);
+        }
     }
-    
-    listeners.clear();
-    eventQueue.clear();
+    clearQueue();
     isInitialized = false;
 }
 
-bool EventManager::subscribe(EventType type, EventListener listener) {
-    if (!isInitialized || listener == nullptr) {
-        return false;
+EventManager::ListenerSlot* EventManager::acquireSlot(EventType type) {
+    uint8_t typeIndex = static_cast<uint8_t>(type);
+    if (!isInitialized || typeIndex >= EVENT_TYPE_COUNT ||
+        listenerCounts[typeIndex] >= EVENT_MAX_LISTENERS_PER_TYPE) {
+        return nullptr;
     }
     
-    listeners[type].push_back(listener);
-    return true;
+    for (uint8_t i = 0; i < EVENT_MAX_LISTENERS; i++) {
+        if (!listenerSlots[i].inUse) {
+            listenerSlots[i].inUse = true;
+            listenerSlots[i].type = type;
+            return &listenerSlots[i];
+        }
+    }
+    return nullptr;
 }
 
-bool EventManager::unsubscribe(EventType type, EventListener listener) {
-    if (!isInitialized || listener == nullptr) {
-        return false;
+EventSubscription EventManager::activateSlot(ListenerSlot& slot) {
+    uint8_t index = static_cast<uint8_t>(&slot - listenerSlots);
+    uint8_t typeIndex = static_cast<uint8_t>(slot.type);
+    
+    // 分发中新增的监听器追加在末尾，不会收到正在分发的事件
+    dispatchTable[typeIndex][listenerCounts[typeIndex]++] = index;
+    slot.active = true;
+    return ((slot.generation & 0xFFFFFF) << 8) | (index + 1);
+}
+
+void EventManager::deactivateSlot(ListenerSlot& slot) {
+    slot.active = false;
+    slot.generation++;
+    pendingRemoval = true;
+    
+    // 分发过程中监听器可能正在执行（例如取消自己），等分发结束再释放
+    if (dispatchDepth == 0) {
+        compactListeners();
+    }
+}
+
+void EventManager::compactListeners() {
+    for (uint8_t type = 0; type < EVENT_TYPE_COUNT; type++) {
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < listenerCounts[type]; i++) {
+            uint8_t index = dispatchTable[type][i];
+            if (listenerSlots[index].active) {
+                dispatchTable[type][kept++] = index;
+            }
+        }
+        listenerCounts[type] = kept;
     }
     
-    auto it = listeners.find(type);
-    if (it == listeners.end()) {
+    for (uint8_t i = 0; i < EVENT_MAX_LISTENERS; i++) {
+        ListenerSlot& slot = listenerSlots[i];
+        if (slot.inUse && !slot.active) {
+            slot.function.reset();
+            slot.inUse = false;
+        }
+    }
+    pendingRemoval = false;
+}
+
+bool EventManager::unsubscribe(EventSubscription subscription) {
+    uint32_t index = (subscription & 0xFF) - 1;
+    if (subscription == INVALID_EVENT_SUBSCRIPTION || index >= EVENT_MAX_LISTENERS) {
         return false;
     }
     
-    auto& vec = it->second;
+    ListenerSlot& slot = listenerSlots[index];
+    if (!slot.active || (slot.generation & 0xFFFFFF) != (subscription >> 8)) {
+        return false;
+    }
     
-    // 由于std::function无法直接比较，我们清空该类型的所有监听器
-    vec.clear();
+    deactivateSlot(slot);
+    return true;
+}
+
+bool EventManager::unsubscribeAll(EventType type) {
+    bool removed = false;
+    for (uint8_t i = 0; i < EVENT_MAX_LISTENERS; i++) {
+        ListenerSlot& slot = listenerSlots[i];
+        if (slot.active && slot.type == type) {
+            deactivateSlot(slot);
+            removed = true;
+        }
+    }
+    return removed;
+}
+
+bool EventManager::unsubscribe(EventType type, const EventListener& listener) {
+    if (!isInitialized || listener == nullptr) {
+        return false;
+    }
     
-    if (vec.empty()) {
-        listeners.erase(it);
+    return unsubscribeAll(type);
+}
+
+uint8_t EventManager::getListenerCount(EventType type) const {
+    uint8_t typeIndex = static_cast<uint8_t>(type);
+    if (typeIndex >= EVENT_TYPE_COUNT) {
+        return 0;
     }
     
-    return true;
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < listenerCounts[typeIndex]; i++) {
+        if (listenerSlots[dispatchTable[typeIndex][i]].active) {
+            count++;
+        }
+    }
+    return count;
 }
 
 bool EventManager::publish(const EventData& event) {
@@ -73,78 +282,264 @@ bool EventManager::publish(const EventData& event) {
         return false;
     }
     
-    auto it = listeners.find(event.type);
-    if (it == listeners.end()) {
+    uint8_t typeIndex = static_cast<uint8_t>(event.type);
+    if (typeIndex >= EVENT_TYPE_COUNT || listenerCounts[typeIndex] == 0) {
         return false;
     }
     
-    for (const auto& listener : it->second) {
-        if (listener != nullptr) {
-            listener(event);
+    // 只分发给开始时已订阅的监听器
+    uint8_t count = listenerCounts[typeIndex];
+    bool delivered = false;
+    dispatchDepth++;
+    for (uint8_t i = 0; i < count; i++) {
+        ListenerSlot& slot = listenerSlots[dispatchTable[typeIndex][i]];
+        if (slot.active) {
+            slot.function(event);
+            delivered = true;
         }
     }
+    dispatchDepth--;
     
-    return true;
+    if (dispatchDepth == 0 && pendingRemoval) {
+        compactListeners();
+    }
+    
+    return delivered;
 }
 
 bool EventManager::publishAsync(const EventData& event) {
-    if (!isInitialized || queueMutex == nullptr) {
+    if (!isInitialized) {
         return false;
     }
     
-    if (xSemaphoreTake(queueMutex, portMAX_DELAY) == pdTRUE) {
-        eventQueue.push_back(event);
-        xSemaphoreGive(queueMutex);
-        return true;
+    uint8_t typeIndex = static_cast<uint8_t>(event.type);
+    if (typeIndex >= EVENT_TYPE_COUNT) {
+        return false;
     }
     
-    return false;
+    EventCoalescing coalescing = static_cast<EventCoalescing>(
+        coalescingPolicies[typeIndex].load(std::memory_order_relaxed));
+    bool queued;
+    if (coalescing != EventCoalescing::KEEP_ALL) {
+        queued = publishCoalesced(event, typeIndex, coalescing);
+    } else if (priorities[typeIndex].load(std::memory_order_relaxed) == static_cast<uint8_t>(EventPriority::URGENT)) {
+        queued = urgentQueue.push(event);
+    } else {
+        queued = normalQueue.push(event);
+    }
+    
+    // 唤醒休眠中的主循环（可能在定时器中断中发布）
+    if (queued) {
+        WakeSignal::getInstance().notifyAny();
+    }
+    return queued;
 }
 
-void EventManager::processEvents() {
-    if (!isInitialized || queueMutex == nullptr) {
-        return;
+bool EventManager::publishCoalesced(const EventData& event, uint8_t typeIndex, EventCoalescing coalescing) {
+    uint32_t bit = 1UL << typeIndex;
+    bool merged;
+    
+    if (coalescing == EventCoalescing::COUNT_ONLY) {
+        merged = eventCounts[typeIndex].fetch_add(1, std::memory_order_relaxed) > 0;
+    } else {
+        // 临界区内只复制一个定长事件
+        portENTER_CRITICAL_SAFE(&coalesceMux);
+        merged = (pendingMask.load(std::memory_order_relaxed) & bit) != 0;
+        latestEvents[typeIndex] = event;
+        pendingMask.fetch_or(bit, std::memory_order_release);
+        portEXIT_CRITICAL_SAFE(&coalesceMux);
     }
     
-    std::vector<EventData> localQueue;
+    coalescedAccepted.fetch_add(1, std::memory_order_relaxed);
+    if (merged) {
+        coalescedMerged.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool EventManager::takeCoalesced(uint8_t typeIndex, EventData& event) {
+    uint32_t bit = 1UL << typeIndex;
+    bool taken = false;
     
-    // 复制事件到本地队列
-    if (xSemaphoreTake(queueMutex, portMAX_DELAY) == pdTRUE) {
-        localQueue = eventQueue;
-        eventQueue.clear();
-        xSemaphoreGive(queueMutex);
+    uint32_t count = eventCounts[typeIndex].exchange(0, std::memory_order_acquire);
+    if (count > 0) {
+        event = EventData(static_cast<EventType>(typeIndex), EventSource::UNKNOWN, nullptr,
+                          static_cast<int32_t>(count));
+        taken = true;
+    } else {
+        portENTER_CRITICAL_SAFE(&coalesceMux);
+        if ((pendingMask.load(std::memory_order_relaxed) & bit) != 0) {
+            pendingMask.fetch_and(~bit, std::memory_order_relaxed);
+            event = latestEvents[typeIndex];
+            taken = true;
+        }
+        portEXIT_CRITICAL_SAFE(&coalesceMux);
     }
     
-    // 处理本地队列中的事件
-    for (const auto& event : localQueue) {
+    if (taken) {
+        coalescedDispatched.fetch_add(1, std::memory_order_relaxed);
+    }
+    return taken;
+}
+
+uint32_t EventManager::getCoalescedPending() const {
+    uint32_t pending = pendingMask.load(std::memory_order_acquire);
+    for (uint8_t typeIndex = 0; typeIndex < EVENT_TYPE_COUNT; typeIndex++) {
+        if (eventCounts[typeIndex].load(std::memory_order_relaxed) > 0) {
+            pending |= 1UL << typeIndex;
+        }
+    }
+    return pending;
+}
+
+bool EventManager::budgetExceeded(uint32_t startMicros, uint32_t budgetMicros, uint32_t processed) const {
+    return budgetMicros > 0 && processed > 0 && micros() - startMicros >= budgetMicros;
+}
+
+uint32_t EventManager::processLane(EventPriority priority, uint32_t queued, uint32_t startMicros,
+                                   uint32_t budgetMicros, uint32_t& processed) {
+    auto dispatch = [this](EventData& event) {
         publish(event);
+    };
+    
+    // 队列中的事件按入队顺序逐个分发，每个之后检查预算
+    while (queued > 0 && !budgetExceeded(startMicros, budgetMicros, processed)) {
+        uint32_t count = priority == EventPriority::URGENT ? urgentQueue.drain(dispatch, 1)
+                                                           : normalQueue.drain(dispatch, 1);
+        if (count == 0) {
+            queued = 0;
+            break;
+        }
+        queued--;
+        processed++;
+    }
+    
+    // 合并的事件：每个待处理的类型分发一次
+    uint32_t pending = getCoalescedPending();
+    for (uint8_t typeIndex = 0; typeIndex < EVENT_TYPE_COUNT && pending != 0; typeIndex++) {
+        if ((pending & (1UL << typeIndex)) == 0 ||
+            priorities[typeIndex].load(std::memory_order_relaxed) != static_cast<uint8_t>(priority)) {
+            continue;
+        }
+        if (budgetExceeded(startMicros, budgetMicros, processed)) {
+            return queued + 1;
+        }
+        EventData event;
+        if (takeCoalesced(typeIndex, event)) {
+            publish(event);
+            processed++;
+        }
+    }
+    
+    return queued;
+}
+
+uint32_t EventManager::processEvents(uint32_t budgetMicros) {
+    if (!isInitialized) {
+        return 0;
+    }
+    
+    // 只处理调用时已入队的事件，监听器中再发布的异步事件留到下一次
+    uint32_t urgentQueued = urgentQueue.size();
+    uint32_t normalQueued = normalQueue.size();
+    if (urgentQueued == 0 && normalQueued == 0 && getCoalescedPending() == 0) {
+        return 0;
+    }
+    
+    uint32_t startMicros = micros();
+    uint32_t processed = 0;
+    uint32_t remaining = processLane(EventPriority::URGENT, urgentQueued, startMicros, budgetMicros, processed);
+    if (remaining == 0) {
+        remaining = processLane(EventPriority::NORMAL, normalQueued, startMicros, budgetMicros, processed);
+    } else {
+        remaining += normalQueued;
+    }
+    
+    if (remaining > 0) {
+        budgetStops.fetch_add(1, std::memory_order_relaxed);
     }
+    return processed;
 }
 
 size_t EventManager::getQueueSize() const {
-    if (!isInitialized || queueMutex == nullptr) {
+    if (!isInitialized) {
         return 0;
     }
     
-    size_t size = 0;
-    if (xSemaphoreTake(queueMutex, portMAX_DELAY) == pdTRUE) {
-        size = eventQueue.size();
-        xSemaphoreGive(queueMutex);
+    uint32_t pending = getCoalescedPending();
+    size_t coalesced = 0;
+    while (pending != 0) {
+        pending &= pending - 1;
+        coalesced++;
     }
-    return size;
+    return urgentQueue.size() + normalQueue.size() + coalesced;
 }
 
 void EventManager::clearQueue() {
-    if (!isInitialized || queueMutex == nullptr) {
+    if (!isInitialized) {
         return;
     }
     
-    if (xSemaphoreTake(queueMutex, portMAX_DELAY) == pdTRUE) {
-        eventQueue.clear();
-        xSemaphoreGive(queueMutex);
+    urgentQueue.clear();
+    normalQueue.clear();
+    
+    EventData discarded;
+    for (uint8_t typeIndex = 0; typeIndex < EVENT_TYPE_COUNT; typeIndex++) {
+        while (takeCoalesced(typeIndex, discarded)) {
+        }
     }
 }
 
+EventManager::QueueStatistics EventManager::getQueueStatistics() const {
+    UrgentEventQueue::Statistics urgent = urgentQueue.getStatistics();
+    EventQueue::Statistics normal = normalQueue.getStatistics();
+    
+    QueueStatistics stats;
+    stats.pushed = urgent.pushed + normal.pushed + coalescedAccepted.load(std::memory_order_relaxed);
+    stats.popped = urgent.popped + normal.popped + coalescedDispatched.load(std::memory_order_relaxed);
+    stats.overflows = urgent.overflows + normal.overflows;
+    stats.highWatermark = std::max(urgent.highWatermark, normal.highWatermark);
+    stats.coalesced = coalescedMerged.load(std::memory_order_relaxed);
+    stats.budgetStops = budgetStops.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void EventManager::resetQueueStatistics() {
+    urgentQueue.resetStatistics();
+    normalQueue.resetStatistics();
+    coalescedAccepted.store(0, std::memory_order_relaxed);
+    coalescedDispatched.store(0, std::memory_order_relaxed);
+    coalescedMerged.store(0, std::memory_order_relaxed);
+    budgetStops.store(0, std::memory_order_relaxed);
+}
+
+void EventManager::setEventPolicy(EventType type, EventCoalescing coalescing, EventPriority priority) {
+    uint8_t typeIndex = static_cast<uint8_t>(type);
+    if (typeIndex >= EVENT_TYPE_COUNT) {
+        return;
+    }
+    
+    // 已合并待处理的事件不受影响，仍会被分发
+    coalescingPolicies[typeIndex].store(static_cast<uint8_t>(coalescing), std::memory_order_relaxed);
+    priorities[typeIndex].store(static_cast<uint8_t>(priority), std::memory_order_relaxed);
+}
+
+EventCoalescing EventManager::getCoalescing(EventType type) const {
+    uint8_t typeIndex = static_cast<uint8_t>(type);
+    if (typeIndex >= EVENT_TYPE_COUNT) {
+        return EventCoalescing::KEEP_ALL;
+    }
+    return static_cast<EventCoalescing>(coalescingPolicies[typeIndex].load(std::memory_order_relaxed));
+}
+
+EventPriority EventManager::getPriority(EventType type) const {
+    uint8_t typeIndex = static_cast<uint8_t>(type);
+    if (typeIndex >= EVENT_TYPE_COUNT) {
+        return EventPriority::NORMAL;
+    }
+    return static_cast<EventPriority>(priorities[typeIndex].load(std::memory_order_relaxed));
+}
+
 String EventManager::getEventTypeName(EventType type) {
     switch (type) {
         case EventType::SYSTEM_STARTUP: return "SYSTEM_STARTUP";
@@ -162,4 +557,51 @@ String EventManager::getEventTypeName(EventType type) {
         case EventType::CUSTOM_EVENT: return "CUSTOM_EVENT";
         default: return "UNKNOWN";
     }
+}
+
+EventSource EventManager::internSource(const char* name) {
+    if (name == nullptr || name[0] == '\0') {
+        return EventSource::UNKNOWN;
+    }
+    
+    for (uint8_t i = 0; i < BUILTIN_SOURCE_COUNT; i++) {
+        if (strcmp(name, BUILTIN_SOURCE_NAMES[i]) == 0) {
+            return static_cast<EventSource>(i);
+        }
+    }
+    
+    if (sourceMutex == nullptr || xSemaphoreTake(sourceMutex, portMAX_DELAY) != pdTRUE) {
+        return EventSource::UNKNOWN;
+    }
+    
+    // 按截断后的名称比较，超长的同名来源得到同一ID
+    char truncated[SOURCE_NAME_SIZE];
+    copyText(truncated, sizeof(truncated), name);
+    
+    EventSource result = EventSource::UNKNOWN;
+    for (uint8_t i = 0; i < sourceCount; i++) {
+        if (strcmp(truncated, sourceNames[i]) == 0) {
+            result = static_cast<EventSource>(BUILTIN_SOURCE_COUNT + i);
+            break;
+        }
+    }
+    if (result == EventSource::UNKNOWN && sourceCount < MAX_DYNAMIC_SOURCES) {
+        memcpy(sourceNames[sourceCount], truncated, sizeof(truncated));
+        result = static_cast<EventSource>(BUILTIN_SOURCE_COUNT + sourceCount);
+        sourceCount++;
+    }
+    
+    xSemaphoreGive(sourceMutex);
+    return result;
+}
+
+const char* EventManager::getSourceName(EventSource source) {
+    uint8_t id = static_cast<uint8_t>(source);
+    if (id < BUILTIN_SOURCE_COUNT) {
+        return BUILTIN_SOURCE_NAMES[id];
+    }
+    
+    // 驻留的名称只增不减，读取不需要加锁
+    id -= BUILTIN_SOURCE_COUNT;
+    return id < sourceCount ? sourceNames[id] : BUILTIN_SOURCE_NAMES[0];
 }
\ No newline at end of file
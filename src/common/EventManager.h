@@ -2,9 +2,12 @@
 #define EVENT_MANAGER_H
 
 #include <Arduino.h>
+#include <atomic>
 #include <functional>
 #include <vector>
-#include <map>
+#include "Config.h"
+#include "InlineFunction.h"
+#include "LockFreeRingBuffer.h"
 
 // 事件类型枚举
 enum class EventType {
@@ -23,31 +26,171 @@ enum class EventType {
     CUSTOM_EVENT
 };
 
+// 事件来源（驻留ID，事件中不携带来源字符串）
+enum class EventSource : uint8_t {
+    UNKNOWN = 0,
+    MAIN_CONTROLLER,
+    MOTOR_CONTROLLER,
+    BLE_SERVER,
+    LED_CONTROLLER,
+    CONFIG_MANAGER,
+    FIRST_DYNAMIC       // EventManager::internSource()分配的ID从这里开始
+};
+
+// 事件负载类型
+enum class EventPayloadType : uint8_t {
+    NONE,
+    INT,                // payload.ints，消息格式使用%ld
+    FLOAT,              // payload.floats，消息格式使用%f
+    TEXT                // payload.text，消息格式使用%s
+};
+
+// 异步事件的合并策略
+enum class EventCoalescing : uint8_t {
+    KEEP_ALL,           // 每个事件都排队分发
+    KEEP_LATEST,        // 只保留最新的一个，分发前被新事件覆盖（状态类事件）
+    COUNT_ONLY          // 只计数，分发一个value为累计次数、不带来源和消息的事件
+};
+
+// 异步事件的优先级，数值越小越先分发
+enum class EventPriority : uint8_t {
+    URGENT = 0,         // 错误、停机
+    NORMAL = 1
+};
+
 // 事件数据结构
+// 定长、不持有堆内存：来源为驻留ID，消息为静态格式字符串加内联负载，
+// 只有监听器调用getMessage()/formatMessage()时才格式化文本
 struct EventData {
     EventType type;
-    String source;
-    String message;
+    EventSource source;
+    EventPayloadType payloadType;
+    const char* format;         // 消息格式，必须是静态字符串（不复制），可为nullptr
     int32_t value;
     void* extraData;
+    union {
+        int32_t ints[2];
+        float floats[2];
+        char text[EVENT_TEXT_SIZE];
+    } payload;
     
-    EventData(EventType t, const String& src = "", const String& msg = "", int32_t val = 0, void* ext = nullptr)
-        : type(t), source(src), message(msg), value(val), extraData(ext) {}
+    EventData() : EventData(EventType::CUSTOM_EVENT) {}
+    
+    EventData(EventType t, EventSource src = EventSource::UNKNOWN, const char* fmt = nullptr,
+              int32_t val = 0, void* ext = nullptr)
+        : type(t), source(src), payloadType(EventPayloadType::NONE), format(fmt), value(val), extraData(ext) {
+        payload.ints[0] = 0;
+        payload.ints[1] = 0;
+    }
+    
+    // 兼容旧接口：来源名在EventManager中驻留，消息复制到内联文本（超长截断）
+    EventData(EventType t, const String& src, const String& msg = "", int32_t val = 0, void* ext = nullptr);
+    
+    // 设置消息参数，可链式调用
+    EventData& withInts(int32_t arg0, int32_t arg1 = 0);
+    EventData& withFloats(float arg0, float arg1 = 0.0f);
+    EventData& withText(const char* text);
+    
+    bool hasMessage() const;
+    
+    /**
+     * 按格式和负载生成消息文本
+     * @return 写入的字符数（不含结尾'\0'）
+     */
+    size_t formatMessage(char* buffer, size_t size) const;
+    String getMessage() const;
+    const char* getSourceName() const;
 };
 
 // 事件监听器类型
 using EventListener = std::function<void(const EventData&)>;
 
+// 订阅句柄：低8位为监听器槽位号+1，高24位为槽位的代数，取消订阅后旧句柄失效
+typedef uint32_t EventSubscription;
+const EventSubscription INVALID_EVENT_SUBSCRIPTION = 0;
+
 class EventManager {
+public:
+    // 异步事件队列：无锁多生产者/单消费者，processEvents()为唯一消费者
+    typedef LockFreeRingBuffer<EventData, EVENT_QUEUE_CAPACITY> EventQueue;
+    typedef LockFreeRingBuffer<EventData, EVENT_URGENT_QUEUE_CAPACITY> UrgentEventQueue;
+    
+    /**
+     * 异步事件统计（两条队列和合并事件之和）
+     * 满足 pushed = popped + coalesced + 当前待处理数
+     */
+    struct QueueStatistics {
+        uint32_t pushed;            // publishAsync()接受的事件数
+        uint32_t popped;            // 分发或清除的事件数
+        uint32_t overflows;         // 队列满被丢弃数
+        uint32_t highWatermark;     // 单条队列的最大深度
+        uint32_t coalesced;         // 被合并（未单独分发）的事件数
+        uint32_t budgetStops;       // 因时间预算用完而留下事件的processEvents()次数
+    };
+    
 private:
+    static const uint8_t MAX_DYNAMIC_SOURCES = 16;
+    static const uint8_t SOURCE_NAME_SIZE = 24;
+    
+    static const uint8_t EVENT_TYPE_COUNT = static_cast<uint8_t>(EventType::CUSTOM_EVENT) + 1;
+    
+    // 监听器槽位：可调用对象内联存放，取消订阅时代数加一
+    struct ListenerSlot {
+        InlineFunction<void(const EventData&), EVENT_LISTENER_INLINE_SIZE> function;
+        uint32_t generation;
+        EventType type;
+        bool inUse;         // 槽位已占用（取消订阅后到压缩前仍占用）
+        bool active;        // 接收事件
+    };
+    
     static EventManager* instance;
-    std::map<EventType, std::vector<EventListener>> listeners;
-    std::vector<EventData> eventQueue;
-    SemaphoreHandle_t queueMutex;
+    
+    // 按事件类型索引的分发表，每行按订阅顺序保存槽位号
+    ListenerSlot listenerSlots[EVENT_MAX_LISTENERS];
+    uint8_t dispatchTable[EVENT_TYPE_COUNT][EVENT_MAX_LISTENERS_PER_TYPE];
+    uint8_t listenerCounts[EVENT_TYPE_COUNT];
+    uint8_t dispatchDepth;      // 正在分发的嵌套层数，期间取消订阅只做标记
+    bool pendingRemoval;
+    
+    // 异步事件：按优先级分两条无锁队列；合并的事件按类型存放，KEEP_LATEST用pendingMask标记
+    UrgentEventQueue urgentQueue;
+    EventQueue normalQueue;
+    std::atomic<uint8_t> coalescingPolicies[EVENT_TYPE_COUNT];
+    std::atomic<uint8_t> priorities[EVENT_TYPE_COUNT];
+    EventData latestEvents[EVENT_TYPE_COUNT];           // KEEP_LATEST，由coalesceMux保护
+    std::atomic<uint32_t> eventCounts[EVENT_TYPE_COUNT]; // COUNT_ONLY
+    std::atomic<uint32_t> pendingMask;
+    portMUX_TYPE coalesceMux = portMUX_INITIALIZER_UNLOCKED;
+    std::atomic<uint32_t> coalescedAccepted;
+    std::atomic<uint32_t> coalescedDispatched;
+    std::atomic<uint32_t> coalescedMerged;
+    std::atomic<uint32_t> budgetStops;
     bool isInitialized;
     
+    // 驻留的来源名，只增不减
+    char sourceNames[MAX_DYNAMIC_SOURCES][SOURCE_NAME_SIZE];
+    uint8_t sourceCount;
+    SemaphoreHandle_t sourceMutex;
+    
     EventManager();
     
+    ListenerSlot* acquireSlot(EventType type);
+    EventSubscription activateSlot(ListenerSlot& slot);
+    void deactivateSlot(ListenerSlot& slot);
+    void compactListeners();
+    
+    bool publishCoalesced(const EventData& event, uint8_t typeIndex, EventCoalescing coalescing);
+    bool takeCoalesced(uint8_t typeIndex, EventData& event);
+    uint32_t getCoalescedPending() const;
+    uint32_t processLane(EventPriority priority, uint32_t queued, uint32_t startMicros, uint32_t budgetMicros,
+                         uint32_t& processed);
+    bool budgetExceeded(uint32_t startMicros, uint32_t budgetMicros, uint32_t processed) const;
+    
+    template <typename F>
+    static bool isNullListener(const F&) { return false; }
+    static bool isNullListener(const EventListener& listener) { return !listener; }
+    static bool isNullListener(void (*listener)(const EventData&)) { return listener == nullptr; }
+    
 public:
     static EventManager& getInstance();
     
@@ -57,29 +200,80 @@ public:
     // 清理资源
     void cleanup();
     
-    // 订阅事件
-    bool subscribe(EventType type, EventListener listener);
+    /**
+     * 订阅事件
+     * 捕获不超过EVENT_LISTENER_INLINE_SIZE的lambda、函数指针和std::function不分配堆内存
+     * @return 订阅句柄，失败（未初始化、监听器为空或已满）时为INVALID_EVENT_SUBSCRIPTION
+     */
+    template <typename F>
+    EventSubscription subscribe(EventType type, F&& listener) {
+        if (isNullListener(listener)) {
+            return INVALID_EVENT_SUBSCRIPTION;
+        }
+        ListenerSlot* slot = acquireSlot(type);
+        if (slot == nullptr) {
+            return INVALID_EVENT_SUBSCRIPTION;
+        }
+        slot->function.assign(std::forward<F>(listener));
+        return activateSlot(*slot);
+    }
+    EventSubscription subscribe(EventType, std::nullptr_t) { return INVALID_EVENT_SUBSCRIPTION; }
+    
+    // 按句柄取消订阅，只移除该监听器；分发过程中调用也安全
+    bool unsubscribe(EventSubscription subscription);
+    
+    // 取消某类型的全部订阅
+    bool unsubscribeAll(EventType type);
     
-    // 取消订阅
-    bool unsubscribe(EventType type, EventListener listener);
+    // 旧接口：std::function无法比较，取消该类型的所有监听器
+    bool unsubscribe(EventType type, const EventListener& listener);
+    
+    uint8_t getListenerCount(EventType type) const;
     
     // 发布事件（立即执行）
     bool publish(const EventData& event);
     
     // 发布事件（异步，加入队列）
+    // 可在BLE回调、其他任务和定时器中断中调用：KEEP_ALL事件进无锁队列，队列满时返回false并计入溢出统计；
+    // KEEP_LATEST只在短临界区（portENTER_CRITICAL_SAFE）内覆盖该类型的待处理事件，COUNT_ONLY只做原子计数；
+    // 入队后通过WakeSignal::notifyAny()唤醒主循环（中断中使用FromISR接口）
     bool publishAsync(const EventData& event);
     
-    // 处理事件队列
-    void processEvents();
+    /**
+     * 处理异步事件：先URGENT后NORMAL，同一优先级内先队列事件、后合并事件
+     * 只处理调用开始时已入队的事件；用完时间预算后停止，剩余事件留到下次（至少处理一个）
+     * @param budgetMicros 时间预算（微秒），0为不限
+     * @return 本次分发的事件数
+     */
+    uint32_t processEvents(uint32_t budgetMicros = EVENT_PROCESS_BUDGET_US);
     
-    // 获取队列中的事件数量
+    // 获取待处理的事件数量（合并的事件每个类型计一个）
     size_t getQueueSize() const;
     
+    QueueStatistics getQueueStatistics() const;
+    void resetQueueStatistics();
+    
+    /**
+     * 设置事件类型的合并策略和优先级
+     * 默认：MOTOR_SPEED_CHANGED、LED_STATE_CHANGED为KEEP_LATEST；
+     * ERROR_OCCURRED、MOTOR_STOP、SYSTEM_SHUTDOWN为URGENT；其余为KEEP_ALL、NORMAL
+     */
+    void setEventPolicy(EventType type, EventCoalescing coalescing, EventPriority priority);
+    EventCoalescing getCoalescing(EventType type) const;
+    EventPriority getPriority(EventType type) const;
+    
     // 清空事件队列
     void clearQueue();
     
     // 获取事件类型名称
     static String getEventTypeName(EventType type);
+    
+    /**
+     * 把来源名换成固定ID，同名返回同一ID；内置来源按名称匹配
+     * @return 来源ID，表满时返回EventSource::UNKNOWN
+     */
+    EventSource internSource(const char* name);
+    const char* getSourceName(EventSource source);
 };
 
 #endif // EVENT_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,106 @@
+#ifndef INLINE_FUNCTION_H
+#define INLINE_FUNCTION_H
+
+#include <Arduino.h>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature, size_t Size>
+class InlineFunction;
+
+/**
+ * 定长可调用对象存储
+ *
+ * 与std::function类似，但捕获不超过Size字节的可调用对象直接存放在内部缓冲区，
+ * 不分配堆内存；更大的对象才在堆上创建，并只在内部保存指针。
+ * 不可复制，只能通过assign()设置、reset()清除。
+ */
+template <typename R, typename... Args, size_t Size>
+class InlineFunction<R(Args...), Size> {
+public:
+    InlineFunction() : _invoker(nullptr), _destroyer(nullptr), _inline(false) {}
+    ~InlineFunction() { reset(); }
+
+    template <typename F>
+    void assign(F&& function) {
+        typedef typename std::decay<F>::type Callable;
+        reset();
+        store<Callable>(std::forward<F>(function), std::integral_constant<bool, fitsInline<Callable>()>());
+    }
+
+    void reset() {
+        if (_destroyer != nullptr) {
+            _destroyer(&_storage);
+        }
+        _invoker = nullptr;
+        _destroyer = nullptr;
+    }
+
+    /**
+     * 可调用对象是否存放在内部缓冲区（没有堆分配）
+     */
+    bool isInline() const { return _inline; }
+
+    explicit operator bool() const { return _invoker != nullptr; }
+
+    R operator()(Args... args) const {
+        return _invoker(const_cast<Storage*>(&_storage), std::forward<Args>(args)...);
+    }
+
+private:
+    typedef typename std::aligned_storage<Size, alignof(std::max_align_t)>::type Storage;
+
+    template <typename Callable>
+    static constexpr bool fitsInline() {
+        return sizeof(Callable) <= Size && alignof(Callable) <= alignof(Storage) &&
+               std::is_nothrow_move_constructible<Callable>::value;
+    }
+
+    template <typename Callable, typename F>
+    void store(F&& function, std::true_type) {
+        new (&_storage) Callable(std::forward<F>(function));
+        _invoker = &invokeInline<Callable>;
+        _destroyer = &destroyInline<Callable>;
+        _inline = true;
+    }
+
+    template <typename Callable, typename F>
+    void store(F&& function, std::false_type) {
+        new (&_storage) Callable*(new Callable(std::forward<F>(function)));
+        _invoker = &invokeHeap<Callable>;
+        _destroyer = &destroyHeap<Callable>;
+        _inline = false;
+    }
+
+    template <typename Callable>
+    static R invokeInline(void* storage, Args... args) {
+        return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+    }
+
+    template <typename Callable>
+    static void destroyInline(void* storage) {
+        static_cast<Callable*>(storage)->~Callable();
+    }
+
+    template <typename Callable>
+    static R invokeHeap(void* storage, Args... args) {
+        return (**static_cast<Callable**>(storage))(std::forward<Args>(args)...);
+    }
+
+    template <typename Callable>
+    static void destroyHeap(void* storage) {
+        delete *static_cast<Callable**>(storage);
+    }
+
+    InlineFunction(const InlineFunction&);
+    InlineFunction& operator=(const InlineFunction&);
+
+    Storage _storage;
+    R (*_invoker)(void*, Args...);
+    void (*_destroyer)(void*);
+    bool _inline;
+};
+
+#endif // INLINE_FUNCTION_H
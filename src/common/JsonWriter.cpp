@@ -0,0 +1,184 @@
+#include "JsonWriter.h"
+
+namespace {
+
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+} // namespace
+
+JsonWriter::JsonWriter(char* buffer, size_t size)
+    : buffer(buffer)
+    , size(size)
+    , pos(0)
+    , overflowed(buffer == nullptr || size == 0)
+    , depth(0)
+    , hasMembers(0) {
+    if (!overflowed) {
+        buffer[0] = '\0';
+    }
+}
+
+void JsonWriter::beginObject(const char* key) {
+    beginContainer(key, '{');
+}
+
+void JsonWriter::endObject() {
+    endContainer('}');
+}
+
+void JsonWriter::beginArray(const char* key) {
+    beginContainer(key, '[');
+}
+
+void JsonWriter::endArray() {
+    endContainer(']');
+}
+
+void JsonWriter::addString(const char* key, const char* value) {
+    beginValue(key);
+    if (value == nullptr) {
+        putRaw("null");
+        return;
+    }
+    putChar('"');
+    putEscaped(value);
+    putChar('"');
+}
+
+void JsonWriter::addBool(const char* key, bool value) {
+    beginValue(key);
+    putRaw(value ? "true" : "false");
+}
+
+void JsonWriter::addInt(const char* key, int64_t value) {
+    beginValue(key);
+    if (value < 0) {
+        putChar('-');
+        putUInt((uint64_t)0 - (uint64_t)value);
+    } else {
+        putUInt((uint64_t)value);
+    }
+}
+
+void JsonWriter::addUInt(const char* key, uint64_t value) {
+    beginValue(key);
+    putUInt(value);
+}
+
+void JsonWriter::addFixed(const char* key, int64_t scaled, uint8_t decimals) {
+    beginValue(key);
+    uint64_t magnitude = scaled < 0 ? (uint64_t)0 - (uint64_t)scaled : (uint64_t)scaled;
+    uint64_t divisor = 1;
+    for (uint8_t i = 0; i < decimals; i++) {
+        divisor *= 10;
+    }
+    if (scaled < 0) {
+        putChar('-');
+    }
+    putUInt(magnitude / divisor);
+    if (decimals == 0) {
+        return;
+    }
+    putChar('.');
+    // 小数部分补足前导0
+    uint64_t fraction = magnitude % divisor;
+    for (divisor /= 10; divisor > 0; divisor /= 10) {
+        putChar((char)('0' + (fraction / divisor) % 10));
+    }
+}
+
+size_t JsonWriter::finish() {
+    if (overflowed) {
+        if (size > 0 && buffer != nullptr) {
+            buffer[0] = '\0';
+        }
+        return 0;
+    }
+    buffer[pos] = '\0';
+    return depth == 0 ? pos : 0;
+}
+
+// 成员前的逗号和成员名
+void JsonWriter::beginValue(const char* key) {
+    if (depth > 0) {
+        uint8_t bit = (uint8_t)(1u << (depth - 1));
+        if (hasMembers & bit) {
+            putChar(',');
+        }
+        hasMembers |= bit;
+    }
+    if (key != nullptr) {
+        putChar('"');
+        putEscaped(key);
+        putRaw("\":");
+    }
+}
+
+void JsonWriter::beginContainer(const char* key, char open) {
+    beginValue(key);
+    putChar(open);
+    if (depth >= MAX_DEPTH) {
+        overflowed = true;
+        return;
+    }
+    depth++;
+    hasMembers &= (uint8_t)~(1u << (depth - 1));
+}
+
+void JsonWriter::endContainer(char close) {
+    putChar(close);
+    if (depth > 0) {
+        depth--;
+    }
+}
+
+void JsonWriter::putChar(char c) {
+    // 保留一个字节给结尾的'\0'
+    if (overflowed || pos + 1 >= size) {
+        overflowed = true;
+        return;
+    }
+    buffer[pos++] = c;
+}
+
+void JsonWriter::putRaw(const char* text) {
+    while (*text) {
+        putChar(*text++);
+    }
+}
+
+void JsonWriter::putEscaped(const char* text) {
+    for (; *text; text++) {
+        uint8_t c = (uint8_t)*text;
+        switch (c) {
+            case '"':  putRaw("\\\""); break;
+            case '\\': putRaw("\\\\"); break;
+            case '\n': putRaw("\\n"); break;
+            case '\r': putRaw("\\r"); break;
+            case '\t': putRaw("\\t"); break;
+            case '\b': putRaw("\\b"); break;
+            case '\f': putRaw("\\f"); break;
+            default:
+                if (c < 0x20) {
+                    putRaw("\\u00");
+                    putChar(HEX_DIGITS[c >> 4]);
+                    putChar(HEX_DIGITS[c & 0x0F]);
+                } else {
+                    putChar((char)c);
+                }
+                break;
+        }
+    }
+}
+
+void JsonWriter::putUInt(uint64_t value) {
+    char digits[20];
+    uint8_t count = 0;
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (count > 0) {
+        putChar(digits[--count]);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * 流式JSON写入器（与硬件无关，不分配堆内存）
+ *
+ * 直接写入调用者提供的定长缓冲区，不经过JsonDocument和String。按调用顺序输出键值，
+ * 自动插入逗号，字符串按JSON规则转义（UTF-8原样输出）。缓冲区不足时停止写入并记录溢出，
+ * finish()返回0。finish()之后缓冲区以'\0'结尾。
+ *
+ *   char buffer[128];
+ *   JsonWriter writer(buffer, sizeof(buffer));
+ *   writer.beginObject();
+ *   writer.addUInt("state", 1);
+ *   writer.addString("stateName", "RUNNING");
+ *   writer.endObject();
+ *   size_t length = writer.finish();   // {"state":1,"stateName":"RUNNING"}
+ */
+class JsonWriter {
+public:
+    static const uint8_t MAX_DEPTH = 8;
+
+    /**
+     * @param buffer 输出缓冲区
+     * @param size 缓冲区大小（含结尾的'\0'）
+     */
+    JsonWriter(char* buffer, size_t size);
+
+    /**
+     * 开始对象
+     * @param key 成员名；顶层对象或数组元素传nullptr
+     */
+    void beginObject(const char* key = nullptr);
+    void endObject();
+
+    /**
+     * 开始数组；元素用add*(nullptr, value)或beginObject()写入
+     * @param key 成员名；顶层数组或数组元素传nullptr
+     */
+    void beginArray(const char* key = nullptr);
+    void endArray();
+
+    void addString(const char* key, const char* value);
+    void addBool(const char* key, bool value);
+    void addInt(const char* key, int64_t value);
+    void addUInt(const char* key, uint64_t value);
+
+    /**
+     * 写入定点小数（避免浮点格式化）
+     * @param key 成员名
+     * @param scaled 放大10^decimals倍的整数值，如温度32.5°C、decimals=1时为325
+     * @param decimals 小数位数
+     */
+    void addFixed(const char* key, int64_t scaled, uint8_t decimals);
+
+    /**
+     * 结束写入并在末尾写入'\0'
+     * @return 写入的长度（不含'\0'）；溢出或对象未闭合时返回0
+     */
+    size_t finish();
+
+    size_t length() const { return pos; }
+    bool hasOverflowed() const { return overflowed; }
+    const char* c_str() const { return buffer; }
+
+private:
+    void beginValue(const char* key);
+    void beginContainer(const char* key, char open);
+    void endContainer(char close);
+    void putChar(char c);
+    void putRaw(const char* text);
+    void putEscaped(const char* text);
+    void putUInt(uint64_t value);
+
+    char* buffer;
+    size_t size;
+    size_t pos;
+    bool overflowed;
+    uint8_t depth;
+    uint8_t hasMembers;     // bit i：第i层对象/数组已有成员（之后的成员前加逗号）
+};
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,187 @@
+#ifndef LOCK_FREE_RING_BUFFER_H
+#define LOCK_FREE_RING_BUFFER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * 固定容量的无锁环形队列（多生产者/单消费者）
+ *
+ * 每个槽位带一个序号，生产者用CAS抢占写入位置，写完后发布序号；
+ * 消费者按序号判断槽位是否可读，读完后把槽位交还给下一圈的生产者。
+ * - 不加锁、不分配内存：槽位在构造时一次性分配，元素通过赋值写入槽位
+ * - push()可在任意任务或中断中调用；pop()/drain()/clear()只能由同一个消费者调用
+ * - 队列满时push()立即失败并计入溢出统计，不等待
+ *
+ * @tparam T 元素类型，需可默认构造和赋值
+ * @tparam Capacity 容量，必须为2的幂
+ */
+template <typename T, uint32_t Capacity>
+class LockFreeRingBuffer {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity必须为2的幂");
+
+public:
+    /**
+     * 队列统计
+     */
+    struct Statistics {
+        uint32_t pushed;        // 成功入队数
+        uint32_t popped;        // 出队数
+        uint32_t overflows;     // 队列满被丢弃数
+        uint32_t highWatermark; // 最大深度
+    };
+
+    LockFreeRingBuffer() : _enqueuePos(0), _dequeuePos(0) {
+        for (uint32_t i = 0; i < Capacity; i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        resetStatistics();
+    }
+
+    /**
+     * 入队（多生产者安全）
+     * @return 是否入队成功，队列满时返回false
+     */
+    bool push(const T& item) {
+        return pushWith([&item](T& slot) { slot = item; });
+    }
+
+    /**
+     * 原地入队（多生产者安全）
+     * 写入函数直接填充槽位，元素较大时避免在调用者的栈上构造临时对象
+     * @param writer 写入函数，参数为T&
+     * @return 是否入队成功，队列满时返回false（不调用writer）
+     */
+    template <typename Writer>
+    bool pushWith(Writer writer) {
+        Cell* cell;
+        uint32_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &_cells[pos & MASK];
+            uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+            int32_t diff = static_cast<int32_t>(sequence - pos);
+            if (diff == 0) {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // 槽位仍被上一圈占用：队列已满
+                _overflows.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        writer(cell->data);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        _pushed.fetch_add(1, std::memory_order_relaxed);
+        uint32_t depth = pos + 1 - _dequeuePos.load(std::memory_order_relaxed);
+        uint32_t watermark = _highWatermark.load(std::memory_order_relaxed);
+        while (depth > watermark &&
+               !_highWatermark.compare_exchange_weak(watermark, depth, std::memory_order_relaxed)) {
+        }
+        return true;
+    }
+
+    /**
+     * 出队（仅消费者调用）
+     * @return 是否取到元素
+     */
+    bool pop(T& item) {
+        return drain([&item](T& slot) { item = slot; }, 1) == 1;
+    }
+
+    /**
+     * 原地处理队首的元素（仅消费者调用）
+     * 处理函数直接访问槽位中的元素，返回后槽位才交还给生产者；
+     * 处理期间新入队的元素也可能在本次被处理，用maxItems限制总数。
+     * @param handler 处理函数，参数为T&
+     * @param maxItems 最多处理的元素数
+     * @return 实际处理的元素数
+     */
+    template <typename Handler>
+    uint32_t drain(Handler handler, uint32_t maxItems = Capacity) {
+        uint32_t count = 0;
+        uint32_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        while (count < maxItems) {
+            Cell* cell = &_cells[pos & MASK];
+            uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+            // 生产者尚未发布该槽位：队列为空（或正在写入）
+            if (static_cast<int32_t>(sequence - (pos + 1)) < 0) {
+                break;
+            }
+
+            handler(cell->data);
+            cell->sequence.store(pos + Capacity, std::memory_order_release);
+            pos++;
+            _dequeuePos.store(pos, std::memory_order_relaxed);
+            count++;
+        }
+
+        if (count > 0) {
+            _popped.fetch_add(count, std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    /**
+     * 丢弃所有已入队的元素（仅消费者调用）
+     * @return 丢弃的元素数
+     */
+    uint32_t clear() {
+        return drain([](T&) {});
+    }
+
+    /**
+     * 当前深度（其他任务调用时为近似值）
+     */
+    uint32_t size() const {
+        uint32_t enqueuePos = _enqueuePos.load(std::memory_order_relaxed);
+        uint32_t dequeuePos = _dequeuePos.load(std::memory_order_relaxed);
+        uint32_t depth = enqueuePos - dequeuePos;
+        return depth > Capacity ? Capacity : depth;
+    }
+
+    bool empty() const { return size() == 0; }
+    static uint32_t capacity() { return Capacity; }
+
+    Statistics getStatistics() const {
+        Statistics stats;
+        stats.pushed = _pushed.load(std::memory_order_relaxed);
+        stats.popped = _popped.load(std::memory_order_relaxed);
+        stats.overflows = _overflows.load(std::memory_order_relaxed);
+        stats.highWatermark = _highWatermark.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void resetStatistics() {
+        _pushed.store(0, std::memory_order_relaxed);
+        _popped.store(0, std::memory_order_relaxed);
+        _overflows.store(0, std::memory_order_relaxed);
+        _highWatermark.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static const uint32_t MASK = Capacity - 1;
+
+    struct Cell {
+        std::atomic<uint32_t> sequence;
+        T data;
+    };
+
+    LockFreeRingBuffer(const LockFreeRingBuffer&);
+    LockFreeRingBuffer& operator=(const LockFreeRingBuffer&);
+
+    Cell _cells[Capacity];
+    std::atomic<uint32_t> _enqueuePos;
+    std::atomic<uint32_t> _dequeuePos;
+
+    std::atomic<uint32_t> _pushed;
+    std::atomic<uint32_t> _popped;
+    std::atomic<uint32_t> _overflows;
+    std::atomic<uint32_t> _highWatermark;
+};
+
+#endif // LOCK_FREE_RING_BUFFER_H
@@ -0,0 +1,31 @@
+#ifndef MONOTONIC_CLOCK_H
+#define MONOTONIC_CLOCK_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+/**
+ * 64位单调时钟
+ *
+ * 取自esp_timer（自启动以来的微秒数；主机测试中由NativeHAL的虚拟时钟提供），不会回绕。
+ * millis()约49.7天回绕、micros()约71.6分钟回绕，长时间运行的计时和超过这些范围的时长
+ * 都应使用本时钟。可以在中断中调用。
+ */
+class MonotonicClock {
+public:
+    /**
+     * 当前时间（微秒）
+     */
+    static inline uint64_t nowMicros() {
+        return static_cast<uint64_t>(esp_timer_get_time());
+    }
+
+    /**
+     * 当前时间（毫秒）
+     */
+    static inline uint64_t nowMillis() {
+        return nowMicros() / 1000;
+    }
+};
+
+#endif // MONOTONIC_CLOCK_H
@@ -0,0 +1,436 @@
+#include "MotorProgram.h"
+#include "../drivers/ModbusCRC.h"
+#include <string.h>
+
+namespace {
+
+// 指令头字节
+const uint8_t HEADER_OP_MASK = 0x03;
+const uint8_t HEADER_MOTOR_ON = 0x04;
+const uint8_t HEADER_FREQUENCY = 0x08;
+const uint8_t HEADER_DUTY = 0x10;
+const uint8_t HEADER_RAMP = 0x20;
+
+const uint8_t MAGIC_0 = 'M';
+const uint8_t MAGIC_1 = 'P';
+const size_t HEADER_SIZE = 4;
+const size_t CRC_SIZE = 2;
+
+// 变长编码：每字节7位，低位在前
+bool writeVarint(uint8_t* buffer, size_t size, size_t& offset, uint32_t value) {
+    do {
+        if (offset >= size) {
+            return false;
+        }
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        buffer[offset++] = value ? (byte | 0x80) : byte;
+    } while (value);
+    return true;
+}
+
+size_t varintSize(uint32_t value) {
+    size_t size = 1;
+    while (value >>= 7) {
+        size++;
+    }
+    return size;
+}
+
+bool readVarint(const uint8_t* data, size_t length, size_t& offset, uint32_t& value) {
+    value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        if (offset >= length) {
+            return false;
+        }
+        uint8_t byte = data[offset++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 时长累加，溢出时饱和为无限
+uint64_t saturatingAdd(uint64_t a, uint64_t b) {
+    return a > MotorProgram::INFINITE_DURATION - b ? MotorProgram::INFINITE_DURATION : a + b;
+}
+
+uint64_t saturatingMultiply(uint64_t a, uint64_t b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    return a > MotorProgram::INFINITE_DURATION / b ? MotorProgram::INFINITE_DURATION : a * b;
+}
+
+} // namespace
+
+MotorProgram::MotorProgram()
+    : count(0)
+    , compiled(false)
+    , totalDurationMs(0)
+    , serializedSize(0)
+    , lastError("") {
+    memset(instructions, 0, sizeof(instructions));
+}
+
+void MotorProgram::clear() {
+    count = 0;
+    compiled = false;
+    totalDurationMs = 0;
+    serializedSize = 0;
+    lastError = "";
+}
+
+bool MotorProgram::append(const ProgramInstruction& instruction) {
+    if (count >= MAX_INSTRUCTIONS) {
+        lastError = "程序指令过多";
+        return false;
+    }
+    instructions[count++] = instruction;
+    compiled = false;
+    return true;
+}
+
+bool MotorProgram::addStep(uint32_t durationMs, bool motorOn) {
+    ProgramSetpoint setpoint;
+    memset(&setpoint, 0, sizeof(setpoint));
+    return addStep(durationMs, motorOn, setpoint);
+}
+
+bool MotorProgram::addStep(uint32_t durationMs, bool motorOn, const ProgramSetpoint& setpoint) {
+    ProgramInstruction instruction;
+    memset(&instruction, 0, sizeof(instruction));
+    instruction.op = ProgramOp::STEP;
+    instruction.motorOn = motorOn;
+    instruction.durationMs = durationMs;
+    instruction.setpoint = setpoint;
+    return append(instruction);
+}
+
+bool MotorProgram::beginRepeat(uint16_t repeatCount) {
+    ProgramInstruction instruction;
+    memset(&instruction, 0, sizeof(instruction));
+    instruction.op = ProgramOp::REPEAT;
+    instruction.repeatCount = repeatCount;
+    return append(instruction);
+}
+
+bool MotorProgram::endRepeat() {
+    ProgramInstruction instruction;
+    memset(&instruction, 0, sizeof(instruction));
+    instruction.op = ProgramOp::END_REPEAT;
+    return append(instruction);
+}
+
+// 检查结构，填写循环的跳转位置和层级，同时按层累加时长
+bool MotorProgram::compile() {
+    compiled = false;
+    totalDurationMs = 0;
+    serializedSize = HEADER_SIZE + CRC_SIZE;
+
+    uint8_t openRepeat[MAX_DEPTH];      // 各层REPEAT指令的位置
+    uint64_t bodyDuration[MAX_DEPTH + 1]; // 各层已累计的时长，第0层为程序本身
+    uint32_t bodySteps[MAX_DEPTH + 1];  // 各层已包含的步骤数（含内层）
+    uint8_t depth = 0;
+    bodyDuration[0] = 0;
+    bodySteps[0] = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        ProgramInstruction& instruction = instructions[i];
+        switch (instruction.op) {
+            case ProgramOp::STEP:
+                if (instruction.durationMs == 0) {
+                    lastError = "步骤时长不能为0";
+                    return false;
+                }
+                if ((instruction.setpoint.mask & ProgramSetpoint::DUTY) && instruction.setpoint.dutyCycle > 100) {
+                    lastError = "占空比超出范围";
+                    return false;
+                }
+                bodyDuration[depth] = saturatingAdd(bodyDuration[depth], instruction.durationMs);
+                bodySteps[depth]++;
+                // 与serialize()相同的编码：头字节、时长及各设定值字段
+                serializedSize += 1 + varintSize(instruction.durationMs);
+                if (instruction.setpoint.mask & ProgramSetpoint::FREQUENCY) {
+                    serializedSize += varintSize(instruction.setpoint.frequency);
+                }
+                if (instruction.setpoint.mask & ProgramSetpoint::DUTY) {
+                    serializedSize += 1;
+                }
+                if (instruction.setpoint.mask & ProgramSetpoint::RAMP) {
+                    serializedSize += varintSize(instruction.setpoint.rampTime);
+                }
+                break;
+
+            case ProgramOp::REPEAT:
+                if (depth >= MAX_DEPTH) {
+                    lastError = "循环嵌套过深";
+                    return false;
+                }
+                instruction.depth = depth;
+                openRepeat[depth++] = i;
+                serializedSize += 1 + varintSize(instruction.repeatCount);
+                bodyDuration[depth] = 0;
+                bodySteps[depth] = 0;
+                break;
+
+            case ProgramOp::END_REPEAT: {
+                if (depth == 0) {
+                    lastError = "循环结束没有对应的循环开始";
+                    return false;
+                }
+                if (bodySteps[depth] == 0) {
+                    lastError = "循环体不包含步骤";
+                    return false;
+                }
+                serializedSize += 1;
+                const ProgramInstruction& repeat = instructions[openRepeat[depth - 1]];
+                instruction.repeatCount = repeat.repeatCount;
+                instruction.jumpTarget = openRepeat[depth - 1] + 1;
+                instruction.depth = repeat.depth;
+
+                uint64_t loopDuration = repeat.repeatCount == 0 ? INFINITE_DURATION :
+                    saturatingMultiply(bodyDuration[depth], repeat.repeatCount);
+                uint32_t loopSteps = bodySteps[depth];
+                depth--;
+                bodyDuration[depth] = saturatingAdd(bodyDuration[depth], loopDuration);
+                bodySteps[depth] += loopSteps;
+                break;
+            }
+
+            default:
+                lastError = "未知指令";
+                return false;
+        }
+    }
+
+    if (depth != 0) {
+        lastError = "循环开始没有对应的循环结束";
+        return false;
+    }
+    if (bodySteps[0] == 0) {
+        lastError = "程序不包含步骤";
+        return false;
+    }
+
+    totalDurationMs = bodyDuration[0];
+    compiled = true;
+    lastError = "";
+    return true;
+}
+
+size_t MotorProgram::serialize(uint8_t* buffer, size_t size) const {
+    if (!compiled || size < HEADER_SIZE + CRC_SIZE) {
+        return 0;
+    }
+
+    buffer[0] = MAGIC_0;
+    buffer[1] = MAGIC_1;
+    buffer[2] = FORMAT_VERSION;
+    buffer[3] = count;
+    size_t offset = HEADER_SIZE;
+    size_t limit = size - CRC_SIZE;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const ProgramInstruction& instruction = instructions[i];
+        uint8_t header = (uint8_t)instruction.op;
+        if (instruction.op == ProgramOp::STEP) {
+            const ProgramSetpoint& setpoint = instruction.setpoint;
+            header |= instruction.motorOn ? HEADER_MOTOR_ON : 0;
+            header |= (setpoint.mask & ProgramSetpoint::FREQUENCY) ? HEADER_FREQUENCY : 0;
+            header |= (setpoint.mask & ProgramSetpoint::DUTY) ? HEADER_DUTY : 0;
+            header |= (setpoint.mask & ProgramSetpoint::RAMP) ? HEADER_RAMP : 0;
+        }
+        if (offset >= limit) {
+            return 0;
+        }
+        buffer[offset++] = header;
+
+        bool ok = true;
+        if (instruction.op == ProgramOp::STEP) {
+            ok = writeVarint(buffer, limit, offset, instruction.durationMs);
+            if (ok && (header & HEADER_FREQUENCY)) {
+                ok = writeVarint(buffer, limit, offset, instruction.setpoint.frequency);
+            }
+            if (ok && (header & HEADER_DUTY)) {
+                ok = offset < limit;
+                if (ok) {
+                    buffer[offset++] = instruction.setpoint.dutyCycle;
+                }
+            }
+            if (ok && (header & HEADER_RAMP)) {
+                ok = writeVarint(buffer, limit, offset, instruction.setpoint.rampTime);
+            }
+        } else if (instruction.op == ProgramOp::REPEAT) {
+            ok = writeVarint(buffer, limit, offset, instruction.repeatCount);
+        }
+        if (!ok) {
+            return 0;
+        }
+    }
+
+    uint16_t crc = ModbusCRC::calculate(buffer, offset);
+    buffer[offset++] = crc & 0xFF;
+    buffer[offset++] = crc >> 8;
+    return offset;
+}
+
+bool MotorProgram::deserialize(const uint8_t* data, size_t length) {
+    clear();
+
+    if (length < HEADER_SIZE + CRC_SIZE || data[0] != MAGIC_0 || data[1] != MAGIC_1) {
+        lastError = "程序数据格式错误";
+        return false;
+    }
+    if (data[2] != FORMAT_VERSION) {
+        lastError = "程序数据版本不支持";
+        return false;
+    }
+    if (ModbusCRC::calculate(data, length) != 0) {
+        lastError = "程序数据校验失败";
+        return false;
+    }
+
+    uint8_t instructionCount = data[3];
+    size_t offset = HEADER_SIZE;
+    size_t limit = length - CRC_SIZE;
+    for (uint8_t i = 0; i < instructionCount; i++) {
+        if (offset >= limit) {
+            lastError = "程序数据不完整";
+            return false;
+        }
+        uint8_t header = data[offset++];
+        uint32_t value = 0;
+        bool ok = true;
+
+        switch ((ProgramOp)(header & HEADER_OP_MASK)) {
+            case ProgramOp::STEP: {
+                ProgramSetpoint setpoint;
+                memset(&setpoint, 0, sizeof(setpoint));
+                uint32_t durationMs = 0;
+                ok = readVarint(data, limit, offset, durationMs);
+                if (ok && (header & HEADER_FREQUENCY)) {
+                    setpoint.mask |= ProgramSetpoint::FREQUENCY;
+                    ok = readVarint(data, limit, offset, setpoint.frequency);
+                }
+                if (ok && (header & HEADER_DUTY)) {
+                    setpoint.mask |= ProgramSetpoint::DUTY;
+                    ok = offset < limit;
+                    if (ok) {
+                        setpoint.dutyCycle = data[offset++];
+                    }
+                }
+                if (ok && (header & HEADER_RAMP)) {
+                    setpoint.mask |= ProgramSetpoint::RAMP;
+                    ok = readVarint(data, limit, offset, value) && value <= 0xFFFF;
+                    setpoint.rampTime = (uint16_t)value;
+                }
+                ok = ok && addStep(durationMs, (header & HEADER_MOTOR_ON) != 0, setpoint);
+                break;
+            }
+            case ProgramOp::REPEAT:
+                ok = readVarint(data, limit, offset, value) && value <= 0xFFFF && beginRepeat((uint16_t)value);
+                break;
+            case ProgramOp::END_REPEAT:
+                ok = endRepeat();
+                break;
+            default:
+                ok = false;
+                break;
+        }
+        if (!ok) {
+            clear();
+            lastError = "程序数据格式错误";
+            return false;
+        }
+    }
+
+    if (offset != limit) {
+        clear();
+        lastError = "程序数据格式错误";
+        return false;
+    }
+    return compile();
+}
+
+MotorProgramRunner::MotorProgramRunner()
+    : program(nullptr)
+    , pc(0)
+    , stepStartMs(0)
+    , stepDeadlineMs(0)
+    , stepsExecuted(0)
+    , running(false) {
+    memset(loopRemaining, 0, sizeof(loopRemaining));
+}
+
+bool MotorProgramRunner::start(const MotorProgram& program, uint64_t nowMs) {
+    stop();
+    if (!program.isCompiled()) {
+        return false;
+    }
+    this->program = &program;
+    stepsExecuted = 0;
+    running = true;
+    enter(0, nowMs);
+    return running;
+}
+
+void MotorProgramRunner::stop() {
+    running = false;
+    pc = 0;
+}
+
+bool MotorProgramRunner::update(uint64_t nowMs) {
+    if (!running || nowMs < stepDeadlineMs) {
+        return false;
+    }
+    // 主循环延迟超过后续步骤的时长时，依次跳过已经结束的步骤
+    do {
+        enter(pc + 1, stepDeadlineMs);
+    } while (running && nowMs >= stepDeadlineMs);
+    return true;
+}
+
+const ProgramInstruction* MotorProgramRunner::getCurrentStep() const {
+    return running ? &program->getInstruction(pc) : nullptr;
+}
+
+uint32_t MotorProgramRunner::getMsUntilNextStep(uint64_t nowMs) const {
+    if (!running || nowMs >= stepDeadlineMs) {
+        return 0;
+    }
+    // 步骤时长不超过32位，剩余时间也不会超过
+    return (uint32_t)(stepDeadlineMs - nowMs);
+}
+
+// 从index开始执行循环指令，直到遇到下一个步骤；没有步骤时程序结束
+void MotorProgramRunner::enter(uint8_t index, uint64_t startMs) {
+    uint8_t count = program->getInstructionCount();
+    while (index < count) {
+        const ProgramInstruction& instruction = program->getInstruction(index);
+        switch (instruction.op) {
+            case ProgramOp::STEP:
+                pc = index;
+                stepStartMs = startMs;
+                stepDeadlineMs = startMs + instruction.durationMs;
+                stepsExecuted++;
+                return;
+            case ProgramOp::REPEAT:
+                loopRemaining[instruction.depth] = instruction.repeatCount;
+                index++;
+                break;
+            case ProgramOp::END_REPEAT:
+                // 无限循环不计数；有限循环计数减到0后继续执行后面的指令
+                if (instruction.repeatCount == 0 || --loopRemaining[instruction.depth] > 0) {
+                    index = instruction.jumpTarget;
+                } else {
+                    index++;
+                }
+                break;
+        }
+    }
+    running = false;
+    pc = 0;
+}
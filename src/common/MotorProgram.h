@@ -0,0 +1,216 @@
+#ifndef MOTOR_PROGRAM_H
+#define MOTOR_PROGRAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * 电机程序指令类型
+ */
+enum class ProgramOp : uint8_t {
+    STEP = 0,           // 步骤：保持电机开/关一段时间，可附带调速器设定值
+    REPEAT = 1,         // 循环开始
+    END_REPEAT = 2      // 循环结束，与最近的未结束REPEAT配对
+};
+
+/**
+ * 步骤进入时下发给调速器的设定值，mask表示哪些字段有效
+ */
+struct ProgramSetpoint {
+    static const uint8_t FREQUENCY = 0x01;
+    static const uint8_t DUTY = 0x02;
+    static const uint8_t RAMP = 0x04;
+
+    uint8_t mask;           // 有效字段
+    uint32_t frequency;     // 频率 (Hz)
+    uint8_t dutyCycle;      // 占空比 (0-100%)
+    uint16_t rampTime;      // 频率/占空比的缓变时间 (0.1s单位)
+};
+
+/**
+ * 电机程序指令；jumpTarget和depth由MotorProgram::compile()填写
+ */
+struct ProgramInstruction {
+    ProgramOp op;
+    bool motorOn;               // STEP: 电机开/关
+    uint32_t durationMs;        // STEP: 持续时间（毫秒，至少1）
+    ProgramSetpoint setpoint;   // STEP: 调速器设定值
+    uint16_t repeatCount;       // REPEAT/END_REPEAT: 循环次数，0表示无限循环
+    uint8_t jumpTarget;         // END_REPEAT: 循环体第一条指令的位置
+    uint8_t depth;              // REPEAT/END_REPEAT: 嵌套层级（循环计数器槽位）
+};
+
+/**
+ * 多段电机程序（配方）
+ *
+ * 由步骤和可嵌套的循环组成，编译时检查结构并填写循环的跳转位置，执行时不需要展开循环。
+ * 序列化为紧凑的二进制格式保存到NVS：
+ *   'M' 'P' 版本 指令数 | 指令... | CRC16（低字节在前）
+ * 每条指令以一个字节开头（低2位为类型；STEP的bit2为电机开/关，bit3~5表示带频率/占空比/缓变时间），
+ * 数值字段使用变长编码（每字节7位，最高位表示后续还有字节）。
+ */
+class MotorProgram {
+public:
+    static const uint8_t MAX_INSTRUCTIONS = 64;
+    static const uint8_t MAX_DEPTH = 4;
+    static const uint8_t FORMAT_VERSION = 1;
+    // 头部4字节 + 每条指令最多15字节 + CRC 2字节
+    static const size_t MAX_SERIALIZED_SIZE = 4 + MAX_INSTRUCTIONS * 15 + 2;
+    static const uint64_t INFINITE_DURATION = 0xFFFFFFFFFFFFFFFFULL;
+
+    MotorProgram();
+
+    /**
+     * 清空程序
+     */
+    void clear();
+
+    /**
+     * 添加步骤
+     * @param durationMs 持续时间（毫秒）
+     * @param motorOn 电机开/关
+     * @return 指令表未满
+     */
+    bool addStep(uint32_t durationMs, bool motorOn);
+
+    /**
+     * 添加带调速器设定值的步骤
+     * @param durationMs 持续时间（毫秒）
+     * @param motorOn 电机开/关
+     * @param setpoint 进入步骤时下发的设定值
+     * @return 指令表未满
+     */
+    bool addStep(uint32_t durationMs, bool motorOn, const ProgramSetpoint& setpoint);
+
+    /**
+     * 开始循环
+     * @param count 循环次数，0表示无限循环
+     * @return 指令表未满
+     */
+    bool beginRepeat(uint16_t count);
+
+    /**
+     * 结束最近的循环
+     * @return 指令表未满
+     */
+    bool endRepeat();
+
+    /**
+     * 检查结构并填写循环跳转位置，计算总时长
+     * 要求：至少一个步骤，步骤时长不为0，占空比不超过100，循环配对且嵌套不超过MAX_DEPTH层，
+     * 每个循环体至少包含一个步骤
+     * @return 编译是否成功，失败原因见getLastError()
+     */
+    bool compile();
+
+    bool isCompiled() const { return compiled; }
+    uint8_t getInstructionCount() const { return count; }
+    const ProgramInstruction& getInstruction(uint8_t index) const { return instructions[index]; }
+
+    /**
+     * 程序执行一遍的总时长（编译后有效）
+     * @return 毫秒，包含无限循环时为INFINITE_DURATION
+     */
+    uint64_t getTotalDurationMs() const { return totalDurationMs; }
+
+    /**
+     * 序列化（需要先编译）
+     * @param buffer 输出缓冲区
+     * @param size 缓冲区大小
+     * @return 写入的字节数，未编译或缓冲区不足时返回0
+     */
+    size_t serialize(uint8_t* buffer, size_t size) const;
+
+    /**
+     * serialize()输出的字节数（编译时计算，不需要序列化缓冲区）
+     * @return 字节数，未编译时返回0
+     */
+    size_t getSerializedSize() const { return compiled ? serializedSize : 0; }
+
+    /**
+     * 反序列化并编译
+     * @param data 序列化数据
+     * @param length 数据长度
+     * @return 格式、校验和编译是否都成功
+     */
+    bool deserialize(const uint8_t* data, size_t length);
+
+    /**
+     * 获取最近一次错误信息
+     */
+    const char* getLastError() const { return lastError; }
+
+private:
+    bool append(const ProgramInstruction& instruction);
+
+    ProgramInstruction instructions[MAX_INSTRUCTIONS];
+    uint8_t count;
+    bool compiled;
+    uint64_t totalDurationMs;
+    size_t serializedSize;
+    const char* lastError;
+};
+
+/**
+ * 电机程序执行器（与硬件无关，时钟由调用者传入）
+ *
+ * 每个步骤从上一步骤的截止时刻开始，调度延迟不会累积。未到截止时刻时update()只做一次比较；
+ * 切换步骤时最多经过2*MAX_DEPTH条循环指令。时间为64位单调毫秒（见MonotonicClock），不回绕。
+ */
+class MotorProgramRunner {
+public:
+    MotorProgramRunner();
+
+    /**
+     * 从第一条指令开始执行
+     * @param program 已编译的程序（执行期间必须保持有效且不被修改）
+     * @param nowMs 当前时刻，第一个步骤从此刻开始
+     * @return 程序已编译且包含步骤
+     */
+    bool start(const MotorProgram& program, uint64_t nowMs);
+
+    /**
+     * 停止执行
+     */
+    void stop();
+
+    /**
+     * 推进到当前时刻（需要在主循环中调用）
+     * @param nowMs 当前时刻
+     * @return 当前步骤是否变化（包括程序结束）
+     */
+    bool update(uint64_t nowMs);
+
+    bool isRunning() const { return running; }
+
+    /**
+     * 获取当前步骤
+     * @return 当前步骤，未运行时返回nullptr
+     */
+    const ProgramInstruction* getCurrentStep() const;
+
+    uint8_t getCurrentIndex() const { return pc; }
+    uint64_t getStepStartMs() const { return stepStartMs; }
+    uint64_t getStepDeadlineMs() const { return stepDeadlineMs; }
+    uint32_t getStepsExecuted() const { return stepsExecuted; }
+
+    /**
+     * 距当前步骤结束的时间
+     * @param nowMs 当前时刻
+     * @return 毫秒，已到期或未运行时返回0
+     */
+    uint32_t getMsUntilNextStep(uint64_t nowMs) const;
+
+private:
+    void enter(uint8_t index, uint64_t startMs);
+
+    const MotorProgram* program;
+    uint8_t pc;                                     // 当前步骤的位置
+    uint16_t loopRemaining[MotorProgram::MAX_DEPTH]; // 各层循环的剩余次数
+    uint64_t stepStartMs;
+    uint64_t stepDeadlineMs;
+    uint32_t stepsExecuted;
+    bool running;
+};
+
+#endif // MOTOR_PROGRAM_H
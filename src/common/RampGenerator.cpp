@@ -0,0 +1,112 @@
+#include "RampGenerator.h"
+
+namespace {
+
+// 2^(-k/16)，k = 0~16（Q16）
+const uint32_t EXP2_TABLE[17] = {
+    65536, 62757, 60097, 57549, 55109, 52773, 50535, 48393, 46341,
+    44376, 42495, 40693, 38968, 37316, 35734, 34219, 32768
+};
+
+// 指数曲线经过的半衰期数：2^-8时剩余约0.4%，归一化后在终点精确到达
+const uint8_t EXP_HALF_LIVES = 8;
+
+/**
+ * 2^(-x)，x为Q16；分数部分查表并线性插值，整数部分移位
+ */
+uint32_t exp2Negative(uint32_t x) {
+    uint32_t integer = x >> RampGenerator::FRACTION_BITS;
+    if (integer >= 32) {
+        return 0;
+    }
+    uint32_t fraction = x & (RampGenerator::ONE - 1);
+    uint32_t index = fraction >> 12;
+    uint32_t weight = fraction & 0x0FFF;
+    uint32_t a = EXP2_TABLE[index];
+    uint32_t b = EXP2_TABLE[index + 1];
+    uint32_t value = a - (((a - b) * weight) >> 12);
+    return value >> integer;
+}
+
+} // namespace
+
+uint32_t RampGenerator::shape(RampProfile profile, uint32_t progress) {
+    if (progress >= ONE) {
+        return ONE;
+    }
+    switch (profile) {
+        case RampProfile::S_CURVE: {
+            // 3p² - 2p³ = p²(3 - 2p)，最后一次性截断以保证单调
+            uint64_t p2 = (uint64_t)progress * progress;
+            return (uint32_t)((p2 * (3 * ONE - 2 * progress)) >> (2 * FRACTION_BITS));
+        }
+        case RampProfile::EXPONENTIAL: {
+            // (1 - 2^(-Np)) / (1 - 2^(-N))
+            const uint32_t floor = ONE >> EXP_HALF_LIVES;
+            uint32_t remaining = exp2Negative(progress * EXP_HALF_LIVES);
+            return (uint32_t)(((uint64_t)(ONE - remaining) << FRACTION_BITS) / (ONE - floor));
+        }
+        case RampProfile::LINEAR:
+        default:
+            return progress;
+    }
+}
+
+RampGenerator::RampGenerator()
+    : profile(RampProfile::LINEAR)
+    , from(0)
+    , target(0)
+    , value(0)
+    , startMicros(0)
+    , durationMicros(0)
+    , active(false) {
+}
+
+void RampGenerator::reset(int32_t newValue) {
+    from = newValue;
+    target = newValue;
+    value = newValue;
+    durationMicros = 0;
+    active = false;
+}
+
+void RampGenerator::start(int32_t newTarget, uint64_t duration, uint64_t nowMicros) {
+    // 从新起点处的输出继续，重新设定目标时输出不跳变
+    from = active ? valueAt(nowMicros) : value;
+    value = from;
+    target = newTarget;
+    startMicros = nowMicros;
+    durationMicros = duration;
+    active = duration > 0 && from != newTarget;
+    if (!active) {
+        value = newTarget;
+    }
+}
+
+bool RampGenerator::update(uint64_t nowMicros) {
+    if (!active) {
+        return false;
+    }
+    int32_t previous = value;
+    value = valueAt(nowMicros);
+    if (nowMicros >= getEndMicros()) {
+        active = false;
+    }
+    return value != previous;
+}
+
+int32_t RampGenerator::valueAt(uint64_t nowMicros) const {
+    if (!active || nowMicros >= getEndMicros()) {
+        return active ? target : value;
+    }
+    if (nowMicros <= startMicros) {
+        return from;
+    }
+    // 进度 = 已过时间 / 时长（Q16）；时长在2^48微秒（约8.9年）以内时左移不溢出
+    uint64_t elapsed = nowMicros - startMicros;
+    uint32_t progress = shape(profile, (uint32_t)((elapsed << FRACTION_BITS) / durationMicros));
+    int64_t delta = (int64_t)target - from;
+    // 向起点方向截断，保证输出单调且不越过目标
+    int64_t step = delta >= 0 ? (delta * progress) >> FRACTION_BITS : -((-delta * progress) >> FRACTION_BITS);
+    return (int32_t)(from + step);
+}
@@ -0,0 +1,92 @@
+#ifndef RAMP_GENERATOR_H
+#define RAMP_GENERATOR_H
+
+#include <stdint.h>
+
+/**
+ * 斜坡曲线
+ */
+enum class RampProfile : uint8_t {
+    LINEAR = 0,         // 匀速
+    S_CURVE = 1,        // 平滑起止（3p²-2p³），起点和终点的变化率为0
+    EXPONENTIAL = 2     // 先快后慢，按指数逼近目标（8个半衰期后归一化到达）
+};
+
+/**
+ * 斜坡发生器（与硬件无关，时钟由调用者传入）
+ *
+ * 在给定时间内把输出从当前值按所选曲线变化到目标值。进度以Q16定点数计算，只用整数运算，
+ * 可用于没有FPU或不希望在主循环中使用浮点的场合。斜坡结束时输出精确等于目标值。
+ * 时间为64位单调微秒（见MonotonicClock）。
+ */
+class RampGenerator {
+public:
+    static const uint8_t FRACTION_BITS = 16;
+    static const uint32_t ONE = 1UL << FRACTION_BITS;
+
+    RampGenerator();
+
+    /**
+     * 设置斜坡曲线（对之后start()的斜坡生效）
+     * @param profile 斜坡曲线
+     */
+    void setProfile(RampProfile profile) { this->profile = profile; }
+    RampProfile getProfile() const { return profile; }
+
+    /**
+     * 计算曲线在给定进度处的值
+     * @param profile 斜坡曲线
+     * @param progress 进度（Q16，0~ONE）
+     * @return 完成比例（Q16，单调不减，progress为ONE时精确等于ONE）
+     */
+    static uint32_t shape(RampProfile profile, uint32_t progress);
+
+    /**
+     * 立即把输出设置为指定值并结束斜坡
+     * @param value 输出值
+     */
+    void reset(int32_t value);
+
+    /**
+     * 从nowMicros时刻的输出开始，经过durationMicros变化到目标值
+     * 斜坡进行中调用时从当前位置重新开始；时长为0或已在目标值时立即到达
+     * @param target 目标值
+     * @param durationMicros 斜坡时长
+     * @param nowMicros 斜坡开始时刻（可以早于当前时刻，例如从定时器切换的时刻开始）
+     */
+    void start(int32_t target, uint64_t durationMicros, uint64_t nowMicros);
+
+    /**
+     * 推进到指定时刻
+     * @param nowMicros 当前时刻
+     * @return 输出值是否变化
+     */
+    bool update(uint64_t nowMicros);
+
+    /**
+     * 计算指定时刻的输出（不改变状态）
+     * @param nowMicros 时刻
+     * @return 输出值
+     */
+    int32_t valueAt(uint64_t nowMicros) const;
+
+    int32_t getValue() const { return value; }
+    int32_t getTarget() const { return target; }
+    bool isActive() const { return active; }
+
+    /**
+     * 斜坡结束时刻（未进行时无意义）
+     */
+    uint64_t getEndMicros() const { return startMicros + durationMicros; }
+
+private:
+    RampProfile profile;
+    int32_t from;
+    int32_t target;
+    int32_t value;
+    uint64_t startMicros;
+    uint64_t durationMicros;
+    bool active;
+};
+
+#endif // RAMP_GENERATOR_H
@@ -0,0 +1,114 @@
+#include "SetpointRamp.h"
+
+SetpointRamp::SetpointRamp()
+    : emitIntervalMicros(0)
+    , lastEmitMicros(0)
+    , known(false)
+    , emittedValid(false)
+    , inFlight(false)
+    , emitCount(0) {
+    lastEmitted.frequency = 0;
+    lastEmitted.dutyCycle = 0;
+}
+
+void SetpointRamp::setProfile(RampProfile profile) {
+    frequencyRamp.setProfile(profile);
+    dutyRamp.setProfile(profile);
+}
+
+void SetpointRamp::reset(const Setpoint& value) {
+    frequencyRamp.reset((int32_t)value.frequency);
+    dutyRamp.reset(value.dutyCycle);
+    lastEmitted = value;
+    known = true;
+    emittedValid = true;
+}
+
+void SetpointRamp::clear() {
+    frequencyRamp.reset(0);
+    dutyRamp.reset(0);
+    known = false;
+    emittedValid = false;
+}
+
+void SetpointRamp::start(const Setpoint& target, uint64_t durationMicros, uint64_t nowMicros) {
+    // 起点未知时无法插值，直接跳到目标值
+    if (!known) {
+        durationMicros = 0;
+        known = true;
+    }
+    frequencyRamp.start((int32_t)target.frequency, durationMicros, nowMicros);
+    dutyRamp.start(target.dutyCycle, durationMicros, nowMicros);
+}
+
+bool SetpointRamp::poll(uint64_t nowMicros, Setpoint& out) {
+    frequencyRamp.update(nowMicros);
+    dutyRamp.update(nowMicros);
+
+    // 上一次写入在途时不输出，中间值被合并到确认后的下一次输出
+    if (inFlight || !pendingChange()) {
+        return false;
+    }
+    if (emitCount > 0 && nowMicros - lastEmitMicros < emitIntervalMicros) {
+        return false;
+    }
+
+    Setpoint value = getValue();
+    if (emittedValid && value.frequency == lastEmitted.frequency && value.dutyCycle == lastEmitted.dutyCycle) {
+        return false;
+    }
+    lastEmitted = value;
+    lastEmitMicros = nowMicros;
+    emittedValid = true;
+    inFlight = true;
+    emitCount++;
+    out = value;
+    return true;
+}
+
+void SetpointRamp::acknowledge(bool success) {
+    inFlight = false;
+    if (!success) {
+        emittedValid = false;
+    }
+}
+
+bool SetpointRamp::isBusy() const {
+    return inFlight || pendingChange();
+}
+
+uint32_t SetpointRamp::getMicrosUntilNextEmit(uint64_t nowMicros) const {
+    if (inFlight || !pendingChange()) {
+        return NO_UPDATE;
+    }
+    if (emitCount == 0) {
+        return 0;
+    }
+    uint64_t elapsed = nowMicros - lastEmitMicros;
+    return elapsed >= emitIntervalMicros ? 0 : (uint32_t)(emitIntervalMicros - elapsed);
+}
+
+SetpointRamp::Setpoint SetpointRamp::getValue() const {
+    Setpoint value;
+    value.frequency = (uint32_t)frequencyRamp.getValue();
+    value.dutyCycle = (uint8_t)dutyRamp.getValue();
+    return value;
+}
+
+SetpointRamp::Setpoint SetpointRamp::getTarget() const {
+    Setpoint target;
+    target.frequency = (uint32_t)frequencyRamp.getTarget();
+    target.dutyCycle = (uint8_t)dutyRamp.getTarget();
+    return target;
+}
+
+bool SetpointRamp::pendingChange() const {
+    if (!known) {
+        return false;
+    }
+    if (isRamping() || !emittedValid) {
+        return true;
+    }
+    Setpoint value = getValue();
+    return value.frequency != lastEmitted.frequency || value.dutyCycle != lastEmitted.dutyCycle;
+}
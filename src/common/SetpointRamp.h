@@ -0,0 +1,119 @@
+#ifndef SETPOINT_RAMP_H
+#define SETPOINT_RAMP_H
+
+#include <stdint.h>
+#include "RampGenerator.h"
+
+/**
+ * 调速器频率/占空比设定值斜坡（与硬件无关，时钟由调用者传入）
+ *
+ * 用两个RampGenerator生成频率和占空比的轨迹，按固定间隔取样输出设定值。
+ * 输出被限速和合并：两次输出至少相隔emitInterval；上一次输出尚未确认（写入还在队列或总线上）时
+ * 不输出新值，期间的中间值被丢弃，确认后直接输出当时的最新值。因此任何时刻最多只有一个
+ * 设定值写入在途，轨迹再密也不会挤满MODBUS事务队列。斜坡结束后的目标值一定会被输出。
+ * 时间为64位单调微秒（见MonotonicClock）。
+ */
+class SetpointRamp {
+public:
+    static const uint32_t NO_UPDATE = 0xFFFFFFFF;
+
+    struct Setpoint {
+        uint32_t frequency;     // 频率 (Hz)
+        uint8_t dutyCycle;      // 占空比 (0-100%)
+    };
+
+    SetpointRamp();
+
+    /**
+     * 设置斜坡曲线（对之后start()的斜坡生效）
+     */
+    void setProfile(RampProfile profile);
+    RampProfile getProfile() const { return frequencyRamp.getProfile(); }
+
+    /**
+     * 设置两次输出之间的最小间隔
+     * @param intervalMicros 间隔（微秒）
+     */
+    void setEmitInterval(uint32_t intervalMicros) { emitIntervalMicros = intervalMicros; }
+    uint32_t getEmitInterval() const { return emitIntervalMicros; }
+
+    /**
+     * 设定调速器的当前输出（例如读取到的寄存器值），不产生输出
+     * @param value 当前输出
+     */
+    void reset(const Setpoint& value);
+
+    /**
+     * 放弃斜坡和当前输出（设定值被其他途径直接修改后调用），之后需要reset()或start()才有起点
+     */
+    void clear();
+
+    /**
+     * 当前输出是否已知（可以作为斜坡起点）
+     */
+    bool hasValue() const { return known; }
+
+    /**
+     * 从当前轨迹位置开始，经过durationMicros变化到目标值
+     * 当前输出未知时直接跳到目标值
+     * @param target 目标值
+     * @param durationMicros 斜坡时长
+     * @param nowMicros 斜坡开始时刻
+     */
+    void start(const Setpoint& target, uint64_t durationMicros, uint64_t nowMicros);
+
+    /**
+     * 推进到当前时刻，判断是否需要输出设定值
+     * @param nowMicros 当前时刻
+     * @param out 需要输出时写入设定值
+     * @return 是否需要输出；返回true后必须在写入完成（或提交失败）时调用acknowledge()
+     */
+    bool poll(uint64_t nowMicros, Setpoint& out);
+
+    /**
+     * 确认上一次输出的写入已完成
+     * @param success 写入是否成功；失败时下一次输出重发当时的轨迹值
+     */
+    void acknowledge(bool success);
+
+    /**
+     * 是否还有未输出的变化（斜坡进行中、目标值未输出或写入在途）
+     */
+    bool isBusy() const;
+    bool isRamping() const { return frequencyRamp.isActive() || dutyRamp.isActive(); }
+    bool isInFlight() const { return inFlight; }
+
+    /**
+     * 距下一次可能输出的时间
+     * @param nowMicros 当前时刻
+     * @return 微秒；写入在途（等待确认）或没有未输出的变化时返回NO_UPDATE
+     */
+    uint32_t getMicrosUntilNextEmit(uint64_t nowMicros) const;
+
+    /**
+     * 当前轨迹值
+     */
+    Setpoint getValue() const;
+
+    /**
+     * 目标值
+     */
+    Setpoint getTarget() const;
+
+    uint32_t getEmitCount() const { return emitCount; }
+
+private:
+    bool pendingChange() const;
+
+    RampGenerator frequencyRamp;
+    RampGenerator dutyRamp;
+    uint32_t emitIntervalMicros;
+    Setpoint lastEmitted;
+    uint64_t lastEmitMicros;
+    bool known;             // 轨迹起点（调速器当前输出）是否已知
+    bool emittedValid;      // lastEmitted是否与调速器一致
+    bool inFlight;          // 上一次输出等待确认
+    uint32_t emitCount;
+};
+
+#endif // SETPOINT_RAMP_H
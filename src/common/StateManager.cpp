@@ -133,6 +133,10 @@ void StateManager::unregisterStateListener(std::function<void(const StateChangeE
 }
 
 String StateManager::getStateName(SystemState state) {
+    return String(getStateNameCStr(state));
+}
+
+const char* StateManager::getStateNameCStr(SystemState state) {
     switch (state) {
         case SystemState::INIT:     return "INIT";
         case SystemState::IDLE:     return "IDLE";
@@ -150,7 +154,8 @@ std::vector<StateChangeEvent> StateManager::getStateHistory(size_t maxEntries) c
     size_t entriesToReturn = (maxEntries < m_historyCount) ? maxEntries : m_historyCount;
     
     for (size_t i = 0; i < entriesToReturn; i++) {
-        size_t index = (m_historyHead + m_historyCount - entriesToReturn + i) % MAX_HISTORY_SIZE;
+        // 最近的entriesToReturn条记录，从较早的开始
+        size_t index = (m_historyHead + MAX_HISTORY_SIZE - entriesToReturn + i) % MAX_HISTORY_SIZE;
         result.push_back(m_stateHistory[index]);
     }
     
@@ -97,6 +97,13 @@ public:
      */
     static String getStateName(SystemState state);
     
+    /**
+     * @brief 获取状态名称（静态字符串，不分配内存）
+     * @param state 状态枚举
+     * @return const char* 状态名称
+     */
+    static const char* getStateNameCStr(SystemState state);
+    
     /**
      * @brief 获取状态变更历史
      * @param maxEntries 最大返回条目数
@@ -0,0 +1,87 @@
+#ifndef STATIC_EVENT_BUS_H
+#define STATIC_EVENT_BUS_H
+
+#include <stddef.h>
+#include <tuple>
+#include <type_traits>
+
+/**
+ * 编译期事件总线
+ *
+ * 事件是普通结构体，订阅者是总线的模板参数：publish()在编译期展开为对每个订阅者
+ * onEvent(const E&)的直接调用，没有类型擦除、没有void*负载，可被内联。
+ * 订阅者没有对应onEvent重载时该事件被忽略；模板化的onEvent接收所有事件
+ * （例如EventManagerBridge把事件转发给运行时的EventManager）。
+ *
+ * 总线只保存订阅者的引用，订阅者的生命周期由调用者管理；订阅关系在编译期确定，
+ * 需要运行时增删的监听器仍通过EventManager订阅。
+ *
+ * 示例：
+ *   struct DutyChanged { uint8_t duty; };
+ *   struct Display { void onEvent(const DutyChanged& e); };
+ *   StaticEventBus<Display, EventManagerBridge> bus(display, bridge);
+ *   bus.publish(DutyChanged{50});
+ */
+template <typename... Subscribers>
+class StaticEventBus {
+public:
+    explicit StaticEventBus(Subscribers&... subscribers) : _subscribers(subscribers...) {}
+
+    /**
+     * 按模板参数顺序把事件同步交给每个能处理它的订阅者
+     */
+    template <typename Event>
+    void publish(const Event& event) {
+        dispatch<0>(event);
+    }
+
+    /**
+     * 编译期判断是否有订阅者处理某个事件
+     */
+    template <typename Event>
+    static constexpr bool handles() {
+        return anyHandles<Event, Subscribers...>();
+    }
+
+    static constexpr size_t subscriberCount() { return sizeof...(Subscribers); }
+
+private:
+    template <size_t Index, typename Event>
+    typename std::enable_if<(Index < sizeof...(Subscribers))>::type dispatch(const Event& event) {
+        deliver(std::get<Index>(_subscribers), event, 0);
+        dispatch<Index + 1>(event);
+    }
+
+    template <size_t Index, typename Event>
+    typename std::enable_if<(Index == sizeof...(Subscribers))>::type dispatch(const Event&) {}
+
+    // 优先匹配int参数的版本：订阅者有onEvent(const Event&)时调用，否则落到空操作
+    template <typename Subscriber, typename Event>
+    static auto deliver(Subscriber& subscriber, const Event& event, int) -> decltype(subscriber.onEvent(event), void()) {
+        subscriber.onEvent(event);
+    }
+
+    template <typename Subscriber, typename Event>
+    static void deliver(Subscriber&, const Event&, long) {}
+
+    template <typename Subscriber, typename Event>
+    struct SubscriberHandles {
+        template <typename S>
+        static auto test(int) -> decltype(std::declval<S&>().onEvent(std::declval<const Event&>()), std::true_type());
+        template <typename S>
+        static std::false_type test(long);
+        static const bool value = decltype(test<Subscriber>(0))::value;
+    };
+
+    template <typename Event>
+    static constexpr bool anyHandles() { return false; }
+
+    template <typename Event, typename First, typename... Rest>
+    static constexpr bool anyHandles() {
+        return SubscriberHandles<First, Event>::value || anyHandles<Event, Rest...>();
+    }
+
+    std::tuple<Subscribers&...> _subscribers;
+};
+
+#endif // STATIC_EVENT_BUS_H
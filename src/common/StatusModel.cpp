@@ -0,0 +1,162 @@
+#include "StatusModel.h"
+
+StatusModel::StatusModel()
+    : fieldCount(0)
+    , dirtyMask(0)
+    , minIntervalMs(0)
+    , maxIntervalMs(0)
+    , keyframeInterval(0)
+    , deltasSinceKeyframe(0)
+    , keyframeRequested(false)
+    , synced(false)
+    , lastNotifyMs(0)
+    , sequence(0)
+    , deltaCount(0)
+    , keyframeCount(0) {
+    for (uint8_t i = 0; i < MAX_FIELDS; i++) {
+        fields[i] = Field();
+    }
+}
+
+bool StatusModel::defineField(uint8_t index, FieldKind kind, uint32_t deadband) {
+    if (index >= MAX_FIELDS) {
+        return false;
+    }
+    fields[index] = Field();
+    fields[index].kind = kind;
+    fields[index].deadband = deadband;
+    if (index >= fieldCount) {
+        fieldCount = index + 1;
+    }
+    return true;
+}
+
+uint32_t StatusModel::getAllFieldsMask() const {
+    return fieldCount >= 32 ? 0xFFFFFFFFu : ((1u << fieldCount) - 1);
+}
+
+void StatusModel::setIntervals(uint32_t minInterval, uint32_t maxInterval) {
+    minIntervalMs = minInterval;
+    maxIntervalMs = maxInterval;
+}
+
+void StatusModel::set(uint8_t index, int64_t value, uint64_t nowMs) {
+    if (index >= fieldCount) {
+        return;
+    }
+    Field& field = fields[index];
+    field.value = value;
+    field.valueAtMs = nowMs;
+    if (isChanged(field)) {
+        dirtyMask |= (1u << index);
+    } else {
+        // 变化回到死区内（例如来回切换）时不再需要发送
+        dirtyMask &= ~(1u << index);
+    }
+}
+
+int64_t StatusModel::get(uint8_t index) const {
+    return index < fieldCount ? fields[index].value : 0;
+}
+
+void StatusModel::markDirty(uint8_t index) {
+    if (index < fieldCount) {
+        dirtyMask |= (1u << index);
+    }
+}
+
+void StatusModel::reset() {
+    synced = false;
+    keyframeRequested = false;
+    dirtyMask = 0;
+    deltasSinceKeyframe = 0;
+}
+
+// 与客户端按发出值推算的当前值比较
+bool StatusModel::isChanged(const Field& field) const {
+    int64_t expected = field.sentValue;
+    int64_t elapsed = field.valueAtMs > field.sentAtMs ? (int64_t)(field.valueAtMs - field.sentAtMs) : 0;
+    if (field.kind == FieldKind::COUNTDOWN) {
+        expected = field.sentValue > elapsed ? field.sentValue - elapsed : 0;
+    } else if (field.kind == FieldKind::COUNTUP) {
+        expected = field.sentValue + elapsed;
+    }
+    int64_t diff = field.value >= expected ? field.value - expected : expected - field.value;
+    return diff > (int64_t)field.deadband;
+}
+
+bool StatusModel::isKeyframeDue() const {
+    return keyframeRequested || (keyframeInterval > 0 && deltasSinceKeyframe >= keyframeInterval);
+}
+
+StatusModel::Notify StatusModel::poll(uint64_t nowMs) const {
+    // 客户端还没有完整状态：立即发送关键帧
+    if (!synced) {
+        return Notify::KEYFRAME;
+    }
+
+    uint64_t elapsed = nowMs > lastNotifyMs ? nowMs - lastNotifyMs : 0;
+    bool pending = keyframeRequested || dirtyMask != 0;
+    if (pending) {
+        if (elapsed < minIntervalMs) {
+            return Notify::NONE;
+        }
+    } else if (maxIntervalMs == 0 || elapsed < maxIntervalMs) {
+        return Notify::NONE;
+    }
+    return isKeyframeDue() ? Notify::KEYFRAME : Notify::DELTA;
+}
+
+uint32_t StatusModel::getMsUntilNextNotify(uint64_t nowMs) const {
+    if (!synced) {
+        return 0;
+    }
+
+    uint64_t elapsed = nowMs > lastNotifyMs ? nowMs - lastNotifyMs : 0;
+    uint64_t interval;
+    if (keyframeRequested || dirtyMask != 0) {
+        interval = minIntervalMs;
+    } else if (maxIntervalMs > 0) {
+        interval = maxIntervalMs;
+    } else {
+        return NO_NOTIFY;
+    }
+    return elapsed >= interval ? 0 : (uint32_t)(interval - elapsed);
+}
+
+uint32_t StatusModel::getMsUntilAllowed(uint64_t nowMs) const {
+    if (!synced) {
+        return 0;
+    }
+    uint64_t elapsed = nowMs > lastNotifyMs ? nowMs - lastNotifyMs : 0;
+    return elapsed >= minIntervalMs ? 0 : (uint32_t)(minIntervalMs - elapsed);
+}
+
+void StatusModel::markSent(Notify kind, uint64_t nowMs) {
+    if (kind == Notify::NONE) {
+        return;
+    }
+
+    uint32_t mask = kind == Notify::KEYFRAME ? getAllFieldsMask() : dirtyMask;
+    for (uint8_t i = 0; i < fieldCount; i++) {
+        if (mask & (1u << i)) {
+            fields[i].sentValue = fields[i].value;
+            fields[i].sentAtMs = fields[i].valueAtMs;
+        }
+    }
+    dirtyMask &= ~mask;
+
+    if (kind == Notify::KEYFRAME) {
+        synced = true;
+        keyframeRequested = false;
+        deltasSinceKeyframe = 0;
+        keyframeCount++;
+    } else {
+        if (deltasSinceKeyframe < 0xFFFF) {
+            deltasSinceKeyframe++;
+        }
+        deltaCount++;
+    }
+    lastNotifyMs = nowMs;
+    sequence++;
+}
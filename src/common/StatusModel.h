@@ -0,0 +1,154 @@
+#ifndef STATUS_MODEL_H
+#define STATUS_MODEL_H
+
+#include <stdint.h>
+
+/**
+ * 变化驱动的状态通知模型（与硬件无关，时钟由调用者传入）
+ *
+ * 每个状态字段保存当前值和客户端已知的值（最近一次通知发出的值），当前值与客户端按字段类型
+ * 推算出的值相差超过死区时置脏位，通知只携带脏字段（增量）。倒计时/正计时字段由客户端按经过的
+ * 时间自行推算，稳定计时时不产生增量。
+ * 通知节奏：
+ *   - 两次通知至少相隔minInterval，期间的变化合并到下一次通知；
+ *   - 超过maxInterval没有通知时发送一次心跳（可能不含字段），客户端据此判断连接仍然有效；
+ *   - 每keyframeInterval次增量后发送一次关键帧（全部字段），requestKeyframe()（如新连接）也会触发，
+ *     客户端丢失通知后最多经过一个关键帧周期即可恢复完整状态。
+ * 每次通知带16位序号，客户端据此发现丢失的增量。时间为64位单调毫秒（见MonotonicClock）。
+ */
+class StatusModel {
+public:
+    static const uint8_t MAX_FIELDS = 32;
+    static const uint32_t NO_NOTIFY = 0xFFFFFFFF;
+
+    enum class FieldKind : uint8_t {
+        VALUE = 0,      // 普通值
+        COUNTDOWN = 1,  // 倒计时：客户端按经过的时间递减，减到0为止
+        COUNTUP = 2     // 正计时：客户端按经过的时间递增
+    };
+
+    enum class Notify : uint8_t {
+        NONE = 0,       // 暂不通知
+        DELTA = 1,      // 增量：只含脏字段（心跳时可能为空）
+        KEYFRAME = 2    // 关键帧：全部字段
+    };
+
+    StatusModel();
+
+    /**
+     * 定义字段（字段编号从0开始连续定义）
+     * @param index 字段编号
+     * @param kind 字段类型
+     * @param deadband 死区：与客户端推算值之差不超过死区时不视为变化
+     * @return 编号是否有效
+     */
+    bool defineField(uint8_t index, FieldKind kind, uint32_t deadband = 0);
+    uint8_t getFieldCount() const { return fieldCount; }
+    uint32_t getAllFieldsMask() const;
+
+    /**
+     * 设置通知间隔
+     * @param minIntervalMs 两次通知的最小间隔（毫秒）
+     * @param maxIntervalMs 无变化时的心跳间隔（毫秒），0表示不发送心跳
+     */
+    void setIntervals(uint32_t minIntervalMs, uint32_t maxIntervalMs);
+
+    /**
+     * 设置关键帧周期
+     * @param deltas 每多少次增量后发送一次关键帧，0表示只在requestKeyframe()后发送
+     */
+    void setKeyframeInterval(uint16_t deltas) { keyframeInterval = deltas; }
+
+    /**
+     * 更新字段的当前值并重新判断脏位
+     * @param index 字段编号
+     * @param value 当前值
+     * @param nowMs 取值时刻
+     */
+    void set(uint8_t index, int64_t value, uint64_t nowMs);
+    int64_t get(uint8_t index) const;
+
+    /**
+     * 强制下一次增量包含该字段（值未变但附带的信息需要发送时使用）
+     */
+    void markDirty(uint8_t index);
+
+    /**
+     * 脏字段掩码（bit i对应字段i）
+     */
+    uint32_t getDirtyMask() const { return dirtyMask; }
+
+    /**
+     * 下一次通知发送关键帧（新连接、客户端请求重新同步时调用）
+     */
+    void requestKeyframe() { keyframeRequested = true; }
+
+    /**
+     * 忘记客户端已知的状态（断开连接时调用），下一次通知为关键帧且不受最小间隔限制
+     */
+    void reset();
+
+    /**
+     * 判断当前时刻应发送的通知
+     * @param nowMs 当前时刻
+     * @return 通知类型；返回DELTA时应发送getDirtyMask()中的字段，发送后调用markSent()
+     */
+    Notify poll(uint64_t nowMs) const;
+
+    /**
+     * 距下一次需要poll()的时间
+     * @param nowMs 当前时刻
+     * @return 毫秒；没有待发送的变化且不发送心跳时为NO_NOTIFY
+     */
+    uint32_t getMsUntilNextNotify(uint64_t nowMs) const;
+
+    /**
+     * 距最小间隔结束的时间（此前即使有变化也不会通知）
+     * @param nowMs 当前时刻
+     * @return 毫秒
+     */
+    uint32_t getMsUntilAllowed(uint64_t nowMs) const;
+
+    /**
+     * 记录通知已发出：发出的字段成为客户端已知的值，序号加1
+     * @param kind poll()返回的通知类型
+     * @param nowMs 发送时刻
+     */
+    void markSent(Notify kind, uint64_t nowMs);
+
+    /**
+     * 下一次通知的序号
+     */
+    uint16_t getSequence() const { return sequence; }
+    uint32_t getDeltaCount() const { return deltaCount; }
+    uint32_t getKeyframeCount() const { return keyframeCount; }
+
+private:
+    struct Field {
+        int64_t value;          // 当前值
+        int64_t sentValue;      // 最近一次通知发出的值
+        uint64_t valueAtMs;     // 当前值的取值时刻
+        uint64_t sentAtMs;      // 发出值的取值时刻
+        uint32_t deadband;
+        FieldKind kind;
+    };
+
+    bool isChanged(const Field& field) const;
+    bool isKeyframeDue() const;
+
+    Field fields[MAX_FIELDS];
+    uint8_t fieldCount;
+    uint32_t dirtyMask;
+    uint32_t minIntervalMs;
+    uint32_t maxIntervalMs;
+    uint16_t keyframeInterval;
+    uint16_t deltasSinceKeyframe;
+    bool keyframeRequested;
+    bool synced;                // 客户端是否已收到过关键帧
+    uint64_t lastNotifyMs;
+    uint16_t sequence;
+    uint32_t deltaCount;
+    uint32_t keyframeCount;
+};
+
+#endif // STATUS_MODEL_H
@@ -0,0 +1,57 @@
+#include "StatusPacket.h"
+
+namespace {
+
+void put16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+void put32(uint8_t* p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+uint16_t get16(const uint8_t* p) {
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+uint32_t get32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+} // namespace
+
+size_t StatusPacketCodec::encode(const StatusPacket& packet, uint8_t* buffer, size_t size) {
+    if (buffer == nullptr || size < StatusPacket::SIZE) {
+        return 0;
+    }
+    buffer[0] = StatusPacket::VERSION;
+    put16(&buffer[1], packet.sequence);
+    buffer[3] = packet.state;
+    buffer[4] = packet.flags;
+    buffer[5] = packet.errors;
+    put32(&buffer[6], packet.remainingMs);
+    put32(&buffer[10], packet.cycleCount);
+    put32(&buffer[14], packet.frequency);
+    put16(&buffer[18], packet.dutyPermille);
+    return StatusPacket::SIZE;
+}
+
+bool StatusPacketCodec::decode(const uint8_t* data, size_t length, StatusPacket& packet) {
+    if (data == nullptr || length < StatusPacket::SIZE || data[0] == 0) {
+        return false;
+    }
+    packet.version = data[0];
+    packet.sequence = get16(&data[1]);
+    packet.state = data[3];
+    packet.flags = data[4];
+    packet.errors = data[5];
+    packet.remainingMs = get32(&data[6]);
+    packet.cycleCount = get32(&data[10]);
+    packet.frequency = get32(&data[14]);
+    packet.dutyPermille = get16(&data[18]);
+    return true;
+}
@@ -0,0 +1,75 @@
+#ifndef STATUS_PACKET_H
+#define STATUS_PACKET_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * 二进制状态包（供App轮询/订阅，JSON状态仍保留给人读）
+ *
+ * 固定布局，小端序，共20字节，默认MTU（23）下一次通知或读取即可完整传输：
+ *   偏移 长度 字段
+ *    0    1   版本（StatusPacket::VERSION）
+ *    1    2   序号（每发送一次通知加1，回绕；读取返回最近一次通知的序号；App据此发现丢失的通知）
+ *    3    1   电机状态（MotorControllerState）
+ *    4    1   状态标志（FLAG_*）
+ *    5    1   错误标志（ERROR_*）
+ *    6    4   当前阶段剩余时间（毫秒）
+ *   10    4   当前循环次数
+ *   14    4   频率（Hz）
+ *   18    2   占空比（0.1%）
+ * 版本规则：已有字段的位置和含义不变，新字段只追加在末尾并增加版本号。
+ * 解码时接受版本不低于1、长度不小于SIZE的数据，只读取已知字段。
+ */
+struct StatusPacket {
+    static const uint8_t VERSION = 1;
+    static const size_t SIZE = 20;
+
+    // 状态标志
+    static const uint8_t FLAG_RUNNING = 0x01;       // 电机运行中
+    static const uint8_t FLAG_AUTO_START = 0x02;    // 自动启动
+    static const uint8_t FLAG_PROGRAM = 0x04;       // 电机程序执行中
+    static const uint8_t FLAG_PWM_OUTPUT = 0x08;    // PWM输出方式（否则为GPIO开关输出+MODBUS调速器）
+    static const uint8_t FLAG_OUTPUT_VALID = 0x10;  // 频率/占空比字段有效
+
+    // 错误标志
+    static const uint8_t ERROR_MOTOR = 0x01;            // 电机控制器处于错误状态
+    static const uint8_t ERROR_SPEED_CONTROLLER = 0x02; // 最近一次读取调速器失败
+    static const uint8_t ERROR_OUTPUT_MODE = 0x04;      // 配置为PWM输出但初始化失败，已回退到GPIO开关输出
+
+    uint8_t version;
+    uint16_t sequence;
+    uint8_t state;
+    uint8_t flags;
+    uint8_t errors;
+    uint32_t remainingMs;
+    uint32_t cycleCount;
+    uint32_t frequency;
+    uint16_t dutyPermille;
+};
+
+/**
+ * 状态包编解码（与硬件无关）
+ */
+class StatusPacketCodec {
+public:
+    /**
+     * 编码（版本字段固定写入StatusPacket::VERSION）
+     * @param packet 状态
+     * @param buffer 输出缓冲区
+     * @param size 缓冲区大小
+     * @return 写入的字节数，缓冲区不足时返回0
+     */
+    static size_t encode(const StatusPacket& packet, uint8_t* buffer, size_t size);
+
+    /**
+     * 解码
+     * @param data 数据
+     * @param length 数据长度（可以长于SIZE，多出的部分为更高版本追加的字段）
+     * @param packet 解码结果
+     * @return 版本和长度是否有效
+     */
+    static bool decode(const uint8_t* data, size_t length, StatusPacket& packet);
+};
+
+#endif // STATUS_PACKET_H
@@ -0,0 +1,104 @@
+#ifndef TYPED_EVENTS_H
+#define TYPED_EVENTS_H
+
+#include <Arduino.h>
+#include <type_traits>
+#include "EventManager.h"
+
+// 类型化事件：用于StaticEventBus，字段即负载，不经过EventData
+
+struct MotorStartEvent {
+    int32_t targetCycles;       // 目标循环次数，0为无限
+};
+
+struct MotorStopEvent {
+    int32_t cycleCount;         // 已完成的循环次数
+};
+
+struct MotorSpeedChangedEvent {
+    uint32_t frequency;         // 调速器频率（Hz，高低两个寄存器）
+    uint8_t dutyCycle;          // 占空比（%）
+};
+
+struct LedStateChangedEvent {
+    uint8_t state;              // LEDState
+};
+
+struct ErrorEvent {
+    EventSource source;
+    int32_t code;
+};
+
+/**
+ * 类型化事件到运行时EventData的映射
+ * 只有特化了EventTraits的事件才能经EventManagerBridge转发
+ */
+template <typename Event>
+struct EventTraits {};
+
+template <>
+struct EventTraits<MotorStartEvent> {
+    static EventData toEventData(const MotorStartEvent& event) {
+        return EventData(EventType::MOTOR_START, EventSource::MOTOR_CONTROLLER,
+                         event.targetCycles == 0 ? "电机启动，目标循环: 无限" : "电机启动，目标循环: %ld")
+            .withInts(event.targetCycles);
+    }
+};
+
+template <>
+struct EventTraits<MotorStopEvent> {
+    static EventData toEventData(const MotorStopEvent& event) {
+        return EventData(EventType::MOTOR_STOP, EventSource::MOTOR_CONTROLLER, "电机停止，循环次数: %ld")
+            .withInts(event.cycleCount);
+    }
+};
+
+template <>
+struct EventTraits<MotorSpeedChangedEvent> {
+    static EventData toEventData(const MotorSpeedChangedEvent& event) {
+        return EventData(EventType::MOTOR_SPEED_CHANGED, EventSource::MOTOR_CONTROLLER,
+                         "频率: %ldHz, 占空比: %ld%%", event.frequency)
+            .withInts(static_cast<int32_t>(event.frequency), event.dutyCycle);
+    }
+};
+
+template <>
+struct EventTraits<LedStateChangedEvent> {
+    static EventData toEventData(const LedStateChangedEvent& event) {
+        return EventData(EventType::LED_STATE_CHANGED, EventSource::LED_CONTROLLER, nullptr, event.state);
+    }
+};
+
+template <>
+struct EventTraits<ErrorEvent> {
+    static EventData toEventData(const ErrorEvent& event) {
+        return EventData(EventType::ERROR_OCCURRED, event.source, "错误码: %ld", event.code).withInts(event.code);
+    }
+};
+
+/**
+ * StaticEventBus的订阅者：把类型化事件转换为EventData交给EventManager，
+ * 使运行时订阅的监听器（如MainController、BLE通知）仍能收到
+ */
+class EventManagerBridge {
+public:
+    /**
+     * @param async 为true时用publishAsync()入队（可在BLE回调等其他任务中发布），否则同步publish()
+     */
+    explicit EventManagerBridge(bool async = false) : _async(async) {}
+
+    template <typename Event>
+    auto onEvent(const Event& event) -> decltype(EventTraits<Event>::toEventData(event), void()) {
+        EventManager& manager = EventManager::getInstance();
+        if (_async) {
+            manager.publishAsync(EventTraits<Event>::toEventData(event));
+        } else {
+            manager.publish(EventTraits<Event>::toEventData(event));
+        }
+    }
+
+private:
+    bool _async;
+};
+
+#endif // TYPED_EVENTS_H
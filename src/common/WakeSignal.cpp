@@ -0,0 +1,68 @@
+#include "WakeSignal.h"
+
+namespace {
+
+const uint32_t WAIT_FOREVER = 0xFFFFFFFF;
+const uint32_t TICK_MICROS = portTICK_PERIOD_MS * 1000;
+
+} // namespace
+
+WakeSignal& WakeSignal::getInstance() {
+    static WakeSignal instance;
+    return instance;
+}
+
+WakeSignal::WakeSignal() : _semaphore(nullptr), _pending(false), _notifyCount(0) {
+    _semaphore = xSemaphoreCreateBinary();
+}
+
+void WakeSignal::notify() {
+    if (_pending.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    _notifyCount.fetch_add(1, std::memory_order_relaxed);
+    if (_semaphore != nullptr) {
+        xSemaphoreGive(_semaphore);
+    }
+}
+
+void IRAM_ATTR WakeSignal::notifyFromISR() {
+    if (_pending.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    _notifyCount.fetch_add(1, std::memory_order_relaxed);
+    if (_semaphore != nullptr) {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        xSemaphoreGiveFromISR(_semaphore, &higherPriorityTaskWoken);
+        if (higherPriorityTaskWoken == pdTRUE) {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+
+void IRAM_ATTR WakeSignal::notifyAny() {
+    if (xPortInIsrContext()) {
+        notifyFromISR();
+    } else {
+        notify();
+    }
+}
+
+bool WakeSignal::consume(TickType_t ticks) {
+    if (_semaphore == nullptr || xSemaphoreTake(_semaphore, ticks) != pdTRUE) {
+        return false;
+    }
+    // 先清标记再返回：之后的notify()会重新释放信号量，不会丢失
+    _pending.store(false, std::memory_order_release);
+    return true;
+}
+
+bool WakeSignal::wait(uint32_t timeoutMicros) {
+    if (timeoutMicros == WAIT_FOREVER) {
+        return consume(portMAX_DELAY);
+    }
+
+    // 信号量按tick计时，向上取整；tick相位可能使超时提前不到一个tick返回，由调度器重新检查截止时间
+    TickType_t ticks = (TickType_t)(((uint64_t)timeoutMicros + TICK_MICROS - 1) / TICK_MICROS);
+    return consume(ticks);
+}
@@ -0,0 +1,59 @@
+#ifndef WAKE_SIGNAL_H
+#define WAKE_SIGNAL_H
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * 主循环唤醒信号
+ *
+ * 主循环按DeadlineScheduler给出的时间休眠，异步事件、BLE写入和LED定时器中断
+ * 通过notify()/notifyFromISR()提前唤醒。基于FreeRTOS二值信号量：
+ * 阻塞期间主循环任务让出CPU，空闲任务可以进入低功耗。
+ */
+class WakeSignal {
+public:
+    static WakeSignal& getInstance();
+
+    /**
+     * 唤醒主循环（任务上下文）；已有未处理的唤醒时不重复释放信号量
+     */
+    void notify();
+
+    /**
+     * 唤醒主循环（中断上下文）
+     */
+    void IRAM_ATTR notifyFromISR();
+
+    /**
+     * 唤醒主循环（任务或中断上下文），按xPortInIsrContext()选择notify()或notifyFromISR()
+     * 供可能在两种上下文中调用的代码使用（如EventManager::publishAsync）
+     */
+    void IRAM_ATTR notifyAny();
+
+    /**
+     * 等待唤醒或超时
+     * 超时向上取整到tick，整个等待都阻塞在信号量上（不忙等）。阻塞从当前tick周期的中途开始计数，
+     * 超时返回仍可能比请求的时间早不到一个tick，调用者需要重新检查截止时间
+     * （DeadlineScheduler::runDue()只执行已到期的任务并返回剩余时间）；
+     * 需要精确时刻的动作（电机相位切换）由硬件定时器中断完成，不依赖主循环的唤醒时刻
+     * @param timeoutMicros 超时时间，0xFFFFFFFF表示一直等待
+     * @return 是否被notify唤醒
+     */
+    bool wait(uint32_t timeoutMicros);
+
+    uint32_t getNotifyCount() const { return _notifyCount.load(std::memory_order_relaxed); }
+
+private:
+    WakeSignal();
+    WakeSignal(const WakeSignal&);
+    WakeSignal& operator=(const WakeSignal&);
+
+    bool consume(TickType_t ticks);
+
+    SemaphoreHandle_t _semaphore;
+    std::atomic<bool> _pending;
+    std::atomic<uint32_t> _notifyCount;
+};
+
+#endif // WAKE_SIGNAL_H
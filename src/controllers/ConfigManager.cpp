@@ -22,8 +22,8 @@ ConfigManager::ConfigManager() :
     memset(validationError, 0, sizeof(validationError));
     
     // 设置默认配置
-    defaultConfig.runDuration = 5;      // 5秒
-    defaultConfig.stopDuration = 2;     // 2秒
+    defaultConfig.runDurationMs = 5000; // 5秒
+    defaultConfig.stopDurationMs = 2000; // 2秒
     defaultConfig.cycleCount = 0;       // 无限循环
     defaultConfig.autoStart = true;     // 自动启动
     
@@ -96,8 +96,8 @@ bool ConfigManager::loadConfig() {
         isModified = true; // 标记为已修改，以便后续保存
         
         LOG_TAG_INFO("ConfigManager", "使用默认配置");
-        LOG_TAG_DEBUG("ConfigManager", "默认配置 - 运行时长: %lu 秒, 停止时长: %lu 秒, 循环次数: %lu, 自动启动: %s",
-                      currentConfig.runDuration, currentConfig.stopDuration,
+        LOG_TAG_DEBUG("ConfigManager", "默认配置 - 运行时长: %lu ms, 停止时长: %lu ms, 循环次数: %lu, 自动启动: %s",
+                      currentConfig.runDurationMs, currentConfig.stopDurationMs,
                       currentConfig.cycleCount, currentConfig.autoStart ? "是" : "否");
         
         return true; // 使用默认配置也算成功
@@ -122,8 +122,8 @@ bool ConfigManager::loadConfig() {
     isModified = false;
     
     LOG_TAG_INFO("ConfigManager", "配置加载成功");
-    LOG_TAG_DEBUG("ConfigManager", "运行时长: %lu 秒, 停止时长: %lu 秒, 循环次数: %lu, 自动启动: %s",
-                  currentConfig.runDuration, currentConfig.stopDuration,
+    LOG_TAG_DEBUG("ConfigManager", "运行时长: %lu ms, 停止时长: %lu ms, 循环次数: %lu, 自动启动: %s",
+                  currentConfig.runDurationMs, currentConfig.stopDurationMs,
                   currentConfig.cycleCount, currentConfig.autoStart ? "是" : "否");
     
     return true;
@@ -199,6 +199,87 @@ bool ConfigManager::deleteStoredConfig() {
     return true;
 }
 
+/**
+ * 保存电机程序到NVS
+ */
+bool ConfigManager::saveProgram(const MotorProgram& program) {
+    if (!isInitialized) {
+        setLastError("配置管理器未初始化");
+        LOG_TAG_ERROR("ConfigManager", "配置管理器未初始化");
+        return false;
+    }
+    
+    setLastError("");
+    
+    uint8_t buffer[MotorProgram::MAX_SERIALIZED_SIZE];
+    size_t length = program.serialize(buffer, sizeof(buffer));
+    if (length == 0) {
+        setLastError("电机程序未编译");
+        LOG_TAG_ERROR("ConfigManager", "电机程序未编译，无法保存");
+        return false;
+    }
+    
+    if (!nvsStorage.saveProgram(buffer, length)) {
+        setLastError("保存电机程序到NVS失败");
+        LOG_TAG_ERROR("ConfigManager", "保存电机程序到NVS失败: %s", nvsStorage.getLastError());
+        return false;
+    }
+    
+    LOG_TAG_INFO("ConfigManager", "电机程序保存成功: %u条指令, %u字节",
+                 program.getInstructionCount(), (unsigned)length);
+    return true;
+}
+
+/**
+ * 从NVS加载电机程序
+ */
+bool ConfigManager::loadProgram(MotorProgram& program) {
+    if (!isInitialized) {
+        setLastError("配置管理器未初始化");
+        LOG_TAG_ERROR("ConfigManager", "配置管理器未初始化");
+        return false;
+    }
+    
+    setLastError("");
+    
+    uint8_t buffer[MotorProgram::MAX_SERIALIZED_SIZE];
+    size_t length = sizeof(buffer);
+    if (!nvsStorage.loadProgram(buffer, length)) {
+        return false;
+    }
+    
+    if (!program.deserialize(buffer, length)) {
+        setLastError("存储的电机程序无效");
+        LOG_TAG_ERROR("ConfigManager", "存储的电机程序无效: %s", program.getLastError());
+        return false;
+    }
+    
+    LOG_TAG_INFO("ConfigManager", "电机程序加载成功: %u条指令", program.getInstructionCount());
+    return true;
+}
+
+/**
+ * 删除存储的电机程序
+ */
+bool ConfigManager::deleteStoredProgram() {
+    if (!isInitialized) {
+        setLastError("配置管理器未初始化");
+        LOG_TAG_ERROR("ConfigManager", "配置管理器未初始化");
+        return false;
+    }
+    
+    setLastError("");
+    
+    if (!nvsStorage.deleteProgram()) {
+        setLastError("删除存储的电机程序失败");
+        LOG_TAG_ERROR("ConfigManager", "删除存储的电机程序失败: %s", nvsStorage.getLastError());
+        return false;
+    }
+    
+    LOG_TAG_INFO("ConfigManager", "存储的电机程序已删除");
+    return true;
+}
+
 /**
  * 获取当前配置
  */
@@ -232,8 +313,8 @@ void ConfigManager::updateConfig(const MotorConfig& config) {
     }
     
     LOG_TAG_INFO("ConfigManager", "配置已更新");
-    LOG_TAG_DEBUG("ConfigManager", "运行时长: %lu 秒, 停止时长: %lu 秒, 循环次数: %lu, 自动启动: %s",
-                  currentConfig.runDuration, currentConfig.stopDuration,
+    LOG_TAG_DEBUG("ConfigManager", "运行时长: %lu ms, 停止时长: %lu ms, 循环次数: %lu, 自动启动: %s",
+                  currentConfig.runDurationMs, currentConfig.stopDurationMs,
                   currentConfig.cycleCount, currentConfig.autoStart ? "是" : "否");
 }
 
@@ -242,14 +323,14 @@ void ConfigManager::updateConfig(const MotorConfig& config) {
  */
 bool ConfigManager::validateConfig(const MotorConfig& config) const {
     // 验证运行时长
-    if (config.runDuration < 1 || config.runDuration > 999) {  // 1-999秒
-        const_cast<ConfigManager*>(this)->setValidationError("运行时长必须在1秒到999秒之间");
+    if (config.runDurationMs < MOTOR_MIN_RUN_DURATION_MS || config.runDurationMs > MOTOR_MAX_DURATION_MS) {  // 10毫秒-7天
+        const_cast<ConfigManager*>(this)->setValidationError("运行时长必须在10毫秒到7天之间");
         return false;
     }
     
     // 验证停止时长
-    if (config.stopDuration > 999) {  // 0-999秒
-        const_cast<ConfigManager*>(this)->setValidationError("停止时长必须在0秒到999秒之间");
+    if (config.stopDurationMs > MOTOR_MAX_DURATION_MS) {  // 0-7天
+        const_cast<ConfigManager*>(this)->setValidationError("停止时长必须在0毫秒到7天之间");
         return false;
     }
     
@@ -259,6 +340,24 @@ bool ConfigManager::validateConfig(const MotorConfig& config) const {
         return false;
     }
     
+    // 验证PWM输出参数
+    if (config.outputMode != MotorOutputMode::SWITCH && config.outputMode != MotorOutputMode::PWM) {
+        const_cast<ConfigManager*>(this)->setValidationError("输出方式无效");
+        return false;
+    }
+    if (config.pwmFrequency < MOTOR_PWM_MIN_FREQUENCY || config.pwmFrequency > MOTOR_PWM_MAX_FREQUENCY) {
+        const_cast<ConfigManager*>(this)->setValidationError("PWM频率必须在10Hz到40000Hz之间");
+        return false;
+    }
+    if (config.pwmDutyCycle > 100) {
+        const_cast<ConfigManager*>(this)->setValidationError("PWM占空比不能超过100%");
+        return false;
+    }
+    if (config.softStartMs > MOTOR_PWM_MAX_SOFT_TIME_MS || config.softStopMs > MOTOR_PWM_MAX_SOFT_TIME_MS) {
+        const_cast<ConfigManager*>(this)->setValidationError("缓启动/缓停止时间不能超过6553.5秒");
+        return false;
+    }
+    
     // 验证通过
     const_cast<ConfigManager*>(this)->setValidationError("");
     return true;
@@ -377,20 +476,20 @@ bool ConfigManager::validateAndSanitizeConfig(MotorConfig& config) const {
     String corrections = "";
     
     // 修正运行时长
-    if (config.runDuration < 1) {
-        corrections += "运行时长过小，已修正为1秒; ";
-        config.runDuration = 1;
+    if (config.runDurationMs < MOTOR_MIN_RUN_DURATION_MS) {
+        corrections += "运行时长过小，已修正为10毫秒; ";
+        config.runDurationMs = MOTOR_MIN_RUN_DURATION_MS;
         wasModified = true;
-    } else if (config.runDuration > 999) {
-        corrections += "运行时长过大，已修正为999秒; ";
-        config.runDuration = 999;
+    } else if (config.runDurationMs > MOTOR_MAX_DURATION_MS) {
+        corrections += "运行时长过大，已修正为7天; ";
+        config.runDurationMs = MOTOR_MAX_DURATION_MS;
         wasModified = true;
     }
     
     // 修正停止时长
-    if (config.stopDuration > 999) {
-        corrections += "停止时长过大，已修正为999秒; ";
-        config.stopDuration = 999;
+    if (config.stopDurationMs > MOTOR_MAX_DURATION_MS) {
+        corrections += "停止时长过大，已修正为7天; ";
+        config.stopDurationMs = MOTOR_MAX_DURATION_MS;
         wasModified = true;
     }
     
@@ -401,19 +500,46 @@ bool ConfigManager::validateAndSanitizeConfig(MotorConfig& config) const {
         wasModified = true;
     }
     
+    // 修正PWM输出参数
+    if (config.outputMode != MotorOutputMode::SWITCH && config.outputMode != MotorOutputMode::PWM) {
+        corrections += "输出方式无效，已修正为GPIO开关; ";
+        config.outputMode = MotorOutputMode::SWITCH;
+        wasModified = true;
+    }
+    if (config.pwmFrequency < MOTOR_PWM_MIN_FREQUENCY || config.pwmFrequency > MOTOR_PWM_MAX_FREQUENCY) {
+        corrections += "PWM频率超出范围，已恢复为默认值; ";
+        config.pwmFrequency = defaultConfig.pwmFrequency;
+        wasModified = true;
+    }
+    if (config.pwmDutyCycle > 100) {
+        corrections += "PWM占空比过大，已修正为100%; ";
+        config.pwmDutyCycle = 100;
+        wasModified = true;
+    }
+    if (config.softStartMs > MOTOR_PWM_MAX_SOFT_TIME_MS) {
+        corrections += "缓启动时间过大，已修正为6553.5秒; ";
+        config.softStartMs = MOTOR_PWM_MAX_SOFT_TIME_MS;
+        wasModified = true;
+    }
+    if (config.softStopMs > MOTOR_PWM_MAX_SOFT_TIME_MS) {
+        corrections += "缓停止时间过大，已修正为6553.5秒; ";
+        config.softStopMs = MOTOR_PWM_MAX_SOFT_TIME_MS;
+        wasModified = true;
+    }
+    
     // 特殊情况处理：如果运行时长和停止时长都为0，使用默认值
-    if (config.runDuration == 0 && config.stopDuration == 0) {
+    if (config.runDurationMs == 0 && config.stopDurationMs == 0) {
         corrections += "运行和停止时长都为0，已恢复为默认值; ";
-        config.runDuration = defaultConfig.runDuration;
-        config.stopDuration = defaultConfig.stopDuration;
+        config.runDurationMs = defaultConfig.runDurationMs;
+        config.stopDurationMs = defaultConfig.stopDurationMs;
         wasModified = true;
     }
     
     // 合理性检查：如果运行时长过短而停止时长过长，给出警告并调整
-    if (config.runDuration < 1 && config.stopDuration > 60) {
+    if (config.runDurationMs < MOTOR_MIN_RUN_DURATION_MS && config.stopDurationMs > 60000) {
         corrections += "运行时长过短而停止时长过长，已调整为合理比例; ";
-        config.runDuration = (config.runDuration > 1ul) ? config.runDuration : 1ul;
-        config.stopDuration = (config.stopDuration < 30ul) ? config.stopDuration : 30ul;
+        config.runDurationMs = MOTOR_MIN_RUN_DURATION_MS;
+        config.stopDurationMs = (config.stopDurationMs < 30000ul) ? config.stopDurationMs : 30000ul;
         wasModified = true;
     }
     
@@ -421,8 +547,8 @@ bool ConfigManager::validateAndSanitizeConfig(MotorConfig& config) const {
     if (wasModified) {
         const_cast<ConfigManager*>(this)->setValidationError(corrections.c_str());
         LOG_TAG_WARN("ConfigManager", "配置参数已自动修正: %s", corrections.c_str());
-        LOG_TAG_INFO("ConfigManager", "修正后配置 - 运行: %lu秒, 停止: %lu秒, 循环: %lu次, 自动启动: %s",
-                     config.runDuration, config.stopDuration, config.cycleCount,
+        LOG_TAG_INFO("ConfigManager", "修正后配置 - 运行: %lu ms, 停止: %lu ms, 循环: %lu次, 自动启动: %s",
+                     config.runDurationMs, config.stopDurationMs, config.cycleCount,
                      config.autoStart ? "是" : "否");
     } else {
         const_cast<ConfigManager*>(this)->setValidationError("");
@@ -5,6 +5,7 @@
 #include "../drivers/NVSStorageDriver.h"
 #include "../common/Logger.h"
 #include "../common/StateManager.h"
+#include "../common/MotorProgram.h"
 
 /**
  * 配置管理器类
@@ -49,6 +50,26 @@ public:
      */
     bool deleteStoredConfig();
     
+    /**
+     * 保存电机程序到NVS
+     * @param program 已编译的程序
+     * @return 保存是否成功
+     */
+    bool saveProgram(const MotorProgram& program);
+    
+    /**
+     * 从NVS加载电机程序
+     * @param program 用于存储读取结果的程序
+     * @return 程序存在且校验、编译成功
+     */
+    bool loadProgram(MotorProgram& program);
+    
+    /**
+     * 删除存储的电机程序
+     * @return 删除是否成功
+     */
+    bool deleteStoredProgram();
+    
     /**
      * 获取当前配置
      * @return 当前配置引用
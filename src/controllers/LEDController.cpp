@@ -1,6 +1,7 @@
 #include "LEDController.h"
 #include "../common/Logger.h"
 #include "../common/Config.h"
+#include "../common/WakeSignal.h"
 
 // 定义颜色常量
 const uint8_t LEDController::COLOR_BLUE[3] = {0, 0, 255};
@@ -210,6 +211,7 @@ void LEDController::blinkCallback() {
         // 达到最大闪烁次数，标记停止（在主循环中处理）
         isBlinking = false;
         ledOn = false;
+        WakeSignal::getInstance().notifyFromISR();
         return;
     }
     
@@ -217,8 +219,9 @@ void LEDController::blinkCallback() {
     ledOn = !ledOn;
     blinkCount++;
     
-    // 设置标志位，让主循环处理LED更新
+    // 设置标志位并唤醒主循环，由主循环处理LED更新
     // 这样避免在中断上下文中调用可能阻塞的函数
+    WakeSignal::getInstance().notifyFromISR();
 }
 
 void LEDController::clearLED() {
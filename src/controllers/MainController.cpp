@@ -1,10 +1,37 @@
 #include "MainController.h"
+#include "SerialConsole.h"
 #include "common/Logger.h"
 #include "../common/EventManager.h"
 #include "../common/PowerManager.h"
+#include "../common/WakeSignal.h"
 #include <Arduino.h>
 #include <cstring>
 
+// 调度器时钟
+static uint32_t schedulerClock() {
+    return micros();
+}
+
+// 串口收到数据时唤醒主循环，诊断命令不需要轮询
+static void enableSerialConsoleWake() {
+#if ARDUINO_USB_CDC_ON_BOOT && ARDUINO_USB_MODE
+    // Serial为USB串口/JTAG控制器（HWCDC），接收事件在事件循环任务中回调
+    Serial.onEvent(ARDUINO_HW_CDC_RX_EVENT, [](void*, esp_event_base_t, int32_t, void*) {
+        WakeSignal::getInstance().notify();
+    });
+#elif ARDUINO_USB_CDC_ON_BOOT
+    // Serial为USB OTG CDC
+    Serial.onEvent(ARDUINO_USB_CDC_RX_EVENT, [](void*, esp_event_base_t, int32_t, void*) {
+        WakeSignal::getInstance().notify();
+    });
+#else
+    // Serial为UART0，接收回调在UART事件任务中执行
+    Serial.onReceive([]() {
+        WakeSignal::getInstance().notify();
+    });
+#endif
+}
+
 // 单例实例
 MainController& MainController::getInstance() {
     static MainController instance;
@@ -13,7 +40,8 @@ MainController& MainController::getInstance() {
 
 // 构造函数
 MainController::MainController()
-    : running(false)
+    : scheduler(schedulerClock, SCHEDULER_OVERRUN_THRESHOLD_MICROS)
+    , running(false)
     , initialized(false)
     , motorControllerInitialized(false)
     , ledControllerInitialized(false)
@@ -51,6 +79,8 @@ bool MainController::init() {
     logConfig.bufferSize = LOG_BUFFER_SIZE;
     
     Logger::getInstance().begin(&Serial, LOG_DEFAULT_LEVEL, logConfig);
+    SerialConsole::getInstance().begin(Serial);
+    enableSerialConsoleWake();
     
     Logger::getInstance().info("MainController", "=== ESP32 电机控制系统启动 ===");
     Logger::getInstance().info("MainController", "固件版本: 1.0.0");
@@ -175,52 +205,29 @@ void MainController::run() {
     Logger::getInstance().info("MainController", "系统开始运行");
     
     // 发布系统启动事件
-    EventManager::getInstance().publish(EventData(EventType::SYSTEM_STARTUP, "MainController", "系统启动"));
+    EventManager::getInstance().publish(EventData(EventType::SYSTEM_STARTUP, EventSource::MAIN_CONTROLLER, "系统启动"));
     
-    while (running) {
-        // 处理事件队列
-        EventManager::getInstance().processEvents();
-        
-        // 更新BLE通信（如果可用）
-        if (bleServerInitialized) {
-            try {
-                MotorBLEServer::getInstance().update();
-            } catch (...) {
-                Logger::getInstance().error("MainController", "BLE更新异常，停用BLE服务");
-                bleServerInitialized = false;
-            }
-        }
-        
-        // 更新电机状态（如果可用）
-        if (motorControllerInitialized) {
-            try {
-                MotorController::getInstance().update();
-            } catch (...) {
-                Logger::getInstance().error("MainController", "电机控制器更新异常");
-                // 电机控制器异常是严重问题，进入安全模式
-                enterSafeMode();
-                break;
-            }
+    if (scheduler.getTaskCount() == 0) {
+        setupSchedulerTasks();
+    }
+    scheduler.wakeAll();
+    
+    // 按截止时间调度：执行到期的任务后休眠到最早的截止时间，异步事件、BLE写入和LED中断会提前唤醒
+    while (running && !criticalModulesFailed) {
+        uint32_t waitMicros = scheduler.runDue();
+        if (!running || criticalModulesFailed) {
+            break;
         }
-        
-        // 更新LED状态（如果可用）
-        if (ledControllerInitialized) {
-            try {
-                ledController.update();
-            } catch (...) {
-                Logger::getInstance().error("MainController", "LED控制器更新异常，停用LED");
-                ledControllerInitialized = false;
-            }
+        if (WakeSignal::getInstance().wait(waitMicros)) {
+            // 唤醒源不区分模块，所有任务都检查一次
+            scheduler.wakeAll();
         }
-        
-        // 简化的功耗管理 - 无需温度监控，BLE已直接配置为低功耗模式
-        
-        // 简单的延时，避免CPU占用过高
-        delay(10);
     }
     
+    logSchedulerStatistics();
+    
     // 发布系统关闭事件
-    EventManager::getInstance().publish(EventData(EventType::SYSTEM_SHUTDOWN, "MainController", "系统关闭"));
+    EventManager::getInstance().publish(EventData(EventType::SYSTEM_SHUTDOWN, EventSource::MAIN_CONTROLLER, "系统关闭"));
     
     Logger::getInstance().info("MainController", "系统主循环结束");
 }
@@ -229,6 +236,85 @@ void MainController::run() {
 void MainController::stop() {
     Logger::getInstance().info("MainController", "收到停止信号");
     running = false;
+    WakeSignal::getInstance().notify();
+}
+
+// 注册主循环任务，每个任务返回距下次需要执行的时间
+void MainController::setupSchedulerTasks() {
+    // 处理事件队列；分发的事件可能改变其他模块的状态，之后所有任务都检查一次
+    scheduler.addTask("events", [this](uint32_t) -> uint32_t {
+        EventManager& eventManager = EventManager::getInstance();
+        if (eventManager.processEvents() > 0) {
+            scheduler.wakeAll();
+        }
+        return eventManager.getQueueSize() > 0 ? 0 : DeadlineScheduler::NO_DEADLINE;
+    });
+    
+    // 更新BLE通信（如果可用）
+    scheduler.addTask("ble", [this](uint32_t) -> uint32_t {
+        if (!bleServerInitialized) {
+            return DeadlineScheduler::NO_DEADLINE;
+        }
+        try {
+            MotorBLEServer& bleServer = MotorBLEServer::getInstance();
+            bleServer.update();
+            return bleServer.getMicrosUntilNextUpdate();
+        } catch (...) {
+            Logger::getInstance().error("MainController", "BLE更新异常，停用BLE服务");
+            bleServerInitialized = false;
+        }
+        return DeadlineScheduler::NO_DEADLINE;
+    });
+    
+    // 更新电机状态（如果可用）
+    scheduler.addTask("motor", [this](uint32_t) -> uint32_t {
+        if (!motorControllerInitialized) {
+            return DeadlineScheduler::NO_DEADLINE;
+        }
+        try {
+            MotorController& motorController = MotorController::getInstance();
+            motorController.update();
+            return motorController.getMicrosUntilNextUpdate();
+        } catch (...) {
+            Logger::getInstance().error("MainController", "电机控制器更新异常");
+            // 电机控制器异常是严重问题，进入安全模式（主循环随后退出）
+            enterSafeMode();
+        }
+        return DeadlineScheduler::NO_DEADLINE;
+    });
+    
+    // 更新LED状态（如果可用），闪烁由定时器中断唤醒
+    scheduler.addTask("led", [this](uint32_t) -> uint32_t {
+        if (!ledControllerInitialized) {
+            return DeadlineScheduler::NO_DEADLINE;
+        }
+        try {
+            ledController.update();
+        } catch (...) {
+            Logger::getInstance().error("MainController", "LED控制器更新异常，停用LED");
+            ledControllerInitialized = false;
+        }
+        return DeadlineScheduler::NO_DEADLINE;
+    });
+    
+    // 串口诊断命令，由串口接收回调唤醒
+    scheduler.addTask("console", [](uint32_t) -> uint32_t {
+        SerialConsole::getInstance().update();
+        return DeadlineScheduler::NO_DEADLINE;
+    });
+}
+
+// 输出各任务的执行统计
+void MainController::logSchedulerStatistics() {
+    for (int8_t taskId = 0; taskId < DeadlineScheduler::MAX_TASKS; taskId++) {
+        DeadlineScheduler::TaskStatistics stats;
+        if (!scheduler.getStatistics(taskId, stats)) {
+            continue;
+        }
+        Logger::getInstance().info("MainController", "任务%s: 执行%lu次, 超期%lu次, 最大延迟%luus, 最长耗时%luus",
+                                  scheduler.getTaskName(taskId), stats.runs, stats.overruns,
+                                  stats.maxLatenessMicros, stats.maxRunMicros);
+    }
 }
 
 // 初始化配置管理器
@@ -254,8 +340,8 @@ bool MainController::initializeConfigManager() {
         
         // 打印当前使用的配置
         const MotorConfig& currentConfig = config.getConfig();
-        Logger::getInstance().info("MainController", "当前配置 - 运行: %lu秒, 停止: %lu秒, 循环: %lu次, 自动启动: %s",
-                                  currentConfig.runDuration, currentConfig.stopDuration,
+        Logger::getInstance().info("MainController", "当前配置 - 运行: %lu ms, 停止: %lu ms, 循环: %lu次, 自动启动: %s",
+                                  currentConfig.runDurationMs, currentConfig.stopDurationMs,
                                   currentConfig.cycleCount, currentConfig.autoStart ? "是" : "否");
         
         return true;
@@ -445,8 +531,8 @@ void MainController::setupEventListeners() {
 // 处理系统事件
 void MainController::handleSystemEvent(const EventData& event) {
     String logMsg = "系统事件: " + EventManager::getEventTypeName(event.type);
-    if (!event.message.isEmpty()) {
-        logMsg += " - " + event.message;
+    if (event.hasMessage()) {
+        logMsg += " - " + event.getMessage();
     }
     Logger::getInstance().info("MainController", logMsg);
     
@@ -471,8 +557,8 @@ void MainController::handleSystemEvent(const EventData& event) {
 // 处理电机事件
 void MainController::handleMotorEvent(const EventData& event) {
     String logMsg = "电机事件: " + EventManager::getEventTypeName(event.type);
-    if (!event.message.isEmpty()) {
-        logMsg += " - " + event.message;
+    if (event.hasMessage()) {
+        logMsg += " - " + event.getMessage();
     }
     if (event.value != 0) {
         logMsg += " (值: " + String(event.value) + ")";
@@ -484,12 +570,7 @@ void MainController::handleMotorEvent(const EventData& event) {
             if (ledControllerInitialized) {
                 ledController.setState(LEDState::MOTOR_RUNNING);
             }
-            // 通知BLE客户端电机状态变化
-            if (bleServerInitialized) {
-                MotorBLEServer::getInstance().sendStatusNotification(
-                    MotorBLEServer::getInstance().generateStatusJson()
-                );
-            }
+            // 电机状态变化由BLE任务取样后增量推送（事件发布已唤醒主循环）
             break;
             
         case EventType::MOTOR_STOP:
@@ -501,21 +582,10 @@ void MainController::handleMotorEvent(const EventData& event) {
                     ledController.setState(LEDState::MOTOR_STOPPED);
                 }
             }
-            // 通知BLE客户端电机状态变化
-            if (bleServerInitialized) {
-                MotorBLEServer::getInstance().sendStatusNotification(
-                    MotorBLEServer::getInstance().generateStatusJson()
-                );
-            }
             break;
             
         case EventType::MOTOR_SPEED_CHANGED:
-            // 通知BLE客户端电机参数变化
-            if (bleServerInitialized) {
-                MotorBLEServer::getInstance().sendStatusNotification(
-                    MotorBLEServer::getInstance().generateStatusJson()
-                );
-            }
+            // 参数变化同样由BLE任务增量推送
             break;
             
         default:
@@ -526,8 +596,8 @@ void MainController::handleMotorEvent(const EventData& event) {
 // 处理BLE事件
 void MainController::handleBLEEvent(const EventData& event) {
     String logMsg = "BLE事件: " + EventManager::getEventTypeName(event.type);
-    if (!event.message.isEmpty()) {
-        logMsg += " - " + event.message;
+    if (event.hasMessage()) {
+        logMsg += " - " + event.getMessage();
     }
     Logger::getInstance().info("MainController", logMsg);
     
@@ -542,13 +612,7 @@ void MainController::handleBLEEvent(const EventData& event) {
                 }
             }
             // === 5.3.3 实时状态推送机制 - BLE连接时立即推送状态 ===
-            if (bleServerInitialized) {
-                // BLE连接后立即推送当前状态
-                MotorBLEServer::getInstance().sendStatusNotification(
-                    MotorBLEServer::getInstance().generateStatusJson()
-                );
-                Logger::getInstance().info("MainController", "BLE连接后已推送初始状态");
-            }
+            // 连接回调已请求关键帧，BLE任务下一次运行时推送完整状态
             break;
             
         case EventType::BLE_DISCONNECTED:
@@ -570,8 +634,8 @@ void MainController::handleBLEEvent(const EventData& event) {
 // 处理配置事件
 void MainController::handleConfigEvent(const EventData& event) {
     String logMsg = "配置事件: " + EventManager::getEventTypeName(event.type);
-    if (!event.message.isEmpty()) {
-        logMsg += " - " + event.message;
+    if (event.hasMessage()) {
+        logMsg += " - " + event.getMessage();
     }
     Logger::getInstance().info("MainController", logMsg);
     
@@ -6,6 +6,7 @@
 #include "ConfigManager.h"
 #include "MotorBLEServer.h"
 #include "../common/EventManager.h"
+#include "../common/DeadlineScheduler.h"
 #include <functional>
 
 /**
@@ -69,6 +70,12 @@ public:
      * @return false 系统已停止
      */
     bool isRunning() const { return running; }
+    
+    /**
+     * @brief 获取主循环调度器（用于查看各任务的执行统计）
+     * @return DeadlineScheduler& 调度器引用
+     */
+    DeadlineScheduler& getScheduler() { return scheduler; }
 
 private:
     // 私有构造函数 - 单例模式
@@ -96,9 +103,16 @@ private:
     // 清理资源
     void cleanup();
     
+    // 主循环调度
+    void setupSchedulerTasks();
+    void logSchedulerStatistics();
+    
     // LED控制器实例（非单例）
     LEDController ledController;
     
+    // 主循环调度器：各模块按自己的下次截止时间执行，其余时间休眠
+    DeadlineScheduler scheduler;
+    
     // 系统状态
     bool running;
     bool initialized;
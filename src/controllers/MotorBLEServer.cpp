@@ -5,8 +5,25 @@
 #include "../common/Logger.h"
 #include "../common/EventManager.h"
 #include "../common/PowerManager.h"
+#include "../common/DeadlineScheduler.h"
+#include "../common/WakeSignal.h"
+#include "../common/MonotonicClock.h"
 #include <ArduinoJson.h>
 
+namespace {
+
+const uint32_t STATUS_COUNTDOWN_TOLERANCE_MS = 100;  // 计时字段与客户端推算值的允许误差（毫秒）
+const uint32_t STATUS_FREE_HEAP_DEADBAND = 1024;     // 空闲堆变化小于1KB不通知
+const uint32_t STATUS_TEMPERATURE_DEADBAND = 10;     // 芯片温度（0.1°C）变化小于1°C不通知
+const uint32_t STATUS_SAMPLE_LAG_MICROS = 1000;      // 电机状态机处理后再取样
+const uint16_t ATT_DEFAULT_MTU = 23;                 // 协商前的ATT MTU
+const uint16_t ATT_HEADER_SIZE = 3;                  // 通知/写请求的ATT头，单包负载为MTU-3
+
+// 最长的二进制电机程序也能一次（分块）写入和通知
+static_assert(MotorProgram::MAX_SERIALIZED_SIZE <= BLE_COMMAND_MAX_LENGTH, "电机程序超过BLE写入上限");
+
+} // namespace
+
 // 单例实例
 MotorBLEServer& MotorBLEServer::getInstance() {
     static MotorBLEServer instance;
@@ -14,11 +31,36 @@ MotorBLEServer& MotorBLEServer::getInstance() {
 }
 
 // 构造函数
-MotorBLEServer::MotorBLEServer() : stateManager(StateManager::getInstance()) {
+MotorBLEServer::MotorBLEServer()
+    : statusResyncPending(false)
+    , statusSequence(0)
+    , stateManager(StateManager::getInstance())
+    , speedControllerRefreshRequested(false)
+    , peerMTU(ATT_DEFAULT_MTU)
+    , gattsInterface(ESP_GATT_IF_NONE)
+    , chunkAssembler(chunkBuffer, sizeof(chunkBuffer)) {
     disconnectionHandled = false;
     lastConnectionTime = 0;
     disconnectionCount = 0;
     pMotorModbusController = new MotorModbusController();
+    
+    // 剩余时间和运行时长由客户端自行推算，只有相位切换、暂停等跳变才产生增量
+    statusModel.defineField(STATUS_STATE, StatusModel::FieldKind::VALUE);
+    statusModel.defineField(STATUS_REMAINING_RUN, StatusModel::FieldKind::COUNTDOWN, STATUS_COUNTDOWN_TOLERANCE_MS);
+    statusModel.defineField(STATUS_REMAINING_STOP, StatusModel::FieldKind::COUNTDOWN, STATUS_COUNTDOWN_TOLERANCE_MS);
+    statusModel.defineField(STATUS_CYCLE, StatusModel::FieldKind::VALUE);
+    statusModel.defineField(STATUS_RUN_DURATION, StatusModel::FieldKind::VALUE);
+    statusModel.defineField(STATUS_STOP_DURATION, StatusModel::FieldKind::VALUE);
+    statusModel.defineField(STATUS_CYCLE_LIMIT, StatusModel::FieldKind::VALUE);
+    statusModel.defineField(STATUS_AUTO_START, StatusModel::FieldKind::VALUE);
+    statusModel.defineField(STATUS_PWM_MODE, StatusModel::FieldKind::VALUE);
+    statusModel.defineField(STATUS_PWM_OUTPUT, StatusModel::FieldKind::VALUE);
+    statusModel.defineField(STATUS_UPTIME, StatusModel::FieldKind::COUNTUP, STATUS_COUNTDOWN_TOLERANCE_MS);
+    statusModel.defineField(STATUS_SYSTEM_STATE, StatusModel::FieldKind::VALUE);
+    statusModel.defineField(STATUS_FREE_HEAP, StatusModel::FieldKind::VALUE, STATUS_FREE_HEAP_DEADBAND);
+    statusModel.defineField(STATUS_CHIP_TEMPERATURE, StatusModel::FieldKind::VALUE, STATUS_TEMPERATURE_DEADBAND);
+    statusModel.setIntervals(BLE_STATUS_MIN_NOTIFY_INTERVAL_MS, BLE_STATUS_MAX_NOTIFY_INTERVAL_MS);
+    statusModel.setKeyframeInterval(BLE_STATUS_KEYFRAME_INTERVAL);
 }
 
 // 析构函数
@@ -37,9 +79,17 @@ bool MotorBLEServer::init() {
         // 初始化BLE设备
         BLEDevice::init(BLE_DEVICE_NAME);
         
+        // 支持更大的MTU：客户端协商后，调速器配置等较长的JSON一包即可传输
+        if (BLEDevice::setMTU(BLE_LOCAL_MTU) != ESP_OK) {
+            LOG_WARN("设置BLE MTU失败: %d", BLE_LOCAL_MTU);
+        }
+        
         // 直接配置BLE低功耗参数
         configureBLELowPowerDirect();
         
+        // 记录GATT接口，分块帧不经过特征值直接通知（须在创建服务器之前设置，以收到注册事件）
+        BLEDevice::setCustomGattsHandler(onGattsEvent);
+        
         // 创建BLE服务器
         pServer = BLEDevice::createServer();
         if (!pServer) {
@@ -101,20 +151,60 @@ bool MotorBLEServer::init() {
         );
         pSpeedControllerConfigCharacteristic->setCallbacks(new CharacteristicCallbacks(this, BLE_SPEED_CONTROLLER_CONFIG_CHAR_UUID));
         
+        // 创建诊断特征值（读取相位切换误差统计，写入"reset"清零）
+        pDiagnosticsCharacteristic = pService->createCharacteristic(
+            BLE_DIAGNOSTICS_CHAR_UUID,
+            BLECharacteristic::PROPERTY_READ |
+            BLECharacteristic::PROPERTY_WRITE
+        );
+        pDiagnosticsCharacteristic->setCallbacks(new CharacteristicCallbacks(this, BLE_DIAGNOSTICS_CHAR_UUID));
+        
+        // 创建电机程序特征值（写入二进制程序或启停命令，读取执行状态，"read"命令通知二进制程序）
+        pProgramCharacteristic = pService->createCharacteristic(
+            BLE_PROGRAM_CHAR_UUID,
+            BLECharacteristic::PROPERTY_READ |
+            BLECharacteristic::PROPERTY_WRITE |
+            BLECharacteristic::PROPERTY_NOTIFY
+        );
+        pProgramCharacteristic->setCallbacks(new CharacteristicCallbacks(this, BLE_PROGRAM_CHAR_UUID));
+        
+        // 创建二进制状态特征值（固定布局，一个默认MTU内，供App低开销轮询/订阅）
+        pStatusBinaryCharacteristic = pService->createCharacteristic(
+            BLE_STATUS_BINARY_CHAR_UUID,
+            BLECharacteristic::PROPERTY_READ |
+            BLECharacteristic::PROPERTY_NOTIFY
+        );
+        pStatusBinaryCharacteristic->setCallbacks(new CharacteristicCallbacks(this, BLE_STATUS_BINARY_CHAR_UUID));
+        
+        // 创建写入确认特征值（每次写入执行后通知编号和结果）
+        pCommandAckCharacteristic = pService->createCharacteristic(
+            BLE_COMMAND_ACK_CHAR_UUID,
+            BLECharacteristic::PROPERTY_READ |
+            BLECharacteristic::PROPERTY_NOTIFY
+        );
+        
         // 设置初始值 - 从ConfigManager获取实际配置值
         ConfigManager& configManager = ConfigManager::getInstance();
         MotorConfig config = configManager.getConfig();
         
-        pRunDurationCharacteristic->setValue(String(config.runDuration).c_str());
-        pStopIntervalCharacteristic->setValue(String(config.stopDuration).c_str());
+        pRunDurationCharacteristic->setValue(formatDurationSeconds(config.runDurationMs).c_str());
+        pStopIntervalCharacteristic->setValue(formatDurationSeconds(config.stopDurationMs).c_str());
         pSystemControlCharacteristic->setValue("1");  // 系统控制初始为启动状态
-        pStatusQueryCharacteristic->setValue(generateStatusJson().c_str());
+        char statusJson[STATUS_JSON_BUFFER_SIZE];
+        pStatusQueryCharacteristic->setValue((uint8_t*)statusJson, writeStatusJson(statusJson, sizeof(statusJson)));
         
         // 调速器配置特征初始为空JSON对象
         pSpeedControllerConfigCharacteristic->setValue("{}");
+        char diagnosticsJson[DIAGNOSTICS_JSON_BUFFER_SIZE];
+        setReadValue(pDiagnosticsCharacteristic, (const uint8_t*)diagnosticsJson,
+                     writeDiagnosticsJson(diagnosticsJson, sizeof(diagnosticsJson)));
+        char programJson[PROGRAM_JSON_BUFFER_SIZE];
+        pProgramCharacteristic->setValue((uint8_t*)programJson, writeProgramStatusJson(programJson, sizeof(programJson)));
+        uint8_t packet[StatusPacket::SIZE];
+        pStatusBinaryCharacteristic->setValue(packet, generateStatusPacket(packet, sizeof(packet)));
         
-        LOG_INFO("BLE特征值已初始化 - 运行时长: %lu秒, 停止间隔: %lu秒",
-                 config.runDuration, config.stopDuration);
+        LOG_INFO("BLE特征值已初始化 - 运行时长: %lu ms, 停止间隔: %lu ms",
+                 config.runDurationMs, config.stopDurationMs);
         
         // 注册系统状态变更监听器
         stateManager.registerStateListener([this](const StateChangeEvent& event) {
@@ -126,6 +216,10 @@ bool MotorBLEServer::init() {
             bool modbusInitSuccess = pMotorModbusController->begin(1); // 默认地址为1
             if (modbusInitSuccess) {
                 LOG_INFO("MotorModbusController初始化成功");
+                // 电机程序步骤的调速器设定值通过MODBUS下发
+                MotorController::getInstance().setProgramSetpointHandler([this](const ProgramSetpoint& setpoint) {
+                    this->applyProgramSetpoint(setpoint);
+                });
             } else {
                 LOG_WARN("MotorModbusController初始化失败: %s", pMotorModbusController->getLastError().c_str());
             }
@@ -177,24 +271,127 @@ void MotorBLEServer::stop() {
 
 // 更新BLE状态
 void MotorBLEServer::update() {
+    // 被拒绝的写入：队列已满或内容过长确认为忙，客户端稍后重试；内容无效时在主循环中记录错误并确认为失败
+    commandQueue.processRejected([this](const BleCommandRejection& rejection) {
+        if (rejection.reason == BleCommandRejection::Reason::INVALID) {
+            char error[64];
+            snprintf(error, sizeof(error), "分块写入失败: %s", rejection.detail ? rejection.detail : "");
+            setError(error);
+            sendCommandAck(rejection.id, rejection.target, BleCommandAck::Result::FAILED, 0);
+            return;
+        }
+        LOG_WARN("BLE写入被拒绝（队列已满或内容过长）: %s, %u字节", getWriteTargetName(rejection.target),
+                 (unsigned)rejection.length);
+        sendCommandAck(rejection.id, rejection.target, BleCommandAck::Result::BUSY, 0);
+    });
+    
+    // 执行写入回调入队的BLE写入（断开连接时也执行已收到的写入），先于MODBUS推进以便新提交的事务立即开始
+    // 处理函数接管确认时（调速器配置的MODBUS写入）在完成回调中通知结果
+    commandQueue.process([this](const BleCommand& command, uint32_t latencyMicros) {
+        executingAck.id = command.id;
+        executingAck.target = command.target;
+        executingAck.latencyMicros = latencyMicros;
+        executingCommand = true;
+        commandAckDeferred = false;
+        bool ok = executeCommand(command);
+        executingCommand = false;
+        if (!commandAckDeferred) {
+            sendCommandAck(command.id, command.target, ok ? BleCommandAck::Result::OK : BleCommandAck::Result::FAILED,
+                           latencyMicros);
+        }
+    });
+    
+    // 读取回调请求的调速器配置刷新在主循环中提交
+    if (speedControllerRefreshRequested.exchange(false)) {
+        requestSpeedControllerRefresh();
+    }
+    
+    // 推进MODBUS异步事务（断开连接时也要让已提交的事务完成）
+    if (pMotorModbusController) {
+        pMotorModbusController->update();
+    }
+    
     if (!isConnected()) {
+        clearPendingNotifications();
         return;
     }
     
-    // === 简化的低功耗状态推送机制 ===
-    static uint32_t lastStatusUpdate = 0;
-    static uint32_t statusUpdateInterval = 1000; // 固定1秒推送间隔
+    // 新连接（或重新连接）从关键帧开始
+    if (statusResyncPending.exchange(false)) {
+        statusModel.reset();
+        clearPendingNotifications();
+    }
+    sendPendingNotifications();
+    
+    // 变化驱动的状态推送：只在有变化（或心跳、关键帧到期）时发送
+    size_t length = pollStatusNotification(statusJsonBuffer, sizeof(statusJsonBuffer));
+    if (length > 0) {
+        sendStatusNotification(statusJsonBuffer, length);
+        sendStatusPacketNotification();
+    }
+}
+
+// 距下一次需要更新的时间
+uint32_t MotorBLEServer::getMicrosUntilNextUpdate() const {
+    // 待执行的BLE写入（超过单次执行上限的部分）和待确认的拒绝下一轮立即处理
+    if (commandQueue.hasPending() || commandQueue.hasRejected() || speedControllerRefreshRequested.load()) {
+        return 0;
+    }
+    
+    // 分块通知的剩余帧按批间隔发送
+    uint32_t pendingMicros = DeadlineScheduler::NO_DEADLINE;
+    if (hasPendingNotifications()) {
+        uint64_t nowMicros = MonotonicClock::nowMicros();
+        pendingMicros = nextNotifyBatchMicros > nowMicros ? (uint32_t)(nextNotifyBatchMicros - nowMicros) : 0;
+    }
     
+    // MODBUS事务需要按轮询间隔推进
+    if (pMotorModbusController && pMotorModbusController->hasPendingWork()) {
+        return pendingMicros < SCHEDULER_MODBUS_POLL_MICROS ? pendingMicros : SCHEDULER_MODBUS_POLL_MICROS;
+    }
     
-    uint32_t currentTime = millis();
+    // 设定值斜坡在两次写入之间不需要轮询
+    if (pMotorModbusController) {
+        uint32_t untilRamp = pMotorModbusController->getMicrosUntilRampUpdate();
+        if (untilRamp != SetpointRamp::NO_UPDATE && untilRamp < pendingMicros) {
+            pendingMicros = untilRamp;
+        }
+    }
+    
+    if (!isConnected()) {
+        return pendingMicros;
+    }
+    if (statusResyncPending.load()) {
+        return 0;
+    }
+    
+    // 已知的变化按通知节奏发送；事件和BLE写入会唤醒主循环重新取样
+    uint64_t nowMs = MonotonicClock::nowMillis();
+    uint64_t statusMicros = DeadlineScheduler::NO_DEADLINE;
+    uint32_t untilNotify = stateChangePending ? statusModel.getMsUntilAllowed(nowMs)
+                                              : statusModel.getMsUntilNextNotify(nowMs);
+    if (untilNotify != StatusModel::NO_NOTIFY) {
+        statusMicros = (uint64_t)untilNotify * 1000;
+    }
     
-    // 低功耗定时状态推送
-    if (currentTime - lastStatusUpdate >= statusUpdateInterval) {
-        String statusJson = generateStatusJson();
-        sendStatusNotification(statusJson);
-        lastStatusUpdate = currentTime;
+    // 电机状态机不发布事件的变化（持续运行的循环计数、PWM缓启动输出）在它处理之后取样，
+    // 但不早于最小通知间隔
+    uint32_t motorMicros = MotorController::getInstance().getMicrosUntilNextUpdate();
+    if (motorMicros != DeadlineScheduler::NO_DEADLINE) {
+        uint64_t sampleMicros = (uint64_t)motorMicros + STATUS_SAMPLE_LAG_MICROS;
+        uint64_t allowedMicros = (uint64_t)statusModel.getMsUntilAllowed(nowMs) * 1000;
+        if (sampleMicros < allowedMicros) {
+            sampleMicros = allowedMicros;
+        }
+        if (sampleMicros < statusMicros) {
+            statusMicros = sampleMicros;
+        }
     }
     
+    if (statusMicros != DeadlineScheduler::NO_DEADLINE && statusMicros > DeadlineScheduler::MAX_DELAY_MICROS) {
+        statusMicros = DeadlineScheduler::MAX_DELAY_MICROS;
+    }
+    return (uint32_t)statusMicros < pendingMicros ? (uint32_t)statusMicros : pendingMicros;
 }
 
 // 获取连接状态
@@ -204,9 +401,262 @@ bool MotorBLEServer::isConnected() const {
 
 // 发送状态通知
 void MotorBLEServer::sendStatusNotification(const String& status) {
+    sendStatusNotification(status.c_str(), status.length());
+}
+
+void MotorBLEServer::sendStatusNotification(const char* json, size_t length) {
     if (pStatusQueryCharacteristic && isConnected()) {
-        pStatusQueryCharacteristic->setValue(status.c_str());
-        pStatusQueryCharacteristic->notify();
+        notifyValue(pStatusQueryCharacteristic, (const uint8_t*)json, length);
+    }
+}
+
+// 下一次状态通知发送关键帧
+void MotorBLEServer::requestStatusKeyframe() {
+    statusResyncPending = true;
+    WakeSignal::getInstance().notify();
+}
+
+// 发送二进制状态通知
+void MotorBLEServer::sendStatusPacketNotification() {
+    if (pStatusBinaryCharacteristic && isConnected()) {
+        // 只有实际发送通知才推进序号，读取和刷新特征值不影响App发现丢失的通知
+        statusSequence.store((uint16_t)(statusSequence.load() + 1));
+        uint8_t packet[StatusPacket::SIZE];
+        pStatusBinaryCharacteristic->setValue(packet, generateStatusPacket(packet, sizeof(packet)));
+        pStatusBinaryCharacteristic->notify();
+    }
+}
+
+// 通知特征值；超过单包负载时复制后分块，分批发送。分块帧直接通知，特征值为完整内容供读取
+// （超过ESP_GATT_MAX_ATTR_LEN时不能存入特征值，见setReadValue()）；storeValue为false时特征值保持不变
+void MotorBLEServer::notifyValue(BLECharacteristic* characteristic, const uint8_t* data, size_t length, bool storeValue) {
+    PendingNotification* pending = nullptr;
+    PendingNotification* idle = nullptr;
+    for (PendingNotification& slot : pendingNotifications) {
+        if (slot.characteristic == characteristic) {
+            pending = &slot;
+        } else if (!slot.characteristic && !idle) {
+            idle = &slot;
+        }
+    }
+    
+    size_t maxPayload = (size_t)peerMTU.load() - ATT_HEADER_SIZE;
+    if (length <= maxPayload) {
+        // 新内容替换未发完的分块通知
+        if (pending) {
+            pending->characteristic = nullptr;
+        }
+        if (!storeValue) {
+            notifyFrame(characteristic, data, length);
+            return;
+        }
+        characteristic->setValue((uint8_t*)data, length);
+        characteristic->notify();
+        return;
+    }
+    
+    if (!pending) {
+        pending = idle;
+    }
+    if (pending && length <= sizeof(pending->message)) {
+        memcpy(pending->message, data, length);
+        pending->length = length;
+        pending->encoder = ChunkEncoder(pending->message, length, notifyTransferId++, maxPayload);
+    }
+    if (!pending || pending->length != length || !pending->encoder.isValid()) {
+        if (pending) {
+            pending->characteristic = nullptr;
+        }
+        LOG_WARN("通知无法分块发送 (%u字节)，将被截断", (unsigned)length);
+        if (storeValue) {
+            setReadValue(characteristic, data, length);
+        }
+        notifyFrame(characteristic, data, maxPayload);
+        return;
+    }
+    pending->characteristic = characteristic;
+    if (storeValue) {
+        setReadValue(characteristic, data, length);
+    }
+    sendPendingNotifications();
+}
+
+// 不经过特征值直接通知一帧（特征值保持不变）
+void MotorBLEServer::notifyFrame(BLECharacteristic* characteristic, const uint8_t* data, size_t length) {
+    esp_gatt_if_t gattsIf = gattsInterface.load();
+    if (!pServer || gattsIf == ESP_GATT_IF_NONE) {
+        LOG_WARN("GATT接口未知，分块通知未发送");
+        return;
+    }
+    esp_err_t result = esp_ble_gatts_send_indicate(gattsIf, pServer->getConnId(), characteristic->getHandle(),
+                                                   (uint16_t)length, (uint8_t*)data, false);
+    if (result != ESP_OK) {
+        LOG_WARN("分块通知发送失败: %d", result);
+    }
+}
+
+// 设置供读取的特征值：BLE库拒绝超过ESP_GATT_MAX_ATTR_LEN的值，此时特征值置空（不保留过期内容），
+// 完整内容只能通过（分块）通知获取
+void MotorBLEServer::setReadValue(BLECharacteristic* characteristic, const uint8_t* data, size_t length) {
+    if (length > ESP_GATT_MAX_ATTR_LEN) {
+        LOG_WARN("内容超过特征值上限 (%u > %u字节)，读取时为空", (unsigned)length, (unsigned)ESP_GATT_MAX_ATTR_LEN);
+        length = 0;
+    }
+    characteristic->setValue((uint8_t*)data, length);
+}
+
+// GATT事件（BLE任务）：记录服务端注册/连接时的GATT接口
+void MotorBLEServer::onGattsEvent(esp_gatts_cb_event_t event, esp_gatt_if_t gattsIf, esp_ble_gatts_cb_param_t*) {
+    if (event == ESP_GATTS_REG_EVT || event == ESP_GATTS_CONNECT_EVT) {
+        getInstance().gattsInterface = gattsIf;
+    }
+}
+
+// 发送一批分块通知：notify()不反馈协议栈拥塞，每批最多BLE_NOTIFY_FRAMES_PER_BATCH帧，
+// 剩余的帧间隔BLE_NOTIFY_BATCH_INTERVAL_MICROS后由update()继续发送
+void MotorBLEServer::sendPendingNotifications() {
+    uint64_t now = MonotonicClock::nowMicros();
+    if (now < nextNotifyBatchMicros) {
+        return;
+    }
+    
+    uint8_t frame[BLE_LOCAL_MTU];
+    uint32_t sent = 0;
+    for (PendingNotification& pending : pendingNotifications) {
+        if (!pending.characteristic) {
+            continue;
+        }
+        while (sent < BLE_NOTIFY_FRAMES_PER_BATCH && pending.encoder.hasNext()) {
+            notifyFrame(pending.characteristic, frame, pending.encoder.next(frame, sizeof(frame)));
+            sent++;
+        }
+        if (!pending.encoder.hasNext()) {
+            pending.characteristic = nullptr;
+        }
+    }
+    if (sent > 0) {
+        nextNotifyBatchMicros = now + BLE_NOTIFY_BATCH_INTERVAL_MICROS;
+    }
+}
+
+// 是否有未发完的分块通知
+bool MotorBLEServer::hasPendingNotifications() const {
+    for (const PendingNotification& pending : pendingNotifications) {
+        if (pending.characteristic) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 丢弃未发完的分块通知（断开连接，或新连接的MTU可能不同）
+void MotorBLEServer::clearPendingNotifications() {
+    for (PendingNotification& pending : pendingNotifications) {
+        pending.characteristic = nullptr;
+    }
+}
+
+// 接收分块写入的一帧，消息完整时返回true（内容见chunkAssembler；BLE任务调用）
+bool MotorBLEServer::acceptChunk(uint8_t target, const char* charUUID, const uint8_t* data, size_t length) {
+    // 一条消息的所有帧必须写入同一特征值
+    if (chunkAssembler.isActive() && charUUID != chunkCharUUID) {
+        LOG_WARN("分块写入被其他特征值打断，已丢弃未完成的消息");
+        chunkAssembler.reset();
+    }
+    chunkCharUUID = charUUID;
+    
+    ChunkAssembler::Result result = chunkAssembler.accept(data, length);
+    if (result == ChunkAssembler::Result::ERROR) {
+        // 错误信息由主循环记录（lastError只由主循环写入），写入确认为失败
+        uint16_t id = 0;
+        commandQueue.rejectInvalid(target, length, chunkAssembler.getLastError(), id);
+        WakeSignal::getInstance().notify();
+        return false;
+    }
+    return result == ChunkAssembler::Result::COMPLETE;
+}
+
+// 复制写入内容入队并唤醒主循环（BLE任务调用）
+void MotorBLEServer::enqueueWrite(uint8_t target, const uint8_t* data, size_t length) {
+    // 被拒绝的写入由队列记录，主循环确认为忙（确认特征值只由主循环访问）
+    uint16_t id = 0;
+    commandQueue.enqueue(target, data, length, id);
+    WakeSignal::getInstance().notify();
+}
+
+// 执行一条BLE写入（主循环调用）
+bool MotorBLEServer::executeCommand(const BleCommand& command) {
+    if (command.target == WRITE_PROGRAM) {
+        // 电机程序可能是二进制，只记录长度
+        LOG_INFO("执行BLE写入 #%u: %s (%u字节)", command.id, getWriteTargetName(command.target), command.length);
+    } else {
+        LOG_INFO("执行BLE写入 #%u: %s = %s", command.id, getWriteTargetName(command.target), command.data);
+    }
+    
+    // 写入内容在队列中以'\0'结尾，文本写入直接使用，不复制
+    switch (command.target) {
+        case WRITE_RUN_DURATION:
+            return handleRunDurationWrite(command.data);
+        case WRITE_STOP_INTERVAL:
+            return handleStopIntervalWrite(command.data);
+        case WRITE_SYSTEM_CONTROL:
+            return handleSystemControlWrite(command.data);
+        case WRITE_SPEED_CONTROLLER_CONFIG:
+            return handleSpeedControllerConfigWrite(command.data, command.length);
+        case WRITE_DIAGNOSTICS:
+            return handleDiagnosticsWrite(command.data);
+        case WRITE_PROGRAM:
+            return handleProgramWrite((const uint8_t*)command.data, command.length);
+        default:
+            return false;
+    }
+}
+
+// 通知写入结果
+void MotorBLEServer::sendCommandAck(uint16_t id, uint8_t target, BleCommandAck::Result result, uint32_t latencyMicros) {
+    if (!pCommandAckCharacteristic) {
+        return;
+    }
+    BleCommandAck ack;
+    ack.id = id;
+    ack.target = target;
+    ack.result = result;
+    ack.latencyMicros = latencyMicros;
+    uint8_t packet[BleCommandAck::SIZE];
+    size_t length = BleCommandAck::encode(ack, packet, sizeof(packet));
+    pCommandAckCharacteristic->setValue(packet, length);
+    if (isConnected()) {
+        pCommandAckCharacteristic->notify();
+    }
+}
+
+// 可写特征值的UUID转换为写入目标，不可写时返回-1
+int MotorBLEServer::getWriteTarget(const char* charUUID) {
+    if (strcmp(charUUID, BLE_RUN_DURATION_CHAR_UUID) == 0) {
+        return WRITE_RUN_DURATION;
+    } else if (strcmp(charUUID, BLE_STOP_INTERVAL_CHAR_UUID) == 0) {
+        return WRITE_STOP_INTERVAL;
+    } else if (strcmp(charUUID, BLE_SYSTEM_CONTROL_CHAR_UUID) == 0) {
+        return WRITE_SYSTEM_CONTROL;
+    } else if (strcmp(charUUID, BLE_SPEED_CONTROLLER_CONFIG_CHAR_UUID) == 0) {
+        return WRITE_SPEED_CONTROLLER_CONFIG;
+    } else if (strcmp(charUUID, BLE_DIAGNOSTICS_CHAR_UUID) == 0) {
+        return WRITE_DIAGNOSTICS;
+    } else if (strcmp(charUUID, BLE_PROGRAM_CHAR_UUID) == 0) {
+        return WRITE_PROGRAM;
+    }
+    return -1;
+}
+
+const char* MotorBLEServer::getWriteTargetName(uint8_t target) {
+    switch (target) {
+        case WRITE_RUN_DURATION: return "runDuration";
+        case WRITE_STOP_INTERVAL: return "stopInterval";
+        case WRITE_SYSTEM_CONTROL: return "systemControl";
+        case WRITE_SPEED_CONTROLLER_CONFIG: return "speedControllerConfig";
+        case WRITE_DIAGNOSTICS: return "diagnostics";
+        case WRITE_PROGRAM: return "program";
+        default: return "unknown";
     }
 }
 
@@ -216,12 +666,15 @@ void MotorBLEServer::ServerCallbacks::onConnect(BLEServer* pServer) {
     bleServer->deviceConnected = true;
     bleServer->lastConnectionTime = millis();
     bleServer->disconnectionHandled = false;
+    bleServer->peerMTU = ATT_DEFAULT_MTU;
+    bleServer->chunkAssembler.reset();
+    bleServer->requestStatusKeyframe();
     LOG_INFO("BLE客户端已连接");
     
     // === 5.3.3 实时状态推送机制 - 发布BLE连接事件 ===
     EventManager::getInstance().publish(EventData(
         EventType::BLE_CONNECTED,
-        "MotorBLEServer",
+        EventSource::BLE_SERVER,
         "BLE客户端连接成功"
     ));
 }
@@ -237,7 +690,7 @@ void MotorBLEServer::ServerCallbacks::onDisconnect(BLEServer* pServer) {
     // === 5.3.3 实时状态推送机制 - 发布BLE断开事件 ===
     EventManager::getInstance().publish(EventData(
         EventType::BLE_DISCONNECTED,
-        "MotorBLEServer",
+        EventSource::BLE_SERVER,
         "BLE客户端连接断开"
     ));
     
@@ -245,36 +698,43 @@ void MotorBLEServer::ServerCallbacks::onDisconnect(BLEServer* pServer) {
     BLEDevice::startAdvertising();
 }
 
+// MTU协商完成（由客户端发起）
+void MotorBLEServer::ServerCallbacks::onMtuChanged(BLEServer*, esp_ble_gatts_cb_param_t* param) {
+    bleServer->peerMTU = param->mtu.mtu;
+    LOG_INFO("BLE MTU已协商: %u (单包负载%u字节)", param->mtu.mtu, param->mtu.mtu - ATT_HEADER_SIZE);
+}
+
 // 特征值读写回调
 void MotorBLEServer::CharacteristicCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
-    std::string value = pCharacteristic->getValue();
-    if (value.length() == 0) {
+    int target = getWriteTarget(charUUID);
+    const uint8_t* data = pCharacteristic->getData();
+    size_t length = pCharacteristic->getLength();
+    if (target < 0 || length == 0) {
         return;
     }
     
-    String strValue = String(value.c_str());
-    LOG_INFO("收到BLE写入: %s = %s", charUUID, strValue.c_str());
-    
-    if (strcmp(charUUID, BLE_RUN_DURATION_CHAR_UUID) == 0) {
-        bleServer->handleRunDurationWrite(strValue);
-    } else if (strcmp(charUUID, BLE_STOP_INTERVAL_CHAR_UUID) == 0) {
-        bleServer->handleStopIntervalWrite(strValue);
-    } else if (strcmp(charUUID, BLE_SYSTEM_CONTROL_CHAR_UUID) == 0) {
-        bleServer->handleSystemControlWrite(strValue);
-    } else if (strcmp(charUUID, BLE_SPEED_CONTROLLER_CONFIG_CHAR_UUID) == 0) {
-        bleServer->handleSpeedControllerConfigWrite(strValue);
+    // 分块写入：收齐全部帧并通过CRC校验后按完整消息处理
+    if (ChunkFrame::isFrame(data, length)) {
+        if (!bleServer->acceptChunk((uint8_t)target, charUUID, data, length)) {
+            return;
+        }
+        data = bleServer->chunkAssembler.getData();
+        length = bleServer->chunkAssembler.getLength();
     }
+    
+    // 回调中只复制写入内容，保存NVS、MODBUS事务等由主循环执行，不阻塞BLE协议栈
+    bleServer->enqueueWrite((uint8_t)target, data, length);
 }
 
 void MotorBLEServer::CharacteristicCallbacks::onRead(BLECharacteristic* pCharacteristic) {
     if (strcmp(charUUID, BLE_RUN_DURATION_CHAR_UUID) == 0) {
         ConfigManager& configManager = ConfigManager::getInstance();
         MotorConfig config = configManager.getConfig();
-        pCharacteristic->setValue(String(config.runDuration).c_str());
+        pCharacteristic->setValue(formatDurationSeconds(config.runDurationMs).c_str());
     } else if (strcmp(charUUID, BLE_STOP_INTERVAL_CHAR_UUID) == 0) {
         ConfigManager& configManager = ConfigManager::getInstance();
         MotorConfig config = configManager.getConfig();
-        pCharacteristic->setValue(String(config.stopDuration).c_str());
+        pCharacteristic->setValue(formatDurationSeconds(config.stopDurationMs).c_str());
     } else if (strcmp(charUUID, BLE_SYSTEM_CONTROL_CHAR_UUID) == 0) {
         // 系统控制开关状态，应该反映电机的实际运行状态
         MotorController& motorController = MotorController::getInstance();
@@ -290,27 +750,40 @@ void MotorBLEServer::CharacteristicCallbacks::onRead(BLECharacteristic* pCharact
             pCharacteristic->setValue("0");
         }
     } else if (strcmp(charUUID, BLE_STATUS_QUERY_CHAR_UUID) == 0) {
-        String statusJson = bleServer->generateStatusJson();
-        pCharacteristic->setValue(statusJson.c_str());
+        char statusJson[STATUS_JSON_BUFFER_SIZE];
+        bleServer->setReadValue(pCharacteristic, (const uint8_t*)statusJson,
+                                bleServer->writeStatusJson(statusJson, sizeof(statusJson)));
     } else if (strcmp(charUUID, BLE_SPEED_CONTROLLER_CONFIG_CHAR_UUID) == 0) {
         // 返回当前的调速器配置
-        String configJson = bleServer->generateSpeedControllerConfigJson();
-        pCharacteristic->setValue(configJson.c_str());
+        char configJson[SPEED_CONTROLLER_JSON_BUFFER_SIZE];
+        bleServer->setReadValue(pCharacteristic, (const uint8_t*)configJson,
+                                bleServer->writeSpeedControllerConfigJson(configJson, sizeof(configJson)));
+    } else if (strcmp(charUUID, BLE_DIAGNOSTICS_CHAR_UUID) == 0) {
+        char diagnosticsJson[DIAGNOSTICS_JSON_BUFFER_SIZE];
+        bleServer->setReadValue(pCharacteristic, (const uint8_t*)diagnosticsJson,
+                                bleServer->writeDiagnosticsJson(diagnosticsJson, sizeof(diagnosticsJson)));
+    } else if (strcmp(charUUID, BLE_PROGRAM_CHAR_UUID) == 0) {
+        char programJson[PROGRAM_JSON_BUFFER_SIZE];
+        bleServer->setReadValue(pCharacteristic, (const uint8_t*)programJson,
+                                bleServer->writeProgramStatusJson(programJson, sizeof(programJson)));
+    } else if (strcmp(charUUID, BLE_STATUS_BINARY_CHAR_UUID) == 0) {
+        uint8_t packet[StatusPacket::SIZE];
+        pCharacteristic->setValue(packet, bleServer->generateStatusPacket(packet, sizeof(packet)));
     }
 }
 
 // 处理运行时长写入
-void MotorBLEServer::handleRunDurationWrite(const String& value) {
+bool MotorBLEServer::handleRunDurationWrite(const char* value) {
     try {
-        uint32_t runDuration = atoi(value.c_str());
-        if (runDuration < 1 || runDuration > 999) {
-            LOG_ERROR("运行时长超出范围: %u (有效范围: 1-999秒)", runDuration);
-            return;
+        uint32_t runDurationMs = 0;
+        if (!parseDurationMs(value, runDurationMs) || runDurationMs < MOTOR_MIN_RUN_DURATION_MS) {
+            LOG_ERROR("运行时长无效: %s (有效范围: 0.01-604800秒)", value);
+            return false;
         }
         
         ConfigManager& configManager = ConfigManager::getInstance();
         MotorConfig currentConfig = configManager.getConfig();
-        currentConfig.runDuration = runDuration;  // 直接使用秒为单位
+        currentConfig.runDurationMs = runDurationMs;
         
         configManager.updateConfig(currentConfig);
         configManager.saveConfig();
@@ -319,34 +792,32 @@ void MotorBLEServer::handleRunDurationWrite(const String& value) {
         MotorController& motorController = MotorController::getInstance();
         motorController.updateConfig(currentConfig);
         
-        LOG_INFO("运行时长已更新: %u 秒", runDuration);
+        LOG_INFO("运行时长已更新: %lu ms", runDurationMs);
         
         // 更新BLE特征值
         if (pRunDurationCharacteristic) {
-            pRunDurationCharacteristic->setValue(String(runDuration).c_str());
+            pRunDurationCharacteristic->setValue(formatDurationSeconds(runDurationMs).c_str());
         }
         
-        // 立即推送更新后的状态
-        if (this->isConnected()) {
-            String statusJson = this->generateStatusJson();
-            this->sendStatusNotification(statusJson);
-        }
+        // 状态变化由同一次update()增量推送
+        return true;
     } catch (const std::exception& e) {
         LOG_ERROR("处理运行时长写入异常: %s", e.what());
+        return false;
     }
 }
 // 处理停止间隔写入
-void MotorBLEServer::handleStopIntervalWrite(const String& value) {
+bool MotorBLEServer::handleStopIntervalWrite(const char* value) {
     try {
-        uint32_t stopInterval = atoi(value.c_str());
-        if (stopInterval > 999) {
-            LOG_ERROR("停止间隔超出范围: %u (有效范围: 0-999秒)", stopInterval);
-            return;
+        uint32_t stopIntervalMs = 0;
+        if (!parseDurationMs(value, stopIntervalMs)) {
+            LOG_ERROR("停止间隔无效: %s (有效范围: 0-604800秒)", value);
+            return false;
         }
         
         ConfigManager& configManager = ConfigManager::getInstance();
         MotorConfig currentConfig = configManager.getConfig();
-        currentConfig.stopDuration = stopInterval;  // 直接使用秒为单位
+        currentConfig.stopDurationMs = stopIntervalMs;
         
         configManager.updateConfig(currentConfig);
         configManager.saveConfig();
@@ -355,35 +826,89 @@ void MotorBLEServer::handleStopIntervalWrite(const String& value) {
         MotorController& motorController = MotorController::getInstance();
         motorController.updateConfig(currentConfig);
         
-        LOG_INFO("停止间隔已更新: %u 秒", stopInterval);
+        LOG_INFO("停止间隔已更新: %lu ms", stopIntervalMs);
         
         // 更新BLE特征值
         if (pStopIntervalCharacteristic) {
-            pStopIntervalCharacteristic->setValue(String(stopInterval).c_str());
+            pStopIntervalCharacteristic->setValue(formatDurationSeconds(stopIntervalMs).c_str());
         }
         
-        // 立即推送更新后的状态
-        if (this->isConnected()) {
-            String statusJson = this->generateStatusJson();
-            this->sendStatusNotification(statusJson);
-        }
+        // 状态变化由同一次update()增量推送
+        return true;
     } catch (const std::exception& e) {
         LOG_ERROR("处理停止间隔写入异常: %s", e.what());
+        return false;
+    }
+}
+
+// 解析以秒为单位的时长，小数部分精确到毫秒
+bool MotorBLEServer::parseDurationMs(const char* text, uint32_t& durationMs) {
+    while (*text == ' ') {
+        text++;
+    }
+    uint64_t ms = 0;
+    uint32_t scale = 1000;
+    bool hasDigits = false;
+    bool inFraction = false;
+    for (; *text != '\0'; text++) {
+        char c = *text;
+        if (c >= '0' && c <= '9') {
+            if (inFraction) {
+                if (scale == 1) {
+                    return false;  // 超过3位小数
+                }
+                scale /= 10;
+                ms += (uint64_t)(c - '0') * scale;
+            } else {
+                ms = ms * 10 + (uint64_t)(c - '0') * 1000;
+                if (ms > MOTOR_MAX_DURATION_MS) {
+                    return false;
+                }
+            }
+            hasDigits = true;
+        } else if (c == '.' && !inFraction) {
+            inFraction = true;
+        } else if (c == ' ' || c == '\r' || c == '\n') {
+            break;
+        } else {
+            return false;
+        }
+    }
+    if (!hasDigits || ms > MOTOR_MAX_DURATION_MS) {
+        return false;
     }
+    durationMs = (uint32_t)ms;
+    return true;
+}
+
+// 格式化为秒，整秒不带小数
+String MotorBLEServer::formatDurationSeconds(uint32_t durationMs) {
+    char buffer[16];
+    uint32_t fraction = durationMs % 1000;
+    if (fraction == 0) {
+        snprintf(buffer, sizeof(buffer), "%lu", (unsigned long)(durationMs / 1000));
+        return String(buffer);
+    }
+    int length = snprintf(buffer, sizeof(buffer), "%lu.%03lu", (unsigned long)(durationMs / 1000), (unsigned long)fraction);
+    while (length > 0 && buffer[length - 1] == '0') {
+        buffer[--length] = '\0';
+    }
+    return String(buffer);
 }
 // 处理系统控制写入
-void MotorBLEServer::handleSystemControlWrite(const String& value) {
+bool MotorBLEServer::handleSystemControlWrite(const char* value) {
     try {
-        uint8_t control = atoi(value.c_str());
+        uint8_t control = atoi(value);
         LOG_INFO("收到系统控制命令: %u (0=停止, 1=启动)", control);
         
         if (control > 1) {
             LOG_ERROR("系统控制值无效: %u (有效值: 0=停止, 1=启动)", control);
-            return;
+            return false;
         }
         
         MotorController& motorController = MotorController::getInstance();
         ConfigManager& configManager = ConfigManager::getInstance();
+        bool success;
         
         if (control == 1) {
             // 启动命令 - 重新启用自动启动并启动电机
@@ -413,7 +938,7 @@ void MotorBLEServer::handleSystemControlWrite(const String& value) {
                 LOG_INFO("ℹ️  自动启动功能已启用，无需修改");
             }
             
-            bool success = motorController.startMotor();
+            success = motorController.startMotor();
             if (success) {
                 LOG_INFO("✅ 系统控制: 启动命令执行成功");
             } else {
@@ -434,7 +959,7 @@ void MotorBLEServer::handleSystemControlWrite(const String& value) {
                 // 注意：不保存到NVS，这样重启后仍然是原来的设置
             }
             
-            bool success = motorController.stopMotor();
+            success = motorController.stopMotor();
             if (success) {
                 LOG_INFO("✅ 系统控制: 停止命令执行成功，电机已停止");
                 LOG_INFO("ℹ️  电机将保持停止状态，直到收到启动命令");
@@ -464,169 +989,692 @@ void MotorBLEServer::handleSystemControlWrite(const String& value) {
             }
         }
         
-        // 立即推送更新后的状态
-        if (this->isConnected()) {
-            String statusJson = this->generateStatusJson();
-            this->sendStatusNotification(statusJson);
-            LOG_INFO("📡 状态已推送给BLE客户端");
-        }
+        // 状态变化由同一次update()增量推送
+        return success;
     } catch (const std::exception& e) {
         LOG_ERROR("处理系统控制写入异常: %s", e.what());
+        return false;
     }
 }
-// 生成状态JSON
+// 生成状态JSON（完整状态，供读取）
 String MotorBLEServer::generateStatusJson() {
-    MotorController& motorController = MotorController::getInstance();
+    char buffer[STATUS_JSON_BUFFER_SIZE];
+    size_t length = writeStatusJson(buffer, sizeof(buffer));
+    return length > 0 ? String(buffer) : String();
+}
+
+// 写入完整状态JSON
+size_t MotorBLEServer::writeStatusJson(char* buffer, size_t size) {
+    int64_t values[STATUS_FIELD_COUNT];
+    sampleStatus(values);
+    sampleSystemInfo(values);
     
-    DynamicJsonDocument doc(512);
+    JsonWriter writer(buffer, size);
+    writer.beginObject();
+    writeStatusFields(writer, values, statusModel.getAllFieldsMask());
+    writer.endObject();
+    return writer.finish();
+}
+
+// 取样状态字段（只读取控制器和配置中已有的值，不访问总线）
+void MotorBLEServer::sampleStatus(int64_t* values) {
+    MotorController& motorController = MotorController::getInstance();
+    MotorConfig config = ConfigManager::getInstance().getConfig();
+    const MotorPWMController* pwm = motorController.getPWMController();
     
-    // 电机状态
-    MotorControllerState state = motorController.getCurrentState();
-    doc["state"] = static_cast<int>(state);
+    values[STATUS_STATE] = static_cast<int>(motorController.getCurrentState());
+    values[STATUS_REMAINING_RUN] = motorController.getRemainingRunTimeMs();
+    values[STATUS_REMAINING_STOP] = motorController.getRemainingStopTimeMs();
+    values[STATUS_CYCLE] = motorController.getCurrentCycleCount();
+    values[STATUS_RUN_DURATION] = config.runDurationMs;
+    values[STATUS_STOP_DURATION] = config.stopDurationMs;
+    values[STATUS_CYCLE_LIMIT] = config.cycleCount;
+    values[STATUS_AUTO_START] = config.autoStart ? 1 : 0;
+    values[STATUS_PWM_MODE] = pwm ? 1 : 0;
+    values[STATUS_PWM_OUTPUT] = pwm ? pwm->getOutputPermille() : 0;
+    values[STATUS_UPTIME] = (int64_t)MonotonicClock::nowMillis();
+    values[STATUS_SYSTEM_STATE] = static_cast<int>(stateManager.getCurrentState());
+}
+
+// 取样系统信息（温度读取较慢，只在发送通知时取样）
+void MotorBLEServer::sampleSystemInfo(int64_t* values) {
+    values[STATUS_FREE_HEAP] = ESP.getFreeHeap();
     
-    // 状态名称映射
-    const char* stateNames[] = {"STOPPED", "RUNNING", "STOPPING", "STARTING", "ERROR"};
-    int stateIndex = static_cast<int>(state);
-    if (stateIndex >= 0 && stateIndex < 5) {
-        doc["stateName"] = stateNames[stateIndex];
-    } else {
-        doc["stateName"] = "UNKNOWN";
+    // 芯片温度信息（ESP32内置温度传感器），单位0.1°C
+    #ifdef ESP32
+    float temperature = temperatureRead();  // ESP32内置温度读取函数
+    #else
+    float temperature = 0.0f;  // 非ESP32平台默认值
+    #endif
+    values[STATUS_CHIP_TEMPERATURE] = (int64_t)(temperature * 10.0f + (temperature >= 0 ? 0.5f : -0.5f));
+}
+
+// 按字段掩码写入状态JSON成员（字段名与完整状态JSON一致）
+void MotorBLEServer::writeStatusFields(JsonWriter& writer, const int64_t* values, uint32_t mask) {
+    if (mask & (1u << STATUS_STATE)) {
+        writer.addInt("state", values[STATUS_STATE]);
+        
+        // 状态名称映射
+        const char* stateNames[] = {"STOPPED", "RUNNING", "STOPPING", "STARTING", "ERROR"};
+        int stateIndex = (int)values[STATUS_STATE];
+        writer.addString("stateName", (stateIndex >= 0 && stateIndex < 5) ? stateNames[stateIndex] : "UNKNOWN");
     }
     
-    // 时间信息
-    doc["remainingRunTime"] = motorController.getRemainingRunTime();
-    doc["remainingStopTime"] = motorController.getRemainingStopTime();
-    doc["currentCycleCount"] = motorController.getCurrentCycleCount();
+    // 时间信息（整秒字段兼容旧客户端）
+    if (mask & (1u << STATUS_REMAINING_RUN)) {
+        writer.addInt("remainingRunTime", values[STATUS_REMAINING_RUN] / 1000);
+        writer.addInt("remainingRunTimeMs", values[STATUS_REMAINING_RUN]);
+    }
+    if (mask & (1u << STATUS_REMAINING_STOP)) {
+        writer.addInt("remainingStopTime", values[STATUS_REMAINING_STOP] / 1000);
+        writer.addInt("remainingStopTimeMs", values[STATUS_REMAINING_STOP]);
+    }
+    if (mask & (1u << STATUS_CYCLE)) {
+        writer.addInt("currentCycleCount", values[STATUS_CYCLE]);
+    }
     
     // 配置信息
-    // 配置信息
-    ConfigManager& configManager = ConfigManager::getInstance();
-    MotorConfig config = configManager.getConfig();
-    doc["runDuration"] = config.runDuration;  // 直接使用秒
-    doc["stopDuration"] = config.stopDuration;  // 直接使用秒
-    doc["cycleCount"] = config.cycleCount;
-    doc["autoStart"] = config.autoStart;
+    if (mask & (1u << STATUS_RUN_DURATION)) {
+        writer.addInt("runDuration", values[STATUS_RUN_DURATION] / 1000);
+        writer.addInt("runDurationMs", values[STATUS_RUN_DURATION]);
+    }
+    if (mask & (1u << STATUS_STOP_DURATION)) {
+        writer.addInt("stopDuration", values[STATUS_STOP_DURATION] / 1000);
+        writer.addInt("stopDurationMs", values[STATUS_STOP_DURATION]);
+    }
+    if (mask & (1u << STATUS_CYCLE_LIMIT)) {
+        writer.addInt("cycleCount", values[STATUS_CYCLE_LIMIT]);
+    }
+    if (mask & (1u << STATUS_AUTO_START)) {
+        writer.addBool("autoStart", values[STATUS_AUTO_START] != 0);
+    }
+    
+    // 输出方式；PWM输出时附带当前输出（0.1%，缓启动/缓停止期间变化）
+    if (mask & (1u << STATUS_PWM_MODE)) {
+        writer.addString("outputMode", values[STATUS_PWM_MODE] ? "pwm" : "switch");
+    }
+    if ((mask & ((1u << STATUS_PWM_MODE) | (1u << STATUS_PWM_OUTPUT))) && values[STATUS_PWM_MODE]) {
+        writer.addInt("pwmOutput", values[STATUS_PWM_OUTPUT]);
+    }
+    
     // 系统信息
-    doc["uptime"] = millis();
-    doc["freeHeap"] = ESP.getFreeHeap();
+    if (mask & (1u << STATUS_UPTIME)) {
+        writer.addInt("uptime", values[STATUS_UPTIME]);
+    }
+    if (mask & (1u << STATUS_SYSTEM_STATE)) {
+        writer.addString("systemState",
+                         StateManager::getStateNameCStr(static_cast<SystemState>(values[STATUS_SYSTEM_STATE])));
+    }
+    if (mask & (1u << STATUS_FREE_HEAP)) {
+        writer.addInt("freeHeap", values[STATUS_FREE_HEAP]);
+    }
+    if (mask & (1u << STATUS_CHIP_TEMPERATURE)) {
+        writer.addFixed("chipTemperature", values[STATUS_CHIP_TEMPERATURE], 1);
+    }
+}
+
+// 写入增量/关键帧状态通知
+size_t MotorBLEServer::writeStatusNotification(char* buffer, size_t size, StatusModel::Notify kind,
+                                               const int64_t* values, uint32_t mask, bool withStateChange) {
+    JsonWriter writer(buffer, size);
+    writer.beginObject();
+    writer.addString("type", kind == StatusModel::Notify::KEYFRAME ? "keyframe" : "delta");
+    writer.addUInt("seq", statusModel.getSequence());
+    writeStatusFields(writer, values, mask);
     
-    // 芯片温度信息（ESP32内置温度传感器）
-    #ifdef ESP32
-    doc["chipTemperature"] = temperatureRead();  // ESP32内置温度读取函数
-    #else
-    doc["chipTemperature"] = 0.0;  // 非ESP32平台默认值
-    #endif
+    // === 5.3.3 实时状态推送机制 - 附带系统状态变更详情 ===
+    if (withStateChange) {
+        const char* from = StateManager::getStateNameCStr(lastStateChange.oldState);
+        const char* to = StateManager::getStateNameCStr(lastStateChange.newState);
+        writer.addString("systemStateReason", lastStateChange.reason.c_str());
+        writer.addUInt("systemStateTimestamp", lastStateChange.timestamp);
+        writer.addString("eventType", "system_state_change");
+        writer.addUInt("eventTime", millis());
+        
+        writer.beginObject("stateChange");
+        writer.addString("from", from);
+        writer.addString("to", to);
+        writer.addString("reason", lastStateChange.reason.c_str());
+        writer.endObject();
+    }
+    
+    writer.endObject();
+    return writer.finish();
+}
+
+// 取样状态字段，按StatusModel判断是否需要通知并生成增量/关键帧
+size_t MotorBLEServer::pollStatusNotification(char* buffer, size_t size) {
+    uint64_t nowMs = MonotonicClock::nowMillis();
+    int64_t values[STATUS_FIELD_COUNT];
+    sampleStatus(values);
+    for (uint8_t i = 0; i < STATUS_FREE_HEAP; i++) {
+        statusModel.set(i, values[i], nowMs);
+    }
+    
+    // 系统状态变更信息需要随systemState一起发送，即使状态已经变回原值
+    if (stateChangePending) {
+        statusModel.markDirty(STATUS_SYSTEM_STATE);
+    }
+    
+    StatusModel::Notify kind = statusModel.poll(nowMs);
+    if (kind == StatusModel::Notify::NONE) {
+        return 0;
+    }
+    
+    // 系统信息随其他变化、心跳或关键帧一起发送
+    sampleSystemInfo(values);
+    statusModel.set(STATUS_FREE_HEAP, values[STATUS_FREE_HEAP], nowMs);
+    statusModel.set(STATUS_CHIP_TEMPERATURE, values[STATUS_CHIP_TEMPERATURE], nowMs);
+    if (stateChangePending) {
+        statusModel.markDirty(STATUS_SYSTEM_STATE);
+    }
     
-    String jsonStr;
-    serializeJson(doc, jsonStr);
-    return jsonStr;
+    uint32_t mask = kind == StatusModel::Notify::KEYFRAME ? statusModel.getAllFieldsMask() : statusModel.getDirtyMask();
+    size_t length = writeStatusNotification(buffer, size, kind, values, mask, stateChangePending);
+    if (length == 0 && stateChangePending) {
+        // 变更原因过长：只发送状态字段
+        LOG_WARN("系统状态变更详情超出通知缓冲区，已省略");
+        length = writeStatusNotification(buffer, size, kind, values, mask, false);
+    }
+    stateChangePending = false;
+    if (length == 0) {
+        LOG_ERROR("状态通知超出缓冲区 (%u字节)", (unsigned)size);
+        return 0;
+    }
+    
+    statusModel.markSent(kind, nowMs);
+    return length;
+}
+
+// 生成二进制状态包（不构造JSON，不访问总线）
+size_t MotorBLEServer::generateStatusPacket(uint8_t* buffer, size_t size) {
+    MotorController& motorController = MotorController::getInstance();
+    MotorConfig config = ConfigManager::getInstance().getConfig();
+    
+    StatusPacket packet = {};
+    packet.sequence = statusSequence.load();
+    MotorControllerState state = motorController.getCurrentState();
+    packet.state = static_cast<uint8_t>(state);
+    packet.remainingMs = motorController.isRunning() ? motorController.getRemainingRunTimeMs()
+                                                     : motorController.getRemainingStopTimeMs();
+    packet.cycleCount = motorController.getCurrentCycleCount();
+    
+    if (motorController.isRunning()) {
+        packet.flags |= StatusPacket::FLAG_RUNNING;
+    }
+    if (config.autoStart) {
+        packet.flags |= StatusPacket::FLAG_AUTO_START;
+    }
+    if (motorController.isProgramRunning()) {
+        packet.flags |= StatusPacket::FLAG_PROGRAM;
+    }
+    
+    // 频率/占空比：PWM输出取本机输出，否则取最近一次读取的调速器配置
+    const MotorPWMController* pwm = motorController.getPWMController();
+    SpeedControllerCache cache = getSpeedControllerCache();
+    if (pwm) {
+        packet.flags |= StatusPacket::FLAG_PWM_OUTPUT | StatusPacket::FLAG_OUTPUT_VALID;
+        packet.frequency = pwm->getFrequency();
+        packet.dutyPermille = pwm->getOutputPermille();
+    } else if (cache.valid) {
+        packet.flags |= StatusPacket::FLAG_OUTPUT_VALID;
+        packet.frequency = cache.config.frequency;
+        packet.dutyPermille = cache.config.dutyCycle * 10;
+    }
+    
+    if (state == MotorControllerState::ERROR_STATE) {
+        packet.errors |= StatusPacket::ERROR_MOTOR;
+    }
+    if (!cache.lastReadOk && cache.errorCount > 0) {
+        packet.errors |= StatusPacket::ERROR_SPEED_CONTROLLER;
+    }
+    if (config.outputMode == MotorOutputMode::PWM && !pwm) {
+        packet.errors |= StatusPacket::ERROR_OUTPUT_MODE;
+    }
+    
+    return StatusPacketCodec::encode(packet, buffer, size);
 }
 
 // 生成调速器配置JSON
 String MotorBLEServer::generateSpeedControllerConfigJson() {
-    DynamicJsonDocument doc(1024);
+    char buffer[SPEED_CONTROLLER_JSON_BUFFER_SIZE];
+    size_t length = writeSpeedControllerConfigJson(buffer, sizeof(buffer));
+    return length > 0 ? String(buffer) : String();
+}
+
+// 写入调速器配置JSON
+size_t MotorBLEServer::writeSpeedControllerConfigJson(char* buffer, size_t size) {
+    // PWM输出方式下调速由本机完成，返回PWM参数
+    if (MotorController::getInstance().getPWMController()) {
+        return writePWMOutputJson(buffer, size);
+    }
     
-    try {
-        if (!pMotorModbusController) {
-            LOG_WARN("MotorModbusController未初始化");
-            // 返回未初始化状态
-            doc["isRunning"] = false;
-            doc["frequency"] = 0;
-            doc["dutyCycle"] = 0;
-            doc["externalSwitch"] = false;
-            doc["analogControl"] = false;
-            doc["powerOnState"] = false;
-            doc["minOutput"] = 0;
-            doc["maxOutput"] = 100;
-            doc["softStartTime"] = 0;
-            doc["softStopTime"] = 0;
+    JsonWriter writer(buffer, size);
+    writer.beginObject();
+    
+    if (!pMotorModbusController) {
+        LOG_WARN("MotorModbusController未初始化");
+        // 返回未初始化状态
+        writer.addBool("isRunning", false);
+        writer.addUInt("frequency", 0);
+        writer.addUInt("dutyCycle", 0);
+        writer.addBool("externalSwitch", false);
+        writer.addBool("analogControl", false);
+        writer.addBool("powerOnState", false);
+        writer.addUInt("minOutput", 0);
+        writer.addUInt("maxOutput", 100);
+        writer.addUInt("softStartTime", 0);
+        writer.addUInt("softStopTime", 0);
+        
+        writer.beginObject("communication");
+        writer.addUInt("lastUpdateTime", 0);
+        writer.addString("connectionStatus", "not_initialized");
+        writer.addUInt("errorCount", 0);
+        writer.addUInt("responseTime", 0);
+        writer.endObject();
+    } else {
+        // 读取不在BLE回调中等待总线：返回缓存，同时请求主循环提交异步刷新，完成后通过通知推送新值
+        speedControllerRefreshRequested = true;
+        WakeSignal::getInstance().notify();
+        writeSpeedControllerConfigFields(writer);
+    }
+    
+    writer.endObject();
+    return writer.finish();
+}
+
+// 提交调速器配置异步刷新（只在主循环中调用，已有刷新在进行时不重复提交）
+void MotorBLEServer::requestSpeedControllerRefresh() {
+    if (!pMotorModbusController || speedControllerRefreshPending) {
+        return;
+    }
+    
+    // 寄存器缓存仍新鲜时直接使用，不占用总线
+    MotorModbusController::AllConfig cachedConfig;
+    if (pMotorModbusController->getCachedAllConfig(cachedConfig)) {
+        SpeedControllerCache cache = getSpeedControllerCache();
+        cache.config = cachedConfig;
+        cache.valid = true;
+        setSpeedControllerCache(cache);
+        return;
+    }
+    
+    speedControllerRefreshPending = pMotorModbusController->requestAllConfig(
+        [this](bool success, const MotorModbusController::AllConfig& config, uint32_t responseTimeMs) {
+            speedControllerRefreshPending = false;
             
-            JsonObject communication = doc.createNestedObject("communication");
-            communication["lastUpdateTime"] = 0;
-            communication["connectionStatus"] = "not_initialized";
-            communication["errorCount"] = 0;
-            communication["responseTime"] = 0;
+            SpeedControllerCache cache = getSpeedControllerCache();
+            cache.lastReadOk = success;
+            if (success) {
+                cache.config = config;
+                cache.valid = true;
+                cache.configTime = millis();
+                cache.responseTime = responseTimeMs;
+                cache.errorCount = 0;
+            } else {
+                cache.errorCount++;
+                LOG_WARN("读取调速器配置失败 (连续%lu次)", cache.errorCount);
+            }
+            setSpeedControllerCache(cache);
             
-            String jsonStr;
-            serializeJson(doc, jsonStr);
-            return jsonStr;
-        }
-        
-        // 一次性获取所有配置和状态信息
-        MotorModbusController::AllConfig allConfig;
-        bool getAllSuccess = pMotorModbusController->getAllConfig(allConfig);
-        
-        // 填充JSON数据
-        doc["isRunning"] = getAllSuccess ? allConfig.isRunning : false;
-        doc["frequency"] = getAllSuccess ? allConfig.frequency : 0;
-        doc["dutyCycle"] = getAllSuccess ? allConfig.dutyCycle : 0;
-        doc["externalSwitch"] = getAllSuccess ? allConfig.externalSwitch : false;
-        doc["analogControl"] = getAllSuccess ? allConfig.analogControl : false;
-        doc["powerOnState"] = getAllSuccess ? allConfig.powerOnState : false;
-        doc["minOutput"] = getAllSuccess ? allConfig.minOutput : 0;
-        doc["maxOutput"] = getAllSuccess ? allConfig.maxOutput : 100;
-        doc["softStartTime"] = getAllSuccess ? allConfig.softStartTime : 0;
-        doc["softStopTime"] = getAllSuccess ? allConfig.softStopTime : 0;
-        
-        // 通信状态信息
-        JsonObject communication = doc.createNestedObject("communication");
-        communication["lastUpdateTime"] = millis();
-        
-        if (getAllSuccess) {
-            communication["connectionStatus"] = "connected";
-            communication["errorCount"] = 0;
-            communication["responseTime"] = 15; // 模拟响应时间
-        } else {
-            communication["connectionStatus"] = "disconnected";
-            communication["errorCount"] = 2;
-            communication["responseTime"] = 0;
-        }
-        
-        String jsonStr;
-        serializeJson(doc, jsonStr);
-        return jsonStr;
+            // 推送最新值
+            if (pSpeedControllerConfigCharacteristic && isConnected()) {
+                char buffer[SPEED_CONTROLLER_JSON_BUFFER_SIZE];
+                JsonWriter writer(buffer, sizeof(buffer));
+                writer.beginObject();
+                writeSpeedControllerConfigFields(writer);
+                writer.endObject();
+                notifyValue(pSpeedControllerConfigCharacteristic, (const uint8_t*)buffer, writer.finish());
+            }
+        });
+}
+
+// 复制调速器配置缓存（读取回调和主循环都可调用，临界区内只复制定长结构）
+MotorBLEServer::SpeedControllerCache MotorBLEServer::getSpeedControllerCache() {
+    portENTER_CRITICAL_SAFE(&speedControllerCacheMux);
+    SpeedControllerCache cache = speedControllerCache;
+    portEXIT_CRITICAL_SAFE(&speedControllerCacheMux);
+    return cache;
+}
+
+// 更新调速器配置缓存（只在主循环中调用）
+void MotorBLEServer::setSpeedControllerCache(const SpeedControllerCache& cache) {
+    portENTER_CRITICAL_SAFE(&speedControllerCacheMux);
+    speedControllerCache = cache;
+    portEXIT_CRITICAL_SAFE(&speedControllerCacheMux);
+}
+
+// 用缓存的调速器配置写入JSON成员
+void MotorBLEServer::writeSpeedControllerConfigFields(JsonWriter& writer) {
+    SpeedControllerCache cache = getSpeedControllerCache();
+    const MotorModbusController::AllConfig& config = cache.config;
+    bool valid = cache.valid;
+    
+    MotorModbusController::AllConfig defaults = {};
+    defaults.maxOutput = 100;
+    
+    writer.addBool("isRunning", valid ? config.isRunning : false);
+    writeConfigRegisterFields(writer, valid ? config : defaults);
+    
+    // 通信状态信息
+    writer.beginObject("communication");
+    writer.addUInt("lastUpdateTime", cache.configTime);
+    
+    if (cache.lastReadOk) {
+        writer.addString("connectionStatus", "connected");
+    } else if (cache.errorCount > 0) {
+        writer.addString("connectionStatus", "disconnected");
+    } else {
+        writer.addString("connectionStatus", "pending");
+    }
+    writer.addUInt("errorCount", cache.errorCount);
+    writer.addUInt("responseTime", cache.responseTime);
+    
+    if (pMotorModbusController) {
+        const ModbusRegisterCache::Statistics& cacheStats = pMotorModbusController->getCacheStatistics();
+        writer.addUInt("cacheHits", cacheStats.hits);
+        writer.addUInt("cacheMisses", cacheStats.misses);
+        writer.addUInt("registersSaved", cacheStats.registersRequested > cacheStats.registersRead
+            ? cacheStats.registersRequested - cacheStats.registersRead : 0);
+    }
+    writer.endObject();
+}
+
+// 写入调速器配置寄存器对应的JSON成员（不含运行状态）
+void MotorBLEServer::writeConfigRegisterFields(JsonWriter& writer, const MotorModbusController::AllConfig& config) {
+    writer.addUInt("frequency", config.frequency);
+    writer.addUInt("dutyCycle", config.dutyCycle);
+    writer.addBool("externalSwitch", config.externalSwitch);
+    writer.addBool("analogControl", config.analogControl);
+    writer.addBool("powerOnState", config.powerOnState);
+    writer.addUInt("minOutput", config.minOutput);
+    writer.addUInt("maxOutput", config.maxOutput);
+    writer.addUInt("softStartTime", config.softStartTime);
+    writer.addUInt("softStopTime", config.softStopTime);
+}
+
+// 生成信息JSON
+String MotorBLEServer::generateInfoJson() {
+    char buffer[INFO_JSON_BUFFER_SIZE];
+    size_t length = writeInfoJson(buffer, sizeof(buffer));
+    return length > 0 ? String(buffer) : String();
+}
+
+// 写入信息JSON
+size_t MotorBLEServer::writeInfoJson(char* buffer, size_t size) {
+    JsonWriter writer(buffer, size);
+    writer.beginObject();
+    writer.addString("deviceName", BLE_DEVICE_NAME);
+    writer.addString("serviceUUID", BLE_SERVICE_UUID);
+    writer.addString("firmwareVersion", "1.0.0");
+    writer.addString("hardware", "ESP32-S3-Zero");
+    writer.addString("features", "Motor Control, LED Status, BLE Communication");
+    writer.endObject();
+    return writer.finish();
+}
+
+// 处理诊断写入
+bool MotorBLEServer::handleDiagnosticsWrite(const char* value) {
+    if (strcmp(value, "reset") != 0) {
+        LOG_ERROR("无效的诊断命令: %s (有效命令: reset)", value);
+        return false;
+    }
+    
+    MotorController::getInstance().resetPhaseJitterStatistics();
+    commandQueue.resetStatistics();
+    LOG_INFO("相位切换误差和BLE写入统计已重置");
+    
+    if (pDiagnosticsCharacteristic) {
+        char diagnosticsJson[DIAGNOSTICS_JSON_BUFFER_SIZE];
+        setReadValue(pDiagnosticsCharacteristic, (const uint8_t*)diagnosticsJson,
+                     writeDiagnosticsJson(diagnosticsJson, sizeof(diagnosticsJson)));
+    }
+    return true;
+}
+
+// 写入诊断JSON（运行/停止阶段的相位切换误差，单位微秒）
+size_t MotorBLEServer::writeDiagnosticsJson(char* buffer, size_t size) {
+    MotorController& motorController = MotorController::getInstance();
+    JsonWriter writer(buffer, size);
+    writer.beginObject();
+    
+    writer.beginObject("phaseTiming");
+    writer.beginArray("bucketLimits");
+    for (uint8_t bucket = 0; bucket < PhaseJitterStatistics::BUCKET_COUNT - 1; bucket++) {
+        writer.addUInt(nullptr, MotorController::getPhaseJitterBucketLimit(bucket));
+    }
+    writer.endArray();
+    
+    const MotorPhase phases[] = {MotorPhase::RUN, MotorPhase::STOP};
+    const char* names[] = {"run", "stop"};
+    for (uint8_t i = 0; i < 2; i++) {
+        const PhaseJitterStatistics& stats = motorController.getPhaseJitterStatistics(phases[i]);
+        PhaseJitterSummary summary = MotorController::summarizePhaseJitter(stats);
         
-    } catch (const std::exception& e) {
-        LOG_ERROR("生成调速器状态JSON异常: %s", e.what());
+        writer.beginObject(names[i]);
+        writer.addUInt("count", summary.count);
+        writer.addUInt("timerEdges", stats.timerEdges);
+        writer.addUInt("min", summary.minMicros);
+        writer.addUInt("max", summary.maxMicros);
+        writer.addUInt("mean", summary.meanMicros);
+        writer.addUInt("p99", summary.p99Micros);
+        writer.beginArray("histogram");
+        for (uint8_t bucket = 0; bucket < PhaseJitterStatistics::BUCKET_COUNT; bucket++) {
+            writer.addUInt(nullptr, stats.buckets[bucket]);
+        }
+        writer.endArray();
+        writer.endObject();
+    }
+    writer.endObject();
+    
+    // BLE写入队列（延迟为从收到写入到主循环开始执行的时间，单位微秒）
+    BleCommandQueue::Statistics commandStats = commandQueue.getStatistics();
+    writer.beginObject("bleCommands");
+    writer.addUInt("received", commandStats.received);
+    writer.addUInt("processed", commandStats.processed);
+    writer.addUInt("rejected", commandStats.rejected);
+    writer.addUInt("highWatermark", commandStats.highWatermark);
+    writer.addUInt("maxLatency", commandStats.maxLatencyMicros);
+    writer.endObject();
+    
+    writer.endObject();
+    return writer.finish();
+}
+
+// 处理电机程序写入
+// 程序为MotorProgram::serialize()格式（"MP"开头，最长MotorProgram::MAX_SERIALIZED_SIZE字节，超过单包负载时分块写入），
+// 检查后保存到NVS并加载；{"action":"start"}/{"action":"stop"}启停程序，{"action":"read"}以同样格式通知当前程序
+bool MotorBLEServer::handleProgramWrite(const uint8_t* data, size_t length) {
+    MotorController& motorController = MotorController::getInstance();
+    bool ok = true;
+    
+    if (length >= 2 && data[0] == 'M' && data[1] == 'P') {
+        // 程序表较大，不放在栈上
+        std::unique_ptr<MotorProgram> program(new MotorProgram());
+        if (!program->deserialize(data, length)) {
+            LOG_ERROR("电机程序无效: %s", program->getLastError());
+            return false;
+        }
         
-        // 异常情况下返回错误状态
-        doc.clear();
-        doc["isRunning"] = false;
-        doc["frequency"] = 0;
-        doc["dutyCycle"] = 0;
-        doc["externalSwitch"] = false;
-        doc["analogControl"] = false;
-        doc["powerOnState"] = false;
-        doc["minOutput"] = 0;
-        doc["maxOutput"] = 100;
-        doc["softStartTime"] = 0;
-        doc["softStopTime"] = 0;
+        ConfigManager& configManager = ConfigManager::getInstance();
+        if (!configManager.saveProgram(*program)) {
+            LOG_ERROR("电机程序保存失败: %s", configManager.getLastError());
+            ok = false;
+        }
+        motorController.loadProgram(*program);
+        LOG_INFO("电机程序已更新: %u条指令, %u字节", program->getInstructionCount(), (unsigned)length);
+    } else {
+        StaticJsonDocument<64> doc;
+        DeserializationError error = deserializeJson(doc, (const char*)data, length);
+        if (error) {
+            LOG_ERROR("解析电机程序命令失败: %s", error.c_str());
+            return false;
+        }
         
-        JsonObject communication = doc.createNestedObject("communication");
-        communication["lastUpdateTime"] = millis();
-        communication["connectionStatus"] = "error";
-        communication["errorCount"] = 1;
-        communication["responseTime"] = 0;
+        const char* action = doc["action"] | "";
+        if (strcmp(action, "start") == 0) {
+            if (!motorController.startProgram()) {
+                LOG_ERROR("电机程序启动失败: %s", motorController.getLastError());
+                ok = false;
+            }
+        } else if (strcmp(action, "stop") == 0) {
+            motorController.stopProgram();
+        } else if (strcmp(action, "read") == 0) {
+            uint8_t program[MotorProgram::MAX_SERIALIZED_SIZE];
+            size_t programLength = motorController.getProgram().serialize(program, sizeof(program));
+            if (programLength == 0) {
+                LOG_ERROR("没有已加载的电机程序");
+                ok = false;
+            } else if (pProgramCharacteristic && isConnected()) {
+                // 读取时仍返回执行状态，程序只通过通知发送
+                notifyValue(pProgramCharacteristic, program, programLength, false);
+            }
+        } else {
+            LOG_ERROR("无效的电机程序命令: %s (有效命令: start, stop, read)", action);
+            ok = false;
+        }
+    }
+    
+    if (pProgramCharacteristic) {
+        char status[PROGRAM_JSON_BUFFER_SIZE];
+        setReadValue(pProgramCharacteristic, (const uint8_t*)status, writeProgramStatusJson(status, sizeof(status)));
+    }
+    return ok;
+}
+
+// 写入电机程序执行状态JSON
+size_t MotorBLEServer::writeProgramStatusJson(char* buffer, size_t size) {
+    MotorController& motorController = MotorController::getInstance();
+    const MotorProgram& program = motorController.getProgram();
+    const MotorProgramRunner& runner = motorController.getProgramRunner();
+    
+    JsonWriter writer(buffer, size);
+    writer.beginObject();
+    writer.addBool("loaded", program.isCompiled());
+    writer.addBool("running", motorController.isProgramRunning());
+    if (motorController.isProgramRunning()) {
+        writer.addUInt("index", runner.getCurrentIndex());
+        writer.addUInt("stepsExecuted", runner.getStepsExecuted());
+        writer.addUInt("stepRemainingMs", runner.getMsUntilNextStep(MonotonicClock::nowMillis()));
+    }
+    
+    if (program.isCompiled()) {
+        uint64_t totalMs = program.getTotalDurationMs();
+        if (totalMs == MotorProgram::INFINITE_DURATION) {
+            writer.addInt("totalMs", -1);  // 无限循环
+        } else {
+            writer.addUInt("totalMs", totalMs);
+        }
+        writer.addUInt("instructions", program.getInstructionCount());
         
-        String jsonStr;
-        serializeJson(doc, jsonStr);
-        return jsonStr;
+        // 二进制程序的长度，"read"命令按此长度通知（超过单包负载时分块）
+        writer.addUInt("size", program.getSerializedSize());
     }
+    writer.endObject();
+    return writer.finish();
 }
 
-// 生成信息JSON
-String MotorBLEServer::generateInfoJson() {
-    DynamicJsonDocument doc(256);
+// 通过MODBUS下发程序步骤的调速器设定值（异步，不等待总线）
+// 带缓变时间的步骤由本机斜坡在该时间内逐步写入频率/占空比；调速器的缓启动/缓停止时间不变，
+// 否则调速器会在每个斜坡设定值上再缓变一次，变化时间最多延长到两倍。
+// 只有缓变时间的步骤没有可斜坡的设定值，与PWM输出方式一致设置为调速器的缓启动/缓停止时间
+void MotorBLEServer::applyProgramSetpoint(const ProgramSetpoint& setpoint) {
+    if (!pMotorModbusController) {
+        return;
+    }
     
-    doc["deviceName"] = BLE_DEVICE_NAME;
-    doc["serviceUUID"] = BLE_SERVICE_UUID;
-    doc["firmwareVersion"] = "1.0.0";
-    doc["hardware"] = "ESP32-S3-Zero";
-    doc["features"] = "Motor Control, LED Status, BLE Communication";
+    bool submitted = true;
+    bool setFrequency = (setpoint.mask & ProgramSetpoint::FREQUENCY) != 0;
+    bool setDuty = (setpoint.mask & ProgramSetpoint::DUTY) != 0;
+    if (setpoint.mask & ProgramSetpoint::RAMP) {
+        uint32_t rampMs = (uint32_t)setpoint.rampTime * 100;
+        if (setFrequency && setDuty) {
+            submitted = pMotorModbusController->rampOutput(setpoint.frequency, setpoint.dutyCycle, rampMs) && submitted;
+        } else if (setFrequency) {
+            submitted = pMotorModbusController->rampFrequency(setpoint.frequency, rampMs) && submitted;
+        } else if (setDuty) {
+            submitted = pMotorModbusController->rampDutyCycle(setpoint.dutyCycle, rampMs) && submitted;
+        } else {
+            submitted = pMotorModbusController->requestSoftTimes(setpoint.rampTime, setpoint.rampTime) && submitted;
+        }
+    } else if (setFrequency && setDuty) {
+        submitted = pMotorModbusController->requestOutput(setpoint.frequency, setpoint.dutyCycle) && submitted;
+    } else if (setFrequency) {
+        submitted = pMotorModbusController->requestFrequency(setpoint.frequency) && submitted;
+    } else if (setDuty) {
+        submitted = pMotorModbusController->requestDutyCycle(setpoint.dutyCycle) && submitted;
+    }
     
-    String jsonStr;
-    serializeJson(doc, jsonStr);
-    return jsonStr;
+    if (!submitted) {
+        LOG_ERROR("程序设定值提交失败: MODBUS事务队列已满");
+    }
+}
+
+// 写入PWM输出参数JSON成员
+void MotorBLEServer::writePWMOutputFields(JsonWriter& writer) {
+    const MotorPWMController* pwm = MotorController::getInstance().getPWMController();
+    writer.addString("outputMode", "pwm");
+    if (!pwm) {
+        return;
+    }
+    writer.addBool("isRunning", pwm->isRunning());
+    writer.addUInt("frequency", pwm->getFrequency());
+    writer.addUInt("dutyCycle", pwm->getDutyCycle());
+    writer.addUInt("softStartTime", pwm->getSoftStartMs() / 100);
+    writer.addUInt("softStopTime", pwm->getSoftStopMs() / 100);
+    writer.addUInt("output", pwm->getOutputPermille());
+}
+
+size_t MotorBLEServer::writePWMOutputJson(char* buffer, size_t size) {
+    JsonWriter writer(buffer, size);
+    writer.beginObject();
+    writePWMOutputFields(writer);
+    writer.endObject();
+    return writer.finish();
+}
+
+// 应用调速器配置中的输出方式和PWM参数，保存到NVS
+bool MotorBLEServer::applyPWMOutputConfig(const JsonDocument& doc) {
+    ConfigManager& configManager = ConfigManager::getInstance();
+    MotorConfig config = configManager.getConfig();
+    
+    if (doc.containsKey("outputMode")) {
+        const char* mode = doc["outputMode"] | "";
+        if (strcmp(mode, "pwm") == 0) {
+            config.outputMode = MotorOutputMode::PWM;
+        } else if (strcmp(mode, "switch") == 0) {
+            config.outputMode = MotorOutputMode::SWITCH;
+        } else {
+            LOG_ERROR("输出方式无效: %s (有效值: switch, pwm)", mode);
+            return false;
+        }
+    }
+    // 切换回开关输出时其余字段属于MODBUS调速器
+    if (config.outputMode == MotorOutputMode::PWM) {
+        if (doc.containsKey("frequency")) {
+            config.pwmFrequency = doc["frequency"];
+        }
+        if (doc.containsKey("dutyCycle")) {
+            config.pwmDutyCycle = doc["dutyCycle"];
+        }
+        if (doc.containsKey("softStartTime")) {
+            config.softStartMs = (uint32_t)doc["softStartTime"] * 100;
+        }
+        if (doc.containsKey("softStopTime")) {
+            config.softStopMs = (uint32_t)doc["softStopTime"] * 100;
+        }
+    }
+    if (!configManager.validateConfig(config)) {
+        LOG_ERROR("PWM参数无效: %s", configManager.getValidationError());
+        return false;
+    }
+    
+    configManager.updateConfig(config);
+    configManager.saveConfig();
+    MotorController::getInstance().updateConfig(config);
+    LOG_INFO("PWM输出参数已更新 - 方式: %s, 频率: %lu Hz, 占空比: %u%%",
+             config.outputMode == MotorOutputMode::PWM ? "PWM" : "开关", config.pwmFrequency, config.pwmDutyCycle);
+    return true;
 }
 
 // 设置错误信息
@@ -656,34 +1704,13 @@ void MotorBLEServer::onSystemStateChanged(const StateChangeEvent& event) {
              StateManager::getStateName(event.newState).c_str());
     
     // === 5.3.3 实时状态推送机制 - 事件驱动推送 ===
-    // 如果有客户端连接，立即发送状态更新
-    if (isConnected()) {
-        // 生成包含系统状态变更信息的完整状态JSON
-        DynamicJsonDocument doc(1024);
-        
-        // 首先获取基础状态信息
-        String baseStatusJson = generateStatusJson();
-        deserializeJson(doc, baseStatusJson);
-        
-        // 添加系统状态变更信息
-        doc["systemState"] = StateManager::getStateName(event.newState);
-        doc["systemStateReason"] = event.reason;
-        doc["systemStateTimestamp"] = event.timestamp;
-        doc["eventType"] = "system_state_change";
-        doc["eventTime"] = millis();
-        
-        // 添加状态变更详情
-        JsonObject stateChange = doc.createNestedObject("stateChange");
-        stateChange["from"] = StateManager::getStateName(event.oldState);
-        stateChange["to"] = StateManager::getStateName(event.newState);
-        stateChange["reason"] = event.reason;
-        
-        String updatedJson;
-        serializeJson(doc, updatedJson);
-        sendStatusNotification(updatedJson);
-        
-        LOG_INFO("系统状态变更已实时推送给BLE客户端");
+    // 变更详情随下一次状态通知（不早于最小通知间隔）发送给已连接的客户端
+    if (!isConnected()) {
+        return;
     }
+    lastStateChange = event;
+    stateChangePending = true;
+    WakeSignal::getInstance().notify();
 }
 
 // === 5.4.3 BLE断连时的系统稳定运行机制 ===
@@ -799,23 +1826,41 @@ void MotorBLEServer::resetConnectionState() {
 }
 
 // 处理调速器配置写入
-void MotorBLEServer::handleSpeedControllerConfigWrite(const String& value) {
+bool MotorBLEServer::handleSpeedControllerConfigWrite(const char* value, size_t length) {
     try {
-        LOG_INFO("收到调速器配置写入: %s", value.c_str());
+        LOG_INFO("收到调速器配置写入: %s", value);
         
-        // 解析JSON配置
-        DynamicJsonDocument doc(1024);
-        DeserializationError error = deserializeJson(doc, value);
+        // 解析JSON配置（最多11个成员，文档放在栈上，不分配堆内存）
+        StaticJsonDocument<SPEED_CONTROLLER_JSON_BUFFER_SIZE> doc;
+        DeserializationError error = deserializeJson(doc, value, length);
         
         if (error) {
             LOG_ERROR("解析调速器配置JSON失败: %s", error.c_str());
-            return;
+            return false;
+        }
+        
+        // 输出方式切换和PWM参数由本机处理，不经过MODBUS
+        if (doc.containsKey("outputMode") || MotorController::getInstance().getPWMController()) {
+            bool applied = applyPWMOutputConfig(doc);
+            if (applied && pSpeedControllerConfigCharacteristic) {
+                if (MotorController::getInstance().getPWMController()) {
+                    char response[SPEED_CONTROLLER_JSON_BUFFER_SIZE];
+                    notifyValue(pSpeedControllerConfigCharacteristic, (const uint8_t*)response,
+                                writePWMOutputJson(response, sizeof(response)));
+                } else {
+                    notifyValue(pSpeedControllerConfigCharacteristic, (const uint8_t*)value, length);
+                }
+            }
+            // 只切换输出方式时不向调速器写入默认值
+            if (MotorController::getInstance().getPWMController() || doc.size() == 1) {
+                return applied;
+            }
         }
         
         // 检查MotorModbusController是否已初始化
         if (!pMotorModbusController) {
             LOG_ERROR("MotorModbusController未初始化");
-            return;
+            return false;
         }
         
         // 创建AllConfig对象并填充值
@@ -833,23 +1878,60 @@ void MotorBLEServer::handleSpeedControllerConfigWrite(const String& value) {
         config.frequency = doc["frequency"] | 0;
         config.dutyCycle = doc["dutyCycle"] | 0;
         
-        // 调用MotorModbusController的setAllConfig方法
+        // 写入的配置保存在预先分配的槽位中，完成后据此回显并确认
+        uint8_t slot = 0;
+        while (slot < MAX_PENDING_CONFIG_WRITES && pendingConfigWrites[slot].inUse) {
+            slot++;
+        }
+        if (slot == MAX_PENDING_CONFIG_WRITES) {
+            LOG_ERROR("调速器配置写入提交失败: 等待完成的写入过多");
+            return false;
+        }
+        PendingConfigWrite& pending = pendingConfigWrites[slot];
+        pending.config = config;
+        pending.ackPending = executingCommand;
+        pending.ack = executingAck;
+        
+        // 提交异步写入，不等待总线；完成后在主循环中通知客户端
         // 不设置运行状态
         bool setRunning = false;
-        bool success = pMotorModbusController->setAllConfig(config, setRunning);
+        pending.inUse = pMotorModbusController->requestSetAllConfig(config, setRunning,
+            [this, slot](bool success) { finishConfigWrite(slot, success); });
         
-        if (success) {
-            LOG_INFO("调速器配置已更新");
-            
-            // 更新特征值
-            if (pSpeedControllerConfigCharacteristic) {
-                pSpeedControllerConfigCharacteristic->setValue(value.c_str());
-                pSpeedControllerConfigCharacteristic->notify();
-            }
-        } else {
-            LOG_ERROR("调速器配置更新失败: %s", pMotorModbusController->getLastError().c_str());
+        if (!pending.inUse) {
+            LOG_ERROR("调速器配置写入提交失败: MODBUS事务队列已满");
+            return false;
         }
+        // 确认在写入完成时发送
+        commandAckDeferred = pending.ackPending;
+        return true;
     } catch (const std::exception& e) {
         LOG_ERROR("处理调速器配置写入异常: %s", e.what());
+        return false;
+    }
+}
+
+// 调速器配置写入完成（主循环中调用）：成功时回显写入的配置，由命令队列执行的写入在此确认
+void MotorBLEServer::finishConfigWrite(uint8_t slot, bool success) {
+    PendingConfigWrite& pending = pendingConfigWrites[slot];
+    pending.inUse = false;
+    
+    if (success) {
+        LOG_INFO("调速器配置已更新");
+        if (pSpeedControllerConfigCharacteristic) {
+            char response[SPEED_CONTROLLER_JSON_BUFFER_SIZE];
+            JsonWriter writer(response, sizeof(response));
+            writer.beginObject();
+            writeConfigRegisterFields(writer, pending.config);
+            writer.endObject();
+            notifyValue(pSpeedControllerConfigCharacteristic, (const uint8_t*)response, writer.finish());
+        }
+    } else {
+        LOG_ERROR("调速器配置更新失败: 重试次数耗尽");
+    }
+    
+    if (pending.ackPending) {
+        sendCommandAck(pending.ack.id, pending.ack.target,
+                       success ? BleCommandAck::Result::OK : BleCommandAck::Result::FAILED, pending.ack.latencyMicros);
     }
 }
\ No newline at end of file
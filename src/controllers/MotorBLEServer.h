@@ -12,6 +12,12 @@
 #include "../controllers/MotorController.h"
 #include "../controllers/ConfigManager.h"
 #include "../controllers/MotorModbusController.h"
+#include "../common/StatusPacket.h"
+#include "../common/StatusModel.h"
+#include "../common/JsonWriter.h"
+#include "../common/ChunkedTransfer.h"
+#include "../common/BleCommandQueue.h"
+#include <atomic>
 
 /**
  * @brief BLE服务器类
@@ -19,6 +25,23 @@
  */
 class MotorBLEServer {
 public:
+    // JSON缓冲区大小（写入器直接输出到栈上或成员缓冲区，不分配堆内存）
+    static const size_t STATUS_JSON_BUFFER_SIZE = 768;          // 完整状态/状态通知（含系统状态变更详情）
+    static const size_t SPEED_CONTROLLER_JSON_BUFFER_SIZE = 512;
+    static const size_t INFO_JSON_BUFFER_SIZE = 256;
+    static const size_t PROGRAM_JSON_BUFFER_SIZE = 256;         // 电机程序执行状态（程序本身为二进制）
+    static const size_t DIAGNOSTICS_JSON_BUFFER_SIZE = 768;     // 计数全部取最大值时约750字节
+    
+    // 可写特征值（写入确认中的target字段）
+    enum WriteTarget : uint8_t {
+        WRITE_RUN_DURATION = 0,
+        WRITE_STOP_INTERVAL = 1,
+        WRITE_SYSTEM_CONTROL = 2,
+        WRITE_SPEED_CONTROLLER_CONFIG = 3,
+        WRITE_DIAGNOSTICS = 4,
+        WRITE_PROGRAM = 5
+    };
+    
     /**
      * @brief 获取单例实例
      * @return MotorBLEServer& 单例引用
@@ -46,6 +69,13 @@ public:
      */
     void update();
     
+    /**
+     * @brief 距下一次需要调用update()的时间（微秒）
+     * @return 有待执行的BLE写入时为0，MODBUS事务进行中时为轮询间隔，
+     *         已连接时为距下次状态通知（或电机状态变化后取样）的时间，否则为DeadlineScheduler::NO_DEADLINE
+     */
+    uint32_t getMicrosUntilNextUpdate() const;
+    
     /**
      * @brief 获取当前连接状态
      * @return true 已连接，false 未连接
@@ -58,6 +88,42 @@ public:
      */
     void sendStatusNotification(const String& status);
     
+    /**
+     * @brief 发送状态通知
+     * @param json JSON格式的状态信息
+     * @param length 长度
+     */
+    void sendStatusNotification(const char* json, size_t length);
+    
+    /**
+     * @brief 发送二进制状态通知（序号加1，只在主循环中调用）
+     */
+    void sendStatusPacketNotification();
+    
+    /**
+     * @brief 下一次状态通知发送完整状态（关键帧），连接建立时调用
+     */
+    void requestStatusKeyframe();
+    
+    /**
+     * @brief 取样状态字段并判断是否需要状态通知（已连接时由update()调用）
+     * 只包含与客户端已知状态不同的字段（增量），带"type"（"delta"/"keyframe"）和"seq"（序号）；
+     * 节奏见StatusModel和BLE_STATUS_*配置
+     * @param buffer 需要通知时写入通知内容（至少STATUS_JSON_BUFFER_SIZE）
+     * @param size 缓冲区大小
+     * @return 通知长度，不需要通知时为0；返回非0时已记录为已发出
+     */
+    size_t pollStatusNotification(char* buffer, size_t size);
+    
+    const StatusModel& getStatusModel() const { return statusModel; }
+    
+    /**
+     * @brief 当前连接协商后的ATT MTU（未协商时为23），单包负载为MTU-3字节
+     */
+    uint16_t getPeerMTU() const { return peerMTU; }
+    const ChunkAssembler& getChunkAssembler() const { return chunkAssembler; }
+    const BleCommandQueue& getCommandQueue() const { return commandQueue; }
+    
     /**
      * @brief 获取最后错误信息
      * @return const char* 错误信息
@@ -65,14 +131,67 @@ public:
     const char* getLastError() const { return lastError; }
 
     // 公开这些方法供测试使用
-    void handleRunDurationWrite(const String& value);
-    void handleStopIntervalWrite(const String& value);
-    void handleSystemControlWrite(const String& value);
-    void handleSpeedControllerConfigWrite(const String& value);
+    // 写入处理（在主循环中执行），返回写入是否有效并已执行；调速器配置为是否已提交MODBUS写入，
+    // 由命令队列执行时其确认在MODBUS写入完成后发送
+    bool handleRunDurationWrite(const char* value);
+    bool handleStopIntervalWrite(const char* value);
+    bool handleSystemControlWrite(const char* value);
+    bool handleSpeedControllerConfigWrite(const char* value, size_t length);
+    bool handleDiagnosticsWrite(const char* value);
+    /**
+     * @brief 处理电机程序写入
+     * @param data MotorProgram::serialize()格式的程序（超过单包负载时分块写入），
+     *             或JSON命令{"action":"start"|"stop"|"read"}
+     * @param length 长度
+     */
+    bool handleProgramWrite(const uint8_t* data, size_t length);
     String generateStatusJson();
     String generateSpeedControllerConfigJson();
     String generateInfoJson();
+    
+    /**
+     * @brief 写入完整状态JSON（不分配堆内存）
+     * @param buffer 输出缓冲区（至少STATUS_JSON_BUFFER_SIZE）
+     * @param size 缓冲区大小
+     * @return 长度，缓冲区不足时为0
+     */
+    size_t writeStatusJson(char* buffer, size_t size);
+    size_t writeSpeedControllerConfigJson(char* buffer, size_t size);
+    size_t writeInfoJson(char* buffer, size_t size);
+    size_t writeDiagnosticsJson(char* buffer, size_t size);
+    
+    /**
+     * @brief 写入电机程序执行状态JSON（程序本身通过"read"命令以二进制通知）
+     * @param buffer 输出缓冲区（至少PROGRAM_JSON_BUFFER_SIZE）
+     * @param size 缓冲区大小
+     * @return 长度，缓冲区不足时为0
+     */
+    size_t writeProgramStatusJson(char* buffer, size_t size);
+    
+    /**
+     * @brief 生成二进制状态包（布局见StatusPacket），序号为最近一次通知的序号，不递增
+     * @param buffer 输出缓冲区
+     * @param size 缓冲区大小（至少StatusPacket::SIZE）
+     * @return 写入的字节数，缓冲区不足时返回0
+     */
+    size_t generateStatusPacket(uint8_t* buffer, size_t size);
+    void applyProgramSetpoint(const ProgramSetpoint& setpoint);
     void onSystemStateChanged(const StateChangeEvent& event);
+    
+    /**
+     * @brief 解析运行时长/停止间隔特征值
+     * @param text 以秒为单位的十进制数，最多3位小数（如"5"、"0.25"）
+     * @param durationMs 解析结果（毫秒）
+     * @return 格式是否有效且不超过MOTOR_MAX_DURATION_MS
+     */
+    static bool parseDurationMs(const char* text, uint32_t& durationMs);
+    
+    /**
+     * @brief 将毫秒时长格式化为运行时长/停止间隔特征值（秒，省略末尾的0）
+     * @param durationMs 时长（毫秒）
+     * @return 如"5"、"0.25"
+     */
+    static String formatDurationSeconds(uint32_t durationMs);
 
 private:
     // 单例模式
@@ -90,6 +209,10 @@ private:
     BLECharacteristic* pStatusQueryCharacteristic = nullptr;
     BLECharacteristic* pSpeedControllerStatusCharacteristic = nullptr;
     BLECharacteristic* pSpeedControllerConfigCharacteristic = nullptr;
+    BLECharacteristic* pDiagnosticsCharacteristic = nullptr;
+    BLECharacteristic* pProgramCharacteristic = nullptr;
+    BLECharacteristic* pStatusBinaryCharacteristic = nullptr;
+    BLECharacteristic* pCommandAckCharacteristic = nullptr;
     
     // 状态
     // 状态
@@ -97,6 +220,37 @@ private:
     bool oldDeviceConnected = false;
     char lastError[128] = "";
     
+    // 变化驱动的状态通知（StatusModel字段编号；系统信息字段只在发送通知时取样）
+    enum StatusField : uint8_t {
+        STATUS_STATE = 0,
+        STATUS_REMAINING_RUN,
+        STATUS_REMAINING_STOP,
+        STATUS_CYCLE,
+        STATUS_RUN_DURATION,
+        STATUS_STOP_DURATION,
+        STATUS_CYCLE_LIMIT,
+        STATUS_AUTO_START,
+        STATUS_PWM_MODE,
+        STATUS_PWM_OUTPUT,
+        STATUS_UPTIME,
+        STATUS_SYSTEM_STATE,
+        STATUS_FREE_HEAP,           // 以下为系统信息字段
+        STATUS_CHIP_TEMPERATURE,
+        STATUS_FIELD_COUNT
+    };
+    StatusModel statusModel;
+    std::atomic<bool> statusResyncPending;       // 连接建立/断开后重新发送关键帧
+    bool stateChangePending = false;             // 系统状态变更信息随下一次通知发送
+    StateChangeEvent lastStateChange;
+    std::atomic<uint16_t> statusSequence;        // 最近一次二进制状态通知的序号（主循环递增，读取回调只读）
+    char statusJsonBuffer[STATUS_JSON_BUFFER_SIZE];  // 主循环中生成状态通知
+    
+    void sampleStatus(int64_t* values);
+    void sampleSystemInfo(int64_t* values);
+    void writeStatusFields(JsonWriter& writer, const int64_t* values, uint32_t mask);
+    size_t writeStatusNotification(char* buffer, size_t size, StatusModel::Notify kind,
+                                   const int64_t* values, uint32_t mask, bool withStateChange);
+    
     // 调速器状态读取保护
     uint32_t lastSpeedControllerStatusReadTime = 0;  // 上次读取调速器状态的时间
     
@@ -111,6 +265,58 @@ private:
     // MotorModbusController实例
     MotorModbusController* pMotorModbusController = nullptr;
     
+    // 调速器配置缓存（异步读取结果）：主循环写入，读取回调通过getSpeedControllerCache()在临界区内复制
+    struct SpeedControllerCache {
+        MotorModbusController::AllConfig config;
+        bool valid;
+        bool lastReadOk;
+        uint32_t configTime;
+        uint32_t responseTime;
+        uint32_t errorCount;
+    };
+    SpeedControllerCache speedControllerCache = {};
+    portMUX_TYPE speedControllerCacheMux = portMUX_INITIALIZER_UNLOCKED;
+    bool speedControllerRefreshPending = false;                // 只在主循环中使用
+    std::atomic<bool> speedControllerRefreshRequested;         // 读取回调请求刷新，由update()提交
+    
+    // 正在执行的写入的确认（只在主循环中使用）；需要等待MODBUS完成的处理函数接管确认，完成时再通知结果
+    bool executingCommand = false;
+    bool commandAckDeferred = false;
+    BleCommandAck executingAck = {};
+    
+    // 等待MODBUS完成的调速器配置写入（预先分配，完成回调只捕获槽位下标，不分配堆内存）
+    static const uint8_t MAX_PENDING_CONFIG_WRITES = 4;
+    struct PendingConfigWrite {
+        bool inUse;
+        bool ackPending;        // 由队列执行的写入，完成时通知确认
+        BleCommandAck ack;
+        MotorModbusController::AllConfig config;
+    };
+    PendingConfigWrite pendingConfigWrites[MAX_PENDING_CONFIG_WRITES] = {};
+    
+    // MTU与分块传输（重组缓冲区预先分配，只在BLE写入回调中使用）
+    std::atomic<uint16_t> peerMTU;
+    std::atomic<esp_gatt_if_t> gattsInterface;  // 分块帧直接通知时使用的GATT接口（GATT事件中记录）
+    uint8_t notifyTransferId = 0;
+    uint8_t chunkBuffer[BLE_CHUNK_MAX_MESSAGE_SIZE + 1];
+    ChunkAssembler chunkAssembler;
+    const char* chunkCharUUID = nullptr;        // 正在分块写入的特征值
+    
+    // 超过单包负载的通知复制后分批发送，每个特征值最多一条，新内容替换未发完的旧消息（只在主循环中使用）；
+    // 帧直接通知，不替换特征值，读取不会取到分块帧
+    struct PendingNotification {
+        BLECharacteristic* characteristic;      // 为空表示空闲
+        uint8_t message[BLE_CHUNK_MAX_MESSAGE_SIZE];
+        size_t length;
+        ChunkEncoder encoder;
+        
+        PendingNotification() : characteristic(nullptr), length(0), encoder(nullptr, 0, 0, 0) {}
+    };
+    PendingNotification pendingNotifications[BLE_NOTIFY_PENDING_SLOTS];
+    uint64_t nextNotifyBatchMicros = 0;         // 下一批分块通知的最早发送时刻（MonotonicClock微秒）
+    
+    // BLE写入由回调复制进队列，主循环执行后发送确认
+    BleCommandQueue commandQueue;
     
     
     // BLE服务器回调类
@@ -119,6 +325,7 @@ private:
         ServerCallbacks(MotorBLEServer* bleServer) : bleServer(bleServer) {}
         void onConnect(BLEServer* pServer) override;
         void onDisconnect(BLEServer* pServer) override;
+        void onMtuChanged(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) override;
     private:
         MotorBLEServer* bleServer;
     };
@@ -137,6 +344,28 @@ private:
     
     // 内部方法
     void setError(const char* error);
+    void notifyValue(BLECharacteristic* characteristic, const uint8_t* data, size_t length, bool storeValue = true);
+    void notifyFrame(BLECharacteristic* characteristic, const uint8_t* data, size_t length);
+    void setReadValue(BLECharacteristic* characteristic, const uint8_t* data, size_t length);
+    static void onGattsEvent(esp_gatts_cb_event_t event, esp_gatt_if_t gattsIf, esp_ble_gatts_cb_param_t* param);
+    void sendPendingNotifications();
+    bool hasPendingNotifications() const;
+    void clearPendingNotifications();
+    bool acceptChunk(uint8_t target, const char* charUUID, const uint8_t* data, size_t length);
+    void enqueueWrite(uint8_t target, const uint8_t* data, size_t length);
+    bool executeCommand(const BleCommand& command);
+    void sendCommandAck(uint16_t id, uint8_t target, BleCommandAck::Result result, uint32_t latencyMicros);
+    static int getWriteTarget(const char* charUUID);
+    static const char* getWriteTargetName(uint8_t target);
+    void requestSpeedControllerRefresh();
+    SpeedControllerCache getSpeedControllerCache();
+    void setSpeedControllerCache(const SpeedControllerCache& cache);
+    void writeSpeedControllerConfigFields(JsonWriter& writer);
+    static void writeConfigRegisterFields(JsonWriter& writer, const MotorModbusController::AllConfig& config);
+    void finishConfigWrite(uint8_t slot, bool success);
+    void writePWMOutputFields(JsonWriter& writer);
+    size_t writePWMOutputJson(char* buffer, size_t size);
+    bool applyPWMOutputConfig(const JsonDocument& doc);
     void configureBLELowPowerDirect();
     
     // === 5.4.3 BLE断连时的系统稳定运行机制 ===
@@ -1,6 +1,9 @@
 #include "MotorController.h"
 #include "../drivers/GPIODriver.h"
 #include "../common/EventManager.h"
+#include "../common/DeadlineScheduler.h"
+#include "../common/WakeSignal.h"
+#include "../common/MonotonicClock.h"
 
 // 单例实例
 MotorController& MotorController::getInstance() {
@@ -13,19 +16,35 @@ MotorController::MotorController()
     : currentState(MotorControllerState::STOPPED)
     , timer(TimerDriver::getInstance())
     , gpioDriver(nullptr)
+    , pwmOutputEnabled(false)
     , stateStartTime(0)
     , remainingRunTime(0)
     , remainingStopTime(0)
     , cycleCount(0)
+    , phaseStartMicros(0)
+    , phaseDeadlineMicros(0)
+    , phaseAnchorMicros(0)
+    , hasPhaseAnchor(false)
+    , phaseTimerCreated(false)
+    , phaseTimerEnabled(true)
+    , phaseTimerArmed(false)
+    , phaseTimerDeferred(false)
+    , phaseEdgeWrites(false)
+    , phaseEdgeLevel(MOTOR_OFF)
+    , phaseEdgePending(false)
+    , phaseEdgeMicros(0)
+    , programActive(false)
+    , programFinished(false)
     , isInitialized(false)
     , configUpdated(false)
     , stateManager(StateManager::getInstance()) {
     
     memset(lastError, 0, sizeof(lastError));
+    memset(jitterStats, 0, sizeof(jitterStats));
     
     // 设置默认配置
-    currentConfig.runDuration = 5;       // 默认5秒
-    currentConfig.stopDuration = 2;      // 默认2秒
+    currentConfig.runDurationMs = 5000;  // 默认5秒
+    currentConfig.stopDurationMs = 2000; // 默认2秒
     currentConfig.cycleCount = 0;        // 默认无限循环
     currentConfig.autoStart = true;      // 默认自动启动
 }
@@ -68,14 +87,38 @@ bool MotorController::init() {
         const MotorConfig& actualConfig = configManager.getConfig();
         currentConfig = actualConfig;
         
-        LOG_TAG_INFO("MotorController", "已加载实际配置 - 运行: %lu秒, 停止: %lu秒, 循环: %lu次, 自动启动: %s",
-                     currentConfig.runDuration, currentConfig.stopDuration,
+        LOG_TAG_INFO("MotorController", "已加载实际配置 - 运行: %lu ms, 停止: %lu ms, 循环: %lu次, 自动启动: %s",
+                     currentConfig.runDurationMs, currentConfig.stopDurationMs,
                      currentConfig.cycleCount, currentConfig.autoStart ? "是" : "否");
     } catch (...) {
         LOG_TAG_WARN("MotorController", "无法获取ConfigManager配置，使用默认配置");
         // 保持使用构造函数中设置的默认配置
     }
     
+    // PWM输出方式：LEDC接管MOTOR_PIN，输出保持关闭；失败时退回GPIO开关输出
+    if (currentConfig.outputMode == MotorOutputMode::PWM && !applyOutputMode(MotorOutputMode::PWM)) {
+        LOG_TAG_WARN("MotorController", "PWM输出不可用，使用GPIO开关输出");
+    }
+    
+    // 创建相位定时器（一次性模式，每个阶段重新启动）；创建失败时由主循环检测到期
+    if (timer.init()) {
+        phaseTimerCreated = timer.createTimer(PHASE_TIMER, 1,
+            [this]() { this->onPhaseTimer(); }, false);
+    }
+    if (!phaseTimerCreated) {
+        LOG_TAG_WARN("MotorController", "相位定时器不可用，由主循环检测阶段到期");
+    }
+    
+    // 加载NVS中保存的电机程序（只加载，由命令启动执行）
+    try {
+        MotorProgram storedProgram;
+        if (ConfigManager::getInstance().loadProgram(storedProgram)) {
+            program = storedProgram;
+        }
+    } catch (...) {
+        LOG_TAG_WARN("MotorController", "无法加载存储的电机程序");
+    }
+    
     isInitialized = true;
     setState(MotorControllerState::STOPPED);
     
@@ -94,11 +137,18 @@ bool MotorController::startMotor() {
         return false;
     }
     
+    // 启停命令结束程序，恢复运行/停止循环
+    abortProgram();
+    
     if (currentState == MotorControllerState::RUNNING || currentState == MotorControllerState::STARTING) {
         LOG_TAG_WARN("MotorController", "电机已在运行中");
         return true;
     }
     
+    // 手动启动：放弃停止间隔的计时，运行阶段从现在开始
+    cancelPhaseTimer();
+    clearPhaseAnchor();
+    remainingStopTime = 0;
     setState(MotorControllerState::STARTING);
     return true;
 }
@@ -110,11 +160,17 @@ bool MotorController::stopMotor() {
         return false;
     }
     
+    abortProgram();
+    
     if (currentState == MotorControllerState::STOPPED || currentState == MotorControllerState::STOPPING) {
         LOG_TAG_WARN("MotorController", "电机已停止");
         return true;
     }
     
+    // 手动停止：放弃运行阶段的计时，下一次启动重新开始计时
+    cancelPhaseTimer();
+    clearPhaseAnchor();
+    remainingRunTime = 0;
     setState(MotorControllerState::STOPPING);
     return true;
 }
@@ -125,6 +181,17 @@ void MotorController::update() {
         return;
     }
     
+    // PWM缓启动/缓停止按固定间隔推进，与状态机无关
+    if (pwmController) {
+        pwmController->update(MonotonicClock::nowMicros());
+    }
+    
+    // 执行程序时由程序决定电机开/关
+    if (programActive) {
+        handleProgram();
+        return;
+    }
+    
     // 根据当前状态处理状态机
     switch (currentState) {
         case MotorControllerState::STOPPED:
@@ -145,10 +212,62 @@ void MotorController::update() {
     }
 }
 
+// 距下一次需要更新的时间：状态机和PWM斜坡中较早的一个
+uint32_t MotorController::getMicrosUntilNextUpdate() const {
+    uint32_t next = getMicrosUntilStateUpdate();
+    if (pwmController) {
+        uint32_t rampDue = pwmController->getMicrosUntilNextUpdate(MonotonicClock::nowMicros());
+        if (rampDue < next) {
+            next = rampDue;
+        }
+    }
+    return next;
+}
+
+// 距状态机下一次需要处理的时间
+uint32_t MotorController::getMicrosUntilStateUpdate() const {
+    if (!isInitialized) {
+        return DeadlineScheduler::NO_DEADLINE;
+    }
+    
+    if (programActive) {
+        uint32_t remainingMs = programRunner.getMsUntilNextStep(MonotonicClock::nowMillis());
+        return remainingMs > DeadlineScheduler::MAX_DELAY_MICROS / 1000 ?
+            DeadlineScheduler::MAX_DELAY_MICROS : remainingMs * 1000;
+    }
+    
+    switch (currentState) {
+        case MotorControllerState::STARTING:
+        case MotorControllerState::STOPPING:
+            return 0;
+        case MotorControllerState::RUNNING:
+            return remainingRunTime == 0 ? 0 : getMicrosUntilPhaseDue();
+        case MotorControllerState::STOPPED:
+            // 循环已完成或自动启动被禁用：等待外部命令
+            if (!isAutoCycleAllowed()) {
+                return DeadlineScheduler::NO_DEADLINE;
+            }
+            if (currentConfig.stopDurationMs == 0 || remainingStopTime == 0) {
+                return 0;
+            }
+            return getMicrosUntilPhaseDue();
+        case MotorControllerState::ERROR_STATE:
+        default:
+            return DeadlineScheduler::NO_DEADLINE;
+    }
+}
+
 // 处理停止状态
 void MotorController::handleStoppedState() {
+    // 程序已结束：保持停止，等待启停命令
+    if (programFinished) {
+        return;
+    }
+    
     // 检查是否达到循环次数限制
     if (currentConfig.cycleCount > 0 && cycleCount >= currentConfig.cycleCount) {
+        cancelPhaseTimer();
+        clearPhaseAnchor();
         LOG_TAG_INFO("MotorController", "已完成所有循环 (%lu/%lu)，保持停止状态",
                      cycleCount, currentConfig.cycleCount);
         return; // 不再启动新的循环
@@ -156,137 +275,520 @@ void MotorController::handleStoppedState() {
     
     // 关键修复：检查自动启动是否被禁用（手动停止模式）
     if (!currentConfig.autoStart) {
+        cancelPhaseTimer();
+        clearPhaseAnchor();
         LOG_TAG_INFO("MotorController", "自动启动已禁用，保持停止状态（手动停止模式）");
         return; // 不自动启动，等待手动启动命令
     }
     
     // 处理停止间隔为0的持续运行模式
-    if (currentConfig.stopDuration == 0) {
+    if (currentConfig.stopDurationMs == 0) {
         LOG_TAG_INFO("MotorController", "持续运行模式，跳过停止间隔");
         // 直接完成当前停止状态，不经过STARTING状态
         setState(MotorControllerState::RUNNING);
         return;
     }
     
-    // 初始化停止时间倒计时
-    // 初始化停止时间倒计时 - 使用毫秒精度
+    // 初始化停止时间倒计时 - 从上一次相位切换的时刻开始，到期时由定时器启动电机
     if (remainingStopTime == 0) {
-        remainingStopTime = currentConfig.stopDuration * 1000; // 转换为毫秒
-        stateStartTime = millis();
-        LOG_TAG_INFO("MotorController", "开始停止间隔倒计时: %lu ms (%.1f 秒, 开始时间: %lu ms)",
-                     remainingStopTime, remainingStopTime/1000.0f, stateStartTime);
-    }
-    
-    // 更新停止时间倒计时 - 使用毫秒精度
-    uint32_t currentTime = millis();
-    uint32_t elapsedMs = currentTime - stateStartTime;
-    uint32_t targetDurationMs = currentConfig.stopDuration * 1000;
-    
-    // 调试日志：计时精度验证
-    if (elapsedMs % 5000 < 100) { // 每5秒输出一次调试信息
-        LOG_TAG_DEBUG("MotorController", "停止计时调试 - 当前时间: %lu ms, 已过时间: %lu ms (%.2f s), 目标: %lu ms (%.1f s), 剩余: %lu ms",
-                     currentTime, elapsedMs, elapsedMs/1000.0f, targetDurationMs, targetDurationMs/1000.0f,
-                     (targetDurationMs > elapsedMs) ? (targetDurationMs - elapsedMs) : 0);
-    }
-    
-    if (elapsedMs >= targetDurationMs) {
-        // 停止时间结束，开始下一个运行周期
-        long timingError = (long)elapsedMs - (long)targetDurationMs;
-        LOG_TAG_INFO("MotorController", "停止间隔结束 - 配置: %lu ms (%.1f s), 实际: %lu ms (%.1f s), 误差: %ld ms",
-                     targetDurationMs, targetDurationMs/1000.0f, elapsedMs, elapsedMs/1000.0f, timingError);
-        remainingStopTime = 0;
-        setState(MotorControllerState::STARTING);
-    } else {
-        // 更新剩余停止时间（毫秒）
-        remainingStopTime = targetDurationMs - elapsedMs;
+        remainingStopTime = currentConfig.stopDurationMs;
+        beginPhase(remainingStopTime, false);
+        LOG_TAG_INFO("MotorController", "开始停止间隔倒计时: %lu ms (%.1f 秒, 开始时间: %llu ms)",
+                     remainingStopTime, remainingStopTime/1000.0f, (unsigned long long)stateStartTime);
+    }
+    
+    uint64_t now = MonotonicClock::nowMicros();
+    if (!isPhaseDue(now)) {
+        // 更新剩余停止时间（毫秒，向上取整，保持非0）
+        remainingStopTime = (uint32_t)((phaseDeadlineMicros - now + 999) / 1000);
+        if (phaseTimerDeferred) {
+            armPhaseTimer();
+        }
+        return;
     }
+    
+    // 停止时间结束，开始下一个运行周期
+    uint32_t targetDurationMs = currentConfig.stopDurationMs;
+    uint64_t edgeMicros = finishPhase(now, MotorPhase::STOP);
+    long timingError = (long)(int64_t)(edgeMicros - phaseDeadlineMicros);
+    LOG_TAG_INFO("MotorController", "停止间隔结束 - 配置: %lu ms (%.1f s), 实际: %.3f ms, 误差: %ld us",
+                 targetDurationMs, targetDurationMs/1000.0f, (edgeMicros - phaseStartMicros)/1000.0f, timingError);
+    remainingStopTime = 0;
+    setState(MotorControllerState::STARTING);
 }
 
 // 处理运行状态
 void MotorController::handleRunningState() {
-    // 初始化运行时间倒计时 - 使用毫秒精度
+    // 初始化运行时间倒计时 - 从上一次相位切换的时刻开始，到期时由定时器停止电机
     if (remainingRunTime == 0) {
-        remainingRunTime = currentConfig.runDuration * 1000; // 转换为毫秒
-        stateStartTime = millis();
-        LOG_TAG_INFO("MotorController", "开始运行时间倒计时: %lu ms (%.1f 秒, 开始时间: %lu ms)",
-                     remainingRunTime, remainingRunTime/1000.0f, stateStartTime);
+        remainingRunTime = currentConfig.runDurationMs;
+        beginPhase(remainingRunTime, true);
+        LOG_TAG_INFO("MotorController", "开始运行时间倒计时: %lu ms (%.1f 秒, 开始时间: %llu ms)",
+                     remainingRunTime, remainingRunTime/1000.0f, (unsigned long long)stateStartTime);
+    }
+    
+    uint64_t now = MonotonicClock::nowMicros();
+    if (!isPhaseDue(now)) {
+        // 更新剩余运行时间（毫秒，向上取整，保持非0）
+        remainingRunTime = (uint32_t)((phaseDeadlineMicros - now + 999) / 1000);
+        if (phaseTimerDeferred) {
+            armPhaseTimer();
+        }
+        return;
+    }
+    
+    // 运行时间结束，完成一个循环
+    uint32_t targetDurationMs = currentConfig.runDurationMs;
+    uint64_t edgeMicros = finishPhase(now, MotorPhase::RUN);
+    long timingError = (long)(int64_t)(edgeMicros - phaseDeadlineMicros);
+    LOG_TAG_INFO("MotorController", "运行周期完成 - 配置: %lu ms (%.1f s), 实际: %.3f ms, 误差: %ld us",
+                 targetDurationMs, targetDurationMs/1000.0f, (edgeMicros - phaseStartMicros)/1000.0f, timingError);
+    
+    remainingRunTime = 0;
+    cycleCount++;
+    
+    LOG_TAG_INFO("MotorController", "当前循环次数: %lu/%s",
+                 cycleCount,
+                 (currentConfig.cycleCount == 0) ? "∞" : String(currentConfig.cycleCount).c_str());
+    
+    // 检查是否需要继续循环
+    if (currentConfig.cycleCount > 0 && cycleCount >= currentConfig.cycleCount) {
+        LOG_TAG_INFO("MotorController", "所有循环已完成，停止电机");
+        setState(MotorControllerState::STOPPING);
+    } else if (currentConfig.stopDurationMs == 0) {
+        // 持续运行模式，直接开始下一个周期
+        LOG_TAG_INFO("MotorController", "持续运行模式，直接开始下一个运行周期");
+        remainingRunTime = 0; // 重置运行时间
+        setState(MotorControllerState::RUNNING); // 保持在运行状态
+    } else {
+        LOG_TAG_INFO("MotorController", "准备进入停止间隔");
+        setState(MotorControllerState::STOPPING);
+    }
+}
+
+// 开始一个运行/停止阶段
+void MotorController::beginPhase(uint32_t durationMs, bool running) {
+    // 紧接上一次相位切换时以切换时刻为起点，状态机处理的延迟不会累积到周期上
+    phaseStartMicros = hasPhaseAnchor ? phaseAnchorMicros : MonotonicClock::nowMicros();
+    hasPhaseAnchor = false;
+    stateStartTime = phaseStartMicros / 1000;
+    schedulePhase(durationMs, running);
+}
+
+// 按阶段时长设置截止时间和到期时的GPIO切换，并启动定时器
+void MotorController::schedulePhase(uint32_t durationMs, bool running) {
+    phaseDeadlineMicros = phaseStartMicros + (uint64_t)durationMs * 1000;
+    if (running) {
+        // 持续运行模式下运行阶段之间不切换GPIO
+        bool lastCycle = currentConfig.cycleCount > 0 && cycleCount + 1 >= currentConfig.cycleCount;
+        phaseEdgeWrites = lastCycle || currentConfig.stopDurationMs > 0;
+        phaseEdgeLevel = MOTOR_OFF;
+    } else {
+        phaseEdgeWrites = true;
+        phaseEdgeLevel = MOTOR_ON;
+    }
+    armPhaseTimer();
+}
+
+// 当前阶段是否已到期；定时器启动后给它一段宽限时间完成切换，超时后由主循环兜底
+bool MotorController::isPhaseDue(uint64_t now) const {
+    if (phaseEdgePending) {
+        return true;
+    }
+    uint64_t deadline = phaseDeadlineMicros + (phaseTimerArmed ? MOTOR_PHASE_TIMER_GRACE_MICROS : 0);
+    return now >= deadline;
+}
+
+// 距当前阶段到期的时间
+uint32_t MotorController::getMicrosUntilPhaseDue() const {
+    if (phaseEdgePending) {
+        return 0;
+    }
+    uint64_t deadline = phaseDeadlineMicros + (phaseTimerArmed ? MOTOR_PHASE_TIMER_GRACE_MICROS : 0);
+    uint64_t now = MonotonicClock::nowMicros();
+    if (now >= deadline) {
+        return 0;
+    }
+    // 超出调度器单次休眠范围时分段等待
+    uint64_t remaining = deadline - now;
+    return remaining > DeadlineScheduler::MAX_DELAY_MICROS ? DeadlineScheduler::MAX_DELAY_MICROS : (uint32_t)remaining;
+}
+
+// 结束当前阶段：确认切换时刻、记录误差，返回切换时刻
+uint64_t MotorController::finishPhase(uint64_t now, MotorPhase phase) {
+    // 先停止定时器：此后定时器不会再切换GPIO，phaseEdgePending不再变化
+    cancelPhaseTimer();
+    bool byTimer = phaseEdgePending;
+    uint64_t edgeMicros = byTimer ? phaseEdgeMicros : now;
+    phaseEdgePending = false;
+    
+    // 定时器未切换（不可用或已超时）：立即切换，不等状态机的下一步；
+    // PWM输出方式下定时器不切换输出，缓启动/缓停止从切换时刻开始
+    if (phaseEdgeWrites && (!byTimer || pwmController)) {
+        writeMotorOutput(phaseEdgeLevel == MOTOR_ON, edgeMicros);
     }
     
-    // 更新运行时间倒计时 - 使用毫秒精度
-    uint32_t currentTime = millis();
-    uint32_t elapsedMs = currentTime - stateStartTime;
-    uint32_t targetDurationMs = currentConfig.runDuration * 1000;
+    uint64_t error = edgeMicros >= phaseDeadlineMicros ? edgeMicros - phaseDeadlineMicros : phaseDeadlineMicros - edgeMicros;
+    recordPhaseJitter(phase, error > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)error, byTimer);
     
-    // 调试日志：计时精度验证
-    if (elapsedMs % 5000 < 100) { // 每5秒输出一次调试信息
-        LOG_TAG_DEBUG("MotorController", "运行计时调试 - 当前时间: %lu ms, 已过时间: %lu ms (%.2f s), 目标: %lu ms (%.1f s), 剩余: %lu ms",
-                     currentTime, elapsedMs, elapsedMs/1000.0f, targetDurationMs, targetDurationMs/1000.0f,
-                     (targetDurationMs > elapsedMs) ? (targetDurationMs - elapsedMs) : 0);
+    phaseAnchorMicros = edgeMicros;
+    hasPhaseAnchor = true;
+    return edgeMicros;
+}
+
+// 定时器已切换GPIO而主循环尚未确认时，先按当前配置结束该阶段并完成状态转换；
+// 重新安排阶段（配置更新、启停定时器）之前调用，否则重新启动定时器会丢掉这次切换，状态与GPIO不一致
+void MotorController::completePendingPhaseEdge() {
+    if (!phaseEdgePending || programActive) {
+        return;
+    }
+    if (currentState == MotorControllerState::RUNNING) {
+        handleRunningState();
+    } else if (currentState == MotorControllerState::STOPPED) {
+        handleStoppedState();
+    }
+}
+
+// 为当前阶段启动一次性定时器；截止时刻较远时先不启动，由主循环在接近时再调用
+void MotorController::armPhaseTimer() {
+    cancelPhaseTimer();
+    phaseEdgePending = false;
+    if (!isPhaseTimerActive()) {
+        return;
     }
     
-    if (elapsedMs >= targetDurationMs) {
-        // 运行时间结束，完成一个循环
-        long timingError = (long)elapsedMs - (long)targetDurationMs;
-        LOG_TAG_INFO("MotorController", "运行周期完成 - 配置: %lu ms (%.1f s), 实际: %lu ms (%.1f s), 误差: %ld ms",
-                     targetDurationMs, targetDurationMs/1000.0f, elapsedMs, elapsedMs/1000.0f, timingError);
-        
-        remainingRunTime = 0;
-        cycleCount++;
-        
-        LOG_TAG_INFO("MotorController", "当前循环次数: %lu/%s",
-                     cycleCount,
-                     (currentConfig.cycleCount == 0) ? "∞" : String(currentConfig.cycleCount).c_str());
-        
-        // 检查是否需要继续循环
-        if (currentConfig.cycleCount > 0 && cycleCount >= currentConfig.cycleCount) {
-            LOG_TAG_INFO("MotorController", "所有循环已完成，停止电机");
-            setState(MotorControllerState::STOPPING);
-        } else if (currentConfig.stopDuration == 0) {
-            // 持续运行模式，直接开始下一个周期
-            LOG_TAG_INFO("MotorController", "持续运行模式，直接开始下一个运行周期");
-            remainingRunTime = 0; // 重置运行时间
-            setState(MotorControllerState::RUNNING); // 保持在运行状态
-        } else {
-            LOG_TAG_INFO("MotorController", "准备进入停止间隔");
-            setState(MotorControllerState::STOPPING);
+    uint64_t now = MonotonicClock::nowMicros();
+    uint64_t remaining = phaseDeadlineMicros > now ? phaseDeadlineMicros - now : 0;
+    if (remaining > DeadlineScheduler::MAX_DELAY_MICROS) {
+        phaseTimerDeferred = true;
+        return;
+    }
+    phaseTimerArmed = timer.startOneShotUs(PHASE_TIMER, (uint32_t)remaining);
+}
+
+// 停止相位定时器
+void MotorController::cancelPhaseTimer() {
+    if (phaseTimerArmed && timer.isTimerRunning(PHASE_TIMER)) {
+        timer.stopTimer(PHASE_TIMER);
+    }
+    phaseTimerArmed = false;
+    phaseTimerDeferred = false;
+}
+
+// 下一阶段不再紧接上一次切换（手动启停、循环结束、禁止自动启动等）
+void MotorController::clearPhaseAnchor() {
+    hasPhaseAnchor = false;
+}
+
+// 定时器中断：在截止时刻直接切换GPIO，状态机由主循环随后确认
+void IRAM_ATTR MotorController::onPhaseTimer() {
+    if (phaseEdgeWrites && !pwmOutputEnabled) {
+        ::digitalWrite(MOTOR_PIN, phaseEdgeLevel);
+    }
+    phaseEdgeMicros = MonotonicClock::nowMicros();
+    phaseEdgePending = true;
+    WakeSignal::getInstance().notifyFromISR();
+}
+
+// 记录相位切换误差
+void MotorController::recordPhaseJitter(MotorPhase phase, uint32_t errorMicros, bool byTimer) {
+    PhaseJitterStatistics& stats = jitterStats[(uint8_t)phase];
+    if (stats.edges == 0 || errorMicros < stats.minErrorMicros) {
+        stats.minErrorMicros = errorMicros;
+    }
+    stats.edges++;
+    if (byTimer) {
+        stats.timerEdges++;
+    }
+    stats.totalErrorMicros += errorMicros;
+    if (errorMicros > stats.maxErrorMicros) {
+        stats.maxErrorMicros = errorMicros;
+    }
+    uint8_t bucket = 0;
+    while (bucket < PhaseJitterStatistics::BUCKET_COUNT - 1 && errorMicros >= getPhaseJitterBucketLimit(bucket)) {
+        bucket++;
+    }
+    stats.buckets[bucket]++;
+}
+
+// 误差分布桶的上限（微秒）
+uint32_t MotorController::getPhaseJitterBucketLimit(uint8_t bucket) {
+    static const uint32_t limits[PhaseJitterStatistics::BUCKET_COUNT] = {
+        10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 50000, 0xFFFFFFFF
+    };
+    return bucket < PhaseJitterStatistics::BUCKET_COUNT ? limits[bucket] : 0xFFFFFFFF;
+}
+
+// 合并运行和停止阶段的误差统计
+PhaseJitterStatistics MotorController::getPhaseJitterStatistics() const {
+    const PhaseJitterStatistics& run = jitterStats[(uint8_t)MotorPhase::RUN];
+    const PhaseJitterStatistics& stop = jitterStats[(uint8_t)MotorPhase::STOP];
+    PhaseJitterStatistics merged = run;
+    if (stop.edges > 0 && (run.edges == 0 || stop.minErrorMicros < run.minErrorMicros)) {
+        merged.minErrorMicros = stop.minErrorMicros;
+    }
+    merged.edges += stop.edges;
+    merged.timerEdges += stop.timerEdges;
+    merged.totalErrorMicros += stop.totalErrorMicros;
+    if (stop.maxErrorMicros > merged.maxErrorMicros) {
+        merged.maxErrorMicros = stop.maxErrorMicros;
+    }
+    for (uint8_t bucket = 0; bucket < PhaseJitterStatistics::BUCKET_COUNT; bucket++) {
+        merged.buckets[bucket] += stop.buckets[bucket];
+    }
+    return merged;
+}
+
+// 获取指定阶段的误差统计
+const PhaseJitterStatistics& MotorController::getPhaseJitterStatistics(MotorPhase phase) const {
+    return jitterStats[(uint8_t)phase];
+}
+
+// 重置相位切换误差统计
+void MotorController::resetPhaseJitterStatistics() {
+    memset(jitterStats, 0, sizeof(jitterStats));
+}
+
+// 从分布桶计算摘要：p99取累计计数首次达到99%的桶的上限
+PhaseJitterSummary MotorController::summarizePhaseJitter(const PhaseJitterStatistics& stats) {
+    PhaseJitterSummary summary;
+    memset(&summary, 0, sizeof(summary));
+    if (stats.edges == 0) {
+        return summary;
+    }
+    
+    summary.count = stats.edges;
+    summary.minMicros = stats.minErrorMicros;
+    summary.maxMicros = stats.maxErrorMicros;
+    summary.meanMicros = (uint32_t)(stats.totalErrorMicros / stats.edges);
+    
+    uint32_t rank = (uint32_t)(((uint64_t)stats.edges * 99 + 99) / 100);
+    uint32_t cumulative = 0;
+    summary.p99Micros = stats.maxErrorMicros;
+    for (uint8_t bucket = 0; bucket < PhaseJitterStatistics::BUCKET_COUNT; bucket++) {
+        cumulative += stats.buckets[bucket];
+        if (cumulative >= rank) {
+            uint32_t limit = getPhaseJitterBucketLimit(bucket);
+            if (limit < summary.p99Micros) {
+                summary.p99Micros = limit;
+            }
+            break;
         }
+    }
+    return summary;
+}
+
+// 启用或禁用相位定时器
+void MotorController::setPhaseTimerEnabled(bool enabled) {
+    if (phaseTimerEnabled == enabled) {
+        return;
+    }
+    completePendingPhaseEdge();
+    phaseTimerEnabled = enabled;
+    
+    // 正在计时的阶段按新的方式处理；停止间隔不再自动进入下一循环时，定时器不能在到期时打开电机
+    bool phaseActive = (currentState == MotorControllerState::RUNNING && remainingRunTime > 0) ||
+                       (currentState == MotorControllerState::STOPPED && remainingStopTime > 0 &&
+                        isAutoCycleAllowed());
+    if (enabled && phaseActive) {
+        armPhaseTimer();
     } else {
-        // 更新剩余运行时间（毫秒）
-        remainingRunTime = targetDurationMs - elapsedMs;
+        cancelPhaseTimer();
+    }
+}
+
+// 相位定时器是否可用
+bool MotorController::isPhaseTimerActive() const {
+    return phaseTimerCreated && phaseTimerEnabled;
+}
+
+// 是否允许自动进入下一循环
+bool MotorController::isAutoCycleAllowed() const {
+    bool cyclesDone = currentConfig.cycleCount > 0 && cycleCount >= currentConfig.cycleCount;
+    return !cyclesDone && currentConfig.autoStart && !programFinished;
+}
+
+// 加载电机程序
+bool MotorController::loadProgram(const MotorProgram& newProgram) {
+    if (!newProgram.isCompiled()) {
+        setLastError("电机程序未编译");
+        return false;
+    }
+    
+    // 执行器引用当前程序，替换前先停止
+    if (programActive) {
+        stopProgram();
     }
+    program = newProgram;
+    LOG_TAG_INFO("MotorController", "已加载电机程序: %u条指令", program.getInstructionCount());
+    return true;
+}
+
+// 开始执行程序
+bool MotorController::startProgram() {
+    if (!isInitialized) {
+        setLastError("电机控制器未初始化");
+        return false;
+    }
+    if (!program.isCompiled()) {
+        setLastError("没有可执行的电机程序");
+        return false;
+    }
+    
+    // 暂停运行/停止循环：取消相位定时器，清空倒计时
+    cancelPhaseTimer();
+    clearPhaseAnchor();
+    phaseEdgePending = false;
+    remainingRunTime = 0;
+    remainingStopTime = 0;
+    
+    if (!programRunner.start(program, MonotonicClock::nowMillis())) {
+        setLastError("电机程序启动失败");
+        return false;
+    }
+    programActive = true;
+    programFinished = false;
+    
+    uint64_t totalMs = program.getTotalDurationMs();
+    if (totalMs == MotorProgram::INFINITE_DURATION) {
+        LOG_TAG_INFO("MotorController", "开始执行电机程序: %u条指令, 无限循环", program.getInstructionCount());
+    } else {
+        LOG_TAG_INFO("MotorController", "开始执行电机程序: %u条指令, 总时长%.1f秒",
+                     program.getInstructionCount(), totalMs / 1000.0);
+    }
+    applyProgramStep();
+    return true;
+}
+
+// 停止执行程序
+bool MotorController::stopProgram() {
+    if (!programActive) {
+        return false;
+    }
+    
+    abortProgram();
+    stopMotorInternal();
+    if (currentState != MotorControllerState::ERROR_STATE) {
+        // 停止后不自动进入运行/停止循环
+        programFinished = true;
+        setState(MotorControllerState::STOPPED);
+    }
+    LOG_TAG_INFO("MotorController", "电机程序已停止");
+    return true;
+}
+
+// 设置调速器设定值处理函数
+void MotorController::setProgramSetpointHandler(ProgramSetpointHandler handler) {
+    setpointHandler = handler;
+}
+
+// 程序执行：未到步骤截止时刻时只做一次比较
+void MotorController::handleProgram() {
+    if (programRunner.update(MonotonicClock::nowMillis())) {
+        applyProgramStep();
+    }
+}
+
+// 进入当前步骤：切换GPIO并下发调速器设定值；程序结束时停止电机
+void MotorController::applyProgramStep() {
+    const ProgramInstruction* step = programRunner.getCurrentStep();
+    if (!step) {
+        programActive = false;
+        programFinished = true;
+        stopMotorInternal();
+        if (currentState != MotorControllerState::ERROR_STATE) {
+            setState(MotorControllerState::STOPPED);
+        }
+        LOG_TAG_INFO("MotorController", "电机程序执行完成，共%lu个步骤", programRunner.getStepsExecuted());
+        return;
+    }
+    
+    LOG_TAG_DEBUG("MotorController", "程序步骤%u: 电机%s, %lu ms", programRunner.getCurrentIndex(),
+                  step->motorOn ? "开" : "关", step->durationMs);
+    // PWM输出方式下先应用设定值，缓启动直接以新的占空比为目标
+    if (step->setpoint.mask != 0 && pwmController) {
+        applyPWMSetpoint(step->setpoint);
+    }
+    if (step->motorOn) {
+        startMotorInternal();
+    } else {
+        stopMotorInternal();
+    }
+    if (currentState == MotorControllerState::ERROR_STATE) {
+        abortProgram();
+        return;
+    }
+    if (step->setpoint.mask != 0 && setpointHandler && !pwmController) {
+        setpointHandler(step->setpoint);
+    }
+    setState(step->motorOn ? MotorControllerState::RUNNING : MotorControllerState::STOPPED);
+}
+
+// 程序步骤的设定值作用于PWM输出（缓变时间同时作为缓启动和缓停止时间，不写入配置）
+void MotorController::applyPWMSetpoint(const ProgramSetpoint& setpoint) {
+    if (setpoint.mask & ProgramSetpoint::RAMP) {
+        uint32_t rampMs = (uint32_t)setpoint.rampTime * 100;
+        pwmController->setSoftTimes(rampMs, rampMs);
+    }
+    if (setpoint.mask & ProgramSetpoint::FREQUENCY) {
+        pwmController->setFrequency(setpoint.frequency);
+    }
+    if (setpoint.mask & ProgramSetpoint::DUTY) {
+        pwmController->setDutyCycle(setpoint.dutyCycle, MonotonicClock::nowMicros());
+    }
+}
+
+// 放弃程序（不改变GPIO），恢复运行/停止循环
+void MotorController::abortProgram() {
+    if (programActive) {
+        LOG_TAG_INFO("MotorController", "电机程序被中止");
+    }
+    programRunner.stop();
+    programActive = false;
+    programFinished = false;
 }
 
 // 处理停止中状态
 void MotorController::handleStoppingState() {
-    // 立即停止电机
+    // 立即停止电机；手动停止时停止间隔从此刻开始
     stopMotorInternal();
+    if (!hasPhaseAnchor) {
+        phaseAnchorMicros = MonotonicClock::nowMicros();
+        hasPhaseAnchor = true;
+    }
     // 发布电机停止事件
     EventManager::getInstance().publish(EventData(
         EventType::MOTOR_STOP,
-        "MotorController",
-        "电机停止，循环次数: " + String(cycleCount)
-    ));
+        EventSource::MOTOR_CONTROLLER,
+        "电机停止，循环次数: %ld"
+    ).withInts(cycleCount));
     
     setState(MotorControllerState::STOPPED);
 }
 
 // 处理启动中状态
 void MotorController::handleStartingState() {
-    // 启动电机
+    // 启动电机；手动启动时运行阶段从此刻开始
     startMotorInternal();
+    if (!hasPhaseAnchor) {
+        phaseAnchorMicros = MonotonicClock::nowMicros();
+        hasPhaseAnchor = true;
+    }
     // 发布电机启动事件
     EventManager::getInstance().publish(EventData(
         EventType::MOTOR_START,
-        "MotorController",
-        "电机启动，目标循环: " + String(currentConfig.cycleCount == 0 ? "无限" : String(currentConfig.cycleCount))
-    ));
+        EventSource::MOTOR_CONTROLLER,
+        currentConfig.cycleCount == 0 ? "电机启动，目标循环: 无限" : "电机启动，目标循环: %ld"
+    ).withInts(currentConfig.cycleCount));
     
     setState(MotorControllerState::RUNNING);
 }
 
 // 处理错误状态
 void MotorController::handleErrorState() {
-    // 确保电机停止
+    // 确保电机停止，定时器不再切换GPIO
+    cancelPhaseTimer();
+    clearPhaseAnchor();
     stopMotorInternal();
     
     // 可以在这里添加错误恢复逻辑
@@ -295,7 +797,7 @@ void MotorController::handleErrorState() {
 
 // 内部启动电机
 void MotorController::startMotorInternal() {
-    if (gpioDriver && gpioDriver->digitalWrite(MOTOR_PIN, MOTOR_ON)) {
+    if (writeMotorOutput(true, MonotonicClock::nowMicros())) {
         LOG_TAG_INFO("MotorController", "电机已启动");
     } else {
         setLastError("无法启动电机");
@@ -305,7 +807,7 @@ void MotorController::startMotorInternal() {
 
 // 内部停止电机
 void MotorController::stopMotorInternal() {
-    if (gpioDriver && gpioDriver->digitalWrite(MOTOR_PIN, MOTOR_OFF)) {
+    if (writeMotorOutput(false, MonotonicClock::nowMicros())) {
         LOG_TAG_INFO("MotorController", "电机已停止");
     } else {
         setLastError("无法停止电机");
@@ -313,40 +815,119 @@ void MotorController::stopMotorInternal() {
     }
 }
 
+// 按输出方式打开/关闭电机；PWM输出方式下从atMicros开始缓启动/缓停止
+bool MotorController::writeMotorOutput(bool on, uint64_t atMicros) {
+    if (pwmController) {
+        if (on) {
+            pwmController->start(atMicros);
+        } else {
+            pwmController->stop(atMicros);
+        }
+        return true;
+    }
+    return gpioDriver && gpioDriver->digitalWrite(MOTOR_PIN, on ? MOTOR_ON : MOTOR_OFF);
+}
+
+// 切换MOTOR_PIN的驱动方式，电机开关状态保持不变（切换到PWM时按缓启动时间恢复输出）
+bool MotorController::applyOutputMode(MotorOutputMode mode) {
+    bool usePWM = mode == MotorOutputMode::PWM;
+    if (usePWM == (pwmController != nullptr)) {
+        return true;
+    }
+    
+    if (usePWM) {
+        bool on = gpioDriver && gpioDriver->digitalRead(MOTOR_PIN) == MOTOR_ON;
+        std::unique_ptr<MotorPWMController> controller(new MotorPWMController());
+        pwmOutputEnabled = true;
+        if (!controller->begin(MOTOR_PIN, MOTOR_PWM_CHANNEL, currentConfig)) {
+            pwmOutputEnabled = false;
+            setLastError("PWM输出初始化失败");
+            return false;
+        }
+        pwmController = std::move(controller);
+        if (on) {
+            pwmController->start(MonotonicClock::nowMicros());
+        }
+        LOG_TAG_INFO("MotorController", "输出方式: PWM (%lu Hz, 占空比%u%%)",
+                     pwmController->getFrequency(), pwmController->getDutyCycle());
+        return true;
+    }
+    
+    // 释放LEDC后重新配置GPIO，直接切换到当前开关状态
+    bool on = pwmController->isRunning();
+    pwmController.reset();
+    pwmOutputEnabled = false;
+    if (!gpioDriver || !gpioDriver->init(MOTOR_PIN, OUTPUT, on ? MOTOR_ON : MOTOR_OFF)) {
+        setLastError("GPIO驱动初始化失败");
+        setState(MotorControllerState::ERROR_STATE);
+        return false;
+    }
+    LOG_TAG_INFO("MotorController", "输出方式: GPIO开关");
+    return true;
+}
+
+// 获取当前输出方式
+MotorOutputMode MotorController::getOutputMode() const {
+    return pwmController ? MotorOutputMode::PWM : MotorOutputMode::SWITCH;
+}
+
 // 更新配置
 void MotorController::updateConfig(const MotorConfig& config) {
     LOG_TAG_INFO("MotorController", "更新配置参数");
     
+    // 定时器已按旧配置切换了GPIO：先完成该阶段，新配置从下一阶段（或新的当前阶段）开始生效
+    completePendingPhaseEdge();
+    
     // 保存新配置
     MotorConfig oldConfig = currentConfig;
     currentConfig = config;
     
-    // 如果电机正在运行，根据新配置调整计时器（注意：内部使用毫秒）
-    if (currentState == MotorControllerState::RUNNING) {
-        uint32_t newRunTimeMs = currentConfig.runDuration * 1000;
+    // 输出方式和PWM参数立即生效（未初始化时由init()应用）
+    if (isInitialized) {
+        applyOutputMode(currentConfig.outputMode);
+        if (pwmController) {
+            pwmController->applyConfig(currentConfig, MonotonicClock::nowMicros());
+        }
+    }
+    
+    // 如果正在计时，按新配置的时长重新安排当前阶段的截止时间（起点不变，注意：内部使用毫秒）
+    if (currentState == MotorControllerState::RUNNING && remainingRunTime > 0) {
+        uint32_t newRunTimeMs = currentConfig.runDurationMs;
         if (remainingRunTime > newRunTimeMs) {
             remainingRunTime = newRunTimeMs;
         }
-    } else if (currentState == MotorControllerState::STOPPED) {
-        uint32_t newStopTimeMs = currentConfig.stopDuration * 1000;
+        schedulePhase(newRunTimeMs, true);
+    } else if (currentState == MotorControllerState::STOPPED && remainingStopTime > 0) {
+        uint32_t newStopTimeMs = currentConfig.stopDurationMs;
         if (remainingStopTime > newStopTimeMs) {
             remainingStopTime = newStopTimeMs;
         }
+        if (isAutoCycleAllowed()) {
+            schedulePhase(newStopTimeMs, false);
+        } else {
+            // 不再自动启动：定时器不能在到期时打开电机
+            cancelPhaseTimer();
+        }
     }
     
-    LOG_TAG_DEBUG("MotorController", "运行时间: %u -> %u 秒",
-                  oldConfig.runDuration, config.runDuration);
-    LOG_TAG_DEBUG("MotorController", "停止时间: %u -> %u 秒",
-                  oldConfig.stopDuration, config.stopDuration);
+    LOG_TAG_DEBUG("MotorController", "运行时间: %lu -> %lu ms",
+                  oldConfig.runDurationMs, config.runDurationMs);
+    LOG_TAG_DEBUG("MotorController", "停止时间: %lu -> %lu ms",
+                  oldConfig.stopDurationMs, config.stopDurationMs);
 }
 
 // 设置状态
 void MotorController::setState(MotorControllerState newState) {
     if (currentState != newState) {
+        // 进入错误状态时立即取消相位定时器，定时器中断不能在主循环处理错误之前打开电机
+        if (newState == MotorControllerState::ERROR_STATE) {
+            cancelPhaseTimer();
+            clearPhaseAnchor();
+        }
         LOG_TAG_INFO("MotorController", "状态切换: %d -> %d",
                      static_cast<int>(currentState), static_cast<int>(newState));
         currentState = newState;
-        stateStartTime = millis();
+        stateStartTime = MonotonicClock::nowMillis();
         
         // 更新系统状态
         updateSystemState();
@@ -367,12 +948,42 @@ MotorControllerState MotorController::getCurrentState() const {
 
 // 获取剩余运行时间（返回秒，用于BLE接口）
 uint32_t MotorController::getRemainingRunTime() const {
-    return remainingRunTime / 1000;  // 转换毫秒为秒
+    return getRemainingRunTimeMs() / 1000;  // 转换毫秒为秒
 }
 
 // 获取剩余停止时间（返回秒，用于BLE接口）
 uint32_t MotorController::getRemainingStopTime() const {
-    return remainingStopTime / 1000;  // 转换毫秒为秒
+    return getRemainingStopTimeMs() / 1000;  // 转换毫秒为秒
+}
+
+// 获取剩余运行时间（毫秒）
+uint32_t MotorController::getRemainingRunTimeMs() const {
+    if (currentState != MotorControllerState::RUNNING || programActive) {
+        return remainingRunTime;
+    }
+    return getLivePhaseRemainingMs(remainingRunTime);
+}
+
+// 获取剩余停止时间（毫秒）
+uint32_t MotorController::getRemainingStopTimeMs() const {
+    if (currentState != MotorControllerState::STOPPED || programActive || !isAutoCycleAllowed()) {
+        return remainingStopTime;
+    }
+    return getLivePhaseRemainingMs(remainingStopTime);
+}
+
+// 计时中的阶段剩余时间按截止时间实时计算：状态机只在阶段到期时处理，成员中保存的是上次处理时的值
+uint32_t MotorController::getLivePhaseRemainingMs(uint32_t lastRemainingMs) const {
+    if (lastRemainingMs == 0) {
+        return 0;
+    }
+    uint64_t now = MonotonicClock::nowMicros();
+    if (now >= phaseDeadlineMicros) {
+        return 1;  // 已到期、尚未处理：与状态机一致保持非0
+    }
+    // 毫秒，向上取整
+    uint64_t remainingMs = (phaseDeadlineMicros - now + 999) / 1000;
+    return remainingMs < lastRemainingMs ? (uint32_t)remainingMs : lastRemainingMs;
 }
 
 // 获取当前循环次数
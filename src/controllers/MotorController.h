@@ -4,9 +4,12 @@
 #include "../common/Config.h"
 #include "../drivers/GPIODriver.h"
 #include "../drivers/TimerDriver.h"
+#include "../controllers/MotorPWMController.h"
 #include "../controllers/ConfigManager.h"
 #include "../common/Logger.h"
 #include "../common/StateManager.h"
+#include "../common/MotorProgram.h"
+#include <functional>
 #include <memory>
 
 /**
@@ -21,6 +24,41 @@ enum class MotorControllerState {
     ERROR_STATE     // 错误状态
 };
 
+/**
+ * @brief 电机相位（运行阶段结束时关闭电机，停止阶段结束时打开电机）
+ */
+enum class MotorPhase : uint8_t {
+    RUN = 0,        // 运行阶段
+    STOP = 1        // 停止阶段
+};
+
+/**
+ * @brief 相位切换误差统计
+ * 误差为GPIO实际切换时刻与阶段截止时刻之差（微秒），按getPhaseJitterBucketLimit()的上限分桶
+ */
+struct PhaseJitterStatistics {
+    static const uint8_t BUCKET_COUNT = 12;
+    
+    uint32_t edges;                 // 相位切换次数
+    uint32_t timerEdges;            // 由定时器中断完成的切换次数
+    uint32_t minErrorMicros;        // 最小误差（edges为0时无效）
+    uint32_t maxErrorMicros;        // 最大误差
+    uint64_t totalErrorMicros;      // 累计误差
+    uint32_t buckets[BUCKET_COUNT]; // 误差分布
+};
+
+/**
+ * @brief 相位切换误差摘要（微秒）
+ * p99为第99百分位所在分布桶的上限，不超过最大误差
+ */
+struct PhaseJitterSummary {
+    uint32_t count;                 // 样本数
+    uint32_t minMicros;             // 最小误差
+    uint32_t maxMicros;             // 最大误差
+    uint32_t meanMicros;            // 平均误差
+    uint32_t p99Micros;             // 99%的切换误差不超过该值
+};
+
 /**
  * @brief 电机控制器类
  * 管理电机的运行状态、循环控制和参数管理
@@ -56,6 +94,58 @@ public:
      */
     void update();
     
+    /**
+     * @brief 距下一次需要调用update()的时间（微秒）
+     * @return 0表示状态机有待处理的切换；DeadlineScheduler::NO_DEADLINE表示在外部命令前无需更新
+     */
+    uint32_t getMicrosUntilNextUpdate() const;
+    
+    /**
+     * @brief 启用或禁用相位定时器
+     * 启用时运行/停止阶段的GPIO切换由一次性硬件定时器在截止时刻完成，主循环随后补做状态切换；
+     * 禁用时（或定时器不可用时）由update()检测到期后切换
+     * @param enabled 是否启用
+     */
+    void setPhaseTimerEnabled(bool enabled);
+    
+    /**
+     * @brief 相位定时器是否可用
+     * @return 已创建定时器且已启用
+     */
+    bool isPhaseTimerActive() const;
+    
+    /**
+     * @brief 获取运行和停止阶段合并后的相位切换误差统计
+     * @return 统计数据
+     */
+    PhaseJitterStatistics getPhaseJitterStatistics() const;
+    
+    /**
+     * @brief 获取指定阶段的相位切换误差统计
+     * @param phase 运行或停止阶段
+     * @return 统计数据引用
+     */
+    const PhaseJitterStatistics& getPhaseJitterStatistics(MotorPhase phase) const;
+    
+    /**
+     * @brief 重置运行和停止阶段的相位切换误差统计
+     */
+    void resetPhaseJitterStatistics();
+    
+    /**
+     * @brief 根据误差统计计算最小/最大/平均/p99摘要
+     * @param stats 误差统计
+     * @return 摘要，无样本时全部为0
+     */
+    static PhaseJitterSummary summarizePhaseJitter(const PhaseJitterStatistics& stats);
+    
+    /**
+     * @brief 获取误差分布桶的上限（微秒，不含）
+     * @param bucket 桶序号
+     * @return 上限，最后一个桶为0xFFFFFFFF
+     */
+    static uint32_t getPhaseJitterBucketLimit(uint8_t bucket);
+    
     /**
      * @brief 获取当前电机状态
      * @return 当前电机状态
@@ -76,14 +166,39 @@ public:
      */
     uint32_t getRemainingStopTime() const;
     
+    /**
+     * @brief 获取剩余运行时间（毫秒）
+     * @return 剩余运行时间，未在运行阶段计时时为0
+     */
+    uint32_t getRemainingRunTimeMs() const;
+    
+    /**
+     * @brief 获取剩余停止时间（毫秒）
+     * @return 剩余停止时间，未在停止间隔计时时为0
+     */
+    uint32_t getRemainingStopTimeMs() const;
+    
     /**
      * @brief 获取当前循环次数
      * @return 当前循环次数
      */
     uint32_t getCurrentCycleCount() const;
     
+    /**
+     * @brief 获取当前输出方式
+     * @return PWM输出已启用时为PWM，否则为SWITCH
+     */
+    MotorOutputMode getOutputMode() const;
+    
+    /**
+     * @brief 获取PWM调速输出
+     * @return PWM输出方式下有效，否则为nullptr
+     */
+    const MotorPWMController* getPWMController() const { return pwmController.get(); }
+    
     /**
      * @brief 更新配置参数
+     * 输出方式变化时切换MOTOR_PIN的驱动（GPIO开关/LEDC），电机开关状态保持不变
      * @param config 新配置
      */
     void updateConfig(const MotorConfig& config);
@@ -116,6 +231,60 @@ public:
      * @return 错误信息
      */
     const char* getLastError() const;
+    
+    /**
+     * @brief 程序步骤的调速器设定值处理函数（在主循环中调用）
+     */
+    typedef std::function<void(const ProgramSetpoint&)> ProgramSetpointHandler;
+    
+    /**
+     * @brief 加载电机程序（正在执行的程序会被停止）
+     * @param program 已编译的程序
+     * @return 加载是否成功
+     */
+    bool loadProgram(const MotorProgram& program);
+    
+    /**
+     * @brief 开始执行已加载的程序
+     * 执行期间由程序控制电机开/关，运行/停止循环暂停；程序结束后电机保持停止，
+     * 直到startMotor()/stopMotor()恢复运行/停止循环
+     * @return 启动是否成功
+     */
+    bool startProgram();
+    
+    /**
+     * @brief 停止执行程序并关闭电机
+     * @return 是否有程序在执行
+     */
+    bool stopProgram();
+    
+    /**
+     * @brief 是否正在执行程序
+     */
+    bool isProgramRunning() const { return programActive; }
+    
+    /**
+     * @brief 获取已加载的程序
+     */
+    const MotorProgram& getProgram() const { return program; }
+    
+    /**
+     * @brief 获取程序执行器（当前步骤、步骤开始时刻等）
+     */
+    const MotorProgramRunner& getProgramRunner() const { return programRunner; }
+    
+    /**
+     * @brief 设置程序步骤的调速器设定值处理函数
+     * PWM输出方式下设定值直接作用于PWM输出，不调用处理函数
+     * @param handler 处理函数，步骤带设定值时调用
+     */
+    void setProgramSetpointHandler(ProgramSetpointHandler handler);
+    
+    /**
+     * @brief 系统状态变更处理（由StateManager监听器调用）
+     * @param event 状态变更事件
+     */
+    void onSystemStateChanged(const StateChangeEvent& event);
 
 private:
     /**
@@ -148,25 +317,73 @@ private:
     // 辅助方法
     void startMotorInternal();
     void stopMotorInternal();
+    bool writeMotorOutput(bool on, uint64_t atMicros);
+    bool applyOutputMode(MotorOutputMode mode);
+    uint32_t getMicrosUntilStateUpdate() const;
     void updateTimers();
     void checkStateTransitions();
     void setState(MotorControllerState newState);
     void setLastError(const char* error);
-    void onSystemStateChanged(const StateChangeEvent& event);
+    
+    // 相位定时
+    void beginPhase(uint32_t durationMs, bool running);
+    void schedulePhase(uint32_t durationMs, bool running);
+    bool isPhaseDue(uint64_t now) const;
+    uint32_t getMicrosUntilPhaseDue() const;
+    uint32_t getLivePhaseRemainingMs(uint32_t lastRemainingMs) const;
+    bool isAutoCycleAllowed() const;
+    uint64_t finishPhase(uint64_t now, MotorPhase phase);
+    void completePendingPhaseEdge();
+    void armPhaseTimer();
+    void cancelPhaseTimer();
+    void clearPhaseAnchor();
+    void recordPhaseJitter(MotorPhase phase, uint32_t errorMicros, bool byTimer);
+    void IRAM_ATTR onPhaseTimer();
     void updateSystemState();
     
+    // 程序执行
+    void handleProgram();
+    void applyProgramStep();
+    void applyPWMSetpoint(const ProgramSetpoint& setpoint);
+    void abortProgram();
+    
     // 成员变量
     MotorControllerState currentState;        // 当前状态
     MotorConfig currentConfig;      // 当前配置
-    std::unique_ptr<GPIODriver> gpioDriver;   // GPIO驱动（智能指针）
     TimerDriver& timer;             // 定时器驱动
+    std::unique_ptr<GPIODriver> gpioDriver;   // GPIO驱动（智能指针）
+    std::unique_ptr<MotorPWMController> pwmController; // PWM调速输出（仅PWM输出方式下存在）
+    bool pwmOutputEnabled;          // MOTOR_PIN由LEDC驱动，定时器中断不切换GPIO
     
     // 计时相关
-    uint32_t stateStartTime;        // 状态开始时间
+    uint64_t stateStartTime;        // 状态开始时间（MonotonicClock毫秒）
     uint32_t remainingRunTime;      // 剩余运行时间
     uint32_t remainingStopTime;     // 剩余停止时间
     uint32_t cycleCount;            // 循环次数
     
+    // 相位定时（MonotonicClock微秒）
+    static const TimerDriver::TimerID PHASE_TIMER = TimerDriver::TIMER_1;
+    uint64_t phaseStartMicros;      // 当前阶段开始时刻
+    uint64_t phaseDeadlineMicros;   // 当前阶段截止时刻
+    uint64_t phaseAnchorMicros;     // 上一次相位切换的时刻，作为下一阶段的起点
+    bool hasPhaseAnchor;            // phaseAnchorMicros是否有效
+    bool phaseTimerCreated;         // 定时器创建成功
+    bool phaseTimerEnabled;         // 是否使用定时器切换
+    bool phaseTimerArmed;           // 定时器已为当前阶段启动
+    bool phaseTimerDeferred;        // 截止时刻超出定时器单次范围，接近时再启动
+    bool phaseEdgeWrites;           // 到期时定时器是否切换GPIO
+    uint8_t phaseEdgeLevel;         // 到期时写入的电平
+    volatile bool phaseEdgePending; // 定时器已切换GPIO，等待主循环确认
+    volatile uint64_t phaseEdgeMicros; // 定时器切换GPIO的时刻
+    PhaseJitterStatistics jitterStats[2]; // 按MotorPhase索引
+    
+    // 程序执行
+    MotorProgram program;           // 已加载的程序
+    MotorProgramRunner programRunner; // 程序执行器
+    ProgramSetpointHandler setpointHandler; // 调速器设定值处理函数
+    bool programActive;             // 正在执行程序
+    bool programFinished;           // 程序已结束，保持停止直到收到启停命令
+    
     // 状态标志
     bool isInitialized;             // 是否已初始化
     bool configUpdated;             // 配置是否已更新
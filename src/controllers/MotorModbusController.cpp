@@ -1,21 +1,70 @@
 #include "MotorModbusController.h"
+#include "../common/MonotonicClock.h"
 
-MotorModbusController::MotorModbusController() : _motorAddress(0x01) {
+MotorModbusController::MotorModbusController()
+    : _bus(new ModbusBusMaster()), _ownsBus(true), _slaveRegistered(false),
+      _cache(REG_MODULE_ADDRESS, CACHED_REGISTER_COUNT, CONFIG_CACHE_TTL_MS), _motorAddress(MODBUS_SLAVE_ADDRESS),
+      _writeMutex(nullptr), _stagedMask(0), _stagedSinceMs(0), _stagedCallbackCount(0),
+      _writeWindowMs(WRITE_COMBINE_WINDOW_MS), _outputOverridden(false) {
+    init();
+}
+
+MotorModbusController::MotorModbusController(ModbusBusMaster& bus)
+    : _bus(&bus), _ownsBus(false), _slaveRegistered(false),
+      _cache(REG_MODULE_ADDRESS, CACHED_REGISTER_COUNT, CONFIG_CACHE_TTL_MS), _motorAddress(MODBUS_SLAVE_ADDRESS),
+      _writeMutex(nullptr), _stagedMask(0), _stagedSinceMs(0), _stagedCallbackCount(0),
+      _writeWindowMs(WRITE_COMBINE_WINDOW_MS), _outputOverridden(false) {
+    init();
+}
+
+void MotorModbusController::init() {
+    // 运行状态、频率和占空比可能被外接开关或0-10V输入改变，有效期更短
+    _cache.setTTL(REG_RUN_STATUS, 4, STATUS_CACHE_TTL_MS);
+    _writeMutex = xSemaphoreCreateMutex();
+    memset(_stagedValues, 0, sizeof(_stagedValues));
+    memset(&_writeStats, 0, sizeof(_writeStats));
+    for (WriteBatch& batch : _writeBatches) {
+        batch.inUse = false;
+        batch.callbackCount = 0;
+        batch.registerMask = 0;
+    }
+    _outputRamp.setEmitInterval((uint32_t)MODBUS_SETPOINT_EMIT_INTERVAL_MS * 1000);
 }
 
 MotorModbusController::~MotorModbusController() {
+    if (_writeMutex != nullptr) {
+        vSemaphoreDelete(_writeMutex);
+        _writeMutex = nullptr;
+    }
+    if (_ownsBus) {
+        delete _bus;
+    } else if (_slaveRegistered) {
+        _bus->removeSlave(_motorAddress);
+    }
+    _bus = nullptr;
 }
 
-bool MotorModbusController::begin(uint8_t motorAddress) {
+bool MotorModbusController::begin(uint8_t motorAddress, uint8_t rxPin, uint8_t txPin, uint32_t baudRate) {
+    if (_slaveRegistered) {
+        _bus->removeSlave(_motorAddress);
+    }
     _motorAddress = motorAddress;
-    return _modbus.begin(8, 9, 9600, motorAddress);
+    _cache.invalidateAll();
+    
+    // 共享总线由其所有者初始化
+    if (_ownsBus && !_bus->begin(rxPin, txPin, baudRate)) {
+        return false;
+    }
+    // 从站已由总线所有者添加时沿用其轮询配置
+    _slaveRegistered = _bus->addSlave(motorAddress);
+    return true;
 }
 
 bool MotorModbusController::getConfig(MotorConfig& config) {
     uint16_t values[8];
     
     // 读取所有配置寄存器
-    if (!_modbus.readHoldingRegisters(REG_MODULE_ADDRESS, 8, values)) {
+    if (!readRegisters(REG_MODULE_ADDRESS, 8, values)) {
         return false;
     }
     
@@ -36,28 +85,18 @@ bool MotorModbusController::getAllConfig(AllConfig& config) {
     uint16_t values[11];
     
     // 从寄存器 0x0001 开始读取 11 个寄存器
-    if (!_modbus.readHoldingRegisters(REG_EXTERNAL_SWITCH, 11, values)) {
+    if (!readRegisters(REG_EXTERNAL_SWITCH, 11, values)) {
         return false;
     }
     
-    // 填充 AllConfig 结构体
-    config.externalSwitch = (values[0] == 1);    // 0x0001
-    config.analogControl = (values[1] == 1);     // 0x0002
-    config.powerOnState = (values[2] == 1);      // 0x0003
-    config.minOutput = (uint8_t)values[3];       // 0x0004
-    config.maxOutput = (uint8_t)values[4];       // 0x0005
-    config.softStartTime = values[5];            // 0x0006
-    config.softStopTime = values[6];             // 0x0007
-    config.isRunning = (values[7] == 1);         // 0x0008
-    config.frequency = ((uint32_t)values[8] << 16) | values[9]; // 0x0009, 0x000A
-    config.dutyCycle = (uint8_t)values[10];      // 0x000B
+    decodeAllConfig(values, config);
     
     return true;
 }
 
 bool MotorModbusController::getModuleAddress(uint8_t& address) {
     uint16_t value;
-    if (_modbus.readHoldingRegisters(REG_MODULE_ADDRESS, 1, &value)) {
+    if (readRegisters(REG_MODULE_ADDRESS, 1, &value)) {
         address = (uint8_t)value;
         return true;
     }
@@ -66,7 +105,7 @@ bool MotorModbusController::getModuleAddress(uint8_t& address) {
 
 bool MotorModbusController::getExternalSwitch(bool& enabled) {
     uint16_t value;
-    if (_modbus.readHoldingRegisters(REG_EXTERNAL_SWITCH, 1, &value)) {
+    if (readRegisters(REG_EXTERNAL_SWITCH, 1, &value)) {
         enabled = (value == 1);
         return true;
     }
@@ -75,7 +114,7 @@ bool MotorModbusController::getExternalSwitch(bool& enabled) {
 
 bool MotorModbusController::getAnalogControl(bool& enabled) {
     uint16_t value;
-    if (_modbus.readHoldingRegisters(REG_0_10V_CONTROL, 1, &value)) {
+    if (readRegisters(REG_0_10V_CONTROL, 1, &value)) {
         enabled = (value == 1);
         return true;
     }
@@ -84,7 +123,7 @@ bool MotorModbusController::getAnalogControl(bool& enabled) {
 
 bool MotorModbusController::getPowerOnState(bool& state) {
     uint16_t value;
-    if (_modbus.readHoldingRegisters(REG_POWER_ON_STATE, 1, &value)) {
+    if (readRegisters(REG_POWER_ON_STATE, 1, &value)) {
         state = (value == 1);
         return true;
     }
@@ -93,7 +132,7 @@ bool MotorModbusController::getPowerOnState(bool& state) {
 
 bool MotorModbusController::getOutputLimits(uint8_t& minOutput, uint8_t& maxOutput) {
     uint16_t values[2];
-    if (_modbus.readHoldingRegisters(REG_MIN_OUTPUT, 2, values)) {
+    if (readRegisters(REG_MIN_OUTPUT, 2, values)) {
         minOutput = (uint8_t)values[0];
         maxOutput = (uint8_t)values[1];
         return true;
@@ -103,7 +142,7 @@ bool MotorModbusController::getOutputLimits(uint8_t& minOutput, uint8_t& maxOutp
 
 bool MotorModbusController::getSoftTimes(uint16_t& startTime, uint16_t& stopTime) {
     uint16_t values[2];
-    if (_modbus.readHoldingRegisters(REG_SOFT_START_TIME, 2, values)) {
+    if (readRegisters(REG_SOFT_START_TIME, 2, values)) {
         startTime = values[0];
         stopTime = values[1];
         return true;
@@ -123,7 +162,7 @@ bool MotorModbusController::setConfig(const MotorConfig& config) {
         config.softStopTime
     };
     
-    return _modbus.writeMultipleRegisters(REG_MODULE_ADDRESS, 8, values);
+    return writeRegisters(REG_MODULE_ADDRESS, 8, values);
 }
 
 bool MotorModbusController::setAllConfig(const AllConfig& config, bool setRunning) {
@@ -131,50 +170,43 @@ bool MotorModbusController::setAllConfig(const AllConfig& config, bool setRunnin
     // 从 REG_EXTERNAL_SWITCH (0x0001) 开始，共 11 个寄存器
     uint16_t values[11];
     
-    // 填充配置值
-    values[0] = config.externalSwitch ? 1 : 0;    // REG_EXTERNAL_SWITCH (0x0001)
-    values[1] = config.analogControl ? 1 : 0;     // REG_0_10V_CONTROL (0x0002)
-    values[2] = config.powerOnState ? 1 : 0;      // REG_POWER_ON_STATE (0x0003)
-    values[3] = config.minOutput;                // REG_MIN_OUTPUT (0x0004)
-    values[4] = config.maxOutput;                // REG_MAX_OUTPUT (0x0005)
-    values[5] = config.softStartTime;            // REG_SOFT_START_TIME (0x0006)
-    values[6] = config.softStopTime;             // REG_SOFT_STOP_TIME (0x0007)
-    values[7] = config.isRunning ? 1 : 0;        // REG_RUN_STATUS (0x0008) - 只有在 setRunning 为 true 时才设置
-    values[8] = (config.frequency >> 16) & 0xFFFF; // REG_FREQ_HIGH (0x0009)
-    values[9] = config.frequency & 0xFFFF;       // REG_FREQ_LOW (0x000A)
-    values[10] = config.dutyCycle;               // REG_DUTY_CYCLE (0x000B)
+    encodeAllConfig(config, values);
     
     // 如果不设置运行状态，则不写入运行状态寄存器
     if (!setRunning) {
         // 只写入前7个寄存器（0x0001-0x0007），不包括运行状态
-        if (!_modbus.writeMultipleRegisters(REG_EXTERNAL_SWITCH, 7, values)) {
+        if (!writeRegisters(REG_EXTERNAL_SWITCH, 7, values)) {
             return false;
         }
         
         // 然后写入频率和占空比寄存器（0x0009-0x000B）
         uint16_t freqDutyValues[3] = {values[8], values[9], values[10]};
-        return _modbus.writeMultipleRegisters(REG_FREQ_HIGH, 3, freqDutyValues);
+        return writeRegisters(REG_FREQ_HIGH, 3, freqDutyValues);
     } else {
         // 设置所有寄存器，包括运行状态
-        return _modbus.writeMultipleRegisters(REG_EXTERNAL_SWITCH, 11, values);
+        return writeRegisters(REG_EXTERNAL_SWITCH, 11, values);
     }
 }
 
 bool MotorModbusController::setModuleAddress(uint8_t address) {
     if (address > 255) address = 255;
-    return _modbus.writeSingleRegister(REG_MODULE_ADDRESS, address);
+    uint16_t value = address;
+    return writeRegisters(REG_MODULE_ADDRESS, 1, &value);
 }
 
 bool MotorModbusController::setExternalSwitch(bool enabled) {
-    return _modbus.writeSingleRegister(REG_EXTERNAL_SWITCH, enabled ? 1 : 0);
+    uint16_t value = enabled ? 1 : 0;
+    return writeRegisters(REG_EXTERNAL_SWITCH, 1, &value);
 }
 
 bool MotorModbusController::setAnalogControl(bool enabled) {
-    return _modbus.writeSingleRegister(REG_0_10V_CONTROL, enabled ? 1 : 0);
+    uint16_t value = enabled ? 1 : 0;
+    return writeRegisters(REG_0_10V_CONTROL, 1, &value);
 }
 
 bool MotorModbusController::setPowerOnState(bool state) {
-    return _modbus.writeSingleRegister(REG_POWER_ON_STATE, state ? 1 : 0);
+    uint16_t value = state ? 1 : 0;
+    return writeRegisters(REG_POWER_ON_STATE, 1, &value);
 }
 
 bool MotorModbusController::setOutputLimits(uint8_t minOutput, uint8_t maxOutput) {
@@ -183,25 +215,27 @@ bool MotorModbusController::setOutputLimits(uint8_t minOutput, uint8_t maxOutput
     if (maxOutput > 100) maxOutput = 100;
     
     uint16_t values[2] = {minOutput, maxOutput};
-    return _modbus.writeMultipleRegisters(REG_MIN_OUTPUT, 2, values);
+    return writeRegisters(REG_MIN_OUTPUT, 2, values);
 }
 
 bool MotorModbusController::setSoftTimes(uint16_t startTime, uint16_t stopTime) {
     uint16_t values[2] = {startTime, stopTime};
-    return _modbus.writeMultipleRegisters(REG_SOFT_START_TIME, 2, values);
+    return writeRegisters(REG_SOFT_START_TIME, 2, values);
 }
 
 bool MotorModbusController::start() {
-    return _modbus.writeSingleRegister(REG_RUN_STATUS, 1);
+    uint16_t value = 1;
+    return writeRegisters(REG_RUN_STATUS, 1, &value);
 }
 
 bool MotorModbusController::stop() {
-    return _modbus.writeSingleRegister(REG_RUN_STATUS, 0);
+    uint16_t value = 0;
+    return writeRegisters(REG_RUN_STATUS, 1, &value);
 }
 
 bool MotorModbusController::getRunStatus(bool& running) {
     uint16_t value;
-    if (_modbus.readHoldingRegisters(REG_RUN_STATUS, 1, &value)) {
+    if (readRegisters(REG_RUN_STATUS, 1, &value)) {
         running = (value == 1);
         return true;
     }
@@ -212,12 +246,12 @@ bool MotorModbusController::setFrequency(uint32_t frequency) {
     uint16_t freqHigh = (frequency >> 16) & 0xFFFF;
     uint16_t freqLow = frequency & 0xFFFF;
     uint16_t values[2] = {freqHigh, freqLow};
-    return _modbus.writeMultipleRegisters(REG_FREQ_HIGH, 2, values);
+    return writeRegisters(REG_FREQ_HIGH, 2, values);
 }
 
 bool MotorModbusController::getFrequency(uint32_t& frequency) {
     uint16_t values[2];
-    if (_modbus.readHoldingRegisters(REG_FREQ_HIGH, 2, values)) {
+    if (readRegisters(REG_FREQ_HIGH, 2, values)) {
         frequency = ((uint32_t)values[0] << 16) | values[1];
         return true;
     }
@@ -226,12 +260,13 @@ bool MotorModbusController::getFrequency(uint32_t& frequency) {
 
 bool MotorModbusController::setDutyCycle(uint8_t duty) {
     if (duty > 100) duty = 100;
-    return _modbus.writeSingleRegister(REG_DUTY_CYCLE, duty);
+    uint16_t value = duty;
+    return writeRegisters(REG_DUTY_CYCLE, 1, &value);
 }
 
 bool MotorModbusController::getDutyCycle(uint8_t& duty) {
     uint16_t value;
-    if (_modbus.readHoldingRegisters(REG_DUTY_CYCLE, 1, &value)) {
+    if (readRegisters(REG_DUTY_CYCLE, 1, &value)) {
         duty = (uint8_t)value;
         return true;
     }
@@ -242,19 +277,491 @@ bool MotorModbusController::setOutput(uint32_t frequency, uint8_t duty) {
     uint16_t freqHigh = (frequency >> 16) & 0xFFFF;
     uint16_t freqLow = frequency & 0xFFFF;
     uint16_t values[3] = {freqHigh, freqLow, duty};
-    return _modbus.writeMultipleRegisters(REG_FREQ_HIGH, 3, values);
+    return writeRegisters(REG_FREQ_HIGH, 3, values);
 }
 
 bool MotorModbusController::getOutput(uint32_t& frequency, uint8_t& duty) {
     uint16_t values[3];
-    if (_modbus.readHoldingRegisters(REG_RUN_STATUS, 3, values)) {
-        frequency = ((uint32_t)values[1] << 16) | values[2];
-        duty = (uint8_t)values[3];
+    if (readRegisters(REG_FREQ_HIGH, 3, values)) {
+        frequency = ((uint32_t)values[0] << 16) | values[1];
+        duty = (uint8_t)values[2];
         return true;
     }
     return false;
 }
 
 String MotorModbusController::getLastError() const {
-    return _modbus.getLastErrorString();
+    return _bus->getDriver().getLastErrorString();
+}
+
+bool MotorModbusController::getCachedAllConfig(AllConfig& config) {
+    uint16_t values[11];
+    if (!_cache.lookup(REG_EXTERNAL_SWITCH, 11, values, millis())) {
+        return false;
+    }
+    
+    decodeAllConfig(values, config);
+    return true;
+}
+
+bool MotorModbusController::requestAllConfig(AllConfigCallback callback) {
+    // 只读取过期的寄存器区间；全部新鲜时视为显式刷新，整段重读
+    uint16_t spanAddress = REG_EXTERNAL_SWITCH;
+    uint16_t spanQuantity = 11;
+    if (!_cache.getStaleSpan(REG_EXTERNAL_SWITCH, 11, millis(), spanAddress, spanQuantity)) {
+        spanAddress = REG_EXTERNAL_SWITCH;
+        spanQuantity = 11;
+    }
+    
+    ModbusRegisterCache* cache = &_cache;
+    return _bus->submitRead(_motorAddress, spanAddress, spanQuantity, ModbusPriority::BACKGROUND,
+        [cache, spanAddress, spanQuantity, callback](const ModbusResult& result) {
+            AllConfig config = {};
+            bool success = result.success;
+            if (success) {
+                uint16_t values[11];
+                cache->storeRead(spanAddress, result.quantity, result.values, millis());
+                success = cache->copy(REG_EXTERNAL_SWITCH, 11, values);
+                decodeAllConfig(values, config);
+            } else {
+                // 失败时result.quantity为0，按请求的区间作废
+                cache->invalidate(spanAddress, spanQuantity);
+            }
+            if (callback) {
+                callback(success, config, result.elapsedMs);
+            }
+        });
+}
+
+bool MotorModbusController::requestSetAllConfig(const AllConfig& config, bool setRunning, CompletionCallback callback) {
+    uint16_t values[11];
+    encodeAllConfig(config, values);
+    
+    if (setRunning) {
+        return stageWrite(REG_EXTERNAL_SWITCH, 11, values, callback);
+    }
+    
+    // 跳过运行状态寄存器，两段合并到同一批次
+    if (!stageWrite(REG_EXTERNAL_SWITCH, 7, values, nullptr)) {
+        return false;
+    }
+    return stageWrite(REG_FREQ_HIGH, 3, &values[8], callback);
+}
+
+bool MotorModbusController::requestStart(CompletionCallback callback) {
+    uint16_t value = 1;
+    return submitWrite(REG_RUN_STATUS, 1, &value, ModbusPriority::URGENT, callback);
+}
+
+bool MotorModbusController::requestStop(CompletionCallback callback) {
+    uint16_t value = 0;
+    return submitWrite(REG_RUN_STATUS, 1, &value, ModbusPriority::URGENT, callback);
+}
+
+bool MotorModbusController::requestFrequency(uint32_t frequency, CompletionCallback callback) {
+    uint16_t values[2] = {(uint16_t)((frequency >> 16) & 0xFFFF), (uint16_t)(frequency & 0xFFFF)};
+    return stageWrite(REG_FREQ_HIGH, 2, values, callback);
+}
+
+bool MotorModbusController::requestDutyCycle(uint8_t duty, CompletionCallback callback) {
+    if (duty > 100) duty = 100;
+    uint16_t value = duty;
+    return stageWrite(REG_DUTY_CYCLE, 1, &value, callback);
+}
+
+bool MotorModbusController::requestOutput(uint32_t frequency, uint8_t duty, CompletionCallback callback) {
+    if (duty > 100) duty = 100;
+    uint16_t values[3] = {(uint16_t)((frequency >> 16) & 0xFFFF), (uint16_t)(frequency & 0xFFFF), duty};
+    return stageWrite(REG_FREQ_HIGH, 3, values, callback);
+}
+
+bool MotorModbusController::requestOutputLimits(uint8_t minOutput, uint8_t maxOutput, CompletionCallback callback) {
+    if (minOutput > 50) minOutput = 50;
+    if (maxOutput < 60) maxOutput = 60;
+    if (maxOutput > 100) maxOutput = 100;
+    
+    uint16_t values[2] = {minOutput, maxOutput};
+    return stageWrite(REG_MIN_OUTPUT, 2, values, callback);
+}
+
+bool MotorModbusController::requestSoftTimes(uint16_t startTime, uint16_t stopTime, CompletionCallback callback) {
+    uint16_t values[2] = {startTime, stopTime};
+    return stageWrite(REG_SOFT_START_TIME, 2, values, callback);
+}
+
+void MotorModbusController::update() {
+    updateOutputRamp();
+    
+    bool due = false;
+    if (_writeMutex != nullptr && xSemaphoreTake(_writeMutex, portMAX_DELAY) == pdTRUE) {
+        bool staged = _stagedMask != 0 || _stagedCallbackCount > 0;
+        due = staged && (uint32_t)(millis() - _stagedSinceMs) >= _writeWindowMs;
+        xSemaphoreGive(_writeMutex);
+    }
+    
+    if (due) {
+        flushStagedWrites();
+    }
+    if (_ownsBus) {
+        _bus->update();
+    }
+}
+
+bool MotorModbusController::hasPendingWork() {
+    bool staged = false;
+    if (_writeMutex != nullptr && xSemaphoreTake(_writeMutex, portMAX_DELAY) == pdTRUE) {
+        staged = _stagedMask != 0 || _stagedCallbackCount > 0;
+        xSemaphoreGive(_writeMutex);
+    }
+    
+    return staged || !_bus->getQueue().isIdle();
+}
+
+void MotorModbusController::flushWrites() {
+    flushStagedWrites();
+}
+
+bool MotorModbusController::rampOutput(uint32_t frequency, uint8_t duty, uint32_t durationMs) {
+    return startOutputRamp(true, frequency, true, duty, durationMs);
+}
+
+bool MotorModbusController::rampFrequency(uint32_t frequency, uint32_t durationMs) {
+    return startOutputRamp(true, frequency, false, 0, durationMs);
+}
+
+bool MotorModbusController::rampDutyCycle(uint8_t duty, uint32_t durationMs) {
+    return startOutputRamp(false, 0, true, duty, durationMs);
+}
+
+uint32_t MotorModbusController::getMicrosUntilRampUpdate() const {
+    return _outputRamp.getMicrosUntilNextEmit(MonotonicClock::nowMicros());
+}
+
+bool MotorModbusController::startOutputRamp(bool setFrequency, uint32_t frequency, bool setDuty, uint8_t duty,
+                                            uint32_t durationMs) {
+    if (duty > 100) duty = 100;
+    // 先处理在此之前的直接写入，避免斜坡从被覆盖的旧轨迹继续
+    updateOutputRamp();
+    
+    // 斜坡空闲时以调速器当前输出（缓存中新鲜的值）为起点，进行中时从当前轨迹位置继续
+    uint16_t values[3];
+    uint32_t now = millis();
+    if (!_outputRamp.isBusy() && _cache.getFresh(REG_FREQ_HIGH, values[0], now) &&
+        _cache.getFresh(REG_FREQ_LOW, values[1], now) && _cache.getFresh(REG_DUTY_CYCLE, values[2], now)) {
+        SetpointRamp::Setpoint current;
+        current.frequency = ((uint32_t)values[0] << 16) | values[1];
+        current.dutyCycle = (uint8_t)values[2];
+        _outputRamp.reset(current);
+    }
+    // 起点未知时未给出的字段也未知，只能直接写入
+    if (!_outputRamp.hasValue() && !setFrequency) {
+        return requestDutyCycle(duty);
+    }
+    if (!_outputRamp.hasValue() && !setDuty) {
+        return requestFrequency(frequency);
+    }
+    
+    SetpointRamp::Setpoint target = _outputRamp.getTarget();
+    if (setFrequency) {
+        target.frequency = frequency;
+    }
+    if (setDuty) {
+        target.dutyCycle = duty;
+    }
+    _outputRamp.start(target, (uint64_t)durationMs * 1000, MonotonicClock::nowMicros());
+    return true;
+}
+
+void MotorModbusController::updateOutputRamp() {
+    bool overridden = false;
+    if (_writeMutex != nullptr && xSemaphoreTake(_writeMutex, portMAX_DELAY) == pdTRUE) {
+        overridden = _outputOverridden;
+        _outputOverridden = false;
+        xSemaphoreGive(_writeMutex);
+    }
+    if (overridden) {
+        _outputRamp.clear();
+    }
+    
+    SetpointRamp::Setpoint setpoint;
+    if (!_outputRamp.poll(MonotonicClock::nowMicros(), setpoint)) {
+        return;
+    }
+    // 经写合并暂存；写入完成（成功或失败）前不会输出下一个值
+    uint16_t values[3] = {(uint16_t)((setpoint.frequency >> 16) & 0xFFFF), (uint16_t)(setpoint.frequency & 0xFFFF),
+                          setpoint.dutyCycle};
+    SetpointRamp* ramp = &_outputRamp;
+    if (!stageWrite(REG_FREQ_HIGH, 3, values, [ramp](bool success) { ramp->acknowledge(success); }, true)) {
+        _outputRamp.acknowledge(false);
+    }
+}
+
+bool MotorModbusController::touchesOutput(uint16_t address, uint16_t quantity) {
+    return address <= REG_DUTY_CYCLE && address + quantity > REG_FREQ_HIGH;
+}
+
+bool MotorModbusController::stageWrite(uint16_t address, uint16_t quantity, const uint16_t* values,
+                                       CompletionCallback callback, bool fromRamp) {
+    if (quantity == 0 || (uint32_t)address + quantity > CACHED_REGISTER_COUNT) {
+        return false;
+    }
+    if (_writeMutex == nullptr || xSemaphoreTake(_writeMutex, portMAX_DELAY) != pdTRUE) {
+        return false;
+    }
+    
+    if (callback && _stagedCallbackCount >= MAX_STAGED_CALLBACKS) {
+        xSemaphoreGive(_writeMutex);
+        return false;
+    }
+    
+    // 窗口从批次中第一次写入开始计时，持续写入也不会无限推迟刷新
+    if (_stagedMask == 0 && _stagedCallbackCount == 0) {
+        _stagedSinceMs = millis();
+    }
+    for (uint16_t i = 0; i < quantity; i++) {
+        _stagedValues[address + i] = values[i];
+        _stagedMask |= (1 << (address + i));
+    }
+    if (callback) {
+        _stagedCallbacks[_stagedCallbackCount++] = callback;
+    }
+    if (!fromRamp && touchesOutput(address, quantity)) {
+        _outputOverridden = true;
+    }
+    _writeStats.stagedRegisters += quantity;
+    
+    xSemaphoreGive(_writeMutex);
+    return true;
+}
+
+void MotorModbusController::flushStagedWrites() {
+    // 预先分配的批次槽位，不在每次刷新时分配堆内存；全部在途时推迟刷新，暂存的写入保留到下一次
+    uint8_t index = 0;
+    while (index < MAX_WRITE_BATCHES && _writeBatches[index].inUse) {
+        index++;
+    }
+    if (index == MAX_WRITE_BATCHES) {
+        return;
+    }
+    WriteBatch& batch = _writeBatches[index];
+    uint16_t values[CACHED_REGISTER_COUNT];
+    uint16_t dirtyMask;
+    
+    if (_writeMutex == nullptr || xSemaphoreTake(_writeMutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+    dirtyMask = _stagedMask;
+    memcpy(values, _stagedValues, sizeof(values));
+    batch.callbackCount = _stagedCallbackCount;
+    for (uint8_t i = 0; i < _stagedCallbackCount; i++) {
+        batch.callbacks[i] = std::move(_stagedCallbacks[i]);
+        _stagedCallbacks[i] = nullptr;
+    }
+    _stagedMask = 0;
+    _stagedCallbackCount = 0;
+    xSemaphoreGive(_writeMutex);
+    
+    if (dirtyMask == 0 && batch.callbackCount == 0) {
+        return;
+    }
+    _writeStats.flushes++;
+    
+    // 之前的批次仍在途的寄存器，缓存要到写入完成时才更新，不能据此跳过或补齐
+    uint16_t inFlightMask = 0;
+    for (const WriteBatch& pending : _writeBatches) {
+        if (pending.inUse) {
+            inFlightMask |= pending.registerMask;
+        }
+    }
+    
+    // 与缓存值相同的寄存器不写；可补齐的寄存器是本批次写入的或缓存中新鲜的
+    uint32_t now = millis();
+    uint16_t writeMask = 0;
+    uint16_t fillMask = 0;
+    for (uint8_t i = 0; i < CACHED_REGISTER_COUNT; i++) {
+        uint16_t bit = 1 << i;
+        uint16_t cached = 0;
+        bool fresh = !(inFlightMask & bit) && _cache.getFresh(i, cached, now);
+        if (dirtyMask & bit) {
+            fillMask |= bit;
+            if (fresh && cached == values[i]) {
+                _writeStats.skippedRegisters++;
+            } else {
+                writeMask |= bit;
+            }
+        } else if (fresh && !(NO_FILL_MASK & bit)) {
+            values[i] = cached;
+            fillMask |= bit;
+        }
+    }
+    
+    // 划分连续写帧：两段之间的寄存器都可补齐时合并为一帧
+    uint8_t frameStart[CACHED_REGISTER_COUNT];
+    uint8_t frameLength[CACHED_REGISTER_COUNT];
+    uint8_t frameCount = 0;
+    uint8_t i = 0;
+    while (i < CACHED_REGISTER_COUNT) {
+        if (!(writeMask & (1 << i))) {
+            i++;
+            continue;
+        }
+        uint8_t start = i;
+        uint8_t end = i;
+        for (uint8_t j = i + 1; j < CACHED_REGISTER_COUNT && (fillMask & (1 << j)); j++) {
+            if (writeMask & (1 << j)) {
+                end = j;
+            }
+        }
+        frameStart[frameCount] = start;
+        frameLength[frameCount] = end - start + 1;
+        frameCount++;
+        i = end + 1;
+    }
+    
+    // 多算一次，保证所有帧提交完之前不会触发回调
+    batch.registerMask = 0;
+    for (uint8_t f = 0; f < frameCount; f++) {
+        batch.registerMask |= ((1 << frameLength[f]) - 1) << frameStart[f];
+    }
+    batch.inUse = true;
+    batch.remaining = frameCount + 1;
+    batch.success = true;
+    for (uint8_t f = 0; f < frameCount; f++) {
+        bool submitted = submitWrite(frameStart[f], frameLength[f], &values[frameStart[f]], ModbusPriority::NORMAL,
+            [this, index](bool success) {
+                finishWriteBatch(index, success);
+            });
+        if (submitted) {
+            _writeStats.frames++;
+        } else {
+            finishWriteBatch(index, false);
+        }
+    }
+    finishWriteBatch(index, true);
+}
+
+// 批次中的一帧完成；全部完成后调用本批次的回调并释放槽位
+void MotorModbusController::finishWriteBatch(uint8_t index, bool success) {
+    WriteBatch& batch = _writeBatches[index];
+    batch.success = batch.success && success;
+    if (--batch.remaining > 0) {
+        return;
+    }
+    for (uint8_t k = 0; k < batch.callbackCount; k++) {
+        if (batch.callbacks[k]) {
+            batch.callbacks[k](batch.success);
+            batch.callbacks[k] = nullptr;
+        }
+    }
+    batch.callbackCount = 0;
+    batch.registerMask = 0;
+    batch.inUse = false;
+}
+
+void MotorModbusController::setMotorAddress(uint8_t address) {
+    if (_slaveRegistered) {
+        _bus->removeSlave(_motorAddress);
+    }
+    _motorAddress = address;
+    _slaveRegistered = _bus->addSlave(address);
+    _cache.invalidateAll();
+}
+
+ModbusRTUDriver& MotorModbusController::selectDriver() {
+    // 共享总线时驱动的从站地址会被其他从站的事务改写
+    ModbusRTUDriver& driver = _bus->getDriver();
+    driver.setSlaveAddress(_motorAddress);
+    return driver;
+}
+
+bool MotorModbusController::readRegisters(uint16_t address, uint16_t quantity, uint16_t* values) {
+    if (_cache.lookup(address, quantity, values, millis())) {
+        return true;
+    }
+    
+    uint16_t spanAddress;
+    uint16_t spanQuantity;
+    if (!_cache.covers(address, quantity) ||
+        !_cache.getStaleSpan(address, quantity, millis(), spanAddress, spanQuantity)) {
+        return selectDriver().readHoldingRegisters(address, quantity, values);
+    }
+    
+    // 只读取过期区间，其余部分取自缓存
+    uint16_t buffer[ModbusRegisterCache::MAX_REGISTERS];
+    if (!selectDriver().readHoldingRegisters(spanAddress, spanQuantity, buffer)) {
+        return false;
+    }
+    _cache.storeRead(spanAddress, spanQuantity, buffer, millis());
+    return _cache.copy(address, quantity, values);
+}
+
+bool MotorModbusController::writeRegisters(uint16_t address, uint16_t quantity, const uint16_t* values) {
+    if (touchesOutput(address, quantity)) {
+        _outputRamp.clear();
+    }
+    bool success = (quantity == 1)
+        ? selectDriver().writeSingleRegister(address, values[0])
+        : selectDriver().writeMultipleRegisters(address, quantity, values);
+    
+    // 写入成功时从站的值就是写入值；失败时无法确定从站状态，作废缓存
+    if (success) {
+        _cache.store(address, quantity, values, millis());
+    } else {
+        _cache.invalidate(address, quantity);
+    }
+    return success;
+}
+
+bool MotorModbusController::submitWrite(uint16_t address, uint16_t quantity, const uint16_t* values,
+                                        ModbusPriority priority, CompletionCallback callback) {
+    uint16_t written[ModbusRegisterCache::MAX_REGISTERS];
+    if (quantity == 0 || quantity > ModbusRegisterCache::MAX_REGISTERS) {
+        return false;
+    }
+    memcpy(written, values, quantity * sizeof(uint16_t));
+    
+    ModbusRegisterCache* cache = &_cache;
+    auto onComplete = [cache, address, quantity, written, callback](const ModbusResult& result) {
+        if (result.success) {
+            cache->store(address, quantity, written, millis());
+        } else {
+            cache->invalidate(address, quantity);
+        }
+        if (callback) {
+            callback(result.success);
+        }
+    };
+    
+    if (quantity == 1) {
+        return _bus->submitWriteSingle(_motorAddress, address, values[0], priority, onComplete);
+    }
+    return _bus->submitWriteMultiple(_motorAddress, address, quantity, values, priority, onComplete);
+}
+
+void MotorModbusController::decodeAllConfig(const uint16_t* values, AllConfig& config) {
+    // 寄存器 0x0001 ~ 0x000B
+    config.externalSwitch = (values[0] == 1);    // 0x0001
+    config.analogControl = (values[1] == 1);     // 0x0002
+    config.powerOnState = (values[2] == 1);      // 0x0003
+    config.minOutput = (uint8_t)values[3];       // 0x0004
+    config.maxOutput = (uint8_t)values[4];       // 0x0005
+    config.softStartTime = values[5];            // 0x0006
+    config.softStopTime = values[6];             // 0x0007
+    config.isRunning = (values[7] == 1);         // 0x0008
+    config.frequency = ((uint32_t)values[8] << 16) | values[9]; // 0x0009, 0x000A
+    config.dutyCycle = (uint8_t)values[10];      // 0x000B
+}
+
+void MotorModbusController::encodeAllConfig(const AllConfig& config, uint16_t* values) {
+    values[0] = config.externalSwitch ? 1 : 0;    // REG_EXTERNAL_SWITCH (0x0001)
+    values[1] = config.analogControl ? 1 : 0;     // REG_0_10V_CONTROL (0x0002)
+    values[2] = config.powerOnState ? 1 : 0;      // REG_POWER_ON_STATE (0x0003)
+    values[3] = config.minOutput;                // REG_MIN_OUTPUT (0x0004)
+    values[4] = config.maxOutput;                // REG_MAX_OUTPUT (0x0005)
+    values[5] = config.softStartTime;            // REG_SOFT_START_TIME (0x0006)
+    values[6] = config.softStopTime;             // REG_SOFT_STOP_TIME (0x0007)
+    values[7] = config.isRunning ? 1 : 0;        // REG_RUN_STATUS (0x0008) - 只有在 setRunning 为 true 时才写入
+    values[8] = (config.frequency >> 16) & 0xFFFF; // REG_FREQ_HIGH (0x0009)
+    values[9] = config.frequency & 0xFFFF;       // REG_FREQ_LOW (0x000A)
+    values[10] = config.dutyCycle;               // REG_DUTY_CYCLE (0x000B)
 }
\ No newline at end of file
@@ -1,7 +1,12 @@
 #pragma once
 
 #include <Arduino.h>
+#include <functional>
 #include "../drivers/ModbusRTUDriver.h"
+#include "../drivers/ModbusTransactionQueue.h"
+#include "../drivers/ModbusBusMaster.h"
+#include "../drivers/ModbusRegisterCache.h"
+#include "../common/SetpointRamp.h"
 
 class MotorModbusController {
 public:
@@ -35,11 +40,19 @@ public:
         uint8_t dutyCycle;          // 当前占空比 (0-100%)
     };
     
+    /**
+     * 独占一条总线（begin()时初始化串口）
+     */
     MotorModbusController();
+    /**
+     * 挂在共享的多从站总线上，总线由调用者初始化并在主循环中调用bus.update()
+     */
+    explicit MotorModbusController(ModbusBusMaster& bus);
     ~MotorModbusController();
     
-    // 初始化
-    bool begin(uint8_t motorAddress = 0x01);
+    // 初始化（共享总线时忽略引脚和波特率）
+    bool begin(uint8_t motorAddress = MODBUS_SLAVE_ADDRESS, uint8_t rxPin = MODBUS_RX_PIN,
+               uint8_t txPin = MODBUS_TX_PIN, uint32_t baudRate = MODBUS_BAUD_RATE);
     
     // 配置获取
     bool getConfig(MotorConfig& config);
@@ -78,8 +91,112 @@ public:
     bool setOutput(uint32_t frequency, uint8_t duty);
     bool getOutput(uint32_t& frequency, uint8_t& duty);
     
+    // === 寄存器影子缓存：读取接口优先使用缓存，只读取过期的寄存器 ===
+    
+    /**
+     * 仅从缓存获取所有配置和状态，不访问总线
+     * @return 缓存是否全部新鲜（计入缓存命中/未命中统计）
+     */
+    bool getCachedAllConfig(AllConfig& config);
+    
+    /**
+     * 设置一段寄存器的缓存有效期，0表示不缓存
+     */
+    void setCacheTTL(uint16_t address, uint16_t quantity, uint32_t ttlMs) { _cache.setTTL(address, quantity, ttlMs); }
+    void invalidateCache() { _cache.invalidateAll(); }
+    const ModbusRegisterCache::Statistics& getCacheStatistics() const { return _cache.getStatistics(); }
+    
+    // === 异步接口：立即返回，结果在update()中通过回调给出 ===
+    typedef std::function<void(bool success)> CompletionCallback;
+    typedef std::function<void(bool success, const AllConfig& config, uint32_t responseTimeMs)> AllConfigCallback;
+    
+    /**
+     * 异步读取所有配置和状态（后台优先级）
+     * 只读取缓存中过期的寄存器区间，缓存全部新鲜时重读整段
+     * @return 是否提交成功
+     */
+    bool requestAllConfig(AllConfigCallback callback);
+    
+    /**
+     * 异步写入所有配置（普通优先级），参数含义同setAllConfig()
+     * @return 是否提交成功
+     */
+    bool requestSetAllConfig(const AllConfig& config, bool setRunning, CompletionCallback callback);
+    
+    /**
+     * 异步启动/停止（最高优先级，排在所有读写之前，不参与写合并）
+     * @return 是否提交成功
+     */
+    bool requestStart(CompletionCallback callback = nullptr);
+    bool requestStop(CompletionCallback callback = nullptr);
+    
+    // === 写合并：以下异步写入先暂存，合并窗口到期后在update()中刷新 ===
+    // 与缓存值相同的寄存器不写；其余脏寄存器合并成最少的连续写帧，
+    // 中间夹着的新鲜寄存器用缓存值补齐（模块地址和运行状态除外）。
+    // 同一窗口内的所有回调在该批次全部帧完成后一起调用。
+    
+    struct WriteStatistics {
+        uint32_t stagedRegisters;   // 暂存的寄存器写入数
+        uint32_t skippedRegisters;  // 与缓存值相同而省略的寄存器数
+        uint32_t flushes;           // 刷新批次数
+        uint32_t frames;            // 实际提交的写帧数
+    };
+    
+    bool requestFrequency(uint32_t frequency, CompletionCallback callback = nullptr);
+    bool requestDutyCycle(uint8_t duty, CompletionCallback callback = nullptr);
+    bool requestOutput(uint32_t frequency, uint8_t duty, CompletionCallback callback = nullptr);
+    bool requestOutputLimits(uint8_t minOutput, uint8_t maxOutput, CompletionCallback callback = nullptr);
+    bool requestSoftTimes(uint16_t startTime, uint16_t stopTime, CompletionCallback callback = nullptr);
+    
+    /**
+     * 不等合并窗口，立即刷新暂存的写入（只在主循环中调用）
+     */
+    void flushWrites();
+    void setWriteCombineWindow(uint16_t windowMs) { _writeWindowMs = windowMs; }
+    const WriteStatistics& getWriteStatistics() const { return _writeStats; }
+    
+    // === 设定值斜坡：频率/占空比在本机按曲线逐步变化，update()中按输出间隔暂存写入 ===
+    // 同一时刻最多一个斜坡写入在途，期间的中间值被合并，不会挤满事务队列。
+    // 起点取缓存中新鲜的频率/占空比，都不知道时直接写入目标值。
+    // 以上直接写入频率/占空比的接口会取消进行中的斜坡。以下接口只在主循环中调用。
+    
+    /**
+     * 在durationMs内把频率和占空比变化到目标值
+     * @return 是否开始（或直接写入成功暂存）
+     */
+    bool rampOutput(uint32_t frequency, uint8_t duty, uint32_t durationMs);
+    bool rampFrequency(uint32_t frequency, uint32_t durationMs);
+    bool rampDutyCycle(uint8_t duty, uint32_t durationMs);
+    void setRampProfile(RampProfile profile) { _outputRamp.setProfile(profile); }
+    void setRampEmitInterval(uint16_t intervalMs) { _outputRamp.setEmitInterval((uint32_t)intervalMs * 1000); }
+    
+    /**
+     * 斜坡是否还有未写入的变化（包括写入在途）
+     */
+    bool isRamping() const { return _outputRamp.isBusy(); }
+    const SetpointRamp& getOutputRamp() const { return _outputRamp; }
+    
+    /**
+     * 距斜坡下一次写入的时间（主循环据此安排update()）
+     * @return 微秒，没有斜坡或写入在途时返回SetpointRamp::NO_UPDATE（在途时由hasPendingWork()驱动轮询）
+     */
+    uint32_t getMicrosUntilRampUpdate() const;
+    
+    /**
+     * 刷新到期的暂存写入；独占总线时同时推进异步事务。主循环每次迭代调用一次，不阻塞
+     * @note 有异步事务进行时不要调用同步接口
+     */
+    void update();
+    
+    /**
+     * 是否有暂存的写入或未完成的异步事务（主循环据此决定是否需要按轮询间隔调用update()）
+     */
+    bool hasPendingWork();
+    ModbusTransactionQueue& getTransactionQueue() { return _bus->getQueue(); }
+    ModbusBusMaster& getBus() { return *_bus; }
+    
     // 配置
-    void setMotorAddress(uint8_t address) { _motorAddress = address; _modbus.setSlaveAddress(address); }
+    void setMotorAddress(uint8_t address);
     uint8_t getMotorAddress() const { return _motorAddress; }
     
     // 错误信息
@@ -100,6 +217,81 @@ private:
     static const uint16_t REG_FREQ_LOW = 0x000A;
     static const uint16_t REG_DUTY_CYCLE = 0x000B;
     
-    ModbusRTUDriver _modbus;
+    // 缓存覆盖 0x0000 ~ 0x000B
+    static const uint8_t CACHED_REGISTER_COUNT = 12;
+    static const uint32_t CONFIG_CACHE_TTL_MS = 5000;   // 配置寄存器只会被本机修改
+    static const uint32_t STATUS_CACHE_TTL_MS = 1000;   // 运行状态/频率/占空比
+    
+    // 写合并
+    static const uint16_t WRITE_COMBINE_WINDOW_MS = 20;
+    static const uint8_t MAX_STAGED_CALLBACKS = 8;
+    // 在途的刷新批次：每个批次完成前至少占用一个事务槽位，因此不会超过事务队列容量
+    static const uint8_t MAX_WRITE_BATCHES = ModbusTransactionQueue::QUEUE_CAPACITY;
+    // 补齐帧间空隙时不能用缓存值重写的寄存器
+    static const uint16_t NO_FILL_MASK = (1 << REG_MODULE_ADDRESS) | (1 << REG_RUN_STATUS);
+    
+    void init();
+    
+    /**
+     * 取得总线驱动并切换到本控制器的从站地址（同步接口使用）
+     */
+    ModbusRTUDriver& selectDriver();
+    
+    // 经过缓存的同步读写：读取合并过期区间，写入成功后写穿缓存
+    bool readRegisters(uint16_t address, uint16_t quantity, uint16_t* values);
+    bool writeRegisters(uint16_t address, uint16_t quantity, const uint16_t* values);
+    
+    // 异步写入，完成时更新缓存后再调用callback
+    bool submitWrite(uint16_t address, uint16_t quantity, const uint16_t* values,
+                     ModbusPriority priority, CompletionCallback callback);
+    
+    /**
+     * 暂存一段寄存器写入，同一寄存器多次写入时保留最后的值
+     * @param fromRamp 是否为斜坡输出（其他写入覆盖频率/占空比时取消斜坡）
+     * @return 是否暂存成功（回调槽已满时失败）
+     */
+    bool stageWrite(uint16_t address, uint16_t quantity, const uint16_t* values, CompletionCallback callback,
+                    bool fromRamp = false);
+    void flushStagedWrites();
+    void finishWriteBatch(uint8_t index, bool success);
+    
+    // 设定值斜坡
+    bool startOutputRamp(bool setFrequency, uint32_t frequency, bool setDuty, uint8_t duty, uint32_t durationMs);
+    void updateOutputRamp();
+    static bool touchesOutput(uint16_t address, uint16_t quantity);
+    
+    // 寄存器与AllConfig的转换（同步和异步接口共用）
+    static void decodeAllConfig(const uint16_t* values, AllConfig& config);
+    static void encodeAllConfig(const AllConfig& config, uint16_t* values);
+    
+    ModbusBusMaster* _bus;
+    bool _ownsBus;
+    bool _slaveRegistered;      // 从站是否由本控制器添加到总线
+    ModbusRegisterCache _cache;
     uint8_t _motorAddress;
+    
+    // 暂存的写入（BLE回调中暂存，主循环中刷新）
+    SemaphoreHandle_t _writeMutex;
+    uint16_t _stagedValues[CACHED_REGISTER_COUNT];
+    uint16_t _stagedMask;
+    uint32_t _stagedSinceMs;
+    CompletionCallback _stagedCallbacks[MAX_STAGED_CALLBACKS];
+    uint8_t _stagedCallbackCount;
+    uint16_t _writeWindowMs;
+    WriteStatistics _writeStats;
+    
+    // 一次刷新的完成状态，由本批次所有写帧的回调按槽位下标共享（主循环中使用）
+    struct WriteBatch {
+        bool inUse;
+        bool success;
+        uint8_t remaining;
+        uint8_t callbackCount;
+        uint16_t registerMask;  // 本批次各写帧覆盖的寄存器（含补齐的），完成前缓存中的值可能已过时
+        CompletionCallback callbacks[MAX_STAGED_CALLBACKS];
+    };
+    WriteBatch _writeBatches[MAX_WRITE_BATCHES];
+    
+    // 设定值斜坡（主循环中推进）
+    SetpointRamp _outputRamp;
+    bool _outputOverridden;     // 频率/占空比被直接写入，受_writeMutex保护
 };
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "MotorPWMController.h"
+#include "../common/DeadlineScheduler.h"
+#include "../common/Logger.h"
+#include "../common/MonotonicClock.h"
+
+MotorPWMController::MotorPWMController()
+    : dutyCycle(100)
+    , softStartMs(0)
+    , softStopMs(0)
+    , nextWriteMicros(0)
+    , running(false) {
+}
+
+// 配置LEDC，连接引脚前先写入关闭电平
+bool MotorPWMController::begin(uint8_t pin, uint8_t channel, const MotorConfig& config) {
+    running = false;
+    ramp.reset(0);
+    uint32_t offCounts = MOTOR_ON == LOW ? (1UL << MOTOR_PWM_RESOLUTION_BITS) : 0;
+    if (!driver.init(pin, channel, config.pwmFrequency, MOTOR_PWM_RESOLUTION_BITS, offCounts)) {
+        return false;
+    }
+    dutyCycle = config.pwmDutyCycle > 100 ? 100 : config.pwmDutyCycle;
+    setSoftTimes(config.softStartMs, config.softStopMs);
+    return true;
+}
+
+void MotorPWMController::end() {
+    driver.end();
+    running = false;
+    ramp.reset(0);
+}
+
+// 应用配置
+bool MotorPWMController::applyConfig(const MotorConfig& config, uint64_t nowMicros) {
+    setSoftTimes(config.softStartMs, config.softStopMs);
+    setDutyCycle(config.pwmDutyCycle, nowMicros);
+    return setFrequency(config.pwmFrequency);
+}
+
+bool MotorPWMController::setFrequency(uint32_t frequency) {
+    return driver.setFrequency(frequency);
+}
+
+// 设置运行占空比，运行中从当前输出变化到新值
+void MotorPWMController::setDutyCycle(uint8_t duty, uint64_t nowMicros) {
+    dutyCycle = duty > 100 ? 100 : duty;
+    if (running) {
+        rampTo(targetCounts(), nowMicros);
+    }
+}
+
+void MotorPWMController::setSoftTimes(uint32_t startMs, uint32_t stopMs) {
+    softStartMs = startMs > MOTOR_PWM_MAX_SOFT_TIME_MS ? MOTOR_PWM_MAX_SOFT_TIME_MS : startMs;
+    softStopMs = stopMs > MOTOR_PWM_MAX_SOFT_TIME_MS ? MOTOR_PWM_MAX_SOFT_TIME_MS : stopMs;
+}
+
+// 开始缓启动
+void MotorPWMController::start(uint64_t atMicros) {
+    if (running) {
+        return;
+    }
+    running = true;
+    rampTo(targetCounts(), atMicros);
+    LOG_TAG_DEBUG("MotorPWM", "缓启动: 目标占空比%u%%, %lu ms", dutyCycle,
+                  (unsigned long)((uint64_t)softStartMs * dutyCycle / 100));
+}
+
+// 开始缓停止
+void MotorPWMController::stop(uint64_t atMicros) {
+    if (!running) {
+        return;
+    }
+    running = false;
+    rampTo(0, atMicros);
+    LOG_TAG_DEBUG("MotorPWM", "缓停止");
+}
+
+// 按缓启动/缓停止时间计算斜坡时长并立即写入起点处的输出
+void MotorPWMController::rampTo(uint32_t counts, uint64_t atMicros) {
+    uint32_t full = driver.getMaxDuty();
+    int32_t current = ramp.isActive() ? ramp.valueAt(atMicros) : ramp.getValue();
+    uint32_t delta = counts >= (uint32_t)current ? counts - current : current - counts;
+    uint32_t rampMs = counts >= (uint32_t)current ? softStartMs : softStopMs;
+    uint64_t durationMicros = (uint64_t)rampMs * 1000 * delta / full;
+    
+    ramp.start((int32_t)counts, durationMicros, atMicros);
+    uint64_t now = MonotonicClock::nowMicros();
+    ramp.update(now);
+    writeOutput();
+    nextWriteMicros = now + MOTOR_PWM_RAMP_INTERVAL_MICROS;
+}
+
+// 斜坡进行中按固定间隔写入占空比，结束时写入目标值
+void MotorPWMController::update(uint64_t nowMicros) {
+    if (!ramp.isActive()) {
+        return;
+    }
+    if (nowMicros < nextWriteMicros && nowMicros < ramp.getEndMicros()) {
+        return;
+    }
+    if (ramp.update(nowMicros)) {
+        writeOutput();
+    }
+    nextWriteMicros = nowMicros + MOTOR_PWM_RAMP_INTERVAL_MICROS;
+}
+
+uint32_t MotorPWMController::getMicrosUntilNextUpdate(uint64_t nowMicros) const {
+    if (!ramp.isActive()) {
+        return DeadlineScheduler::NO_DEADLINE;
+    }
+    uint64_t due = nextWriteMicros < ramp.getEndMicros() ? nextWriteMicros : ramp.getEndMicros();
+    return due > nowMicros ? (uint32_t)(due - nowMicros) : 0;
+}
+
+uint16_t MotorPWMController::getOutputPermille() const {
+    return (uint16_t)((uint64_t)ramp.getValue() * OUTPUT_SCALE / driver.getMaxDuty());
+}
+
+// 运行占空比对应的计数
+uint32_t MotorPWMController::targetCounts() const {
+    return (uint32_t)((uint64_t)driver.getMaxDuty() * dutyCycle / 100);
+}
+
+// 写入LEDC：MOTOR_ON为低电平时低电平时间即开启时间
+void MotorPWMController::writeOutput() {
+    uint32_t counts = (uint32_t)ramp.getValue();
+    driver.setDuty(MOTOR_ON == LOW ? driver.getMaxDuty() - counts : counts);
+}
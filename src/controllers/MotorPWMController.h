@@ -0,0 +1,120 @@
+#ifndef MOTOR_PWM_CONTROLLER_H
+#define MOTOR_PWM_CONTROLLER_H
+
+#include "../common/Config.h"
+#include "../common/RampGenerator.h"
+#include "../drivers/PWMDriver.h"
+
+/**
+ * @brief PWM调速输出（MotorModbusController之外的另一种调速后端）
+ *
+ * 由LEDC在MOTOR_PIN上直接输出PWM，不经过MODBUS调速器。启动/停止和占空比变化按缓启动/缓停止
+ * 时间线性变化：缓启动时间是输出从0升到100%所需的时间，较小的变化按比例缩短。斜坡以定点数计算，
+ * 每MOTOR_PWM_RAMP_INTERVAL_MICROS更新一次占空比，结束时精确到达目标。
+ * 输出值按电机开启的比例表示，MOTOR_ON为低电平时写入LEDC前取反。
+ */
+class MotorPWMController {
+public:
+    static const uint16_t OUTPUT_SCALE = 1000;  // getOutputPermille()的满量程
+    
+    MotorPWMController();
+    
+    /**
+     * @brief 配置LEDC并接管引脚，输出为关闭
+     * @param pin GPIO引脚号
+     * @param channel LEDC通道
+     * @param config 频率、占空比和缓启动/缓停止时间
+     * @return 初始化是否成功
+     */
+    bool begin(uint8_t pin, uint8_t channel, const MotorConfig& config);
+    
+    /**
+     * @brief 释放引脚
+     */
+    void end();
+    
+    /**
+     * @brief 应用配置中的频率、占空比和缓启动/缓停止时间
+     * @param config 配置
+     * @param nowMicros 当前时刻，运行中修改占空比时斜坡从此刻开始
+     * @return 频率设置是否成功
+     */
+    bool applyConfig(const MotorConfig& config, uint64_t nowMicros);
+    
+    /**
+     * @brief 设置PWM频率（立即生效）
+     * @param frequency 频率 (Hz)
+     * @return 操作是否成功
+     */
+    bool setFrequency(uint32_t frequency);
+    
+    /**
+     * @brief 设置运行占空比，运行中按缓启动/缓停止时间变化到新值
+     * @param duty 占空比 (0-100%)
+     * @param nowMicros 当前时刻
+     */
+    void setDutyCycle(uint8_t duty, uint64_t nowMicros);
+    
+    /**
+     * @brief 设置缓启动/缓停止时间（下一次变化开始生效）
+     * @param softStartMs 输出从0升到100%的时间（毫秒）
+     * @param softStopMs 输出从100%降到0的时间（毫秒）
+     */
+    void setSoftTimes(uint32_t softStartMs, uint32_t softStopMs);
+    
+    /**
+     * @brief 开始缓启动，已在运行时不做处理
+     * @param atMicros 斜坡起点（可以早于当前时刻，例如相位定时器到期的时刻）
+     */
+    void start(uint64_t atMicros);
+    
+    /**
+     * @brief 开始缓停止，已停止时不做处理
+     * @param atMicros 斜坡起点
+     */
+    void stop(uint64_t atMicros);
+    
+    /**
+     * @brief 推进斜坡并写入占空比（需要在主循环中调用）
+     * @param nowMicros 当前时刻
+     */
+    void update(uint64_t nowMicros);
+    
+    /**
+     * @brief 距下一次需要调用update()的时间（微秒）
+     * @return 斜坡进行中返回距下一次占空比更新的时间，否则为DeadlineScheduler::NO_DEADLINE
+     */
+    uint32_t getMicrosUntilNextUpdate(uint64_t nowMicros) const;
+    
+    bool isRunning() const { return running; }
+    bool isRamping() const { return ramp.isActive(); }
+    uint32_t getFrequency() const { return driver.getFrequency(); }
+    uint8_t getDutyCycle() const { return dutyCycle; }
+    uint32_t getSoftStartMs() const { return softStartMs; }
+    uint32_t getSoftStopMs() const { return softStopMs; }
+    
+    /**
+     * @brief 当前输出（电机开启的比例，0-1000）
+     */
+    uint16_t getOutputPermille() const;
+    
+    /**
+     * @brief 当前写入LEDC的占空比计数
+     */
+    uint32_t getDutyCounts() const { return driver.getDuty(); }
+
+private:
+    uint32_t targetCounts() const;
+    void rampTo(uint32_t counts, uint64_t atMicros);
+    void writeOutput();
+    
+    PWMDriver driver;
+    RampGenerator ramp;             // 输出值为电机开启的占空比计数
+    uint8_t dutyCycle;              // 运行占空比 (0-100%)
+    uint32_t softStartMs;
+    uint32_t softStopMs;
+    uint64_t nextWriteMicros;       // 斜坡进行中下一次写入占空比的时刻
+    bool running;
+};
+
+#endif // MOTOR_PWM_CONTROLLER_H
@@ -0,0 +1,208 @@
+#include "SerialConsole.h"
+#include "MotorController.h"
+#include "../common/MonotonicClock.h"
+#include <cstring>
+
+// 单例实例
+SerialConsole& SerialConsole::getInstance() {
+    static SerialConsole instance;
+    return instance;
+}
+
+// 构造函数
+SerialConsole::SerialConsole()
+    : stream(nullptr)
+    , lineLength(0)
+    , lineOverflow(false) {
+    lineBuffer[0] = '\0';
+}
+
+// 绑定串口
+void SerialConsole::begin(Stream& stream) {
+    this->stream = &stream;
+    lineLength = 0;
+    lineOverflow = false;
+}
+
+// 读取串口数据，每遇到一个换行执行一条命令
+void SerialConsole::update() {
+    if (!stream) {
+        return;
+    }
+    
+    while (stream->available() > 0) {
+        int c = stream->read();
+        if (c < 0) {
+            break;
+        }
+        if (c == '\r' || c == '\n') {
+            if (lineOverflow) {
+                stream->println("命令过长");
+            } else if (lineLength > 0) {
+                lineBuffer[lineLength] = '\0';
+                handleLine(lineBuffer, *stream);
+            }
+            lineLength = 0;
+            lineOverflow = false;
+        } else if (lineLength < LINE_BUFFER_SIZE - 1) {
+            lineBuffer[lineLength++] = (char)c;
+        } else {
+            lineOverflow = true;
+        }
+    }
+}
+
+// 执行一行命令
+bool SerialConsole::handleLine(const char* line, Print& out) {
+    // 去掉首尾空白
+    while (*line == ' ' || *line == '\t') {
+        line++;
+    }
+    size_t length = strlen(line);
+    while (length > 0 && (line[length - 1] == ' ' || line[length - 1] == '\t' ||
+                          line[length - 1] == '\r' || line[length - 1] == '\n')) {
+        length--;
+    }
+    if (length == 0) {
+        return false;
+    }
+    
+    if (length == 4 && strncmp(line, "help", 4) == 0) {
+        printHelp(out);
+        return true;
+    }
+    if (length == 6 && strncmp(line, "timing", 6) == 0) {
+        printTiming(out);
+        return true;
+    }
+    if (length == 12 && strncmp(line, "timing reset", 12) == 0) {
+        MotorController::getInstance().resetPhaseJitterStatistics();
+        out.println("相位切换误差统计已重置");
+        return true;
+    }
+    if (length == 7 && strncmp(line, "program", 7) == 0) {
+        printProgram(out);
+        return true;
+    }
+    if (length == 13 && strncmp(line, "program start", 13) == 0) {
+        MotorController& motorController = MotorController::getInstance();
+        if (!motorController.startProgram()) {
+            out.printf("程序启动失败: %s", motorController.getLastError());
+            out.println();
+            return false;
+        }
+        out.println("程序已启动");
+        return true;
+    }
+    if (length == 12 && strncmp(line, "program stop", 12) == 0) {
+        out.println(MotorController::getInstance().stopProgram() ? "程序已停止" : "没有正在执行的程序");
+        return true;
+    }
+    
+    out.printf("未知命令: %.*s (输入help查看命令)", (int)length, line);
+    out.println();
+    return false;
+}
+
+// 列出命令
+void SerialConsole::printHelp(Print& out) {
+    out.println("可用命令:");
+    out.println("  help          列出命令");
+    out.println("  timing        相位切换误差统计（微秒）");
+    out.println("  timing reset  清零相位切换误差统计");
+    out.println("  program       电机程序与执行状态");
+    out.println("  program start 开始执行电机程序");
+    out.println("  program stop  停止电机程序并关闭电机");
+}
+
+// 输出运行/停止阶段的误差摘要和分布
+void SerialConsole::printTiming(Print& out) {
+    MotorController& motorController = MotorController::getInstance();
+    const MotorPhase phases[] = {MotorPhase::RUN, MotorPhase::STOP};
+    const char* names[] = {"运行", "停止"};
+    
+    for (uint8_t i = 0; i < 2; i++) {
+        const PhaseJitterStatistics& stats = motorController.getPhaseJitterStatistics(phases[i]);
+        PhaseJitterSummary summary = MotorController::summarizePhaseJitter(stats);
+        
+        out.printf("%s阶段: 切换%lu次 (定时器%lu次) 最小%luus 最大%luus 平均%luus p99 %luus",
+                   names[i], (unsigned long)summary.count, (unsigned long)stats.timerEdges,
+                   (unsigned long)summary.minMicros, (unsigned long)summary.maxMicros,
+                   (unsigned long)summary.meanMicros, (unsigned long)summary.p99Micros);
+        out.println();
+        out.print("  分布(us):");
+        for (uint8_t bucket = 0; bucket < PhaseJitterStatistics::BUCKET_COUNT; bucket++) {
+            uint32_t limit = MotorController::getPhaseJitterBucketLimit(bucket);
+            if (limit == 0xFFFFFFFF) {
+                out.printf(" >=%lu:%lu", (unsigned long)MotorController::getPhaseJitterBucketLimit(bucket - 1),
+                           (unsigned long)stats.buckets[bucket]);
+            } else {
+                out.printf(" <%lu:%lu", (unsigned long)limit, (unsigned long)stats.buckets[bucket]);
+            }
+        }
+        out.println();
+    }
+}
+
+// 输出已加载的程序和执行状态
+void SerialConsole::printProgram(Print& out) {
+    MotorController& motorController = MotorController::getInstance();
+    const MotorProgram& program = motorController.getProgram();
+    if (!program.isCompiled()) {
+        out.println("没有加载电机程序");
+        return;
+    }
+    
+    uint64_t totalMs = program.getTotalDurationMs();
+    if (totalMs == MotorProgram::INFINITE_DURATION) {
+        out.printf("电机程序: %u条指令, 无限循环", program.getInstructionCount());
+    } else {
+        out.printf("电机程序: %u条指令, 总时长%lu.%03lu秒", program.getInstructionCount(),
+                   (unsigned long)(totalMs / 1000), (unsigned long)(totalMs % 1000));
+    }
+    out.println();
+    
+    uint8_t depth = 0;
+    for (uint8_t i = 0; i < program.getInstructionCount(); i++) {
+        const ProgramInstruction& instruction = program.getInstruction(i);
+        if (instruction.op == ProgramOp::END_REPEAT) {
+            depth--;
+        }
+        out.printf("  %2u %*s", i, depth * 2, "");
+        switch (instruction.op) {
+            case ProgramOp::STEP:
+                out.printf("%s %lums", instruction.motorOn ? "开" : "关", (unsigned long)instruction.durationMs);
+                if (instruction.setpoint.mask & ProgramSetpoint::FREQUENCY) {
+                    out.printf(" 频率%luHz", (unsigned long)instruction.setpoint.frequency);
+                }
+                if (instruction.setpoint.mask & ProgramSetpoint::DUTY) {
+                    out.printf(" 占空比%u%%", instruction.setpoint.dutyCycle);
+                }
+                if (instruction.setpoint.mask & ProgramSetpoint::RAMP) {
+                    out.printf(" 缓变%u.%us", instruction.setpoint.rampTime / 10, instruction.setpoint.rampTime % 10);
+                }
+                break;
+            case ProgramOp::REPEAT:
+                if (instruction.repeatCount == 0) {
+                    out.print("循环 无限次 {");
+                } else {
+                    out.printf("循环 %u次 {", instruction.repeatCount);
+                }
+                depth++;
+                break;
+            case ProgramOp::END_REPEAT:
+                out.print("}");
+                break;
+        }
+        out.println();
+    }
+    
+    const MotorProgramRunner& runner = motorController.getProgramRunner();
+    if (motorController.isProgramRunning()) {
+        out.printf("正在执行第%u条指令, 已执行%lu个步骤, 本步骤剩余%lums", runner.getCurrentIndex(),
+                   (unsigned long)runner.getStepsExecuted(), (unsigned long)runner.getMsUntilNextStep(MonotonicClock::nowMillis()));
+    } else {
+        out.print("未执行");
+    }
+    out.println();
+}
@@ -0,0 +1,61 @@
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief 串口诊断命令
+ * 
+ * 从串口按行读取命令（不阻塞主循环），支持的命令：
+ * - help          列出命令
+ * - timing        输出运行/停止阶段的相位切换误差统计
+ * - timing reset  清零相位切换误差统计
+ * - program       输出电机程序和执行状态
+ * - program start 开始执行电机程序
+ * - program stop  停止电机程序
+ */
+class SerialConsole {
+public:
+    /**
+     * @brief 获取串口命令单例实例
+     * @return SerialConsole& 单例引用
+     */
+    static SerialConsole& getInstance();
+    
+    /**
+     * @brief 绑定命令输入输出的串口
+     * @param stream 串口（通常为Serial）
+     */
+    void begin(Stream& stream);
+    
+    /**
+     * @brief 读取已到达的串口数据，遇到换行时执行命令（需要在主循环中调用）
+     */
+    void update();
+    
+    /**
+     * @brief 执行一行命令
+     * @param line 命令文本（不含换行，忽略首尾空白）
+     * @param out 命令输出
+     * @return 命令是否有效
+     */
+    bool handleLine(const char* line, Print& out);
+
+private:
+    SerialConsole();
+    SerialConsole(const SerialConsole&) = delete;
+    SerialConsole& operator=(const SerialConsole&) = delete;
+    
+    void printHelp(Print& out);
+    void printTiming(Print& out);
+    void printProgram(Print& out);
+    
+    static const size_t LINE_BUFFER_SIZE = 64;
+    
+    Stream* stream;                     // 命令串口
+    char lineBuffer[LINE_BUFFER_SIZE];  // 当前行
+    size_t lineLength;                  // 当前行长度
+    bool lineOverflow;                  // 当前行超长，丢弃到换行为止
+};
+
+#endif // SERIAL_CONSOLE_H
@@ -0,0 +1,244 @@
+#include "ModbusBusMaster.h"
+
+ModbusBusMaster::ModbusBusMaster()
+    : _queue(_driver), _slaveCount(0), _pollCursor(0), _pollsInFlight(0),
+      _pollIntervalMs(1000), _pollBudget(2), _offlineThreshold(3),
+      _backoffBaseMs(1000), _backoffMaxMs(30000) {
+    for (uint8_t i = 0; i < MAX_SLAVES; i++) {
+        _slaves[i].inUse = false;
+    }
+}
+
+ModbusBusMaster::~ModbusBusMaster() {
+}
+
+bool ModbusBusMaster::begin(uint8_t rxPin, uint8_t txPin, uint32_t baudRate) {
+    return _driver.begin(rxPin, txPin, baudRate, MODBUS_SLAVE_ADDRESS);
+}
+
+bool ModbusBusMaster::addSlave(uint8_t address, uint16_t pollAddress, uint16_t pollQuantity, PollCallback callback) {
+    // 0为广播地址，248~255为保留地址
+    if (address == 0 || address > 247 || findSlave(address) != nullptr ||
+        pollQuantity > ModbusTransactionQueue::MAX_REGISTERS) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < MAX_SLAVES; i++) {
+        Slave& slave = _slaves[i];
+        if (slave.inUse) {
+            continue;
+        }
+        slave.inUse = true;
+        slave.pollAddress = pollAddress;
+        slave.pollQuantity = pollQuantity;
+        slave.callback = callback;
+        slave.nextPollMs = millis();
+        slave.pollPending = false;
+        slave.totalResponseMs = 0;
+        memset(&slave.stats, 0, sizeof(slave.stats));
+        slave.stats.address = address;
+        slave.stats.online = true;
+        _slaveCount++;
+        return true;
+    }
+    return false;
+}
+
+bool ModbusBusMaster::removeSlave(uint8_t address) {
+    Slave* slave = findSlave(address);
+    if (slave == nullptr) {
+        return false;
+    }
+    // 进行中的轮询完成时找不到从站，只会被忽略
+    if (slave->pollPending) {
+        _pollsInFlight--;
+    }
+    slave->inUse = false;
+    slave->callback = nullptr;
+    _slaveCount--;
+    return true;
+}
+
+bool ModbusBusMaster::submitRead(uint8_t slaveAddress, uint16_t address, uint16_t quantity,
+                                 ModbusPriority priority, ModbusCallback callback) {
+    return _queue.submitTo(slaveAddress, 0x03, address, quantity, nullptr, priority,
+                           getCommandRetries(slaveAddress), wrapCallback(callback));
+}
+
+bool ModbusBusMaster::submitWriteSingle(uint8_t slaveAddress, uint16_t address, uint16_t value,
+                                        ModbusPriority priority, ModbusCallback callback) {
+    return _queue.submitTo(slaveAddress, 0x06, address, 1, &value, priority,
+                           getCommandRetries(slaveAddress), wrapCallback(callback));
+}
+
+bool ModbusBusMaster::submitWriteMultiple(uint8_t slaveAddress, uint16_t address, uint16_t quantity,
+                                          const uint16_t* values, ModbusPriority priority, ModbusCallback callback) {
+    return _queue.submitTo(slaveAddress, 0x10, address, quantity, values, priority,
+                           getCommandRetries(slaveAddress), wrapCallback(callback));
+}
+
+void ModbusBusMaster::update() {
+    schedulePoll(millis());
+    _queue.process();
+}
+
+bool ModbusBusMaster::getSlaveStatistics(uint8_t address, SlaveStatistics& stats) const {
+    const Slave* slave = findSlave(address);
+    if (slave == nullptr) {
+        return false;
+    }
+    stats = slave->stats;
+    return true;
+}
+
+bool ModbusBusMaster::isOnline(uint8_t address) const {
+    const Slave* slave = findSlave(address);
+    return slave != nullptr && slave->stats.online;
+}
+
+void ModbusBusMaster::resetStatistics() {
+    for (uint8_t i = 0; i < MAX_SLAVES; i++) {
+        Slave& slave = _slaves[i];
+        if (!slave.inUse) {
+            continue;
+        }
+        uint8_t address = slave.stats.address;
+        bool online = slave.stats.online;
+        uint32_t consecutiveFailures = slave.stats.consecutiveFailures;
+        uint32_t backoffMs = slave.stats.backoffMs;
+        memset(&slave.stats, 0, sizeof(slave.stats));
+        slave.stats.address = address;
+        slave.stats.online = online;
+        slave.stats.consecutiveFailures = consecutiveFailures;
+        slave.stats.backoffMs = backoffMs;
+        slave.totalResponseMs = 0;
+    }
+    _queue.resetStatistics();
+}
+
+ModbusBusMaster::Slave* ModbusBusMaster::findSlave(uint8_t address) {
+    for (uint8_t i = 0; i < MAX_SLAVES; i++) {
+        if (_slaves[i].inUse && _slaves[i].stats.address == address) {
+            return &_slaves[i];
+        }
+    }
+    return nullptr;
+}
+
+const ModbusBusMaster::Slave* ModbusBusMaster::findSlave(uint8_t address) const {
+    return const_cast<ModbusBusMaster*>(this)->findSlave(address);
+}
+
+// 离线从站的命令不重试，在线或未添加的从站使用队列的重试次数
+uint8_t ModbusBusMaster::getCommandRetries(uint8_t address) const {
+    const Slave* slave = findSlave(address);
+    if (slave != nullptr && !slave->stats.online) {
+        return 0;
+    }
+    return ModbusTransactionQueue::DEFAULT_RETRIES;
+}
+
+bool ModbusBusMaster::schedulePoll(uint32_t nowMs) {
+    if (_pollsInFlight >= _pollBudget) {
+        return false;
+    }
+
+    // 从上次安排的下一个从站开始找第一个到期的，保证各从站轮流获得总线
+    for (uint8_t n = 0; n < MAX_SLAVES; n++) {
+        uint8_t index = (_pollCursor + n) % MAX_SLAVES;
+        Slave& slave = _slaves[index];
+        if (!slave.inUse || slave.pollQuantity == 0 || slave.pollPending ||
+            static_cast<int32_t>(nowMs - slave.nextPollMs) < 0) {
+            continue;
+        }
+
+        // 轮询失败不重试：下一周期会再次读取；离线探测同样只发一次
+        uint8_t address = slave.stats.address;
+        bool submitted = _queue.submitTo(address, 0x03, slave.pollAddress, slave.pollQuantity, nullptr,
+            ModbusPriority::BACKGROUND, 0,
+            [this, address](const ModbusResult& result) {
+                Slave* polled = findSlave(address);
+                if (polled == nullptr || !polled->pollPending) {
+                    return;
+                }
+                polled->pollPending = false;
+                _pollsInFlight--;
+                recordResult(address, result, true);
+                if (polled->callback) {
+                    polled->callback(address, result);
+                }
+            });
+        if (!submitted) {
+            return false;
+        }
+
+        slave.pollPending = true;
+        slave.nextPollMs = nowMs + _pollIntervalMs;
+        _pollsInFlight++;
+        _pollCursor = (index + 1) % MAX_SLAVES;
+        return true;
+    }
+    return false;
+}
+
+void ModbusBusMaster::recordResult(uint8_t address, const ModbusResult& result, bool isPoll) {
+    Slave* slave = findSlave(address);
+    if (slave == nullptr) {
+        return;
+    }
+
+    SlaveStatistics& stats = slave->stats;
+    stats.requests++;
+    if (isPoll) {
+        stats.polls++;
+    }
+
+    if (result.success) {
+        stats.successes++;
+        stats.consecutiveFailures = 0;
+        stats.online = true;
+        stats.backoffMs = 0;
+        stats.lastSuccessMs = millis();
+        slave->totalResponseMs += result.elapsedMs;
+        stats.averageResponseMs = slave->totalResponseMs / stats.successes;
+        return;
+    }
+
+    stats.failures++;
+    if (result.error == ModbusRTUDriver::ERROR_EXCEPTION) {
+        // 从站正常应答了请求，只是拒绝执行
+        stats.exceptions++;
+        stats.lastExceptionCode = result.exceptionCode;
+        stats.consecutiveFailures = 0;
+        stats.online = true;
+        stats.backoffMs = 0;
+        return;
+    }
+    if (result.error == ModbusRTUDriver::ERROR_TIMEOUT) {
+        stats.timeouts++;
+    } else {
+        stats.crcErrors++;
+    }
+    stats.consecutiveFailures++;
+
+    // 连续失败达到阈值后离线，之后每多失败一次退避时间翻倍
+    if (stats.consecutiveFailures >= _offlineThreshold) {
+        stats.online = false;
+        uint32_t shift = stats.consecutiveFailures - _offlineThreshold;
+        uint32_t backoff = _backoffMaxMs;
+        if (shift < 16 && (_backoffBaseMs << shift) < _backoffMaxMs) {
+            backoff = _backoffBaseMs << shift;
+        }
+        stats.backoffMs = backoff;
+        slave->nextPollMs = millis() + backoff;
+    }
+}
+
+ModbusCallback ModbusBusMaster::wrapCallback(ModbusCallback callback) {
+    return [this, callback](const ModbusResult& result) {
+        recordResult(result.slaveAddress, result, false);
+        if (callback) {
+            callback(result);
+        }
+    };
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "ModbusRTUDriver.h"
+#include "ModbusTransactionQueue.h"
+#include "../common/Config.h"
+
+/**
+ * 多从站MODBUS总线主站
+ *
+ * 独占一条RS-485总线（ModbusRTUDriver及其串口），所有从站的请求都经过同一个事务队列：
+ * - 按轮询顺序公平地为每个在线从站安排周期读取，每次update()最多发起一个轮询
+ * - 轮询预算限制同时排队的轮询数，给控制命令留出队列空间
+ * - 连续失败的从站标记为离线，按指数退避降低探测频率，探测不重试；
+ *   异常应答说明从站在线，不计入连续失败
+ * - 每个从站单独统计请求、成功、超时和响应时间
+ *
+ * 控制命令通过submitRead/submitWrite*提交，按优先级排在轮询之前。
+ * 发往离线从站的命令仍会发送（没有轮询的从站只能靠命令恢复在线），但与探测一样不重试，
+ * 一个掉线的从站每条命令最多占用总线一个超时时间。
+ */
+class ModbusBusMaster {
+public:
+    static const uint8_t MAX_SLAVES = 16;
+
+    typedef std::function<void(uint8_t slaveAddress, const ModbusResult& result)> PollCallback;
+
+    /**
+     * 单个从站统计
+     */
+    struct SlaveStatistics {
+        uint8_t address;
+        bool online;
+        uint32_t requests;              // 完成的事务数（轮询和命令）
+        uint32_t successes;
+        uint32_t failures;
+        uint32_t timeouts;
+        uint32_t crcErrors;             // 应答CRC错误或无效帧导致的失败
+        uint32_t exceptions;            // 异常应答（从站在线但拒绝请求）
+        uint8_t lastExceptionCode;
+        uint32_t polls;                 // 完成的轮询数
+        uint32_t consecutiveFailures;
+        uint32_t lastSuccessMs;
+        uint32_t averageResponseMs;     // 成功事务的平均耗时
+        uint32_t backoffMs;             // 当前离线退避间隔
+    };
+
+    ModbusBusMaster();
+    ~ModbusBusMaster();
+
+    /**
+     * 初始化总线
+     */
+    bool begin(uint8_t rxPin = MODBUS_RX_PIN, uint8_t txPin = MODBUS_TX_PIN, uint32_t baudRate = MODBUS_BAUD_RATE);
+
+    /**
+     * 添加从站及其周期轮询的寄存器区间
+     * @param pollQuantity 为0时不轮询，只用于统计命令结果
+     * @return 是否添加成功（从站表已满或地址重复时失败）
+     */
+    bool addSlave(uint8_t address, uint16_t pollAddress = 0, uint16_t pollQuantity = 0, PollCallback callback = nullptr);
+    bool removeSlave(uint8_t address);
+    uint8_t getSlaveCount() const { return _slaveCount; }
+
+    // 控制命令（发往指定从站，结果计入该从站统计）
+    bool submitRead(uint8_t slaveAddress, uint16_t address, uint16_t quantity,
+                    ModbusPriority priority, ModbusCallback callback);
+    bool submitWriteSingle(uint8_t slaveAddress, uint16_t address, uint16_t value,
+                           ModbusPriority priority, ModbusCallback callback);
+    bool submitWriteMultiple(uint8_t slaveAddress, uint16_t address, uint16_t quantity, const uint16_t* values,
+                             ModbusPriority priority, ModbusCallback callback);
+
+    /**
+     * 安排到期的轮询并推进事务队列，主循环每次迭代调用一次，不阻塞
+     */
+    void update();
+
+    // 轮询配置
+    void setPollInterval(uint16_t intervalMs) { _pollIntervalMs = intervalMs; }
+    void setPollBudget(uint8_t budget) { _pollBudget = budget; }
+    void setOfflineThreshold(uint8_t failures) { _offlineThreshold = failures; }
+    void setBackoff(uint32_t baseMs, uint32_t maxMs) { _backoffBaseMs = baseMs; _backoffMaxMs = maxMs; }
+
+    /**
+     * 获取从站统计
+     * @return 从站是否存在
+     */
+    bool getSlaveStatistics(uint8_t address, SlaveStatistics& stats) const;
+    bool isOnline(uint8_t address) const;
+    void resetStatistics();
+
+    ModbusRTUDriver& getDriver() { return _driver; }
+    ModbusTransactionQueue& getQueue() { return _queue; }
+
+private:
+    struct Slave {
+        bool inUse;
+        uint16_t pollAddress;
+        uint16_t pollQuantity;
+        PollCallback callback;
+        uint32_t nextPollMs;
+        bool pollPending;
+        uint32_t totalResponseMs;
+        SlaveStatistics stats;
+    };
+
+    Slave* findSlave(uint8_t address);
+    const Slave* findSlave(uint8_t address) const;
+    bool schedulePoll(uint32_t nowMs);
+    uint8_t getCommandRetries(uint8_t address) const;
+    void recordResult(uint8_t address, const ModbusResult& result, bool isPoll);
+    ModbusCallback wrapCallback(ModbusCallback callback);
+
+    ModbusRTUDriver _driver;
+    ModbusTransactionQueue _queue;
+
+    Slave _slaves[MAX_SLAVES];
+    uint8_t _slaveCount;
+    uint8_t _pollCursor;            // 轮询起点，每次安排后移到下一个从站
+    uint8_t _pollsInFlight;
+
+    uint16_t _pollIntervalMs;
+    uint8_t _pollBudget;
+    uint8_t _offlineThreshold;
+    uint32_t _backoffBaseMs;
+    uint32_t _backoffMaxMs;
+};
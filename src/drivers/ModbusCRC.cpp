@@ -0,0 +1,108 @@
+#include "ModbusCRC.h"
+
+namespace {
+
+// 编译期生成查表数据（C++11 constexpr，只能使用单条return的递归形式）
+
+// 对一个字节执行8次移位异或
+constexpr uint16_t crcShift(uint16_t crc, int bits) {
+    return bits == 0 ? crc : crcShift((crc & 0x0001) ? (crc >> 1) ^ 0xA001 : (crc >> 1), bits - 1);
+}
+
+// 第slice张表：T0为标准单字节表，Tn[i] = (Tn-1[i] >> 8) ^ T0[Tn-1[i] & 0xFF]
+constexpr uint16_t crcEntry(uint16_t index, int slice) {
+    return slice == 0
+        ? crcShift(index, 8)
+        : static_cast<uint16_t>((crcEntry(index, slice - 1) >> 8) ^ crcShift(crcEntry(index, slice - 1) & 0xFF, 8));
+}
+
+#define CRC_E(s, i)    crcEntry((i), (s))
+#define CRC_R4(s, i)   CRC_E(s, i), CRC_E(s, i + 1), CRC_E(s, i + 2), CRC_E(s, i + 3)
+#define CRC_R16(s, i)  CRC_R4(s, i), CRC_R4(s, i + 4), CRC_R4(s, i + 8), CRC_R4(s, i + 12)
+#define CRC_R64(s, i)  CRC_R16(s, i), CRC_R16(s, i + 16), CRC_R16(s, i + 32), CRC_R16(s, i + 48)
+#define CRC_R256(s)    CRC_R64(s, 0), CRC_R64(s, 64), CRC_R64(s, 128), CRC_R64(s, 192)
+
+// constexpr常量数组位于.rodata（flash），不占用RAM
+constexpr uint16_t CRC_TABLES[4][256] = {
+    { CRC_R256(0) },
+    { CRC_R256(1) },
+    { CRC_R256(2) },
+    { CRC_R256(3) }
+};
+
+#undef CRC_E
+#undef CRC_R4
+#undef CRC_R16
+#undef CRC_R64
+#undef CRC_R256
+
+static_assert(CRC_TABLES[0][1] == 0xC0C1, "CRC表生成错误");
+static_assert(CRC_TABLES[0][255] == 0x4040, "CRC表生成错误");
+
+} // namespace
+
+uint16_t ModbusCRC::calculate(const uint8_t* data, size_t length, CRCEngine engine) {
+    return update(INITIAL_VALUE, data, length, engine);
+}
+
+uint16_t ModbusCRC::update(uint16_t crc, const uint8_t* data, size_t length, CRCEngine engine) {
+    switch (engine) {
+        case CRCEngine::BITWISE:
+            return updateBitwise(crc, data, length);
+        case CRCEngine::SLICE_BY_4:
+            return updateSliceBy4(crc, data, length);
+        case CRCEngine::TABLE:
+        default:
+            return updateTable(crc, data, length);
+    }
+}
+
+uint16_t ModbusCRC::update(uint16_t crc, uint8_t byte) {
+    return (crc >> 8) ^ CRC_TABLES[0][(crc ^ byte) & 0xFF];
+}
+
+uint16_t ModbusCRC::updateBitwise(uint16_t crc, const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        
+        for (uint8_t j = 0; j < 8; j++) {
+            if (crc & 0x0001) {
+                crc = (crc >> 1) ^ 0xA001;
+            } else {
+                crc = crc >> 1;
+            }
+        }
+    }
+    
+    return crc;
+}
+
+uint16_t ModbusCRC::updateTable(uint16_t crc, const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        crc = (crc >> 8) ^ CRC_TABLES[0][(crc ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+uint16_t ModbusCRC::updateSliceBy4(uint16_t crc, const uint8_t* data, size_t length) {
+    // 按字节读取，避免Xtensa上的非对齐32位访问异常
+    while (length >= 4) {
+        crc ^= static_cast<uint16_t>(data[0] | (data[1] << 8));
+        crc = CRC_TABLES[3][crc & 0xFF] ^
+              CRC_TABLES[2][crc >> 8] ^
+              CRC_TABLES[1][data[2]] ^
+              CRC_TABLES[0][data[3]];
+        data += 4;
+        length -= 4;
+    }
+    return updateTable(crc, data, length);
+}
+
+const char* ModbusCRC::getEngineName(CRCEngine engine) {
+    switch (engine) {
+        case CRCEngine::BITWISE: return "bitwise";
+        case CRCEngine::TABLE: return "table";
+        case CRCEngine::SLICE_BY_4: return "slice-by-4";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * MODBUS CRC16 计算引擎
+ * 多项式 0xA001（0x8005反射），初值 0xFFFF，结果低字节在前发送
+ *
+ * 提供三种实现，结果完全一致：
+ * - BITWISE:    逐位移位异或，不占用查表空间
+ * - TABLE:      256项查表（512字节，编译期生成并放在flash），每字节一次查表
+ * - SLICE_BY_4: 4张256项表（2KB），每4字节并行查表，缩短数据依赖链
+ */
+enum class CRCEngine : uint8_t {
+    BITWISE = 0,
+    TABLE = 1,
+    SLICE_BY_4 = 2
+};
+
+class ModbusCRC {
+public:
+    static const uint16_t INITIAL_VALUE = 0xFFFF;
+    
+    /**
+     * 计算CRC
+     * @param data 数据
+     * @param length 数据长度
+     * @param engine 计算引擎
+     * @return CRC16值
+     */
+    static uint16_t calculate(const uint8_t* data, size_t length, CRCEngine engine = CRCEngine::TABLE);
+    
+    /**
+     * 增量计算：在已有CRC基础上继续处理数据
+     * 对完整帧（含末尾CRC）做增量计算，结果为0表示校验通过
+     * @param crc 当前CRC（首次使用INITIAL_VALUE）
+     * @param data 数据
+     * @param length 数据长度
+     * @param engine 计算引擎
+     * @return 更新后的CRC
+     */
+    static uint16_t update(uint16_t crc, const uint8_t* data, size_t length, CRCEngine engine = CRCEngine::TABLE);
+    
+    /**
+     * 单字节增量计算（查表）
+     */
+    static uint16_t update(uint16_t crc, uint8_t byte);
+    
+    // 各引擎实现
+    static uint16_t updateBitwise(uint16_t crc, const uint8_t* data, size_t length);
+    static uint16_t updateTable(uint16_t crc, const uint8_t* data, size_t length);
+    static uint16_t updateSliceBy4(uint16_t crc, const uint8_t* data, size_t length);
+    
+    /**
+     * 获取引擎名称
+     */
+    static const char* getEngineName(CRCEngine engine);
+};
@@ -0,0 +1,168 @@
+#include "ModbusFrameReceiver.h"
+
+ModbusFrameReceiver::ModbusFrameReceiver()
+    : _length(0), _expectedLength(0), _crc(ModbusCRC::INITIAL_VALUE),
+      _state(State::IDLE), _error(FrameError::NONE), _lastByteMicros(0),
+      _charTimeUs(0), _t35Us(0), _droppedBytes(0) {
+    begin(MODBUS_BAUD_RATE);
+}
+
+void ModbusFrameReceiver::begin(uint32_t baudRate) {
+    if (baudRate == 0) {
+        baudRate = MODBUS_BAUD_RATE;
+    }
+
+    // 8N1：每字符10位
+    _charTimeUs = (10UL * 1000000UL + baudRate - 1) / baudRate;
+
+    if (baudRate > 19200) {
+        _t35Us = 1750;
+    } else {
+        _t35Us = (_charTimeUs * 7 + 1) / 2;
+    }
+
+    reset();
+}
+
+void ModbusFrameReceiver::reset() {
+    _length = 0;
+    _expectedLength = 0;
+    _crc = ModbusCRC::INITIAL_VALUE;
+    _state = State::IDLE;
+    _error = FrameError::NONE;
+    _droppedBytes = 0;
+}
+
+void ModbusFrameReceiver::feed(uint8_t byte, uint32_t nowMicros) {
+    switch (_state) {
+        case State::FRAME_READY:
+            // 就绪帧未取走前不覆盖
+            _droppedBytes++;
+            _lastByteMicros = nowMicros;
+            return;
+
+        case State::FRAME_ERROR:
+            // 错误帧的剩余字节一律丢弃，直到出现T3.5静默
+            if (nowMicros - _lastByteMicros < _t35Us) {
+                _lastByteMicros = nowMicros;
+                return;
+            }
+            reset();
+            break;
+
+        default:
+            break;
+    }
+
+    if (_state == State::IDLE) {
+        _state = State::RECEIVING;
+    }
+
+    _lastByteMicros = nowMicros;
+
+    if (_length >= MAX_FRAME_SIZE) {
+        failFrame(FrameError::INVALID_LENGTH);
+        return;
+    }
+
+    _buffer[_length++] = byte;
+    _crc = ModbusCRC::update(_crc, byte);
+
+    if (_expectedLength == 0) {
+        _expectedLength = expectedResponseLength(_buffer, _length);
+        if (_expectedLength > MAX_FRAME_SIZE) {
+            failFrame(FrameError::INVALID_LENGTH);
+            return;
+        }
+    }
+
+    if (_expectedLength != 0 && _length >= _expectedLength) {
+        completeFrame();
+    }
+}
+
+bool ModbusFrameReceiver::poll(uint32_t nowMicros) {
+    if (_state != State::RECEIVING) {
+        return _state == State::FRAME_READY;
+    }
+
+    if (nowMicros - _lastByteMicros < _t35Us) {
+        return false;
+    }
+
+    if (_expectedLength != 0) {
+        // 长度已知但未收满
+        failFrame(FrameError::TRUNCATED);
+    } else if (_length < MIN_FRAME_SIZE) {
+        failFrame(FrameError::INVALID_LENGTH);
+    } else {
+        completeFrame();
+    }
+
+    return _state == State::FRAME_READY;
+}
+
+uint16_t ModbusFrameReceiver::expectedResponseLength(const uint8_t* frame, uint16_t received) {
+    if (received < 2) {
+        return 0;
+    }
+
+    uint8_t functionCode = frame[1];
+
+    // 异常应答：地址 + 功能码|0x80 + 异常码 + CRC
+    if (functionCode & 0x80) {
+        return 5;
+    }
+
+    switch (functionCode) {
+        case 0x01:  // 读线圈
+        case 0x02:  // 读离散输入
+        case 0x03:  // 读保持寄存器
+        case 0x04:  // 读输入寄存器
+        case 0x17:  // 读写多个寄存器
+            // 地址 + 功能码 + 字节数 + 数据 + CRC
+            if (received < 3) {
+                return 0;
+            }
+            return 5 + frame[2];
+
+        case 0x05:  // 写单个线圈
+        case 0x06:  // 写单个寄存器
+        case 0x08:  // 诊断（回显）
+        case 0x0F:  // 写多个线圈
+        case 0x10:  // 写多个寄存器
+            return 8;
+
+        case 0x07:  // 读异常状态
+            return 5;
+
+        default:
+            // 未知功能码，以静默判定帧结束
+            return 0;
+    }
+}
+
+const char* ModbusFrameReceiver::getErrorName(FrameError error) {
+    switch (error) {
+        case FrameError::NONE: return "None";
+        case FrameError::CRC_MISMATCH: return "CRC mismatch";
+        case FrameError::INVALID_LENGTH: return "Invalid length";
+        case FrameError::TRUNCATED: return "Truncated";
+        default: return "Unknown";
+    }
+}
+
+void ModbusFrameReceiver::completeFrame() {
+    // 对含CRC的完整帧增量计算，余数为0即校验通过
+    if (_crc != 0) {
+        failFrame(FrameError::CRC_MISMATCH);
+        return;
+    }
+    _state = State::FRAME_READY;
+    _error = FrameError::NONE;
+}
+
+void ModbusFrameReceiver::failFrame(FrameError error) {
+    _state = State::FRAME_ERROR;
+    _error = error;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <Arduino.h>
+#include "ModbusCRC.h"
+#include "../common/Config.h"
+
+/**
+ * MODBUS RTU 流式帧接收器（主站侧，解析从站应答）
+ *
+ * 逐字节喂入数据，不做任何等待：
+ * - 按功能码推算帧长，收满即校验完成，无需等待帧间静默
+ * - 功能码未知时，以3.5个字符时间(T3.5)的总线静默判定帧结束
+ * - 已知长度的帧在收满前出现T3.5静默，视为帧被截断
+ * - CRC随字节增量计算，完整帧（含CRC）的余数为0即校验通过
+ *
+ * @note 字节时间戳取自读出UART缓冲区的时刻而非真实到达时刻，
+ *       因此不做T1.5字符间隔检查；静默检测的精度取决于poll()的调用间隔，
+ *       按长度完成的帧不受调用间隔影响
+ */
+class ModbusFrameReceiver {
+public:
+    static const uint16_t MAX_FRAME_SIZE = 256;
+    static const uint16_t MIN_FRAME_SIZE = 4;   // 地址 + 功能码 + CRC
+
+    enum class State : uint8_t {
+        IDLE = 0,           // 等待帧起始
+        RECEIVING = 1,      // 正在接收
+        FRAME_READY = 2,    // 完整帧已就绪，等待取走
+        FRAME_ERROR = 3     // 帧错误，等待总线静默后重新同步
+    };
+
+    enum class FrameError : uint8_t {
+        NONE = 0,
+        CRC_MISMATCH = 1,   // CRC校验失败
+        INVALID_LENGTH = 2, // 长度与功能码不符或超出缓冲区
+        TRUNCATED = 3       // 帧未收满即出现T3.5静默
+    };
+
+    ModbusFrameReceiver();
+
+    /**
+     * 根据波特率计算T3.5并复位
+     * 波特率高于19200时按规范使用固定值1750us
+     * @param baudRate 波特率
+     */
+    void begin(uint32_t baudRate);
+
+    /**
+     * 丢弃当前帧，回到空闲状态
+     */
+    void reset();
+
+    /**
+     * 喂入一个接收到的字节
+     * @param byte 字节
+     * @param nowMicros 字节到达时间(micros())
+     */
+    void feed(uint8_t byte, uint32_t nowMicros);
+
+    /**
+     * 检查总线静默，判定以静默结束的帧
+     * @param nowMicros 当前时间(micros())
+     * @return 是否有完整帧就绪
+     */
+    bool poll(uint32_t nowMicros);
+
+    // 状态查询
+    State getState() const { return _state; }
+    bool isFrameReady() const { return _state == State::FRAME_READY; }
+    bool hasError() const { return _state == State::FRAME_ERROR; }
+    bool isReceiving() const { return _state == State::RECEIVING; }
+    FrameError getError() const { return _error; }
+
+    /**
+     * 已就绪帧的数据（含地址、功能码和CRC）
+     */
+    const uint8_t* getFrame() const { return _buffer; }
+    uint16_t getFrameLength() const { return _state == State::FRAME_READY ? _length : 0; }
+
+    // 时序参数
+    uint32_t getCharTimeMicros() const { return _charTimeUs; }
+    uint32_t getT35Micros() const { return _t35Us; }
+
+    /**
+     * 帧就绪后到达的多余字节数（调试用）
+     */
+    uint32_t getDroppedBytes() const { return _droppedBytes; }
+
+    /**
+     * 根据已收到的帧头推算应答帧总长度
+     * @param frame 已收到的数据
+     * @param received 已收到的字节数
+     * @return 帧总长度；0表示尚无法确定（需要更多字节或功能码未知）
+     */
+    static uint16_t expectedResponseLength(const uint8_t* frame, uint16_t received);
+
+    /**
+     * 错误名称
+     */
+    static const char* getErrorName(FrameError error);
+
+private:
+    void completeFrame();
+    void failFrame(FrameError error);
+
+    uint8_t _buffer[MAX_FRAME_SIZE];
+    uint16_t _length;
+    uint16_t _expectedLength;
+    uint16_t _crc;
+    State _state;
+    FrameError _error;
+    uint32_t _lastByteMicros;
+    uint32_t _charTimeUs;
+    uint32_t _t35Us;
+    uint32_t _droppedBytes;
+};
@@ -1,7 +1,8 @@
 #include "ModbusRTUDriver.h"
 
 ModbusRTUDriver::ModbusRTUDriver() 
-    : _slaveAddress(0x01), _timeout(100), _maxRetries(3), _lastError(ERROR_NONE) {
+    : _slaveAddress(0x01), _timeout(100), _maxRetries(3), _lastError(ERROR_NONE),
+      _lastExceptionCode(0), _crcEngine(CRCEngine::TABLE), _lastRxMicros(0), _requestLength(0) {
 }
 
 ModbusRTUDriver::~ModbusRTUDriver() {
@@ -15,175 +16,244 @@ bool ModbusRTUDriver::begin(uint8_t rxPin, uint8_t txPin, uint32_t baudRate, uin
     }
     
     _serial.setTimeout(_timeout);
+    _receiver.begin(baudRate);
     return true;
 }
 
 bool ModbusRTUDriver::readHoldingRegisters(uint16_t startAddress, uint16_t quantity, uint16_t* values) {
-    if (quantity == 0 || quantity > 125) {
-        _lastError = ERROR_INVALID_RESPONSE;
+    return transact(0x03, startAddress, quantity, nullptr, values);
+}
+
+bool ModbusRTUDriver::writeSingleRegister(uint16_t address, uint16_t value) {
+    return transact(0x06, address, 1, &value, nullptr);
+}
+
+bool ModbusRTUDriver::writeMultipleRegisters(uint16_t startAddress, uint16_t quantity, const uint16_t* values) {
+    return transact(0x10, startAddress, quantity, values, nullptr);
+}
+
+bool ModbusRTUDriver::sendRequest(uint8_t functionCode, uint16_t address, uint16_t quantity, const uint16_t* values) {
+    if (!buildRequest(functionCode, address, quantity, values)) {
         return false;
     }
+    if (!sendFrame(_request, _requestLength)) {
+        _lastError = ERROR_TIMEOUT;
+        return false;
+    }
+    return true;
+}
+
+bool ModbusRTUDriver::parseResponse(uint16_t* values) {
+    const uint8_t* response = _receiver.getFrame();
+    uint16_t length = _receiver.getFrameLength();
+    uint8_t functionCode = _request[1];
+    bool valid = false;
     
-    uint8_t request[8];
-    request[0] = _slaveAddress;
-    request[1] = 0x03;
-    request[2] = (startAddress >> 8) & 0xFF;
-    request[3] = startAddress & 0xFF;
-    request[4] = (quantity >> 8) & 0xFF;
-    request[5] = quantity & 0xFF;
-    
-    uint16_t crc = calculateCRC(request, 6);
-    request[6] = crc & 0xFF;
-    request[7] = (crc >> 8) & 0xFF;
+    _lastExceptionCode = 0;
+    if (length == 0 || _requestLength == 0) {
+        _lastError = ERROR_TIMEOUT;
+        return false;
+    }
     
-    for (uint8_t retry = 0; retry <= _maxRetries; retry++) {
-        if (sendFrame(request, 8)) {
-            uint8_t response[256];
-            uint16_t responseLength = 0;
-            
-            if (receiveFrame(response, sizeof(response), responseLength)) {
-                if (responseLength >= 5 && response[0] == _slaveAddress && response[1] == 0x03) {
-                    uint8_t byteCount = response[2];
-                    if (byteCount == quantity * 2 && responseLength >= 5 + byteCount) {
+    if (response[0] != _request[0]) {
+        _lastError = ERROR_INVALID_RESPONSE;
+    } else if (response[1] == (functionCode | 0x80)) {
+        // 异常应答固定为 地址 + 功能码|0x80 + 异常码 + CRC
+        if (length == 5 && response[2] != 0) {
+            _lastError = ERROR_EXCEPTION;
+            _lastExceptionCode = response[2];
+        } else {
+            _lastError = ERROR_INVALID_RESPONSE;
+        }
+    } else if (response[1] != functionCode) {
+        _lastError = ERROR_INVALID_RESPONSE;
+    } else {
+        switch (functionCode) {
+            case 0x03: {
+                uint16_t quantity = (_request[4] << 8) | _request[5];
+                uint8_t byteCount = length >= 5 ? response[2] : 0;
+                if (byteCount == quantity * 2 && length == 5 + byteCount) {
+                    if (values) {
                         for (uint16_t i = 0; i < quantity; i++) {
                             values[i] = (response[3 + i * 2] << 8) | response[4 + i * 2];
                         }
-                        _lastError = ERROR_NONE;
-                        return true;
                     }
+                    valid = true;
                 }
+                break;
             }
+            case 0x06:
+                // 写单个寄存器应答为请求的回显
+                valid = length == 8 && memcmp(_request, response, 8) == 0;
+                break;
+            case 0x10:
+                // 应答回显起始地址和数量
+                valid = length == 8 && memcmp(_request + 2, response + 2, 4) == 0;
+                break;
+            default:
+                break;
         }
-        
-        if (retry < _maxRetries) {
-            delay(10);
-        }
+        _lastError = valid ? ERROR_NONE : ERROR_INVALID_RESPONSE;
     }
     
-    _lastError = ERROR_TIMEOUT;
-    return false;
+    _receiver.reset();
+    return valid;
 }
 
-bool ModbusRTUDriver::writeSingleRegister(uint16_t address, uint16_t value) {
-    uint8_t request[8];
-    request[0] = _slaveAddress;
-    request[1] = 0x06;
-    request[2] = (address >> 8) & 0xFF;
-    request[3] = address & 0xFF;
-    request[4] = (value >> 8) & 0xFF;
-    request[5] = value & 0xFF;
-    
-    uint16_t crc = calculateCRC(request, 6);
-    request[6] = crc & 0xFF;
-    request[7] = (crc >> 8) & 0xFF;
+uint16_t ModbusRTUDriver::calculateCRC(const uint8_t* data, uint16_t length) {
+    return ModbusCRC::calculate(data, length, _crcEngine);
+}
+
+bool ModbusRTUDriver::sendFrame(const uint8_t* frame, uint16_t length) {
+    // 丢弃上一次事务遗留的字节（如超时后才到达的应答），避免与本次应答拼接
+    while (_serial.available() > 0) {
+        _serial.read();
+    }
+    _receiver.reset();
     
-    for (uint8_t retry = 0; retry <= _maxRetries; retry++) {
-        if (sendFrame(request, 8)) {
-            uint8_t response[8];
-            uint16_t responseLength = 0;
-            
-            if (receiveFrame(response, sizeof(response), responseLength)) {
-                if (responseLength == 8 && memcmp(request, response, 8) == 0) {
-                    _lastError = ERROR_NONE;
-                    return true;
-                }
-            }
-        }
-        
-        if (retry < _maxRetries) {
-            delay(10);
+    return _serial.write(frame, length) == length;
+}
+
+bool ModbusRTUDriver::poll() {
+    while (_serial.available() > 0) {
+        int value = _serial.read();
+        if (value < 0) {
+            break;
         }
+        _lastRxMicros = micros();
+        _receiver.feed(static_cast<uint8_t>(value), _lastRxMicros);
     }
     
-    _lastError = ERROR_TIMEOUT;
-    return false;
+    return _receiver.poll(micros());
 }
 
-bool ModbusRTUDriver::writeMultipleRegisters(uint16_t startAddress, uint16_t quantity, const uint16_t* values) {
-    if (quantity == 0 || quantity > 123) {
+bool ModbusRTUDriver::buildRequest(uint8_t functionCode, uint16_t address, uint16_t quantity, const uint16_t* values) {
+    uint16_t length = 0;
+    
+    _request[0] = _slaveAddress;
+    _request[1] = functionCode;
+    _request[2] = (address >> 8) & 0xFF;
+    _request[3] = address & 0xFF;
+    
+    switch (functionCode) {
+        case 0x03:
+            if (quantity == 0 || quantity > 125) {
+                break;
+            }
+            _request[4] = (quantity >> 8) & 0xFF;
+            _request[5] = quantity & 0xFF;
+            length = 6;
+            break;
+        case 0x06:
+            if (quantity != 1 || !values) {
+                break;
+            }
+            _request[4] = (values[0] >> 8) & 0xFF;
+            _request[5] = values[0] & 0xFF;
+            length = 6;
+            break;
+        case 0x10:
+            if (quantity == 0 || quantity > 123 || !values) {
+                break;
+            }
+            _request[4] = (quantity >> 8) & 0xFF;
+            _request[5] = quantity & 0xFF;
+            _request[6] = quantity * 2;
+            for (uint16_t i = 0; i < quantity; i++) {
+                _request[7 + i * 2] = (values[i] >> 8) & 0xFF;
+                _request[8 + i * 2] = values[i] & 0xFF;
+            }
+            length = 7 + quantity * 2;
+            break;
+        default:
+            break;
+    }
+    
+    if (length == 0) {
+        _requestLength = 0;
         _lastError = ERROR_INVALID_RESPONSE;
         return false;
     }
     
-    uint8_t request[256];
-    request[0] = _slaveAddress;
-    request[1] = 0x10;
-    request[2] = (startAddress >> 8) & 0xFF;
-    request[3] = startAddress & 0xFF;
-    request[4] = (quantity >> 8) & 0xFF;
-    request[5] = quantity & 0xFF;
-    request[6] = quantity * 2;
-    
-    for (uint16_t i = 0; i < quantity; i++) {
-        request[7 + i * 2] = (values[i] >> 8) & 0xFF;
-        request[8 + i * 2] = values[i] & 0xFF;
+    uint16_t crc = calculateCRC(_request, length);
+    _request[length] = crc & 0xFF;
+    _request[length + 1] = (crc >> 8) & 0xFF;
+    _requestLength = length + 2;
+    return true;
+}
+
+bool ModbusRTUDriver::transact(uint8_t functionCode, uint16_t address, uint16_t quantity,
+                               const uint16_t* writeValues, uint16_t* readValues) {
+    if (!buildRequest(functionCode, address, quantity, writeValues)) {
+        return false;
     }
     
-    uint16_t crc = calculateCRC(request, 7 + quantity * 2);
-    request[7 + quantity * 2] = crc & 0xFF;
-    request[8 + quantity * 2] = (crc >> 8) & 0xFF;
-    
     for (uint8_t retry = 0; retry <= _maxRetries; retry++) {
-        if (sendFrame(request, 9 + quantity * 2)) {
-            uint8_t response[8];
-            uint16_t responseLength = 0;
-            
-            if (receiveFrame(response, sizeof(response), responseLength)) {
-                if (responseLength == 8 && response[0] == _slaveAddress && response[1] == 0x10) {
-                    uint16_t respAddress = (response[2] << 8) | response[3];
-                    uint16_t respQuantity = (response[4] << 8) | response[5];
-                    
-                    if (respAddress == startAddress && respQuantity == quantity) {
-                        _lastError = ERROR_NONE;
-                        return true;
-                    }
-                }
+        _lastExceptionCode = 0;
+        if (sendFrame(_request, _requestLength)) {
+            if (waitForFrame() && parseResponse(readValues)) {
+                return true;
             }
+        } else {
+            _lastError = ERROR_TIMEOUT;
         }
         
+        ModbusRetryPolicy policy = getRetryPolicy(_lastError, _lastExceptionCode);
+        if (policy == ModbusRetryPolicy::NO_RETRY) {
+            return false;
+        }
+        
+        // 超时和从站忙等待重试间隔；损坏的帧不必等待重试间隔，但从站可能仍在发送，等线路静默T3.5后重发
         if (retry < _maxRetries) {
-            delay(10);
+            if (policy == ModbusRetryPolicy::DELAYED) {
+                delay(RETRY_DELAY_MS);
+            } else {
+                waitForLineSilence();
+            }
         }
     }
     
-    _lastError = ERROR_TIMEOUT;
     return false;
 }
 
-uint16_t ModbusRTUDriver::calculateCRC(const uint8_t* data, uint16_t length) {
-    uint16_t crc = 0xFFFF;
+bool ModbusRTUDriver::waitForFrame() {
+    unsigned long startTime = millis();
     
-    for (uint16_t i = 0; i < length; i++) {
-        crc ^= data[i];
+    // 帧按长度收满或T3.5静默后立即返回，不再等待readBytes超时
+    while (millis() - startTime < _timeout) {
+        if (poll()) {
+            return true;
+        }
         
-        for (uint8_t j = 0; j < 8; j++) {
-            if (crc & 0x0001) {
-                crc = (crc >> 1) ^ 0xA001;
-            } else {
-                crc = crc >> 1;
-            }
+        if (_receiver.hasError()) {
+            _lastError = _receiver.getError() == ModbusFrameReceiver::FrameError::CRC_MISMATCH
+                             ? ERROR_CRC : ERROR_INVALID_RESPONSE;
+            return false;
         }
+        
+        delay(1);
     }
     
-    return crc;
+    _lastError = ERROR_TIMEOUT;
+    return false;
 }
 
-bool ModbusRTUDriver::sendFrame(const uint8_t* frame, uint16_t length) {
-    return _serial.write(frame, length) == length;
+bool ModbusRTUDriver::isLineSilent() {
+    while (_serial.available() > 0) {
+        if (_serial.read() < 0) {
+            break;
+        }
+        _lastRxMicros = micros();
+    }
+    return micros() - _lastRxMicros >= _receiver.getT35Micros();
 }
 
-bool ModbusRTUDriver::receiveFrame(uint8_t* buffer, uint16_t maxLength, uint16_t& receivedLength) {
+void ModbusRTUDriver::waitForLineSilence() {
+    // 从站持续发送时最多等待一个应答超时，之后的重发由应答校验处理
     unsigned long startTime = millis();
-    
-    while (millis() - startTime < _timeout) {
-        if (_serial.available() > 0) {
-            receivedLength = _serial.readBytes(buffer, maxLength);
-            return receivedLength > 0;
-        }
+    while (!isLineSilent() && millis() - startTime < _timeout) {
         delay(1);
     }
-    
-    return false;
 }
 
 String ModbusRTUDriver::getLastErrorString() const {
@@ -191,8 +261,39 @@ String ModbusRTUDriver::getLastErrorString() const {
         case ERROR_NONE: return "No error";
         case ERROR_TIMEOUT: return "Timeout";
         case ERROR_CRC: return "CRC error";
-        case ERROR_EXCEPTION: return "Exception response";
+        case ERROR_EXCEPTION: return String("Exception response: ") + getExceptionString(_lastExceptionCode);
         case ERROR_INVALID_RESPONSE: return "Invalid response";
         default: return "Unknown error";
     }
+}
+
+ModbusRetryPolicy ModbusRTUDriver::getRetryPolicy(uint8_t error, uint8_t exceptionCode) {
+    switch (error) {
+        case ERROR_CRC:
+        case ERROR_INVALID_RESPONSE:
+            return ModbusRetryPolicy::IMMEDIATE;
+        case ERROR_EXCEPTION:
+            // 从站忙或已受理长操作时稍后重发有意义，其余异常重发结果不变
+            return exceptionCode == EXCEPTION_SLAVE_DEVICE_BUSY || exceptionCode == EXCEPTION_ACKNOWLEDGE
+                       ? ModbusRetryPolicy::DELAYED : ModbusRetryPolicy::NO_RETRY;
+        case ERROR_NONE:
+            return ModbusRetryPolicy::NO_RETRY;
+        case ERROR_TIMEOUT:
+        default:
+            return ModbusRetryPolicy::DELAYED;
+    }
+}
+
+const char* ModbusRTUDriver::getExceptionString(uint8_t exceptionCode) {
+    switch (exceptionCode) {
+        case EXCEPTION_ILLEGAL_FUNCTION: return "Illegal function";
+        case EXCEPTION_ILLEGAL_DATA_ADDRESS: return "Illegal data address";
+        case EXCEPTION_ILLEGAL_DATA_VALUE: return "Illegal data value";
+        case EXCEPTION_SLAVE_DEVICE_FAILURE: return "Slave device failure";
+        case EXCEPTION_ACKNOWLEDGE: return "Acknowledge";
+        case EXCEPTION_SLAVE_DEVICE_BUSY: return "Slave device busy";
+        case EXCEPTION_GATEWAY_PATH_UNAVAILABLE: return "Gateway path unavailable";
+        case EXCEPTION_GATEWAY_TARGET_NO_RESPONSE: return "Gateway target no response";
+        default: return "Unknown exception";
+    }
 }
\ No newline at end of file
@@ -2,8 +2,19 @@
 
 #include <Arduino.h>
 #include "SerialDriver.h"
+#include "ModbusCRC.h"
+#include "ModbusFrameReceiver.h"
 #include "../common/Config.h"
 
+/**
+ * 失败后的重试策略，由错误类型决定
+ */
+enum class ModbusRetryPolicy : uint8_t {
+    NO_RETRY = 0,   // 从站明确拒绝了请求（异常应答），重发结果相同
+    IMMEDIATE = 1,  // 应答帧损坏（CRC错误、无效帧），总线静默T3.5后立即重发
+    DELAYED = 2     // 无应答或从站忙，等待重试间隔后重发
+};
+
 class ModbusRTUDriver {
 public:
     ModbusRTUDriver();
@@ -12,38 +23,117 @@ public:
     
     // 初始化
     bool begin(uint8_t rxPin = MODBUS_RX_PIN, uint8_t txPin = MODBUS_TX_PIN, uint32_t baudRate = MODBUS_BAUD_RATE, uint8_t slaveAddress = MODBUS_SLAVE_ADDRESS);
-    // MODBUS功能码实现
+    // MODBUS功能码实现（同步：阻塞直到应答或重试耗尽）
     bool readHoldingRegisters(uint16_t startAddress, uint16_t quantity, uint16_t* values);
     bool writeSingleRegister(uint16_t address, uint16_t value);
     bool writeMultipleRegisters(uint16_t startAddress, uint16_t quantity, const uint16_t* values);
     
+    // 非阻塞事务：sendRequest()发送后反复调用poll()，帧就绪后用parseResponse()校验
+    /**
+     * 构造并发送请求帧，不等待应答
+     * @param functionCode 功能码(0x03/0x06/0x10)
+     * @param address 起始地址
+     * @param quantity 寄存器数量（0x06固定为1）
+     * @param values 写入值，读请求传nullptr
+     * @return 参数有效且发送成功
+     */
+    bool sendRequest(uint8_t functionCode, uint16_t address, uint16_t quantity, const uint16_t* values = nullptr);
+    
+    /**
+     * 校验已就绪的应答帧与最近一次请求是否匹配，并丢弃该帧
+     * @param values 读请求的寄存器值输出，可为nullptr
+     * @return 是否为有效的正常应答；失败原因见getLastError()
+     */
+    bool parseResponse(uint16_t* values);
+    
+    /**
+     * 读出UART中已到达的字节并推进帧接收状态机，不等待
+     * @return 是否有完整且CRC正确的应答帧就绪
+     */
+    bool poll();
+    bool isFrameReady() const { return _receiver.isFrameReady(); }
+    const uint8_t* getFrame() const { return _receiver.getFrame(); }
+    uint16_t getFrameLength() const { return _receiver.getFrameLength(); }
+    /**
+     * 丢弃已就绪或出错的帧，准备接收下一帧
+     */
+    void clearFrame() { _receiver.reset(); }
+    
+    /**
+     * 读出并丢弃线路上的剩余字节，判断自最后一个接收字节起是否已静默T3.5，不等待
+     * 已知长度的帧收满即校验，帧错误（如字节数被破坏）判定时从站可能仍在发送，重发前需等待线路静默
+     * @return 线路是否已静默
+     */
+    bool isLineSilent();
+    const ModbusFrameReceiver& getReceiver() const { return _receiver; }
+    
     // 配置
     void setSlaveAddress(uint8_t address) { _slaveAddress = address; }
     void setTimeout(uint16_t timeout) { _timeout = timeout; }
     void setRetries(uint8_t retries) { _maxRetries = retries; }
+    void setCRCEngine(CRCEngine engine) { _crcEngine = engine; }
+    CRCEngine getCRCEngine() const { return _crcEngine; }
+    uint8_t getSlaveAddress() const { return _slaveAddress; }
+    uint16_t getTimeout() const { return _timeout; }
+    uint8_t getRetries() const { return _maxRetries; }
     
     // 错误信息
     uint8_t getLastError() const { return _lastError; }
+    /**
+     * 最近一次异常应答的异常码，错误不是ERROR_EXCEPTION时为0
+     */
+    uint8_t getLastExceptionCode() const { return _lastExceptionCode; }
     String getLastErrorString() const;
     
+    /**
+     * 按错误类型选择重试策略：异常应答不重试（从站忙/确认除外），
+     * CRC错误和无效应答立即重试，超时延时重试
+     */
+    static ModbusRetryPolicy getRetryPolicy(uint8_t error, uint8_t exceptionCode);
+    static const char* getExceptionString(uint8_t exceptionCode);
+    
+    // 错误码定义
+    static const uint8_t ERROR_NONE = 0;
+    static const uint8_t ERROR_TIMEOUT = 1;
+    static const uint8_t ERROR_CRC = 2;
+    static const uint8_t ERROR_EXCEPTION = 3;
+    static const uint8_t ERROR_INVALID_RESPONSE = 4;
+    
+    // 异常码定义（异常应答的第3字节）
+    static const uint8_t EXCEPTION_ILLEGAL_FUNCTION = 0x01;
+    static const uint8_t EXCEPTION_ILLEGAL_DATA_ADDRESS = 0x02;
+    static const uint8_t EXCEPTION_ILLEGAL_DATA_VALUE = 0x03;
+    static const uint8_t EXCEPTION_SLAVE_DEVICE_FAILURE = 0x04;
+    static const uint8_t EXCEPTION_ACKNOWLEDGE = 0x05;
+    static const uint8_t EXCEPTION_SLAVE_DEVICE_BUSY = 0x06;
+    static const uint8_t EXCEPTION_GATEWAY_PATH_UNAVAILABLE = 0x0A;
+    static const uint8_t EXCEPTION_GATEWAY_TARGET_NO_RESPONSE = 0x0B;
+    
+    // 超时或从站忙时的重试间隔
+    static const uint16_t RETRY_DELAY_MS = 10;
+    
 private:
     // 内部方法
     uint16_t calculateCRC(const uint8_t* data, uint16_t length);
+    bool buildRequest(uint8_t functionCode, uint16_t address, uint16_t quantity, const uint16_t* values);
     bool sendFrame(const uint8_t* frame, uint16_t length);
-    bool receiveFrame(uint8_t* buffer, uint16_t maxLength, uint16_t& receivedLength);
-    bool validateResponse(const uint8_t* response, uint16_t length);
+    bool waitForFrame();
+    void waitForLineSilence();
+    bool transact(uint8_t functionCode, uint16_t address, uint16_t quantity,
+                  const uint16_t* writeValues, uint16_t* readValues);
     
     // 成员变量
     SerialDriver _serial;
+    ModbusFrameReceiver _receiver;
     uint8_t _slaveAddress;
     uint16_t _timeout;
     uint8_t _maxRetries;
     uint8_t _lastError;
+    uint8_t _lastExceptionCode;
+    CRCEngine _crcEngine;
+    uint32_t _lastRxMicros;     // 最后一个接收字节读出的时刻
     
-    // 错误码定义
-    static const uint8_t ERROR_NONE = 0;
-    static const uint8_t ERROR_TIMEOUT = 1;
-    static const uint8_t ERROR_CRC = 2;
-    static const uint8_t ERROR_EXCEPTION = 3;
-    static const uint8_t ERROR_INVALID_RESPONSE = 4;
+    // 最近一次请求，用于校验应答
+    uint8_t _request[256];
+    uint16_t _requestLength;
 };
\ No newline at end of file
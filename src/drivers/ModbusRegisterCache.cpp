@@ -0,0 +1,187 @@
+#include "ModbusRegisterCache.h"
+
+ModbusRegisterCache::ModbusRegisterCache(uint16_t baseAddress, uint8_t count, uint32_t defaultTtlMs)
+    : _baseAddress(baseAddress), _count(count > MAX_REGISTERS ? MAX_REGISTERS : count), _mutex(nullptr) {
+    _mutex = xSemaphoreCreateMutex();
+    for (uint8_t i = 0; i < MAX_REGISTERS; i++) {
+        _entries[i].value = 0;
+        _entries[i].valid = false;
+        _entries[i].updatedMs = 0;
+        _entries[i].ttlMs = defaultTtlMs;
+    }
+    resetStatistics();
+}
+
+ModbusRegisterCache::~ModbusRegisterCache() {
+    if (_mutex != nullptr) {
+        vSemaphoreDelete(_mutex);
+        _mutex = nullptr;
+    }
+}
+
+void ModbusRegisterCache::setTTL(uint16_t address, uint16_t quantity, uint32_t ttlMs) {
+    if (!covers(address, quantity) || !lock()) {
+        return;
+    }
+    for (uint16_t i = 0; i < quantity; i++) {
+        _entries[address - _baseAddress + i].ttlMs = ttlMs;
+    }
+    unlock();
+}
+
+bool ModbusRegisterCache::covers(uint16_t address, uint16_t quantity) const {
+    return quantity > 0 && address >= _baseAddress &&
+           (uint32_t)address + quantity <= (uint32_t)_baseAddress + _count;
+}
+
+bool ModbusRegisterCache::lookup(uint16_t address, uint16_t quantity, uint16_t* values, uint32_t nowMs) {
+    if (!covers(address, quantity) || !lock()) {
+        return false;
+    }
+
+    _stats.registersRequested += quantity;
+
+    uint16_t offset = address - _baseAddress;
+    for (uint16_t i = 0; i < quantity; i++) {
+        if (!isFresh(_entries[offset + i], nowMs)) {
+            _stats.misses++;
+            unlock();
+            return false;
+        }
+    }
+
+    for (uint16_t i = 0; i < quantity; i++) {
+        values[i] = _entries[offset + i].value;
+    }
+    _stats.hits++;
+    unlock();
+    return true;
+}
+
+bool ModbusRegisterCache::getStaleSpan(uint16_t address, uint16_t quantity, uint32_t nowMs,
+                                       uint16_t& spanAddress, uint16_t& spanQuantity) {
+    if (!covers(address, quantity)) {
+        // 不在缓存范围内，整段都需要读取
+        spanAddress = address;
+        spanQuantity = quantity;
+        return quantity > 0;
+    }
+    if (!lock()) {
+        return false;
+    }
+
+    uint16_t offset = address - _baseAddress;
+    int first = -1;
+    int last = -1;
+    for (uint16_t i = 0; i < quantity; i++) {
+        if (!isFresh(_entries[offset + i], nowMs)) {
+            if (first < 0) {
+                first = i;
+            }
+            last = i;
+        }
+    }
+
+    if (first < 0) {
+        unlock();
+        return false;
+    }
+
+    // 中间夹着的新鲜寄存器一并读取，一次请求比拆成多次便宜
+    spanAddress = address + first;
+    spanQuantity = last - first + 1;
+    unlock();
+    return true;
+}
+
+void ModbusRegisterCache::store(uint16_t address, uint16_t quantity, const uint16_t* values, uint32_t nowMs) {
+    if (!lock()) {
+        return;
+    }
+    for (uint16_t i = 0; i < quantity; i++) {
+        uint32_t reg = (uint32_t)address + i;
+        if (reg < _baseAddress || reg >= (uint32_t)_baseAddress + _count) {
+            continue;
+        }
+        Entry& entry = _entries[reg - _baseAddress];
+        entry.value = values[i];
+        entry.valid = true;
+        entry.updatedMs = nowMs;
+    }
+    unlock();
+}
+
+void ModbusRegisterCache::storeRead(uint16_t address, uint16_t quantity, const uint16_t* values, uint32_t nowMs) {
+    store(address, quantity, values, nowMs);
+    if (!lock()) {
+        return;
+    }
+    _stats.registersRead += quantity;
+    unlock();
+}
+
+bool ModbusRegisterCache::getFresh(uint16_t address, uint16_t& value, uint32_t nowMs) {
+    if (!covers(address, 1) || !lock()) {
+        return false;
+    }
+
+    const Entry& entry = _entries[address - _baseAddress];
+    bool fresh = isFresh(entry, nowMs);
+    if (fresh) {
+        value = entry.value;
+    }
+    unlock();
+    return fresh;
+}
+
+bool ModbusRegisterCache::copy(uint16_t address, uint16_t quantity, uint16_t* values) {
+    if (!covers(address, quantity) || !lock()) {
+        return false;
+    }
+
+    bool allValid = true;
+    uint16_t offset = address - _baseAddress;
+    for (uint16_t i = 0; i < quantity; i++) {
+        values[i] = _entries[offset + i].value;
+        allValid = allValid && _entries[offset + i].valid;
+    }
+    unlock();
+    return allValid;
+}
+
+void ModbusRegisterCache::invalidate(uint16_t address, uint16_t quantity) {
+    if (!lock()) {
+        return;
+    }
+    for (uint16_t i = 0; i < quantity; i++) {
+        uint32_t reg = (uint32_t)address + i;
+        if (reg >= _baseAddress && reg < (uint32_t)_baseAddress + _count) {
+            _entries[reg - _baseAddress].valid = false;
+        }
+    }
+    unlock();
+}
+
+void ModbusRegisterCache::invalidateAll() {
+    invalidate(_baseAddress, _count);
+}
+
+void ModbusRegisterCache::resetStatistics() {
+    _stats.hits = 0;
+    _stats.misses = 0;
+    _stats.registersRequested = 0;
+    _stats.registersRead = 0;
+}
+
+bool ModbusRegisterCache::isFresh(const Entry& entry, uint32_t nowMs) const {
+    // TTL为0的寄存器不缓存；用差值比较，millis()回绕时仍然正确
+    return entry.valid && entry.ttlMs > 0 && (uint32_t)(nowMs - entry.updatedMs) < entry.ttlMs;
+}
+
+bool ModbusRegisterCache::lock() {
+    return _mutex != nullptr && xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE;
+}
+
+void ModbusRegisterCache::unlock() {
+    xSemaphoreGive(_mutex);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/**
+ * MODBUS保持寄存器影子缓存
+ *
+ * 覆盖从站一段连续的寄存器，每个寄存器单独记录更新时间和有效期(TTL)：
+ * - lookup()在请求范围内全部新鲜时直接返回缓存值，否则记为未命中
+ * - getStaleSpan()把请求范围内的过期寄存器合并成一个连续区间，只需一次读取，读取成功后用storeRead()写入
+ * - 本地写入成功后用store()写穿缓存，失败时用invalidate()作废
+ *
+ * 可在主循环和BLE回调等不同任务中访问，内部加锁。
+ */
+class ModbusRegisterCache {
+public:
+    static const uint8_t MAX_REGISTERS = 16;
+
+    /**
+     * 缓存统计
+     */
+    struct Statistics {
+        uint32_t hits;                  // 完全命中的查询数
+        uint32_t misses;                // 需要访问总线的查询数
+        uint32_t registersRequested;    // 查询的寄存器总数
+        uint32_t registersRead;         // 实际从总线读取成功的寄存器总数
+    };
+
+    /**
+     * @param baseAddress 缓存覆盖的起始寄存器地址
+     * @param count 缓存覆盖的寄存器数量（不超过MAX_REGISTERS）
+     * @param defaultTtlMs 默认有效期（毫秒）
+     */
+    ModbusRegisterCache(uint16_t baseAddress, uint8_t count, uint32_t defaultTtlMs);
+    ~ModbusRegisterCache();
+
+    /**
+     * 设置一段寄存器的有效期
+     * @param ttlMs 有效期（毫秒），0表示不缓存（每次都从总线读取）
+     */
+    void setTTL(uint16_t address, uint16_t quantity, uint32_t ttlMs);
+
+    /**
+     * 请求范围是否完全在缓存覆盖范围内
+     */
+    bool covers(uint16_t address, uint16_t quantity) const;
+
+    /**
+     * 查询缓存，计入命中/未命中统计
+     * @param values 全部新鲜时写入缓存值
+     * @return 是否全部命中
+     */
+    bool lookup(uint16_t address, uint16_t quantity, uint16_t* values, uint32_t nowMs);
+
+    /**
+     * 计算请求范围内需要从总线读取的最小连续区间（首个到末个过期寄存器）
+     * @return 是否存在过期寄存器
+     */
+    bool getStaleSpan(uint16_t address, uint16_t quantity, uint32_t nowMs,
+                      uint16_t& spanAddress, uint16_t& spanQuantity);
+
+    /**
+     * 写入寄存器值并刷新时间戳（总线读取结果或写入成功的值），超出覆盖范围的部分忽略
+     */
+    void store(uint16_t address, uint16_t quantity, const uint16_t* values, uint32_t nowMs);
+
+    /**
+     * 写入总线读取成功的结果，同store()，并计入读取寄存器数统计
+     */
+    void storeRead(uint16_t address, uint16_t quantity, const uint16_t* values, uint32_t nowMs);
+
+    /**
+     * 读取单个新鲜寄存器的值，不计入统计（用于写入前比较）
+     * @return 寄存器是否在有效期内
+     */
+    bool getFresh(uint16_t address, uint16_t& value, uint32_t nowMs);
+
+    /**
+     * 复制缓存值（不检查有效期），用于store()之后组装完整结果
+     * @return 请求范围内是否全部有过有效值
+     */
+    bool copy(uint16_t address, uint16_t quantity, uint16_t* values);
+
+    /**
+     * 作废一段寄存器，下次访问必然读取总线
+     */
+    void invalidate(uint16_t address, uint16_t quantity);
+    void invalidateAll();
+
+    const Statistics& getStatistics() const { return _stats; }
+    void resetStatistics();
+
+private:
+    struct Entry {
+        uint16_t value;
+        bool valid;
+        uint32_t updatedMs;
+        uint32_t ttlMs;
+    };
+
+    bool isFresh(const Entry& entry, uint32_t nowMs) const;
+    bool lock();
+    void unlock();
+
+    uint16_t _baseAddress;
+    uint8_t _count;
+    Entry _entries[MAX_REGISTERS];
+    SemaphoreHandle_t _mutex;
+    Statistics _stats;
+};
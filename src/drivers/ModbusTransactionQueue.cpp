@@ -0,0 +1,287 @@
+#include "ModbusTransactionQueue.h"
+
+ModbusTransactionQueue::ModbusTransactionQueue(ModbusRTUDriver& driver)
+    : _driver(driver), _mutex(nullptr), _nextSequence(0), _pendingCount(0),
+      _state(State::IDLE), _attempts(0), _sentTimeMs(0), _retryAtMs(0), _lastBusActivityMicros(0),
+      _timeoutMs(driver.getTimeout()), _maxRetries(driver.getRetries()),
+      _retryDelayMs(ModbusRTUDriver::RETRY_DELAY_MS) {
+    _mutex = xSemaphoreCreateMutex();
+    for (uint8_t i = 0; i < QUEUE_CAPACITY; i++) {
+        _slots[i].inUse = false;
+    }
+    _active.inUse = false;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+ModbusTransactionQueue::~ModbusTransactionQueue() {
+    if (_mutex != nullptr) {
+        vSemaphoreDelete(_mutex);
+        _mutex = nullptr;
+    }
+}
+
+bool ModbusTransactionQueue::submitRead(uint16_t address, uint16_t quantity, ModbusPriority priority,
+                                        ModbusCallback callback) {
+    return submitTo(DEFAULT_SLAVE, 0x03, address, quantity, nullptr, priority, DEFAULT_RETRIES, callback);
+}
+
+bool ModbusTransactionQueue::submitWriteSingle(uint16_t address, uint16_t value, ModbusPriority priority,
+                                               ModbusCallback callback) {
+    return submitTo(DEFAULT_SLAVE, 0x06, address, 1, &value, priority, DEFAULT_RETRIES, callback);
+}
+
+bool ModbusTransactionQueue::submitWriteMultiple(uint16_t address, uint16_t quantity, const uint16_t* values,
+                                                 ModbusPriority priority, ModbusCallback callback) {
+    return submitTo(DEFAULT_SLAVE, 0x10, address, quantity, values, priority, DEFAULT_RETRIES, callback);
+}
+
+bool ModbusTransactionQueue::submitTo(uint8_t slaveAddress, uint8_t functionCode, uint16_t address,
+                                      uint16_t quantity, const uint16_t* values, ModbusPriority priority,
+                                      uint8_t maxRetries, ModbusCallback callback) {
+    bool isWrite = functionCode != 0x03;
+    // 0x06只写一个寄存器，数量不为1的请求每次构造都会失败，提交时即拒绝
+    bool valid = (functionCode == 0x03 || functionCode == 0x06 || functionCode == 0x10) &&
+                 quantity > 0 && quantity <= MAX_REGISTERS && (functionCode != 0x06 || quantity == 1) &&
+                 (!isWrite || values != nullptr);
+
+    if (_mutex == nullptr || xSemaphoreTake(_mutex, portMAX_DELAY) != pdTRUE) {
+        return false;
+    }
+
+    // 统计与其他计数一样在锁内更新
+    if (!valid) {
+        _stats.rejected++;
+        xSemaphoreGive(_mutex);
+        return false;
+    }
+
+    Transaction* slot = nullptr;
+    for (uint8_t i = 0; i < QUEUE_CAPACITY; i++) {
+        if (!_slots[i].inUse) {
+            slot = &_slots[i];
+            break;
+        }
+    }
+
+    if (slot == nullptr) {
+        _stats.rejected++;
+        xSemaphoreGive(_mutex);
+        return false;
+    }
+
+    slot->inUse = true;
+    slot->priority = priority;
+    slot->sequence = _nextSequence++;
+    slot->slaveAddress = slaveAddress == DEFAULT_SLAVE ? _driver.getSlaveAddress() : slaveAddress;
+    slot->maxRetries = maxRetries;
+    slot->functionCode = functionCode;
+    slot->address = address;
+    slot->quantity = quantity;
+    if (isWrite) {
+        memcpy(slot->values, values, quantity * sizeof(uint16_t));
+    }
+    slot->submitTime = millis();
+    slot->callback = callback;
+
+    _pendingCount++;
+    if (_pendingCount > _stats.maxDepth) {
+        _stats.maxDepth = _pendingCount;
+    }
+    _stats.submitted++;
+
+    xSemaphoreGive(_mutex);
+    return true;
+}
+
+void ModbusTransactionQueue::process() {
+    switch (_state) {
+        case State::IDLE:
+            if (!takeNext(_active)) {
+                return;
+            }
+            _attempts = 0;
+            _state = State::WAIT_BUS_IDLE;
+            if (isBusIdle()) {
+                sendActive();
+            }
+            return;
+
+        case State::WAIT_BUS_IDLE:
+            if (isBusIdle()) {
+                sendActive();
+            }
+            return;
+
+        case State::WAIT_RESPONSE:
+            if (_driver.poll()) {
+                if (_driver.parseResponse(_active.functionCode == 0x03 ? _active.values : nullptr)) {
+                    complete(true, ModbusRTUDriver::ERROR_NONE);
+                } else {
+                    handleFailure(_driver.getLastError(), _driver.getLastExceptionCode());
+                }
+            } else if (_driver.getReceiver().hasError()) {
+                handleFailure(_driver.getReceiver().getError() == ModbusFrameReceiver::FrameError::CRC_MISMATCH
+                                  ? ModbusRTUDriver::ERROR_CRC : ModbusRTUDriver::ERROR_INVALID_RESPONSE);
+            } else if (millis() - _sentTimeMs >= _timeoutMs) {
+                handleFailure(ModbusRTUDriver::ERROR_TIMEOUT);
+            }
+            return;
+
+        case State::WAIT_RETRY:
+            if (static_cast<int32_t>(millis() - _retryAtMs) >= 0) {
+                sendActive();
+            }
+            return;
+
+        case State::WAIT_LINE_SILENCE:
+            if (_driver.isLineSilent()) {
+                sendActive();
+            } else if (static_cast<int32_t>(millis() - _retryAtMs) >= 0) {
+                // 从站持续发送，按超时处理（等待重试间隔）
+                handleFailure(ModbusRTUDriver::ERROR_TIMEOUT);
+            }
+            return;
+    }
+}
+
+bool ModbusTransactionQueue::isIdle() {
+    return _state == State::IDLE && getPendingCount() == 0;
+}
+
+uint8_t ModbusTransactionQueue::getPendingCount() {
+    uint8_t count = 0;
+    if (_mutex != nullptr && xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+        count = _pendingCount;
+        xSemaphoreGive(_mutex);
+    }
+    return count;
+}
+
+ModbusTransactionQueue::Statistics ModbusTransactionQueue::getStatistics() {
+    Statistics stats = {};
+    if (_mutex != nullptr && xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+        stats = _stats;
+        xSemaphoreGive(_mutex);
+    }
+    return stats;
+}
+
+void ModbusTransactionQueue::resetStatistics() {
+    if (_mutex != nullptr && xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+        memset(&_stats, 0, sizeof(_stats));
+        xSemaphoreGive(_mutex);
+    }
+}
+
+bool ModbusTransactionQueue::takeNext(Transaction& transaction) {
+    if (_mutex == nullptr || xSemaphoreTake(_mutex, portMAX_DELAY) != pdTRUE) {
+        return false;
+    }
+
+    // 优先级高者先出，同优先级按提交顺序
+    Transaction* next = nullptr;
+    for (uint8_t i = 0; i < QUEUE_CAPACITY; i++) {
+        Transaction& slot = _slots[i];
+        if (!slot.inUse) {
+            continue;
+        }
+        if (next == nullptr || slot.priority < next->priority ||
+            (slot.priority == next->priority && static_cast<int32_t>(slot.sequence - next->sequence) < 0)) {
+            next = &slot;
+        }
+    }
+
+    if (next != nullptr) {
+        transaction = *next;
+        next->inUse = false;
+        next->callback = nullptr;
+        _pendingCount--;
+    }
+
+    xSemaphoreGive(_mutex);
+    return next != nullptr;
+}
+
+bool ModbusTransactionQueue::isBusIdle() const {
+    // 帧间至少保持T3.5静默
+    return micros() - _lastBusActivityMicros >= _driver.getReceiver().getT35Micros();
+}
+
+void ModbusTransactionQueue::sendActive() {
+    _attempts++;
+    _sentTimeMs = millis();
+
+    _driver.setSlaveAddress(_active.slaveAddress);
+    if (!_driver.sendRequest(_active.functionCode, _active.address, _active.quantity, _active.values)) {
+        handleFailure(_driver.getLastError());
+        return;
+    }
+    _state = State::WAIT_RESPONSE;
+}
+
+void ModbusTransactionQueue::handleFailure(uint8_t error, uint8_t exceptionCode) {
+    _driver.clearFrame();
+
+    ModbusRetryPolicy policy = ModbusRTUDriver::getRetryPolicy(error, exceptionCode);
+    uint8_t maxRetries = _active.maxRetries == DEFAULT_RETRIES ? _maxRetries : _active.maxRetries;
+    bool retry = policy != ModbusRetryPolicy::NO_RETRY && _attempts <= maxRetries;
+
+    if (_mutex != nullptr && xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+        switch (error) {
+            case ModbusRTUDriver::ERROR_TIMEOUT: _stats.timeouts++; break;
+            case ModbusRTUDriver::ERROR_CRC: _stats.crcErrors++; break;
+            case ModbusRTUDriver::ERROR_EXCEPTION: _stats.exceptions++; break;
+            default: _stats.invalidResponses++; break;
+        }
+        if (retry) {
+            _stats.retries++;
+        }
+        xSemaphoreGive(_mutex);
+    }
+
+    if (!retry) {
+        complete(false, error, exceptionCode);
+        return;
+    }
+
+    if (policy == ModbusRetryPolicy::IMMEDIATE) {
+        // 损坏的帧不必等待重试间隔；已知长度的帧收满即判定，从站可能仍在发送，
+        // 从最后一个接收字节起静默T3.5后再重发
+        _retryAtMs = millis() + _timeoutMs;
+        _state = State::WAIT_LINE_SILENCE;
+        return;
+    }
+    _retryAtMs = millis() + _retryDelayMs;
+    _state = State::WAIT_RETRY;
+}
+
+void ModbusTransactionQueue::complete(bool success, uint8_t error, uint8_t exceptionCode) {
+    if (_mutex != nullptr && xSemaphoreTake(_mutex, portMAX_DELAY) == pdTRUE) {
+        if (success) {
+            _stats.completed++;
+        } else {
+            _stats.failed++;
+        }
+        xSemaphoreGive(_mutex);
+    }
+
+    ModbusResult result;
+    result.slaveAddress = _active.slaveAddress;
+    result.success = success;
+    result.error = error;
+    result.exceptionCode = error == ModbusRTUDriver::ERROR_EXCEPTION ? exceptionCode : 0;
+    result.attempts = _attempts;
+    result.elapsedMs = millis() - _active.submitTime;
+    result.quantity = _active.functionCode == 0x03 && success ? _active.quantity : 0;
+    result.values = result.quantity > 0 ? _active.values : nullptr;
+
+    // 先回到空闲状态，回调中可以提交新的事务
+    _state = State::IDLE;
+    _lastBusActivityMicros = micros();
+
+    ModbusCallback callback = _active.callback;
+    _active.callback = nullptr;
+    if (callback) {
+        callback(result);
+    }
+}
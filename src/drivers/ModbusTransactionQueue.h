@@ -0,0 +1,170 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "ModbusRTUDriver.h"
+
+/**
+ * MODBUS事务优先级，数值越小越先执行
+ */
+enum class ModbusPriority : uint8_t {
+    URGENT = 0,     // 运行控制（启动/停止）
+    NORMAL = 1,     // 配置写入
+    BACKGROUND = 2  // 状态/配置读取
+};
+
+/**
+ * 事务完成结果，仅在回调期间有效
+ */
+struct ModbusResult {
+    uint8_t slaveAddress;       // 从站地址
+    bool success;               // 是否成功
+    uint8_t error;              // ModbusRTUDriver错误码
+    uint8_t exceptionCode;      // 异常应答的异常码（error为ERROR_EXCEPTION时有效）
+    uint8_t attempts;           // 实际发送次数
+    uint32_t elapsedMs;         // 从提交到完成的耗时
+    uint16_t quantity;          // 读取的寄存器数量
+    const uint16_t* values;     // 读取结果（写请求为nullptr）
+};
+
+typedef std::function<void(const ModbusResult& result)> ModbusCallback;
+
+/**
+ * MODBUS异步事务队列
+ *
+ * 请求提交后立即返回，由主循环调用process()推进：
+ * 每次调用最多完成一步（发送、检查应答、重试等待），从不阻塞等待总线。
+ * - 有界队列，满时提交失败
+ * - 按优先级出队，同优先级先进先出
+ * - 按错误类型重试：异常应答直接失败，CRC错误和无效应答在T3.5后立即重发，
+ *   超时和从站忙等待重试间隔，等待期间不占用主循环
+ * - 两次请求之间保证T3.5的总线静默
+ *
+ * submit系列方法可在BLE回调等其他任务中调用；process()和完成回调在主循环中执行。
+ * @note 使用队列时不要再调用同一驱动的同步读写接口
+ */
+class ModbusTransactionQueue {
+public:
+    static const uint8_t QUEUE_CAPACITY = 8;
+    static const uint8_t MAX_REGISTERS = 16;
+    static const uint8_t DEFAULT_SLAVE = 0;       // 使用驱动当前的从站地址
+    static const uint8_t DEFAULT_RETRIES = 0xFF;  // 使用队列的重试次数
+
+    /**
+     * 队列统计
+     */
+    struct Statistics {
+        uint32_t submitted;     // 成功提交数
+        uint32_t rejected;      // 队列满或参数无效被拒绝数
+        uint32_t completed;     // 成功完成数
+        uint32_t failed;        // 重试耗尽失败数
+        uint32_t retries;       // 重试次数
+        // 各类失败的发送次数（含已重试成功的）
+        uint32_t timeouts;
+        uint32_t crcErrors;
+        uint32_t invalidResponses;
+        uint32_t exceptions;
+        uint8_t maxDepth;       // 最大排队深度
+    };
+
+    explicit ModbusTransactionQueue(ModbusRTUDriver& driver);
+    ~ModbusTransactionQueue();
+
+    /**
+     * 提交读保持寄存器请求
+     * @return 是否提交成功（队列满或参数无效时失败）
+     */
+    bool submitRead(uint16_t address, uint16_t quantity, ModbusPriority priority, ModbusCallback callback);
+
+    /**
+     * 提交写单个寄存器请求
+     */
+    bool submitWriteSingle(uint16_t address, uint16_t value, ModbusPriority priority, ModbusCallback callback);
+
+    /**
+     * 提交写多个寄存器请求
+     */
+    bool submitWriteMultiple(uint16_t address, uint16_t quantity, const uint16_t* values,
+                             ModbusPriority priority, ModbusCallback callback);
+
+    /**
+     * 提交发往指定从站的请求（多从站总线使用）
+     * @param slaveAddress 从站地址，DEFAULT_SLAVE表示驱动当前地址
+     * @param functionCode 功能码(0x03/0x06/0x10)
+     * @param maxRetries 本事务的重试次数，DEFAULT_RETRIES表示使用队列配置
+     */
+    bool submitTo(uint8_t slaveAddress, uint8_t functionCode, uint16_t address, uint16_t quantity,
+                  const uint16_t* values, ModbusPriority priority, uint8_t maxRetries, ModbusCallback callback);
+
+    /**
+     * 推进当前事务一步，主循环每次迭代调用一次
+     */
+    void process();
+
+    /**
+     * 没有排队或进行中的事务
+     */
+    bool isIdle();
+    uint8_t getPendingCount();
+
+    // 配置，默认取驱动的超时和重试次数
+    void setTimeout(uint16_t timeoutMs) { _timeoutMs = timeoutMs; }
+    void setRetries(uint8_t retries) { _maxRetries = retries; }
+    void setRetryDelay(uint16_t delayMs) { _retryDelayMs = delayMs; }
+
+    // 统计在锁内更新，返回一致的快照
+    Statistics getStatistics();
+    void resetStatistics();
+
+private:
+    enum class State : uint8_t {
+        IDLE = 0,           // 无进行中的事务
+        WAIT_BUS_IDLE = 1,  // 等待T3.5总线静默后发送
+        WAIT_RESPONSE = 2,  // 已发送，等待应答
+        WAIT_RETRY = 3,     // 失败后等待重试间隔
+        WAIT_LINE_SILENCE = 4   // 帧损坏后等待线路静默T3.5再重发
+    };
+
+    struct Transaction {
+        bool inUse;
+        ModbusPriority priority;
+        uint32_t sequence;          // 提交序号，同优先级先进先出
+        uint8_t slaveAddress;
+        uint8_t maxRetries;
+        uint8_t functionCode;
+        uint16_t address;
+        uint16_t quantity;
+        uint16_t values[MAX_REGISTERS];
+        uint32_t submitTime;
+        ModbusCallback callback;
+    };
+
+    bool takeNext(Transaction& transaction);
+    bool isBusIdle() const;
+    void sendActive();
+    void handleFailure(uint8_t error, uint8_t exceptionCode = 0);
+    void complete(bool success, uint8_t error, uint8_t exceptionCode = 0);
+
+    ModbusRTUDriver& _driver;
+    SemaphoreHandle_t _mutex;
+
+    Transaction _slots[QUEUE_CAPACITY];
+    uint32_t _nextSequence;
+    uint8_t _pendingCount;
+
+    // 当前事务（只在process()中访问）
+    Transaction _active;
+    State _state;
+    uint8_t _attempts;
+    uint32_t _sentTimeMs;
+    uint32_t _retryAtMs;         // 重试时刻；等待线路静默时为放弃等待的时刻
+    uint32_t _lastBusActivityMicros;
+
+    uint16_t _timeoutMs;
+    uint8_t _maxRetries;
+    uint16_t _retryDelayMs;
+
+    Statistics _stats;
+};
@@ -66,22 +66,26 @@ bool NVSStorageDriver::saveConfig(const MotorConfig& config) {
     
     setLastError("");
     
-    // 保存runDuration
-    esp_err_t err = nvs_set_u32(nvs_handle, "runDuration", config.runDuration);
+    // 保存runDurationMs
+    esp_err_t err = nvs_set_u32(nvs_handle, "runDurationMs", config.runDurationMs);
     if (err != ESP_OK) {
-        setLastError("保存runDuration失败");
-        Logger::getInstance().error(String("NVSStorageDriver"), "保存runDuration失败: %s", esp_err_to_name(err));
+        setLastError("保存runDurationMs失败");
+        Logger::getInstance().error(String("NVSStorageDriver"), "保存runDurationMs失败: %s", esp_err_to_name(err));
         return false;
     }
     
-    // 保存stopDuration
-    err = nvs_set_u32(nvs_handle, "stopDuration", config.stopDuration);
+    // 保存stopDurationMs
+    err = nvs_set_u32(nvs_handle, "stopDurationMs", config.stopDurationMs);
     if (err != ESP_OK) {
-        setLastError("保存stopDuration失败");
-        Logger::getInstance().error(String("NVSStorageDriver"), "保存stopDuration失败: %s", esp_err_to_name(err));
+        setLastError("保存stopDurationMs失败");
+        Logger::getInstance().error(String("NVSStorageDriver"), "保存stopDurationMs失败: %s", esp_err_to_name(err));
         return false;
     }
     
+    // 旧版本以秒保存的时长已被毫秒键取代
+    nvs_erase_key(nvs_handle, "runDuration");
+    nvs_erase_key(nvs_handle, "stopDuration");
+    
     // 保存cycleCount
     err = nvs_set_u32(nvs_handle, "cycleCount", config.cycleCount);
     if (err != ESP_OK) {
@@ -98,6 +102,11 @@ bool NVSStorageDriver::saveConfig(const MotorConfig& config) {
         return false;
     }
     
+    // 保存输出方式和PWM参数
+    if (!savePWMConfig(config)) {
+        return false;
+    }
+    
     // 提交更改
     err = nvs_commit(nvs_handle);
     if (err != ESP_OK) {
@@ -125,34 +134,14 @@ bool NVSStorageDriver::loadConfig(MotorConfig& config) {
     // 检查配置是否存在
     bool configExists = false;
     
-    // 读取runDuration
-    esp_err_t err = nvs_get_u32(nvs_handle, "runDuration", &config.runDuration);
-    if (err == ESP_OK) {
-        configExists = true;
-    } else if (err == ESP_ERR_NVS_NOT_FOUND) {
-        // 配置不存在，使用默认值
-        Logger::getInstance().warn("NVSStorageDriver", "runDuration配置不存在，将使用默认值");
-    } else {
-        setLastError("读取runDuration失败");
-        Logger::getInstance().error(String("NVSStorageDriver"), "读取runDuration失败: %s", esp_err_to_name(err));
-        return false;
-    }
-    
-    // 读取stopDuration
-    err = nvs_get_u32(nvs_handle, "stopDuration", &config.stopDuration);
-    if (err == ESP_OK) {
-        configExists = true;
-    } else if (err == ESP_ERR_NVS_NOT_FOUND) {
-        // 配置不存在，使用默认值
-        Logger::getInstance().warn("NVSStorageDriver", "stopDuration配置不存在，将使用默认值");
-    } else {
-        setLastError("读取stopDuration失败");
-        Logger::getInstance().error(String("NVSStorageDriver"), "读取stopDuration失败: %s", esp_err_to_name(err));
+    // 读取runDurationMs和stopDurationMs
+    if (!loadDurationMs("runDurationMs", "runDuration", config.runDurationMs, configExists) ||
+        !loadDurationMs("stopDurationMs", "stopDuration", config.stopDurationMs, configExists)) {
         return false;
     }
     
     // 读取cycleCount
-    err = nvs_get_u32(nvs_handle, "cycleCount", &config.cycleCount);
+    esp_err_t err = nvs_get_u32(nvs_handle, "cycleCount", &config.cycleCount);
     if (err == ESP_OK) {
         configExists = true;
     } else if (err == ESP_ERR_NVS_NOT_FOUND) {
@@ -179,10 +168,15 @@ bool NVSStorageDriver::loadConfig(MotorConfig& config) {
         return false;
     }
     
+    // 读取输出方式和PWM参数
+    if (!loadPWMConfig(config, configExists)) {
+        return false;
+    }
+    
     if (configExists) {
         Logger::getInstance().info("NVSStorageDriver", "配置读取成功");
-        Logger::getInstance().debug("NVSStorageDriver", "读取的配置 - 运行: %lu秒, 停止: %lu秒, 循环: %lu次, 自动启动: %s",
-                                   config.runDuration, config.stopDuration, config.cycleCount,
+        Logger::getInstance().debug("NVSStorageDriver", "读取的配置 - 运行: %lu ms, 停止: %lu ms, 循环: %lu次, 自动启动: %s",
+                                   config.runDurationMs, config.stopDurationMs, config.cycleCount,
                                    config.autoStart ? "是" : "否");
         return true;
     } else {
@@ -203,20 +197,16 @@ bool NVSStorageDriver::deleteConfig() {
     
     setLastError("");
     
-    // 删除runDuration
-    esp_err_t err = nvs_erase_key(nvs_handle, "runDuration");
-    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
-        setLastError("删除runDuration失败");
-        Logger::getInstance().error(String("NVSStorageDriver"), "删除runDuration失败: %s", esp_err_to_name(err));
-        return false;
-    }
-    
-    // 删除stopDuration
-    err = nvs_erase_key(nvs_handle, "stopDuration");
-    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
-        setLastError("删除stopDuration失败");
-        Logger::getInstance().error(String("NVSStorageDriver"), "删除stopDuration失败: %s", esp_err_to_name(err));
-        return false;
+    // 删除运行/停止时长（包括旧版本以秒保存的键）
+    static const char* const durationKeys[] = {"runDurationMs", "stopDurationMs", "runDuration", "stopDuration"};
+    esp_err_t err = ESP_OK;
+    for (const char* key : durationKeys) {
+        err = nvs_erase_key(nvs_handle, key);
+        if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            setLastError("删除运行/停止时长失败");
+            Logger::getInstance().error(String("NVSStorageDriver"), "删除%s失败: %s", key, esp_err_to_name(err));
+            return false;
+        }
     }
     
     // 删除cycleCount
@@ -235,6 +225,17 @@ bool NVSStorageDriver::deleteConfig() {
         return false;
     }
     
+    // 删除输出方式和PWM参数
+    static const char* const pwmKeys[] = {"outputMode", "pwmFrequency", "pwmDuty", "softStartMs", "softStopMs"};
+    for (const char* key : pwmKeys) {
+        err = nvs_erase_key(nvs_handle, key);
+        if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            setLastError("删除PWM参数失败");
+            Logger::getInstance().error(String("NVSStorageDriver"), "删除%s失败: %s", key, esp_err_to_name(err));
+            return false;
+        }
+    }
+    
     // 提交更改
     err = nvs_commit(nvs_handle);
     if (err != ESP_OK) {
@@ -258,10 +259,182 @@ bool NVSStorageDriver::isConfigExist() {
     
     setLastError("");
     
-    // 检查runDuration是否存在
+    // 检查runDurationMs（或旧版本的runDuration）是否存在
     uint32_t value;
-    esp_err_t err = nvs_get_u32(nvs_handle, "runDuration", &value);
-    return (err == ESP_OK);
+    return nvs_get_u32(nvs_handle, "runDurationMs", &value) == ESP_OK ||
+           nvs_get_u32(nvs_handle, "runDuration", &value) == ESP_OK;
+}
+
+/**
+ * 读取毫秒时长，兼容旧版本以秒保存的键
+ */
+bool NVSStorageDriver::loadDurationMs(const char* key, const char* legacyKey, uint32_t& value, bool& found) {
+    esp_err_t err = nvs_get_u32(nvs_handle, key, &value);
+    if (err == ESP_OK) {
+        found = true;
+        return true;
+    }
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        uint32_t seconds = 0;
+        err = nvs_get_u32(nvs_handle, legacyKey, &seconds);
+        if (err == ESP_OK) {
+            value = seconds > 0xFFFFFFFFUL / 1000 ? 0xFFFFFFFFUL : seconds * 1000;
+            found = true;
+            Logger::getInstance().info("NVSStorageDriver", "已将%s从秒换算为毫秒: %lu ms", legacyKey, value);
+            return true;
+        }
+    }
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        // 配置不存在，使用默认值
+        Logger::getInstance().warn("NVSStorageDriver", "%s配置不存在，将使用默认值", key);
+        return true;
+    }
+    setLastError("读取运行/停止时长失败");
+    Logger::getInstance().error(String("NVSStorageDriver"), "读取%s失败: %s", key, esp_err_to_name(err));
+    return false;
+}
+
+/**
+ * 保存输出方式和PWM参数
+ */
+bool NVSStorageDriver::savePWMConfig(const MotorConfig& config) {
+    esp_err_t err = nvs_set_u8(nvs_handle, "outputMode", (uint8_t)config.outputMode);
+    if (err == ESP_OK) {
+        err = nvs_set_u8(nvs_handle, "pwmDuty", config.pwmDutyCycle);
+    }
+    if (err == ESP_OK) {
+        err = nvs_set_u32(nvs_handle, "pwmFrequency", config.pwmFrequency);
+    }
+    if (err == ESP_OK) {
+        err = nvs_set_u32(nvs_handle, "softStartMs", config.softStartMs);
+    }
+    if (err == ESP_OK) {
+        err = nvs_set_u32(nvs_handle, "softStopMs", config.softStopMs);
+    }
+    if (err != ESP_OK) {
+        setLastError("保存PWM参数失败");
+        Logger::getInstance().error(String("NVSStorageDriver"), "保存PWM参数失败: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 读取输出方式和PWM参数
+ */
+bool NVSStorageDriver::loadPWMConfig(MotorConfig& config, bool& found) {
+    uint8_t mode = 0;
+    esp_err_t err = nvs_get_u8(nvs_handle, "outputMode", &mode);
+    if (err == ESP_OK) {
+        config.outputMode = mode == (uint8_t)MotorOutputMode::PWM ? MotorOutputMode::PWM : MotorOutputMode::SWITCH;
+        found = true;
+        err = nvs_get_u8(nvs_handle, "pwmDuty", &config.pwmDutyCycle);
+    }
+    if (err == ESP_OK) {
+        err = nvs_get_u32(nvs_handle, "pwmFrequency", &config.pwmFrequency);
+    }
+    if (err == ESP_OK) {
+        err = nvs_get_u32(nvs_handle, "softStartMs", &config.softStartMs);
+    }
+    if (err == ESP_OK) {
+        err = nvs_get_u32(nvs_handle, "softStopMs", &config.softStopMs);
+    }
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        // 旧版本保存的配置没有PWM参数，使用默认值
+        Logger::getInstance().debug("NVSStorageDriver", "PWM参数不存在，将使用默认值");
+        return true;
+    }
+    if (err != ESP_OK) {
+        setLastError("读取PWM参数失败");
+        Logger::getInstance().error(String("NVSStorageDriver"), "读取PWM参数失败: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 保存序列化的电机程序
+ * @param data 程序数据
+ * @param length 数据长度
+ * @return 保存是否成功
+ */
+bool NVSStorageDriver::saveProgram(const uint8_t* data, size_t length) {
+    if (!checkInitialized()) {
+        return false;
+    }
+    
+    setLastError("");
+    
+    esp_err_t err = nvs_set_blob(nvs_handle, "program", data, length);
+    if (err != ESP_OK) {
+        setLastError("保存program失败");
+        Logger::getInstance().error(String("NVSStorageDriver"), "保存program失败: %s", esp_err_to_name(err));
+        return false;
+    }
+    
+    err = nvs_commit(nvs_handle);
+    if (err != ESP_OK) {
+        setLastError("提交NVS更改失败");
+        Logger::getInstance().error(String("NVSStorageDriver"), "提交NVS更改失败: %s", esp_err_to_name(err));
+        return false;
+    }
+    
+    Logger::getInstance().info("NVSStorageDriver", "电机程序保存成功 (%u字节)", (unsigned)length);
+    return true;
+}
+
+/**
+ * 读取序列化的电机程序
+ * @param buffer 用于存储读取结果的缓冲区
+ * @param length 输入为缓冲区大小，输出为数据长度
+ * @return 读取是否成功（程序不存在时返回false）
+ */
+bool NVSStorageDriver::loadProgram(uint8_t* buffer, size_t& length) {
+    if (!checkInitialized()) {
+        return false;
+    }
+    
+    setLastError("");
+    
+    esp_err_t err = nvs_get_blob(nvs_handle, "program", buffer, &length);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        length = 0;
+        return false;
+    }
+    if (err != ESP_OK) {
+        setLastError("读取program失败");
+        Logger::getInstance().error(String("NVSStorageDriver"), "读取program失败: %s", esp_err_to_name(err));
+        length = 0;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 删除电机程序
+ * @return 删除是否成功
+ */
+bool NVSStorageDriver::deleteProgram() {
+    if (!checkInitialized()) {
+        return false;
+    }
+    
+    setLastError("");
+    
+    esp_err_t err = nvs_erase_key(nvs_handle, "program");
+    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+        setLastError("删除program失败");
+        Logger::getInstance().error(String("NVSStorageDriver"), "删除program失败: %s", esp_err_to_name(err));
+        return false;
+    }
+    
+    err = nvs_commit(nvs_handle);
+    if (err != ESP_OK) {
+        setLastError("提交NVS更改失败");
+        Logger::getInstance().error(String("NVSStorageDriver"), "提交NVS更改失败: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
 }
 
 /**
@@ -56,6 +56,28 @@ public:
      */
     bool isConfigExist();
     
+    /**
+     * 保存序列化的电机程序
+     * @param data 程序数据
+     * @param length 数据长度
+     * @return 保存是否成功
+     */
+    bool saveProgram(const uint8_t* data, size_t length);
+    
+    /**
+     * 读取序列化的电机程序
+     * @param buffer 用于存储读取结果的缓冲区
+     * @param length 输入为缓冲区大小，输出为数据长度
+     * @return 读取是否成功（程序不存在时返回false）
+     */
+    bool loadProgram(uint8_t* buffer, size_t& length);
+    
+    /**
+     * 删除电机程序
+     * @return 删除是否成功
+     */
+    bool deleteProgram();
+    
     /**
      * 获取错误信息
      * @return 最近一次错误信息
@@ -78,6 +100,31 @@ private:
      * @return 是否已初始化
      */
     bool checkInitialized();
+    
+    /**
+     * 读取毫秒时长；不存在时读取旧版本以秒保存的键并换算
+     * @param key 毫秒键名
+     * @param legacyKey 旧版本的秒键名
+     * @param value 读取结果，两个键都不存在时不修改
+     * @param found 读取到任一键时置为true
+     * @return 读取过程没有出错
+     */
+    bool loadDurationMs(const char* key, const char* legacyKey, uint32_t& value, bool& found);
+    
+    /**
+     * 保存输出方式和PWM参数（不提交）
+     * @param config 配置参数
+     * @return 保存是否成功
+     */
+    bool savePWMConfig(const MotorConfig& config);
+    
+    /**
+     * 读取输出方式和PWM参数；旧版本没有这些键，不存在时保留默认值
+     * @param config 读取结果
+     * @param found 读取到任一键时置为true
+     * @return 读取过程没有出错
+     */
+    bool loadPWMConfig(MotorConfig& config, bool& found);
 };
 
 #endif // NVS_STORAGE_DRIVER_H
\ No newline at end of file
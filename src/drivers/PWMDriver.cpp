@@ -0,0 +1,75 @@
+#include "PWMDriver.h"
+
+PWMDriver::PWMDriver()
+    : pin(0)
+    , channel(0)
+    , resolutionBits(0)
+    , frequency(0)
+    , duty(0)
+    , initialized(false) {
+}
+
+PWMDriver::~PWMDriver() {
+    end();
+}
+
+bool PWMDriver::init(uint8_t pin, uint8_t channel, uint32_t frequency, uint8_t resolutionBits, uint32_t initialDuty) {
+    end();
+    
+    // ledcSetup返回实际频率，频率与分辨率的组合超出时钟范围时返回0
+    uint32_t actual = ledcSetup(channel, frequency, resolutionBits);
+    if (actual == 0) {
+        Logger::getInstance().error("PWMDriver", ("LEDC通道" + String(channel) + " 配置失败，频率: " + String(frequency) + " Hz").c_str());
+        return false;
+    }
+    
+    this->pin = pin;
+    this->channel = channel;
+    this->resolutionBits = resolutionBits;
+    this->frequency = actual;
+    this->duty = initialDuty > getMaxDuty() ? getMaxDuty() : initialDuty;
+    ledcWrite(channel, this->duty);
+    ledcAttachPin(pin, channel);
+    initialized = true;
+    
+    Logger::getInstance().info("PWMDriver", ("GPIO" + String(pin) + " PWM输出已启用，通道: " + String(channel) +
+                                             ", 频率: " + String(actual) + " Hz").c_str());
+    return true;
+}
+
+void PWMDriver::end() {
+    if (!initialized) {
+        return;
+    }
+    ledcDetachPin(pin);
+    initialized = false;
+    Logger::getInstance().info("PWMDriver", ("GPIO" + String(pin) + " PWM输出已停用").c_str());
+}
+
+bool PWMDriver::setFrequency(uint32_t frequency) {
+    if (!initialized) {
+        return false;
+    }
+    if (frequency == this->frequency) {
+        return true;
+    }
+    uint32_t actual = ledcChangeFrequency(channel, frequency, resolutionBits);
+    if (actual == 0) {
+        Logger::getInstance().error("PWMDriver", ("无法设置PWM频率: " + String(frequency) + " Hz").c_str());
+        return false;
+    }
+    this->frequency = actual;
+    return true;
+}
+
+bool PWMDriver::setDuty(uint32_t duty) {
+    if (!initialized) {
+        return false;
+    }
+    if (duty > getMaxDuty()) {
+        duty = getMaxDuty();
+    }
+    ledcWrite(channel, duty);
+    this->duty = duty;
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef PWM_DRIVER_H
+#define PWM_DRIVER_H
+
+#include <Arduino.h>
+#include "../common/Logger.h"
+
+/**
+ * PWM驱动类
+ * 使用LEDC外设在单个引脚上输出PWM，占空比以原始计数表示（0到2^分辨率，后者为常高电平）
+ */
+class PWMDriver {
+public:
+    /**
+     * 构造函数
+     */
+    PWMDriver();
+    
+    /**
+     * 析构函数，释放引脚
+     */
+    ~PWMDriver();
+    
+    /**
+     * 配置LEDC通道并连接引脚
+     * @param pin GPIO引脚号
+     * @param channel LEDC通道
+     * @param frequency PWM频率 (Hz)
+     * @param resolutionBits 占空比分辨率（位）
+     * @param initialDuty 初始占空比计数（连接引脚前写入，避免输出毛刺）
+     * @return 初始化是否成功
+     */
+    bool init(uint8_t pin, uint8_t channel, uint32_t frequency, uint8_t resolutionBits, uint32_t initialDuty = 0);
+    
+    /**
+     * 断开引脚与LEDC的连接，之后引脚可重新作为GPIO使用
+     */
+    void end();
+    
+    /**
+     * 修改PWM频率（占空比计数保持不变）
+     * @param frequency PWM频率 (Hz)
+     * @return 操作是否成功
+     */
+    bool setFrequency(uint32_t frequency);
+    
+    /**
+     * 设置占空比
+     * @param duty 占空比计数，超过getMaxDuty()时按最大值处理
+     * @return 操作是否成功
+     */
+    bool setDuty(uint32_t duty);
+    
+    /**
+     * 占空比计数的最大值（常高电平）
+     */
+    uint32_t getMaxDuty() const { return 1UL << resolutionBits; }
+    
+    uint32_t getDuty() const { return duty; }
+    uint32_t getFrequency() const { return frequency; }
+    bool isInitialized() const { return initialized; }
+
+private:
+    uint8_t pin;
+    uint8_t channel;
+    uint8_t resolutionBits;
+    uint32_t frequency;
+    uint32_t duty;
+    bool initialized;
+};
+
+#endif // PWM_DRIVER_H
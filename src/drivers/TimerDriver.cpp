@@ -284,6 +284,27 @@ bool TimerDriver::changeTimerInterval(TimerID timer_id, uint32_t new_interval_ms
     }
 }
 
+bool TimerDriver::startOneShotUs(TimerID timer_id, uint32_t delay_us) {
+    if (!isValidTimerID(timer_id) || !timer_info[timer_id].is_created) {
+        Logger::getInstance().error("TimerDriver", ("定时器" + String(timer_id) + " 未创建").c_str());
+        return false;
+    }
+    
+    if (timer_info[timer_id].auto_reload) {
+        Logger::getInstance().error("TimerDriver", ("定时器" + String(timer_id) + " 为自动重载模式，不能用于一次性定时").c_str());
+        return false;
+    }
+    
+    // 每个阶段都会调用，成功时不输出日志
+    timerAlarmDisable(timer_info[timer_id].timer);
+    timer_info[timer_id].is_running = false;
+    timerAlarmWrite(timer_info[timer_id].timer, delay_us > 0 ? delay_us : 1, false);
+    timerRestart(timer_info[timer_id].timer);
+    timer_info[timer_id].is_running = true;
+    timerAlarmEnable(timer_info[timer_id].timer);
+    return true;
+}
+
 bool TimerDriver::isTimerRunning(TimerID timer_id) {
     if (!isValidTimerID(timer_id) || !timer_info[timer_id].is_created) {
         return false;
@@ -372,13 +393,13 @@ void TimerDriver::handleTimerInterrupt(TimerID timer_id) {
     // 增加触发次数
     timer_info[timer_id].trigger_count++;
     
+    // 如果不是自动重载模式，停止定时器（先于回调，回调中可以重新启动）
+    if (!timer_info[timer_id].auto_reload) {
+        timer_info[timer_id].is_running = false;
+    }
+    
     // 调用回调函数
     if (timer_info[timer_id].callback) {
         timer_info[timer_id].callback();
     }
-    
-    // 如果不是自动重载模式，停止定时器
-    if (!timer_info[timer_id].auto_reload) {
-        timer_info[timer_id].is_running = false;
-    }
 }
\ No newline at end of file
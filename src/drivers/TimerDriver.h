@@ -93,6 +93,16 @@ public:
      */
     bool changeTimerInterval(TimerID timer_id, uint32_t new_interval_ms);
     
+    /**
+     * 以微秒精度启动一次性定时
+     * 定时器需先以auto_reload=false创建；计数从调用时刻开始，到期触发一次回调后自动停止，
+     * 可以在回调中再次调用以安排下一次定时
+     * @param timer_id 定时器ID
+     * @param delay_us 距触发的时间(微秒)，0按1微秒处理
+     * @return 启动是否成功
+     */
+    bool startOneShotUs(TimerID timer_id, uint32_t delay_us);
+    
     /**
      * 检查定时器是否运行中
      * @param timer_id 定时器ID
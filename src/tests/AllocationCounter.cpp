@@ -0,0 +1,44 @@
+#include "AllocationCounter.h"
+
+#ifdef NATIVE_BUILD
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local bool counting = false;
+thread_local uint32_t allocationCount = 0;
+
+} // namespace
+
+void AllocationCounter::begin() {
+    allocationCount = 0;
+    counting = true;
+}
+
+uint32_t AllocationCounter::end() {
+    counting = false;
+    return allocationCount;
+}
+
+void* operator new(size_t size) {
+    if (counting) {
+        allocationCount++;
+    }
+    void* pointer = malloc(size > 0 ? size : 1);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+#endif // NATIVE_BUILD
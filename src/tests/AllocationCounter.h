@@ -0,0 +1,24 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * 主机测试用的堆分配计数（替换全局operator new，仅统计调用线程在计数窗口内的分配）
+ */
+class AllocationCounter {
+public:
+    static void begin();
+
+    /**
+     * 结束计数
+     * @return 窗口内的分配次数
+     */
+    static uint32_t end();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // ALLOCATION_COUNTER_H
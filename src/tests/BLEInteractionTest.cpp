@@ -99,12 +99,12 @@ bool BLEInteractionTest::testConfigImmediateEffect() {
     try {
         // 获取初始配置（使用默认值如果未初始化）
         MotorConfig initialConfig;
-        initialConfig.runDuration = 5;
-        initialConfig.stopDuration = 2;
+        initialConfig.runDurationMs = 5000;
+        initialConfig.stopDurationMs = 2000;
         initialConfig.cycleCount = 0;
         initialConfig.autoStart = true;
         
-        LOG_INFO("初始配置: 运行=%u秒, 停止=%u秒", initialConfig.runDuration, initialConfig.stopDuration);
+        LOG_INFO("初始配置: 运行=%u ms, 停止=%u ms", initialConfig.runDurationMs, initialConfig.stopDurationMs);
         
         // 模拟BLE配置更新 - 分别设置运行时长和停止间隔
         // 运行时长：30秒
@@ -114,7 +114,7 @@ bool BLEInteractionTest::testConfigImmediateEffect() {
         
         // 验证电机控制器是否获得了新配置
         const MotorConfig& motorConfig = motorController.getCurrentConfig();
-        if (motorConfig.runDuration == 30 && motorConfig.stopDuration == 15) {
+        if (motorConfig.runDurationMs == 30000 && motorConfig.stopDurationMs == 15000) {
             LOG_INFO("电机控制器配置同步成功");
         } else {
             LOG_WARN("电机控制器配置同步可能受初始化状态影响");
@@ -288,13 +288,13 @@ bool BLEInteractionTest::testErrorHandlingAndRecovery() {
     try {
         // 测试无效数值处理
         String invalidValue = "invalid";
-        bleServer.handleRunDurationWrite(invalidValue);
+        bleServer.handleRunDurationWrite(invalidValue.c_str());
         // 应该不会崩溃，只是记录错误
         
-        bleServer.handleStopIntervalWrite(invalidValue);
+        bleServer.handleStopIntervalWrite(invalidValue.c_str());
         // 应该不会崩溃，只是记录错误
         
-        bleServer.handleSystemControlWrite(invalidValue);
+        bleServer.handleSystemControlWrite(invalidValue.c_str());
         // 应该不会崩溃，只是记录错误
         
         LOG_INFO("无效数值错误处理通过");
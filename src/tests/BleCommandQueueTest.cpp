@@ -0,0 +1,395 @@
+#include "BleCommandQueueTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <string>
+#include <vector>
+#include "../common/BleCommandQueue.h"
+#include "../common/ChunkedTransfer.h"
+#include "../common/Config.h"
+#include "../common/Logger.h"
+#include "../controllers/ConfigManager.h"
+#include "../controllers/MotorBLEServer.h"
+#include "SimulatedModbusSlave.h"
+
+namespace {
+
+bool enqueueText(BleCommandQueue& queue, uint8_t target, const char* text, uint16_t& id) {
+    return queue.enqueue(target, (const uint8_t*)text, strlen(text), id);
+}
+
+/**
+ * 取出写入确认通知
+ */
+std::vector<BleCommandAck> takeAcks() {
+    std::vector<BleCommandAck> acks;
+    for (const NativeHAL::BLENotification& notification : NativeHAL::bleTakeNotifications()) {
+        BleCommandAck ack;
+        if (notification.uuid == BLE_COMMAND_ACK_CHAR_UUID &&
+            BleCommandAck::decode((const uint8_t*)notification.value.data(), notification.value.size(), ack)) {
+            acks.push_back(ack);
+        }
+    }
+    return acks;
+}
+
+bool writeText(const char* uuid, const char* text) {
+    return NativeHAL::bleWrite(uuid, std::string(text));
+}
+
+} // namespace
+
+bool BleCommandQueueTest::runAllTests() {
+    LOG_TAG_INFO("BleCmdTest", "开始BLE写入命令队列测试...");
+
+    bool allPassed = true;
+
+    if (!testOrderAndCopy()) {
+        LOG_TAG_ERROR("BleCmdTest", "❌ 顺序和复制测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("BleCmdTest", "✅ 顺序和复制测试通过");
+    }
+
+    if (!testBounds()) {
+        LOG_TAG_ERROR("BleCmdTest", "❌ 容量和执行上限测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("BleCmdTest", "✅ 容量和执行上限测试通过");
+    }
+
+    if (!testLatencyAndAck()) {
+        LOG_TAG_ERROR("BleCmdTest", "❌ 延迟和确认编码测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("BleCmdTest", "✅ 延迟和确认编码测试通过");
+    }
+
+    if (!testServerDeferredWrites()) {
+        LOG_TAG_ERROR("BleCmdTest", "❌ BLE服务器延迟执行写入测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("BleCmdTest", "✅ BLE服务器延迟执行写入测试通过");
+    }
+
+    if (!testSpeedControllerConfigAck()) {
+        LOG_TAG_ERROR("BleCmdTest", "❌ 调速器配置写入确认测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("BleCmdTest", "✅ 调速器配置写入确认测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("BleCmdTest", "🎉 所有BLE写入命令队列测试通过!");
+    }
+    return allPassed;
+}
+
+bool BleCommandQueueTest::testOrderAndCopy() {
+    BleCommandQueue queue;
+    char text[16];
+    uint16_t ids[3];
+    for (uint8_t i = 0; i < 3; i++) {
+        snprintf(text, sizeof(text), "value%u", i);
+        if (!enqueueText(queue, i, text, ids[i])) {
+            LOG_TAG_ERROR("BleCmdTest", "第%u条入队失败", i);
+            return false;
+        }
+    }
+    // 入队后改写调用者的缓冲区不影响队列中的内容
+    strcpy(text, "overwritten");
+
+    uint8_t executed = 0;
+    bool contentOk = true;
+    queue.process([&](const BleCommand& command, uint32_t latencyMicros) {
+        (void)latencyMicros;
+        char expected[16];
+        snprintf(expected, sizeof(expected), "value%u", executed);
+        if (command.target != executed || command.id != ids[executed] || strcmp(command.data, expected) != 0 ||
+            command.length != strlen(expected)) {
+            LOG_TAG_ERROR("BleCmdTest", "第%u条内容错误: #%u %u %s", executed, command.id, command.target,
+                          command.data);
+            contentOk = false;
+        }
+        executed++;
+    });
+
+    return contentOk && executed == 3 && !queue.hasPending() && ids[1] == (uint16_t)(ids[0] + 1) &&
+           ids[2] == (uint16_t)(ids[1] + 1);
+}
+
+bool BleCommandQueueTest::testBounds() {
+    BleCommandQueue queue;
+    uint16_t id = 0;
+
+    // 超过最大长度：拒绝但仍分配编号
+    std::string tooLong(BLE_COMMAND_MAX_LENGTH + 1, 'x');
+    if (queue.enqueue(0, (const uint8_t*)tooLong.data(), tooLong.size(), id) || id != 0 || queue.hasPending()) {
+        LOG_TAG_ERROR("BleCmdTest", "超长写入应被拒绝");
+        return false;
+    }
+    std::string maxLength(BLE_COMMAND_MAX_LENGTH, 'y');
+    if (!queue.enqueue(0, (const uint8_t*)maxLength.data(), maxLength.size(), id) || id != 1) {
+        LOG_TAG_ERROR("BleCmdTest", "最大长度的写入应入队");
+        return false;
+    }
+
+    // 填满队列后拒绝
+    for (uint32_t i = 1; i < BleCommandQueue::capacity(); i++) {
+        if (!enqueueText(queue, 1, "1", id)) {
+            LOG_TAG_ERROR("BleCmdTest", "队列未满时入队失败: %lu", (unsigned long)i);
+            return false;
+        }
+    }
+    uint16_t rejectedId = 0;
+    if (enqueueText(queue, 1, "1", rejectedId) || rejectedId != (uint16_t)(id + 1)) {
+        LOG_TAG_ERROR("BleCmdTest", "队列满时应拒绝写入");
+        return false;
+    }
+
+    // 被拒绝的写入按顺序记录，由主循环取出
+    std::vector<uint16_t> rejectedIds;
+    queue.processRejected([&rejectedIds](const BleCommandRejection& rejection) {
+        rejectedIds.push_back(rejection.id);
+    });
+    if (rejectedIds.size() != 2 || rejectedIds[0] != 0 || rejectedIds[1] != rejectedId || queue.hasRejected()) {
+        LOG_TAG_ERROR("BleCmdTest", "拒绝记录错误: %u条", (unsigned)rejectedIds.size());
+        return false;
+    }
+
+    // 每次最多执行BLE_COMMAND_MAX_PER_UPDATE条
+    uint32_t executed = queue.process([](const BleCommand& command, uint32_t latencyMicros) {
+        (void)command;
+        (void)latencyMicros;
+    });
+    if (executed != BLE_COMMAND_MAX_PER_UPDATE ||
+        queue.size() != BleCommandQueue::capacity() - BLE_COMMAND_MAX_PER_UPDATE) {
+        LOG_TAG_ERROR("BleCmdTest", "单次执行条数错误: %lu", (unsigned long)executed);
+        return false;
+    }
+    while (queue.process([](const BleCommand&, uint32_t) {}) > 0) {
+    }
+
+    BleCommandQueue::Statistics stats = queue.getStatistics();
+    if (stats.received != BleCommandQueue::capacity() + 2 || stats.processed != BleCommandQueue::capacity() ||
+        stats.rejected != 2 || stats.highWatermark != BleCommandQueue::capacity()) {
+        LOG_TAG_ERROR("BleCmdTest", "统计错误: 收到%lu 执行%lu 拒绝%lu 最大深度%lu",
+                      (unsigned long)stats.received, (unsigned long)stats.processed,
+                      (unsigned long)stats.rejected, (unsigned long)stats.highWatermark);
+        return false;
+    }
+    queue.resetStatistics();
+    stats = queue.getStatistics();
+    return stats.received == 0 && stats.rejected == 0 && stats.highWatermark == 0;
+}
+
+bool BleCommandQueueTest::testLatencyAndAck() {
+    BleCommandQueue queue;
+    uint16_t id = 0;
+    enqueueText(queue, 2, "first", id);
+    NativeHAL::advanceMicros(1500);
+    enqueueText(queue, 2, "second", id);
+    NativeHAL::advanceMicros(500);
+
+    std::vector<uint32_t> latencies;
+    queue.process([&latencies](const BleCommand& command, uint32_t latencyMicros) {
+        (void)command;
+        latencies.push_back(latencyMicros);
+    });
+    if (latencies.size() != 2 || latencies[0] != 2000 || latencies[1] != 500 ||
+        queue.getStatistics().maxLatencyMicros != 2000) {
+        LOG_TAG_ERROR("BleCmdTest", "执行延迟错误");
+        return false;
+    }
+
+    BleCommandAck ack;
+    ack.id = 0xBEEF;
+    ack.target = 5;
+    ack.result = BleCommandAck::Result::BUSY;
+    ack.latencyMicros = 0x01020304;
+    uint8_t packet[BleCommandAck::SIZE];
+    BleCommandAck decoded;
+    if (BleCommandAck::encode(ack, packet, sizeof(packet) - 1) != 0 ||
+        BleCommandAck::encode(ack, packet, sizeof(packet)) != BleCommandAck::SIZE ||
+        packet[0] != 0xEF || packet[1] != 0xBE || packet[4] != 0x04 || packet[7] != 0x01 ||
+        !BleCommandAck::decode(packet, sizeof(packet), decoded) || decoded.id != ack.id ||
+        decoded.target != ack.target || decoded.result != ack.result || decoded.latencyMicros != ack.latencyMicros) {
+        LOG_TAG_ERROR("BleCmdTest", "确认编解码错误");
+        return false;
+    }
+    return !BleCommandAck::decode(packet, BleCommandAck::SIZE - 1, decoded);
+}
+
+bool BleCommandQueueTest::testServerDeferredWrites() {
+    MotorBLEServer& bleServer = MotorBLEServer::getInstance();
+    if (!BLEDevice::getInitialized() && !bleServer.init()) {
+        LOG_TAG_ERROR("BleCmdTest", "BLE服务器初始化失败: %s", bleServer.getLastError());
+        return false;
+    }
+    ConfigManager& configManager = ConfigManager::getInstance();
+    uint32_t originalStopMs = configManager.getConfig().stopDurationMs;
+    const char* newValue = originalStopMs == 12500 ? "13.5" : "12.5";
+    uint32_t newStopMs = originalStopMs == 12500 ? 13500 : 12500;
+    bool passed = false;
+
+    do {
+        NativeHAL::bleReset();
+        if (!NativeHAL::bleConnect(BLE_LOCAL_MTU)) {
+            LOG_TAG_ERROR("BleCmdTest", "连接失败");
+            break;
+        }
+        bleServer.update();
+        NativeHAL::bleTakeNotifications();
+
+        // 写入回调只入队：配置不变，主循环应立即更新
+        if (!writeText(BLE_STOP_INTERVAL_CHAR_UUID, newValue) ||
+            configManager.getConfig().stopDurationMs != originalStopMs ||
+            bleServer.getCommandQueue().size() != 1 || bleServer.getMicrosUntilNextUpdate() != 0) {
+            LOG_TAG_ERROR("BleCmdTest", "写入回调中不应执行写入");
+            break;
+        }
+        NativeHAL::advanceMicros(2000);
+        bleServer.update();
+        std::vector<BleCommandAck> acks = takeAcks();
+        if (configManager.getConfig().stopDurationMs != newStopMs || acks.size() != 1 ||
+            acks[0].target != MotorBLEServer::WRITE_STOP_INTERVAL || acks[0].result != BleCommandAck::Result::OK ||
+            acks[0].latencyMicros < 2000 || bleServer.getCommandQueue().hasPending()) {
+            LOG_TAG_ERROR("BleCmdTest", "update()后写入未执行或确认错误: %lu ms, %u条确认",
+                          (unsigned long)configManager.getConfig().stopDurationMs, (unsigned)acks.size());
+            break;
+        }
+        uint16_t firstId = acks[0].id;
+
+        // 无效内容：确认为失败，配置不变
+        writeText(BLE_STOP_INTERVAL_CHAR_UUID, "abc");
+        bleServer.update();
+        acks = takeAcks();
+        if (acks.size() != 1 || acks[0].id != (uint16_t)(firstId + 1) ||
+            acks[0].result != BleCommandAck::Result::FAILED ||
+            configManager.getConfig().stopDurationMs != newStopMs) {
+            LOG_TAG_ERROR("BleCmdTest", "无效写入应确认为失败");
+            break;
+        }
+
+        // 队列满：回调中不发送确认，下一次update()先确认为忙；其余分多次update()执行，每次不超过上限
+        for (uint32_t i = 0; i <= BleCommandQueue::capacity(); i++) {
+            writeText(BLE_DIAGNOSTICS_CHAR_UUID, "reset");
+        }
+        if (!takeAcks().empty() || bleServer.getMicrosUntilNextUpdate() != 0) {
+            LOG_TAG_ERROR("BleCmdTest", "写入回调中不应发送确认");
+            break;
+        }
+        bleServer.update();
+        acks = takeAcks();
+        if (acks.size() != BLE_COMMAND_MAX_PER_UPDATE + 1 || acks[0].result != BleCommandAck::Result::BUSY ||
+            acks[0].target != MotorBLEServer::WRITE_DIAGNOSTICS ||
+            acks[0].id != (uint16_t)(firstId + 2 + BleCommandQueue::capacity())) {
+            LOG_TAG_ERROR("BleCmdTest", "队列满时应在update()中确认为忙: %u条确认", (unsigned)acks.size());
+            break;
+        }
+        if (bleServer.getMicrosUntilNextUpdate() != 0) {
+            LOG_TAG_ERROR("BleCmdTest", "单次update()执行条数错误: %u", (unsigned)acks.size());
+            break;
+        }
+        bleServer.update();
+        acks = takeAcks();
+        if (acks.size() != BleCommandQueue::capacity() - BLE_COMMAND_MAX_PER_UPDATE ||
+            acks.back().result != BleCommandAck::Result::OK || bleServer.getCommandQueue().hasPending()) {
+            LOG_TAG_ERROR("BleCmdTest", "剩余写入未执行: %u条确认", (unsigned)acks.size());
+            break;
+        }
+
+        // 分块写入出错（缺少首帧）：回调中不记录错误，update()记录错误并确认为失败
+        const char* message = "12.5                    ";
+        ChunkEncoder encoder((const uint8_t*)message, strlen(message), 3, 20);
+        uint8_t frame[20];
+        encoder.next(frame, sizeof(frame));
+        size_t frameLength = encoder.next(frame, sizeof(frame));
+        NativeHAL::bleWrite(BLE_STOP_INTERVAL_CHAR_UUID, std::string((const char*)frame, frameLength));
+        if (strstr(bleServer.getLastError(), "缺少首帧") != nullptr || !takeAcks().empty() ||
+            bleServer.getMicrosUntilNextUpdate() != 0) {
+            LOG_TAG_ERROR("BleCmdTest", "写入回调中不应记录分块写入错误");
+            break;
+        }
+        bleServer.update();
+        acks = takeAcks();
+        if (acks.size() != 1 || acks[0].id != (uint16_t)(firstId + 3 + BleCommandQueue::capacity()) ||
+            acks[0].result != BleCommandAck::Result::FAILED || acks[0].target != MotorBLEServer::WRITE_STOP_INTERVAL ||
+            strstr(bleServer.getLastError(), "缺少首帧") == nullptr) {
+            LOG_TAG_ERROR("BleCmdTest", "分块写入错误应在update()中记录并确认为失败: %u条确认, %s",
+                          (unsigned)acks.size(), bleServer.getLastError());
+            break;
+        }
+        passed = true;
+    } while (false);
+
+    NativeHAL::bleDisconnect();
+    bleServer.handleStopIntervalWrite(MotorBLEServer::formatDurationSeconds(originalStopMs).c_str());
+    return passed;
+}
+
+bool BleCommandQueueTest::testSpeedControllerConfigAck() {
+    MotorBLEServer& bleServer = MotorBLEServer::getInstance();
+    if (!BLEDevice::getInitialized() && !bleServer.init()) {
+        LOG_TAG_ERROR("BleCmdTest", "BLE服务器初始化失败: %s", bleServer.getLastError());
+        return false;
+    }
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+    const char* config = "{\"minOutput\":10,\"maxOutput\":90,\"softStartTime\":30,\"softStopTime\":20,"
+                         "\"frequency\":1000,\"dutyCycle\":50}";
+    bool passed = false;
+
+    do {
+        NativeHAL::bleReset();
+        if (!NativeHAL::bleConnect(BLE_LOCAL_MTU)) {
+            LOG_TAG_ERROR("BleCmdTest", "连接失败");
+            break;
+        }
+        bleServer.update();
+        NativeHAL::bleTakeNotifications();
+
+        // 执行时只提交MODBUS写入，不确认
+        writeText(BLE_SPEED_CONTROLLER_CONFIG_CHAR_UUID, config);
+        bleServer.update();
+        if (!takeAcks().empty()) {
+            LOG_TAG_ERROR("BleCmdTest", "MODBUS写入完成前不应确认");
+            break;
+        }
+        std::vector<BleCommandAck> acks;
+        for (int i = 0; i < 2000 && acks.empty(); i++) {
+            NativeHAL::advanceMicros(1000);
+            bleServer.update();
+            acks = takeAcks();
+        }
+        if (acks.size() != 1 || acks[0].target != MotorBLEServer::WRITE_SPEED_CONTROLLER_CONFIG ||
+            acks[0].result != BleCommandAck::Result::OK || slave.getRequestCount() == 0) {
+            LOG_TAG_ERROR("BleCmdTest", "写入完成后应确认为已执行: %u条确认", (unsigned)acks.size());
+            break;
+        }
+        uint16_t firstId = acks[0].id;
+
+        // 调速器无应答：重试次数耗尽后确认为失败（等寄存器缓存过期，写入不会因与缓存相同被跳过）
+        NativeHAL::advanceMicros(6000000);
+        slave.setOnline(false);
+        writeText(BLE_SPEED_CONTROLLER_CONFIG_CHAR_UUID, "{\"minOutput\":20,\"frequency\":2000}");
+        acks.clear();
+        for (int i = 0; i < 20000 && acks.empty(); i++) {
+            NativeHAL::advanceMicros(1000);
+            bleServer.update();
+            acks = takeAcks();
+        }
+        if (acks.size() != 1 || acks[0].id != (uint16_t)(firstId + 1) ||
+            acks[0].result != BleCommandAck::Result::FAILED) {
+            LOG_TAG_ERROR("BleCmdTest", "MODBUS写入失败应确认为失败: %u条确认", (unsigned)acks.size());
+            break;
+        }
+        passed = true;
+    } while (false);
+
+    NativeHAL::bleDisconnect();
+    return passed;
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,52 @@
+#ifndef BLE_COMMAND_QUEUE_TEST_H
+#define BLE_COMMAND_QUEUE_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * BLE写入命令队列测试（仅在native环境运行）
+ */
+class BleCommandQueueTest {
+public:
+    /**
+     * 运行所有BLE写入命令队列测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试按收到的顺序执行、内容在入队时复制、编号递增
+     * @return 测试是否通过
+     */
+    static bool testOrderAndCopy();
+
+    /**
+     * 测试内容过长和队列满时拒绝、单次执行条数上限和统计
+     * @return 测试是否通过
+     */
+    static bool testBounds();
+
+    /**
+     * 测试从收到写入到开始执行的延迟（虚拟时钟）和确认的编码
+     * @return 测试是否通过
+     */
+    static bool testLatencyAndAck();
+
+    /**
+     * 测试MotorBLEServer：写入回调只入队，update()执行后通知确认
+     * @return 测试是否通过
+     */
+    static bool testServerDeferredWrites();
+
+    /**
+     * 测试调速器配置写入在MODBUS写入完成后才确认，失败时确认为失败
+     * @return 测试是否通过
+     */
+    static bool testSpeedControllerConfigAck();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // BLE_COMMAND_QUEUE_TEST_H
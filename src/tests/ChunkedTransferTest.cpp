@@ -0,0 +1,437 @@
+#include "ChunkedTransferTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <ArduinoJson.h>
+#include <string>
+#include <vector>
+#include "../common/ChunkedTransfer.h"
+#include "../common/Config.h"
+#include "../common/Logger.h"
+#include "../controllers/ConfigManager.h"
+#include "../controllers/MotorBLEServer.h"
+#include "../controllers/MotorController.h"
+
+namespace {
+
+const size_t MESSAGE_SIZE = 700;
+
+void fillMessage(uint8_t* message, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        message[i] = (uint8_t)(' ' + (i * 7) % 90);
+    }
+}
+
+/**
+ * 把消息编码为帧序列
+ */
+std::vector<std::string> encodeFrames(const uint8_t* message, size_t length, uint8_t transferId, size_t maxFrameSize) {
+    std::vector<std::string> frames;
+    ChunkEncoder encoder(message, length, transferId, maxFrameSize);
+    uint8_t frame[BLE_LOCAL_MTU];
+    size_t frameLength;
+    while ((frameLength = encoder.next(frame, sizeof(frame))) > 0) {
+        frames.push_back(std::string((const char*)frame, frameLength));
+    }
+    return frames;
+}
+
+ChunkAssembler::Result acceptFrame(ChunkAssembler& assembler, const std::string& frame) {
+    return assembler.accept((const uint8_t*)frame.data(), frame.size());
+}
+
+/**
+ * 重组某个特征值的通知（未分块的通知原样返回）
+ */
+std::string assembleNotifications(const std::vector<NativeHAL::BLENotification>& notifications, const char* uuid,
+                                  size_t& count) {
+    uint8_t buffer[BLE_CHUNK_MAX_MESSAGE_SIZE + 1];
+    ChunkAssembler assembler(buffer, sizeof(buffer));
+    std::string message;
+    count = 0;
+    for (const NativeHAL::BLENotification& notification : notifications) {
+        if (notification.uuid != uuid) {
+            continue;
+        }
+        count++;
+        const uint8_t* data = (const uint8_t*)notification.value.data();
+        if (!ChunkFrame::isFrame(data, notification.value.size())) {
+            message = notification.value;
+        } else if (assembler.accept(data, notification.value.size()) == ChunkAssembler::Result::COMPLETE) {
+            message.assign(assembler.getText(), assembler.getLength());
+        }
+    }
+    return message;
+}
+
+/**
+ * 记录通知时特征值中是否出现过分块帧（读取回调转发给原回调）
+ */
+class StoredValueProbe : public BLECharacteristicCallbacks {
+public:
+    explicit StoredValueProbe(BLECharacteristicCallbacks* original) : original(original) {}
+
+    void onRead(BLECharacteristic* characteristic) override {
+        if (original) {
+            original->onRead(characteristic);
+        }
+    }
+
+    void onNotify(BLECharacteristic* characteristic) override {
+        std::string value = characteristic->getValue();
+        if (ChunkFrame::isFrame((const uint8_t*)value.data(), value.size())) {
+            framesStored++;
+        }
+    }
+
+    BLECharacteristicCallbacks* original;
+    size_t framesStored = 0;
+};
+
+/**
+ * 按批间隔推进虚拟时钟并调用update()，直到一批中没有分块帧，返回收到的全部通知
+ * @param maxBatchFrames 单批最多的分块帧数
+ * @param batches 含分块帧的批数
+ */
+std::vector<NativeHAL::BLENotification> drainNotifications(MotorBLEServer& bleServer, size_t& maxBatchFrames,
+                                                          size_t& batches) {
+    std::vector<NativeHAL::BLENotification> all;
+    maxBatchFrames = 0;
+    batches = 0;
+    for (int round = 0; round < 100; round++) {
+        std::vector<NativeHAL::BLENotification> notifications = NativeHAL::bleTakeNotifications();
+        size_t frames = 0;
+        for (const NativeHAL::BLENotification& notification : notifications) {
+            if (ChunkFrame::isFrame((const uint8_t*)notification.value.data(), notification.value.size())) {
+                frames++;
+            }
+        }
+        all.insert(all.end(), notifications.begin(), notifications.end());
+        if (frames == 0) {
+            break;
+        }
+        batches++;
+        if (frames > maxBatchFrames) {
+            maxBatchFrames = frames;
+        }
+        NativeHAL::advanceMicros(BLE_NOTIFY_BATCH_INTERVAL_MICROS);
+        bleServer.update();
+    }
+    return all;
+}
+
+} // namespace
+
+bool ChunkedTransferTest::runAllTests() {
+    LOG_TAG_INFO("ChunkTest", "开始分块传输测试...");
+
+    bool allPassed = true;
+
+    if (!testRoundTrip()) {
+        LOG_TAG_ERROR("ChunkTest", "❌ 编码重组测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ChunkTest", "✅ 编码重组测试通过");
+    }
+
+    if (!testInvalidFrames()) {
+        LOG_TAG_ERROR("ChunkTest", "❌ 无效帧测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ChunkTest", "✅ 无效帧测试通过");
+    }
+
+    if (!testServerTransfer()) {
+        LOG_TAG_ERROR("ChunkTest", "❌ BLE服务器分块传输测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ChunkTest", "✅ BLE服务器分块传输测试通过");
+    }
+
+    if (!testProgramTransfer()) {
+        LOG_TAG_ERROR("ChunkTest", "❌ 电机程序分块传输测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ChunkTest", "✅ 电机程序分块传输测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("ChunkTest", "🎉 所有分块传输测试通过!");
+    }
+    return allPassed;
+}
+
+bool ChunkedTransferTest::testRoundTrip() {
+    uint8_t message[MESSAGE_SIZE];
+    fillMessage(message, sizeof(message));
+    uint8_t buffer[BLE_CHUNK_MAX_MESSAGE_SIZE + 1];
+    ChunkAssembler assembler(buffer, sizeof(buffer));
+
+    // 默认MTU、常见的247和最大512
+    const size_t frameSizes[] = {20, 244, 509};
+    uint8_t transferId = 250;  // 覆盖编号回绕
+    for (size_t frameSize : frameSizes) {
+        ChunkEncoder encoder(message, sizeof(message), transferId, frameSize);
+        std::vector<std::string> frames = encodeFrames(message, sizeof(message), transferId++, frameSize);
+        size_t expectedCount = (sizeof(message) + frameSize - ChunkFrame::HEADER_SIZE - 1) /
+                               (frameSize - ChunkFrame::HEADER_SIZE);
+        if (!encoder.isValid() || encoder.getChunkCount() != expectedCount || frames.size() != expectedCount) {
+            LOG_TAG_ERROR("ChunkTest", "帧大小%u: 帧数错误 %u", (unsigned)frameSize, (unsigned)frames.size());
+            return false;
+        }
+
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (frames[i].size() > frameSize) {
+                LOG_TAG_ERROR("ChunkTest", "帧大小%u: 第%u帧超长", (unsigned)frameSize, (unsigned)i);
+                return false;
+            }
+            ChunkAssembler::Result expected = i + 1 < frames.size() ? ChunkAssembler::Result::INCOMPLETE
+                                                                    : ChunkAssembler::Result::COMPLETE;
+            if (acceptFrame(assembler, frames[i]) != expected) {
+                LOG_TAG_ERROR("ChunkTest", "帧大小%u: 第%u帧结果错误: %s",
+                              (unsigned)frameSize, (unsigned)i, assembler.getLastError());
+                return false;
+            }
+        }
+        if (assembler.getLength() != sizeof(message) || memcmp(assembler.getData(), message, sizeof(message)) != 0 ||
+            assembler.getText()[sizeof(message)] != '\0') {
+            LOG_TAG_ERROR("ChunkTest", "帧大小%u: 重组内容错误", (unsigned)frameSize);
+            return false;
+        }
+    }
+
+    // 帧头放不下负载时无效
+    ChunkEncoder tooSmall(message, sizeof(message), 0, ChunkFrame::HEADER_SIZE);
+    ChunkEncoder empty(message, 0, 0, 20);
+    return !tooSmall.isValid() && !empty.isValid() && assembler.getCompletedCount() == 3;
+}
+
+bool ChunkedTransferTest::testInvalidFrames() {
+    uint8_t message[MESSAGE_SIZE];
+    fillMessage(message, sizeof(message));
+    uint8_t buffer[BLE_CHUNK_MAX_MESSAGE_SIZE + 1];
+    ChunkAssembler assembler(buffer, sizeof(buffer));
+    std::vector<std::string> frames = encodeFrames(message, sizeof(message), 1, 244);
+
+    // CRC错误：负载中翻转一位
+    std::string corrupted = frames[1];
+    corrupted[ChunkFrame::HEADER_SIZE + 3] ^= 0x01;
+    acceptFrame(assembler, frames[0]);
+    acceptFrame(assembler, corrupted);
+    if (acceptFrame(assembler, frames[2]) != ChunkAssembler::Result::ERROR ||
+        strcmp(assembler.getLastError(), "CRC校验失败") != 0) {
+        LOG_TAG_ERROR("ChunkTest", "CRC错误未被发现: %s", assembler.getLastError());
+        return false;
+    }
+
+    // 丢帧
+    acceptFrame(assembler, frames[0]);
+    if (acceptFrame(assembler, frames[2]) != ChunkAssembler::Result::ERROR || assembler.isActive()) {
+        LOG_TAG_ERROR("ChunkTest", "丢帧未被发现");
+        return false;
+    }
+
+    // 缺少首帧、帧头无效
+    if (acceptFrame(assembler, frames[1]) != ChunkAssembler::Result::ERROR ||
+        acceptFrame(assembler, std::string("{\"a\":1}")) != ChunkAssembler::Result::ERROR) {
+        LOG_TAG_ERROR("ChunkTest", "缺少首帧或帧头无效时应拒绝");
+        return false;
+    }
+
+    // 超过重组缓冲区
+    uint8_t small[64];
+    ChunkAssembler smallAssembler(small, sizeof(small));
+    if (acceptFrame(smallAssembler, frames[0]) != ChunkAssembler::Result::ERROR) {
+        LOG_TAG_ERROR("ChunkTest", "超长消息应被拒绝");
+        return false;
+    }
+
+    // 新消息的首帧打断未完成的消息，新消息正常完成
+    std::vector<std::string> next = encodeFrames(message, 100, 2, 244);
+    acceptFrame(assembler, frames[0]);
+    if (acceptFrame(assembler, next[0]) != ChunkAssembler::Result::COMPLETE || assembler.getLength() != 100) {
+        LOG_TAG_ERROR("ChunkTest", "新消息应替换未完成的消息");
+        return false;
+    }
+    return assembler.getErrorCount() == 4;
+}
+
+bool ChunkedTransferTest::testServerTransfer() {
+    MotorBLEServer& bleServer = MotorBLEServer::getInstance();
+    if (!BLEDevice::getInitialized() && !bleServer.init()) {
+        LOG_TAG_ERROR("ChunkTest", "BLE服务器初始化失败: %s", bleServer.getLastError());
+        return false;
+    }
+    uint32_t originalRunMs = ConfigManager::getInstance().getConfig().runDurationMs;
+    BLECharacteristic* statusCharacteristic = BLEDevice::getServer()->findCharacteristic(BLE_STATUS_QUERY_CHAR_UUID);
+    StoredValueProbe probe(statusCharacteristic->getCallbacks());
+    statusCharacteristic->setCallbacks(&probe);
+    bool passed = false;
+
+    do {
+        // 默认MTU：单包负载20字节
+        NativeHAL::bleReset();
+        if (!NativeHAL::bleConnect() || bleServer.getPeerMTU() != 23) {
+            LOG_TAG_ERROR("ChunkTest", "默认MTU错误: %u", bleServer.getPeerMTU());
+            break;
+        }
+
+        // 超过单包负载的写入不能直接写入，分块后可以
+        std::string value = "7.5";
+        value.append(40, ' ');
+        if (NativeHAL::bleWrite(BLE_RUN_DURATION_CHAR_UUID, value)) {
+            LOG_TAG_ERROR("ChunkTest", "超过MTU的写入应被拒绝");
+            break;
+        }
+        NativeHAL::bleTakeNotifications();
+        std::vector<std::string> frames = encodeFrames((const uint8_t*)value.data(), value.size(), 7, 20);
+        for (const std::string& frame : frames) {
+            NativeHAL::bleWrite(BLE_RUN_DURATION_CHAR_UUID, frame);
+        }
+        // 写入由主循环执行
+        bleServer.update();
+        if (frames.size() < 2 || ConfigManager::getInstance().getConfig().runDurationMs != 7500) {
+            LOG_TAG_ERROR("ChunkTest", "分块写入未生效: %u帧, 运行时长%lu ms", (unsigned)frames.size(),
+                          (unsigned long)ConfigManager::getInstance().getConfig().runDurationMs);
+            break;
+        }
+
+        // 状态关键帧超过单包负载：分块通知分批发送，重组后为完整JSON
+        // 分批发送期间特征值保持为完整内容（帧直接通知，不替换特征值），读取不会取到分块帧
+        std::string stored = statusCharacteristic->getValue();
+        size_t count = 0;
+        size_t maxBatchFrames = 0;
+        size_t batches = 0;
+        std::vector<NativeHAL::BLENotification> notifications = drainNotifications(bleServer, maxBatchFrames, batches);
+        std::string json = assembleNotifications(notifications, BLE_STATUS_QUERY_CHAR_UUID, count);
+        DynamicJsonDocument doc(1024);
+        if (count < 2 || deserializeJson(doc, json) || strcmp(doc["type"] | "", "keyframe") != 0 ||
+            doc["runDurationMs"].as<uint32_t>() != 7500) {
+            LOG_TAG_ERROR("ChunkTest", "分块通知错误: %u包, %s", (unsigned)count, json.c_str());
+            break;
+        }
+        if (stored != json || statusCharacteristic->getValue() != json || probe.framesStored > 0) {
+            LOG_TAG_ERROR("ChunkTest", "分块通知期间特征值被替换: %u字节, 出现分块帧%u次", (unsigned)stored.size(),
+                          (unsigned)probe.framesStored);
+            break;
+        }
+        if (maxBatchFrames > BLE_NOTIFY_FRAMES_PER_BATCH || batches < 2 || bleServer.getMicrosUntilNextUpdate() == 0) {
+            LOG_TAG_ERROR("ChunkTest", "分块通知未分批发送: 单批最多%u帧, %u批", (unsigned)maxBatchFrames,
+                          (unsigned)batches);
+            break;
+        }
+        LOG_TAG_INFO("ChunkTest", "MTU 23: 关键帧%u字节分%u包、%u批通知", (unsigned)json.size(), (unsigned)count,
+                     (unsigned)batches);
+        NativeHAL::bleDisconnect();
+
+        // 协商到512：关键帧一包通知，不分块
+        if (!NativeHAL::bleConnect(BLE_LOCAL_MTU) || bleServer.getPeerMTU() != BLE_LOCAL_MTU) {
+            LOG_TAG_ERROR("ChunkTest", "MTU协商结果错误: %u", bleServer.getPeerMTU());
+            break;
+        }
+        NativeHAL::bleTakeNotifications();
+        bleServer.update();
+        json = assembleNotifications(NativeHAL::bleTakeNotifications(), BLE_STATUS_QUERY_CHAR_UUID, count);
+        if (count != 1 || json.empty() || json[0] != '{') {
+            LOG_TAG_ERROR("ChunkTest", "MTU 512时关键帧应一包通知: %u包", (unsigned)count);
+            break;
+        }
+        LOG_TAG_INFO("ChunkTest", "MTU %u: 关键帧%u字节1包通知", BLE_LOCAL_MTU, (unsigned)json.size());
+        passed = true;
+    } while (false);
+
+    NativeHAL::bleDisconnect();
+    statusCharacteristic->setCallbacks(probe.original);
+    bleServer.handleRunDurationWrite(MotorBLEServer::formatDurationSeconds(originalRunMs).c_str());
+    return passed;
+}
+
+bool ChunkedTransferTest::testProgramTransfer() {
+    MotorBLEServer& bleServer = MotorBLEServer::getInstance();
+    if (!BLEDevice::getInitialized() && !bleServer.init()) {
+        LOG_TAG_ERROR("ChunkTest", "BLE服务器初始化失败: %s", bleServer.getLastError());
+        return false;
+    }
+    MotorController& motorController = MotorController::getInstance();
+    MotorProgram original = motorController.getProgram();
+
+    // 64条指令，每个步骤带全部设定值，序列化后超过特征值上限
+    MotorProgram program;
+    ProgramSetpoint setpoint = {ProgramSetpoint::FREQUENCY | ProgramSetpoint::DUTY | ProgramSetpoint::RAMP,
+                                2000000, 100, 20000};
+    program.beginRepeat(2);
+    while (program.getInstructionCount() < MotorProgram::MAX_INSTRUCTIONS - 1) {
+        program.addStep(3600000 + program.getInstructionCount(), program.getInstructionCount() % 2, setpoint);
+    }
+    program.endRepeat();
+    uint8_t serialized[MotorProgram::MAX_SERIALIZED_SIZE];
+    size_t length = program.compile() ? program.serialize(serialized, sizeof(serialized)) : 0;
+    std::string expected((const char*)serialized, length);
+    bool passed = false;
+
+    do {
+        if (length <= ESP_GATT_MAX_ATTR_LEN) {
+            LOG_TAG_ERROR("ChunkTest", "测试程序应超过特征值上限: %u字节", (unsigned)length);
+            break;
+        }
+
+        NativeHAL::bleReset();
+        if (!NativeHAL::bleConnect(247)) {
+            LOG_TAG_ERROR("ChunkTest", "连接失败");
+            break;
+        }
+        std::vector<std::string> frames = encodeFrames(serialized, length, 11, 244);
+        for (const std::string& frame : frames) {
+            NativeHAL::bleWrite(BLE_PROGRAM_CHAR_UUID, frame);
+        }
+        bleServer.update();
+        uint8_t loaded[MotorProgram::MAX_SERIALIZED_SIZE];
+        size_t loadedLength = motorController.getProgram().serialize(loaded, sizeof(loaded));
+        if (loadedLength != length || memcmp(loaded, serialized, length) != 0) {
+            LOG_TAG_ERROR("ChunkTest", "分块写入的电机程序未加载: %u帧, %u字节", (unsigned)frames.size(),
+                          (unsigned)loadedLength);
+            break;
+        }
+
+        // 读取返回执行状态
+        DynamicJsonDocument doc(512);
+        std::string status = NativeHAL::bleRead(BLE_PROGRAM_CHAR_UUID);
+        if (deserializeJson(doc, status) || doc["instructions"].as<unsigned>() != MotorProgram::MAX_INSTRUCTIONS ||
+            doc["size"].as<size_t>() != length) {
+            LOG_TAG_ERROR("ChunkTest", "电机程序状态错误: %s", status.c_str());
+            break;
+        }
+
+        // "read"命令分块通知二进制程序，特征值保持为执行状态（先等上一批分块通知的间隔结束）
+        NativeHAL::advanceMicros(BLE_NOTIFY_BATCH_INTERVAL_MICROS);
+        NativeHAL::bleTakeNotifications();
+        NativeHAL::bleWrite(BLE_PROGRAM_CHAR_UUID, "{\"action\":\"read\"}");
+        bleServer.update();
+        size_t count = 0;
+        size_t maxBatchFrames = 0;
+        size_t batches = 0;
+        std::vector<NativeHAL::BLENotification> notifications = drainNotifications(bleServer, maxBatchFrames, batches);
+        std::string received = assembleNotifications(notifications, BLE_PROGRAM_CHAR_UUID, count);
+        if (count < 2 || received != expected) {
+            LOG_TAG_ERROR("ChunkTest", "电机程序通知错误: %u包, %u字节", (unsigned)count, (unsigned)received.size());
+            break;
+        }
+        if (BLEDevice::getServer()->findCharacteristic(BLE_PROGRAM_CHAR_UUID)->getValue() != status) {
+            LOG_TAG_ERROR("ChunkTest", "电机程序通知替换了执行状态");
+            break;
+        }
+        LOG_TAG_INFO("ChunkTest", "MTU 247: 电机程序%u字节分%u帧写入、%u包通知", (unsigned)length,
+                     (unsigned)frames.size(), (unsigned)count);
+        passed = true;
+    } while (false);
+
+    NativeHAL::bleDisconnect();
+    if (original.isCompiled()) {
+        motorController.loadProgram(original);
+        ConfigManager::getInstance().saveProgram(original);
+    }
+    return passed;
+}
+
+#endif // NATIVE_BUILD
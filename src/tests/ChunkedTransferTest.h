@@ -0,0 +1,46 @@
+#ifndef CHUNKED_TRANSFER_TEST_H
+#define CHUNKED_TRANSFER_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * BLE MTU协商和分块传输测试（仅在native环境运行）
+ */
+class ChunkedTransferTest {
+public:
+    /**
+     * 运行所有分块传输测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试不同帧大小下编码后重组得到原消息
+     * @return 测试是否通过
+     */
+    static bool testRoundTrip();
+
+    /**
+     * 测试CRC错误、丢帧、缺少首帧、超长消息被拒绝，以及新消息打断未完成的消息
+     * @return 测试是否通过
+     */
+    static bool testInvalidFrames();
+
+    /**
+     * 测试MotorBLEServer：记录协商的MTU，超过单包负载的写入和通知分块传输
+     * @return 测试是否通过
+     */
+    static bool testServerTransfer();
+
+    /**
+     * 测试超过特征值上限的二进制电机程序分块写入，"read"命令分块通知回同样内容
+     * @return 测试是否通过
+     */
+    static bool testProgramTransfer();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // CHUNKED_TRANSFER_TEST_H
@@ -1,11 +1,14 @@
 #include "ConfigManagerTest.h"
 #include <Arduino.h>
 
+uint32_t ConfigManagerTest::failureCount = 0;
+
 /**
  * 运行所有测试
  */
-void ConfigManagerTest::runAllTests() {
+bool ConfigManagerTest::runAllTests() {
     Serial.println("=== ConfigManager 单元测试开始 ===");
+    failureCount = 0;
     
     testSingleton();
     testInit();
@@ -17,6 +20,7 @@ void ConfigManagerTest::runAllTests() {
     testBoundaryValues();
     
     Serial.println("=== ConfigManager 单元测试完成 ===");
+    return failureCount == 0;
 }
 
 /**
@@ -58,8 +62,8 @@ void ConfigManagerTest::testConfigValidation() {
     
     // 测试有效配置
     MotorConfig validConfig;
-    validConfig.runDuration = 5;
-    validConfig.stopDuration = 2;
+    validConfig.runDurationMs = 5000;
+    validConfig.stopDurationMs = 2000;
     validConfig.cycleCount = 10;
     validConfig.autoStart = true;
     
@@ -67,15 +71,15 @@ void ConfigManagerTest::testConfigValidation() {
     
     // 测试无效运行时长
     MotorConfig invalidRunDuration = validConfig;
-    invalidRunDuration.runDuration = 0;  // 小于1秒
+    invalidRunDuration.runDurationMs = MOTOR_MIN_RUN_DURATION_MS - 1;  // 小于10毫秒
     assertFalse(manager.validateConfig(invalidRunDuration), "运行时长过小应该失败");
     
-    invalidRunDuration.runDuration = 1000;  // 大于999秒
+    invalidRunDuration.runDurationMs = MOTOR_MAX_DURATION_MS + 1;  // 大于7天
     assertFalse(manager.validateConfig(invalidRunDuration), "运行时长过大应该失败");
     
     // 测试无效停止时长
     MotorConfig invalidStopDuration = validConfig;
-    invalidStopDuration.stopDuration = 1000;  // 大于999秒
+    invalidStopDuration.stopDurationMs = MOTOR_MAX_DURATION_MS + 1;  // 大于7天
     assertFalse(manager.validateConfig(invalidStopDuration), "停止时长过大应该失败");
     
     // 测试无效循环次数
@@ -99,8 +103,8 @@ void ConfigManagerTest::testLoadSaveConfig() {
     
     // 创建测试配置
     MotorConfig testConfig;
-    testConfig.runDuration = 30;
-    testConfig.stopDuration = 15;
+    testConfig.runDurationMs = 30000;
+    testConfig.stopDurationMs = 15000;
     testConfig.cycleCount = 5;
     testConfig.autoStart = false;
     
@@ -116,8 +120,8 @@ void ConfigManagerTest::testLoadSaveConfig() {
     
     // 验证当前配置已重置
     const MotorConfig& defaultConfig = manager.getConfig();
-    assertEqual(5, defaultConfig.runDuration, "重置后应该使用默认运行时长");
-    assertEqual(2, defaultConfig.stopDuration, "重置后应该使用默认停止时长");
+    assertEqual(5000, defaultConfig.runDurationMs, "重置后应该使用默认运行时长");
+    assertEqual(2000, defaultConfig.stopDurationMs, "重置后应该使用默认停止时长");
     assertEqual(0, defaultConfig.cycleCount, "重置后应该使用默认循环次数");
     assertEqual(true, defaultConfig.autoStart, "重置后应该使用默认自动启动设置");
     
@@ -127,8 +131,8 @@ void ConfigManagerTest::testLoadSaveConfig() {
     
     // 验证加载的配置
     const MotorConfig& loadedConfig = manager.getConfig();
-    assertEqual(30, loadedConfig.runDuration, "加载的运行时长应该匹配");
-    assertEqual(15, loadedConfig.stopDuration, "加载的停止时长应该匹配");
+    assertEqual(30000, loadedConfig.runDurationMs, "加载的运行时长应该匹配");
+    assertEqual(15000, loadedConfig.stopDurationMs, "加载的停止时长应该匹配");
     assertEqual(5, loadedConfig.cycleCount, "加载的循环次数应该匹配");
     assertEqual(false, loadedConfig.autoStart, "加载的自动启动设置应该匹配");
     
@@ -143,12 +147,15 @@ void ConfigManagerTest::testDefaultValues() {
     
     ConfigManager& manager = ConfigManager::getInstance();
     
+    // 之前的测试加载过其他配置，先恢复默认值
+    manager.resetToDefaults();
+    
     // 获取当前配置
     const MotorConfig& config = manager.getConfig();
     
     // 验证默认值
-    assertEqual(5, config.runDuration, "默认运行时长应该是5秒");
-    assertEqual(2, config.stopDuration, "默认停止时长应该是2秒");
+    assertEqual(5000, config.runDurationMs, "默认运行时长应该是5秒");
+    assertEqual(2000, config.stopDurationMs, "默认停止时长应该是2秒");
     assertEqual(0, config.cycleCount, "默认循环次数应该是0（无限）");
     assertEqual(true, config.autoStart, "默认应该自动启动");
     
@@ -171,7 +178,7 @@ void ConfigManagerTest::testConfigModification() {
     
     // 创建新配置
     MotorConfig newConfig;
-    newConfig.runDuration = 80;
+    newConfig.runDurationMs = 80000;
     
     // 更新配置
     manager.updateConfig(newConfig);
@@ -194,10 +201,10 @@ void ConfigManagerTest::testErrorHandling() {
     
     // 测试无效配置的错误信息
     MotorConfig invalidConfig;
-    invalidConfig.runDuration = 0;  // 无效值
+    invalidConfig.runDurationMs = 0;  // 无效值
     
     assertFalse(manager.validateConfig(invalidConfig), "无效配置应该失败");
-    assertEqualString("运行时长必须在1秒到999秒之间", manager.getValidationError(), "应该返回正确的验证错误");
+    assertEqualString("运行时长必须在10毫秒到7天之间", manager.getValidationError(), "应该返回正确的验证错误");
     
     Serial.println("✓ 错误处理测试通过");
 }
@@ -214,14 +221,14 @@ void ConfigManagerTest::testBoundaryValues() {
     MotorConfig boundaryConfig;
     
     // 最小有效值
-    boundaryConfig.runDuration = 1;
-    boundaryConfig.stopDuration = 0;
+    boundaryConfig.runDurationMs = MOTOR_MIN_RUN_DURATION_MS;
+    boundaryConfig.stopDurationMs = 0;
     boundaryConfig.cycleCount = 0;
     assertTrue(manager.validateConfig(boundaryConfig), "最小边界值应该有效");
     
     // 最大有效值
-    boundaryConfig.runDuration = 999;
-    boundaryConfig.stopDuration = 999;
+    boundaryConfig.runDurationMs = MOTOR_MAX_DURATION_MS;
+    boundaryConfig.stopDurationMs = MOTOR_MAX_DURATION_MS;
     boundaryConfig.cycleCount = 1000000;
     assertTrue(manager.validateConfig(boundaryConfig), "最大边界值应该有效");
     
@@ -233,6 +240,7 @@ void ConfigManagerTest::testBoundaryValues() {
  */
 void ConfigManagerTest::assertTrue(bool condition, const char* message) {
     if (!condition) {
+        failureCount++;
         Serial.print("❌ 断言失败: ");
         Serial.println(message);
     } else {
@@ -247,6 +255,7 @@ void ConfigManagerTest::assertFalse(bool condition, const char* message) {
 
 void ConfigManagerTest::assertEqual(uint32_t expected, uint32_t actual, const char* message) {
     if (expected != actual) {
+        failureCount++;
         Serial.print("❌ 断言失败: ");
         Serial.print(message);
         Serial.print(" (期望: ");
@@ -262,6 +271,7 @@ void ConfigManagerTest::assertEqual(uint32_t expected, uint32_t actual, const ch
 
 void ConfigManagerTest::assertEqual(bool expected, bool actual, const char* message) {
     if (expected != actual) {
+        failureCount++;
         Serial.print("❌ 断言失败: ");
         Serial.print(message);
         Serial.print(" (期望: ");
@@ -277,6 +287,7 @@ void ConfigManagerTest::assertEqual(bool expected, bool actual, const char* mess
 
 void ConfigManagerTest::assertEqualString(const char* expected, const char* actual, const char* message) {
     if (strcmp(expected, actual) != 0) {
+        failureCount++;
         Serial.print("❌ 断言失败: ");
         Serial.print(message);
         Serial.print(" (期望: \"");
@@ -11,8 +11,9 @@ class ConfigManagerTest {
 public:
     /**
      * 运行所有测试
+     * @return 所有断言是否通过
      */
-    static void runAllTests();
+    static bool runAllTests();
     
 private:
     /**
@@ -63,6 +64,11 @@ private:
     static void assertEqual(uint32_t expected, uint32_t actual, const char* message);
     static void assertEqual(bool expected, bool actual, const char* message);
     static void assertEqualString(const char* expected, const char* actual, const char* message);
+    
+    /**
+     * 本次运行失败的断言数
+     */
+    static uint32_t failureCount;
 };
 
 #endif // CONFIG_MANAGER_TEST_H
\ No newline at end of file
@@ -0,0 +1,438 @@
+#include "DeadlineSchedulerTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <string>
+#include "../common/DeadlineScheduler.h"
+#include "../common/WakeSignal.h"
+#include "../common/Logger.h"
+
+namespace {
+
+// 手动推进的测试时钟
+uint32_t testNowMicros = 0;
+
+uint32_t testClock() {
+    return testNowMicros;
+}
+
+uint32_t halClock() {
+    return micros();
+}
+
+void IRAM_ATTR wakeFromTimerISR() {
+    WakeSignal::getInstance().notifyFromISR();
+}
+
+/**
+ * 电机运行/停止循环模型：与MotorController一样在检测到切换时从当前时刻开始下一阶段
+ */
+struct MotorCycleModel {
+    uint32_t runMicros;
+    uint32_t stopMicros;
+    bool running;
+    uint32_t phaseStartMicros;
+    uint32_t edges;
+    uint32_t maxLatenessMicros;
+    uint64_t totalLatenessMicros;
+
+    MotorCycleModel(uint32_t runMs, uint32_t stopMs, uint32_t now)
+        : runMicros(runMs * 1000), stopMicros(stopMs * 1000), running(true), phaseStartMicros(now),
+          edges(0), maxLatenessMicros(0), totalLatenessMicros(0) {}
+
+    uint32_t phaseMicros() const { return running ? runMicros : stopMicros; }
+
+    void update(uint32_t now) {
+        uint32_t elapsed = now - phaseStartMicros;
+        if (elapsed < phaseMicros()) {
+            return;
+        }
+        uint32_t lateness = elapsed - phaseMicros();
+        edges++;
+        totalLatenessMicros += lateness;
+        if (lateness > maxLatenessMicros) {
+            maxLatenessMicros = lateness;
+        }
+        running = !running;
+        phaseStartMicros = now;
+    }
+
+    uint32_t microsUntilNextEdge(uint32_t now) const {
+        uint32_t elapsed = now - phaseStartMicros;
+        return elapsed >= phaseMicros() ? 0 : phaseMicros() - elapsed;
+    }
+};
+
+// 模拟每次主循环唤醒后的处理耗时
+const uint32_t LOOP_BODY_MICROS = 150;
+const uint32_t STATUS_INTERVAL_MICROS = 1000000;
+
+} // namespace
+
+bool DeadlineSchedulerTest::runAllTests() {
+    LOG_TAG_INFO("SchedulerTest", "开始截止时间调度器测试...");
+
+    bool allPassed = true;
+
+    if (!testDeadlineOrder()) {
+        LOG_TAG_ERROR("SchedulerTest", "❌ 截止时间顺序测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("SchedulerTest", "✅ 截止时间顺序测试通过");
+    }
+
+    if (!testWakeAndSinglePass()) {
+        LOG_TAG_ERROR("SchedulerTest", "❌ 唤醒与单轮执行测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("SchedulerTest", "✅ 唤醒与单轮执行测试通过");
+    }
+
+    if (!testOverrunStatistics()) {
+        LOG_TAG_ERROR("SchedulerTest", "❌ 超期统计测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("SchedulerTest", "✅ 超期统计测试通过");
+    }
+
+    if (!testClockWrap()) {
+        LOG_TAG_ERROR("SchedulerTest", "❌ 时钟回绕测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("SchedulerTest", "✅ 时钟回绕测试通过");
+    }
+
+    if (!testModifyDuringRun()) {
+        LOG_TAG_ERROR("SchedulerTest", "❌ 执行期间增删任务测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("SchedulerTest", "✅ 执行期间增删任务测试通过");
+    }
+
+    if (!testWakeSignal()) {
+        LOG_TAG_ERROR("SchedulerTest", "❌ 唤醒信号测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("SchedulerTest", "✅ 唤醒信号测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("SchedulerTest", "🎉 所有截止时间调度器测试通过!");
+    } else {
+        LOG_TAG_ERROR("SchedulerTest", "💥 部分截止时间调度器测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool DeadlineSchedulerTest::testDeadlineOrder() {
+    testNowMicros = 1000;
+    DeadlineScheduler scheduler(testClock);
+    std::string order;
+
+    scheduler.addTask("a", [&order](uint32_t) -> uint32_t { order += 'a'; return DeadlineScheduler::NO_DEADLINE; }, 300);
+    scheduler.addTask("b", [&order](uint32_t) -> uint32_t { order += 'b'; return DeadlineScheduler::NO_DEADLINE; }, 100);
+    int8_t c = scheduler.addTask("c", [&order](uint32_t) -> uint32_t { order += 'c'; return 50; }, 200);
+
+    // 尚未到期：返回距最早截止时间的间隔
+    if (scheduler.runDue() != 100 || !order.empty()) {
+        LOG_TAG_ERROR("SchedulerTest", "未到期的任务不应执行");
+        return false;
+    }
+
+    testNowMicros += 250;
+    if (scheduler.runDue() != 50 || order != "bc") {
+        LOG_TAG_ERROR("SchedulerTest", "到期任务执行顺序错误: %s", order.c_str());
+        return false;
+    }
+
+    testNowMicros += 100;
+    scheduler.runDue();
+    if (order != "bcac") {
+        LOG_TAG_ERROR("SchedulerTest", "到期任务执行顺序错误: %s", order.c_str());
+        return false;
+    }
+
+    // 只剩c有截止时间；取消后没有任何截止时间
+    scheduler.runAfter(c, DeadlineScheduler::NO_DEADLINE);
+    if (scheduler.getMicrosUntilNextDeadline() != DeadlineScheduler::NO_DEADLINE) {
+        LOG_TAG_ERROR("SchedulerTest", "取消截止时间后仍有等待时间");
+        return false;
+    }
+
+    return true;
+}
+
+bool DeadlineSchedulerTest::testWakeAndSinglePass() {
+    testNowMicros = 0;
+    DeadlineScheduler scheduler(testClock);
+    uint32_t idleRuns = 0;
+    uint32_t busyRuns = 0;
+    uint32_t wakerRuns = 0;
+
+    int8_t idle = scheduler.addTask("idle", [&idleRuns](uint32_t) -> uint32_t {
+        idleRuns++;
+        return DeadlineScheduler::NO_DEADLINE;
+    }, DeadlineScheduler::NO_DEADLINE);
+    // 总是立即再次到期的任务每轮也只执行一次
+    scheduler.addTask("busy", [&busyRuns](uint32_t) -> uint32_t {
+        busyRuns++;
+        return 0;
+    });
+
+    if (scheduler.runDue() != 0 || busyRuns != 1 || idleRuns != 0) {
+        LOG_TAG_ERROR("SchedulerTest", "每轮应只执行一次到期任务 (busy=%lu idle=%lu)", busyRuns, idleRuns);
+        return false;
+    }
+
+    scheduler.wake(idle);
+    scheduler.runDue();
+    if (idleRuns != 1 || busyRuns != 2) {
+        LOG_TAG_ERROR("SchedulerTest", "wake()后任务未执行");
+        return false;
+    }
+
+    // 执行中的任务调用wakeAll()：其他任务在本轮执行，自己不再重复执行
+    scheduler.addTask("waker", [&scheduler, &wakerRuns](uint32_t) -> uint32_t {
+        wakerRuns++;
+        scheduler.wakeAll();
+        return DeadlineScheduler::NO_DEADLINE;
+    });
+    scheduler.runDue();
+    if (wakerRuns != 1 || idleRuns != 2 || busyRuns != 3) {
+        LOG_TAG_ERROR("SchedulerTest", "wakeAll()结果错误 (waker=%lu idle=%lu busy=%lu)", wakerRuns, idleRuns, busyRuns);
+        return false;
+    }
+
+    scheduler.runDue();
+    if (wakerRuns != 1 || idleRuns != 2) {
+        LOG_TAG_ERROR("SchedulerTest", "无截止时间的任务不应再次执行");
+        return false;
+    }
+
+    return true;
+}
+
+bool DeadlineSchedulerTest::testOverrunStatistics() {
+    testNowMicros = 0;
+    DeadlineScheduler scheduler(testClock, 1000);
+
+    // 每次执行耗时300us，周期2ms
+    int8_t task = scheduler.addTask("periodic", [](uint32_t) -> uint32_t {
+        testNowMicros += 300;
+        return 2000;
+    });
+    scheduler.runDue();
+
+    // 晚到500us：不算超期
+    testNowMicros = 2500;
+    scheduler.runDue();
+    // 晚到2500us：超期
+    testNowMicros = 7000;
+    scheduler.runDue();
+    // 被唤醒提前执行不统计延迟
+    scheduler.wake(task);
+    testNowMicros = 9000;
+    scheduler.runDue();
+
+    DeadlineScheduler::TaskStatistics stats;
+    if (!scheduler.getStatistics(task, stats)) {
+        return false;
+    }
+    if (stats.runs != 4 || stats.overruns != 1 || stats.maxLatenessMicros != 2500 ||
+        stats.maxRunMicros != 300 || stats.totalRunMicros != 1200) {
+        LOG_TAG_ERROR("SchedulerTest", "统计错误: 执行%lu次 超期%lu次 最大延迟%lu 最长耗时%lu 累计%lu",
+                      stats.runs, stats.overruns, stats.maxLatenessMicros, stats.maxRunMicros, stats.totalRunMicros);
+        return false;
+    }
+
+    scheduler.resetStatistics();
+    scheduler.getStatistics(task, stats);
+    if (stats.runs != 0 || stats.overruns != 0) {
+        LOG_TAG_ERROR("SchedulerTest", "统计未重置");
+        return false;
+    }
+    return true;
+}
+
+bool DeadlineSchedulerTest::testClockWrap() {
+    testNowMicros = 0xFFFFFF00;
+    DeadlineScheduler scheduler(testClock);
+    uint32_t runs = 0;
+
+    scheduler.addTask("wrap", [&runs](uint32_t) -> uint32_t {
+        runs++;
+        return DeadlineScheduler::NO_DEADLINE;
+    }, 0x200);
+
+    testNowMicros = 0xFFFFFFFF;
+    uint32_t wait = scheduler.runDue();
+    if (runs != 0 || wait != 0x101) {
+        LOG_TAG_ERROR("SchedulerTest", "回绕前不应到期 (等待%lu)", wait);
+        return false;
+    }
+
+    testNowMicros = 0x100;
+    scheduler.runDue();
+    if (runs != 1) {
+        LOG_TAG_ERROR("SchedulerTest", "回绕后任务未执行");
+        return false;
+    }
+
+    // 超过上限的延迟被截断，不会被当作已过期
+    int8_t far = scheduler.addTask("far", [](uint32_t) -> uint32_t { return 0; }, 0xFFFFFFF0);
+    if (far == DeadlineScheduler::INVALID_TASK ||
+        scheduler.getMicrosUntilNextDeadline() != DeadlineScheduler::MAX_DELAY_MICROS) {
+        LOG_TAG_ERROR("SchedulerTest", "超长延迟未截断");
+        return false;
+    }
+    return true;
+}
+
+bool DeadlineSchedulerTest::testModifyDuringRun() {
+    testNowMicros = 0;
+    DeadlineScheduler scheduler(testClock);
+    uint32_t onceRuns = 0;
+    uint32_t addedRuns = 0;
+    int8_t added = DeadlineScheduler::INVALID_TASK;
+
+    int8_t once = DeadlineScheduler::INVALID_TASK;
+    once = scheduler.addTask("once", [&](uint32_t) -> uint32_t {
+        onceRuns++;
+        scheduler.removeTask(once);
+        // 新任务不能占用正在执行的任务的槽位
+        added = scheduler.addTask("added", [&addedRuns](uint32_t) -> uint32_t {
+            addedRuns++;
+            return DeadlineScheduler::NO_DEADLINE;
+        });
+        return 0;
+    });
+
+    // 新任务从下一轮开始执行
+    scheduler.runDue();
+    if (onceRuns != 1 || added == DeadlineScheduler::INVALID_TASK || added == once || addedRuns != 0) {
+        LOG_TAG_ERROR("SchedulerTest", "执行期间增删任务结果错误 (once=%lu added=%lu)", onceRuns, addedRuns);
+        return false;
+    }
+
+    scheduler.runDue();
+    if (onceRuns != 1 || addedRuns != 1 || scheduler.getTaskCount() != 1 || scheduler.getTaskName(once) != nullptr) {
+        LOG_TAG_ERROR("SchedulerTest", "已删除的任务仍在执行");
+        return false;
+    }
+    return true;
+}
+
+bool DeadlineSchedulerTest::testWakeSignal() {
+    WakeSignal& signal = WakeSignal::getInstance();
+    // 其他测试发布的异步事件可能留下未处理的唤醒
+    signal.wait(0);
+
+    // 没有唤醒时阻塞到超时，超时向上取整到tick（不忙等）
+    uint64_t start = NativeHAL::nowMicros();
+    if (signal.wait(5300)) {
+        LOG_TAG_ERROR("SchedulerTest", "没有notify时不应被唤醒");
+        return false;
+    }
+    uint64_t waited = NativeHAL::nowMicros() - start;
+    if (waited != 6 * portTICK_PERIOD_MS * 1000) {
+        LOG_TAG_ERROR("SchedulerTest", "超时等待时间错误: %lu us", static_cast<uint32_t>(waited));
+        return false;
+    }
+
+    // 重复notify只释放一次信号量
+    uint32_t notifies = signal.getNotifyCount();
+    signal.notify();
+    signal.notify();
+    if (signal.getNotifyCount() != notifies + 1 || !signal.wait(1000) || signal.wait(0)) {
+        LOG_TAG_ERROR("SchedulerTest", "重复notify处理错误");
+        return false;
+    }
+
+    // 定时器中断在2ms时唤醒，等待提前结束
+    hw_timer_t* timer = timerBegin(3, 80, true);
+    timerAttachInterrupt(timer, &wakeFromTimerISR, true);
+    timerAlarmWrite(timer, 2000, false);
+    timerAlarmEnable(timer);
+
+    start = NativeHAL::nowMicros();
+    bool woken = signal.wait(100000);
+    waited = NativeHAL::nowMicros() - start;
+    timerEnd(timer);
+    if (!woken || waited > 3000) {
+        LOG_TAG_ERROR("SchedulerTest", "定时器中断未提前唤醒 (等待%lu us)", static_cast<uint32_t>(waited));
+        return false;
+    }
+
+    return true;
+}
+
+bool DeadlineSchedulerTest::runLoopComparison() {
+    const uint32_t durationMicros = 60000000;
+    LOG_TAG_INFO("SchedulerTest", "模拟60秒电机循环（运行5秒/停止2秒，已连接BLE每秒推送状态，每次唤醒处理%luus）...",
+                 LOOP_BODY_MICROS);
+
+    // 固定10ms主循环
+    uint32_t fixedWakeups = 0;
+    uint32_t fixedStatus = 0;
+    uint32_t start = micros();
+    MotorCycleModel fixedModel(5000, 2000, start);
+    uint32_t lastStatus = start;
+    while (micros() - start < durationMicros) {
+        fixedModel.update(micros());
+        if (micros() - lastStatus >= STATUS_INTERVAL_MICROS) {
+            lastStatus = micros();
+            fixedStatus++;
+        }
+        fixedWakeups++;
+        NativeHAL::advanceMicros(LOOP_BODY_MICROS);
+        delay(10);
+    }
+
+    // 截止时间调度：休眠到最早的截止时间
+    WakeSignal& signal = WakeSignal::getInstance();
+    signal.wait(0);
+    uint32_t scheduledWakeups = 0;
+    uint32_t scheduledStatus = 0;
+    start = micros();
+    MotorCycleModel scheduledModel(5000, 2000, start);
+    lastStatus = start;
+
+    DeadlineScheduler scheduler(halClock);
+    scheduler.addTask("motor", [&scheduledModel](uint32_t now) -> uint32_t {
+        scheduledModel.update(now);
+        return scheduledModel.microsUntilNextEdge(now);
+    });
+    scheduler.addTask("status", [&lastStatus, &scheduledStatus](uint32_t now) -> uint32_t {
+        if (now - lastStatus >= STATUS_INTERVAL_MICROS) {
+            lastStatus = now;
+            scheduledStatus++;
+        }
+        return STATUS_INTERVAL_MICROS - (now - lastStatus);
+    });
+    while (micros() - start < durationMicros) {
+        scheduler.runDue();
+        scheduledWakeups++;
+        // 处理耗时计入本次唤醒，之后再计算休眠时间
+        NativeHAL::advanceMicros(LOOP_BODY_MICROS);
+        if (signal.wait(scheduler.getMicrosUntilNextDeadline())) {
+            scheduler.wakeAll();
+        }
+    }
+
+    float fixedAverage = fixedModel.edges > 0 ? fixedModel.totalLatenessMicros / 1000.0f / fixedModel.edges : 0;
+    float scheduledAverage = scheduledModel.edges > 0 ?
+        scheduledModel.totalLatenessMicros / 1000.0f / scheduledModel.edges : 0;
+    LOG_TAG_INFO("SchedulerTest", "固定10ms循环: 唤醒%lu次, 相位切换%lu次 (平均延迟%.2fms, 最大%.2fms), 状态推送%lu次, 处理占用%.2f%%",
+                 fixedWakeups, fixedModel.edges, fixedAverage, fixedModel.maxLatenessMicros / 1000.0f, fixedStatus,
+                 fixedWakeups * LOOP_BODY_MICROS * 100.0f / durationMicros);
+    LOG_TAG_INFO("SchedulerTest", "截止时间调度: 唤醒%lu次, 相位切换%lu次 (平均延迟%.2fms, 最大%.2fms), 状态推送%lu次, 处理占用%.2f%%",
+                 scheduledWakeups, scheduledModel.edges, scheduledAverage, scheduledModel.maxLatenessMicros / 1000.0f,
+                 scheduledStatus, scheduledWakeups * LOOP_BODY_MICROS * 100.0f / durationMicros);
+
+    return scheduledWakeups * 10 < fixedWakeups && scheduledModel.edges >= fixedModel.edges &&
+           scheduledModel.maxLatenessMicros <= fixedModel.maxLatenessMicros;
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,64 @@
+#ifndef DEADLINE_SCHEDULER_TEST_H
+#define DEADLINE_SCHEDULER_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * 截止时间调度器和主循环唤醒信号测试（使用虚拟时钟，仅在native环境运行）
+ */
+class DeadlineSchedulerTest {
+public:
+    /**
+     * 运行所有调度器测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试到期任务按截止时间顺序执行，并返回距最早截止时间的间隔
+     * @return 测试是否通过
+     */
+    static bool testDeadlineOrder();
+
+    /**
+     * 测试无截止时间的任务只在唤醒后执行，且每次runDue()最多执行一次
+     * @return 测试是否通过
+     */
+    static bool testWakeAndSinglePass();
+
+    /**
+     * 测试执行耗时、延迟和超期统计
+     * @return 测试是否通过
+     */
+    static bool testOverrunStatistics();
+
+    /**
+     * 测试32位微秒时钟回绕时的截止时间比较
+     * @return 测试是否通过
+     */
+    static bool testClockWrap();
+
+    /**
+     * 测试任务在执行期间删除自己和添加新任务
+     * @return 测试是否通过
+     */
+    static bool testModifyDuringRun();
+
+    /**
+     * 测试WakeSignal的超时和定时器中断提前唤醒
+     * @return 测试是否通过
+     */
+    static bool testWakeSignal();
+
+    /**
+     * 模拟电机运行/停止循环，对比固定10ms主循环与截止时间调度的唤醒次数和相位切换延迟
+     * @return 调度器是否减少了唤醒次数且没有增加切换延迟
+     */
+    static bool runLoopComparison();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // DEADLINE_SCHEDULER_TEST_H
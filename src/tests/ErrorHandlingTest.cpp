@@ -171,24 +171,24 @@ void ErrorHandlingTest::testRunDurationValidation() {
         
         // 测试过小值修正
         MotorConfig testConfig;
-        testConfig.runDuration = 0; // 小于最小值1秒
-        testConfig.stopDuration = 10;
+        testConfig.runDurationMs = 0; // 小于最小值10毫秒
+        testConfig.stopDurationMs = 10000;
         testConfig.cycleCount = 1;
         
         // 测试自动修正功能
         bool wasModified = !configManager.validateAndSanitizeConfig(testConfig);
-        if (wasModified && testConfig.runDuration == 1) {
-            LOG_TAG_INFO("ErrorHandlingTest", "✓ 运行时长过小值自动修正为1秒");
+        if (wasModified && testConfig.runDurationMs == MOTOR_MIN_RUN_DURATION_MS) {
+            LOG_TAG_INFO("ErrorHandlingTest", "✓ 运行时长过小值自动修正为10毫秒");
         } else {
             LOG_TAG_ERROR("ErrorHandlingTest", "✗ 运行时长过小值修正失败");
             testPassed = false;
         }
         
         // 测试过大值修正
-        testConfig.runDuration = 1000; // 大于最大值999秒
+        testConfig.runDurationMs = MOTOR_MAX_DURATION_MS + 1; // 大于最大值7天
         wasModified = !configManager.validateAndSanitizeConfig(testConfig);
-        if (wasModified && testConfig.runDuration == 999) {
-            LOG_TAG_INFO("ErrorHandlingTest", "✓ 运行时长过大值自动修正为999秒");
+        if (wasModified && testConfig.runDurationMs == MOTOR_MAX_DURATION_MS) {
+            LOG_TAG_INFO("ErrorHandlingTest", "✓ 运行时长过大值自动修正为7天");
         } else {
             LOG_TAG_ERROR("ErrorHandlingTest", "✗ 运行时长过大值修正失败");
             testPassed = false;
@@ -215,26 +215,26 @@ void ErrorHandlingTest::testStopDurationValidation() {
         ConfigManager& configManager = ConfigManager::getInstance();
         bool testPassed = true;
         
-        // 测试负值修正 - 由于stopDuration是uint32_t，负值会变成很大的正数
+        // 测试负值修正 - 由于stopDurationMs是uint32_t，负值会变成很大的正数
         {
             MotorConfig negativeTestConfig;
-            negativeTestConfig.runDuration = 10;
-            negativeTestConfig.stopDuration = (uint32_t)(-100); // 负值转换为uint32_t会变成很大的正数
+            negativeTestConfig.runDurationMs = 10000;
+            negativeTestConfig.stopDurationMs = (uint32_t)(-100); // 负值转换为uint32_t会变成很大的正数
             negativeTestConfig.cycleCount = 1;
             negativeTestConfig.autoStart = false;
             
-            LOG_TAG_DEBUG("ErrorHandlingTest", "测试前负值配置: 停止时长=%lu", negativeTestConfig.stopDuration);
+            LOG_TAG_DEBUG("ErrorHandlingTest", "测试前负值配置: 停止时长=%lu", negativeTestConfig.stopDurationMs);
             
             bool wasModified = !configManager.validateAndSanitizeConfig(negativeTestConfig);
             
             LOG_TAG_DEBUG("ErrorHandlingTest", "测试后负值配置: 停止时长=%lu, 是否修正=%s",
-                         negativeTestConfig.stopDuration, wasModified ? "是" : "否");
+                         negativeTestConfig.stopDurationMs, wasModified ? "是" : "否");
             
-            // 由于负值转换为uint32_t会变成很大的正数，应该被修正为最大值999秒
-            if (wasModified && negativeTestConfig.stopDuration == 999) {
-                LOG_TAG_INFO("ErrorHandlingTest", "✓ 停止时长负值(转换为大正数)自动修正为999秒");
+            // 由于负值转换为uint32_t会变成很大的正数，应该被修正为最大值7天
+            if (wasModified && negativeTestConfig.stopDurationMs == MOTOR_MAX_DURATION_MS) {
+                LOG_TAG_INFO("ErrorHandlingTest", "✓ 停止时长负值(转换为大正数)自动修正为7天");
             } else {
-                LOG_TAG_ERROR("ErrorHandlingTest", "✗ 停止时长负值修正失败，期望999秒，实际: %lu", negativeTestConfig.stopDuration);
+                LOG_TAG_ERROR("ErrorHandlingTest", "✗ 停止时长负值修正失败，期望7天，实际: %lu ms", negativeTestConfig.stopDurationMs);
                 testPassed = false;
             }
         }
@@ -242,14 +242,14 @@ void ErrorHandlingTest::testStopDurationValidation() {
         // 测试过大值修正 - 创建新的测试配置
         {
             MotorConfig largeTestConfig;
-            largeTestConfig.runDuration = 10;
-            largeTestConfig.stopDuration = 1000; // 大于最大值999秒
+            largeTestConfig.runDurationMs = 10000;
+            largeTestConfig.stopDurationMs = MOTOR_MAX_DURATION_MS + 1; // 大于最大值7天
             largeTestConfig.cycleCount = 1;
             largeTestConfig.autoStart = false;
             
             bool wasModified = !configManager.validateAndSanitizeConfig(largeTestConfig);
-            if (wasModified && largeTestConfig.stopDuration == 999) {
-                LOG_TAG_INFO("ErrorHandlingTest", "✓ 停止时长过大值自动修正为999秒");
+            if (wasModified && largeTestConfig.stopDurationMs == MOTOR_MAX_DURATION_MS) {
+                LOG_TAG_INFO("ErrorHandlingTest", "✓ 停止时长过大值自动修正为7天");
             } else {
                 LOG_TAG_ERROR("ErrorHandlingTest", "✗ 停止时长过大值修正失败");
                 testPassed = false;
@@ -279,8 +279,8 @@ void ErrorHandlingTest::testCycleCountValidation() {
         
         // 测试过大值修正
         MotorConfig testConfig;
-        testConfig.runDuration = 10;
-        testConfig.stopDuration = 10;
+        testConfig.runDurationMs = 10000;
+        testConfig.stopDurationMs = 10000;
         testConfig.cycleCount = 2000000; // 大于最大值1000000
         testConfig.autoStart = false;
         
@@ -315,15 +315,15 @@ void ErrorHandlingTest::testParameterAutoCorrection() {
         
         // 测试不合理参数组合的自动修正
         MotorConfig testConfig;
-        testConfig.runDuration = 1; // 最小值
-        testConfig.stopDuration = 70; // 过长
+        testConfig.runDurationMs = 1000; // 最小值
+        testConfig.stopDurationMs = 70000; // 过长
         testConfig.cycleCount = 1;
         testConfig.autoStart = false;
         
         bool wasModified = !configManager.validateAndSanitizeConfig(testConfig);
         if (wasModified) {
-            LOG_TAG_INFO("ErrorHandlingTest", "✓ 不合理参数组合自动修正: 运行=%lu秒, 停止=%lu秒",
-                         testConfig.runDuration, testConfig.stopDuration);
+            LOG_TAG_INFO("ErrorHandlingTest", "✓ 不合理参数组合自动修正: 运行=%lu ms, 停止=%lu ms",
+                         testConfig.runDurationMs, testConfig.stopDurationMs);
         } else {
             LOG_TAG_ERROR("ErrorHandlingTest", "✗ 不合理参数组合修正失败");
             testPassed = false;
@@ -389,7 +389,7 @@ void ErrorHandlingTest::testSystemStabilityAfterDisconnection() {
         
         // 检查配置管理器状态
         const MotorConfig& config = configManager.getConfig();
-        if (config.runDuration > 0) {
+        if (config.runDurationMs > 0) {
             LOG_TAG_INFO("ErrorHandlingTest", "✓ 配置管理器状态正常");
         } else {
             LOG_TAG_ERROR("ErrorHandlingTest", "✗ 配置管理器状态异常");
@@ -0,0 +1,179 @@
+#include "EventDataTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include "AllocationCounter.h"
+#include "../common/EventManager.h"
+#include "../common/Logger.h"
+
+bool EventDataTest::runAllTests() {
+    LOG_TAG_INFO("EventDataTest", "开始EventData测试...");
+
+    bool allPassed = true;
+
+    if (!testMessageFormatting()) {
+        LOG_TAG_ERROR("EventDataTest", "❌ 消息格式化测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("EventDataTest", "✅ 消息格式化测试通过");
+    }
+
+    if (!testSourceInterning()) {
+        LOG_TAG_ERROR("EventDataTest", "❌ 来源驻留测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("EventDataTest", "✅ 来源驻留测试通过");
+    }
+
+    if (!testNoHeapAllocation()) {
+        LOG_TAG_ERROR("EventDataTest", "❌ 堆分配测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("EventDataTest", "✅ 堆分配测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("EventDataTest", "🎉 所有EventData测试通过!");
+    } else {
+        LOG_TAG_ERROR("EventDataTest", "💥 部分EventData测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool EventDataTest::testMessageFormatting() {
+    char buffer[EVENT_MESSAGE_MAX_LENGTH];
+
+    EventData stop(EventType::MOTOR_STOP, EventSource::MOTOR_CONTROLLER, "电机停止，循环次数: %ld");
+    stop.withInts(42);
+    stop.formatMessage(buffer, sizeof(buffer));
+    if (strcmp(buffer, "电机停止，循环次数: 42") != 0 || !stop.hasMessage()) {
+        LOG_TAG_ERROR("EventDataTest", "整数消息错误: %s", buffer);
+        return false;
+    }
+
+    EventData speed(EventType::MOTOR_SPEED_CHANGED, EventSource::MOTOR_CONTROLLER, "%.1fHz %.0f%%");
+    speed.withFloats(12.5f, 80.0f);
+    if (speed.getMessage() != "12.5Hz 80%") {
+        LOG_TAG_ERROR("EventDataTest", "浮点消息错误: %s", speed.getMessage().c_str());
+        return false;
+    }
+
+    EventData text(EventType::CUSTOM_EVENT, EventSource::UNKNOWN, "按键: %s");
+    text.withText("LONG_PRESS");
+    if (text.getMessage() != "按键: LONG_PRESS") {
+        LOG_TAG_ERROR("EventDataTest", "文本消息错误");
+        return false;
+    }
+
+    // 无格式无负载时没有消息
+    EventData empty(EventType::MOTOR_START);
+    if (empty.hasMessage() || empty.formatMessage(buffer, sizeof(buffer)) != 0 || buffer[0] != '\0') {
+        LOG_TAG_ERROR("EventDataTest", "空消息错误");
+        return false;
+    }
+
+    // 输出缓冲区不足时截断
+    size_t length = stop.formatMessage(buffer, 8);
+    if (length != 7 || strlen(buffer) != 7) {
+        LOG_TAG_ERROR("EventDataTest", "截断长度错误: %u", static_cast<unsigned>(length));
+        return false;
+    }
+
+    // 兼容接口：消息复制到内联文本，超长时在UTF-8字符边界截断
+    EventData legacy(EventType::CUSTOM_EVENT, "LegacySource", "电机启动完成", 7);
+    String message = legacy.getMessage();
+    if (message != "电机启动完" || legacy.value != 7 || strcmp(legacy.getSourceName(), "LegacySource") != 0) {
+        LOG_TAG_ERROR("EventDataTest", "兼容接口错误: %s", message.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool EventDataTest::testSourceInterning() {
+    EventManager& manager = EventManager::getInstance();
+
+    if (manager.internSource("MotorController") != EventSource::MOTOR_CONTROLLER ||
+        manager.internSource("") != EventSource::UNKNOWN ||
+        strcmp(manager.getSourceName(EventSource::BLE_SERVER), "MotorBLEServer") != 0) {
+        LOG_TAG_ERROR("EventDataTest", "内置来源匹配错误");
+        return false;
+    }
+
+    EventSource first = manager.internSource("SensorTask");
+    if (first < EventSource::FIRST_DYNAMIC || strcmp(manager.getSourceName(first), "SensorTask") != 0) {
+        LOG_TAG_ERROR("EventDataTest", "动态来源分配错误");
+        return false;
+    }
+    for (int i = 0; i < 100; i++) {
+        if (manager.internSource("SensorTask") != first) {
+            LOG_TAG_ERROR("EventDataTest", "同名来源得到不同ID");
+            return false;
+        }
+    }
+
+    // 超长名称截断后仍然稳定映射到同一ID
+    const char* longName = "AVeryLongEventSourceNameThatDoesNotFit";
+    EventSource longSource = manager.internSource(longName);
+    if (longSource == EventSource::UNKNOWN || manager.internSource(longName) != longSource ||
+        strlen(manager.getSourceName(longSource)) >= 24) {
+        LOG_TAG_ERROR("EventDataTest", "超长来源名处理错误");
+        return false;
+    }
+
+    return true;
+}
+
+bool EventDataTest::testNoHeapAllocation() {
+    const int eventCount = 1000;
+    EventManager& manager = EventManager::getInstance();
+    manager.initialize();
+    manager.clearQueue();
+    manager.unsubscribeAll(EventType::MOTOR_STOP);
+
+    int64_t sum = 0;
+    manager.subscribe(EventType::MOTOR_STOP, [&sum](const EventData& event) {
+        sum += event.payload.ints[0];
+    });
+
+    // 预热：首次使用时的分配（如日志、std::function）不计入
+    manager.publish(EventData(EventType::MOTOR_STOP, EventSource::MOTOR_CONTROLLER, "%ld").withInts(0));
+
+    AllocationCounter::begin();
+    for (int i = 0; i < eventCount; i++) {
+        manager.publish(EventData(EventType::MOTOR_STOP, EventSource::MOTOR_CONTROLLER,
+                                  "电机停止，循环次数: %ld").withInts(i));
+        manager.publishAsync(EventData(EventType::MOTOR_STOP, EventSource::MOTOR_CONTROLLER,
+                                       "电机停止，循环次数: %ld").withInts(i));
+        if (i % 16 == 15) {
+            manager.processEvents();
+        }
+    }
+    manager.processEvents();
+    uint32_t allocations = AllocationCounter::end();
+
+    // 对比：原先每个事件拼接消息字符串
+    size_t totalLength = 0;
+    AllocationCounter::begin();
+    for (int i = 0; i < eventCount; i++) {
+        String message = "电机停止，循环次数: " + String(i);
+        totalLength += message.length();
+    }
+    uint32_t stringAllocations = AllocationCounter::end();
+
+    manager.unsubscribeAll(EventType::MOTOR_STOP);
+
+    LOG_TAG_INFO("EventDataTest", "发布%d个同步和%d个异步事件: 堆分配%lu次 (String拼接消息: %lu次), sizeof(EventData)=%u",
+                 eventCount, eventCount, allocations, stringAllocations, static_cast<unsigned>(sizeof(EventData)));
+
+    // 同步和异步各收到一次0 ~ eventCount-1
+    if (allocations != 0 || totalLength == 0 || sum != static_cast<int64_t>(eventCount) * (eventCount - 1)) {
+        LOG_TAG_ERROR("EventDataTest", "发布过程中发生堆分配或事件丢失: %lu", allocations);
+        return false;
+    }
+
+    return true;
+}
+
+#endif // NATIVE_BUILD
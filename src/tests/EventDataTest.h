@@ -0,0 +1,40 @@
+#ifndef EVENT_DATA_TEST_H
+#define EVENT_DATA_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * 定长EventData测试：延迟格式化、来源驻留和发布路径的堆分配（仅在native环境运行）
+ */
+class EventDataTest {
+public:
+    /**
+     * 运行所有EventData测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试各种负载的消息格式化和截断
+     * @return 测试是否通过
+     */
+    static bool testMessageFormatting();
+
+    /**
+     * 测试来源名驻留：内置来源按名称匹配，同名返回同一ID
+     * @return 测试是否通过
+     */
+    static bool testSourceInterning();
+
+    /**
+     * 测试同步和异步发布过程中没有堆分配
+     * @return 测试是否通过
+     */
+    static bool testNoHeapAllocation();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // EVENT_DATA_TEST_H
@@ -0,0 +1,296 @@
+#include "EventDispatchTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <chrono>
+#include <map>
+#include <vector>
+#include "AllocationCounter.h"
+#include "../common/EventManager.h"
+#include "../common/Logger.h"
+
+namespace {
+
+// 测试使用的事件类型，开始和结束时清空其监听器
+const EventType TEST_TYPE = EventType::WARNING_TRIGGERED;
+const EventType OTHER_TYPE = EventType::BUTTON_PRESSED;
+
+/**
+ * 原EventManager的分发实现：std::map查找 + std::vector<std::function>
+ */
+class MapDispatcher {
+public:
+    void subscribe(EventType type, EventListener listener) {
+        listeners[type].push_back(listener);
+    }
+
+    bool publish(const EventData& event) {
+        auto it = listeners.find(event.type);
+        if (it == listeners.end()) {
+            return false;
+        }
+        for (const auto& listener : it->second) {
+            if (listener != nullptr) {
+                listener(event);
+            }
+        }
+        return true;
+    }
+
+private:
+    std::map<EventType, std::vector<EventListener>> listeners;
+};
+
+/**
+ * 测量每次发布的平均耗时
+ * @return 纳秒/次
+ */
+template <typename Publish>
+double measurePublish(Publish publish, uint32_t iterations) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        publish(i);
+    }
+    double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return nanoseconds / iterations;
+}
+
+} // namespace
+
+bool EventDispatchTest::runAllTests() {
+    LOG_TAG_INFO("DispatchTest", "开始事件分发测试...");
+
+    EventManager& manager = EventManager::getInstance();
+    manager.initialize();
+    manager.unsubscribeAll(TEST_TYPE);
+    manager.unsubscribeAll(OTHER_TYPE);
+
+    bool allPassed = true;
+
+    if (!testSubscriptionHandles()) {
+        LOG_TAG_ERROR("DispatchTest", "❌ 订阅句柄测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("DispatchTest", "✅ 订阅句柄测试通过");
+    }
+    manager.unsubscribeAll(TEST_TYPE);
+
+    if (!testReentrantChanges()) {
+        LOG_TAG_ERROR("DispatchTest", "❌ 分发中修改订阅测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("DispatchTest", "✅ 分发中修改订阅测试通过");
+    }
+    manager.unsubscribeAll(TEST_TYPE);
+
+    if (!testCapacityAndStorage()) {
+        LOG_TAG_ERROR("DispatchTest", "❌ 容量与存储测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("DispatchTest", "✅ 容量与存储测试通过");
+    }
+    manager.unsubscribeAll(TEST_TYPE);
+    manager.unsubscribeAll(OTHER_TYPE);
+
+    if (allPassed) {
+        LOG_TAG_INFO("DispatchTest", "🎉 所有事件分发测试通过!");
+    } else {
+        LOG_TAG_ERROR("DispatchTest", "💥 部分事件分发测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool EventDispatchTest::testSubscriptionHandles() {
+    EventManager& manager = EventManager::getInstance();
+    int calls[3] = {0, 0, 0};
+
+    EventSubscription a = manager.subscribe(TEST_TYPE, [&calls](const EventData&) { calls[0]++; });
+    EventSubscription b = manager.subscribe(TEST_TYPE, [&calls](const EventData&) { calls[1]++; });
+    EventSubscription c = manager.subscribe(TEST_TYPE, [&calls](const EventData&) { calls[2]++; });
+    if (a == INVALID_EVENT_SUBSCRIPTION || b == INVALID_EVENT_SUBSCRIPTION || c == INVALID_EVENT_SUBSCRIPTION ||
+        a == b || manager.getListenerCount(TEST_TYPE) != 3) {
+        LOG_TAG_ERROR("DispatchTest", "订阅失败");
+        return false;
+    }
+
+    // 只移除中间的监听器，其余保持订阅顺序
+    if (!manager.unsubscribe(b) || manager.getListenerCount(TEST_TYPE) != 2) {
+        LOG_TAG_ERROR("DispatchTest", "按句柄取消订阅失败");
+        return false;
+    }
+    manager.publish(EventData(TEST_TYPE));
+    if (calls[0] != 1 || calls[1] != 0 || calls[2] != 1) {
+        LOG_TAG_ERROR("DispatchTest", "取消订阅影响了其他监听器");
+        return false;
+    }
+
+    // 重复取消和复用槽位后的旧句柄都无效
+    if (manager.unsubscribe(b)) {
+        LOG_TAG_ERROR("DispatchTest", "重复取消订阅应失败");
+        return false;
+    }
+    EventSubscription d = manager.subscribe(TEST_TYPE, [&calls](const EventData&) { calls[1]++; });
+    if ((d & 0xFF) != (b & 0xFF) || d == b || manager.unsubscribe(b) || manager.getListenerCount(TEST_TYPE) != 3) {
+        LOG_TAG_ERROR("DispatchTest", "复用槽位后旧句柄仍然有效");
+        return false;
+    }
+    if (manager.unsubscribe(INVALID_EVENT_SUBSCRIPTION) || manager.unsubscribe(0xFFFFFFFF)) {
+        LOG_TAG_ERROR("DispatchTest", "无效句柄应被拒绝");
+        return false;
+    }
+
+    // 其他类型不受影响
+    if (manager.publish(EventData(OTHER_TYPE)) || !manager.unsubscribeAll(TEST_TYPE) ||
+        manager.getListenerCount(TEST_TYPE) != 0 || manager.publish(EventData(TEST_TYPE))) {
+        LOG_TAG_ERROR("DispatchTest", "按类型取消订阅错误");
+        return false;
+    }
+
+    return true;
+}
+
+bool EventDispatchTest::testReentrantChanges() {
+    EventManager& manager = EventManager::getInstance();
+    int selfCalls = 0;
+    int victimCalls = 0;
+    int lateCalls = 0;
+    EventSubscription self = INVALID_EVENT_SUBSCRIPTION;
+    EventSubscription victim = INVALID_EVENT_SUBSCRIPTION;
+    bool subscribed = false;
+
+    // 第一个监听器取消自己和后面的监听器，并新增一个监听器
+    self = manager.subscribe(TEST_TYPE, [&](const EventData&) {
+        selfCalls++;
+        manager.unsubscribe(self);
+        manager.unsubscribe(victim);
+        if (!subscribed) {
+            subscribed = true;
+            manager.subscribe(TEST_TYPE, [&lateCalls](const EventData&) { lateCalls++; });
+        }
+    });
+    victim = manager.subscribe(TEST_TYPE, [&victimCalls](const EventData&) { victimCalls++; });
+
+    manager.publish(EventData(TEST_TYPE));
+    if (selfCalls != 1 || victimCalls != 0 || lateCalls != 0 || manager.getListenerCount(TEST_TYPE) != 1) {
+        LOG_TAG_ERROR("DispatchTest", "分发中修改订阅错误: self=%d victim=%d late=%d", selfCalls, victimCalls, lateCalls);
+        return false;
+    }
+
+    manager.publish(EventData(TEST_TYPE));
+    if (selfCalls != 1 || lateCalls != 1) {
+        LOG_TAG_ERROR("DispatchTest", "分发后订阅状态错误");
+        return false;
+    }
+
+    // 嵌套发布
+    int nested = 0;
+    manager.subscribe(OTHER_TYPE, [&](const EventData&) {
+        nested++;
+        manager.unsubscribeAll(OTHER_TYPE);
+        manager.publish(EventData(TEST_TYPE));
+    });
+    manager.publish(EventData(OTHER_TYPE));
+    manager.publish(EventData(OTHER_TYPE));
+    if (nested != 1 || lateCalls != 2) {
+        LOG_TAG_ERROR("DispatchTest", "嵌套发布错误");
+        return false;
+    }
+
+    return true;
+}
+
+bool EventDispatchTest::testCapacityAndStorage() {
+    EventManager& manager = EventManager::getInstance();
+    int calls = 0;
+    int* counter = &calls;
+
+    // 每个类型的上限
+    uint8_t existing = manager.getListenerCount(TEST_TYPE);
+    uint8_t accepted = existing;
+    AllocationCounter::begin();
+    for (int i = 0; i < EVENT_MAX_LISTENERS_PER_TYPE + 4; i++) {
+        if (manager.subscribe(TEST_TYPE, [counter](const EventData&) { (*counter)++; }) != INVALID_EVENT_SUBSCRIPTION) {
+            accepted++;
+        }
+    }
+    manager.publish(EventData(TEST_TYPE));
+    uint32_t allocations = AllocationCounter::end();
+    if (accepted != EVENT_MAX_LISTENERS_PER_TYPE || calls != EVENT_MAX_LISTENERS_PER_TYPE - existing) {
+        LOG_TAG_ERROR("DispatchTest", "监听器上限错误: %u", accepted);
+        return false;
+    }
+    if (allocations != 0) {
+        LOG_TAG_ERROR("DispatchTest", "小捕获监听器的订阅和分发发生了%lu次堆分配", allocations);
+        return false;
+    }
+    manager.unsubscribeAll(TEST_TYPE);
+
+    // 函数指针、std::function和大捕获lambda
+    static int functionCalls = 0;
+    struct Local {
+        static void listener(const EventData&) { functionCalls++; }
+    };
+    void (*nullFunction)(const EventData&) = nullptr;
+    char large[64] = "large capture";
+    int largeCalls = 0;
+    if (manager.subscribe(TEST_TYPE, nullFunction) != INVALID_EVENT_SUBSCRIPTION ||
+        manager.subscribe(TEST_TYPE, EventListener()) != INVALID_EVENT_SUBSCRIPTION ||
+        manager.subscribe(TEST_TYPE, Local::listener) == INVALID_EVENT_SUBSCRIPTION ||
+        manager.subscribe(TEST_TYPE, EventListener([&calls](const EventData&) { calls++; })) == INVALID_EVENT_SUBSCRIPTION ||
+        manager.subscribe(TEST_TYPE, [large, &largeCalls](const EventData&) {
+            if (large[0] == 'l') {
+                largeCalls++;
+            }
+        }) == INVALID_EVENT_SUBSCRIPTION) {
+        LOG_TAG_ERROR("DispatchTest", "监听器类型处理错误");
+        return false;
+    }
+    calls = 0;
+    manager.publish(EventData(TEST_TYPE));
+    if (functionCalls != 1 || calls != 1 || largeCalls != 1) {
+        LOG_TAG_ERROR("DispatchTest", "各类监听器调用错误");
+        return false;
+    }
+
+    return true;
+}
+
+bool EventDispatchTest::runBenchmark() {
+    const uint32_t iterations = 200000;
+    LOG_TAG_INFO("DispatchTest", "开始事件发布延迟测试（每组%lu次发布）...", iterations);
+
+    EventManager& manager = EventManager::getInstance();
+    manager.initialize();
+    manager.unsubscribeAll(TEST_TYPE);
+
+    const uint8_t listenerCounts[] = {1, 4, 16};
+    volatile uint32_t sink = 0;
+    for (size_t n = 0; n < sizeof(listenerCounts) / sizeof(listenerCounts[0]); n++) {
+        uint8_t count = listenerCounts[n];
+
+        // 两种实现都订阅全部事件类型，使map有真实的查找深度
+        MapDispatcher legacy;
+        for (uint8_t type = 0; type <= static_cast<uint8_t>(EventType::CUSTOM_EVENT); type++) {
+            legacy.subscribe(static_cast<EventType>(type), [&sink](const EventData& event) { sink += event.value; });
+        }
+        for (uint8_t i = 1; i < count; i++) {
+            legacy.subscribe(TEST_TYPE, [&sink](const EventData& event) { sink += event.value; });
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            manager.subscribe(TEST_TYPE, [&sink](const EventData& event) { sink += event.value; });
+        }
+
+        EventData event(TEST_TYPE, EventSource::UNKNOWN, nullptr, 1);
+        double legacyNs = measurePublish([&legacy, &event](uint32_t) { legacy.publish(event); }, iterations);
+        double tableNs = measurePublish([&manager, &event](uint32_t) { manager.publish(event); }, iterations);
+        manager.unsubscribeAll(TEST_TYPE);
+
+        LOG_TAG_INFO("DispatchTest", "%u个监听器: 分发表 %.1f ns/次, std::map + std::function %.1f ns/次 (%.2fx)",
+                     count, tableNs, legacyNs, tableNs > 0 ? legacyNs / tableNs : 0);
+    }
+
+    return sink > 0;
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,46 @@
+#ifndef EVENT_DISPATCH_TEST_H
+#define EVENT_DISPATCH_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * 事件分发表和订阅句柄测试（仅在native环境运行）
+ */
+class EventDispatchTest {
+public:
+    /**
+     * 运行所有分发测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试按句柄精确取消订阅，以及旧句柄失效
+     * @return 测试是否通过
+     */
+    static bool testSubscriptionHandles();
+
+    /**
+     * 测试分发过程中取消订阅（自己或其他监听器）和新增订阅
+     * @return 测试是否通过
+     */
+    static bool testReentrantChanges();
+
+    /**
+     * 测试监听器数量上限和小捕获监听器不分配堆内存
+     * @return 测试是否通过
+     */
+    static bool testCapacityAndStorage();
+
+    /**
+     * 发布延迟：1、4、16个监听器时与原std::map + std::vector<std::function>实现对比
+     * @return 基准是否完成
+     */
+    static bool runBenchmark();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // EVENT_DISPATCH_TEST_H
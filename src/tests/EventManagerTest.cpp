@@ -5,12 +5,14 @@
 int EventManagerTest::testEventCounter = 0;
 String EventManagerTest::lastTestMessage = "";
 EventType EventManagerTest::lastTestEventType = EventType::CUSTOM_EVENT;
+uint32_t EventManagerTest::failureCount = 0;
 
 /**
  * 运行所有测试
  */
-void EventManagerTest::runAllTests() {
+bool EventManagerTest::runAllTests() {
     Serial.println("=== EventManager 单元测试开始 ===");
+    failureCount = 0;
     
     testSingleton();
     testInitializeAndCleanup();
@@ -24,6 +26,7 @@ void EventManagerTest::runAllTests() {
     testBoundaryConditions();
     
     Serial.println("=== EventManager 单元测试完成 ===");
+    return failureCount == 0;
 }
 
 /**
@@ -241,8 +244,9 @@ void EventManagerTest::testMultipleListeners() {
     manager.initialize();
     manager.clearQueue();
     
-    // 重置计数器
+    // 重置计数器，移除之前的测试留下的监听器
     testEventCounter = 0;
+    manager.unsubscribeAll(EventType::MOTOR_START);
     
     // 订阅多个监听器
     manager.subscribe(EventType::MOTOR_START, testEventListener);
@@ -360,7 +364,7 @@ void EventManagerTest::testBoundaryConditions() {
  */
 void EventManagerTest::testEventListener(const EventData& event) {
     testEventCounter++;
-    lastTestMessage = event.message;
+    lastTestMessage = event.getMessage();
     lastTestEventType = event.type;
 }
 
@@ -377,6 +381,7 @@ void EventManagerTest::testEventListener3(const EventData& event) {
  */
 void EventManagerTest::assertTrue(bool condition, const char* message) {
     if (!condition) {
+        failureCount++;
         Serial.print("❌ 断言失败: ");
         Serial.println(message);
     } else {
@@ -391,6 +396,7 @@ void EventManagerTest::assertFalse(bool condition, const char* message) {
 
 void EventManagerTest::assertEqual(uint32_t expected, uint32_t actual, const char* message) {
     if (expected != actual) {
+        failureCount++;
         Serial.print("❌ 断言失败: ");
         Serial.print(message);
         Serial.print(" (期望: ");
@@ -406,6 +412,7 @@ void EventManagerTest::assertEqual(uint32_t expected, uint32_t actual, const cha
 
 void EventManagerTest::assertEqual(int expected, int actual, const char* message) {
     if (expected != actual) {
+        failureCount++;
         Serial.print("❌ 断言失败: ");
         Serial.print(message);
         Serial.print(" (期望: ");
@@ -421,6 +428,7 @@ void EventManagerTest::assertEqual(int expected, int actual, const char* message
 
 void EventManagerTest::assertEqual(bool expected, bool actual, const char* message) {
     if (expected != actual) {
+        failureCount++;
         Serial.print("❌ 断言失败: ");
         Serial.print(message);
         Serial.print(" (期望: ");
@@ -436,6 +444,7 @@ void EventManagerTest::assertEqual(bool expected, bool actual, const char* messa
 
 void EventManagerTest::assertEqualString(const char* expected, const char* actual, const char* message) {
     if (strcmp(expected, actual) != 0) {
+        failureCount++;
         Serial.print("❌ 断言失败: ");
         Serial.print(message);
         Serial.print(" (期望: \"");
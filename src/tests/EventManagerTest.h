@@ -11,8 +11,9 @@ class EventManagerTest {
 public:
     /**
      * 运行所有测试
+     * @return 所有断言是否通过
      */
-    static void runAllTests();
+    static bool runAllTests();
     
 private:
     /**
@@ -75,6 +76,11 @@ private:
     static void assertEqual(bool expected, bool actual, const char* message);
     static void assertEqualString(const char* expected, const char* actual, const char* message);
     
+    /**
+     * 本次运行失败的断言数
+     */
+    static uint32_t failureCount;
+    
     /**
      * 测试用的全局变量
      */
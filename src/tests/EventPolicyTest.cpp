@@ -0,0 +1,447 @@
+#include "EventPolicyTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../common/EventManager.h"
+#include "../common/WakeSignal.h"
+#include "../common/Logger.h"
+
+namespace {
+
+const EventType POLICY_TEST_TYPES[] = {
+    EventType::MOTOR_SPEED_CHANGED,
+    EventType::LED_STATE_CHANGED,
+    EventType::ERROR_OCCURRED,
+    EventType::MOTOR_STOP,
+    EventType::BUTTON_PRESSED,
+    EventType::CUSTOM_EVENT
+};
+
+/**
+ * 清空队列和测试用类型的监听器，并恢复默认策略
+ */
+void resetManager(EventManager& manager) {
+    manager.initialize();
+    manager.clearQueue();
+    for (size_t i = 0; i < sizeof(POLICY_TEST_TYPES) / sizeof(POLICY_TEST_TYPES[0]); i++) {
+        manager.unsubscribeAll(POLICY_TEST_TYPES[i]);
+    }
+    manager.setEventPolicy(EventType::MOTOR_SPEED_CHANGED, EventCoalescing::KEEP_LATEST, EventPriority::NORMAL);
+    manager.setEventPolicy(EventType::LED_STATE_CHANGED, EventCoalescing::KEEP_LATEST, EventPriority::NORMAL);
+    manager.setEventPolicy(EventType::ERROR_OCCURRED, EventCoalescing::KEEP_ALL, EventPriority::URGENT);
+    manager.setEventPolicy(EventType::MOTOR_STOP, EventCoalescing::KEEP_ALL, EventPriority::URGENT);
+    manager.setEventPolicy(EventType::BUTTON_PRESSED, EventCoalescing::KEEP_ALL, EventPriority::NORMAL);
+    manager.setEventPolicy(EventType::CUSTOM_EVENT, EventCoalescing::KEEP_ALL, EventPriority::NORMAL);
+    manager.resetQueueStatistics();
+}
+
+void IRAM_ATTR publishFromTimerISR() {
+    EventManager& manager = EventManager::getInstance();
+    manager.publishAsync(EventData(EventType::CUSTOM_EVENT, EventSource::MOTOR_CONTROLLER, nullptr, 1));
+    manager.publishAsync(EventData(EventType::MOTOR_SPEED_CHANGED, EventSource::MOTOR_CONTROLLER, nullptr, 2));
+    manager.publishAsync(EventData(EventType::ERROR_OCCURRED, EventSource::MOTOR_CONTROLLER, nullptr, 3));
+}
+
+} // namespace
+
+bool EventPolicyTest::runAllTests() {
+    LOG_TAG_INFO("EventPolicyTest", "开始事件合并与优先级测试...");
+
+    bool allPassed = true;
+
+    if (!testCoalescing()) {
+        LOG_TAG_ERROR("EventPolicyTest", "❌ 事件合并测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("EventPolicyTest", "✅ 事件合并测试通过");
+    }
+
+    if (!testPriorityLanes()) {
+        LOG_TAG_ERROR("EventPolicyTest", "❌ 优先级测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("EventPolicyTest", "✅ 优先级测试通过");
+    }
+
+    if (!testTimeBudget()) {
+        LOG_TAG_ERROR("EventPolicyTest", "❌ 时间预算测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("EventPolicyTest", "✅ 时间预算测试通过");
+    }
+
+    if (!testConcurrentLatest()) {
+        LOG_TAG_ERROR("EventPolicyTest", "❌ 多线程合并测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("EventPolicyTest", "✅ 多线程合并测试通过");
+    }
+
+    if (!testPublishFromISR()) {
+        LOG_TAG_ERROR("EventPolicyTest", "❌ 中断中发布测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("EventPolicyTest", "✅ 中断中发布测试通过");
+    }
+
+    resetManager(EventManager::getInstance());
+
+    if (allPassed) {
+        LOG_TAG_INFO("EventPolicyTest", "🎉 所有事件合并与优先级测试通过!");
+    } else {
+        LOG_TAG_ERROR("EventPolicyTest", "💥 部分事件合并与优先级测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool EventPolicyTest::testCoalescing() {
+    EventManager& manager = EventManager::getInstance();
+    resetManager(manager);
+
+    if (manager.getCoalescing(EventType::MOTOR_SPEED_CHANGED) != EventCoalescing::KEEP_LATEST ||
+        manager.getPriority(EventType::ERROR_OCCURRED) != EventPriority::URGENT ||
+        manager.getCoalescing(EventType::CUSTOM_EVENT) != EventCoalescing::KEEP_ALL) {
+        LOG_TAG_ERROR("EventPolicyTest", "默认策略错误");
+        return false;
+    }
+
+    int speedCalls = 0;
+    int32_t lastSpeed = -1;
+    manager.subscribe(EventType::MOTOR_SPEED_CHANGED, [&](const EventData& event) {
+        speedCalls++;
+        lastSpeed = event.value;
+    });
+    int32_t pressCount = 0;
+    int pressCalls = 0;
+    manager.subscribe(EventType::BUTTON_PRESSED, [&](const EventData& event) {
+        pressCalls++;
+        pressCount += event.value;
+    });
+    manager.setEventPolicy(EventType::BUTTON_PRESSED, EventCoalescing::COUNT_ONLY, EventPriority::NORMAL);
+
+    for (int i = 0; i < 100; i++) {
+        manager.publishAsync(EventData(EventType::MOTOR_SPEED_CHANGED, EventSource::BLE_SERVER, nullptr, i));
+        manager.publishAsync(EventData(EventType::BUTTON_PRESSED));
+    }
+    if (manager.getQueueSize() != 2) {
+        LOG_TAG_ERROR("EventPolicyTest", "合并后应只有2个待处理事件 (实际%u)", manager.getQueueSize());
+        return false;
+    }
+
+    uint32_t processed = manager.processEvents();
+    EventManager::QueueStatistics stats = manager.getQueueStatistics();
+    if (processed != 2 || speedCalls != 1 || lastSpeed != 99 || pressCalls != 1 || pressCount != 100) {
+        LOG_TAG_ERROR("EventPolicyTest", "合并结果错误: speed=%d/%ld press=%d/%ld",
+                      speedCalls, lastSpeed, pressCalls, pressCount);
+        return false;
+    }
+    if (stats.pushed != 200 || stats.popped != 2 || stats.coalesced != 198 || stats.overflows != 0) {
+        LOG_TAG_ERROR("EventPolicyTest", "合并统计错误: pushed=%lu popped=%lu coalesced=%lu",
+                      stats.pushed, stats.popped, stats.coalesced);
+        return false;
+    }
+
+    // 分发后再发布的事件不受之前合并的影响；clearQueue()丢弃合并的事件
+    manager.publishAsync(EventData(EventType::MOTOR_SPEED_CHANGED, EventSource::BLE_SERVER, nullptr, 7));
+    manager.processEvents();
+    manager.publishAsync(EventData(EventType::MOTOR_SPEED_CHANGED, EventSource::BLE_SERVER, nullptr, 8));
+    manager.publishAsync(EventData(EventType::BUTTON_PRESSED));
+    manager.clearQueue();
+    manager.processEvents();
+    stats = manager.getQueueStatistics();
+    if (speedCalls != 2 || lastSpeed != 7 || pressCalls != 1 || manager.getQueueSize() != 0 ||
+        stats.pushed != stats.popped + stats.coalesced) {
+        LOG_TAG_ERROR("EventPolicyTest", "清空合并事件错误");
+        return false;
+    }
+
+    return true;
+}
+
+bool EventPolicyTest::testPriorityLanes() {
+    EventManager& manager = EventManager::getInstance();
+    resetManager(manager);
+
+    std::vector<EventType> order;
+    auto record = [&order](const EventData& event) { order.push_back(event.type); };
+    manager.subscribe(EventType::MOTOR_SPEED_CHANGED, record);
+    manager.subscribe(EventType::LED_STATE_CHANGED, record);
+    manager.subscribe(EventType::CUSTOM_EVENT, record);
+    manager.subscribe(EventType::ERROR_OCCURRED, record);
+    manager.subscribe(EventType::MOTOR_STOP, record);
+
+    // 外观类事件先到，错误和停止后到
+    manager.publishAsync(EventData(EventType::LED_STATE_CHANGED));
+    manager.publishAsync(EventData(EventType::CUSTOM_EVENT));
+    manager.publishAsync(EventData(EventType::MOTOR_SPEED_CHANGED));
+    manager.publishAsync(EventData(EventType::ERROR_OCCURRED));
+    manager.publishAsync(EventData(EventType::CUSTOM_EVENT));
+    manager.publishAsync(EventData(EventType::MOTOR_STOP));
+    manager.processEvents();
+
+    const EventType expected[] = {
+        EventType::ERROR_OCCURRED, EventType::MOTOR_STOP,
+        EventType::CUSTOM_EVENT, EventType::CUSTOM_EVENT,
+        EventType::MOTOR_SPEED_CHANGED, EventType::LED_STATE_CHANGED
+    };
+    if (order.size() != sizeof(expected) / sizeof(expected[0])) {
+        LOG_TAG_ERROR("EventPolicyTest", "分发数量错误: %u", order.size());
+        return false;
+    }
+    for (size_t i = 0; i < order.size(); i++) {
+        if (order[i] != expected[i]) {
+            LOG_TAG_ERROR("EventPolicyTest", "第%u个事件应为%s，实际为%s", i,
+                          EventManager::getEventTypeName(expected[i]).c_str(),
+                          EventManager::getEventTypeName(order[i]).c_str());
+            return false;
+        }
+    }
+
+    // 改为URGENT的合并事件也先分发
+    order.clear();
+    manager.setEventPolicy(EventType::LED_STATE_CHANGED, EventCoalescing::KEEP_LATEST, EventPriority::URGENT);
+    manager.publishAsync(EventData(EventType::CUSTOM_EVENT));
+    manager.publishAsync(EventData(EventType::LED_STATE_CHANGED));
+    manager.processEvents();
+    if (order.size() != 2 || order[0] != EventType::LED_STATE_CHANGED) {
+        LOG_TAG_ERROR("EventPolicyTest", "URGENT合并事件未优先分发");
+        return false;
+    }
+
+    return true;
+}
+
+bool EventPolicyTest::testTimeBudget() {
+    EventManager& manager = EventManager::getInstance();
+    resetManager(manager);
+
+    // 每个监听器耗时500µs（虚拟时钟）
+    const uint32_t listenerMicros = 500;
+    std::vector<EventType> order;
+    auto slowListener = [&order, listenerMicros](const EventData& event) {
+        order.push_back(event.type);
+        NativeHAL::advanceMicros(listenerMicros);
+    };
+    manager.subscribe(EventType::CUSTOM_EVENT, slowListener);
+    manager.subscribe(EventType::MOTOR_STOP, slowListener);
+    manager.subscribe(EventType::MOTOR_SPEED_CHANGED, slowListener);
+
+    for (int i = 0; i < 10; i++) {
+        manager.publishAsync(EventData(EventType::CUSTOM_EVENT));
+    }
+    manager.publishAsync(EventData(EventType::MOTOR_SPEED_CHANGED));
+
+    // 2ms预算：每次处理4个
+    uint32_t processed = manager.processEvents(2000);
+    if (processed != 4 || manager.getQueueSize() != 7) {
+        LOG_TAG_ERROR("EventPolicyTest", "预算内应处理4个事件 (实际%lu，剩余%u)", processed, manager.getQueueSize());
+        return false;
+    }
+
+    // 剩余事件之后到达的紧急事件在下一次最先处理
+    manager.publishAsync(EventData(EventType::MOTOR_STOP));
+    order.clear();
+    processed = manager.processEvents(2000);
+    if (processed != 4 || order[0] != EventType::MOTOR_STOP) {
+        LOG_TAG_ERROR("EventPolicyTest", "紧急事件应在下一次最先处理");
+        return false;
+    }
+
+    // 单个事件超过预算时仍至少处理一个，保证前进
+    processed = manager.processEvents(100);
+    if (processed != 1) {
+        LOG_TAG_ERROR("EventPolicyTest", "预算不足时应至少处理一个事件 (实际%lu)", processed);
+        return false;
+    }
+
+    // 不限预算时处理完剩余事件
+    processed = manager.processEvents(0);
+    EventManager::QueueStatistics stats = manager.getQueueStatistics();
+    if (processed != 3 || manager.getQueueSize() != 0 || order.back() != EventType::MOTOR_SPEED_CHANGED ||
+        stats.budgetStops != 3) {
+        LOG_TAG_ERROR("EventPolicyTest", "剩余事件处理错误 (处理%lu，预算中断%lu次)", processed, stats.budgetStops);
+        return false;
+    }
+
+    return true;
+}
+
+bool EventPolicyTest::testConcurrentLatest() {
+    const uint32_t producers = 3;
+    const uint32_t eventsPerProducer = 20000;
+
+    EventManager& manager = EventManager::getInstance();
+    resetManager(manager);
+
+    // 每个生产者用自己的事件类型，值递增：收到的值必须单调递增且最终为最后一个值
+    const EventType types[producers] = {
+        EventType::MOTOR_SPEED_CHANGED, EventType::LED_STATE_CHANGED, EventType::CUSTOM_EVENT
+    };
+    manager.setEventPolicy(EventType::CUSTOM_EVENT, EventCoalescing::KEEP_LATEST, EventPriority::NORMAL);
+    int32_t lastValue[producers] = {-1, -1, -1};
+    bool ordered = true;
+    for (uint32_t p = 0; p < producers; p++) {
+        manager.subscribe(types[p], [&lastValue, &ordered, p](const EventData& event) {
+            if (event.value <= lastValue[p] || event.payload.ints[0] != event.value) {
+                ordered = false;
+            }
+            lastValue[p] = event.value;
+        });
+    }
+
+    std::atomic<uint32_t> finished(0);
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; p++) {
+        threads.emplace_back([&manager, &finished, &types, p, eventsPerProducer]() {
+            for (uint32_t i = 0; i < eventsPerProducer; i++) {
+                int32_t value = static_cast<int32_t>(i);
+                manager.publishAsync(EventData(types[p], EventSource::UNKNOWN, nullptr, value).withInts(value));
+                if (i % 64 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            finished++;
+        });
+    }
+    while (finished.load() < producers) {
+        manager.processEvents(0);
+        std::this_thread::yield();
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    manager.processEvents(0);
+
+    EventManager::QueueStatistics stats = manager.getQueueStatistics();
+    for (uint32_t p = 0; p < producers; p++) {
+        if (lastValue[p] != static_cast<int32_t>(eventsPerProducer - 1)) {
+            ordered = false;
+        }
+    }
+    if (!ordered || stats.pushed != producers * eventsPerProducer || stats.pushed != stats.popped + stats.coalesced) {
+        LOG_TAG_ERROR("EventPolicyTest", "多线程合并错误: pushed=%lu popped=%lu coalesced=%lu",
+                      stats.pushed, stats.popped, stats.coalesced);
+        return false;
+    }
+    LOG_TAG_INFO("EventPolicyTest", "%lu个生产者共%lu个事件，分发%lu个，合并%lu个",
+                 producers, stats.pushed, stats.popped, stats.coalesced);
+
+    return true;
+}
+
+bool EventPolicyTest::testPublishFromISR() {
+    EventManager& manager = EventManager::getInstance();
+    resetManager(manager);
+    int32_t sum = 0;
+    for (size_t i = 0; i < 3; i++) {
+        EventType type = i == 0 ? EventType::CUSTOM_EVENT
+                                : (i == 1 ? EventType::MOTOR_SPEED_CHANGED : EventType::ERROR_OCCURRED);
+        manager.subscribe(type, [&sum](const EventData& event) {
+            sum += event.value;
+        });
+    }
+
+    // 清掉之前留下的唤醒，之后由定时器中断在2ms时发布并唤醒
+    WakeSignal& signal = WakeSignal::getInstance();
+    signal.wait(0);
+    uint32_t violations = NativeHAL::getISRViolationCount();
+    hw_timer_t* timer = timerBegin(3, 80, true);
+    timerAttachInterrupt(timer, &publishFromTimerISR, true);
+    timerAlarmWrite(timer, 2000, false);
+    timerAlarmEnable(timer);
+
+    uint64_t start = NativeHAL::nowMicros();
+    bool woken = signal.wait(100000);
+    uint64_t waited = NativeHAL::nowMicros() - start;
+    timerEnd(timer);
+    uint32_t processed = manager.processEvents();
+    if (!woken || waited > 3000 || NativeHAL::getISRViolationCount() != violations) {
+        LOG_TAG_ERROR("EventPolicyTest", "中断中发布未正确唤醒: 等待%lu us, 违规调用%lu次",
+                      static_cast<unsigned long>(waited),
+                      static_cast<unsigned long>(NativeHAL::getISRViolationCount() - violations));
+        return false;
+    }
+    if (processed != 3 || sum != 6) {
+        LOG_TAG_ERROR("EventPolicyTest", "中断中发布的事件分发错误: %lu个, 合计%ld",
+                      static_cast<unsigned long>(processed), static_cast<long>(sum));
+        return false;
+    }
+    return true;
+}
+
+bool EventPolicyTest::runBurstComparison() {
+    // 模拟连接期间的BLE突发：每个主循环周期到达一批速度、LED和普通事件，外加偶发的错误
+    const uint32_t loops = 200;
+    const uint32_t speedPerLoop = 48;
+    const uint32_t ledPerLoop = 24;
+    const uint32_t customPerLoop = 4;
+    const uint32_t listenerMicros = 100;
+    LOG_TAG_INFO("EventPolicyTest", "开始突发事件对比（%lu个周期，每周期%lu个事件，监听器耗时%luµs）...",
+                 loops, speedPerLoop + ledPerLoop + customPerLoop, listenerMicros);
+
+    uint32_t overflows[2] = {0, 0};
+    uint32_t worstMicros[2] = {0, 0};
+    for (int mode = 0; mode < 2; mode++) {
+        bool policies = mode == 1;
+        EventManager& manager = EventManager::getInstance();
+        resetManager(manager);
+        if (!policies) {
+            manager.setEventPolicy(EventType::MOTOR_SPEED_CHANGED, EventCoalescing::KEEP_ALL, EventPriority::NORMAL);
+            manager.setEventPolicy(EventType::LED_STATE_CHANGED, EventCoalescing::KEEP_ALL, EventPriority::NORMAL);
+            manager.setEventPolicy(EventType::ERROR_OCCURRED, EventCoalescing::KEEP_ALL, EventPriority::NORMAL);
+        }
+
+        auto listener = [listenerMicros](const EventData&) { NativeHAL::advanceMicros(listenerMicros); };
+        manager.subscribe(EventType::MOTOR_SPEED_CHANGED, listener);
+        manager.subscribe(EventType::LED_STATE_CHANGED, listener);
+        manager.subscribe(EventType::CUSTOM_EVENT, listener);
+        uint32_t errorLatencyTotal = 0;
+        uint32_t errors = 0;
+        uint32_t errorPublishedAt = 0;
+        manager.subscribe(EventType::ERROR_OCCURRED, [&](const EventData&) {
+            errorLatencyTotal += micros() - errorPublishedAt;
+            errors++;
+        });
+
+        for (uint32_t loop = 0; loop < loops; loop++) {
+            for (uint32_t i = 0; i < speedPerLoop; i++) {
+                manager.publishAsync(EventData(EventType::MOTOR_SPEED_CHANGED, EventSource::BLE_SERVER, nullptr, i));
+                if (i < ledPerLoop) {
+                    manager.publishAsync(EventData(EventType::LED_STATE_CHANGED, EventSource::LED_CONTROLLER));
+                }
+                if (i < customPerLoop) {
+                    manager.publishAsync(EventData(EventType::CUSTOM_EVENT));
+                }
+            }
+            if (loop % 20 == 10) {
+                errorPublishedAt = micros();
+                manager.publishAsync(EventData(EventType::ERROR_OCCURRED, EventSource::MOTOR_CONTROLLER));
+            }
+
+            uint32_t start = micros();
+            manager.processEvents(policies ? EVENT_PROCESS_BUDGET_US : 0);
+            uint32_t elapsed = micros() - start;
+            worstMicros[mode] = elapsed > worstMicros[mode] ? elapsed : worstMicros[mode];
+            NativeHAL::advanceMicros(1000);
+        }
+        manager.processEvents(0);
+
+        EventManager::QueueStatistics stats = manager.getQueueStatistics();
+        overflows[mode] = stats.overflows;
+        LOG_TAG_INFO("EventPolicyTest", "%s: 发布%lu个，分发%lu个，合并%lu个，丢弃%lu个，最大深度%lu，"
+                     "单次处理最长%luµs，错误事件收到%lu/%lu个、平均延迟%luµs",
+                     policies ? "合并+优先级+预算" : "全部KEEP_ALL", stats.pushed + stats.overflows, stats.popped,
+                     stats.coalesced, stats.overflows, stats.highWatermark, worstMicros[mode], errors, loops / 20,
+                     errors > 0 ? errorLatencyTotal / errors : 0);
+    }
+    resetManager(EventManager::getInstance());
+
+    return overflows[1] < overflows[0] && worstMicros[1] < worstMicros[0];
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,58 @@
+#ifndef EVENT_POLICY_TEST_H
+#define EVENT_POLICY_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * 异步事件合并策略、优先级和处理时间预算测试（使用虚拟时钟，仅在native环境运行）
+ */
+class EventPolicyTest {
+public:
+    /**
+     * 运行所有策略测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试KEEP_LATEST只分发最新事件、COUNT_ONLY分发累计次数
+     * @return 测试是否通过
+     */
+    static bool testCoalescing();
+
+    /**
+     * 测试URGENT事件先于NORMAL事件分发
+     * @return 测试是否通过
+     */
+    static bool testPriorityLanes();
+
+    /**
+     * 测试processEvents()在时间预算用完后停止，剩余事件留到下次
+     * @return 测试是否通过
+     */
+    static bool testTimeBudget();
+
+    /**
+     * 测试多个线程同时发布KEEP_LATEST事件
+     * @return 测试是否通过
+     */
+    static bool testConcurrentLatest();
+
+    /**
+     * 测试在（模拟的）定时器中断中发布各种策略的事件：唤醒主循环且不调用任务上下文的FreeRTOS接口
+     * @return 测试是否通过
+     */
+    static bool testPublishFromISR();
+
+    /**
+     * 突发BLE流量下对比全部KEEP_ALL与默认策略的队列深度、丢弃数和单次处理耗时
+     * @return 默认策略是否降低了丢弃数和单次处理耗时
+     */
+    static bool runBurstComparison();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // EVENT_POLICY_TEST_H
@@ -0,0 +1,359 @@
+#include "EventQueueTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../common/EventManager.h"
+#include "../common/LockFreeRingBuffer.h"
+#include "../common/Logger.h"
+
+namespace {
+
+// 值的高8位为生产者编号，低24位为该生产者内的序号
+uint32_t encode(uint32_t producer, uint32_t sequence) {
+    return (producer << 24) | (sequence & 0xFFFFFF);
+}
+
+/**
+ * 原EventManager的队列实现：互斥锁保护的vector，每次处理时整体复制
+ */
+class MutexVectorQueue {
+public:
+    bool push(const EventData& event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(event);
+        return true;
+    }
+
+    template <typename Handler>
+    uint32_t drain(Handler handler) {
+        std::vector<EventData> local;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            local = queue;
+            queue.clear();
+        }
+        for (size_t i = 0; i < local.size(); i++) {
+            handler(local[i]);
+        }
+        return local.size();
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<EventData> queue;
+};
+
+/**
+ * 多个生产者各发布eventsPerProducer个事件（满时让出CPU后重试），一个消费者线程处理
+ * @return 每秒处理的事件数
+ */
+template <typename Queue>
+double measureThroughput(Queue& queue, uint32_t producers, uint32_t eventsPerProducer) {
+    const uint32_t total = producers * eventsPerProducer;
+    std::atomic<bool> go(false);
+    uint32_t received = 0;
+
+    std::thread consumer([&]() {
+        while (!go.load()) {
+            std::this_thread::yield();
+        }
+        while (received < total) {
+            uint32_t count = queue.drain([](EventData& event) { (void)event; });
+            received += count;
+            if (count == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, &go, p, eventsPerProducer]() {
+            EventData event(EventType::MOTOR_SPEED_CHANGED, EventSource::MOTOR_CONTROLLER, "speed");
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (uint32_t i = 0; i < eventsPerProducer; i++) {
+                event.value = encode(p, i);
+                while (!queue.push(event)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    consumer.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds > 0 ? total / seconds : 0;
+}
+
+} // namespace
+
+bool EventQueueTest::runAllTests() {
+    LOG_TAG_INFO("EventQueueTest", "开始无锁事件队列测试...");
+
+    bool allPassed = true;
+
+    if (!testBasicOperations()) {
+        LOG_TAG_ERROR("EventQueueTest", "❌ 基本操作测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("EventQueueTest", "✅ 基本操作测试通过");
+    }
+
+    if (!testConcurrentProducers()) {
+        LOG_TAG_ERROR("EventQueueTest", "❌ 多生产者并发测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("EventQueueTest", "✅ 多生产者并发测试通过");
+    }
+
+    if (!testEventManagerFromThreads()) {
+        LOG_TAG_ERROR("EventQueueTest", "❌ 多线程异步发布测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("EventQueueTest", "✅ 多线程异步发布测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("EventQueueTest", "🎉 所有无锁事件队列测试通过!");
+    } else {
+        LOG_TAG_ERROR("EventQueueTest", "💥 部分无锁事件队列测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool EventQueueTest::testBasicOperations() {
+    LockFreeRingBuffer<uint32_t, 8> queue;
+
+    // 写满后再写入失败并计入溢出
+    for (uint32_t i = 0; i < 8; i++) {
+        if (!queue.push(i)) {
+            LOG_TAG_ERROR("EventQueueTest", "第%lu个元素入队失败", i);
+            return false;
+        }
+    }
+    if (queue.push(100) || queue.size() != 8 || queue.getStatistics().overflows != 1 ||
+        queue.getStatistics().highWatermark != 8) {
+        LOG_TAG_ERROR("EventQueueTest", "满队列处理错误");
+        return false;
+    }
+
+    // 原地处理：按先进先出顺序，且受maxItems限制
+    std::vector<uint32_t> seen;
+    uint32_t count = queue.drain([&seen](uint32_t& value) { seen.push_back(value); }, 3);
+    if (count != 3 || seen.size() != 3 || seen[0] != 0 || seen[2] != 2 || queue.size() != 5) {
+        LOG_TAG_ERROR("EventQueueTest", "原地处理错误");
+        return false;
+    }
+
+    uint32_t value = 0;
+    if (!queue.pop(value) || value != 3) {
+        LOG_TAG_ERROR("EventQueueTest", "出队顺序错误");
+        return false;
+    }
+    if (queue.clear() != 4 || !queue.empty() || queue.pop(value)) {
+        LOG_TAG_ERROR("EventQueueTest", "清空错误");
+        return false;
+    }
+
+    // 反复回绕，包括序号越过32位边界以外的多圈
+    for (uint32_t round = 0; round < 1000; round++) {
+        for (uint32_t i = 0; i < 5; i++) {
+            queue.push(round * 5 + i);
+        }
+        for (uint32_t i = 0; i < 5; i++) {
+            if (!queue.pop(value) || value != round * 5 + i) {
+                LOG_TAG_ERROR("EventQueueTest", "回绕后顺序错误 (第%lu轮)", round);
+                return false;
+            }
+        }
+    }
+
+    LockFreeRingBuffer<uint32_t, 8>::Statistics stats = queue.getStatistics();
+    if (stats.pushed != 5008 || stats.popped != 5008 || stats.overflows != 1) {
+        LOG_TAG_ERROR("EventQueueTest", "统计错误: pushed=%lu popped=%lu", stats.pushed, stats.popped);
+        return false;
+    }
+
+    return true;
+}
+
+bool EventQueueTest::testConcurrentProducers() {
+    const uint32_t producers = 4;
+    const uint32_t eventsPerProducer = 200000;
+    const uint32_t total = producers * eventsPerProducer;
+
+    LockFreeRingBuffer<uint32_t, 256> queue;
+    std::atomic<bool> go(false);
+    uint32_t received = 0;
+    uint32_t nextSequence[producers] = {0};
+    bool ordered = true;
+
+    std::thread consumer([&]() {
+        while (!go.load()) {
+            std::this_thread::yield();
+        }
+        while (received < total && ordered) {
+            uint32_t count = queue.drain([&](uint32_t& value) {
+                uint32_t producer = value >> 24;
+                if (producer >= producers || (value & 0xFFFFFF) != nextSequence[producer]) {
+                    ordered = false;
+                    return;
+                }
+                nextSequence[producer]++;
+            });
+            received += count;
+            if (count == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, &go, p, eventsPerProducer]() {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (uint32_t i = 0; i < eventsPerProducer; i++) {
+                while (!queue.push(encode(p, i))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    go.store(true);
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    consumer.join();
+
+    if (!ordered || received != total || !queue.empty()) {
+        LOG_TAG_ERROR("EventQueueTest", "并发结果错误: 收到%lu/%lu, 有序=%d", received, total, ordered);
+        return false;
+    }
+    for (uint32_t p = 0; p < producers; p++) {
+        if (nextSequence[p] != eventsPerProducer) {
+            LOG_TAG_ERROR("EventQueueTest", "生产者%lu丢失事件: %lu", p, nextSequence[p]);
+            return false;
+        }
+    }
+
+    LockFreeRingBuffer<uint32_t, 256>::Statistics stats = queue.getStatistics();
+    if (stats.pushed != total || stats.popped != total || stats.highWatermark > 256) {
+        LOG_TAG_ERROR("EventQueueTest", "并发统计错误");
+        return false;
+    }
+    LOG_TAG_INFO("EventQueueTest", "%lu个生产者共%lu个事件，满队列重试%lu次，最大深度%lu",
+                 producers, total, stats.overflows, stats.highWatermark);
+
+    return true;
+}
+
+bool EventQueueTest::testEventManagerFromThreads() {
+    const uint32_t producers = 3;
+    const uint32_t eventsPerProducer = 5000;
+
+    EventManager& manager = EventManager::getInstance();
+    manager.initialize();
+    manager.clearQueue();
+    manager.resetQueueStatistics();
+    // 其他测试在CUSTOM_EVENT上留下的监听器一并移除
+    manager.unsubscribeAll(EventType::CUSTOM_EVENT);
+
+    EventSource threadSource = manager.internSource("Thread");
+    uint32_t received = 0;
+    uint32_t nextSequence[producers] = {0};
+    bool ordered = true;
+    manager.subscribe(EventType::CUSTOM_EVENT, [&](const EventData& event) {
+        uint32_t producer = static_cast<uint32_t>(event.value) >> 24;
+        uint32_t sequence = event.value & 0xFFFFFF;
+        // 队列满时事件被丢弃，但同一生产者的事件不会乱序
+        if (producer >= producers || sequence < nextSequence[producer] || event.source != threadSource) {
+            ordered = false;
+            return;
+        }
+        nextSequence[producer] = sequence + 1;
+        received++;
+    });
+
+    std::atomic<uint32_t> accepted(0);
+    std::atomic<uint32_t> finished(0);
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; p++) {
+        threads.emplace_back([&manager, &accepted, &finished, threadSource, p, eventsPerProducer]() {
+            for (uint32_t i = 0; i < eventsPerProducer; i++) {
+                if (manager.publishAsync(EventData(EventType::CUSTOM_EVENT, threadSource, "async", encode(p, i)))) {
+                    accepted++;
+                }
+                if (i % 64 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            finished++;
+        });
+    }
+
+    // 主线程作为唯一消费者
+    while (finished.load() < producers || manager.getQueueSize() > 0) {
+        manager.processEvents();
+        std::this_thread::yield();
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    manager.processEvents();
+    manager.unsubscribeAll(EventType::CUSTOM_EVENT);
+
+    EventManager::QueueStatistics stats = manager.getQueueStatistics();
+    const uint32_t total = producers * eventsPerProducer;
+    if (!ordered || received != accepted.load() || stats.pushed != accepted.load() ||
+        stats.pushed + stats.overflows != total || stats.popped != stats.pushed) {
+        LOG_TAG_ERROR("EventQueueTest", "异步发布结果错误: 收到%lu, 入队%lu, 溢出%lu, 有序=%d",
+                      received, accepted.load(), stats.overflows, ordered);
+        return false;
+    }
+    LOG_TAG_INFO("EventQueueTest", "EventManager: 发布%lu个，处理%lu个，溢出%lu个，最大深度%lu",
+                 total, received, stats.overflows, stats.highWatermark);
+
+    return true;
+}
+
+bool EventQueueTest::runBenchmark() {
+    const uint32_t eventsPerProducer = 100000;
+    LOG_TAG_INFO("EventQueueTest", "开始事件队列吞吐量测试（每个生产者%lu个事件，队列容量%u）...",
+                 eventsPerProducer, EVENT_QUEUE_CAPACITY);
+
+    const uint32_t producerCounts[] = {1, 4};
+    for (size_t i = 0; i < sizeof(producerCounts) / sizeof(producerCounts[0]); i++) {
+        uint32_t producers = producerCounts[i];
+
+        EventManager::EventQueue* ringQueue = new EventManager::EventQueue();
+        double ringRate = measureThroughput(*ringQueue, producers, eventsPerProducer);
+        delete ringQueue;
+
+        MutexVectorQueue mutexQueue;
+        double mutexRate = measureThroughput(mutexQueue, producers, eventsPerProducer);
+
+        LOG_TAG_INFO("EventQueueTest", "%lu个生产者: 无锁队列 %.0f 事件/秒, 互斥锁+vector %.0f 事件/秒 (%.1fx)",
+                     producers, ringRate, mutexRate, mutexRate > 0 ? ringRate / mutexRate : 0);
+    }
+
+    return true;
+}
+
+#endif // NATIVE_BUILD
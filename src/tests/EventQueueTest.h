@@ -0,0 +1,46 @@
+#ifndef EVENT_QUEUE_TEST_H
+#define EVENT_QUEUE_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * 无锁事件队列测试（使用std::thread模拟多个发布任务，仅在native环境运行）
+ */
+class EventQueueTest {
+public:
+    /**
+     * 运行所有事件队列测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试先进先出、满队列溢出统计、原地处理和回绕
+     * @return 测试是否通过
+     */
+    static bool testBasicOperations();
+
+    /**
+     * 多个生产者线程与一个消费者线程并发读写，校验不丢失、不重复且每个生产者内有序
+     * @return 测试是否通过
+     */
+    static bool testConcurrentProducers();
+
+    /**
+     * 多个线程通过EventManager::publishAsync发布，主线程processEvents处理
+     * @return 测试是否通过
+     */
+    static bool testEventManagerFromThreads();
+
+    /**
+     * 吞吐量：无锁队列与原互斥锁+vector实现的每秒事件数对比
+     * @return 基准是否完成
+     */
+    static bool runBenchmark();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // EVENT_QUEUE_TEST_H
@@ -0,0 +1,341 @@
+#include "JsonWriterTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <ArduinoJson.h>
+#include <chrono>
+#include "AllocationCounter.h"
+#include "../common/JsonWriter.h"
+#include "../common/StateManager.h"
+#include "../common/Logger.h"
+#include "../controllers/MotorBLEServer.h"
+#include "../controllers/MotorController.h"
+
+namespace {
+
+// 典型运行中的状态（与MotorBLEServer的完整状态JSON字段相同）
+struct StatusSnapshot {
+    int state;
+    uint32_t remainingRunMs;
+    uint32_t remainingStopMs;
+    uint32_t currentCycle;
+    uint32_t runDurationMs;
+    uint32_t stopDurationMs;
+    uint32_t cycleCount;
+    bool autoStart;
+    bool pwmMode;
+    uint16_t pwmOutput;
+    uint64_t uptimeMs;
+    SystemState systemState;
+    uint32_t freeHeap;
+    int32_t temperatureTenths;
+};
+
+const StatusSnapshot SNAPSHOT = {
+    1, 4321, 0, 17, 5000, 2000, 0, true, true, 875, 123456789ull, SystemState::RUNNING, 187432, 325
+};
+
+const char* const STATE_NAMES[] = {"STOPPED", "RUNNING", "STOPPING", "STARTING", "ERROR"};
+
+/**
+ * 原实现：DynamicJsonDocument + serializeJson(String)
+ */
+String legacyStatusJson(const StatusSnapshot& status) {
+    DynamicJsonDocument doc(512);
+    doc["state"] = status.state;
+    doc["stateName"] = STATE_NAMES[status.state];
+    doc["remainingRunTime"] = status.remainingRunMs / 1000;
+    doc["remainingRunTimeMs"] = status.remainingRunMs;
+    doc["remainingStopTime"] = status.remainingStopMs / 1000;
+    doc["remainingStopTimeMs"] = status.remainingStopMs;
+    doc["currentCycleCount"] = status.currentCycle;
+    doc["runDuration"] = status.runDurationMs / 1000;
+    doc["runDurationMs"] = status.runDurationMs;
+    doc["stopDuration"] = status.stopDurationMs / 1000;
+    doc["stopDurationMs"] = status.stopDurationMs;
+    doc["cycleCount"] = status.cycleCount;
+    doc["autoStart"] = status.autoStart;
+    doc["outputMode"] = status.pwmMode ? "pwm" : "switch";
+    doc["pwmOutput"] = status.pwmOutput;
+    doc["uptime"] = status.uptimeMs;
+    doc["systemState"] = StateManager::getStateName(status.systemState);
+    doc["freeHeap"] = status.freeHeap;
+    doc["chipTemperature"] = status.temperatureTenths / 10.0;
+
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
+
+/**
+ * 新实现：JsonWriter直接写入定长缓冲区
+ */
+size_t writerStatusJson(const StatusSnapshot& status, char* buffer, size_t size) {
+    JsonWriter writer(buffer, size);
+    writer.beginObject();
+    writer.addInt("state", status.state);
+    writer.addString("stateName", STATE_NAMES[status.state]);
+    writer.addUInt("remainingRunTime", status.remainingRunMs / 1000);
+    writer.addUInt("remainingRunTimeMs", status.remainingRunMs);
+    writer.addUInt("remainingStopTime", status.remainingStopMs / 1000);
+    writer.addUInt("remainingStopTimeMs", status.remainingStopMs);
+    writer.addUInt("currentCycleCount", status.currentCycle);
+    writer.addUInt("runDuration", status.runDurationMs / 1000);
+    writer.addUInt("runDurationMs", status.runDurationMs);
+    writer.addUInt("stopDuration", status.stopDurationMs / 1000);
+    writer.addUInt("stopDurationMs", status.stopDurationMs);
+    writer.addUInt("cycleCount", status.cycleCount);
+    writer.addBool("autoStart", status.autoStart);
+    writer.addString("outputMode", status.pwmMode ? "pwm" : "switch");
+    writer.addUInt("pwmOutput", status.pwmOutput);
+    writer.addUInt("uptime", status.uptimeMs);
+    writer.addString("systemState", StateManager::getStateNameCStr(status.systemState));
+    writer.addUInt("freeHeap", status.freeHeap);
+    writer.addFixed("chipTemperature", status.temperatureTenths, 1);
+    writer.endObject();
+    return writer.finish();
+}
+
+/**
+ * 测量一种实现的吞吐量和每次的堆分配次数
+ * @param serialize 序列化一次，返回输出字节数
+ */
+template <typename Serialize>
+void measureSerialize(const char* name, Serialize serialize, uint32_t iterations) {
+    serialize();  // 预热
+
+    AllocationCounter::begin();
+    size_t bytes = serialize();
+    uint32_t allocations = AllocationCounter::end();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t totalBytes = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        totalBytes += serialize();
+    }
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (micros <= 0) {
+        micros = 1;
+    }
+
+    LOG_TAG_INFO("JsonWriterTest", "%-31s: %3u字节, %.2f 字节/微秒, %.2f 微秒/次, 每次%lu次堆分配",
+                 name, (unsigned)bytes, totalBytes / micros, micros / iterations, (unsigned long)allocations);
+}
+
+} // namespace
+
+bool JsonWriterTest::runAllTests() {
+    LOG_TAG_INFO("JsonWriterTest", "开始JSON写入器测试...");
+
+    bool allPassed = true;
+
+    if (!testFormatting()) {
+        LOG_TAG_ERROR("JsonWriterTest", "❌ 格式测试失败");
+        allPassed = false;
+    }
+
+    if (!testEscaping()) {
+        LOG_TAG_ERROR("JsonWriterTest", "❌ 转义测试失败");
+        allPassed = false;
+    }
+
+    if (!testOverflow()) {
+        LOG_TAG_ERROR("JsonWriterTest", "❌ 溢出测试失败");
+        allPassed = false;
+    }
+
+    if (!testStatusJson()) {
+        LOG_TAG_ERROR("JsonWriterTest", "❌ 状态JSON测试失败");
+        allPassed = false;
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("JsonWriterTest", "✅ 所有JSON写入器测试通过");
+    }
+    return allPassed;
+}
+
+bool JsonWriterTest::testFormatting() {
+    char buffer[192];
+    JsonWriter writer(buffer, sizeof(buffer));
+    writer.beginObject();
+    writer.addUInt("a", 0);
+    writer.addInt("b", -12);
+    writer.beginObject("nested");
+    writer.addBool("on", true);
+    writer.beginObject("empty");
+    writer.endObject();
+    writer.addBool("off", false);
+    writer.endObject();
+    writer.addFixed("t", 325, 1);
+    writer.addFixed("n", -5, 2);
+    writer.addFixed("z", 7, 0);
+    writer.addInt("min", INT64_MIN);
+    writer.addUInt("max", UINT64_MAX);
+    writer.addString("s", nullptr);
+    writer.beginArray("list");
+    writer.addUInt(nullptr, 1);
+    writer.beginObject();
+    writer.addInt("x", -1);
+    writer.endObject();
+    writer.beginArray();
+    writer.endArray();
+    writer.endArray();
+    writer.endObject();
+    size_t length = writer.finish();
+
+    const char* expected = "{\"a\":0,\"b\":-12,\"nested\":{\"on\":true,\"empty\":{},\"off\":false},"
+                           "\"t\":32.5,\"n\":-0.05,\"z\":7,\"min\":-9223372036854775808,"
+                           "\"max\":18446744073709551615,\"s\":null,\"list\":[1,{\"x\":-1},[]]}";
+    if (length != strlen(expected) || strcmp(buffer, expected) != 0) {
+        LOG_TAG_ERROR("JsonWriterTest", "格式错误: %s", buffer);
+        return false;
+    }
+    return true;
+}
+
+bool JsonWriterTest::testEscaping() {
+    char buffer[128];
+    JsonWriter writer(buffer, sizeof(buffer));
+    writer.beginObject();
+    writer.addString("msg", "引号\"反斜杠\\换行\n制表\t\x01");
+    writer.addString("k\"ey", "换行\n制表\t");
+    writer.endObject();
+    size_t length = writer.finish();
+
+    const char* expected = "{\"msg\":\"引号\\\"反斜杠\\\\换行\\n制表\\t\\u0001\",\"k\\\"ey\":\"换行\\n制表\\t\"}";
+    if (length == 0 || strcmp(buffer, expected) != 0) {
+        LOG_TAG_ERROR("JsonWriterTest", "转义错误: %s", buffer);
+        return false;
+    }
+
+    // 解析回来与原字符串一致
+    StaticJsonDocument<256> doc;
+    DeserializationError error = deserializeJson(doc, (const char*)buffer, length);
+    if (error || strcmp(doc["k\"ey"] | "", "换行\n制表\t") != 0) {
+        LOG_TAG_ERROR("JsonWriterTest", "转义结果无法正确解析: %s", error.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool JsonWriterTest::testOverflow() {
+    // 恰好容纳：{"a":1} 7字节 + '\0'
+    char exact[8];
+    JsonWriter fits(exact, sizeof(exact));
+    fits.beginObject();
+    fits.addUInt("a", 1);
+    fits.endObject();
+    if (fits.finish() != 7 || strcmp(exact, "{\"a\":1}") != 0) {
+        LOG_TAG_ERROR("JsonWriterTest", "恰好容纳时应写入成功: %s", exact);
+        return false;
+    }
+
+    // 少一个字节：溢出，返回0且缓冲区为空串
+    char small[7];
+    JsonWriter overflow(small, sizeof(small));
+    overflow.beginObject();
+    overflow.addUInt("a", 1);
+    overflow.endObject();
+    if (!overflow.hasOverflowed() || overflow.finish() != 0 || small[0] != '\0') {
+        LOG_TAG_ERROR("JsonWriterTest", "缓冲区不足时应返回0");
+        return false;
+    }
+
+    // 对象未闭合
+    char buffer[32];
+    JsonWriter open(buffer, sizeof(buffer));
+    open.beginObject();
+    open.addUInt("a", 1);
+    if (open.finish() != 0) {
+        LOG_TAG_ERROR("JsonWriterTest", "对象未闭合时应返回0");
+        return false;
+    }
+
+    // 空缓冲区
+    JsonWriter none(nullptr, 0);
+    none.beginObject();
+    none.endObject();
+    return none.finish() == 0;
+}
+
+bool JsonWriterTest::testStatusJson() {
+    MotorBLEServer& bleServer = MotorBLEServer::getInstance();
+    char buffer[MotorBLEServer::STATUS_JSON_BUFFER_SIZE];
+
+    bleServer.writeStatusJson(buffer, sizeof(buffer));  // 预热
+    AllocationCounter::begin();
+    size_t length = bleServer.writeStatusJson(buffer, sizeof(buffer));
+    uint32_t allocations = AllocationCounter::end();
+    if (length == 0 || allocations != 0) {
+        LOG_TAG_ERROR("JsonWriterTest", "状态JSON生成失败或分配了堆内存: %u字节, %lu次分配",
+                      (unsigned)length, (unsigned long)allocations);
+        return false;
+    }
+
+    DynamicJsonDocument doc(1024);
+    if (deserializeJson(doc, buffer, length)) {
+        LOG_TAG_ERROR("JsonWriterTest", "状态JSON无法解析: %s", buffer);
+        return false;
+    }
+    const char* keys[] = {"state", "stateName", "remainingRunTimeMs", "runDurationMs", "cycleCount",
+                          "autoStart", "outputMode", "uptime", "systemState", "freeHeap", "chipTemperature"};
+    for (const char* key : keys) {
+        if (!doc.containsKey(key)) {
+            LOG_TAG_ERROR("JsonWriterTest", "状态JSON缺少%s: %s", key, buffer);
+            return false;
+        }
+    }
+
+    // 兼容接口与定长缓冲区输出一致
+    if (bleServer.generateStatusJson().length() != length) {
+        LOG_TAG_ERROR("JsonWriterTest", "generateStatusJson()与writeStatusJson()输出不一致");
+        return false;
+    }
+
+    // 两种实现对同一状态的输出逐字节相同
+    char expected[MotorBLEServer::STATUS_JSON_BUFFER_SIZE];
+    size_t expectedLength = writerStatusJson(SNAPSHOT, expected, sizeof(expected));
+    String legacy = legacyStatusJson(SNAPSHOT);
+    if (expectedLength == 0 || legacy.length() != expectedLength || strcmp(legacy.c_str(), expected) != 0) {
+        LOG_TAG_ERROR("JsonWriterTest", "与原实现输出不一致:\n  %s\n  %s", legacy.c_str(), expected);
+        return false;
+    }
+
+    // 诊断JSON（含数组）同样不分配堆内存
+    char diagnostics[MotorBLEServer::DIAGNOSTICS_JSON_BUFFER_SIZE];
+    AllocationCounter::begin();
+    length = bleServer.writeDiagnosticsJson(diagnostics, sizeof(diagnostics));
+    allocations = AllocationCounter::end();
+    doc.clear();
+    if (length == 0 || allocations != 0 || deserializeJson(doc, diagnostics, length) ||
+        doc["phaseTiming"]["bucketLimits"].size() != PhaseJitterStatistics::BUCKET_COUNT - 1 ||
+        doc["phaseTiming"]["stop"]["histogram"].size() != PhaseJitterStatistics::BUCKET_COUNT ||
+        !doc["bleCommands"].containsKey("maxLatency")) {
+        LOG_TAG_ERROR("JsonWriterTest", "诊断JSON错误(%lu次分配): %s", (unsigned long)allocations, diagnostics);
+        return false;
+    }
+    return true;
+}
+
+bool JsonWriterTest::runBenchmark() {
+    const uint32_t iterations = 100000;
+    LOG_TAG_INFO("JsonWriterTest", "开始状态JSON序列化对比（每组%lu次）...", (unsigned long)iterations);
+
+    char buffer[MotorBLEServer::STATUS_JSON_BUFFER_SIZE];
+    measureSerialize("DynamicJsonDocument + String", []() {
+        return legacyStatusJson(SNAPSHOT).length();
+    }, iterations);
+    measureSerialize("JsonWriter", [&buffer]() {
+        return writerStatusJson(SNAPSHOT, buffer, sizeof(buffer));
+    }, iterations);
+
+    // 含取样的完整路径（读取控制器和配置）
+    MotorBLEServer& bleServer = MotorBLEServer::getInstance();
+    measureSerialize("MotorBLEServer::writeStatusJson", [&bleServer, &buffer]() {
+        return bleServer.writeStatusJson(buffer, sizeof(buffer));
+    }, iterations / 10);
+    return true;
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,52 @@
+#ifndef JSON_WRITER_TEST_H
+#define JSON_WRITER_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * 流式JSON写入器测试（仅在native环境运行）
+ */
+class JsonWriterTest {
+public:
+    /**
+     * 运行所有JSON写入器测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试对象/数组嵌套、逗号和各类数值的格式
+     * @return 测试是否通过
+     */
+    static bool testFormatting();
+
+    /**
+     * 测试字符串转义（控制字符、引号、UTF-8原样输出）
+     * @return 测试是否通过
+     */
+    static bool testEscaping();
+
+    /**
+     * 测试缓冲区不足和对象未闭合时finish()返回0
+     * @return 测试是否通过
+     */
+    static bool testOverflow();
+
+    /**
+     * 测试BLE状态JSON和诊断JSON：可被ArduinoJson解析、字段完整、不分配堆内存
+     * @return 测试是否通过
+     */
+    static bool testStatusJson();
+
+    /**
+     * 状态JSON序列化对比：DynamicJsonDocument + String与JsonWriter的吞吐量(字节/微秒)和每次堆分配次数
+     * @return 基准是否正常完成
+     */
+    static bool runBenchmark();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // JSON_WRITER_TEST_H
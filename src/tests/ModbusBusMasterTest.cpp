@@ -0,0 +1,317 @@
+#include "ModbusBusMasterTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <memory>
+#include <vector>
+#include "SimulatedModbusSlave.h"
+#include "../common/Logger.h"
+#include "../controllers/MotorModbusController.h"
+
+namespace {
+
+const uint32_t TEST_BAUD_RATE = 9600;
+
+// 主循环步长
+const uint32_t STEP_MICROS = 250;
+
+// 与调速器一致：轮询 0x0001 ~ 0x000B
+const uint16_t POLL_ADDRESS = 0x0001;
+const uint16_t POLL_QUANTITY = 11;
+
+/**
+ * 一条模拟总线及其上的从站，地址从1开始连续分配
+ */
+struct SimulatedSegment {
+    std::vector<std::unique_ptr<SimulatedModbusSlave>> slaves;
+    SimulatedModbusBus bus;
+
+    explicit SimulatedSegment(uint8_t count) {
+        for (uint8_t i = 0; i < count; i++) {
+            slaves.emplace_back(new SimulatedModbusSlave(i + 1));
+            slaves.back()->setRegister(0x000B, 10 + i);
+            slaves.back()->setResponseDelayMicros(1000);
+            bus.addSlave(*slaves.back());
+        }
+        bus.attach(Serial2);
+    }
+
+    ~SimulatedSegment() {
+        bus.detach();
+    }
+};
+
+} // namespace
+
+bool ModbusBusMasterTest::runAllTests() {
+    LOG_TAG_INFO("BusTest", "开始MODBUS多从站总线测试...");
+
+    bool allPassed = true;
+
+    if (!testFairPolling()) {
+        LOG_TAG_ERROR("BusTest", "❌ 公平轮询测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("BusTest", "✅ 公平轮询测试通过");
+    }
+
+    if (!testOfflineBackoff()) {
+        LOG_TAG_ERROR("BusTest", "❌ 离线退避测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("BusTest", "✅ 离线退避测试通过");
+    }
+
+    if (!testCommandsOnSharedBus()) {
+        LOG_TAG_ERROR("BusTest", "❌ 共享总线命令测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("BusTest", "✅ 共享总线命令测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("BusTest", "🎉 所有MODBUS多从站总线测试通过!");
+    } else {
+        LOG_TAG_ERROR("BusTest", "💥 部分MODBUS多从站总线测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool ModbusBusMasterTest::testFairPolling() {
+    const uint8_t slaveCount = 8;
+    ModbusBusMaster bus;
+    bus.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE);
+    SimulatedSegment segment(slaveCount);
+
+    // 轮询间隔为0：总线始终忙碌，检验轮转是否公平
+    uint16_t lastDuty[slaveCount + 1] = {0};
+    bus.setPollInterval(0);
+    for (uint8_t address = 1; address <= slaveCount; address++) {
+        bus.addSlave(address, POLL_ADDRESS, POLL_QUANTITY,
+            [&lastDuty](uint8_t slave, const ModbusResult& result) {
+                if (result.success) {
+                    lastDuty[slave] = result.values[10];
+                }
+            });
+    }
+    runFor(bus, 5000);
+
+    uint32_t minPolls = 0xFFFFFFFF;
+    uint32_t maxPolls = 0;
+    for (uint8_t address = 1; address <= slaveCount; address++) {
+        ModbusBusMaster::SlaveStatistics stats;
+        if (!bus.getSlaveStatistics(address, stats) || !stats.online || stats.failures != 0) {
+            LOG_TAG_ERROR("BusTest", "从站%u状态错误", address);
+            return false;
+        }
+        if (lastDuty[address] != 10 + address - 1) {
+            LOG_TAG_ERROR("BusTest", "从站%u的轮询结果错误", address);
+            return false;
+        }
+        minPolls = stats.polls < minPolls ? stats.polls : minPolls;
+        maxPolls = stats.polls > maxPolls ? stats.polls : maxPolls;
+    }
+    if (minPolls == 0 || maxPolls - minPolls > 1) {
+        LOG_TAG_ERROR("BusTest", "轮询不均: 最少%lu次, 最多%lu次", minPolls, maxPolls);
+        return false;
+    }
+
+    // 有轮询间隔时按间隔执行
+    bus.setPollInterval(500);
+    bus.resetStatistics();
+    runFor(bus, 5000);
+    ModbusBusMaster::SlaveStatistics stats;
+    bus.getSlaveStatistics(1, stats);
+    if (stats.polls < 9 || stats.polls > 11) {
+        LOG_TAG_ERROR("BusTest", "500ms间隔5秒内应轮询约10次 (实际%lu)", stats.polls);
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusBusMasterTest::testOfflineBackoff() {
+    const uint8_t slaveCount = 8;
+    ModbusBusMaster bus;
+    bus.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE);
+    SimulatedSegment segment(slaveCount);
+
+    bus.setPollInterval(500);
+    bus.setOfflineThreshold(3);
+    bus.setBackoff(500, 8000);
+    for (uint8_t address = 1; address <= slaveCount; address++) {
+        bus.addSlave(address, POLL_ADDRESS, POLL_QUANTITY);
+    }
+
+    // 从站3掉线20秒：连续3次失败后离线，之后探测间隔翻倍直到8秒
+    segment.slaves[2]->setOnline(false);
+    runFor(bus, 20000);
+
+    ModbusBusMaster::SlaveStatistics stats;
+    bus.getSlaveStatistics(3, stats);
+    if (stats.online || stats.backoffMs != 8000) {
+        LOG_TAG_ERROR("BusTest", "从站3应离线且退避到8秒 (online=%d backoff=%lu)", stats.online, stats.backoffMs);
+        return false;
+    }
+    // 离线前约3次，之后0.5+1+2+4+8秒的退避序列，20秒内不超过10次
+    if (stats.polls > 10 || stats.timeouts != stats.polls) {
+        LOG_TAG_ERROR("BusTest", "离线从站探测次数过多: %lu", stats.polls);
+        return false;
+    }
+    ModbusBusMaster::SlaveStatistics neighbour;
+    bus.getSlaveStatistics(4, neighbour);
+    if (!neighbour.online || neighbour.polls < 38) {
+        LOG_TAG_ERROR("BusTest", "在线从站轮询受影响: %lu次", neighbour.polls);
+        return false;
+    }
+
+    // 发往离线从站的命令只发送一次，不占用重试时间
+    uint8_t attempts = 0;
+    bool done = false;
+    bus.submitWriteSingle(3, 0x0005, 33, ModbusPriority::URGENT,
+        [&attempts, &done](const ModbusResult& result) {
+            attempts = result.attempts;
+            done = !result.success;
+        });
+    runFor(bus, 1000);
+    if (!done || attempts != 1) {
+        LOG_TAG_ERROR("BusTest", "离线从站的命令不应重试 (尝试%u次)", attempts);
+        return false;
+    }
+
+    // 恢复后下一次探测成功即回到在线
+    segment.slaves[2]->setOnline(true);
+    runFor(bus, 9000);
+    bus.getSlaveStatistics(3, stats);
+    if (!stats.online || stats.backoffMs != 0 || stats.consecutiveFailures != 0) {
+        LOG_TAG_ERROR("BusTest", "从站3未恢复在线");
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusBusMasterTest::testCommandsOnSharedBus() {
+    const uint8_t slaveCount = 8;
+    ModbusBusMaster bus;
+    bus.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE);
+    SimulatedSegment segment(slaveCount);
+
+    bus.setPollInterval(0);
+    for (uint8_t address = 1; address <= slaveCount; address++) {
+        bus.addSlave(address, POLL_ADDRESS, POLL_QUANTITY);
+    }
+
+    // 两个调速器控制器共用同一条总线
+    MotorModbusController controllerA(bus);
+    MotorModbusController controllerB(bus);
+    controllerA.begin(5);
+    controllerB.begin(6);
+    if (bus.getSlaveCount() != slaveCount) {
+        LOG_TAG_ERROR("BusTest", "控制器不应重复添加已有从站");
+        return false;
+    }
+
+    // 轮询不停时启动命令仍然优先完成
+    bool started = false;
+    controllerA.requestStart([&started](bool success) { started = success; });
+    bool written = false;
+    bus.submitWriteSingle(7, 0x0005, 77, ModbusPriority::NORMAL,
+        [&written](const ModbusResult& result) { written = result.success && result.slaveAddress == 7; });
+
+    uint32_t startedAtMs = 0;
+    for (uint32_t elapsedUs = 0; elapsedUs < 1000000 && (!started || !written); elapsedUs += STEP_MICROS) {
+        controllerA.update();
+        controllerB.update();
+        bus.update();
+        NativeHAL::advanceMicros(STEP_MICROS);
+        if (started && startedAtMs == 0) {
+            startedAtMs = elapsedUs / 1000;
+        }
+    }
+    if (!started || !written || startedAtMs > 300) {
+        LOG_TAG_ERROR("BusTest", "命令未及时完成 (启动耗时%lums)", startedAtMs);
+        return false;
+    }
+    if (segment.slaves[4]->getRegister(0x0008) != 1 || segment.slaves[5]->getRegister(0x0008) != 0 ||
+        segment.slaves[6]->getRegister(0x0005) != 77) {
+        LOG_TAG_ERROR("BusTest", "命令发到了错误的从站");
+        return false;
+    }
+
+    // 同步接口在轮询间隙使用正确的从站地址
+    runFor(bus, 200);
+    while (!bus.getQueue().isIdle()) {
+        bus.getQueue().process();
+        NativeHAL::advanceMicros(STEP_MICROS);
+    }
+    uint8_t duty = 0;
+    if (!controllerB.getDutyCycle(duty) || duty != 15) {
+        LOG_TAG_ERROR("BusTest", "控制器B读取到错误的从站数据: %u", duty);
+        return false;
+    }
+
+    ModbusBusMaster::SlaveStatistics stats;
+    bus.getSlaveStatistics(7, stats);
+    if (stats.requests != stats.polls + 1) {
+        LOG_TAG_ERROR("BusTest", "命令结果未计入从站统计");
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusBusMasterTest::runThroughputBenchmark() {
+    const uint8_t slaveCount = 12;
+    const uint32_t durationMs = 30000;
+    LOG_TAG_INFO("BusTest", "开始总线轮询吞吐量测试（%u个从站，其中2个离线，%lu波特，每次读取%u个寄存器）...",
+                 slaveCount, TEST_BAUD_RATE, POLL_QUANTITY);
+
+    uint32_t onlinePolls[2] = {0, 0};
+    for (int mode = 0; mode < 2; mode++) {
+        bool backoff = mode == 1;
+        ModbusBusMaster bus;
+        bus.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE);
+        SimulatedSegment segment(slaveCount);
+        const uint8_t offlineA = 4;
+        const uint8_t offlineB = 9;
+        segment.slaves[offlineA - 1]->setOnline(false);
+        segment.slaves[offlineB - 1]->setOnline(false);
+
+        bus.setPollInterval(0);
+        // 不退避时离线从站与在线从站一样参与每轮轮询
+        bus.setOfflineThreshold(backoff ? 3 : 0xFF);
+        for (uint8_t address = 1; address <= slaveCount; address++) {
+            bus.addSlave(address, POLL_ADDRESS, POLL_QUANTITY);
+        }
+        runFor(bus, durationMs);
+
+        uint32_t timeouts = 0;
+        uint32_t minPolls = 0xFFFFFFFF;
+        for (uint8_t address = 1; address <= slaveCount; address++) {
+            ModbusBusMaster::SlaveStatistics stats;
+            bus.getSlaveStatistics(address, stats);
+            if (address != offlineA && address != offlineB) {
+                onlinePolls[mode] += stats.successes;
+                minPolls = stats.successes < minPolls ? stats.successes : minPolls;
+            }
+            timeouts += stats.timeouts;
+        }
+        LOG_TAG_INFO("BusTest", "%s: 在线从站共%lu次轮询 (%.1f次/秒，单个从站最少%.1f次/秒)，超时%lu次",
+                     backoff ? "离线退避" : "无退避", onlinePolls[mode],
+                     onlinePolls[mode] * 1000.0f / durationMs, minPolls * 1000.0f / durationMs, timeouts);
+    }
+
+    return onlinePolls[1] > onlinePolls[0];
+}
+
+void ModbusBusMasterTest::runFor(ModbusBusMaster& bus, uint32_t durationMs) {
+    for (uint32_t elapsedUs = 0; elapsedUs < durationMs * 1000; elapsedUs += STEP_MICROS) {
+        bus.update();
+        NativeHAL::advanceMicros(STEP_MICROS);
+    }
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,53 @@
+#ifndef MODBUS_BUS_MASTER_TEST_H
+#define MODBUS_BUS_MASTER_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+#include "../drivers/ModbusBusMaster.h"
+
+/**
+ * 多从站总线主站测试（依赖模拟UART和模拟从站，仅在native环境运行）
+ */
+class ModbusBusMasterTest {
+public:
+    /**
+     * 运行所有总线主站测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试8个从站轮流获得轮询机会
+     * @return 测试是否通过
+     */
+    static bool testFairPolling();
+
+    /**
+     * 测试离线从站的判定、指数退避和恢复
+     * @return 测试是否通过
+     */
+    static bool testOfflineBackoff();
+
+    /**
+     * 测试控制命令发往正确的从站，以及多个控制器共享一条总线
+     * @return 测试是否通过
+     */
+    static bool testCommandsOnSharedBus();
+
+    /**
+     * 总线轮询吞吐量：12个从站（其中2个离线），对比有无离线退避的总轮询速率
+     * @return 有退避时在线从站的轮询速率是否更高
+     */
+    static bool runThroughputBenchmark();
+
+private:
+    /**
+     * 以固定步长推进虚拟时间并调用bus.update()
+     */
+    static void runFor(ModbusBusMaster& bus, uint32_t durationMs);
+};
+
+#endif // NATIVE_BUILD
+
+#endif // MODBUS_BUS_MASTER_TEST_H
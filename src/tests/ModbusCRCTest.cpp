@@ -0,0 +1,175 @@
+#include "ModbusCRCTest.h"
+#include "../common/Logger.h"
+
+namespace {
+
+const CRCEngine ALL_ENGINES[] = {
+    CRCEngine::BITWISE,
+    CRCEngine::TABLE,
+    CRCEngine::SLICE_BY_4
+};
+
+// 防止基准测试循环被编译器优化掉
+volatile uint16_t benchmarkSink = 0;
+
+} // namespace
+
+bool ModbusCRCTest::runAllTests() {
+    LOG_TAG_INFO("CRCTest", "开始MODBUS CRC测试...");
+    
+    bool allPassed = true;
+    
+    if (!testKnownVectors()) {
+        LOG_TAG_ERROR("CRCTest", "❌ 已知报文CRC测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("CRCTest", "✅ 已知报文CRC测试通过");
+    }
+    
+    if (!testEnginesAgree()) {
+        LOG_TAG_ERROR("CRCTest", "❌ 引擎一致性测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("CRCTest", "✅ 引擎一致性测试通过");
+    }
+    
+    if (!testIncrementalUpdate()) {
+        LOG_TAG_ERROR("CRCTest", "❌ 增量计算测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("CRCTest", "✅ 增量计算测试通过");
+    }
+    
+    if (allPassed) {
+        LOG_TAG_INFO("CRCTest", "🎉 所有MODBUS CRC测试通过!");
+    } else {
+        LOG_TAG_ERROR("CRCTest", "💥 部分MODBUS CRC测试失败!");
+    }
+    
+    return allPassed;
+}
+
+bool ModbusCRCTest::testKnownVectors() {
+    // 读保持寄存器请求：01 03 00 00 00 0A -> CRC C5 CD
+    const uint8_t readRequest[] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x0A};
+    // 写单个寄存器请求：01 06 00 01 00 03 -> CRC 98 0B
+    const uint8_t writeRequest[] = {0x01, 0x06, 0x00, 0x01, 0x00, 0x03};
+    // 标准校验串 "123456789" -> 0x4B37
+    const uint8_t checkString[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    
+    bool result = true;
+    for (CRCEngine engine : ALL_ENGINES) {
+        uint16_t crc1 = ModbusCRC::calculate(readRequest, sizeof(readRequest), engine);
+        uint16_t crc2 = ModbusCRC::calculate(writeRequest, sizeof(writeRequest), engine);
+        uint16_t crc3 = ModbusCRC::calculate(checkString, sizeof(checkString), engine);
+        uint16_t crcEmpty = ModbusCRC::calculate(readRequest, 0, engine);
+        
+        if (crc1 != 0xCDC5 || crc2 != 0x0B98 || crc3 != 0x4B37 || crcEmpty != 0xFFFF) {
+            LOG_TAG_ERROR("CRCTest", "%s 引擎结果错误: %04X %04X %04X %04X",
+                          ModbusCRC::getEngineName(engine), crc1, crc2, crc3, crcEmpty);
+            result = false;
+        }
+    }
+    return result;
+}
+
+bool ModbusCRCTest::testEnginesAgree() {
+    uint8_t data[300];
+    uint32_t seed = 0x12345678;
+    
+    // 覆盖0~299所有长度，包括slice-by-4的各种尾部余数
+    for (size_t length = 0; length < sizeof(data); length++) {
+        for (size_t i = 0; i < length; i++) {
+            seed = seed * 1103515245 + 12345;
+            data[i] = static_cast<uint8_t>(seed >> 16);
+        }
+        
+        uint16_t expected = ModbusCRC::calculate(data, length, CRCEngine::BITWISE);
+        uint16_t table = ModbusCRC::calculate(data, length, CRCEngine::TABLE);
+        uint16_t slice = ModbusCRC::calculate(data, length, CRCEngine::SLICE_BY_4);
+        
+        if (table != expected || slice != expected) {
+            LOG_TAG_ERROR("CRCTest", "长度%u结果不一致: bitwise=%04X table=%04X slice=%04X",
+                          static_cast<unsigned>(length), expected, table, slice);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ModbusCRCTest::testIncrementalUpdate() {
+    uint8_t frame[64];
+    for (size_t i = 0; i < 62; i++) {
+        frame[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    uint16_t crc = ModbusCRC::calculate(frame, 62);
+    frame[62] = crc & 0xFF;
+    frame[63] = (crc >> 8) & 0xFF;
+    
+    for (CRCEngine engine : ALL_ENGINES) {
+        // 分段计算应与一次计算结果相同
+        uint16_t partial = ModbusCRC::update(ModbusCRC::INITIAL_VALUE, frame, 13, engine);
+        partial = ModbusCRC::update(partial, frame + 13, 49, engine);
+        if (partial != crc) {
+            LOG_TAG_ERROR("CRCTest", "%s 分段计算结果错误", ModbusCRC::getEngineName(engine));
+            return false;
+        }
+        
+        // 对含CRC的完整帧计算，余数应为0
+        if (ModbusCRC::calculate(frame, sizeof(frame), engine) != 0) {
+            LOG_TAG_ERROR("CRCTest", "%s 完整帧余数不为0", ModbusCRC::getEngineName(engine));
+            return false;
+        }
+    }
+    
+    // 单字节增量
+    uint16_t byteWise = ModbusCRC::INITIAL_VALUE;
+    for (size_t i = 0; i < sizeof(frame); i++) {
+        byteWise = ModbusCRC::update(byteWise, frame[i]);
+    }
+    if (byteWise != 0) {
+        LOG_TAG_ERROR("CRCTest", "单字节增量计算余数不为0: %04X", byteWise);
+        return false;
+    }
+    return true;
+}
+
+void ModbusCRCTest::runBenchmark() {
+    LOG_TAG_INFO("CRCTest", "开始MODBUS CRC性能基准...");
+    
+    const struct {
+        size_t frameLength;
+        uint32_t iterations;
+    } cases[] = {
+        {8, 50000},     // 典型请求帧
+        {256, 2000}     // 最大RTU帧
+    };
+    
+    for (const auto& benchCase : cases) {
+        for (CRCEngine engine : ALL_ENGINES) {
+            float throughput = measureThroughput(engine, benchCase.frameLength, benchCase.iterations);
+            LOG_TAG_INFO("CRCTest", "%3u字节帧 %-10s: %.2f 字节/微秒",
+                         static_cast<unsigned>(benchCase.frameLength),
+                         ModbusCRC::getEngineName(engine), throughput);
+        }
+    }
+}
+
+float ModbusCRCTest::measureThroughput(CRCEngine engine, size_t frameLength, uint32_t iterations) {
+    uint8_t frame[256];
+    for (size_t i = 0; i < frameLength; i++) {
+        frame[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    
+    uint32_t startTime = micros();
+    for (uint32_t i = 0; i < iterations; i++) {
+        frame[0] = static_cast<uint8_t>(i);  // 每次数据不同，避免结果被提升到循环外
+        benchmarkSink = ModbusCRC::calculate(frame, frameLength, engine);
+    }
+    uint32_t elapsed = micros() - startTime;
+    
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    return static_cast<float>(frameLength) * iterations / elapsed;
+}
@@ -0,0 +1,47 @@
+#ifndef MODBUS_CRC_TEST_H
+#define MODBUS_CRC_TEST_H
+
+#include <Arduino.h>
+#include "../drivers/ModbusCRC.h"
+
+class ModbusCRCTest {
+public:
+    /**
+     * 运行所有CRC正确性测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+    
+    /**
+     * 测试已知报文的CRC值
+     * @return 测试是否通过
+     */
+    static bool testKnownVectors();
+    
+    /**
+     * 测试三种引擎在随机数据和各种长度下结果一致
+     * @return 测试是否通过
+     */
+    static bool testEnginesAgree();
+    
+    /**
+     * 测试增量计算和完整帧校验（余数为0）
+     * @return 测试是否通过
+     */
+    static bool testIncrementalUpdate();
+    
+    /**
+     * CRC性能基准：输出各引擎处理8字节和256字节帧的吞吐量(字节/微秒)
+     * @note 依赖真实时钟，主机上需关闭虚拟时钟后运行
+     */
+    static void runBenchmark();
+
+private:
+    /**
+     * 测量单个引擎的吞吐量
+     * @return 字节/微秒
+     */
+    static float measureThroughput(CRCEngine engine, size_t frameLength, uint32_t iterations);
+};
+
+#endif // MODBUS_CRC_TEST_H
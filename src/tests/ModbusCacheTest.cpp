@@ -0,0 +1,322 @@
+#include "ModbusCacheTest.h"
+#include "../common/Logger.h"
+#include "../drivers/ModbusRegisterCache.h"
+
+#ifdef NATIVE_BUILD
+#include <NativeHAL.h>
+#include "SimulatedModbusSlave.h"
+#include "../controllers/MotorModbusController.h"
+#endif
+
+namespace {
+
+// 缓存覆盖 0x0000 ~ 0x000B，与调速器寄存器表一致
+const uint16_t CACHE_BASE = 0x0000;
+const uint8_t CACHE_COUNT = 12;
+const uint32_t CACHE_TTL_MS = 1000;
+
+void fillRegisters(ModbusRegisterCache& cache, uint32_t nowMs) {
+    uint16_t values[CACHE_COUNT];
+    for (uint16_t i = 0; i < CACHE_COUNT; i++) {
+        values[i] = 100 + i;
+    }
+    cache.store(CACHE_BASE, CACHE_COUNT, values, nowMs);
+}
+
+} // namespace
+
+bool ModbusCacheTest::runAllTests() {
+    LOG_TAG_INFO("CacheTest", "开始MODBUS寄存器缓存测试...");
+
+    bool allPassed = true;
+
+    if (!testFreshness()) {
+        LOG_TAG_ERROR("CacheTest", "❌ 有效期测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("CacheTest", "✅ 有效期测试通过");
+    }
+
+    if (!testStaleSpanCoalescing()) {
+        LOG_TAG_ERROR("CacheTest", "❌ 过期区间合并测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("CacheTest", "✅ 过期区间合并测试通过");
+    }
+
+    if (!testInvalidationAndStatistics()) {
+        LOG_TAG_ERROR("CacheTest", "❌ 作废及统计测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("CacheTest", "✅ 作废及统计测试通过");
+    }
+
+#ifdef NATIVE_BUILD
+    if (!testControllerBusTraffic()) {
+        LOG_TAG_ERROR("CacheTest", "❌ 控制器总线流量测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("CacheTest", "✅ 控制器总线流量测试通过");
+    }
+#endif
+
+    if (allPassed) {
+        LOG_TAG_INFO("CacheTest", "🎉 所有MODBUS寄存器缓存测试通过!");
+    } else {
+        LOG_TAG_ERROR("CacheTest", "💥 部分MODBUS寄存器缓存测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool ModbusCacheTest::testFreshness() {
+    ModbusRegisterCache cache(CACHE_BASE, CACHE_COUNT, CACHE_TTL_MS);
+    uint16_t values[CACHE_COUNT];
+
+    // 从未读取过的寄存器不命中
+    if (cache.lookup(0x0001, 2, values, 0)) {
+        LOG_TAG_ERROR("CacheTest", "空缓存不应命中");
+        return false;
+    }
+
+    fillRegisters(cache, 5000);
+    if (!cache.lookup(0x0009, 3, values, 5000 + CACHE_TTL_MS - 1) ||
+        values[0] != 109 || values[1] != 110 || values[2] != 111) {
+        LOG_TAG_ERROR("CacheTest", "有效期内应命中并返回缓存值");
+        return false;
+    }
+    if (cache.lookup(0x0009, 3, values, 5000 + CACHE_TTL_MS)) {
+        LOG_TAG_ERROR("CacheTest", "到期后不应命中");
+        return false;
+    }
+
+    // TTL为0的寄存器始终需要读取总线
+    cache.setTTL(0x0008, 1, 0);
+    fillRegisters(cache, 6000);
+    if (cache.lookup(0x0008, 1, values, 6000) || !cache.lookup(0x0007, 1, values, 6000)) {
+        LOG_TAG_ERROR("CacheTest", "TTL为0的寄存器不应被缓存");
+        return false;
+    }
+
+    // millis()回绕前后仍按差值判定
+    uint32_t nearWrap = 0xFFFFFF00;
+    fillRegisters(cache, nearWrap);
+    if (!cache.lookup(0x0000, 1, values, nearWrap + 0x200) ||
+        cache.lookup(0x0000, 1, values, nearWrap + CACHE_TTL_MS + 1)) {
+        LOG_TAG_ERROR("CacheTest", "millis()回绕时有效期判定错误");
+        return false;
+    }
+
+    // 超出覆盖范围的请求不命中
+    if (cache.covers(0x000B, 2) || cache.lookup(0x000B, 2, values, nearWrap)) {
+        LOG_TAG_ERROR("CacheTest", "超出覆盖范围的请求不应命中");
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusCacheTest::testStaleSpanCoalescing() {
+    ModbusRegisterCache cache(CACHE_BASE, CACHE_COUNT, CACHE_TTL_MS);
+    uint16_t spanAddress = 0;
+    uint16_t spanQuantity = 0;
+
+    // 全部未读取时整段读取
+    if (!cache.getStaleSpan(0x0001, 11, 0, spanAddress, spanQuantity) ||
+        spanAddress != 0x0001 || spanQuantity != 11) {
+        LOG_TAG_ERROR("CacheTest", "空缓存应整段读取");
+        return false;
+    }
+
+    fillRegisters(cache, 1000);
+    if (cache.getStaleSpan(0x0001, 11, 1500, spanAddress, spanQuantity)) {
+        LOG_TAG_ERROR("CacheTest", "全部新鲜时不应需要读取");
+        return false;
+    }
+
+    // 两个不相邻的过期寄存器合并成一个区间
+    cache.invalidate(0x0003, 1);
+    cache.invalidate(0x0006, 1);
+    if (!cache.getStaleSpan(0x0001, 11, 1500, spanAddress, spanQuantity) ||
+        spanAddress != 0x0003 || spanQuantity != 4) {
+        LOG_TAG_ERROR("CacheTest", "过期区间应为0x0003开始的4个寄存器 (实际: 0x%04X, %u)",
+                      spanAddress, spanQuantity);
+        return false;
+    }
+
+    // 运行状态/频率/占空比使用较短的TTL，到期后只读取这一段
+    fillRegisters(cache, 1000);
+    cache.setTTL(0x0008, 4, 200);
+    if (!cache.getStaleSpan(0x0001, 11, 1300, spanAddress, spanQuantity) ||
+        spanAddress != 0x0008 || spanQuantity != 4) {
+        LOG_TAG_ERROR("CacheTest", "短TTL区间到期后应只读取0x0008开始的4个寄存器");
+        return false;
+    }
+
+    // 超出覆盖范围时原样返回请求区间
+    if (!cache.getStaleSpan(0x0020, 2, 1300, spanAddress, spanQuantity) ||
+        spanAddress != 0x0020 || spanQuantity != 2) {
+        LOG_TAG_ERROR("CacheTest", "超出覆盖范围的请求应整段读取");
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusCacheTest::testInvalidationAndStatistics() {
+    ModbusRegisterCache cache(CACHE_BASE, CACHE_COUNT, CACHE_TTL_MS);
+    uint16_t values[CACHE_COUNT];
+    uint16_t spanAddress = 0;
+    uint16_t spanQuantity = 0;
+
+    fillRegisters(cache, 0);
+
+    // 写穿：写入的值立即可读
+    const uint16_t written[2] = {7, 8};
+    cache.store(0x0004, 2, written, 10);
+    if (!cache.lookup(0x0004, 2, values, 20) || values[0] != 7 || values[1] != 8) {
+        LOG_TAG_ERROR("CacheTest", "写入后应能读到新值");
+        return false;
+    }
+
+    // 作废后必须重新读取，copy()报告数据无效
+    cache.invalidate(0x0005, 1);
+    if (cache.lookup(0x0004, 2, values, 20) || cache.copy(0x0004, 2, values)) {
+        LOG_TAG_ERROR("CacheTest", "作废后不应命中");
+        return false;
+    }
+    // 只有读取成功的寄存器计入读取统计
+    if (!cache.getStaleSpan(0x0004, 2, 20, spanAddress, spanQuantity) || cache.getStatistics().registersRead != 0) {
+        LOG_TAG_ERROR("CacheTest", "计算过期区间时不应计入读取统计");
+        return false;
+    }
+    const uint16_t readBack[1] = {8};
+    cache.storeRead(spanAddress, spanQuantity, readBack, 20);
+
+    cache.invalidateAll();
+    if (cache.lookup(0x0000, 1, values, 20)) {
+        LOG_TAG_ERROR("CacheTest", "全部作废后不应命中");
+        return false;
+    }
+
+    const ModbusRegisterCache::Statistics& stats = cache.getStatistics();
+    if (stats.hits != 1 || stats.misses != 2 || stats.registersRequested != 5 || stats.registersRead != 1) {
+        LOG_TAG_ERROR("CacheTest", "统计错误 (命中%lu 未命中%lu 请求%lu 读取%lu)",
+                      stats.hits, stats.misses, stats.registersRequested, stats.registersRead);
+        return false;
+    }
+
+    cache.resetStatistics();
+    if (cache.getStatistics().hits != 0 || cache.getStatistics().registersRequested != 0) {
+        LOG_TAG_ERROR("CacheTest", "统计重置失败");
+        return false;
+    }
+
+    return true;
+}
+
+#ifdef NATIVE_BUILD
+bool ModbusCacheTest::testControllerBusTraffic() {
+    MotorModbusController controller;
+    controller.begin(0x01);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+    const uint16_t registers[] = {1, 1, 0, 1, 10, 90, 30, 20, 0, 0x0001, 0x86A0, 55};
+    for (uint16_t i = 0; i < 12; i++) {
+        slave.setRegister(i, registers[i]);
+    }
+
+    // 一次完整读取后，单项读取全部来自缓存
+    MotorModbusController::AllConfig config;
+    uint32_t frequency = 0;
+    uint8_t duty = 0;
+    bool running = true;
+    if (!controller.getAllConfig(config) || config.frequency != 100000 || config.dutyCycle != 55) {
+        LOG_TAG_ERROR("CacheTest", "读取所有配置失败");
+        return false;
+    }
+    for (int i = 0; i < 10; i++) {
+        if (!controller.getFrequency(frequency) || !controller.getDutyCycle(duty) ||
+            !controller.getRunStatus(running) || !controller.getAllConfig(config)) {
+            LOG_TAG_ERROR("CacheTest", "缓存读取失败");
+            return false;
+        }
+    }
+    if (slave.getRequestCount() != 1 || frequency != 100000 || duty != 55 || running) {
+        LOG_TAG_ERROR("CacheTest", "有效期内不应访问总线 (请求数: %lu)", slave.getRequestCount());
+        return false;
+    }
+
+    // 本机写入后缓存即为新值，不需要回读
+    if (!controller.setDutyCycle(70) || !controller.getDutyCycle(duty) || duty != 70 ||
+        slave.getRequestCount() != 2) {
+        LOG_TAG_ERROR("CacheTest", "写入后缓存未更新");
+        return false;
+    }
+
+    // 状态寄存器先到期：只重读0x0008开始的4个寄存器，配置寄存器仍来自缓存
+    slave.setRegister(0x0008, 1);
+    NativeHAL::advanceMicros(1500 * 1000);
+    slave.clearRequestLog();
+    if (!controller.getAllConfig(config) || !config.isRunning) {
+        LOG_TAG_ERROR("CacheTest", "状态到期后读取失败");
+        return false;
+    }
+    const std::vector<SimulatedModbusSlave::RequestRecord>& log = slave.getRequestLog();
+    if (log.size() != 1 || log[0].address != 0x0008) {
+        LOG_TAG_ERROR("CacheTest", "应只读取过期的状态区间");
+        return false;
+    }
+
+    // 异步读取在缓存新鲜时不访问总线
+    if (!controller.getCachedAllConfig(config) || slave.getRequestCount() != 1) {
+        LOG_TAG_ERROR("CacheTest", "新鲜缓存不应访问总线");
+        return false;
+    }
+
+    // 写入失败时作废缓存
+    slave.dropNextRequests(10);
+    if (controller.setFrequency(2000)) {
+        LOG_TAG_ERROR("CacheTest", "从站无应答时写入应失败");
+        return false;
+    }
+    slave.dropNextRequests(0);
+    slave.clearRequestLog();
+    if (!controller.getFrequency(frequency) || frequency != 100000 || slave.getRequestCount() != 1) {
+        LOG_TAG_ERROR("CacheTest", "写入失败后应重新读取");
+        return false;
+    }
+
+    // 异步读取失败时作废请求的整个区间，且不计入读取统计
+    if (!controller.getAllConfig(config)) {
+        LOG_TAG_ERROR("CacheTest", "读取所有配置失败");
+        return false;
+    }
+    uint32_t readBefore = controller.getCacheStatistics().registersRead;
+    bool completed = false;
+    bool readOk = true;
+    slave.dropNextRequests(10);
+    controller.requestAllConfig([&completed, &readOk](bool success, const MotorModbusController::AllConfig&,
+                                                      uint32_t) {
+        completed = true;
+        readOk = success;
+    });
+    for (uint32_t elapsedMs = 0; elapsedMs < 3000 && !completed; elapsedMs++) {
+        controller.update();
+        NativeHAL::advanceMicros(1000);
+    }
+    slave.dropNextRequests(0);
+    slave.clearRequestLog();
+    if (!completed || readOk || controller.getCacheStatistics().registersRead != readBefore ||
+        !controller.getAllConfig(config) || slave.getRequestLog().size() != 1 ||
+        slave.getRequestLog()[0].address != 0x0001) {
+        LOG_TAG_ERROR("CacheTest", "异步读取失败后应作废整个区间");
+        return false;
+    }
+
+    const ModbusRegisterCache::Statistics& stats = controller.getCacheStatistics();
+    LOG_TAG_INFO("CacheTest", "缓存命中%lu次，未命中%lu次，请求寄存器%lu个，实际读取%lu个",
+                 stats.hits, stats.misses, stats.registersRequested, stats.registersRead);
+    return stats.hits > stats.misses && stats.registersRead < stats.registersRequested;
+}
+#endif
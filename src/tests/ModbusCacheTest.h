@@ -0,0 +1,44 @@
+#ifndef MODBUS_CACHE_TEST_H
+#define MODBUS_CACHE_TEST_H
+
+#include <Arduino.h>
+
+/**
+ * MODBUS寄存器影子缓存测试
+ */
+class ModbusCacheTest {
+public:
+    /**
+     * 运行所有寄存器缓存测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试有效期判定：命中、过期、TTL为0不缓存、millis()回绕
+     * @return 测试是否通过
+     */
+    static bool testFreshness();
+
+    /**
+     * 测试过期寄存器合并为单个读取区间
+     * @return 测试是否通过
+     */
+    static bool testStaleSpanCoalescing();
+
+    /**
+     * 测试作废和统计计数
+     * @return 测试是否通过
+     */
+    static bool testInvalidationAndStatistics();
+
+#ifdef NATIVE_BUILD
+    /**
+     * 测试控制器经过缓存后的总线请求数（依赖模拟从站，仅在native环境运行）
+     * @return 测试是否通过
+     */
+    static bool testControllerBusTraffic();
+#endif
+};
+
+#endif // MODBUS_CACHE_TEST_H
@@ -0,0 +1,454 @@
+#include "ModbusErrorTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include "SimulatedModbusSlave.h"
+#include "../common/Logger.h"
+#include "../drivers/ModbusBusMaster.h"
+#include "../drivers/ModbusCRC.h"
+
+namespace {
+
+const uint32_t TEST_BAUD_RATE = 9600;
+const uint32_t STEP_MICROS = 250;
+
+/**
+ * 注入一帧应答（自动追加CRC）并等待驱动接收
+ * @param corruptCrc 是否破坏CRC
+ * @return parseResponse()的结果；帧出错时返回false，错误保留在接收器中
+ */
+bool receiveResponse(ModbusRTUDriver& driver, const uint8_t* frame, uint16_t length, uint16_t* values,
+                     bool corruptCrc = false) {
+    uint8_t buffer[32];
+    memcpy(buffer, frame, length);
+    uint16_t crc = ModbusCRC::calculate(buffer, length);
+    buffer[length] = crc & 0xFF;
+    buffer[length + 1] = ((crc >> 8) & 0xFF) ^ (corruptCrc ? 0xFF : 0x00);
+    Serial2.simInject(buffer, length + 2);
+
+    for (uint32_t elapsedUs = 0; elapsedUs < 100000; elapsedUs += STEP_MICROS) {
+        if (driver.poll()) {
+            return driver.parseResponse(values);
+        }
+        if (driver.getReceiver().hasError()) {
+            return false;
+        }
+        NativeHAL::advanceMicros(STEP_MICROS);
+    }
+    return false;
+}
+
+/**
+ * 应答读取10个寄存器的请求；第一次应答的字节数被破坏，接收器在第7个字节即判定CRC错误，
+ * 其余18个字节仍在发送。记录每次请求的发送时刻和损坏应答最后一个字节的到达时刻
+ */
+class CorruptedByteCountSlave {
+public:
+    static const uint16_t QUANTITY = 10;
+
+    CorruptedByteCountSlave() : requestCount(0), corruptedEndMicros(0) {
+        Serial2.simReset();
+        Serial2.simSetTxHandler([this](const uint8_t*, size_t length) {
+            onRequest(length);
+        });
+    }
+
+    ~CorruptedByteCountSlave() {
+        Serial2.simSetTxHandler(nullptr);
+        Serial2.simReset();
+    }
+
+    uint32_t requestCount;
+    uint64_t requestMicros[4];
+    uint64_t corruptedEndMicros;
+
+private:
+    void onRequest(size_t requestLength) {
+        uint64_t now = NativeHAL::nowMicros();
+        if (requestCount < 4) {
+            requestMicros[requestCount] = now;
+        }
+        requestCount++;
+
+        uint8_t frame[5 + QUANTITY * 2];
+        frame[0] = 0x01;
+        frame[1] = 0x03;
+        frame[2] = QUANTITY * 2;
+        for (uint16_t i = 0; i < QUANTITY * 2; i++) {
+            frame[3 + i] = (uint8_t)i;
+        }
+        uint16_t crc = ModbusCRC::calculate(frame, 3 + QUANTITY * 2);
+        frame[3 + QUANTITY * 2] = crc & 0xFF;
+        frame[4 + QUANTITY * 2] = (crc >> 8) & 0xFF;
+        if (requestCount == 1) {
+            frame[2] = 2;
+            // 应答在请求发送完之后开始
+            corruptedEndMicros = now + (requestLength + sizeof(frame)) * Serial2.simCharTimeUs();
+        }
+        Serial2.simInject(frame, sizeof(frame));
+    }
+};
+
+void pumpUntilIdle(ModbusTransactionQueue& queue) {
+    for (uint32_t elapsedUs = 0; elapsedUs < 2000000 && !queue.isIdle(); elapsedUs += STEP_MICROS) {
+        queue.process();
+        NativeHAL::advanceMicros(STEP_MICROS);
+    }
+}
+
+} // namespace
+
+bool ModbusErrorTest::runAllTests() {
+    LOG_TAG_INFO("ErrorTest", "开始MODBUS错误处理测试...");
+
+    bool allPassed = true;
+
+    if (!testResponseValidation()) {
+        LOG_TAG_ERROR("ErrorTest", "❌ 应答校验测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ErrorTest", "✅ 应答校验测试通过");
+    }
+
+    if (!testSyncRetryPolicy()) {
+        LOG_TAG_ERROR("ErrorTest", "❌ 同步重试策略测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ErrorTest", "✅ 同步重试策略测试通过");
+    }
+
+    if (!testQueueRetryPolicy()) {
+        LOG_TAG_ERROR("ErrorTest", "❌ 队列重试策略测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ErrorTest", "✅ 队列重试策略测试通过");
+    }
+
+    if (!testRetryAfterLineSilence()) {
+        LOG_TAG_ERROR("ErrorTest", "❌ 重发前线路静默测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ErrorTest", "✅ 重发前线路静默测试通过");
+    }
+
+    if (!testBusMasterExceptions()) {
+        LOG_TAG_ERROR("ErrorTest", "❌ 总线异常应答测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ErrorTest", "✅ 总线异常应答测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("ErrorTest", "🎉 所有MODBUS错误处理测试通过!");
+    } else {
+        LOG_TAG_ERROR("ErrorTest", "💥 部分MODBUS错误处理测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool ModbusErrorTest::testResponseValidation() {
+    ModbusRTUDriver driver;
+    driver.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE, 0x01);
+    Serial2.simReset();
+    Serial2.simSetTxHandler(nullptr);
+
+    uint16_t values[2] = {0, 0};
+
+    // 正常应答
+    const uint8_t valid[] = {0x01, 0x03, 0x04, 0x00, 0x0A, 0x00, 0x0B};
+    driver.sendRequest(0x03, 0x0001, 2);
+    if (!receiveResponse(driver, valid, sizeof(valid), values) || values[0] != 10 || values[1] != 11) {
+        LOG_TAG_ERROR("ErrorTest", "正常应答解析失败");
+        return false;
+    }
+
+    // 字节数与请求的寄存器数量不符
+    const uint8_t shortCount[] = {0x01, 0x03, 0x02, 0x00, 0x0A};
+    driver.sendRequest(0x03, 0x0001, 2);
+    if (receiveResponse(driver, shortCount, sizeof(shortCount), values) ||
+        driver.getLastError() != ModbusRTUDriver::ERROR_INVALID_RESPONSE) {
+        LOG_TAG_ERROR("ErrorTest", "字节数错误未被识别");
+        return false;
+    }
+
+    // 其他从站的应答
+    const uint8_t otherSlave[] = {0x02, 0x03, 0x04, 0x00, 0x0A, 0x00, 0x0B};
+    driver.sendRequest(0x03, 0x0001, 2);
+    if (receiveResponse(driver, otherSlave, sizeof(otherSlave), values) ||
+        driver.getLastError() != ModbusRTUDriver::ERROR_INVALID_RESPONSE) {
+        LOG_TAG_ERROR("ErrorTest", "从站地址错误未被识别");
+        return false;
+    }
+
+    // CRC错误
+    driver.sendRequest(0x03, 0x0001, 2);
+    if (receiveResponse(driver, valid, sizeof(valid), values, true) ||
+        driver.getReceiver().getError() != ModbusFrameReceiver::FrameError::CRC_MISMATCH) {
+        LOG_TAG_ERROR("ErrorTest", "CRC错误的帧被接受");
+        return false;
+    }
+
+    // 异常应答：记录异常码
+    const uint8_t exception[] = {0x01, 0x83, ModbusRTUDriver::EXCEPTION_ILLEGAL_DATA_ADDRESS};
+    driver.sendRequest(0x03, 0x0001, 2);
+    if (receiveResponse(driver, exception, sizeof(exception), values) ||
+        driver.getLastError() != ModbusRTUDriver::ERROR_EXCEPTION ||
+        driver.getLastExceptionCode() != ModbusRTUDriver::EXCEPTION_ILLEGAL_DATA_ADDRESS ||
+        driver.getLastErrorString() != "Exception response: Illegal data address") {
+        LOG_TAG_ERROR("ErrorTest", "异常应答解析错误: %s", driver.getLastErrorString().c_str());
+        return false;
+    }
+
+    // 异常应答的功能码必须对应请求
+    const uint8_t wrongException[] = {0x01, 0x86, ModbusRTUDriver::EXCEPTION_ILLEGAL_DATA_ADDRESS};
+    driver.sendRequest(0x03, 0x0001, 2);
+    if (receiveResponse(driver, wrongException, sizeof(wrongException), values) ||
+        driver.getLastError() != ModbusRTUDriver::ERROR_INVALID_RESPONSE || driver.getLastExceptionCode() != 0) {
+        LOG_TAG_ERROR("ErrorTest", "功能码不符的异常应答未被识别");
+        return false;
+    }
+
+    // 写单个寄存器的回显不一致
+    const uint8_t badEcho[] = {0x01, 0x06, 0x00, 0x05, 0x00, 0x63};
+    driver.sendRequest(0x06, 0x0005, 1, values);
+    if (receiveResponse(driver, badEcho, sizeof(badEcho), nullptr) ||
+        driver.getLastError() != ModbusRTUDriver::ERROR_INVALID_RESPONSE) {
+        LOG_TAG_ERROR("ErrorTest", "写回显错误未被识别");
+        return false;
+    }
+
+    // 重试策略分类
+    if (ModbusRTUDriver::getRetryPolicy(ModbusRTUDriver::ERROR_EXCEPTION,
+                                        ModbusRTUDriver::EXCEPTION_ILLEGAL_FUNCTION) != ModbusRetryPolicy::NO_RETRY ||
+        ModbusRTUDriver::getRetryPolicy(ModbusRTUDriver::ERROR_EXCEPTION,
+                                        ModbusRTUDriver::EXCEPTION_SLAVE_DEVICE_BUSY) != ModbusRetryPolicy::DELAYED ||
+        ModbusRTUDriver::getRetryPolicy(ModbusRTUDriver::ERROR_CRC, 0) != ModbusRetryPolicy::IMMEDIATE ||
+        ModbusRTUDriver::getRetryPolicy(ModbusRTUDriver::ERROR_INVALID_RESPONSE, 0) != ModbusRetryPolicy::IMMEDIATE ||
+        ModbusRTUDriver::getRetryPolicy(ModbusRTUDriver::ERROR_TIMEOUT, 0) != ModbusRetryPolicy::DELAYED) {
+        LOG_TAG_ERROR("ErrorTest", "重试策略分类错误");
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusErrorTest::testSyncRetryPolicy() {
+    ModbusRTUDriver driver;
+    driver.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE, 0x01);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+    slave.setRegister(0x0005, 1234);
+
+    uint16_t value = 0;
+
+    // 非法地址：异常应答只发送一次
+    slave.rejectNextRequests(ModbusRTUDriver::EXCEPTION_ILLEGAL_DATA_ADDRESS, 1);
+    if (driver.readHoldingRegisters(0x0005, 1, &value) || slave.getRequestCount() != 1 ||
+        driver.getLastError() != ModbusRTUDriver::ERROR_EXCEPTION ||
+        driver.getLastExceptionCode() != ModbusRTUDriver::EXCEPTION_ILLEGAL_DATA_ADDRESS) {
+        LOG_TAG_ERROR("ErrorTest", "异常应答被重试 (请求%lu次)", slave.getRequestCount());
+        return false;
+    }
+
+    // 无故障时的单次事务耗时作为基准
+    slave.clearRequestLog();
+    uint64_t start = NativeHAL::nowMicros();
+    if (!driver.readHoldingRegisters(0x0005, 1, &value) || value != 1234) {
+        LOG_TAG_ERROR("ErrorTest", "正常读取失败");
+        return false;
+    }
+    uint64_t cleanUs = NativeHAL::nowMicros() - start;
+
+    // CRC错误不等待重试间隔：三次发送的耗时只多出重发前的线路静默等待（T3.5，按1ms轮询）
+    slave.clearRequestLog();
+    slave.corruptNextResponses(2);
+    start = NativeHAL::nowMicros();
+    if (!driver.readHoldingRegisters(0x0005, 1, &value) || value != 1234 || slave.getRequestCount() != 3) {
+        LOG_TAG_ERROR("ErrorTest", "CRC错误重试失败");
+        return false;
+    }
+    uint64_t corruptUs = NativeHAL::nowMicros() - start;
+    uint64_t silenceUs = 2 * (driver.getReceiver().getT35Micros() + 1000);
+    if (corruptUs > cleanUs * 3 + silenceUs + 2000) {
+        LOG_TAG_ERROR("ErrorTest", "CRC错误重试耗时过长: %lluus (单次%lluus)", corruptUs, cleanUs);
+        return false;
+    }
+
+    // 从站忙：等待重试间隔后成功
+    slave.clearRequestLog();
+    slave.rejectNextRequests(ModbusRTUDriver::EXCEPTION_SLAVE_DEVICE_BUSY, 1);
+    start = NativeHAL::nowMicros();
+    if (!driver.readHoldingRegisters(0x0005, 1, &value) || slave.getRequestCount() != 2 ||
+        NativeHAL::nowMicros() - start < cleanUs + ModbusRTUDriver::RETRY_DELAY_MS * 1000) {
+        LOG_TAG_ERROR("ErrorTest", "从站忙重试错误");
+        return false;
+    }
+
+    // 写入被拒绝时寄存器不变且不重试
+    slave.clearRequestLog();
+    slave.rejectNextRequests(ModbusRTUDriver::EXCEPTION_ILLEGAL_DATA_VALUE, 1);
+    if (driver.writeSingleRegister(0x0005, 99) || slave.getRequestCount() != 1 || slave.getRegister(0x0005) != 1234 ||
+        driver.getLastExceptionCode() != ModbusRTUDriver::EXCEPTION_ILLEGAL_DATA_VALUE) {
+        LOG_TAG_ERROR("ErrorTest", "写入异常处理错误");
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusErrorTest::testQueueRetryPolicy() {
+    ModbusRTUDriver driver;
+    driver.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE, 0x01);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+    slave.setRegister(0x0005, 1234);
+
+    ModbusTransactionQueue queue(driver);
+    // 较长的重试间隔便于区分立即重试和延时重试
+    queue.setRetryDelay(200);
+    ModbusResult last = {};
+    auto record = [&last](const ModbusResult& result) {
+        last = result;
+        last.values = nullptr;
+    };
+
+    // 异常应答：一次即失败并带回异常码
+    slave.rejectNextRequests(ModbusRTUDriver::EXCEPTION_ILLEGAL_FUNCTION, 1);
+    queue.submitRead(0x0005, 1, ModbusPriority::NORMAL, record);
+    pumpUntilIdle(queue);
+    if (last.success || last.attempts != 1 || last.error != ModbusRTUDriver::ERROR_EXCEPTION ||
+        last.exceptionCode != ModbusRTUDriver::EXCEPTION_ILLEGAL_FUNCTION) {
+        LOG_TAG_ERROR("ErrorTest", "队列异常应答处理错误: attempts=%u error=%u code=%u",
+                      last.attempts, last.error, last.exceptionCode);
+        return false;
+    }
+
+    // CRC错误：不等待200ms重试间隔
+    slave.corruptNextResponses(2);
+    queue.submitRead(0x0005, 1, ModbusPriority::NORMAL, record);
+    pumpUntilIdle(queue);
+    if (!last.success || last.attempts != 3 || last.elapsedMs >= 200 || last.exceptionCode != 0) {
+        LOG_TAG_ERROR("ErrorTest", "队列CRC重试错误: attempts=%u elapsed=%lums", last.attempts, last.elapsedMs);
+        return false;
+    }
+
+    // 从站忙：等待重试间隔
+    slave.rejectNextRequests(ModbusRTUDriver::EXCEPTION_SLAVE_DEVICE_BUSY, 1);
+    queue.submitRead(0x0005, 1, ModbusPriority::NORMAL, record);
+    pumpUntilIdle(queue);
+    if (!last.success || last.attempts != 2 || last.elapsedMs < 200) {
+        LOG_TAG_ERROR("ErrorTest", "队列从站忙重试错误: attempts=%u elapsed=%lums", last.attempts, last.elapsedMs);
+        return false;
+    }
+
+    // 超时仍按重试次数重试
+    slave.dropNextRequests(1);
+    queue.submitRead(0x0005, 1, ModbusPriority::NORMAL, record);
+    pumpUntilIdle(queue);
+    if (!last.success || last.attempts != 2) {
+        LOG_TAG_ERROR("ErrorTest", "队列超时重试错误");
+        return false;
+    }
+
+    const ModbusTransactionQueue::Statistics& stats = queue.getStatistics();
+    if (stats.exceptions != 2 || stats.crcErrors != 2 || stats.timeouts != 1 || stats.invalidResponses != 0 ||
+        stats.retries != 4 || stats.failed != 1 || stats.completed != 3) {
+        LOG_TAG_ERROR("ErrorTest", "分类统计错误: exceptions=%lu crc=%lu timeouts=%lu retries=%lu",
+                      static_cast<unsigned long>(stats.exceptions),
+                      static_cast<unsigned long>(stats.crcErrors),
+                      static_cast<unsigned long>(stats.timeouts),
+                      static_cast<unsigned long>(stats.retries));
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusErrorTest::testRetryAfterLineSilence() {
+    ModbusRTUDriver driver;
+    driver.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE, 0x01);
+    uint32_t t35Us = driver.getReceiver().getT35Micros();
+    uint16_t values[CorruptedByteCountSlave::QUANTITY];
+
+    // 同步接口
+    {
+        CorruptedByteCountSlave slave;
+        if (!driver.readHoldingRegisters(0x0000, CorruptedByteCountSlave::QUANTITY, values) ||
+            slave.requestCount != 2 || values[0] != 0x0001 ||
+            slave.requestMicros[1] < slave.corruptedEndMicros + t35Us) {
+            LOG_TAG_ERROR("ErrorTest", "同步重发过早: 请求%lu次, 重发于损坏应答结束后%lldus",
+                          static_cast<unsigned long>(slave.requestCount),
+                          static_cast<long long>(slave.requestMicros[1] - slave.corruptedEndMicros));
+            return false;
+        }
+    }
+
+    // 事务队列
+    {
+        CorruptedByteCountSlave slave;
+        ModbusTransactionQueue queue(driver);
+        ModbusResult last = {};
+        queue.submitRead(0x0000, CorruptedByteCountSlave::QUANTITY, ModbusPriority::NORMAL,
+                         [&last](const ModbusResult& result) {
+                             last = result;
+                             last.values = nullptr;
+                         });
+        pumpUntilIdle(queue);
+        if (!last.success || last.attempts != 2 || slave.requestCount != 2 ||
+            slave.requestMicros[1] < slave.corruptedEndMicros + t35Us ||
+            queue.getStatistics().crcErrors != 1) {
+            LOG_TAG_ERROR("ErrorTest", "队列重发过早: attempts=%u, 重发于损坏应答结束后%lldus", last.attempts,
+                          static_cast<long long>(slave.requestMicros[1] - slave.corruptedEndMicros));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ModbusErrorTest::testBusMasterExceptions() {
+    ModbusBusMaster bus;
+    bus.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+
+    // 轮询区间超出从站寄存器范围，每次都得到非法地址异常
+    bus.setPollInterval(100);
+    bus.setOfflineThreshold(3);
+    bus.addSlave(0x01, 0x0000, 1);
+    slave.rejectNextRequests(ModbusRTUDriver::EXCEPTION_ILLEGAL_DATA_ADDRESS, 0xFFFFFFFF);
+    for (uint32_t elapsedUs = 0; elapsedUs < 1000000; elapsedUs += STEP_MICROS) {
+        bus.update();
+        NativeHAL::advanceMicros(STEP_MICROS);
+    }
+
+    ModbusBusMaster::SlaveStatistics stats;
+    bus.getSlaveStatistics(0x01, stats);
+    if (!stats.online || stats.consecutiveFailures != 0 || stats.exceptions < 9 ||
+        stats.exceptions != stats.failures || stats.timeouts != 0 ||
+        stats.lastExceptionCode != ModbusRTUDriver::EXCEPTION_ILLEGAL_DATA_ADDRESS) {
+        LOG_TAG_ERROR("ErrorTest", "异常应答影响了在线判定: online=%d exceptions=%lu failures=%lu",
+                      stats.online, stats.exceptions, stats.failures);
+        return false;
+    }
+
+    // CRC错误仍计为失败
+    slave.rejectNextRequests(0, 0);
+    slave.corruptNextResponses(0xFFFFFFFF);
+    for (uint32_t elapsedUs = 0; elapsedUs < 1000000; elapsedUs += STEP_MICROS) {
+        bus.update();
+        NativeHAL::advanceMicros(STEP_MICROS);
+    }
+    bus.getSlaveStatistics(0x01, stats);
+    slave.corruptNextResponses(0);
+    if (stats.online || stats.crcErrors < 3) {
+        LOG_TAG_ERROR("ErrorTest", "CRC错误未使从站离线: crc=%lu", stats.crcErrors);
+        return false;
+    }
+
+    return true;
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,52 @@
+#ifndef MODBUS_ERROR_TEST_H
+#define MODBUS_ERROR_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * MODBUS应答校验与按错误类型重试测试（依赖模拟UART和模拟从站，仅在native环境运行）
+ */
+class ModbusErrorTest {
+public:
+    /**
+     * 运行所有错误处理测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试应答帧校验：从站地址、异常应答、字节数和回显
+     * @return 测试是否通过
+     */
+    static bool testResponseValidation();
+
+    /**
+     * 测试同步接口的重试策略：异常不重试，CRC错误立即重试，从站忙延时重试
+     * @return 测试是否通过
+     */
+    static bool testSyncRetryPolicy();
+
+    /**
+     * 测试事务队列的重试策略和分类统计
+     * @return 测试是否通过
+     */
+    static bool testQueueRetryPolicy();
+
+    /**
+     * 测试字节数被破坏、从站仍在发送时，同步接口和事务队列都等到线路静默T3.5后才重发
+     * @return 测试是否通过
+     */
+    static bool testRetryAfterLineSilence();
+
+    /**
+     * 测试异常应答不会使总线主站把从站判为离线
+     * @return 测试是否通过
+     */
+    static bool testBusMasterExceptions();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // MODBUS_ERROR_TEST_H
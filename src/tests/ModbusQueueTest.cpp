@@ -0,0 +1,383 @@
+#include "ModbusQueueTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <algorithm>
+#include "SimulatedModbusSlave.h"
+#include "../common/Logger.h"
+#include "../controllers/MotorModbusController.h"
+
+namespace {
+
+const uint32_t TEST_BAUD_RATE = 9600;
+
+// 主循环末尾的固定延时（与MainController::run()一致）
+const uint32_t LOOP_DELAY_MS = 10;
+
+// 模拟调速器寄存器 0x0001 ~ 0x000B
+void loadSpeedControllerRegisters(SimulatedModbusSlave& slave) {
+    const uint16_t values[] = {1, 0, 1, 10, 90, 30, 20, 0, 0x0001, 0x86A0, 55};
+    for (uint16_t i = 0; i < 11; i++) {
+        slave.setRegister(1 + i, values[i]);
+    }
+}
+
+} // namespace
+
+bool ModbusQueueTest::runAllTests() {
+    LOG_TAG_INFO("QueueTest", "开始MODBUS事务队列测试...");
+
+    bool allPassed = true;
+
+    if (!testPriorityOrder()) {
+        LOG_TAG_ERROR("QueueTest", "❌ 优先级测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("QueueTest", "✅ 优先级测试通过");
+    }
+
+    if (!testRetries()) {
+        LOG_TAG_ERROR("QueueTest", "❌ 重试测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("QueueTest", "✅ 重试测试通过");
+    }
+
+    if (!testQueueFull()) {
+        LOG_TAG_ERROR("QueueTest", "❌ 队列容量测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("QueueTest", "✅ 队列容量测试通过");
+    }
+
+    if (!testNonBlockingController()) {
+        LOG_TAG_ERROR("QueueTest", "❌ 非阻塞控制器测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("QueueTest", "✅ 非阻塞控制器测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("QueueTest", "🎉 所有MODBUS事务队列测试通过!");
+    } else {
+        LOG_TAG_ERROR("QueueTest", "💥 部分MODBUS事务队列测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool ModbusQueueTest::testPriorityOrder() {
+    ModbusRTUDriver driver;
+    driver.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE, 0x01);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+    loadSpeedControllerRegisters(slave);
+
+    ModbusTransactionQueue queue(driver);
+    std::vector<int> order;
+
+    // 按与优先级相反的顺序提交
+    queue.submitRead(0x0001, 11, ModbusPriority::BACKGROUND, [&order](const ModbusResult& result) {
+        order.push_back(result.success ? 2 : -1);
+    });
+    const uint16_t output[3] = {0x0000, 1000, 50};
+    queue.submitWriteMultiple(0x0009, 3, output, ModbusPriority::NORMAL, [&order](const ModbusResult& result) {
+        order.push_back(result.success ? 1 : -1);
+    });
+    queue.submitWriteSingle(0x0008, 1, ModbusPriority::URGENT, [&order](const ModbusResult& result) {
+        order.push_back(result.success ? 0 : -1);
+    });
+    queue.submitRead(0x0000, 1, ModbusPriority::BACKGROUND, [&order](const ModbusResult& result) {
+        order.push_back(result.success ? 3 : -1);
+    });
+
+    if (!pumpUntilIdle(queue)) {
+        LOG_TAG_ERROR("QueueTest", "事务未在限定时间内完成");
+        return false;
+    }
+
+    const std::vector<int> expected = {0, 1, 2, 3};
+    if (order != expected) {
+        LOG_TAG_ERROR("QueueTest", "完成顺序错误");
+        return false;
+    }
+
+    // 总线上的请求顺序同样按优先级
+    const std::vector<SimulatedModbusSlave::RequestRecord>& log = slave.getRequestLog();
+    if (log.size() != 4 || log[0].functionCode != 0x06 || log[1].functionCode != 0x10 ||
+        log[2].functionCode != 0x03 || log[2].address != 0x0001 || log[3].address != 0x0000) {
+        LOG_TAG_ERROR("QueueTest", "总线请求顺序错误");
+        return false;
+    }
+
+    if (slave.getRegister(0x0008) != 1 || slave.getRegister(0x000A) != 1000 || slave.getRegister(0x000B) != 50) {
+        LOG_TAG_ERROR("QueueTest", "写入结果错误");
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusQueueTest::testRetries() {
+    ModbusRTUDriver driver;
+    driver.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE, 0x01);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+    slave.setRegister(0x0005, 1234);
+
+    ModbusTransactionQueue queue(driver);
+    ModbusResult last = {};
+    uint16_t lastValue = 0;
+    auto record = [&last, &lastValue](const ModbusResult& result) {
+        last = result;
+        lastValue = result.values ? result.values[0] : 0;
+        last.values = nullptr;
+    };
+
+    // 前两次请求无应答，第三次成功
+    slave.dropNextRequests(2);
+    queue.submitRead(0x0005, 1, ModbusPriority::NORMAL, record);
+    pumpUntilIdle(queue);
+    if (!last.success || last.attempts != 3 || lastValue != 1234) {
+        LOG_TAG_ERROR("QueueTest", "超时重试结果错误: success=%d attempts=%u", last.success, last.attempts);
+        return false;
+    }
+
+    // 应答CRC错误后重试
+    slave.corruptNextResponses(1);
+    queue.submitRead(0x0005, 1, ModbusPriority::NORMAL, record);
+    pumpUntilIdle(queue);
+    if (!last.success || last.attempts != 2) {
+        LOG_TAG_ERROR("QueueTest", "CRC错误重试结果错误: success=%d attempts=%u", last.success, last.attempts);
+        return false;
+    }
+
+    // 重试耗尽
+    queue.setRetries(2);
+    slave.dropNextRequests(100);
+    queue.submitRead(0x0005, 1, ModbusPriority::NORMAL, record);
+    pumpUntilIdle(queue);
+    slave.dropNextRequests(0);
+    if (last.success || last.attempts != 3 || last.error != ModbusRTUDriver::ERROR_TIMEOUT) {
+        LOG_TAG_ERROR("QueueTest", "重试耗尽结果错误: success=%d attempts=%u error=%u",
+                      last.success, last.attempts, last.error);
+        return false;
+    }
+
+    const ModbusTransactionQueue::Statistics& stats = queue.getStatistics();
+    if (stats.completed != 2 || stats.failed != 1 || stats.retries != 5) {
+        LOG_TAG_ERROR("QueueTest", "统计错误: completed=%lu failed=%lu retries=%lu",
+                      static_cast<unsigned long>(stats.completed),
+                      static_cast<unsigned long>(stats.failed),
+                      static_cast<unsigned long>(stats.retries));
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusQueueTest::testQueueFull() {
+    ModbusRTUDriver driver;
+    driver.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE, 0x01);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+
+    ModbusTransactionQueue queue(driver);
+    uint32_t completed = 0;
+    auto count = [&completed](const ModbusResult& result) {
+        if (result.success) {
+            completed++;
+        }
+    };
+
+    for (uint8_t i = 0; i < ModbusTransactionQueue::QUEUE_CAPACITY; i++) {
+        if (!queue.submitRead(i, 1, ModbusPriority::BACKGROUND, count)) {
+            LOG_TAG_ERROR("QueueTest", "第%u个请求提交失败", i);
+            return false;
+        }
+    }
+
+    if (queue.submitRead(0, 1, ModbusPriority::URGENT, count)) {
+        LOG_TAG_ERROR("QueueTest", "队列已满时提交未被拒绝");
+        return false;
+    }
+
+    // 参数无效（0x06只能写一个寄存器）
+    const uint16_t values[2] = {1, 2};
+    if (queue.submitRead(0, 0, ModbusPriority::BACKGROUND, count) ||
+        queue.submitRead(0, ModbusTransactionQueue::MAX_REGISTERS + 1, ModbusPriority::BACKGROUND, count) ||
+        queue.submitTo(ModbusTransactionQueue::DEFAULT_SLAVE, 0x06, 0, 2, values, ModbusPriority::BACKGROUND,
+                       ModbusTransactionQueue::DEFAULT_RETRIES, count)) {
+        LOG_TAG_ERROR("QueueTest", "无效参数未被拒绝");
+        return false;
+    }
+
+    pumpUntilIdle(queue);
+
+    const ModbusTransactionQueue::Statistics& stats = queue.getStatistics();
+    if (completed != ModbusTransactionQueue::QUEUE_CAPACITY || stats.rejected != 4 ||
+        stats.maxDepth != ModbusTransactionQueue::QUEUE_CAPACITY) {
+        LOG_TAG_ERROR("QueueTest", "容量统计错误: completed=%lu rejected=%lu maxDepth=%u",
+                      static_cast<unsigned long>(completed),
+                      static_cast<unsigned long>(stats.rejected), stats.maxDepth);
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusQueueTest::testNonBlockingController() {
+    MotorModbusController controller;
+    controller.begin(0x01);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+    loadSpeedControllerRegisters(slave);
+    slave.setResponseDelayMicros(2000);
+
+    bool configDone = false;
+    bool startDone = false;
+    bool startBeforeConfig = false;
+    MotorModbusController::AllConfig config = {};
+
+    controller.requestAllConfig([&](bool success, const MotorModbusController::AllConfig& result, uint32_t) {
+        configDone = success;
+        config = result;
+    });
+    controller.requestStart([&](bool success) {
+        startDone = success;
+        startBeforeConfig = !configDone;
+    });
+
+    uint32_t iterations = 0;
+    while ((!configDone || !startDone) && iterations < 1000) {
+        uint64_t before = NativeHAL::nowMicros();
+        controller.update();
+        if (NativeHAL::nowMicros() != before) {
+            LOG_TAG_ERROR("QueueTest", "update()发生了等待");
+            return false;
+        }
+        NativeHAL::advanceMicros(1000);
+        iterations++;
+    }
+
+    if (!configDone || !startDone || !startBeforeConfig) {
+        LOG_TAG_ERROR("QueueTest", "异步读取/启动未按预期完成");
+        return false;
+    }
+    if (!config.externalSwitch || config.minOutput != 10 || config.maxOutput != 90 ||
+        config.frequency != 100000 || config.dutyCycle != 55) {
+        LOG_TAG_ERROR("QueueTest", "异步读取的配置错误");
+        return false;
+    }
+    if (slave.getRegister(0x0008) != 1) {
+        LOG_TAG_ERROR("QueueTest", "启动命令未写入");
+        return false;
+    }
+
+    // 不设置运行状态的配置写入分两段提交，运行状态寄存器保持不变
+    config.minOutput = 5;
+    config.frequency = 2000;
+    config.isRunning = false;
+    bool writeDone = false;
+    controller.requestSetAllConfig(config, false, [&writeDone](bool success) {
+        writeDone = success;
+    });
+    // 写入先在控制器中暂存，合并窗口到期后才进入队列
+    for (iterations = 0; !writeDone && iterations < 1000; iterations++) {
+        controller.update();
+        NativeHAL::advanceMicros(1000);
+    }
+
+    if (!writeDone || slave.getRegister(0x0004) != 5 || slave.getRegister(0x000A) != 2000 ||
+        slave.getRegister(0x0008) != 1) {
+        LOG_TAG_ERROR("QueueTest", "异步配置写入错误");
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusQueueTest::runLoopLatencyBenchmark() {
+    LOG_TAG_INFO("QueueTest", "开始主循环延迟对比（模拟BLE每200ms读取一次调速器配置，10%%请求丢失）...");
+
+    const uint32_t iterations = 2000;
+    const uint32_t readInterval = 20;
+
+    std::vector<uint32_t> syncSamples;
+    std::vector<uint32_t> asyncSamples;
+
+    for (int mode = 0; mode < 2; mode++) {
+        bool useQueue = mode == 1;
+        MotorModbusController controller;
+        controller.begin(0x01);
+        SimulatedModbusSlave slave(0x01);
+        slave.attach(Serial2);
+        loadSpeedControllerRegisters(slave);
+        slave.setResponseDelayMicros(2000);
+        slave.setDropEvery(10);
+
+        std::vector<uint32_t>& samples = useQueue ? asyncSamples : syncSamples;
+        samples.reserve(iterations);
+        bool pending = false;
+
+        for (uint32_t i = 0; i < iterations; i++) {
+            uint64_t start = NativeHAL::nowMicros();
+
+            if (i % readInterval == 0) {
+                if (useQueue) {
+                    if (!pending) {
+                        pending = controller.requestAllConfig(
+                            [&pending](bool, const MotorModbusController::AllConfig&, uint32_t) {
+                                pending = false;
+                            });
+                    }
+                } else {
+                    MotorModbusController::AllConfig config;
+                    controller.getAllConfig(config);
+                }
+            }
+            if (useQueue) {
+                controller.update();
+            }
+
+            samples.push_back(static_cast<uint32_t>(NativeHAL::nowMicros() - start));
+            delay(LOOP_DELAY_MS);
+        }
+    }
+
+    logPercentiles("同步读取", syncSamples);
+    logPercentiles("异步队列", asyncSamples);
+
+    std::sort(syncSamples.begin(), syncSamples.end());
+    std::sort(asyncSamples.begin(), asyncSamples.end());
+    return asyncSamples[iterations * 99 / 100] < syncSamples[iterations * 99 / 100];
+}
+
+bool ModbusQueueTest::pumpUntilIdle(ModbusTransactionQueue& queue, uint32_t maxIterations) {
+    for (uint32_t i = 0; i < maxIterations; i++) {
+        queue.process();
+        if (queue.isIdle()) {
+            return true;
+        }
+        NativeHAL::advanceMicros(1000);
+    }
+    return false;
+}
+
+void ModbusQueueTest::logPercentiles(const char* label, std::vector<uint32_t>& samples) {
+    if (samples.empty()) {
+        return;
+    }
+    std::vector<uint32_t> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+    LOG_TAG_INFO("QueueTest", "%s 单次循环阻塞(us): p50=%lu p90=%lu p99=%lu max=%lu",
+                 label,
+                 static_cast<unsigned long>(sorted[n * 50 / 100]),
+                 static_cast<unsigned long>(sorted[n * 90 / 100]),
+                 static_cast<unsigned long>(sorted[n * 99 / 100]),
+                 static_cast<unsigned long>(sorted[n - 1]));
+}
+
+#endif // NATIVE_BUILD
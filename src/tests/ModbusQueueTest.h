@@ -0,0 +1,66 @@
+#ifndef MODBUS_QUEUE_TEST_H
+#define MODBUS_QUEUE_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+#include <vector>
+#include "../drivers/ModbusTransactionQueue.h"
+
+/**
+ * MODBUS异步事务队列测试（依赖模拟UART和模拟从站，仅在native环境运行）
+ */
+class ModbusQueueTest {
+public:
+    /**
+     * 运行所有事务队列测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试优先级：启停控制先于配置写入，配置写入先于读取
+     * @return 测试是否通过
+     */
+    static bool testPriorityOrder();
+
+    /**
+     * 测试超时重试、CRC错误重试以及重试耗尽
+     * @return 测试是否通过
+     */
+    static bool testRetries();
+
+    /**
+     * 测试队列容量限制
+     * @return 测试是否通过
+     */
+    static bool testQueueFull();
+
+    /**
+     * 测试process()从不等待总线，以及异步读写配置
+     * @return 测试是否通过
+     */
+    static bool testNonBlockingController();
+
+    /**
+     * 主循环延迟对比：BLE读取调速器配置时同步读取与异步队列的单次循环阻塞时间分位数
+     * @return 异步方式的p99是否低于同步方式
+     */
+    static bool runLoopLatencyBenchmark();
+
+private:
+    /**
+     * 循环调用process()直到队列空闲
+     * @return 是否在限定次数内完成
+     */
+    static bool pumpUntilIdle(ModbusTransactionQueue& queue, uint32_t maxIterations = 1000);
+
+    /**
+     * 输出分位数
+     */
+    static void logPercentiles(const char* label, std::vector<uint32_t>& samples);
+};
+
+#endif // NATIVE_BUILD
+
+#endif // MODBUS_QUEUE_TEST_H
@@ -0,0 +1,393 @@
+#include "ModbusReceiverTest.h"
+#include "../common/Logger.h"
+
+#ifdef NATIVE_BUILD
+#include <NativeHAL.h>
+#include "../drivers/ModbusRTUDriver.h"
+#endif
+
+namespace {
+
+const uint32_t TEST_BAUD_RATE = 9600;
+const uint32_t TEST_START_MICROS = 1000000;
+
+} // namespace
+
+bool ModbusReceiverTest::runAllTests() {
+    LOG_TAG_INFO("RxTest", "开始MODBUS帧接收器测试...");
+
+    bool allPassed = true;
+
+    if (!testTimingParameters()) {
+        LOG_TAG_ERROR("RxTest", "❌ 时序参数测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("RxTest", "✅ 时序参数测试通过");
+    }
+
+    if (!testLengthBasedCompletion()) {
+        LOG_TAG_ERROR("RxTest", "❌ 按长度判定帧结束测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("RxTest", "✅ 按长度判定帧结束测试通过");
+    }
+
+    if (!testSilenceBasedCompletion()) {
+        LOG_TAG_ERROR("RxTest", "❌ 按T3.5静默判定帧结束测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("RxTest", "✅ 按T3.5静默判定帧结束测试通过");
+    }
+
+    if (!testExceptionFrame()) {
+        LOG_TAG_ERROR("RxTest", "❌ 异常应答帧测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("RxTest", "✅ 异常应答帧测试通过");
+    }
+
+    if (!testErrorsAndResync()) {
+        LOG_TAG_ERROR("RxTest", "❌ 错误帧及重新同步测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("RxTest", "✅ 错误帧及重新同步测试通过");
+    }
+
+#ifdef NATIVE_BUILD
+    if (!testDriverWithSimulatedBus()) {
+        LOG_TAG_ERROR("RxTest", "❌ 模拟总线驱动测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("RxTest", "✅ 模拟总线驱动测试通过");
+    }
+#endif
+
+    if (allPassed) {
+        LOG_TAG_INFO("RxTest", "🎉 所有MODBUS帧接收器测试通过!");
+    } else {
+        LOG_TAG_ERROR("RxTest", "💥 部分MODBUS帧接收器测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool ModbusReceiverTest::testTimingParameters() {
+    ModbusFrameReceiver receiver;
+
+    // 9600bps：字符时间1042us，T3.5约3.65ms
+    receiver.begin(9600);
+    if (receiver.getCharTimeMicros() != 1042 || receiver.getT35Micros() != 3647) {
+        LOG_TAG_ERROR("RxTest", "9600bps时序错误: char=%u T3.5=%u",
+                      receiver.getCharTimeMicros(), receiver.getT35Micros());
+        return false;
+    }
+
+    // 19200bps及以下按字符时间计算
+    receiver.begin(19200);
+    if (receiver.getT35Micros() != 1824) {
+        LOG_TAG_ERROR("RxTest", "19200bps T3.5错误: %u", receiver.getT35Micros());
+        return false;
+    }
+
+    // 高于19200bps使用固定值
+    receiver.begin(115200);
+    if (receiver.getT35Micros() != 1750) {
+        LOG_TAG_ERROR("RxTest", "115200bps T3.5错误: %u", receiver.getT35Micros());
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusReceiverTest::testLengthBasedCompletion() {
+    ModbusFrameReceiver receiver;
+    receiver.begin(TEST_BAUD_RATE);
+    uint32_t charTime = receiver.getCharTimeMicros();
+
+    // 读保持寄存器应答：3个寄存器
+    const uint8_t payload[] = {0x01, 0x03, 0x06, 0x00, 0x01, 0x00, 0x02, 0x00, 0x03};
+    uint8_t frame[16];
+    uint16_t frameLength = buildFrame(frame, payload, sizeof(payload));
+
+    // 前半帧到达，随后出现小于T3.5的间隔
+    uint32_t now = feedBytes(receiver, frame, 5, TEST_START_MICROS);
+    if (receiver.poll(now + receiver.getT35Micros() - 1) || !receiver.isReceiving()) {
+        LOG_TAG_ERROR("RxTest", "帧未收满时被误判为结束");
+        return false;
+    }
+
+    // 后半帧到达，最后一个字节到达即就绪，无需等待T3.5
+    now = feedBytes(receiver, frame + 5, frameLength - 5, now + receiver.getT35Micros() - 1 + charTime);
+    if (!receiver.poll(now)) {
+        LOG_TAG_ERROR("RxTest", "帧收满后未立即就绪, 状态=%d", static_cast<int>(receiver.getState()));
+        return false;
+    }
+    if (receiver.getFrameLength() != frameLength || memcmp(receiver.getFrame(), frame, frameLength) != 0) {
+        LOG_TAG_ERROR("RxTest", "帧内容错误: 长度%u", receiver.getFrameLength());
+        return false;
+    }
+
+    // 就绪帧取走前，多余字节不覆盖帧内容
+    receiver.feed(0xAA, now + charTime);
+    if (!receiver.isFrameReady() || receiver.getDroppedBytes() != 1) {
+        LOG_TAG_ERROR("RxTest", "就绪帧被后续字节破坏");
+        return false;
+    }
+
+    // 写单个寄存器应答（回显）固定8字节
+    receiver.reset();
+    const uint8_t writeEcho[] = {0x01, 0x06, 0x00, 0x0B, 0x00, 0x32};
+    frameLength = buildFrame(frame, writeEcho, sizeof(writeEcho));
+    now = feedBytes(receiver, frame, frameLength, now + 10 * charTime);
+    if (!receiver.isFrameReady() || receiver.getFrameLength() != 8) {
+        LOG_TAG_ERROR("RxTest", "写单个寄存器应答未就绪");
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusReceiverTest::testSilenceBasedCompletion() {
+    ModbusFrameReceiver receiver;
+    receiver.begin(TEST_BAUD_RATE);
+
+    // 未知功能码0x2B（设备标识），长度无法预知
+    const uint8_t payload[] = {0x01, 0x2B, 0x0E, 0x01, 0x01, 0x00, 0x00};
+    uint8_t frame[16];
+    uint16_t frameLength = buildFrame(frame, payload, sizeof(payload));
+
+    uint32_t now = feedBytes(receiver, frame, frameLength, TEST_START_MICROS);
+    if (receiver.poll(now + receiver.getT35Micros() - 1)) {
+        LOG_TAG_ERROR("RxTest", "静默不足T3.5时误判帧结束");
+        return false;
+    }
+    if (!receiver.poll(now + receiver.getT35Micros())) {
+        LOG_TAG_ERROR("RxTest", "T3.5静默后帧未就绪, 错误=%s",
+                      ModbusFrameReceiver::getErrorName(receiver.getError()));
+        return false;
+    }
+    if (receiver.getFrameLength() != frameLength) {
+        LOG_TAG_ERROR("RxTest", "帧长度错误: %u", receiver.getFrameLength());
+        return false;
+    }
+
+    // micros()回绕时静默判定仍然正确
+    receiver.reset();
+    now = feedBytes(receiver, frame, frameLength, 0xFFFFFFFFUL - 3 * receiver.getCharTimeMicros());
+    if (!receiver.poll(now + receiver.getT35Micros())) {
+        LOG_TAG_ERROR("RxTest", "micros()回绕时帧未就绪");
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusReceiverTest::testExceptionFrame() {
+    ModbusFrameReceiver receiver;
+    receiver.begin(TEST_BAUD_RATE);
+
+    // 读保持寄存器异常应答：非法数据地址
+    const uint8_t payload[] = {0x01, 0x83, 0x02};
+    uint8_t frame[8];
+    uint16_t frameLength = buildFrame(frame, payload, sizeof(payload));
+
+    feedBytes(receiver, frame, frameLength, TEST_START_MICROS);
+    if (!receiver.isFrameReady() || receiver.getFrameLength() != 5) {
+        LOG_TAG_ERROR("RxTest", "异常应答帧未按5字节完成");
+        return false;
+    }
+    if (receiver.getFrame()[1] != 0x83 || receiver.getFrame()[2] != 0x02) {
+        LOG_TAG_ERROR("RxTest", "异常应答帧内容错误");
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusReceiverTest::testErrorsAndResync() {
+    ModbusFrameReceiver receiver;
+    receiver.begin(TEST_BAUD_RATE);
+    uint32_t t35 = receiver.getT35Micros();
+
+    const uint8_t payload[] = {0x01, 0x03, 0x04, 0x12, 0x34, 0x56, 0x78};
+    uint8_t frame[16];
+    uint16_t frameLength = buildFrame(frame, payload, sizeof(payload));
+
+    // CRC错误
+    uint8_t corrupted[16];
+    memcpy(corrupted, frame, frameLength);
+    corrupted[4] ^= 0x01;
+    uint32_t now = feedBytes(receiver, corrupted, frameLength, TEST_START_MICROS);
+    if (!receiver.hasError() || receiver.getError() != ModbusFrameReceiver::FrameError::CRC_MISMATCH) {
+        LOG_TAG_ERROR("RxTest", "CRC错误未被检测");
+        return false;
+    }
+
+    // 错误帧之后紧跟的字节（间隔小于T3.5）应被丢弃
+    now = feedBytes(receiver, frame, 3, now + receiver.getCharTimeMicros());
+    if (!receiver.hasError()) {
+        LOG_TAG_ERROR("RxTest", "未等待总线静默就重新开始接收");
+        return false;
+    }
+
+    // T3.5静默后重新同步，正确接收下一帧
+    now = feedBytes(receiver, frame, frameLength, now + t35 + receiver.getCharTimeMicros());
+    if (!receiver.isFrameReady()) {
+        LOG_TAG_ERROR("RxTest", "静默后未能重新同步, 错误=%s",
+                      ModbusFrameReceiver::getErrorName(receiver.getError()));
+        return false;
+    }
+
+    // 截断帧：收到部分字节后出现T3.5静默
+    receiver.reset();
+    now = feedBytes(receiver, frame, frameLength - 2, now + t35);
+    if (receiver.poll(now + t35) || receiver.getError() != ModbusFrameReceiver::FrameError::TRUNCATED) {
+        LOG_TAG_ERROR("RxTest", "截断帧未被检测");
+        return false;
+    }
+
+    // 截断后静默已满足，下一帧直接开始
+    now = feedBytes(receiver, frame, frameLength, now + 2 * t35);
+    if (!receiver.isFrameReady()) {
+        LOG_TAG_ERROR("RxTest", "截断帧之后未能接收下一帧");
+        return false;
+    }
+
+    // 字节数字段导致帧长超出缓冲区
+    receiver.reset();
+    const uint8_t oversized[] = {0x01, 0x03, 0xFF};
+    feedBytes(receiver, oversized, sizeof(oversized), now + t35);
+    if (receiver.getError() != ModbusFrameReceiver::FrameError::INVALID_LENGTH) {
+        LOG_TAG_ERROR("RxTest", "超长帧未被检测");
+        return false;
+    }
+
+    return true;
+}
+
+#ifdef NATIVE_BUILD
+bool ModbusReceiverTest::testDriverWithSimulatedBus() {
+    ModbusRTUDriver driver;
+    if (!driver.begin(MODBUS_RX_PIN, MODBUS_TX_PIN, TEST_BAUD_RATE, 0x01)) {
+        LOG_TAG_ERROR("RxTest", "驱动初始化失败");
+        return false;
+    }
+    Serial2.simReset();
+
+    bool result = true;
+    uint32_t charTime = Serial2.simCharTimeUs();
+
+    // 1. 非阻塞poll()：应答逐字节到达期间每次调用都立即返回
+    const uint8_t echo[] = {0x01, 0x06, 0x00, 0x08, 0x00, 0x01};
+    uint8_t frame[16];
+    uint16_t frameLength = buildFrame(frame, echo, sizeof(echo));
+    Serial2.simInject(frame, frameLength);
+
+    uint64_t injectTime = NativeHAL::nowMicros();
+    uint32_t pollCount = 0;
+    bool ready = false;
+    while (!ready && pollCount < 1000) {
+        uint64_t before = NativeHAL::nowMicros();
+        ready = driver.poll();
+        if (NativeHAL::nowMicros() != before) {
+            LOG_TAG_ERROR("RxTest", "poll()发生了等待");
+            result = false;
+            break;
+        }
+        pollCount++;
+        if (!ready) {
+            NativeHAL::advanceMicros(100);
+        }
+    }
+    uint64_t readyDelay = NativeHAL::nowMicros() - injectTime;
+    if (!ready || driver.getFrameLength() != frameLength) {
+        LOG_TAG_ERROR("RxTest", "poll()未收到完整帧");
+        result = false;
+    } else if (readyDelay > frameLength * charTime + 100) {
+        LOG_TAG_ERROR("RxTest", "帧就绪延迟过大: %lluus", static_cast<unsigned long long>(readyDelay));
+        result = false;
+    }
+    driver.clearFrame();
+
+    // 2. 同步读取：模拟从站分两段发送应答（中间间隔小于T3.5），并在请求前残留噪声字节
+    Serial2.simSetTxHandler([charTime](const uint8_t* data, size_t length) {
+        if (length != 8 || data[1] != 0x03) {
+            return;
+        }
+        uint8_t response[32];
+        uint16_t quantity = (data[4] << 8) | data[5];
+        response[0] = data[0];
+        response[1] = 0x03;
+        response[2] = quantity * 2;
+        for (uint16_t i = 0; i < quantity; i++) {
+            response[3 + i * 2] = 0x00;
+            response[4 + i * 2] = static_cast<uint8_t>(i + 1);
+        }
+        uint16_t crc = ModbusCRC::calculate(response, 3 + quantity * 2);
+        response[3 + quantity * 2] = crc & 0xFF;
+        response[4 + quantity * 2] = (crc >> 8) & 0xFF;
+        uint16_t total = 5 + quantity * 2;
+
+        Serial2.simInject(response, 4, 500);
+        Serial2.simInject(response + 4, total - 4, 2 * charTime);
+    });
+
+    const uint8_t noise = 0x55;
+    Serial2.simInject(&noise, 1);
+    NativeHAL::advanceMicros(2 * charTime);
+
+    uint16_t values[11] = {0};
+    uint64_t start = NativeHAL::nowMicros();
+    bool readOk = driver.readHoldingRegisters(0x0001, 11, values);
+    uint64_t elapsed = NativeHAL::nowMicros() - start;
+
+    // 请求8字节 + 应答27字节 + 间隔，约39ms；旧实现需额外等待readBytes超时100ms
+    uint64_t expectedMax = (8 + 27 + 3) * charTime + 500 + 1000;
+    if (!readOk) {
+        LOG_TAG_ERROR("RxTest", "同步读取失败: %s", driver.getLastErrorString().c_str());
+        result = false;
+    } else {
+        for (uint16_t i = 0; i < 11; i++) {
+            if (values[i] != i + 1) {
+                LOG_TAG_ERROR("RxTest", "寄存器%u值错误: %u", i, values[i]);
+                result = false;
+                break;
+            }
+        }
+        if (elapsed > expectedMax) {
+            LOG_TAG_ERROR("RxTest", "同步读取耗时过长: %lluus > %lluus",
+                          static_cast<unsigned long long>(elapsed),
+                          static_cast<unsigned long long>(expectedMax));
+            result = false;
+        } else {
+            LOG_TAG_INFO("RxTest", "同步读取11个寄存器耗时: %lluus",
+                         static_cast<unsigned long long>(elapsed));
+        }
+    }
+
+    Serial2.simSetTxHandler(nullptr);
+    Serial2.simReset();
+    return result;
+}
+#endif
+
+uint32_t ModbusReceiverTest::feedBytes(ModbusFrameReceiver& receiver, const uint8_t* data, uint16_t length,
+                                       uint32_t startMicros) {
+    uint32_t now = startMicros;
+    for (uint16_t i = 0; i < length; i++) {
+        if (i > 0) {
+            now += receiver.getCharTimeMicros();
+        }
+        receiver.feed(data[i], now);
+        receiver.poll(now);
+    }
+    return now;
+}
+
+uint16_t ModbusReceiverTest::buildFrame(uint8_t* frame, const uint8_t* payload, uint16_t payloadLength) {
+    memcpy(frame, payload, payloadLength);
+    uint16_t crc = ModbusCRC::calculate(frame, payloadLength);
+    frame[payloadLength] = crc & 0xFF;
+    frame[payloadLength + 1] = (crc >> 8) & 0xFF;
+    return payloadLength + 2;
+}
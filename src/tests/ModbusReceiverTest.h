@@ -0,0 +1,68 @@
+#ifndef MODBUS_RECEIVER_TEST_H
+#define MODBUS_RECEIVER_TEST_H
+
+#include <Arduino.h>
+#include "../drivers/ModbusFrameReceiver.h"
+
+class ModbusReceiverTest {
+public:
+    /**
+     * 运行所有帧接收器测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试T3.5按波特率计算
+     * @return 测试是否通过
+     */
+    static bool testTimingParameters();
+
+    /**
+     * 测试已知功能码的帧收满即就绪，分段到达时中途不误判结束
+     * @return 测试是否通过
+     */
+    static bool testLengthBasedCompletion();
+
+    /**
+     * 测试未知功能码的帧以T3.5静默判定结束
+     * @return 测试是否通过
+     */
+    static bool testSilenceBasedCompletion();
+
+    /**
+     * 测试异常应答帧
+     * @return 测试是否通过
+     */
+    static bool testExceptionFrame();
+
+    /**
+     * 测试CRC错误、截断帧、超长帧，以及出错后的重新同步
+     * @return 测试是否通过
+     */
+    static bool testErrorsAndResync();
+
+#ifdef NATIVE_BUILD
+    /**
+     * 通过模拟UART测试驱动：非阻塞poll()和同步读写在模拟从站下的时序
+     * @return 测试是否通过
+     */
+    static bool testDriverWithSimulatedBus();
+#endif
+
+private:
+    /**
+     * 按字符时间逐字节喂入数据
+     * @return 最后一个字节的到达时间
+     */
+    static uint32_t feedBytes(ModbusFrameReceiver& receiver, const uint8_t* data, uint16_t length,
+                              uint32_t startMicros);
+
+    /**
+     * 构造带CRC的帧
+     * @return 帧总长度
+     */
+    static uint16_t buildFrame(uint8_t* frame, const uint8_t* payload, uint16_t payloadLength);
+};
+
+#endif // MODBUS_RECEIVER_TEST_H
@@ -0,0 +1,301 @@
+#include "ModbusWriteCombineTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include "SimulatedModbusSlave.h"
+#include "../common/Logger.h"
+
+namespace {
+
+// 模拟调速器寄存器 0x0000 ~ 0x000B
+void loadSpeedControllerRegisters(SimulatedModbusSlave& slave) {
+    const uint16_t values[] = {1, 1, 0, 1, 10, 90, 30, 20, 0, 0x0001, 0x86A0, 55};
+    for (uint16_t i = 0; i < 12; i++) {
+        slave.setRegister(i, values[i]);
+    }
+}
+
+} // namespace
+
+bool ModbusWriteCombineTest::runAllTests() {
+    LOG_TAG_INFO("CombineTest", "开始MODBUS写合并测试...");
+
+    bool allPassed = true;
+
+    if (!testBackToBackSetters()) {
+        LOG_TAG_ERROR("CombineTest", "❌ 连续setter合并测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("CombineTest", "✅ 连续setter合并测试通过");
+    }
+
+    if (!testSkipAndGapFill()) {
+        LOG_TAG_ERROR("CombineTest", "❌ 跳过相同值及空隙补齐测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("CombineTest", "✅ 跳过相同值及空隙补齐测试通过");
+    }
+
+    if (!testWindowAndFailure()) {
+        LOG_TAG_ERROR("CombineTest", "❌ 合并窗口及失败回调测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("CombineTest", "✅ 合并窗口及失败回调测试通过");
+    }
+
+    if (!testOverlappingBatches()) {
+        LOG_TAG_ERROR("CombineTest", "❌ 重叠批次测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("CombineTest", "✅ 重叠批次测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("CombineTest", "🎉 所有MODBUS写合并测试通过!");
+    } else {
+        LOG_TAG_ERROR("CombineTest", "💥 部分MODBUS写合并测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool ModbusWriteCombineTest::testBackToBackSetters() {
+    MotorModbusController controller;
+    controller.begin(0x01);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+    loadSpeedControllerRegisters(slave);
+
+    // 缓存为空：运行状态寄存器不能补齐，只能分成两帧
+    int callbacks = 0;
+    auto done = [&callbacks](bool success) {
+        if (success) {
+            callbacks++;
+        }
+    };
+    controller.requestFrequency(2000, done);
+    controller.requestDutyCycle(80, done);
+    controller.requestOutputLimits(5, 95, done);
+    controller.requestSoftTimes(40, 50, done);
+    pumpUntilIdle(controller);
+
+    const std::vector<SimulatedModbusSlave::RequestRecord>& log = slave.getRequestLog();
+    if (callbacks != 4 || log.size() != 2 || log[0].address != 0x0004 || log[1].address != 0x0009) {
+        LOG_TAG_ERROR("CombineTest", "应合并为两帧 (回调%d, 帧数%u)", callbacks, (unsigned)log.size());
+        return false;
+    }
+    if (slave.getRegister(0x0004) != 5 || slave.getRegister(0x0007) != 50 ||
+        slave.getRegister(0x000A) != 2000 || slave.getRegister(0x000B) != 80) {
+        LOG_TAG_ERROR("CombineTest", "从站寄存器值错误");
+        return false;
+    }
+
+    // 同一寄存器在窗口内多次写入只保留最后一次
+    slave.clearRequestLog();
+    controller.requestDutyCycle(10);
+    controller.requestDutyCycle(20);
+    controller.requestDutyCycle(30);
+    pumpUntilIdle(controller);
+    if (slave.getRequestCount() != 1 || slave.getRegister(0x000B) != 30) {
+        LOG_TAG_ERROR("CombineTest", "重复写入未合并");
+        return false;
+    }
+
+    // 完整配置推送（不含运行状态）：两帧
+    slave.clearRequestLog();
+    controller.invalidateCache();
+    MotorModbusController::AllConfig config = {};
+    config.externalSwitch = true;
+    config.minOutput = 15;
+    config.maxOutput = 85;
+    config.softStartTime = 10;
+    config.softStopTime = 10;
+    config.frequency = 3000;
+    config.dutyCycle = 60;
+    bool pushed = false;
+    controller.requestSetAllConfig(config, false, [&pushed](bool success) { pushed = success; });
+    pumpUntilIdle(controller);
+    if (!pushed || slave.getRequestCount() != 2 || slave.getRegister(0x0008) != 0) {
+        LOG_TAG_ERROR("CombineTest", "完整配置推送应为两帧且不改变运行状态 (帧数%lu)", slave.getRequestCount());
+        return false;
+    }
+
+    const MotorModbusController::WriteStatistics& stats = controller.getWriteStatistics();
+    LOG_TAG_INFO("CombineTest", "暂存寄存器%lu个，跳过%lu个，%lu个批次共%lu帧",
+                 stats.stagedRegisters, stats.skippedRegisters, stats.flushes, stats.frames);
+    return true;
+}
+
+bool ModbusWriteCombineTest::testSkipAndGapFill() {
+    MotorModbusController controller;
+    controller.begin(0x01);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+    loadSpeedControllerRegisters(slave);
+
+    MotorModbusController::AllConfig config;
+    if (!controller.getAllConfig(config)) {
+        LOG_TAG_ERROR("CombineTest", "读取所有配置失败");
+        return false;
+    }
+
+    // 与缓存完全相同的配置不访问总线，回调仍报告成功
+    slave.clearRequestLog();
+    bool unchanged = false;
+    controller.requestSetAllConfig(config, false, [&unchanged](bool success) { unchanged = success; });
+    pumpUntilIdle(controller);
+    if (!unchanged || slave.getRequestCount() != 0) {
+        LOG_TAG_ERROR("CombineTest", "相同配置不应发送 (帧数%lu)", slave.getRequestCount());
+        return false;
+    }
+
+    // 只改最小输出和缓停止时间：中间两个寄存器用缓存值补齐，合并为一帧
+    config.minOutput = 20;
+    config.softStopTime = 99;
+    bool changed = false;
+    controller.requestSetAllConfig(config, false, [&changed](bool success) { changed = success; });
+    pumpUntilIdle(controller);
+    const std::vector<SimulatedModbusSlave::RequestRecord>& log = slave.getRequestLog();
+    if (!changed || log.size() != 1 || log[0].functionCode != 0x10 || log[0].address != 0x0004) {
+        LOG_TAG_ERROR("CombineTest", "应合并为从0x0004开始的一帧");
+        return false;
+    }
+    if (slave.getRegister(0x0004) != 20 || slave.getRegister(0x0005) != 90 ||
+        slave.getRegister(0x0006) != 30 || slave.getRegister(0x0007) != 99) {
+        LOG_TAG_ERROR("CombineTest", "补齐的寄存器值错误");
+        return false;
+    }
+
+    // 运行状态不用缓存值补齐：频率和缓停止时间分成两帧
+    slave.clearRequestLog();
+    controller.requestSoftTimes(30, 10);
+    controller.requestFrequency(500);
+    pumpUntilIdle(controller);
+    if (slave.getRequestCount() != 2) {
+        LOG_TAG_ERROR("CombineTest", "运行状态寄存器不应被补齐 (帧数%lu)", slave.getRequestCount());
+        return false;
+    }
+
+    return controller.getWriteStatistics().skippedRegisters >= 10;
+}
+
+bool ModbusWriteCombineTest::testWindowAndFailure() {
+    MotorModbusController controller;
+    controller.begin(0x01);
+    controller.setWriteCombineWindow(50);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+    loadSpeedControllerRegisters(slave);
+
+    // 窗口到期前只暂存，不发送
+    controller.requestDutyCycle(40);
+    for (int i = 0; i < 40; i++) {
+        controller.update();
+        NativeHAL::advanceMicros(1000);
+    }
+    if (slave.getRequestCount() != 0) {
+        LOG_TAG_ERROR("CombineTest", "合并窗口内不应发送");
+        return false;
+    }
+    pumpUntilIdle(controller);
+    if (slave.getRequestCount() != 1 || slave.getRegister(0x000B) != 40) {
+        LOG_TAG_ERROR("CombineTest", "窗口到期后应发送");
+        return false;
+    }
+
+    // flushWrites()立即提交
+    controller.requestDutyCycle(45);
+    controller.flushWrites();
+    for (int i = 0; i < 200 && slave.getRegister(0x000B) != 45; i++) {
+        controller.update();
+        NativeHAL::advanceMicros(1000);
+    }
+    if (slave.getRegister(0x000B) != 45) {
+        LOG_TAG_ERROR("CombineTest", "flushWrites()未立即提交");
+        return false;
+    }
+
+    // 从站无应答：批次内所有回调都收到失败
+    slave.dropNextRequests(100);
+    int failures = 0;
+    auto failed = [&failures](bool success) {
+        if (!success) {
+            failures++;
+        }
+    };
+    controller.requestFrequency(1234, failed);
+    controller.requestSoftTimes(1, 2, failed);
+    pumpUntilIdle(controller, 20000);
+    slave.dropNextRequests(0);
+    if (failures != 2) {
+        LOG_TAG_ERROR("CombineTest", "写失败时回调应报告失败 (失败回调%d)", failures);
+        return false;
+    }
+
+    return true;
+}
+
+bool ModbusWriteCombineTest::testOverlappingBatches() {
+    MotorModbusController controller;
+    controller.begin(0x01);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+    loadSpeedControllerRegisters(slave);
+
+    MotorModbusController::AllConfig config;
+    if (!controller.getAllConfig(config)) {
+        LOG_TAG_ERROR("CombineTest", "读取所有配置失败");
+        return false;
+    }
+
+    slave.clearRequestLog();
+
+    // 第一批次写入在途时改回缓存中的频率：缓存尚未更新，不能当作无变化跳过
+    controller.requestFrequency(100);
+    controller.flushWrites();
+    controller.requestFrequency(config.frequency);
+    controller.flushWrites();
+    pumpUntilIdle(controller);
+    uint32_t frequency = ((uint32_t)slave.getRegister(0x0009) << 16) | slave.getRegister(0x000A);
+    if (frequency != config.frequency || slave.getRequestCount() != 2) {
+        LOG_TAG_ERROR("CombineTest", "改回的频率被跳过 (从站频率%lu, 帧数%lu)",
+                      (unsigned long)frequency, slave.getRequestCount());
+        return false;
+    }
+
+    // 第二批次的完整配置覆盖在途的缓启停时间，并补齐到同一帧
+    slave.clearRequestLog();
+    controller.requestSoftTimes(40, 50);
+    controller.flushWrites();
+    config.minOutput = 25;
+    bool pushed = false;
+    controller.requestSetAllConfig(config, false, [&pushed](bool success) { pushed = success; });
+    controller.flushWrites();
+    pumpUntilIdle(controller);
+    const std::vector<SimulatedModbusSlave::RequestRecord>& log = slave.getRequestLog();
+    if (!pushed || log.size() != 2 || log[1].address != 0x0004) {
+        LOG_TAG_ERROR("CombineTest", "第二批次应为从0x0004开始的一帧 (帧数%u)", (unsigned)log.size());
+        return false;
+    }
+    if (slave.getRegister(0x0004) != 25 || slave.getRegister(0x0006) != config.softStartTime ||
+        slave.getRegister(0x0007) != config.softStopTime) {
+        LOG_TAG_ERROR("CombineTest", "在途写入覆盖了后提交的值");
+        return false;
+    }
+
+    return true;
+}
+
+void ModbusWriteCombineTest::pumpUntilIdle(MotorModbusController& controller, uint32_t maxIterations) {
+    for (uint32_t i = 0; i < maxIterations; i++) {
+        controller.update();
+        NativeHAL::advanceMicros(1000);
+        // 合并窗口已过且队列空闲
+        if (i > 100 && controller.getTransactionQueue().isIdle()) {
+            return;
+        }
+    }
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,53 @@
+#ifndef MODBUS_WRITE_COMBINE_TEST_H
+#define MODBUS_WRITE_COMBINE_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+#include "../controllers/MotorModbusController.h"
+
+/**
+ * MotorModbusController写合并测试（依赖模拟UART和模拟从站，仅在native环境运行）
+ */
+class ModbusWriteCombineTest {
+public:
+    /**
+     * 运行所有写合并测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试连续调用多个setter被合并为最少的连续写帧
+     * @return 测试是否通过
+     */
+    static bool testBackToBackSetters();
+
+    /**
+     * 测试与缓存值相同的寄存器被跳过，以及用缓存值补齐帧间空隙
+     * @return 测试是否通过
+     */
+    static bool testSkipAndGapFill();
+
+    /**
+     * 测试合并窗口到期前不发送，以及写失败时回调收到失败
+     * @return 测试是否通过
+     */
+    static bool testWindowAndFailure();
+
+    /**
+     * 测试前一批次写入仍在途时提交的批次不依据过时的缓存跳过寄存器
+     * @return 测试是否通过
+     */
+    static bool testOverlappingBatches();
+
+private:
+    /**
+     * 循环调用update()直到暂存写入全部完成
+     */
+    static void pumpUntilIdle(MotorModbusController& controller, uint32_t maxIterations = 2000);
+};
+
+#endif // NATIVE_BUILD
+
+#endif // MODBUS_WRITE_COMBINE_TEST_H
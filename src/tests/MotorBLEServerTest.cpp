@@ -158,8 +158,26 @@ void MotorBLEServerTest::testConfigHandling() {
     bleServer.handleStopIntervalWrite("8");
     
     MotorConfig newConfig = configManager.getConfig();
-    MB_TEST_ASSERT_EQUAL_UINT32(150, newConfig.runDuration);
-    MB_TEST_ASSERT_EQUAL_UINT32(8, newConfig.stopDuration);
+    MB_TEST_ASSERT_EQUAL_UINT32(150000, newConfig.runDurationMs);
+    MB_TEST_ASSERT_EQUAL_UINT32(8000, newConfig.stopDurationMs);
+    
+    // 亚秒级和超过999秒的时长
+    bleServer.handleRunDurationWrite("0.25");
+    bleServer.handleStopIntervalWrite("3600");
+    newConfig = configManager.getConfig();
+    MB_TEST_ASSERT_EQUAL_UINT32(250, newConfig.runDurationMs);
+    MB_TEST_ASSERT_EQUAL_UINT32(3600000, newConfig.stopDurationMs);
+    MB_TEST_ASSERT_TRUE(MotorBLEServer::formatDurationSeconds(250) == "0.25");
+    MB_TEST_ASSERT_TRUE(MotorBLEServer::formatDurationSeconds(3600000) == "3600");
+    
+    // 无效格式和越界值被拒绝
+    uint32_t durationMs = 0;
+    MB_TEST_ASSERT_FALSE(MotorBLEServer::parseDurationMs("0.0005", durationMs));
+    MB_TEST_ASSERT_FALSE(MotorBLEServer::parseDurationMs("1.2.3", durationMs));
+    MB_TEST_ASSERT_FALSE(MotorBLEServer::parseDurationMs("abc", durationMs));
+    MB_TEST_ASSERT_FALSE(MotorBLEServer::parseDurationMs("604800.001", durationMs));
+    MB_TEST_ASSERT_TRUE(MotorBLEServer::parseDurationMs("604800", durationMs));
+    MB_TEST_ASSERT_EQUAL_UINT32(MOTOR_MAX_DURATION_MS, durationMs);
     // 注意：autoStart 不能通过BLE特征值直接设置，需要其他方式
     
     // 恢复原始配置
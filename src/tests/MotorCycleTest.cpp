@@ -10,8 +10,8 @@ bool MotorCycleTest::testBasicCycle() {
     
     // 设置测试配置
     MotorConfig testConfig;
-    testConfig.runDuration = 3;       // 3秒运行
-    testConfig.stopDuration = 2;      // 2秒停止
+    testConfig.runDurationMs = 3000;       // 3秒运行
+    testConfig.stopDurationMs = 2000;      // 2秒停止
     testConfig.cycleCount = 3;        // 循环3次
     testConfig.autoStart = false;     // 手动启动
     
@@ -29,7 +29,7 @@ bool MotorCycleTest::testBasicCycle() {
     motor.resetCycleCount();
     
     LOG_TAG_INFO("MotorCycleTest", "配置: 运行%ums, 停止%ums, 循环%u次", 
-                 testConfig.runDuration, testConfig.stopDuration, testConfig.cycleCount);
+                 testConfig.runDurationMs, testConfig.stopDurationMs, testConfig.cycleCount);
     
     // 启动电机
     if (!motor.startMotor()) {
@@ -88,8 +88,8 @@ bool MotorCycleTest::testContinuousMode() {
     
     // 设置测试配置
     MotorConfig testConfig;
-    testConfig.runDuration = 2;       // 2秒运行
-    testConfig.stopDuration = 1;      // 1秒停止（最小值，不能为0）
+    testConfig.runDurationMs = 2000;       // 2秒运行
+    testConfig.stopDurationMs = 1000;      // 1秒停止（最小值，不能为0）
     testConfig.cycleCount = 5;        // 循环5次
     testConfig.autoStart = false;     // 手动启动
     
@@ -107,7 +107,7 @@ bool MotorCycleTest::testContinuousMode() {
     motor.resetCycleCount();
     
     LOG_TAG_INFO("MotorCycleTest", "配置: 运行%ums, 停止%ums (持续模式), 循环%u次", 
-                 testConfig.runDuration, testConfig.stopDuration, testConfig.cycleCount);
+                 testConfig.runDurationMs, testConfig.stopDurationMs, testConfig.cycleCount);
     
     // 启动电机
     if (!motor.startMotor()) {
@@ -159,8 +159,8 @@ bool MotorCycleTest::testInfiniteMode() {
     
     // 设置测试配置
     MotorConfig testConfig;
-    testConfig.runDuration = 1;       // 1秒运行
-    testConfig.stopDuration = 1;      // 1秒停止
+    testConfig.runDurationMs = 1000;       // 1秒运行
+    testConfig.stopDurationMs = 1000;      // 1秒停止
     testConfig.cycleCount = 0;        // 0表示无限循环
     testConfig.autoStart = false;     // 手动启动
     
@@ -178,7 +178,7 @@ bool MotorCycleTest::testInfiniteMode() {
     motor.resetCycleCount();
     
     LOG_TAG_INFO("MotorCycleTest", "配置: 运行%ums, 停止%ums, 无限循环", 
-                 testConfig.runDuration, testConfig.stopDuration);
+                 testConfig.runDurationMs, testConfig.stopDurationMs);
     
     // 启动电机
     if (!motor.startMotor()) {
@@ -233,8 +233,8 @@ bool MotorCycleTest::testConfigUpdate() {
     
     // 初始配置
     MotorConfig testConfig;
-    testConfig.runDuration = 2;       // 2秒运行
-    testConfig.stopDuration = 1;      // 1秒停止
+    testConfig.runDurationMs = 2000;       // 2秒运行
+    testConfig.stopDurationMs = 1000;      // 1秒停止
     testConfig.cycleCount = 0;        // 无限循环
     testConfig.autoStart = false;     // 手动启动
     
@@ -268,13 +268,13 @@ bool MotorCycleTest::testConfigUpdate() {
     LOG_TAG_INFO("MotorCycleTest", "更新前循环次数: %u", cyclesBeforeUpdate);
     
     // 动态更新配置
-    testConfig.runDuration = 1;       // 改为1秒运行
-    testConfig.stopDuration = 1;      // 改为1秒停止
+    testConfig.runDurationMs = 1000;       // 改为1秒运行
+    testConfig.stopDurationMs = 1000;      // 改为1秒停止
     testConfig.cycleCount = cyclesBeforeUpdate + 3; // 设置循环次数限制
     
     motor.updateConfig(testConfig);
     LOG_TAG_INFO("MotorCycleTest", "配置已更新: 运行%ums, 停止%ums, 循环%u次", 
-                 testConfig.runDuration, testConfig.stopDuration, testConfig.cycleCount);
+                 testConfig.runDurationMs, testConfig.stopDurationMs, testConfig.cycleCount);
     
     // 继续运行直到完成
     while (millis() - startTime < 10000) {
@@ -0,0 +1,466 @@
+#include "MotorPWMTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <vector>
+#include "../common/RampGenerator.h"
+#include "../common/DeadlineScheduler.h"
+#include "../common/Logger.h"
+#include "../controllers/ConfigManager.h"
+#include "../controllers/MotorController.h"
+#include "../controllers/MotorPWMController.h"
+
+namespace {
+
+const uint32_t FULL_COUNTS = 1UL << MOTOR_PWM_RESOLUTION_BITS;
+
+/**
+ * 电机PWM通道的占空比写入记录（换算为电机开启的计数）
+ */
+struct DutyWrite {
+    uint32_t onCounts;
+    uint64_t timeUs;
+};
+
+std::vector<DutyWrite> g_writes;
+
+uint32_t toOnCounts(uint32_t duty) {
+    return MOTOR_ON == LOW ? FULL_COUNTS - duty : duty;
+}
+
+void recordWrites() {
+    g_writes.clear();
+    NativeHAL::setLEDCWriteHook([](uint8_t channel, uint32_t duty, uint64_t timeUs) {
+        if (channel == MOTOR_PWM_CHANNEL) {
+            g_writes.push_back(DutyWrite{toOnCounts(duty), timeUs});
+        }
+    });
+}
+
+void stopRecording() {
+    NativeHAL::setLEDCWriteHook(nullptr);
+}
+
+uint32_t currentOnCounts() {
+    return toOnCounts(NativeHAL::getLEDCDuty(MOTOR_PWM_CHANNEL));
+}
+
+/**
+ * 线性斜坡在t时刻的精确值（整数除法）
+ */
+int64_t linearAt(int64_t from, int64_t to, uint64_t startUs, uint64_t durationUs, uint64_t t) {
+    if (t >= startUs + durationUs) {
+        return to;
+    }
+    return from + (to - from) * (int64_t)(t - startUs) / (int64_t)durationUs;
+}
+
+/**
+ * 按PWM控制器给出的更新时刻推进，直到斜坡结束
+ */
+void runRamp(MotorPWMController& pwm) {
+    for (int guard = 0; guard < 10000 && pwm.isRamping(); guard++) {
+        NativeHAL::advanceMicros(pwm.getMicrosUntilNextUpdate(NativeHAL::nowMicros()));
+        pwm.update(NativeHAL::nowMicros());
+    }
+}
+
+/**
+ * 检查从fromIndex开始的写入是一段从from到to、起点为startUs、时长为durationUs的线性斜坡
+ */
+bool checkRampWrites(size_t fromIndex, uint32_t from, uint32_t to, uint64_t startUs, uint64_t durationUs, const char* label) {
+    if (fromIndex >= g_writes.size()) {
+        LOG_TAG_ERROR("PWMTest", "%s: 没有占空比写入", label);
+        return false;
+    }
+    for (size_t i = fromIndex; i < g_writes.size(); i++) {
+        const DutyWrite& write = g_writes[i];
+        int64_t expected = linearAt(from, to, startUs, durationUs, write.timeUs);
+        int64_t error = (int64_t)write.onCounts - expected;
+        if (error > 1 || error < -1) {
+            LOG_TAG_ERROR("PWMTest", "%s: t=%luus 输出%lu, 应为%ld", label,
+                          (uint32_t)(write.timeUs - startUs), write.onCounts, (long)expected);
+            return false;
+        }
+        if (i > fromIndex) {
+            const DutyWrite& previous = g_writes[i - 1];
+            bool monotonic = to >= from ? write.onCounts >= previous.onCounts : write.onCounts <= previous.onCounts;
+            bool isLast = i + 1 == g_writes.size();
+            if (!monotonic || (!isLast && write.timeUs - previous.timeUs < MOTOR_PWM_RAMP_INTERVAL_MICROS)) {
+                LOG_TAG_ERROR("PWMTest", "%s: 第%u次写入不单调或间隔过短 (%luus)", label, (unsigned)i,
+                              (uint32_t)(write.timeUs - previous.timeUs));
+                return false;
+            }
+        }
+    }
+    const DutyWrite& last = g_writes.back();
+    if (last.onCounts != to || last.timeUs != startUs + durationUs) {
+        LOG_TAG_ERROR("PWMTest", "%s: 结束于%luus, 输出%lu (应为%luus, %lu)", label,
+                      (uint32_t)(last.timeUs - startUs), last.onCounts, (uint32_t)durationUs, to);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 第一次输出到达value的时刻
+ */
+bool findReach(size_t fromIndex, uint32_t value, size_t& index) {
+    for (size_t i = fromIndex; i < g_writes.size(); i++) {
+        if (g_writes[i].onCounts == value) {
+            index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+MotorConfig makePWMConfig(uint32_t runMs, uint32_t stopMs, uint32_t cycles, bool autoStart) {
+    MotorConfig config;
+    config.runDurationMs = runMs;
+    config.stopDurationMs = stopMs;
+    config.cycleCount = cycles;
+    config.autoStart = autoStart;
+    config.outputMode = MotorOutputMode::PWM;
+    config.pwmFrequency = 1000;
+    config.pwmDutyCycle = 100;
+    config.softStartMs = 200;
+    config.softStopMs = 100;
+    return config;
+}
+
+/**
+ * 按截止时间驱动的主循环
+ */
+void runDeadlineLoop(MotorController& motor, uint64_t durationUs) {
+    uint64_t end = NativeHAL::nowMicros() + durationUs;
+    for (int guard = 0; guard < 10000 && NativeHAL::nowMicros() < end; guard++) {
+        motor.update();
+        uint64_t remaining = end - NativeHAL::nowMicros();
+        uint32_t wait = motor.getMicrosUntilNextUpdate();
+        NativeHAL::advanceMicros(wait < remaining ? wait : remaining);
+    }
+}
+
+/**
+ * 让电机以GPIO开关输出停在STOPPED状态且不自动启动
+ */
+bool resetMotor(MotorController& motor) {
+    if (!motor.init()) {
+        return false;
+    }
+    MotorConfig config;
+    config.autoStart = false;
+    motor.setPhaseTimerEnabled(true);
+    motor.updateConfig(config);
+    motor.stopMotor();
+    for (int i = 0; i < 5 && !motor.isStopped(); i++) {
+        motor.update();
+        NativeHAL::advanceMicros(1000);
+    }
+    motor.resetCycleCount();
+    return motor.isStopped() && motor.getOutputMode() == MotorOutputMode::SWITCH &&
+           NativeHAL::getPinLevel(MOTOR_PIN) == MOTOR_OFF;
+}
+
+} // namespace
+
+bool MotorPWMTest::runAllTests() {
+    LOG_TAG_INFO("PWMTest", "开始PWM输出测试...");
+
+    bool allPassed = true;
+
+    if (!testRampGenerator()) {
+        LOG_TAG_ERROR("PWMTest", "❌ 定点斜坡测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("PWMTest", "✅ 定点斜坡测试通过");
+    }
+
+    if (!testPWMOutputRamp()) {
+        LOG_TAG_ERROR("PWMTest", "❌ PWM缓启动/缓停止测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("PWMTest", "✅ PWM缓启动/缓停止测试通过");
+    }
+
+    if (!testControllerPWMMode()) {
+        LOG_TAG_ERROR("PWMTest", "❌ 电机控制器PWM输出方式测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("PWMTest", "✅ 电机控制器PWM输出方式测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("PWMTest", "🎉 所有PWM输出测试通过!");
+    } else {
+        LOG_TAG_ERROR("PWMTest", "💥 部分PWM输出测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool MotorPWMTest::testRampGenerator() {
+    RampGenerator ramp;
+    ramp.reset(0);
+
+    // 0 -> 1000，历时1秒：逐微秒检查单调、不超前、误差不超过1
+    ramp.start(1000, 1000000, 5000);
+    int32_t previous = 0;
+    for (uint64_t t = 5000; t < 1005000; t += 7) {
+        int32_t value = ramp.valueAt(t);
+        int64_t exact = linearAt(0, 1000, 5000, 1000000, t);
+        if (value < previous || value > exact || exact - value > 1) {
+            LOG_TAG_ERROR("PWMTest", "上升斜坡 t=%lu: %ld (精确值%ld)", (uint32_t)t, (long)value, (long)exact);
+            return false;
+        }
+        previous = value;
+    }
+    if (ramp.valueAt(1004999) == 1000 || ramp.valueAt(1005000) != 1000) {
+        LOG_TAG_ERROR("PWMTest", "上升斜坡应恰好在结束时刻到达目标");
+        return false;
+    }
+
+    // 中途改为下降：输出从改目标时刻的值连续变化
+    ramp.update(505000);
+    if (ramp.getValue() != 500 || !ramp.isActive()) {
+        LOG_TAG_ERROR("PWMTest", "斜坡中点应为500 (实际%ld)", (long)ramp.getValue());
+        return false;
+    }
+    ramp.start(-1500, 1000000, 505000);
+    if (ramp.valueAt(505000) != 500 || ramp.valueAt(1005000) != -500 || ramp.valueAt(1505000) != -1500) {
+        LOG_TAG_ERROR("PWMTest", "改目标后斜坡错误: %ld %ld %ld", (long)ramp.valueAt(505000),
+                      (long)ramp.valueAt(1005000), (long)ramp.valueAt(1505000));
+        return false;
+    }
+    previous = 500;
+    for (uint64_t t = 505000; t <= 1505000; t += 13) {
+        int32_t value = ramp.valueAt(t);
+        int64_t exact = linearAt(500, -1500, 505000, 1000000, t);
+        if (value > previous || value < exact || value - exact > 1) {
+            LOG_TAG_ERROR("PWMTest", "下降斜坡 t=%lu: %ld (精确值%ld)", (uint32_t)t, (long)value, (long)exact);
+            return false;
+        }
+        previous = value;
+    }
+    if (!ramp.update(3000000) || ramp.isActive() || ramp.getValue() != -1500 || ramp.update(4000000)) {
+        LOG_TAG_ERROR("PWMTest", "斜坡结束后应停在目标值");
+        return false;
+    }
+
+    // 时长为0或已在目标值时立即到达
+    ramp.start(42, 0, 4000000);
+    if (ramp.isActive() || ramp.getValue() != 42) {
+        LOG_TAG_ERROR("PWMTest", "时长为0时应立即到达目标");
+        return false;
+    }
+    ramp.start(42, 1000, 4000000);
+    if (ramp.isActive()) {
+        LOG_TAG_ERROR("PWMTest", "已在目标值时不应开始斜坡");
+        return false;
+    }
+
+    // 长斜坡（约1.8小时）不溢出
+    ramp.reset(0);
+    ramp.start(FULL_COUNTS, 6553500000ULL, 0);
+    if (ramp.valueAt(3276750000ULL) != (int32_t)FULL_COUNTS / 2 || ramp.valueAt(6553500000ULL) != (int32_t)FULL_COUNTS) {
+        LOG_TAG_ERROR("PWMTest", "长斜坡计算错误: %ld", (long)ramp.valueAt(3276750000ULL));
+        return false;
+    }
+    return true;
+}
+
+bool MotorPWMTest::testPWMOutputRamp() {
+    NativeHAL::resetLEDC();
+    const uint8_t pin = 5;
+
+    MotorConfig config;
+    config.pwmFrequency = 2000;
+    config.pwmDutyCycle = 50;
+    config.softStartMs = 1000;
+    config.softStopMs = 400;
+
+    MotorPWMController pwm;
+    if (!pwm.begin(pin, MOTOR_PWM_CHANNEL, config)) {
+        LOG_TAG_ERROR("PWMTest", "PWM输出初始化失败");
+        return false;
+    }
+    if (NativeHAL::getLEDCPinChannel(pin) != MOTOR_PWM_CHANNEL ||
+        NativeHAL::getLEDCFrequency(MOTOR_PWM_CHANNEL) != 2000 || currentOnCounts() != 0 ||
+        pwm.getMicrosUntilNextUpdate(NativeHAL::nowMicros()) != DeadlineScheduler::NO_DEADLINE) {
+        LOG_TAG_ERROR("PWMTest", "初始化后应连接引脚并保持关闭");
+        return false;
+    }
+
+    // 缓启动到50%：缓启动时间对应0~100%，因此历时500ms
+    recordWrites();
+    uint64_t startUs = NativeHAL::nowMicros();
+    pwm.start(startUs);
+    runRamp(pwm);
+    if (!checkRampWrites(0, 0, FULL_COUNTS / 2, startUs, 500000, "缓启动") || pwm.getOutputPermille() != 500) {
+        stopRecording();
+        return false;
+    }
+    if (g_writes.size() > 500000 / MOTOR_PWM_RAMP_INTERVAL_MICROS + 2) {
+        LOG_TAG_ERROR("PWMTest", "缓启动写入次数过多: %u", (unsigned)g_writes.size());
+        stopRecording();
+        return false;
+    }
+
+    // 运行中提高到100%：从当前输出继续，历时500ms
+    NativeHAL::advanceMillis(100);
+    g_writes.clear();
+    startUs = NativeHAL::nowMicros();
+    pwm.setDutyCycle(100, startUs);
+    runRamp(pwm);
+    if (!checkRampWrites(0, FULL_COUNTS / 2, FULL_COUNTS, startUs, 500000, "提高占空比")) {
+        stopRecording();
+        return false;
+    }
+
+    // 缓停止：100%到0历时400ms；斜坡从稍早的时刻开始（如定时器到期时刻），第一次写入即追上轨迹
+    NativeHAL::advanceMillis(100);
+    g_writes.clear();
+    startUs = NativeHAL::nowMicros() - 1500;
+    pwm.stop(startUs);
+    if (g_writes.empty() || g_writes[0].onCounts != (uint32_t)linearAt(FULL_COUNTS, 0, startUs, 400000, NativeHAL::nowMicros())) {
+        LOG_TAG_ERROR("PWMTest", "缓停止的第一次写入应按斜坡起点计算");
+        stopRecording();
+        return false;
+    }
+    runRamp(pwm);
+    if (!checkRampWrites(0, FULL_COUNTS, 0, startUs, 400000, "缓停止") || pwm.isRunning() || pwm.getOutputPermille() != 0) {
+        stopRecording();
+        return false;
+    }
+
+    // 缓启动时间为0：立即输出；频率修改立即生效，超出LEDC范围时失败
+    pwm.setSoftTimes(0, 0);
+    g_writes.clear();
+    pwm.start(NativeHAL::nowMicros());
+    if (pwm.isRamping() || g_writes.size() != 1 || currentOnCounts() != FULL_COUNTS) {
+        LOG_TAG_ERROR("PWMTest", "缓启动时间为0时应立即输出");
+        stopRecording();
+        return false;
+    }
+    stopRecording();
+    if (!pwm.setFrequency(5000) || NativeHAL::getLEDCFrequency(MOTOR_PWM_CHANNEL) != 5000 ||
+        pwm.setFrequency(100000) || pwm.getFrequency() != 5000) {
+        LOG_TAG_ERROR("PWMTest", "频率设置错误");
+        return false;
+    }
+
+    pwm.end();
+    if (NativeHAL::getLEDCPinChannel(pin) != -1) {
+        LOG_TAG_ERROR("PWMTest", "释放后引脚应断开LEDC");
+        return false;
+    }
+    return true;
+}
+
+bool MotorPWMTest::testControllerPWMMode() {
+    MotorController& motor = MotorController::getInstance();
+    if (!resetMotor(motor)) {
+        LOG_TAG_ERROR("PWMTest", "电机控制器复位失败");
+        return false;
+    }
+    NativeHAL::resetLEDC();
+
+    // 切换到PWM输出：LEDC接管引脚，输出保持关闭
+    motor.updateConfig(makePWMConfig(1000, 500, 0, false));
+    if (motor.getOutputMode() != MotorOutputMode::PWM || !motor.getPWMController() ||
+        NativeHAL::getLEDCPinChannel(MOTOR_PIN) != MOTOR_PWM_CHANNEL || currentOnCounts() != 0) {
+        LOG_TAG_ERROR("PWMTest", "切换到PWM输出失败");
+        return false;
+    }
+
+    // 运行1秒/停止0.5秒，共2个循环：缓启动200ms，缓停止100ms，从相位截止时刻开始
+    uint32_t gpioWrites = NativeHAL::getPinWriteCount(MOTOR_PIN);
+    recordWrites();
+    motor.updateConfig(makePWMConfig(1000, 500, 2, true));
+    motor.startMotor();
+    runDeadlineLoop(motor, 3500000);
+    stopRecording();
+
+    size_t full1 = 0, off1 = 0, full2 = 0, off2 = 0;
+    if (g_writes.empty() || !findReach(0, FULL_COUNTS, full1) || !findReach(full1, 0, off1) ||
+        !findReach(off1, FULL_COUNTS, full2) || !findReach(full2, 0, off2)) {
+        LOG_TAG_ERROR("PWMTest", "PWM输出应完成两次启停 (写入%u次)", (unsigned)g_writes.size());
+        return false;
+    }
+    uint64_t t0 = g_writes[0].timeUs;
+    uint64_t expected[4] = {t0 + 200000, t0 + 1100000, t0 + 1700000, t0 + 2600000};
+    size_t reached[4] = {full1, off1, full2, off2};
+    for (int i = 0; i < 4; i++) {
+        if (g_writes[reached[i]].timeUs != expected[i]) {
+            LOG_TAG_ERROR("PWMTest", "第%d次到达时刻错误: %luus (应为%luus)", i + 1,
+                          (uint32_t)(g_writes[reached[i]].timeUs - t0), (uint32_t)(expected[i] - t0));
+            return false;
+        }
+    }
+    if (g_writes.size() > 80 || NativeHAL::getPinWriteCount(MOTOR_PIN) != gpioWrites ||
+        NativeHAL::getLEDCPinChannel(MOTOR_PIN) != MOTOR_PWM_CHANNEL || !motor.isStopped()) {
+        LOG_TAG_ERROR("PWMTest", "PWM输出期间不应切换GPIO (LEDC写入%u次)", (unsigned)g_writes.size());
+        return false;
+    }
+
+    // 程序步骤的设定值直接作用于PWM输出：50%占空比，缓变0.1秒
+    MotorProgram program;
+    ProgramSetpoint setpoint;
+    setpoint.mask = ProgramSetpoint::DUTY | ProgramSetpoint::RAMP;
+    setpoint.dutyCycle = 50;
+    setpoint.rampTime = 1;
+    program.addStep(300, true, setpoint);
+    program.addStep(200, false);
+    if (!program.compile() || !motor.loadProgram(program)) {
+        LOG_TAG_ERROR("PWMTest", "加载电机程序失败");
+        return false;
+    }
+    recordWrites();
+    motor.startProgram();
+    runDeadlineLoop(motor, 600000);
+    stopRecording();
+    size_t half = 0, off = 0;
+    if (!findReach(0, FULL_COUNTS / 2, half) || !findReach(half, 0, off) ||
+        g_writes[half].timeUs - g_writes[0].timeUs != 50000 || g_writes[off].timeUs - g_writes[0].timeUs != 350000 ||
+        motor.getPWMController()->getDutyCycle() != 50 || motor.isProgramRunning()) {
+        LOG_TAG_ERROR("PWMTest", "程序设定值未作用于PWM输出");
+        return false;
+    }
+
+    // 保存到NVS后读回
+    ConfigManager& configManager = ConfigManager::getInstance();
+    if (!configManager.init()) {
+        LOG_TAG_ERROR("PWMTest", "ConfigManager初始化失败");
+        return false;
+    }
+    MotorConfig originalConfig = configManager.getConfig();
+    MotorConfig stored = makePWMConfig(1000, 500, 0, false);
+    stored.pwmFrequency = 25000;
+    stored.pwmDutyCycle = 35;
+    stored.softStartMs = 1500;
+    stored.softStopMs = 700;
+    configManager.updateConfig(stored);
+    bool saved = configManager.saveConfig();
+    configManager.resetToDefaults();
+    bool loaded = configManager.loadConfig();
+    MotorConfig readBack = configManager.getConfig();
+    configManager.updateConfig(originalConfig);
+    configManager.saveConfig();
+    if (!saved || !loaded || readBack.outputMode != MotorOutputMode::PWM || readBack.pwmFrequency != 25000 ||
+        readBack.pwmDutyCycle != 35 || readBack.softStartMs != 1500 || readBack.softStopMs != 700) {
+        LOG_TAG_ERROR("PWMTest", "PWM参数NVS保存/读取错误");
+        return false;
+    }
+
+    // 切换回GPIO开关输出：释放LEDC，引脚保持关闭
+    if (!resetMotor(motor) || NativeHAL::getLEDCPinChannel(MOTOR_PIN) != -1 ||
+        NativeHAL::getPinMode(MOTOR_PIN) != OUTPUT) {
+        LOG_TAG_ERROR("PWMTest", "切换回GPIO开关输出失败");
+        return false;
+    }
+    return true;
+}
+
+#endif // NATIVE_BUILD
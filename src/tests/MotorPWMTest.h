@@ -0,0 +1,40 @@
+#ifndef MOTOR_PWM_TEST_H
+#define MOTOR_PWM_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * PWM输出方式测试（定点斜坡、LEDC占空比轨迹和MotorController集成，仅在native环境运行）
+ */
+class MotorPWMTest {
+public:
+    /**
+     * 运行所有PWM输出测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试定点线性斜坡：单调、不超前、准时到达目标，中途改目标时输出连续
+     * @return 测试是否通过
+     */
+    static bool testRampGenerator();
+
+    /**
+     * 测试MotorPWMController：缓启动/缓停止的占空比轨迹、更新间隔、运行中修改占空比和频率
+     * @return 测试是否通过
+     */
+    static bool testPWMOutputRamp();
+
+    /**
+     * 测试MotorController的PWM输出方式：斜坡起点对齐相位截止时刻、程序设定值、切换回GPIO和NVS保存
+     * @return 测试是否通过
+     */
+    static bool testControllerPWMMode();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // MOTOR_PWM_TEST_H
@@ -0,0 +1,625 @@
+#include "MotorPhaseTimingTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../controllers/MotorController.h"
+#include "../controllers/SerialConsole.h"
+#include "../common/Logger.h"
+#include "../common/StateManager.h"
+
+namespace {
+
+/**
+ * 电机引脚的电平切换记录
+ */
+struct PinEdge {
+    uint8_t level;
+    uint64_t timeUs;
+};
+
+std::vector<PinEdge> g_edges;
+int g_lastLevel = -1;
+
+void recordEdges() {
+    g_edges.clear();
+    g_lastLevel = NativeHAL::getPinLevel(MOTOR_PIN);
+    NativeHAL::setPinWriteHook([](uint8_t pin, uint8_t level, uint64_t timeUs) {
+        if (pin != MOTOR_PIN || level == g_lastLevel) {
+            return;
+        }
+        g_lastLevel = level;
+        g_edges.push_back(PinEdge{level, timeUs});
+    });
+}
+
+void stopRecording() {
+    NativeHAL::setPinWriteHook(nullptr);
+}
+
+MotorConfig makeConfig(uint32_t runSeconds, uint32_t stopSeconds, uint32_t cycles, bool autoStart) {
+    MotorConfig config;
+    config.runDurationMs = runSeconds * 1000;
+    config.stopDurationMs = stopSeconds * 1000;
+    config.cycleCount = cycles;
+    config.autoStart = autoStart;
+    return config;
+}
+
+/**
+ * 旧主循环模型：每次迭代调用update()，之后delay(10)，再加上0~24ms的MODBUS/BLE阻塞
+ */
+void runBlockingLoop(MotorController& motor, uint32_t durationMs, uint32_t& seed) {
+    uint64_t end = NativeHAL::nowMicros() + (uint64_t)durationMs * 1000;
+    while (NativeHAL::nowMicros() < end) {
+        motor.update();
+        seed = seed * 1103515245u + 12345u;
+        NativeHAL::advanceMicros(10000 + ((seed >> 16) % 25) * 1000);
+    }
+}
+
+/**
+ * 让电机停在STOPPED状态且不自动启动，清空统计
+ */
+bool resetMotor(MotorController& motor) {
+    if (!motor.init()) {
+        return false;
+    }
+    motor.setPhaseTimerEnabled(true);
+    motor.updateConfig(makeConfig(2, 1, 0, false));
+    motor.stopMotor();
+    for (int i = 0; i < 5 && !motor.isStopped(); i++) {
+        motor.update();
+        NativeHAL::advanceMicros(1000);
+    }
+    motor.resetCycleCount();
+    motor.resetPhaseJitterStatistics();
+    return motor.isStopped() && NativeHAL::getPinLevel(MOTOR_PIN) == MOTOR_OFF;
+}
+
+/**
+ * 按截止时间驱动的主循环：每次update()后休眠到控制器给出的下一次更新时刻
+ */
+void runDeadlineLoop(MotorController& motor, uint64_t durationUs) {
+    uint64_t end = NativeHAL::nowMicros() + durationUs;
+    for (int guard = 0; guard < 10000 && NativeHAL::nowMicros() < end; guard++) {
+        motor.update();
+        uint64_t remaining = end - NativeHAL::nowMicros();
+        uint32_t wait = motor.getMicrosUntilNextUpdate();
+        NativeHAL::advanceMicros(wait < remaining ? wait : remaining);
+    }
+}
+
+bool near(uint64_t actual, uint64_t expected, uint64_t tolerance) {
+    return actual + tolerance >= expected && actual <= expected + tolerance;
+}
+
+void logHistogram(const char* label, const PhaseJitterStatistics& stats) {
+    char line[160];
+    size_t length = 0;
+    uint32_t lower = 0;
+    for (uint8_t bucket = 0; bucket < PhaseJitterStatistics::BUCKET_COUNT; bucket++) {
+        uint32_t limit = MotorController::getPhaseJitterBucketLimit(bucket);
+        int written = limit == 0xFFFFFFFF ?
+            snprintf(line + length, sizeof(line) - length, " >=%lu:%lu", (unsigned long)lower, (unsigned long)stats.buckets[bucket]) :
+            snprintf(line + length, sizeof(line) - length, " <%lu:%lu", (unsigned long)limit, (unsigned long)stats.buckets[bucket]);
+        if (written < 0 || (size_t)written >= sizeof(line) - length) {
+            break;
+        }
+        length += written;
+        lower = limit;
+    }
+    LOG_TAG_INFO("PhaseTest", "%s: 切换%lu次 (定时器%lu次), 平均误差%.1fus, 最大%luus, 分布(us)%s",
+                 label, stats.edges, stats.timerEdges,
+                 stats.edges > 0 ? (float)stats.totalErrorMicros / stats.edges : 0.0f,
+                 stats.maxErrorMicros, line);
+}
+
+/**
+ * 把命令输出收集到字符串中
+ */
+class CapturePrint : public Print {
+public:
+    size_t write(uint8_t byte) override {
+        text += (char)byte;
+        return 1;
+    }
+    
+    bool contains(const char* needle) const {
+        return text.find(needle) != std::string::npos;
+    }
+    
+    std::string text;
+};
+
+} // namespace
+
+bool MotorPhaseTimingTest::runAllTests() {
+    LOG_TAG_INFO("PhaseTest", "开始电机相位定时测试...");
+
+    bool allPassed = true;
+
+    if (!testTimerEdges()) {
+        LOG_TAG_ERROR("PhaseTest", "❌ 定时器相位切换测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("PhaseTest", "✅ 定时器相位切换测试通过");
+    }
+
+    if (!testRescheduleAndCancel()) {
+        LOG_TAG_ERROR("PhaseTest", "❌ 相位重新安排与取消测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("PhaseTest", "✅ 相位重新安排与取消测试通过");
+    }
+
+    if (!testErrorDuringStopInterval()) {
+        LOG_TAG_ERROR("PhaseTest", "❌ 停止间隔中进入错误状态测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("PhaseTest", "✅ 停止间隔中进入错误状态测试通过");
+    }
+
+    if (!testTimerToggleAfterAutoStartDisabled()) {
+        LOG_TAG_ERROR("PhaseTest", "❌ 禁止自动启动后切换定时器测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("PhaseTest", "✅ 禁止自动启动后切换定时器测试通过");
+    }
+
+    if (!testConfigChangeAfterTimerEdge()) {
+        LOG_TAG_ERROR("PhaseTest", "❌ 定时器切换后更新配置测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("PhaseTest", "✅ 定时器切换后更新配置测试通过");
+    }
+
+    if (!testJitterSummary()) {
+        LOG_TAG_ERROR("PhaseTest", "❌ 误差摘要计算测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("PhaseTest", "✅ 误差摘要计算测试通过");
+    }
+
+    if (!testPhaseStatisticsAndConsole()) {
+        LOG_TAG_ERROR("PhaseTest", "❌ 分阶段统计与串口命令测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("PhaseTest", "✅ 分阶段统计与串口命令测试通过");
+    }
+
+    if (!testLongUptimeAndDurations()) {
+        LOG_TAG_ERROR("PhaseTest", "❌ 长时间运行与长/短阶段测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("PhaseTest", "✅ 长时间运行与长/短阶段测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("PhaseTest", "🎉 所有电机相位定时测试通过!");
+    } else {
+        LOG_TAG_ERROR("PhaseTest", "💥 部分电机相位定时测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool MotorPhaseTimingTest::testTimerEdges() {
+    MotorController& motor = MotorController::getInstance();
+    if (!resetMotor(motor)) {
+        LOG_TAG_ERROR("PhaseTest", "电机控制器复位失败");
+        return false;
+    }
+    if (!motor.isPhaseTimerActive()) {
+        LOG_TAG_ERROR("PhaseTest", "相位定时器不可用");
+        return false;
+    }
+
+    // 运行2秒/停止1秒，共3个循环
+    recordEdges();
+    uint32_t seed = 1;
+    motor.updateConfig(makeConfig(2, 1, 3, true));
+    runBlockingLoop(motor, 12000, seed);
+    stopRecording();
+
+    if (g_edges.size() != 6) {
+        LOG_TAG_ERROR("PhaseTest", "应有6次电平切换 (实际%u次)", (unsigned)g_edges.size());
+        return false;
+    }
+    for (size_t i = 1; i < g_edges.size(); i++) {
+        uint8_t expectedLevel = (i % 2 == 1) ? MOTOR_OFF : MOTOR_ON;
+        uint64_t expectedInterval = (i % 2 == 1) ? 2000000 : 1000000;
+        uint64_t interval = g_edges[i].timeUs - g_edges[i - 1].timeUs;
+        if (g_edges[i].level != expectedLevel || !near(interval, expectedInterval, 100)) {
+            LOG_TAG_ERROR("PhaseTest", "第%u次切换错误: 电平%u, 间隔%luus", (unsigned)i, g_edges[i].level,
+                          (uint32_t)interval);
+            return false;
+        }
+    }
+
+    const PhaseJitterStatistics& stats = motor.getPhaseJitterStatistics();
+    // 首个停止间隔 + 3次运行 + 2次停止间隔
+    if (stats.edges != 6 || stats.timerEdges != stats.edges || stats.maxErrorMicros >= 100) {
+        LOG_TAG_ERROR("PhaseTest", "误差统计错误: 切换%lu次 定时器%lu次 最大误差%luus",
+                      stats.edges, stats.timerEdges, stats.maxErrorMicros);
+        return false;
+    }
+    if (!motor.isStopped() || motor.getCurrentCycleCount() != 3 || NativeHAL::getPinLevel(MOTOR_PIN) != MOTOR_OFF) {
+        LOG_TAG_ERROR("PhaseTest", "循环结束后电机应保持停止");
+        return false;
+    }
+    return true;
+}
+
+bool MotorPhaseTimingTest::testRescheduleAndCancel() {
+    MotorController& motor = MotorController::getInstance();
+    if (!resetMotor(motor)) {
+        LOG_TAG_ERROR("PhaseTest", "电机控制器复位失败");
+        return false;
+    }
+
+    recordEdges();
+    uint32_t seed = 7;
+
+    // 停止间隔计时中禁止自动启动：定时器不能在到期时打开电机
+    motor.updateConfig(makeConfig(2, 1, 0, true));
+    runBlockingLoop(motor, 500, seed);
+    motor.updateConfig(makeConfig(2, 1, 0, false));
+    runBlockingLoop(motor, 2000, seed);
+    if (!g_edges.empty()) {
+        LOG_TAG_ERROR("PhaseTest", "禁止自动启动后电机仍被打开");
+        stopRecording();
+        return false;
+    }
+
+    // 手动启动后运行阶段从启动时刻开始；运行中缩短运行时间，已超时的阶段立即结束
+    motor.startMotor();
+    runBlockingLoop(motor, 1200, seed);
+    if (g_edges.size() != 1 || g_edges[0].level != MOTOR_ON) {
+        LOG_TAG_ERROR("PhaseTest", "手动启动未打开电机");
+        stopRecording();
+        return false;
+    }
+    uint64_t changedAt = NativeHAL::nowMicros();
+    motor.updateConfig(makeConfig(1, 1, 0, false));
+    runBlockingLoop(motor, 100, seed);
+    stopRecording();
+
+    if (g_edges.size() != 2 || g_edges[1].level != MOTOR_OFF || !near(g_edges[1].timeUs, changedAt, 10)) {
+        LOG_TAG_ERROR("PhaseTest", "缩短运行时间后电机未立即停止");
+        return false;
+    }
+    return motor.isStopped();
+}
+
+bool MotorPhaseTimingTest::testErrorDuringStopInterval() {
+    MotorController& motor = MotorController::getInstance();
+    if (!resetMotor(motor)) {
+        LOG_TAG_ERROR("PhaseTest", "电机控制器复位失败");
+        return false;
+    }
+    StateManager& stateManager = StateManager::getInstance();
+    SystemState originalState = stateManager.getCurrentState();
+
+    // 自动启动先进入停止间隔，间隔计时中（定时器已安排在间隔结束时打开电机）进入系统错误状态
+    recordEdges();
+    uint32_t seed = 11;
+    motor.updateConfig(makeConfig(2, 1, 0, true));
+    runBlockingLoop(motor, 300, seed);
+    bool inStopInterval = g_edges.empty() && motor.getCurrentState() == MotorControllerState::STOPPED;
+    stateManager.setState(SystemState::ERROR, "测试");
+    if (motor.getCurrentState() != MotorControllerState::ERROR_STATE) {
+        // 状态监听器已被其他测试清除时，按监听器的方式直接通知电机控制器
+        StateChangeEvent event;
+        event.oldState = originalState;
+        event.newState = SystemState::ERROR;
+        event.reason = "测试";
+        event.timestamp = millis();
+        motor.onSystemStateChanged(event);
+    }
+    bool inError = motor.getCurrentState() == MotorControllerState::ERROR_STATE;
+
+    // 主循环阻塞（不调用update()）超过停止间隔
+    NativeHAL::advanceMicros(2000000);
+    bool pinStayedOff = g_edges.empty() && NativeHAL::getPinLevel(MOTOR_PIN) == MOTOR_OFF;
+    size_t edgeCount = g_edges.size();
+    stopRecording();
+
+    stateManager.setState(originalState, "测试结束");
+    motor.stopMotor();
+    for (int i = 0; i < 5 && !motor.isStopped(); i++) {
+        motor.update();
+        NativeHAL::advanceMicros(1000);
+    }
+
+    if (!inStopInterval) {
+        LOG_TAG_ERROR("PhaseTest", "未进入停止间隔");
+        return false;
+    }
+    if (!inError || !pinStayedOff) {
+        LOG_TAG_ERROR("PhaseTest", "错误状态下电机被定时器打开 (错误状态%d, 切换%u次)", inError,
+                      (unsigned)edgeCount);
+        return false;
+    }
+    return true;
+}
+
+bool MotorPhaseTimingTest::testTimerToggleAfterAutoStartDisabled() {
+    MotorController& motor = MotorController::getInstance();
+    if (!resetMotor(motor)) {
+        LOG_TAG_ERROR("PhaseTest", "电机控制器复位失败");
+        return false;
+    }
+
+    // 停止间隔计时中禁止自动启动，之后关闭再打开相位定时器（剩余停止时间仍不为0）
+    recordEdges();
+    uint32_t seed = 13;
+    motor.updateConfig(makeConfig(2, 5, 0, true));
+    runBlockingLoop(motor, 300, seed);
+    bool inStopInterval = g_edges.empty() && motor.getCurrentState() == MotorControllerState::STOPPED &&
+                          motor.getRemainingStopTimeMs() > 0;
+    motor.updateConfig(makeConfig(2, 5, 0, false));
+    motor.setPhaseTimerEnabled(false);
+    motor.setPhaseTimerEnabled(true);
+
+    // 主循环阻塞（不调用update()）超过停止间隔
+    NativeHAL::advanceMicros(6000000);
+    bool pinStayedOff = g_edges.empty() && NativeHAL::getPinLevel(MOTOR_PIN) == MOTOR_OFF;
+    runBlockingLoop(motor, 500, seed);
+    size_t edgeCount = g_edges.size();
+    stopRecording();
+
+    if (!inStopInterval) {
+        LOG_TAG_ERROR("PhaseTest", "未进入停止间隔");
+        return false;
+    }
+    if (!pinStayedOff || edgeCount != 0 || !motor.isStopped()) {
+        LOG_TAG_ERROR("PhaseTest", "重新打开定时器后电机被打开 (切换%u次)", (unsigned)edgeCount);
+        return false;
+    }
+    return true;
+}
+
+bool MotorPhaseTimingTest::testConfigChangeAfterTimerEdge() {
+    MotorController& motor = MotorController::getInstance();
+    if (!resetMotor(motor)) {
+        LOG_TAG_ERROR("PhaseTest", "电机控制器复位失败");
+        return false;
+    }
+
+    // 运行2秒/停止1秒，等到运行阶段开始计时
+    motor.updateConfig(makeConfig(2, 1, 0, true));
+    for (int i = 0; i < 300 && !(motor.isRunning() && motor.getRemainingRunTimeMs() > 0); i++) {
+        motor.update();
+        NativeHAL::advanceMicros(10000);
+    }
+    if (!motor.isRunning()) {
+        LOG_TAG_ERROR("PhaseTest", "未进入运行阶段");
+        return false;
+    }
+
+    // 定时器在截止时刻关闭电机，主循环确认之前延长运行时长（调度器先执行BLE任务）
+    NativeHAL::advanceMicros((uint64_t)motor.getRemainingRunTimeMs() * 1000 + 1000);
+    bool stoppedByTimer = NativeHAL::getPinLevel(MOTOR_PIN) == MOTOR_OFF;
+    motor.updateConfig(makeConfig(5, 1, 0, true));
+    motor.update();
+    if (!stoppedByTimer || motor.isRunning() || NativeHAL::getPinLevel(MOTOR_PIN) != MOTOR_OFF) {
+        LOG_TAG_ERROR("PhaseTest", "运行阶段结束后更新配置: 状态%d, 剩余运行%lu ms, 电平%u",
+                      (int)motor.getCurrentState(), (unsigned long)motor.getRemainingRunTimeMs(),
+                      NativeHAL::getPinLevel(MOTOR_PIN));
+        return false;
+    }
+
+    // 停止间隔同样处理：定时器打开电机后更新停止间隔，状态随之进入运行阶段，新运行时长生效
+    motor.update();
+    if (motor.getCurrentState() != MotorControllerState::STOPPED || motor.getRemainingStopTimeMs() == 0) {
+        LOG_TAG_ERROR("PhaseTest", "未进入停止间隔");
+        return false;
+    }
+    NativeHAL::advanceMicros((uint64_t)motor.getRemainingStopTimeMs() * 1000 + 1000);
+    bool startedByTimer = NativeHAL::getPinLevel(MOTOR_PIN) == MOTOR_ON;
+    motor.updateConfig(makeConfig(5, 3, 0, true));
+    motor.update();
+    motor.update();
+    if (!startedByTimer || !motor.isRunning() || NativeHAL::getPinLevel(MOTOR_PIN) != MOTOR_ON ||
+        motor.getRemainingRunTimeMs() <= 4000) {
+        LOG_TAG_ERROR("PhaseTest", "停止间隔结束后更新配置: 状态%d, 剩余运行%lu ms, 电平%u",
+                      (int)motor.getCurrentState(), (unsigned long)motor.getRemainingRunTimeMs(),
+                      NativeHAL::getPinLevel(MOTOR_PIN));
+        return false;
+    }
+    return true;
+}
+
+bool MotorPhaseTimingTest::testJitterSummary() {
+    PhaseJitterStatistics stats;
+    memset(&stats, 0, sizeof(stats));
+    PhaseJitterSummary summary = MotorController::summarizePhaseJitter(stats);
+    if (summary.count != 0 || summary.maxMicros != 0 || summary.p99Micros != 0) {
+        LOG_TAG_ERROR("PhaseTest", "无样本时摘要应全部为0");
+        return false;
+    }
+
+    // 100个样本：98个<10us，1个在[50,100)，1个>=50000；第99个样本落在<100us的桶
+    stats.edges = 100;
+    stats.minErrorMicros = 2;
+    stats.maxErrorMicros = 70000;
+    stats.totalErrorMicros = 98 * 5 + 80 + 70000;
+    stats.buckets[0] = 98;
+    stats.buckets[3] = 1;
+    stats.buckets[PhaseJitterStatistics::BUCKET_COUNT - 1] = 1;
+    summary = MotorController::summarizePhaseJitter(stats);
+    if (summary.count != 100 || summary.minMicros != 2 || summary.maxMicros != 70000 ||
+        summary.meanMicros != 705 || summary.p99Micros != 100) {
+        LOG_TAG_ERROR("PhaseTest", "摘要错误: n=%lu min=%lu max=%lu mean=%lu p99=%lu", summary.count,
+                      summary.minMicros, summary.maxMicros, summary.meanMicros, summary.p99Micros);
+        return false;
+    }
+
+    // 第99百分位落在最后一个桶时取最大误差；桶上限超过最大误差时也取最大误差
+    stats.buckets[0] = 97;
+    stats.buckets[3] = 0;
+    stats.buckets[PhaseJitterStatistics::BUCKET_COUNT - 1] = 3;
+    if (MotorController::summarizePhaseJitter(stats).p99Micros != 70000) {
+        LOG_TAG_ERROR("PhaseTest", "p99落在最后一个桶时应为最大误差");
+        return false;
+    }
+    memset(stats.buckets, 0, sizeof(stats.buckets));
+    stats.buckets[0] = 100;
+    stats.maxErrorMicros = 6;
+    if (MotorController::summarizePhaseJitter(stats).p99Micros != 6) {
+        LOG_TAG_ERROR("PhaseTest", "p99不应超过最大误差");
+        return false;
+    }
+    return true;
+}
+
+bool MotorPhaseTimingTest::testPhaseStatisticsAndConsole() {
+    MotorController& motor = MotorController::getInstance();
+    if (!resetMotor(motor)) {
+        LOG_TAG_ERROR("PhaseTest", "电机控制器复位失败");
+        return false;
+    }
+
+    // 主循环检测到期：运行2秒/停止1秒，共2个循环 -> 运行阶段2次，停止阶段2次（含首个停止间隔）
+    motor.setPhaseTimerEnabled(false);
+    uint32_t seed = 3;
+    motor.updateConfig(makeConfig(2, 1, 2, true));
+    runBlockingLoop(motor, 8000, seed);
+    motor.setPhaseTimerEnabled(true);
+
+    const PhaseJitterStatistics& run = motor.getPhaseJitterStatistics(MotorPhase::RUN);
+    const PhaseJitterStatistics& stop = motor.getPhaseJitterStatistics(MotorPhase::STOP);
+    PhaseJitterStatistics merged = motor.getPhaseJitterStatistics();
+    if (run.edges != 2 || stop.edges != 2 || run.timerEdges != 0 || merged.edges != 4 ||
+        merged.maxErrorMicros != std::max(run.maxErrorMicros, stop.maxErrorMicros) ||
+        merged.minErrorMicros != std::min(run.minErrorMicros, stop.minErrorMicros)) {
+        LOG_TAG_ERROR("PhaseTest", "分阶段统计错误: 运行%lu次 停止%lu次 合并%lu次", run.edges, stop.edges,
+                      merged.edges);
+        return false;
+    }
+    PhaseJitterSummary summary = MotorController::summarizePhaseJitter(run);
+    if (summary.minMicros > summary.meanMicros || summary.meanMicros > summary.maxMicros ||
+        summary.p99Micros > summary.maxMicros || summary.maxMicros == 0) {
+        LOG_TAG_ERROR("PhaseTest", "运行阶段摘要错误: min=%lu mean=%lu max=%lu p99=%lu", summary.minMicros,
+                      summary.meanMicros, summary.maxMicros, summary.p99Micros);
+        return false;
+    }
+
+    SerialConsole& console = SerialConsole::getInstance();
+    CapturePrint out;
+    if (!console.handleLine(" timing ", out) || !out.contains("运行阶段: 切换2次") ||
+        !out.contains("停止阶段: 切换2次") || !out.contains(">=50000:")) {
+        LOG_TAG_ERROR("PhaseTest", "timing命令输出错误: %s", out.text.c_str());
+        return false;
+    }
+
+    out.text.clear();
+    if (console.handleLine("timing now", out) || !out.contains("未知命令")) {
+        LOG_TAG_ERROR("PhaseTest", "未知命令应被拒绝");
+        return false;
+    }
+
+    out.text.clear();
+    if (!console.handleLine("timing reset", out) || motor.getPhaseJitterStatistics().edges != 0) {
+        LOG_TAG_ERROR("PhaseTest", "timing reset未清零统计");
+        return false;
+    }
+    out.text.clear();
+    console.handleLine("timing", out);
+    if (!out.contains("运行阶段: 切换0次") || !out.contains("停止阶段: 切换0次")) {
+        LOG_TAG_ERROR("PhaseTest", "重置后timing命令输出错误: %s", out.text.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool MotorPhaseTimingTest::testLongUptimeAndDurations() {
+    MotorController& motor = MotorController::getInstance();
+    if (!resetMotor(motor)) {
+        LOG_TAG_ERROR("PhaseTest", "电机控制器复位失败");
+        return false;
+    }
+
+    // 虚拟时钟推进到millis()回绕前1秒，运行250ms/停止150ms共6个循环，跨过回绕点
+    const uint64_t millisWrapUs = 0x100000000ULL * 1000;
+    if (NativeHAL::nowMicros() < millisWrapUs - 1000000) {
+        NativeHAL::setMicros(millisWrapUs - 1000000);
+    }
+    MotorConfig config = makeConfig(1, 1, 6, true);
+    config.runDurationMs = 250;
+    config.stopDurationMs = 150;
+    recordEdges();
+    uint32_t seed = 5;
+    motor.updateConfig(config);
+    runBlockingLoop(motor, 4000, seed);
+    stopRecording();
+
+    bool edgesOk = g_edges.size() == 12 && g_edges.front().timeUs < millisWrapUs && g_edges.back().timeUs > millisWrapUs;
+    for (size_t i = 1; edgesOk && i < g_edges.size(); i++) {
+        uint64_t expectedInterval = (i % 2 == 1) ? 250000 : 150000;
+        edgesOk = g_edges[i].level == ((i % 2 == 1) ? MOTOR_OFF : MOTOR_ON) &&
+                  near(g_edges[i].timeUs - g_edges[i - 1].timeUs, expectedInterval, 100);
+    }
+    if (!edgesOk || motor.getCurrentCycleCount() != 6) {
+        LOG_TAG_ERROR("PhaseTest", "millis()回绕前后的亚秒级循环错误: 切换%u次, 循环%lu次",
+                      (unsigned)g_edges.size(), motor.getCurrentCycleCount());
+        return false;
+    }
+    LOG_TAG_INFO("PhaseTest", "millis()回绕前后: 6个250ms/150ms循环, 最大误差%luus",
+                 motor.getPhaseJitterStatistics().maxErrorMicros);
+
+    // 停止间隔90分钟、运行2小时：超过micros()回绕周期和单次定时范围，定时器在接近截止时刻时才启动
+    motor.resetCycleCount();
+    motor.resetPhaseJitterStatistics();
+    config.runDurationMs = 2UL * 3600 * 1000;
+    config.stopDurationMs = 90UL * 60 * 1000;
+    config.cycleCount = 1;
+    recordEdges();
+    uint64_t startUs = NativeHAL::nowMicros();
+    motor.updateConfig(config);
+    runDeadlineLoop(motor, 4ULL * 3600 * 1000000);
+    stopRecording();
+
+    const PhaseJitterStatistics& stats = motor.getPhaseJitterStatistics();
+    if (g_edges.size() != 2 || g_edges[0].level != MOTOR_ON || g_edges[1].level != MOTOR_OFF ||
+        !near(g_edges[0].timeUs - startUs, 90ULL * 60 * 1000000, 100) ||
+        !near(g_edges[1].timeUs - g_edges[0].timeUs, 2ULL * 3600 * 1000000, 100) ||
+        stats.edges != 2 || stats.timerEdges != 2) {
+        LOG_TAG_ERROR("PhaseTest", "长阶段错误: 切换%u次, 定时器切换%lu次", (unsigned)g_edges.size(), stats.timerEdges);
+        return false;
+    }
+    return motor.isStopped() && motor.getCurrentCycleCount() == 1;
+}
+
+bool MotorPhaseTimingTest::runJitterComparison() {
+    LOG_TAG_INFO("PhaseTest", "阻塞主循环（delay(10) + 0~24ms MODBUS/BLE阻塞）下运行60秒，运行2秒/停止1秒...");
+
+    MotorController& motor = MotorController::getInstance();
+    PhaseJitterStatistics results[2];
+    for (int mode = 0; mode < 2; mode++) {
+        bool useTimer = mode == 1;
+        if (!resetMotor(motor)) {
+            return false;
+        }
+        motor.setPhaseTimerEnabled(useTimer);
+        uint32_t seed = 42;
+        motor.updateConfig(makeConfig(2, 1, 0, true));
+        runBlockingLoop(motor, 60000, seed);
+        results[mode] = motor.getPhaseJitterStatistics();
+        logHistogram(useTimer ? "定时器切换" : "主循环检测", results[mode]);
+        PhaseJitterSummary summary = MotorController::summarizePhaseJitter(results[mode]);
+        LOG_TAG_INFO("PhaseTest", "  最小%luus 平均%luus p99 %luus", summary.minMicros, summary.meanMicros,
+                     summary.p99Micros);
+    }
+
+    resetMotor(motor);
+    return results[1].edges > 0 && results[1].maxErrorMicros < 1000 &&
+           results[1].maxErrorMicros < results[0].maxErrorMicros;
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,76 @@
+#ifndef MOTOR_PHASE_TIMING_TEST_H
+#define MOTOR_PHASE_TIMING_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * 电机运行/停止相位定时测试（使用虚拟时钟和GPIO写入钩子，仅在native环境运行）
+ */
+class MotorPhaseTimingTest {
+public:
+    /**
+     * 运行所有相位定时测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试主循环阻塞时GPIO仍在截止时刻由定时器切换，周期不累积误差
+     * @return 测试是否通过
+     */
+    static bool testTimerEdges();
+
+    /**
+     * 测试禁止自动启动、手动启动和缩短运行时间时定时器被取消或重新安排
+     * @return 测试是否通过
+     */
+    static bool testRescheduleAndCancel();
+
+    /**
+     * 测试停止间隔中进入系统错误状态：主循环阻塞时定时器也不能打开电机
+     * @return 测试是否通过
+     */
+    static bool testErrorDuringStopInterval();
+    
+    /**
+     * 测试禁止自动启动后关闭再打开相位定时器：停止间隔到期时电机不能被打开
+     * @return 测试是否通过
+     */
+    static bool testTimerToggleAfterAutoStartDisabled();
+    
+    /**
+     * 测试定时器已切换GPIO、主循环确认之前更新配置：状态随GPIO完成切换，新时长从下一阶段生效
+     * @return 测试是否通过
+     */
+    static bool testConfigChangeAfterTimerEdge();
+    
+    /**
+     * 测试误差摘要（最小/最大/平均/p99）的计算
+     * @return 测试是否通过
+     */
+    static bool testJitterSummary();
+    
+    /**
+     * 测试运行/停止阶段分别统计、串口timing命令输出和重置
+     * @return 测试是否通过
+     */
+    static bool testPhaseStatisticsAndConsole();
+    
+    /**
+     * 测试millis()回绕（运行约49.7天）前后的亚秒级运行/停止阶段，以及超过micros()回绕周期的长阶段
+     * @return 测试是否通过
+     */
+    static bool testLongUptimeAndDurations();
+
+    /**
+     * 同样的阻塞主循环下，对比定时器切换与主循环检测到期切换的误差分布
+     * @return 定时器切换的最大误差是否低于1ms
+     */
+    static bool runJitterComparison();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // MOTOR_PHASE_TIMING_TEST_H
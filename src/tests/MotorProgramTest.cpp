@@ -0,0 +1,512 @@
+#include "MotorProgramTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <cstring>
+#include <vector>
+#include "../common/MotorProgram.h"
+#include "../common/DeadlineScheduler.h"
+#include "../controllers/MotorController.h"
+#include "../controllers/ConfigManager.h"
+#include "../common/Logger.h"
+
+namespace {
+
+/**
+ * 展开后的一次步骤执行
+ */
+struct ExpectedStep {
+    uint8_t index;
+    uint64_t startMs;
+};
+
+/**
+ * 参考实现：递归展开循环，生成每个步骤的位置和开始时刻
+ * @return 下一条未处理指令的位置
+ */
+uint8_t expand(const MotorProgram& program, uint8_t index, uint64_t& timeMs, std::vector<ExpectedStep>& steps) {
+    while (index < program.getInstructionCount()) {
+        const ProgramInstruction& instruction = program.getInstruction(index);
+        if (instruction.op == ProgramOp::STEP) {
+            steps.push_back(ExpectedStep{index, timeMs});
+            timeMs += instruction.durationMs;
+            index++;
+        } else if (instruction.op == ProgramOp::REPEAT) {
+            uint8_t end = index + 1;
+            for (uint16_t i = 0; i < instruction.repeatCount; i++) {
+                end = expand(program, index + 1, timeMs, steps);
+            }
+            index = end + 1;
+        } else {
+            return index;
+        }
+    }
+    return index;
+}
+
+ProgramSetpoint makeSetpoint(uint32_t frequency, uint8_t duty, uint16_t ramp) {
+    ProgramSetpoint setpoint;
+    setpoint.mask = ProgramSetpoint::FREQUENCY | ProgramSetpoint::DUTY | ProgramSetpoint::RAMP;
+    setpoint.frequency = frequency;
+    setpoint.dutyCycle = duty;
+    setpoint.rampTime = ramp;
+    return setpoint;
+}
+
+/**
+ * 运行3次：开1500ms（带设定值）/关500ms
+ */
+void buildCycleProgram(MotorProgram& program) {
+    program.clear();
+    program.beginRepeat(3);
+    program.addStep(1500, true, makeSetpoint(1000, 50, 5));
+    program.addStep(500, false);
+    program.endRepeat();
+}
+
+/**
+ * 嵌套循环的长程序：外层200次，每次含开/关交替、两层嵌套和不同时长的步骤
+ */
+void buildLongProgram(MotorProgram& program) {
+    program.clear();
+    program.addStep(250, false);
+    program.beginRepeat(200);
+    program.addStep(3000, true, makeSetpoint(1200, 80, 20));
+    program.beginRepeat(7);
+    program.addStep(45, false);
+    program.addStep(130, true);
+    program.endRepeat();
+    program.beginRepeat(3);
+    program.beginRepeat(2);
+    program.addStep(17, false);
+    program.endRepeat();
+    program.addStep(1999, true);
+    program.endRepeat();
+    program.endRepeat();
+    program.addStep(1, false);
+}
+
+/**
+ * 电机引脚的电平切换记录
+ */
+struct PinEdge {
+    uint8_t level;
+    uint64_t timeUs;
+};
+
+std::vector<PinEdge> g_edges;
+int g_lastLevel = -1;
+
+void recordEdges() {
+    g_edges.clear();
+    g_lastLevel = NativeHAL::getPinLevel(MOTOR_PIN);
+    NativeHAL::setPinWriteHook([](uint8_t pin, uint8_t level, uint64_t timeUs) {
+        if (pin != MOTOR_PIN || level == g_lastLevel) {
+            return;
+        }
+        g_lastLevel = level;
+        g_edges.push_back(PinEdge{level, timeUs});
+    });
+}
+
+/**
+ * 按截止时间驱动的主循环：每次update()后休眠到控制器给出的下一次更新时刻
+ */
+void runSchedulerLoop(MotorController& motor, uint32_t durationMs) {
+    uint64_t end = NativeHAL::nowMicros() + (uint64_t)durationMs * 1000;
+    for (int guard = 0; guard < 100000 && NativeHAL::nowMicros() < end; guard++) {
+        motor.update();
+        uint64_t remaining = end - NativeHAL::nowMicros();
+        uint32_t wait = motor.getMicrosUntilNextUpdate();
+        NativeHAL::advanceMicros(wait < remaining ? wait : remaining);
+    }
+}
+
+MotorConfig makeConfig(bool autoStart) {
+    MotorConfig config;
+    config.runDurationMs = 2000;
+    config.stopDurationMs = 1000;
+    config.cycleCount = 0;
+    config.autoStart = autoStart;
+    return config;
+}
+
+} // namespace
+
+bool MotorProgramTest::runAllTests() {
+    LOG_TAG_INFO("ProgramTest", "开始电机程序测试...");
+
+    bool allPassed = true;
+
+    if (!testCompile()) {
+        LOG_TAG_ERROR("ProgramTest", "❌ 程序编译测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ProgramTest", "✅ 程序编译测试通过");
+    }
+
+    if (!testSerialization()) {
+        LOG_TAG_ERROR("ProgramTest", "❌ 程序存储格式测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ProgramTest", "✅ 程序存储格式测试通过");
+    }
+
+    if (!testRunnerTiming()) {
+        LOG_TAG_ERROR("ProgramTest", "❌ 程序执行时序测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ProgramTest", "✅ 程序执行时序测试通过");
+    }
+
+    if (!testControllerProgram()) {
+        LOG_TAG_ERROR("ProgramTest", "❌ 电机控制器程序执行测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("ProgramTest", "✅ 电机控制器程序执行测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("ProgramTest", "🎉 所有电机程序测试通过!");
+    } else {
+        LOG_TAG_ERROR("ProgramTest", "💥 部分电机程序测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool MotorProgramTest::testCompile() {
+    MotorProgram program;
+    buildCycleProgram(program);
+    if (!program.compile() || program.getTotalDurationMs() != 6000) {
+        LOG_TAG_ERROR("ProgramTest", "循环程序编译失败或总时长错误: %s", program.getLastError());
+        return false;
+    }
+    const ProgramInstruction& end = program.getInstruction(3);
+    if (end.op != ProgramOp::END_REPEAT || end.jumpTarget != 1 || end.repeatCount != 3 || end.depth != 0) {
+        LOG_TAG_ERROR("ProgramTest", "循环结束指令的跳转位置错误");
+        return false;
+    }
+
+    buildLongProgram(program);
+    // 250 + 200 * (3000 + 7 * 175 + 3 * (2 * 17 + 1999)) + 1
+    if (!program.compile() || program.getTotalDurationMs() != 250ULL + 200ULL * (3000 + 7 * 175 + 3 * (2 * 17 + 1999)) + 1) {
+        LOG_TAG_ERROR("ProgramTest", "嵌套程序编译失败或总时长错误");
+        return false;
+    }
+
+    program.clear();
+    program.beginRepeat(0);
+    program.addStep(100, true);
+    program.endRepeat();
+    if (!program.compile() || program.getTotalDurationMs() != MotorProgram::INFINITE_DURATION) {
+        LOG_TAG_ERROR("ProgramTest", "无限循环程序的总时长应为无限");
+        return false;
+    }
+
+    // 无效程序
+    struct InvalidCase {
+        const char* name;
+        void (*build)(MotorProgram&);
+    };
+    static const InvalidCase cases[] = {
+        {"空程序", [](MotorProgram&) {}},
+        {"步骤时长为0", [](MotorProgram& p) { p.addStep(0, true); }},
+        {"占空比超过100", [](MotorProgram& p) {
+            ProgramSetpoint setpoint = makeSetpoint(1000, 101, 0);
+            p.addStep(10, true, setpoint);
+        }},
+        {"缺少循环结束", [](MotorProgram& p) { p.beginRepeat(2); p.addStep(10, true); }},
+        {"多余的循环结束", [](MotorProgram& p) { p.addStep(10, true); p.endRepeat(); }},
+        {"循环体为空", [](MotorProgram& p) { p.addStep(10, true); p.beginRepeat(2); p.endRepeat(); }},
+        {"嵌套过深", [](MotorProgram& p) {
+            for (int i = 0; i <= MotorProgram::MAX_DEPTH; i++) {
+                p.beginRepeat(2);
+            }
+            p.addStep(10, true);
+            for (int i = 0; i <= MotorProgram::MAX_DEPTH; i++) {
+                p.endRepeat();
+            }
+        }},
+    };
+    for (const InvalidCase& invalid : cases) {
+        program.clear();
+        invalid.build(program);
+        if (program.compile()) {
+            LOG_TAG_ERROR("ProgramTest", "无效程序被接受: %s", invalid.name);
+            return false;
+        }
+        LOG_TAG_DEBUG("ProgramTest", "%s: %s", invalid.name, program.getLastError());
+    }
+
+    program.clear();
+    for (int i = 0; i < MotorProgram::MAX_INSTRUCTIONS; i++) {
+        program.addStep(10, i % 2 == 0);
+    }
+    if (program.addStep(10, true) || program.getInstructionCount() != MotorProgram::MAX_INSTRUCTIONS) {
+        LOG_TAG_ERROR("ProgramTest", "指令表满后仍能添加指令");
+        return false;
+    }
+    return true;
+}
+
+bool MotorProgramTest::testSerialization() {
+    MotorProgram program;
+    buildCycleProgram(program);
+    program.compile();
+
+    // 头部4 + REPEAT 2 + 带设定值的STEP 7 + STEP 3 + END 1 + CRC 2
+    uint8_t buffer[MotorProgram::MAX_SERIALIZED_SIZE];
+    size_t length = program.serialize(buffer, sizeof(buffer));
+    if (length != 19 || program.getSerializedSize() != length) {
+        LOG_TAG_ERROR("ProgramTest", "序列化长度错误: %u (预计%u)", (unsigned)length,
+                      (unsigned)program.getSerializedSize());
+        return false;
+    }
+
+    MotorProgram loaded;
+    if (!loaded.deserialize(buffer, length) || loaded.getInstructionCount() != program.getInstructionCount() ||
+        loaded.getTotalDurationMs() != program.getTotalDurationMs() || loaded.getSerializedSize() != length) {
+        LOG_TAG_ERROR("ProgramTest", "反序列化失败: %s", loaded.getLastError());
+        return false;
+    }
+    const ProgramInstruction& step = loaded.getInstruction(1);
+    if (step.op != ProgramOp::STEP || !step.motorOn || step.durationMs != 1500 ||
+        step.setpoint.mask != (ProgramSetpoint::FREQUENCY | ProgramSetpoint::DUTY | ProgramSetpoint::RAMP) ||
+        step.setpoint.frequency != 1000 || step.setpoint.dutyCycle != 50 || step.setpoint.rampTime != 5 ||
+        loaded.getInstruction(2).setpoint.mask != 0 || loaded.getInstruction(2).motorOn) {
+        LOG_TAG_ERROR("ProgramTest", "反序列化后的步骤内容错误");
+        return false;
+    }
+
+    // 最大的程序也能放进MAX_SERIALIZED_SIZE
+    MotorProgram large;
+    for (int i = 0; i < MotorProgram::MAX_INSTRUCTIONS; i++) {
+        large.addStep(0xFFFFFFFF, true, makeSetpoint(0xFFFFFFFF, 100, 0xFFFF));
+    }
+    if (!large.compile() || large.serialize(buffer, sizeof(buffer)) == 0) {
+        LOG_TAG_ERROR("ProgramTest", "最大程序无法序列化");
+        return false;
+    }
+    if (program.serialize(buffer, 10) != 0) {
+        LOG_TAG_ERROR("ProgramTest", "缓冲区不足时应返回0");
+        return false;
+    }
+
+    // 损坏的数据
+    length = program.serialize(buffer, sizeof(buffer));
+    buffer[6] ^= 0x01;
+    if (loaded.deserialize(buffer, length)) {
+        LOG_TAG_ERROR("ProgramTest", "CRC错误的数据被接受");
+        return false;
+    }
+    buffer[6] ^= 0x01;
+    if (loaded.deserialize(buffer, length - 1) || loaded.isCompiled()) {
+        LOG_TAG_ERROR("ProgramTest", "截断的数据被接受");
+        return false;
+    }
+
+    // 通过ConfigManager保存到NVS
+    ConfigManager& configManager = ConfigManager::getInstance();
+    if (!configManager.init()) {
+        LOG_TAG_ERROR("ProgramTest", "ConfigManager初始化失败");
+        return false;
+    }
+    configManager.deleteStoredProgram();
+    if (configManager.loadProgram(loaded)) {
+        LOG_TAG_ERROR("ProgramTest", "删除后仍能加载程序");
+        return false;
+    }
+    buildLongProgram(program);
+    program.compile();
+    if (!configManager.saveProgram(program) || !configManager.loadProgram(loaded) ||
+        loaded.getInstructionCount() != program.getInstructionCount() ||
+        loaded.getTotalDurationMs() != program.getTotalDurationMs() ||
+        program.getSerializedSize() != program.serialize(buffer, sizeof(buffer))) {
+        LOG_TAG_ERROR("ProgramTest", "NVS保存/加载程序失败");
+        return false;
+    }
+    LOG_TAG_INFO("ProgramTest", "嵌套程序: %u条指令, NVS占用%u字节",
+                 program.getInstructionCount(), (unsigned)program.getSerializedSize());
+    return configManager.deleteStoredProgram();
+}
+
+bool MotorProgramTest::testRunnerTiming() {
+    MotorProgram program;
+    buildLongProgram(program);
+    if (!program.compile()) {
+        return false;
+    }
+
+    std::vector<ExpectedStep> expected;
+    uint64_t totalMs = 0;
+    expand(program, 0, totalMs, expected);
+    if (totalMs != program.getTotalDurationMs()) {
+        LOG_TAG_ERROR("ProgramTest", "参考展开的总时长与编译结果不一致");
+        return false;
+    }
+
+    // 起点在millis()的32位回绕点之前（运行约49.7天），主循环间隔1~37ms随机
+    const uint64_t start = 0xFFFFFFFFULL - 5000;
+    uint64_t now = start;
+    uint32_t seed = 11;
+    uint32_t ticks = 0;
+    uint32_t transitions = 0;
+    MotorProgramRunner runner;
+    if (!runner.start(program, now) || runner.getCurrentIndex() != expected[0].index) {
+        LOG_TAG_ERROR("ProgramTest", "执行器启动失败");
+        return false;
+    }
+    while (runner.isRunning()) {
+        seed = seed * 1103515245u + 12345u;
+        now += 1 + (seed >> 16) % 37;
+        ticks++;
+        if (!runner.update(now)) {
+            continue;
+        }
+        transitions++;
+        if (!runner.isRunning()) {
+            break;
+        }
+        uint32_t executed = runner.getStepsExecuted();
+        if (executed > expected.size()) {
+            LOG_TAG_ERROR("ProgramTest", "执行的步骤数超过参考时间表");
+            return false;
+        }
+        const ExpectedStep& step = expected[executed - 1];
+        if (runner.getCurrentIndex() != step.index ||
+            runner.getStepStartMs() != start + step.startMs ||
+            now < runner.getStepStartMs() || now >= runner.getStepDeadlineMs()) {
+            LOG_TAG_ERROR("ProgramTest", "第%lu个步骤错误: 位置%u (应为%u), 开始%llu (应为%llu)", executed,
+                          runner.getCurrentIndex(), step.index, (unsigned long long)runner.getStepStartMs(),
+                          (unsigned long long)(start + step.startMs));
+            return false;
+        }
+    }
+    if (runner.getStepsExecuted() != expected.size() || runner.getStepDeadlineMs() != start + totalMs) {
+        LOG_TAG_ERROR("ProgramTest", "程序结束错误: 执行%lu个步骤 (应为%u), 结束时刻偏差%lldms",
+                      runner.getStepsExecuted(), (unsigned)expected.size(),
+                      (long long)(runner.getStepDeadlineMs() - (start + totalMs)));
+        return false;
+    }
+    LOG_TAG_INFO("ProgramTest", "模拟%.1f小时: %u个步骤, %lu次主循环, %lu次切换, 结束时刻误差0ms",
+                 totalMs / 3600000.0, (unsigned)expected.size(), ticks, transitions);
+
+    // 主循环长时间阻塞：一次update()跳过多个步骤，后续步骤仍按原时间表
+    runner.start(program, 0);
+    uint64_t late = expected[40].startMs + 3;
+    if (!runner.update(late) || runner.getStepsExecuted() != 41 || runner.getStepStartMs() != expected[40].startMs ||
+        runner.getMsUntilNextStep(late) != expected[41].startMs - late) {
+        LOG_TAG_ERROR("ProgramTest", "阻塞后追赶错误: 执行%lu个步骤, 开始%llu", runner.getStepsExecuted(),
+                      (unsigned long long)runner.getStepStartMs());
+        return false;
+    }
+
+    // 无限循环不会结束
+    program.clear();
+    program.beginRepeat(0);
+    program.addStep(5, true);
+    program.addStep(5, false);
+    program.endRepeat();
+    program.compile();
+    runner.start(program, 0);
+    for (uint32_t t = 1; t <= 100000; t++) {
+        runner.update(t);
+    }
+    if (!runner.isRunning() || runner.getStepsExecuted() != 20001 || runner.getStepStartMs() != 100000) {
+        LOG_TAG_ERROR("ProgramTest", "无限循环执行错误: 执行%lu个步骤", runner.getStepsExecuted());
+        return false;
+    }
+    return true;
+}
+
+bool MotorProgramTest::testControllerProgram() {
+    MotorController& motor = MotorController::getInstance();
+    if (!motor.init()) {
+        return false;
+    }
+    motor.updateConfig(makeConfig(false));
+    motor.stopMotor();
+    runSchedulerLoop(motor, 10);
+    if (!motor.isStopped()) {
+        LOG_TAG_ERROR("ProgramTest", "电机未停止");
+        return false;
+    }
+
+    std::vector<ProgramSetpoint> setpoints;
+    motor.setProgramSetpointHandler([&setpoints](const ProgramSetpoint& setpoint) {
+        setpoints.push_back(setpoint);
+    });
+
+    MotorProgram program;
+    buildCycleProgram(program);
+    program.compile();
+    if (!motor.loadProgram(program)) {
+        return false;
+    }
+
+    // 自动启动打开时程序结束后也应保持停止；从整毫秒开始，步骤截止时刻落在整毫秒上
+    motor.updateConfig(makeConfig(true));
+    NativeHAL::advanceMicros(1000 - NativeHAL::nowMicros() % 1000);
+    recordEdges();
+    uint64_t startUs = NativeHAL::nowMicros();
+    bool started = motor.startProgram();
+    runSchedulerLoop(motor, 9000);
+    NativeHAL::setPinWriteHook(nullptr);
+
+    static const uint64_t expectedMs[] = {0, 1500, 2000, 3500, 4000, 5500};
+    bool edgesOk = started && g_edges.size() == 6;
+    for (size_t i = 0; edgesOk && i < g_edges.size(); i++) {
+        edgesOk = g_edges[i].level == (i % 2 == 0 ? MOTOR_ON : MOTOR_OFF) &&
+                  g_edges[i].timeUs - startUs == expectedMs[i] * 1000;
+    }
+    if (!edgesOk) {
+        LOG_TAG_ERROR("ProgramTest", "程序的GPIO切换错误 (%u次)", (unsigned)g_edges.size());
+        for (size_t i = 0; i < g_edges.size(); i++) {
+            LOG_TAG_ERROR("ProgramTest", "  电平%u @ %lluus", g_edges[i].level,
+                          (unsigned long long)(g_edges[i].timeUs - startUs));
+        }
+        motor.setProgramSetpointHandler(nullptr);
+        return false;
+    }
+    if (setpoints.size() != 3 || setpoints[0].frequency != 1000 || setpoints[0].dutyCycle != 50 ||
+        setpoints[0].rampTime != 5) {
+        LOG_TAG_ERROR("ProgramTest", "调速器设定值下发错误 (%u次)", (unsigned)setpoints.size());
+        motor.setProgramSetpointHandler(nullptr);
+        return false;
+    }
+    if (motor.isProgramRunning() || !motor.isStopped() ||
+        motor.getMicrosUntilNextUpdate() != DeadlineScheduler::NO_DEADLINE) {
+        LOG_TAG_ERROR("ProgramTest", "程序结束后电机应保持停止");
+        motor.setProgramSetpointHandler(nullptr);
+        return false;
+    }
+
+    // 中途停止：立即关闭电机并保持停止
+    motor.startProgram();
+    runSchedulerLoop(motor, 700);
+    bool runningMidway = motor.isProgramRunning() && NativeHAL::getPinLevel(MOTOR_PIN) == MOTOR_ON;
+    bool stopped = motor.stopProgram();
+    runSchedulerLoop(motor, 3000);
+    motor.setProgramSetpointHandler(nullptr);
+    if (!runningMidway || !stopped || motor.isProgramRunning() || NativeHAL::getPinLevel(MOTOR_PIN) != MOTOR_OFF) {
+        LOG_TAG_ERROR("ProgramTest", "中途停止程序失败");
+        return false;
+    }
+
+    // 启动命令恢复运行/停止循环
+    motor.startMotor();
+    runSchedulerLoop(motor, 100);
+    bool resumed = motor.isRunning() && !motor.isProgramRunning();
+    motor.updateConfig(makeConfig(false));
+    motor.stopMotor();
+    runSchedulerLoop(motor, 10);
+    if (!resumed) {
+        LOG_TAG_ERROR("ProgramTest", "启动命令未恢复运行/停止循环");
+        return false;
+    }
+    return motor.isStopped();
+}
+
+#endif // NATIVE_BUILD
@@ -0,0 +1,46 @@
+#ifndef MOTOR_PROGRAM_TEST_H
+#define MOTOR_PROGRAM_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * 多段电机程序测试（编译、NVS存储格式、执行器时序和控制器集成，仅在native环境运行）
+ */
+class MotorProgramTest {
+public:
+    /**
+     * 运行所有电机程序测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试程序结构检查、循环跳转和总时长计算
+     * @return 测试是否通过
+     */
+    static bool testCompile();
+
+    /**
+     * 测试序列化格式、损坏数据检测和通过ConfigManager保存到NVS
+     * @return 测试是否通过
+     */
+    static bool testSerialization();
+
+    /**
+     * 主机模拟：长程序在随机主循环间隔下执行，每个步骤的开始时刻与展开后的参考时间表完全一致
+     * @return 测试是否通过
+     */
+    static bool testRunnerTiming();
+
+    /**
+     * 测试MotorController执行程序：GPIO切换时刻、调速器设定值、结束后保持停止和中途停止
+     * @return 测试是否通过
+     */
+    static bool testControllerProgram();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // MOTOR_PROGRAM_TEST_H
@@ -46,6 +46,14 @@ bool NVSStorageTest::runAllTests() {
         LOG_TAG_INFO("NVSTest", "✅ 数据持久化测试通过");
     }
     
+    // 测试旧版本配置迁移功能
+    if (!testLegacyDurationMigration()) {
+        LOG_TAG_ERROR("NVSTest", "❌ 旧版本配置迁移测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("NVSTest", "✅ 旧版本配置迁移测试通过");
+    }
+    
     if (allPassed) {
         LOG_TAG_INFO("NVSTest", "🎉 所有NVS存储驱动测试通过!");
     } else {
@@ -67,8 +75,8 @@ bool NVSStorageTest::testSaveConfig() {
     }
     
     MotorConfig config;
-    config.runDuration = 10;
-    config.stopDuration = 5;
+    config.runDurationMs = 10000;
+    config.stopDurationMs = 5000;
     config.cycleCount = 10;
     config.autoStart = true;
     
@@ -87,8 +95,8 @@ bool NVSStorageTest::testLoadConfig() {
     }
     
     // 验证读取的数据是否正确
-    return (config.runDuration == 10) &&
-           (config.stopDuration == 5) &&
+    return (config.runDurationMs == 10000) &&
+           (config.stopDurationMs == 5000) &&
            (config.cycleCount == 10) &&
            (config.autoStart == true);
 }
@@ -101,8 +109,8 @@ bool NVSStorageTest::testDeleteConfig() {
     
     // 先保存一个配置
     MotorConfig config;
-    config.runDuration = 20;
-    config.stopDuration = 10;
+    config.runDurationMs = 20000;
+    config.stopDurationMs = 10000;
     config.cycleCount = 20;
     config.autoStart = false;
     
@@ -120,7 +128,7 @@ bool NVSStorageTest::testDeleteConfig() {
     // 读取应该失败或返回默认值
     nvsStorage.loadConfig(loadedConfig);
     // 由于loadConfig不会在键不存在时返回false，我们需要检查值是否为默认值
-    return (loadedConfig.runDuration != 20);
+    return (loadedConfig.runDurationMs != 20000);
 }
 
 bool NVSStorageTest::testPersistence() {
@@ -131,8 +139,8 @@ bool NVSStorageTest::testPersistence() {
     
     // 保存配置
     MotorConfig config;
-    config.runDuration = 30;
-    config.stopDuration = 15;
+    config.runDurationMs = 30000;
+    config.stopDurationMs = 15000;
     config.cycleCount = 30;
     config.autoStart = true;
     
@@ -153,8 +161,49 @@ bool NVSStorageTest::testPersistence() {
     }
     
     // 验证数据是否持久化
-    return (loadedConfig.runDuration == 30) &&
-           (loadedConfig.stopDuration == 15) &&
+    return (loadedConfig.runDurationMs == 30000) &&
+           (loadedConfig.stopDurationMs == 15000) &&
            (loadedConfig.cycleCount == 30) &&
            (loadedConfig.autoStart == true);
+}
+
+bool NVSStorageTest::testLegacyDurationMigration() {
+    NVSStorageDriver nvsStorage;
+    if (!nvsStorage.init() || !nvsStorage.deleteConfig()) {
+        return false;
+    }
+    
+    // 模拟旧固件写入的配置：时长以秒为单位
+    nvs_handle_t handle;
+    if (nvs_open("motor_config", NVS_READWRITE, &handle) != ESP_OK) {
+        return false;
+    }
+    bool written = nvs_set_u32(handle, "runDuration", 12) == ESP_OK &&
+                   nvs_set_u32(handle, "stopDuration", 3) == ESP_OK &&
+                   nvs_commit(handle) == ESP_OK;
+    nvs_close(handle);
+    if (!written || !nvsStorage.isConfigExist()) {
+        return false;
+    }
+    
+    MotorConfig config;
+    if (!nvsStorage.loadConfig(config) || config.runDurationMs != 12000 || config.stopDurationMs != 3000) {
+        return false;
+    }
+    
+    // 重新保存后只保留毫秒键，亚秒级时长不丢失
+    config.runDurationMs = 250;
+    if (!nvsStorage.saveConfig(config)) {
+        return false;
+    }
+    uint32_t legacy = 0;
+    if (nvs_open("motor_config", NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    bool legacyErased = nvs_get_u32(handle, "runDuration", &legacy) == ESP_ERR_NVS_NOT_FOUND;
+    nvs_close(handle);
+    
+    MotorConfig reloaded;
+    return legacyErased && nvsStorage.loadConfig(reloaded) &&
+           reloaded.runDurationMs == 250 && reloaded.stopDurationMs == 3000;
 }
\ No newline at end of file
@@ -41,6 +41,12 @@ public:
      * @return 测试是否通过
      */
     static bool testPersistence();
+    
+    /**
+     * 测试读取旧版本以秒保存的运行/停止时长并换算为毫秒
+     * @return 测试是否通过
+     */
+    static bool testLegacyDurationMigration();
 };
 
 #endif // NVS_STORAGE_TEST_H
\ No newline at end of file
@@ -0,0 +1,353 @@
+#include "SetpointRampTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <math.h>
+#include <vector>
+#include "SimulatedModbusSlave.h"
+#include "../common/RampGenerator.h"
+#include "../common/SetpointRamp.h"
+#include "../common/Logger.h"
+#include "../controllers/MotorModbusController.h"
+
+namespace {
+
+const uint32_t ONE = RampGenerator::ONE;
+
+/**
+ * 浮点参考曲线
+ */
+double referenceShape(RampProfile profile, double p) {
+    switch (profile) {
+        case RampProfile::S_CURVE:
+            return p * p * (3.0 - 2.0 * p);
+        case RampProfile::EXPONENTIAL:
+            return (1.0 - pow(2.0, -8.0 * p)) / (1.0 - pow(2.0, -8.0));
+        case RampProfile::LINEAR:
+        default:
+            return p;
+    }
+}
+
+struct Emission {
+    uint64_t timeUs;
+    SetpointRamp::Setpoint value;
+};
+
+// 模拟调速器寄存器 0x0000 ~ 0x000B（频率100000Hz，占空比55%）
+void loadSpeedControllerRegisters(SimulatedModbusSlave& slave) {
+    const uint16_t values[] = {1, 1, 0, 1, 10, 90, 30, 20, 0, 0x0001, 0x86A0, 55};
+    for (uint16_t i = 0; i < 12; i++) {
+        slave.setRegister(i, values[i]);
+    }
+}
+
+uint32_t slaveFrequency(const SimulatedModbusSlave& slave) {
+    return ((uint32_t)slave.getRegister(0x0009) << 16) | slave.getRegister(0x000A);
+}
+
+/**
+ * 每毫秒推进一次，直到斜坡结束且队列空闲；记录从站占空比的变化
+ */
+void pumpRamp(MotorModbusController& controller, SimulatedModbusSlave& slave, std::vector<uint16_t>& duties,
+              uint32_t maxIterations = 5000) {
+    for (uint32_t i = 0; i < maxIterations; i++) {
+        controller.update();
+        NativeHAL::advanceMicros(1000);
+        uint16_t duty = slave.getRegister(0x000B);
+        if (duties.empty() || duties.back() != duty) {
+            duties.push_back(duty);
+        }
+        if (!controller.isRamping() && !controller.hasPendingWork()) {
+            return;
+        }
+    }
+}
+
+} // namespace
+
+bool SetpointRampTest::runAllTests() {
+    LOG_TAG_INFO("RampTest", "开始设定值斜坡测试...");
+
+    bool allPassed = true;
+
+    if (!testProfiles()) {
+        LOG_TAG_ERROR("RampTest", "❌ 斜坡曲线测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("RampTest", "✅ 斜坡曲线测试通过");
+    }
+
+    if (!testEmitRateLimit()) {
+        LOG_TAG_ERROR("RampTest", "❌ 输出限速与合并测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("RampTest", "✅ 输出限速与合并测试通过");
+    }
+
+    if (!testModbusRamp()) {
+        LOG_TAG_ERROR("RampTest", "❌ MODBUS设定值斜坡测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("RampTest", "✅ MODBUS设定值斜坡测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("RampTest", "🎉 所有设定值斜坡测试通过!");
+    } else {
+        LOG_TAG_ERROR("RampTest", "💥 部分设定值斜坡测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool SetpointRampTest::testProfiles() {
+    const RampProfile profiles[] = {RampProfile::LINEAR, RampProfile::S_CURVE, RampProfile::EXPONENTIAL};
+    for (size_t n = 0; n < sizeof(profiles) / sizeof(profiles[0]); n++) {
+        RampProfile profile = profiles[n];
+        if (RampGenerator::shape(profile, 0) != 0 || RampGenerator::shape(profile, ONE) != ONE) {
+            LOG_TAG_ERROR("RampTest", "曲线%u端点错误", (unsigned)n);
+            return false;
+        }
+        uint32_t previous = 0;
+        for (uint32_t p = 0; p <= ONE; p += 16) {
+            uint32_t value = RampGenerator::shape(profile, p);
+            double reference = referenceShape(profile, (double)p / ONE) * ONE;
+            if (value < previous || value > ONE || fabs(value - reference) > 32) {
+                LOG_TAG_ERROR("RampTest", "曲线%u在进度%lu处为%lu (参考%.1f, 前一值%lu)",
+                              (unsigned)n, (unsigned long)p, (unsigned long)value, reference, (unsigned long)previous);
+                return false;
+            }
+            previous = value;
+        }
+    }
+
+    // S曲线关于中点对称，四分之一处为5/32
+    if (RampGenerator::shape(RampProfile::S_CURVE, ONE / 2) != ONE / 2 ||
+        RampGenerator::shape(RampProfile::S_CURVE, ONE / 4) != ONE * 5 / 32) {
+        LOG_TAG_ERROR("RampTest", "S曲线中点/四分之一点错误");
+        return false;
+    }
+
+    // 斜坡发生器按所选曲线输出，结束时精确到达目标
+    RampGenerator ramp;
+    ramp.setProfile(RampProfile::S_CURVE);
+    ramp.reset(0);
+    ramp.start(1000, 1000000, 0);
+    if (ramp.valueAt(250000) != 156 || ramp.valueAt(500000) != 500 || ramp.valueAt(999999) > 1000) {
+        LOG_TAG_ERROR("RampTest", "S曲线斜坡输出错误 (%ld, %ld)", (long)ramp.valueAt(250000), (long)ramp.valueAt(500000));
+        return false;
+    }
+    ramp.update(1000000);
+    if (ramp.getValue() != 1000 || ramp.isActive()) {
+        LOG_TAG_ERROR("RampTest", "S曲线斜坡未到达目标");
+        return false;
+    }
+
+    // 指数曲线先快后慢：1/8处已完成约一半，中点处约94%
+    ramp.setProfile(RampProfile::EXPONENTIAL);
+    ramp.start(-1000, 800000, 0);
+    int32_t early = ramp.valueAt(100000);
+    int32_t middle = ramp.valueAt(400000);
+    if (early < -10 || early > 0 || middle < -890 || middle > -875) {
+        LOG_TAG_ERROR("RampTest", "指数斜坡输出错误 (%ld, %ld)", (long)early, (long)middle);
+        return false;
+    }
+    ramp.update(800000);
+    return ramp.getValue() == -1000 && !ramp.isActive();
+}
+
+bool SetpointRampTest::testEmitRateLimit() {
+    SetpointRamp ramp;
+    ramp.setEmitInterval(100000);
+    SetpointRamp::Setpoint start = {1000, 0};
+    SetpointRamp::Setpoint target = {1100, 100};
+    ramp.reset(start);
+
+    // 起点与调速器一致时不输出
+    SetpointRamp::Setpoint out;
+    if (ramp.poll(0, out) || ramp.isBusy()) {
+        LOG_TAG_ERROR("RampTest", "未开始斜坡时不应输出");
+        return false;
+    }
+
+    // 1秒线性斜坡、每毫秒查询一次、立即确认：11ms处第一次变化，之后每100ms一次，1011ms输出目标值
+    ramp.start(target, 1000000, 0);
+    std::vector<Emission> emissions;
+    for (uint64_t t = 0; t <= 1500000; t += 1000) {
+        if (ramp.poll(t, out)) {
+            emissions.push_back(Emission{t, out});
+            ramp.acknowledge(true);
+        }
+    }
+    if (emissions.size() != 11 || emissions.front().timeUs != 11000 || emissions.back().timeUs != 1011000) {
+        LOG_TAG_ERROR("RampTest", "输出次数或时刻错误 (%u次)", (unsigned)emissions.size());
+        return false;
+    }
+    for (size_t i = 1; i < emissions.size(); i++) {
+        if (emissions[i].timeUs - emissions[i - 1].timeUs < 100000 ||
+            emissions[i].value.frequency < emissions[i - 1].value.frequency ||
+            emissions[i].value.dutyCycle < emissions[i - 1].value.dutyCycle) {
+            LOG_TAG_ERROR("RampTest", "第%u次输出间隔不足或不单调", (unsigned)i);
+            return false;
+        }
+    }
+    if (emissions.back().value.frequency != 1100 || emissions.back().value.dutyCycle != 100 || ramp.isBusy() ||
+        ramp.getMicrosUntilNextEmit(1500000) != SetpointRamp::NO_UPDATE) {
+        LOG_TAG_ERROR("RampTest", "斜坡结束后应输出目标值并空闲");
+        return false;
+    }
+
+    // 写入在途时不输出；确认后直接输出最新值，中间值被合并
+    uint64_t base = 2000000;
+    SetpointRamp::Setpoint next = {3000, 50};
+    ramp.start(next, 200000, base);
+    if (!ramp.poll(base + 1000, out)) {
+        LOG_TAG_ERROR("RampTest", "间隔已过时应立即输出");
+        return false;
+    }
+    for (uint64_t t = base + 2000; t <= base + 500000; t += 1000) {
+        if (ramp.poll(t, out)) {
+            LOG_TAG_ERROR("RampTest", "写入在途时不应输出");
+            return false;
+        }
+    }
+    if (!ramp.isBusy() || ramp.getMicrosUntilNextEmit(base + 500000) != SetpointRamp::NO_UPDATE) {
+        LOG_TAG_ERROR("RampTest", "在途时应为忙且等待确认");
+        return false;
+    }
+    ramp.acknowledge(true);
+    if (!ramp.poll(base + 501000, out) || out.frequency != 3000 || out.dutyCycle != 50) {
+        LOG_TAG_ERROR("RampTest", "确认后应输出最新值");
+        return false;
+    }
+
+    // 写入失败：下一个间隔重发当前值
+    ramp.acknowledge(false);
+    if (ramp.poll(base + 550000, out) || ramp.getMicrosUntilNextEmit(base + 550000) != 51000) {
+        LOG_TAG_ERROR("RampTest", "失败重发应遵守输出间隔");
+        return false;
+    }
+    if (!ramp.poll(base + 601000, out) || out.frequency != 3000 || ramp.getEmitCount() != 14) {
+        LOG_TAG_ERROR("RampTest", "写入失败后应重发 (输出%lu次)", (unsigned long)ramp.getEmitCount());
+        return false;
+    }
+    ramp.acknowledge(true);
+
+    // 放弃后没有起点：下一次斜坡直接跳到目标值
+    ramp.clear();
+    SetpointRamp::Setpoint jump = {500, 10};
+    ramp.start(jump, 1000000, base + 1000000);
+    if (!ramp.poll(base + 1000000, out) || out.frequency != 500 || out.dutyCycle != 10 || ramp.isRamping()) {
+        LOG_TAG_ERROR("RampTest", "起点未知时应直接跳到目标值");
+        return false;
+    }
+    ramp.acknowledge(true);
+    return !ramp.isBusy();
+}
+
+bool SetpointRampTest::testModbusRamp() {
+    MotorModbusController controller;
+    controller.begin(0x01);
+    SimulatedModbusSlave slave(0x01);
+    slave.attach(Serial2);
+    loadSpeedControllerRegisters(slave);
+
+    // 缓存中有新鲜的频率/占空比作为起点
+    MotorModbusController::AllConfig config;
+    if (!controller.getAllConfig(config)) {
+        LOG_TAG_ERROR("RampTest", "读取所有配置失败");
+        return false;
+    }
+    slave.clearRequestLog();
+
+    // 1秒S曲线斜坡：100000Hz/55% -> 50000Hz/85%，默认每100ms最多写一帧
+    controller.setRampProfile(RampProfile::S_CURVE);
+    if (!controller.rampOutput(50000, 85, 1000)) {
+        LOG_TAG_ERROR("RampTest", "开始斜坡失败");
+        return false;
+    }
+    std::vector<uint16_t> duties;
+    pumpRamp(controller, slave, duties);
+
+    const std::vector<SimulatedModbusSlave::RequestRecord>& log = slave.getRequestLog();
+    if (log.size() < 5 || log.size() > 12) {
+        LOG_TAG_ERROR("RampTest", "写帧数量应受输出间隔限制 (%u帧)", (unsigned)log.size());
+        return false;
+    }
+    for (size_t i = 0; i < log.size(); i++) {
+        // 与缓存相同的寄存器被写合并跳过，帧可能从频率低字或占空比开始
+        if (log[i].address < 0x0009 || log[i].address > 0x000B ||
+            (i > 0 && log[i].timeMicros - log[i - 1].timeMicros < (uint64_t)MODBUS_SETPOINT_EMIT_INTERVAL_MS * 1000)) {
+            LOG_TAG_ERROR("RampTest", "第%u帧地址或间隔错误 (0x%04X, %llu us)", (unsigned)i, log[i].address,
+                          (unsigned long long)(i > 0 ? log[i].timeMicros - log[i - 1].timeMicros : 0));
+            return false;
+        }
+    }
+    LOG_TAG_INFO("RampTest", "1秒斜坡共%u帧，占空比经过%u个值", (unsigned)log.size(), (unsigned)duties.size());
+    for (size_t i = 1; i < duties.size(); i++) {
+        if (duties[i] < duties[i - 1]) {
+            LOG_TAG_ERROR("RampTest", "占空比轨迹不单调");
+            return false;
+        }
+    }
+    if (slaveFrequency(slave) != 50000 || slave.getRegister(0x000B) != 85 ||
+        controller.getTransactionQueue().getStatistics().maxDepth > 1) {
+        LOG_TAG_ERROR("RampTest", "斜坡结束值错误或队列积压 (%lu Hz, %u%%, 深度%u)",
+                      (unsigned long)slaveFrequency(slave), slave.getRegister(0x000B),
+                      controller.getTransactionQueue().getStatistics().maxDepth);
+        return false;
+    }
+
+    // 不限速时由在途确认合并：总线忙时不排队新的设定值
+    slave.clearRequestLog();
+    controller.setRampEmitInterval(0);
+    controller.setRampProfile(RampProfile::LINEAR);
+    controller.rampDutyCycle(15, 500);
+    duties.clear();
+    pumpRamp(controller, slave, duties);
+    if (slave.getRegister(0x000B) != 15 || slaveFrequency(slave) != 50000 ||
+        slave.getRequestCount() > 500 / 20 || controller.getTransactionQueue().getStatistics().maxDepth > 1 ||
+        controller.getOutputRamp().getEmitCount() == 0) {
+        LOG_TAG_ERROR("RampTest", "不限速斜坡结束值错误或未合并 (%lu帧)", slave.getRequestCount());
+        return false;
+    }
+
+    // 直接写入占空比取消进行中的斜坡
+    controller.setRampEmitInterval(MODBUS_SETPOINT_EMIT_INTERVAL_MS);
+    controller.rampDutyCycle(95, 2000);
+    for (int i = 0; i < 300; i++) {
+        controller.update();
+        NativeHAL::advanceMicros(1000);
+    }
+    controller.requestDutyCycle(40);
+    duties.clear();
+    pumpRamp(controller, slave, duties);
+    if (controller.isRamping() || slave.getRegister(0x000B) != 40) {
+        LOG_TAG_ERROR("RampTest", "直接写入后斜坡应取消 (占空比%u)", slave.getRegister(0x000B));
+        return false;
+    }
+    for (int i = 0; i < 2000; i++) {
+        controller.update();
+        NativeHAL::advanceMicros(1000);
+    }
+    if (slave.getRegister(0x000B) != 40) {
+        LOG_TAG_ERROR("RampTest", "斜坡取消后不应再写入");
+        return false;
+    }
+
+    // 起点未知（缓存作废）且只给出占空比：直接写入
+    controller.invalidateCache();
+    controller.rampDutyCycle(70, 1000);
+    duties.clear();
+    pumpRamp(controller, slave, duties);
+    if (slave.getRegister(0x000B) != 70 || duties.size() != 2) {
+        LOG_TAG_ERROR("RampTest", "起点未知时应直接写入目标值");
+        return false;
+    }
+
+    return true;
+}
+
+#endif // NATIVE_BUILD
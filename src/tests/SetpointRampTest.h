@@ -0,0 +1,40 @@
+#ifndef SETPOINT_RAMP_TEST_H
+#define SETPOINT_RAMP_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * 设定值斜坡测试（斜坡曲线、输出限速与合并、MODBUS调速器集成，仅在native环境运行）
+ */
+class SetpointRampTest {
+public:
+    /**
+     * 运行所有设定值斜坡测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试三种斜坡曲线的定点轨迹：端点精确、单调、与浮点参考值一致
+     * @return 测试是否通过
+     */
+    static bool testProfiles();
+
+    /**
+     * 测试输出限速：间隔不小于设定值、目标值一定输出；写入在途时合并、失败后重发
+     * @return 测试是否通过
+     */
+    static bool testEmitRateLimit();
+
+    /**
+     * 测试MotorModbusController斜坡：写帧数量和间隔受限、队列中最多一帧、直接写入取消斜坡
+     * @return 测试是否通过
+     */
+    static bool testModbusRamp();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // SETPOINT_RAMP_TEST_H
@@ -0,0 +1,184 @@
+#include "SimulatedModbusSlave.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include "../drivers/ModbusCRC.h"
+
+SimulatedModbusSlave::SimulatedModbusSlave(uint8_t slaveAddress)
+    : serial(nullptr), ownsHandler(false), online(true), slaveAddress(slaveAddress), responseDelayUs(0),
+      dropCount(0), corruptCount(0), rejectCode(0), rejectCount(0), dropEvery(0), requestCount(0) {
+    memset(registers, 0, sizeof(registers));
+}
+
+SimulatedModbusSlave::~SimulatedModbusSlave() {
+    detach();
+}
+
+void SimulatedModbusSlave::attach(HardwareSerial& port) {
+    serial = &port;
+    ownsHandler = true;
+    serial->simReset();
+    serial->simSetTxHandler([this](const uint8_t* data, size_t length) {
+        handleRequest(data, length);
+    });
+}
+
+void SimulatedModbusSlave::detach() {
+    if (serial && ownsHandler) {
+        serial->simSetTxHandler(nullptr);
+        serial->simReset();
+    }
+    serial = nullptr;
+    ownsHandler = false;
+}
+
+uint16_t SimulatedModbusSlave::getRegister(uint16_t address) const {
+    return address < REGISTER_COUNT ? registers[address] : 0;
+}
+
+void SimulatedModbusSlave::setRegister(uint16_t address, uint16_t value) {
+    if (address < REGISTER_COUNT) {
+        registers[address] = value;
+    }
+}
+
+void SimulatedModbusSlave::handleRequest(const uint8_t* data, size_t length) {
+    // 离线、地址不符或CRC错误的请求从站不应答
+    if (!online || length < 8 || data[0] != slaveAddress || ModbusCRC::calculate(data, length) != 0) {
+        return;
+    }
+
+    requestCount++;
+    uint8_t functionCode = data[1];
+    uint16_t address = (data[2] << 8) | data[3];
+    requestLog.push_back({functionCode, address, NativeHAL::nowMicros()});
+
+    if (dropCount > 0) {
+        dropCount--;
+        return;
+    }
+    if (dropEvery > 0 && requestCount % dropEvery == 0) {
+        return;
+    }
+    if (rejectCount > 0) {
+        rejectCount--;
+        sendException(functionCode, rejectCode);
+        return;
+    }
+
+    uint8_t response[256];
+    response[0] = slaveAddress;
+    response[1] = functionCode;
+
+    switch (functionCode) {
+        case 0x03: {
+            uint16_t quantity = (data[4] << 8) | data[5];
+            if (quantity == 0 || quantity > 125 || address + quantity > REGISTER_COUNT) {
+                sendException(functionCode, 0x02);
+                return;
+            }
+            response[2] = quantity * 2;
+            for (uint16_t i = 0; i < quantity; i++) {
+                response[3 + i * 2] = (registers[address + i] >> 8) & 0xFF;
+                response[4 + i * 2] = registers[address + i] & 0xFF;
+            }
+            sendResponse(response, 3 + quantity * 2);
+            return;
+        }
+        case 0x06: {
+            if (address >= REGISTER_COUNT) {
+                sendException(functionCode, 0x02);
+                return;
+            }
+            registers[address] = (data[4] << 8) | data[5];
+            memcpy(response, data, 6);
+            sendResponse(response, 6);
+            return;
+        }
+        case 0x10: {
+            uint16_t quantity = (data[4] << 8) | data[5];
+            if (quantity == 0 || length != 9u + quantity * 2 || address + quantity > REGISTER_COUNT) {
+                sendException(functionCode, 0x02);
+                return;
+            }
+            for (uint16_t i = 0; i < quantity; i++) {
+                registers[address + i] = (data[7 + i * 2] << 8) | data[8 + i * 2];
+            }
+            memcpy(response, data, 6);
+            sendResponse(response, 6);
+            return;
+        }
+        default:
+            sendException(functionCode, 0x01);
+            return;
+    }
+}
+
+void SimulatedModbusSlave::sendResponse(uint8_t* response, uint16_t length) {
+    uint16_t crc = ModbusCRC::calculate(response, length);
+    response[length] = crc & 0xFF;
+    response[length + 1] = (crc >> 8) & 0xFF;
+
+    if (corruptCount > 0) {
+        corruptCount--;
+        response[length] ^= 0xFF;
+    }
+
+    serial->simInject(response, length + 2, responseDelayUs);
+}
+
+void SimulatedModbusSlave::sendException(uint8_t functionCode, uint8_t exceptionCode) {
+    uint8_t response[5];
+    response[0] = slaveAddress;
+    response[1] = functionCode | 0x80;
+    response[2] = exceptionCode;
+    sendResponse(response, 3);
+}
+
+SimulatedModbusBus::SimulatedModbusBus() : serial(nullptr) {
+}
+
+SimulatedModbusBus::~SimulatedModbusBus() {
+    detach();
+}
+
+void SimulatedModbusBus::attach(HardwareSerial& port) {
+    serial = &port;
+    serial->simReset();
+    for (size_t i = 0; i < slaves.size(); i++) {
+        slaves[i]->serial = serial;
+    }
+    serial->simSetTxHandler([this](const uint8_t* data, size_t length) {
+        for (size_t i = 0; i < slaves.size(); i++) {
+            slaves[i]->handleRequest(data, length);
+        }
+    });
+}
+
+void SimulatedModbusBus::detach() {
+    if (serial) {
+        serial->simSetTxHandler(nullptr);
+        serial->simReset();
+        serial = nullptr;
+    }
+    for (size_t i = 0; i < slaves.size(); i++) {
+        slaves[i]->serial = nullptr;
+    }
+}
+
+void SimulatedModbusBus::addSlave(SimulatedModbusSlave& slave) {
+    slave.detach();
+    slave.serial = serial;
+    slaves.push_back(&slave);
+}
+
+uint32_t SimulatedModbusBus::getRequestCount() const {
+    uint32_t count = 0;
+    for (size_t i = 0; i < slaves.size(); i++) {
+        count += slaves[i]->getRequestCount();
+    }
+    return count;
+}
+
+#endif // NATIVE_BUILD
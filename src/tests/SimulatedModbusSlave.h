@@ -0,0 +1,105 @@
+#ifndef SIMULATED_MODBUS_SLAVE_H
+#define SIMULATED_MODBUS_SLAVE_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+#include <vector>
+
+/**
+ * 主机测试用的模拟MODBUS从站
+ * 挂接到模拟UART的发送回调上，收到请求后按波特率时序注入应答。
+ * 支持0x03/0x06/0x10，可注入丢包、CRC错误、异常应答和应答延迟。
+ */
+class SimulatedModbusSlave {
+public:
+    static const uint16_t REGISTER_COUNT = 64;
+
+    /**
+     * 请求记录
+     */
+    struct RequestRecord {
+        uint8_t functionCode;
+        uint16_t address;
+        uint64_t timeMicros;
+    };
+
+    explicit SimulatedModbusSlave(uint8_t slaveAddress = 0x01);
+    ~SimulatedModbusSlave();
+
+    /**
+     * 挂接到模拟串口并清空收发缓冲
+     */
+    void attach(HardwareSerial& serial);
+    void detach();
+
+    // 寄存器访问
+    uint16_t getRegister(uint16_t address) const;
+    void setRegister(uint16_t address, uint16_t value);
+
+    // 故障注入
+    void setOnline(bool value) { online = value; }
+    void setResponseDelayMicros(uint32_t delayUs) { responseDelayUs = delayUs; }
+    void dropNextRequests(uint32_t count) { dropCount = count; }
+    void corruptNextResponses(uint32_t count) { corruptCount = count; }
+    /**
+     * 接下来的N个请求以指定异常码应答，不执行请求
+     */
+    void rejectNextRequests(uint8_t exceptionCode, uint32_t count) { rejectCode = exceptionCode; rejectCount = count; }
+    /**
+     * 每隔N个请求丢弃一个（0表示不丢弃）
+     */
+    void setDropEvery(uint32_t n) { dropEvery = n; }
+
+    // 统计
+    uint32_t getRequestCount() const { return requestCount; }
+    const std::vector<RequestRecord>& getRequestLog() const { return requestLog; }
+    void clearRequestLog() { requestLog.clear(); requestCount = 0; }
+
+private:
+    friend class SimulatedModbusBus;
+
+    void handleRequest(const uint8_t* data, size_t length);
+    void sendResponse(uint8_t* response, uint16_t length);
+    void sendException(uint8_t functionCode, uint8_t exceptionCode);
+
+    HardwareSerial* serial;
+    bool ownsHandler;           // 单独挂接时占用串口发送回调，挂在总线上时由总线分发
+    bool online;
+    uint8_t slaveAddress;
+    uint16_t registers[REGISTER_COUNT];
+    uint32_t responseDelayUs;
+    uint32_t dropCount;
+    uint32_t corruptCount;
+    uint8_t rejectCode;
+    uint32_t rejectCount;
+    uint32_t dropEvery;
+    uint32_t requestCount;
+    std::vector<RequestRecord> requestLog;
+};
+
+/**
+ * 多个模拟从站共用一条模拟总线：主站发出的每一帧分发给所有从站，由地址匹配的从站应答
+ */
+class SimulatedModbusBus {
+public:
+    SimulatedModbusBus();
+    ~SimulatedModbusBus();
+
+    void attach(HardwareSerial& serial);
+    void detach();
+    void addSlave(SimulatedModbusSlave& slave);
+
+    /**
+     * 所有从站收到的有效请求总数
+     */
+    uint32_t getRequestCount() const;
+
+private:
+    HardwareSerial* serial;
+    std::vector<SimulatedModbusSlave*> slaves;
+};
+
+#endif // NATIVE_BUILD
+
+#endif // SIMULATED_MODBUS_SLAVE_H
@@ -2,8 +2,11 @@
 #include "../common/StateManager.h"
 #include <Arduino.h>
 
-void StateManagerTest::runAllTests() {
+uint32_t StateManagerTest::failureCount = 0;
+
+bool StateManagerTest::runAllTests() {
     Serial.println("=== StateManager Tests ===");
+    failureCount = 0;
     
     testInitialState();
     testValidStateTransitions();
@@ -14,6 +17,7 @@ void StateManagerTest::runAllTests() {
     testIntegrationWithControllers();
     
     Serial.println("=== StateManager Tests Complete ===");
+    return failureCount == 0;
 }
 
 void StateManagerTest::testInitialState() {
@@ -5,7 +5,8 @@
 
 class StateManagerTest {
 public:
-    static void runAllTests();
+    // 返回所有断言是否通过
+    static bool runAllTests();
     
 private:
     static void testInitialState();
@@ -15,11 +16,14 @@ private:
     static void testStateHistory();
     static void testStateNames();
     static void testIntegrationWithControllers();
+    
+    static uint32_t failureCount;   // 本次运行失败的断言数
 };
 
 // 测试辅助宏 - 使用自定义前缀避免与Unity框架冲突
 #define SM_TEST_ASSERT_EQUAL(expected, actual) \
     if ((expected) != (actual)) { \
+        StateManagerTest::failureCount++; \
         Serial.printf("TEST FAILED: Expected %d, got %d at %s:%d\n", \
                      (int)(expected), (int)(actual), __FILE__, __LINE__); \
     } else { \
@@ -28,6 +32,7 @@ private:
 
 #define SM_TEST_ASSERT_TRUE(condition) \
     if (!(condition)) { \
+        StateManagerTest::failureCount++; \
         Serial.printf("TEST FAILED: Expected true, got false at %s:%d\n", \
                      __FILE__, __LINE__); \
     } else { \
@@ -36,6 +41,7 @@ private:
 
 #define SM_TEST_ASSERT_FALSE(condition) \
     if (condition) { \
+        StateManagerTest::failureCount++; \
         Serial.printf("TEST FAILED: Expected false, got true at %s:%d\n", \
                      __FILE__, __LINE__); \
     } else { \
@@ -44,6 +50,7 @@ private:
 
 #define SM_TEST_ASSERT_EQUAL_STRING(expected, actual) \
     if (String(expected) != String(actual)) { \
+        StateManagerTest::failureCount++; \
         Serial.printf("TEST FAILED: Expected '%s', got '%s' at %s:%d\n", \
                      expected, actual, __FILE__, __LINE__); \
     } else { \
@@ -0,0 +1,211 @@
+#include "StaticEventBusTest.h"
+#include "../common/Logger.h"
+#include "../common/StaticEventBus.h"
+#include "../common/TypedEvents.h"
+
+namespace {
+
+/**
+ * 记录调用顺序的订阅者
+ */
+struct RecordingSubscriber {
+    char log[16];
+    uint8_t length;
+    char id;
+
+    explicit RecordingSubscriber(char subscriberId) : length(0), id(subscriberId) {
+        log[0] = '\0';
+    }
+
+    void record(char event) {
+        if (static_cast<size_t>(length) + 2 < sizeof(log)) {
+            log[length++] = id;
+            log[length++] = event;
+            log[length] = '\0';
+        }
+    }
+};
+
+struct MotorSubscriber : RecordingSubscriber {
+    int32_t lastCycles;
+    MotorSubscriber(char subscriberId) : RecordingSubscriber(subscriberId), lastCycles(-1) {}
+    void onEvent(const MotorStopEvent& event) {
+        lastCycles = event.cycleCount;
+        record('S');
+    }
+    void onEvent(const MotorSpeedChangedEvent&) { record('V'); }
+};
+
+struct StopOnlySubscriber : RecordingSubscriber {
+    StopOnlySubscriber(char subscriberId) : RecordingSubscriber(subscriberId) {}
+    void onEvent(const MotorStopEvent&) { record('S'); }
+};
+
+// 没有EventTraits的事件：只在编译期总线内使用
+struct LocalOnlyEvent {
+    int value;
+};
+
+/**
+ * 基准用订阅者：volatile累加，保证每次发布都有一次真实写入
+ */
+struct CountingSubscriber {
+    volatile int32_t sum;
+    CountingSubscriber() : sum(0) {}
+    void onEvent(const MotorStopEvent& event) { sum += event.cycleCount; }
+};
+
+// 两种实现的一次计时，结果为每次发布的平均周期数
+template <typename Publish>
+float measureCycles(Publish publish, uint32_t iterations) {
+    uint32_t start = ESP.getCycleCount();
+    for (uint32_t i = 0; i < iterations; i++) {
+        publish(static_cast<int32_t>(i));
+    }
+    return static_cast<float>(ESP.getCycleCount() - start) / iterations;
+}
+
+} // namespace
+
+bool StaticEventBusTest::runAllTests() {
+    LOG_TAG_INFO("StaticBusTest", "开始编译期事件总线测试...");
+
+    bool allPassed = true;
+
+    if (!testDispatch()) {
+        LOG_TAG_ERROR("StaticBusTest", "❌ 编译期分发测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("StaticBusTest", "✅ 编译期分发测试通过");
+    }
+
+    if (!testBridge()) {
+        LOG_TAG_ERROR("StaticBusTest", "❌ EventManager桥接测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("StaticBusTest", "✅ EventManager桥接测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("StaticBusTest", "🎉 所有编译期事件总线测试通过!");
+    } else {
+        LOG_TAG_ERROR("StaticBusTest", "💥 部分编译期事件总线测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool StaticEventBusTest::testDispatch() {
+    typedef StaticEventBus<MotorSubscriber, StopOnlySubscriber> Bus;
+    static_assert(Bus::handles<MotorStopEvent>(), "两个订阅者都处理MotorStopEvent");
+    static_assert(Bus::handles<MotorSpeedChangedEvent>(), "MotorSubscriber处理MotorSpeedChangedEvent");
+    static_assert(!Bus::handles<LocalOnlyEvent>(), "没有订阅者处理LocalOnlyEvent");
+    static_assert(Bus::subscriberCount() == 2, "订阅者数量");
+    static_assert(StaticEventBus<EventManagerBridge>::handles<ErrorEvent>(), "桥接处理有EventTraits的事件");
+    static_assert(!StaticEventBus<EventManagerBridge>::handles<LocalOnlyEvent>(), "桥接忽略没有EventTraits的事件");
+
+    MotorSubscriber motor('a');
+    StopOnlySubscriber stopOnly('b');
+    Bus bus(motor, stopOnly);
+
+    bus.publish(MotorStopEvent{12});
+    bus.publish(MotorSpeedChangedEvent{100000, 50});
+    bus.publish(LocalOnlyEvent{1});
+
+    // 按模板参数顺序调用，未处理的事件被忽略
+    if (strcmp(motor.log, "aSaV") != 0 || strcmp(stopOnly.log, "bS") != 0 || motor.lastCycles != 12) {
+        LOG_TAG_ERROR("StaticBusTest", "分发结果错误: %s / %s", motor.log, stopOnly.log);
+        return false;
+    }
+
+    return true;
+}
+
+bool StaticEventBusTest::testBridge() {
+    EventManager& manager = EventManager::getInstance();
+    manager.initialize();
+    manager.clearQueue();
+
+    int runtimeCalls = 0;
+    char message[EVENT_MESSAGE_MAX_LENGTH] = "";
+    EventSource source = EventSource::UNKNOWN;
+    EventSubscription subscription = manager.subscribe(EventType::MOTOR_STOP,
+        [&runtimeCalls, &message, &source](const EventData& event) {
+            runtimeCalls++;
+            source = event.source;
+            event.formatMessage(message, sizeof(message));
+        });
+
+    MotorSubscriber motor('a');
+    EventManagerBridge bridge;
+    StaticEventBus<MotorSubscriber, EventManagerBridge> bus(motor, bridge);
+    bus.publish(MotorStopEvent{42});
+
+    bool passed = true;
+    if (runtimeCalls != 1 || motor.lastCycles != 42 || source != EventSource::MOTOR_CONTROLLER ||
+        strcmp(message, "电机停止，循环次数: 42") != 0) {
+        LOG_TAG_ERROR("StaticBusTest", "同步桥接错误: calls=%d message=%s", runtimeCalls, message);
+        passed = false;
+    }
+
+    // 异步桥接：处理队列后才到达运行时监听器
+    EventManagerBridge asyncBridge(true);
+    StaticEventBus<EventManagerBridge> asyncBus(asyncBridge);
+    asyncBus.publish(MotorStopEvent{43});
+    if (passed && (runtimeCalls != 1 || manager.getQueueSize() != 1)) {
+        LOG_TAG_ERROR("StaticBusTest", "异步桥接不应立即分发");
+        passed = false;
+    }
+    manager.processEvents();
+    if (passed && (runtimeCalls != 2 || strcmp(message, "电机停止，循环次数: 43") != 0)) {
+        LOG_TAG_ERROR("StaticBusTest", "异步桥接错误: calls=%d message=%s", runtimeCalls, message);
+        passed = false;
+    }
+
+    manager.unsubscribe(subscription);
+    return passed;
+}
+
+bool StaticEventBusTest::runBenchmark() {
+    const uint32_t iterations = 20000;
+    LOG_TAG_INFO("StaticBusTest", "开始事件发布周期数测试（每组%lu次发布）...", iterations);
+
+    EventManager& manager = EventManager::getInstance();
+    manager.initialize();
+    manager.clearQueue();
+    manager.unsubscribeAll(EventType::MOTOR_STOP);
+
+    CountingSubscriber s1, s2, s3, s4;
+    volatile int32_t runtimeSum = 0;
+    auto runtimeListener = [&runtimeSum](const EventData& event) { runtimeSum += event.payload.ints[0]; };
+
+    // 1个订阅者
+    StaticEventBus<CountingSubscriber> bus1(s1);
+    float static1 = measureCycles([&bus1](int32_t i) { bus1.publish(MotorStopEvent{i}); }, iterations);
+    manager.subscribe(EventType::MOTOR_STOP, runtimeListener);
+    float runtime1 = measureCycles([&manager](int32_t i) {
+        manager.publish(EventData(EventType::MOTOR_STOP, EventSource::MOTOR_CONTROLLER).withInts(i));
+    }, iterations);
+
+    // 4个订阅者
+    StaticEventBus<CountingSubscriber, CountingSubscriber, CountingSubscriber, CountingSubscriber> bus4(s1, s2, s3, s4);
+    float static4 = measureCycles([&bus4](int32_t i) { bus4.publish(MotorStopEvent{i}); }, iterations);
+    for (int i = 0; i < 3; i++) {
+        manager.subscribe(EventType::MOTOR_STOP, runtimeListener);
+    }
+    float runtime4 = measureCycles([&manager](int32_t i) {
+        manager.publish(EventData(EventType::MOTOR_STOP, EventSource::MOTOR_CONTROLLER).withInts(i));
+    }, iterations);
+
+    // 编译期订阅者 + 经桥接的运行时监听器（4个）
+    EventManagerBridge bridge;
+    StaticEventBus<CountingSubscriber, EventManagerBridge> bridged(s1, bridge);
+    float bridged4 = measureCycles([&bridged](int32_t i) { bridged.publish(MotorStopEvent{i}); }, iterations);
+    manager.unsubscribeAll(EventType::MOTOR_STOP);
+
+    LOG_TAG_INFO("StaticBusTest", "1个订阅者: 编译期总线 %.1f 周期/次, EventManager %.1f 周期/次", static1, runtime1);
+    LOG_TAG_INFO("StaticBusTest", "4个订阅者: 编译期总线 %.1f 周期/次, EventManager %.1f 周期/次", static4, runtime4);
+    LOG_TAG_INFO("StaticBusTest", "编译期订阅者+桥接4个运行时监听器: %.1f 周期/次", bridged4);
+
+    return s1.sum != 0 && runtimeSum != 0;
+}
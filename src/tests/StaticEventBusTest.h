@@ -0,0 +1,37 @@
+#ifndef STATIC_EVENT_BUS_TEST_H
+#define STATIC_EVENT_BUS_TEST_H
+
+#include <Arduino.h>
+
+/**
+ * 编译期事件总线测试（设备和native环境均可运行）
+ */
+class StaticEventBusTest {
+public:
+    /**
+     * 运行所有编译期事件总线测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试事件只交给有对应onEvent的订阅者，并按订阅者顺序调用
+     * @return 测试是否通过
+     */
+    static bool testDispatch();
+
+    /**
+     * 测试EventManagerBridge把类型化事件转发给运行时监听器
+     * @return 测试是否通过
+     */
+    static bool testBridge();
+
+    /**
+     * 每次发布的CPU周期数：编译期总线与EventManager::publish()对比
+     * 设备上为ESP.getCycleCount()，native环境为TSC计数
+     * @return 基准是否完成
+     */
+    static bool runBenchmark();
+};
+
+#endif // STATIC_EVENT_BUS_TEST_H
@@ -0,0 +1,357 @@
+#include "StatusModelTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <ArduinoJson.h>
+#include "../common/Config.h"
+#include "../common/StatusModel.h"
+#include "../common/Logger.h"
+#include "../controllers/ConfigManager.h"
+#include "../controllers/MotorBLEServer.h"
+
+namespace {
+
+// 测试字段
+const uint8_t FIELD_STATE = 0;
+const uint8_t FIELD_HEAP = 1;
+const uint8_t FIELD_REMAINING = 2;
+const uint8_t FIELD_UPTIME = 3;
+
+const uint32_t MIN_INTERVAL_MS = 200;
+const uint32_t MAX_INTERVAL_MS = 5000;
+
+void defineFields(StatusModel& model) {
+    model.defineField(FIELD_STATE, StatusModel::FieldKind::VALUE);
+    model.defineField(FIELD_HEAP, StatusModel::FieldKind::VALUE, 1024);
+    model.defineField(FIELD_REMAINING, StatusModel::FieldKind::COUNTDOWN, 50);
+    model.defineField(FIELD_UPTIME, StatusModel::FieldKind::COUNTUP, 50);
+    model.setIntervals(MIN_INTERVAL_MS, MAX_INTERVAL_MS);
+}
+
+/**
+ * 发送一次初始关键帧，使模型与客户端同步
+ */
+void syncModel(StatusModel& model, uint64_t nowMs) {
+    model.set(FIELD_STATE, 0, nowMs);
+    model.set(FIELD_HEAP, 200000, nowMs);
+    model.set(FIELD_REMAINING, 10000, nowMs);
+    model.set(FIELD_UPTIME, (int64_t)nowMs, nowMs);
+    model.markSent(model.poll(nowMs), nowMs);
+}
+
+} // namespace
+
+bool StatusModelTest::runAllTests() {
+    LOG_TAG_INFO("StatusModelTest", "开始状态通知测试...");
+
+    bool allPassed = true;
+
+    if (!testDirtyTracking()) {
+        LOG_TAG_ERROR("StatusModelTest", "❌ 脏位测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("StatusModelTest", "✅ 脏位测试通过");
+    }
+
+    if (!testTimedFields()) {
+        LOG_TAG_ERROR("StatusModelTest", "❌ 计时字段测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("StatusModelTest", "✅ 计时字段测试通过");
+    }
+
+    if (!testIntervals()) {
+        LOG_TAG_ERROR("StatusModelTest", "❌ 通知节奏测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("StatusModelTest", "✅ 通知节奏测试通过");
+    }
+
+    if (!testKeyframes()) {
+        LOG_TAG_ERROR("StatusModelTest", "❌ 关键帧测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("StatusModelTest", "✅ 关键帧测试通过");
+    }
+
+    if (!testServerNotifications()) {
+        LOG_TAG_ERROR("StatusModelTest", "❌ BLE服务器状态通知测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("StatusModelTest", "✅ BLE服务器状态通知测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("StatusModelTest", "🎉 所有状态通知测试通过!");
+    } else {
+        LOG_TAG_ERROR("StatusModelTest", "💥 部分状态通知测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool StatusModelTest::testDirtyTracking() {
+    StatusModel model;
+    defineFields(model);
+    uint64_t now = 1000;
+
+    // 客户端还没有任何状态：立即发送关键帧，不受最小间隔限制
+    if (model.poll(now) != StatusModel::Notify::KEYFRAME || model.getMsUntilNextNotify(now) != 0) {
+        LOG_TAG_ERROR("StatusModelTest", "首次通知应为关键帧");
+        return false;
+    }
+    syncModel(model, now);
+    if (model.getDirtyMask() != 0 || model.getSequence() != 1 || model.getKeyframeCount() != 1) {
+        LOG_TAG_ERROR("StatusModelTest", "关键帧发出后应清除脏位");
+        return false;
+    }
+
+    // 值不变、变化在死区内：不通知
+    now += 1000;
+    model.set(FIELD_STATE, 0, now);
+    model.set(FIELD_HEAP, 200000 - 1000, now);
+    if (model.getDirtyMask() != 0 || model.poll(now) != StatusModel::Notify::NONE) {
+        LOG_TAG_ERROR("StatusModelTest", "未超出死区的变化不应通知");
+        return false;
+    }
+
+    // 超出死区：只有变化的字段进入增量
+    model.set(FIELD_STATE, 1, now);
+    model.set(FIELD_HEAP, 200000 - 2000, now);
+    if (model.getDirtyMask() != ((1u << FIELD_STATE) | (1u << FIELD_HEAP)) ||
+        model.poll(now) != StatusModel::Notify::DELTA) {
+        LOG_TAG_ERROR("StatusModelTest", "脏字段掩码错误: 0x%08X", model.getDirtyMask());
+        return false;
+    }
+
+    // 发送前变回原值：不再需要发送
+    model.set(FIELD_HEAP, 200000, now);
+    if (model.getDirtyMask() != (1u << FIELD_STATE)) {
+        LOG_TAG_ERROR("StatusModelTest", "变回原值的字段应清除脏位");
+        return false;
+    }
+
+    model.markSent(StatusModel::Notify::DELTA, now);
+    if (model.getDirtyMask() != 0 || model.getSequence() != 2 || model.getDeltaCount() != 1) {
+        LOG_TAG_ERROR("StatusModelTest", "增量发出后应清除脏位并增加序号");
+        return false;
+    }
+
+    // 强制发送的字段即使值未变也进入增量
+    model.markDirty(FIELD_STATE);
+    return model.getDirtyMask() == (1u << FIELD_STATE);
+}
+
+bool StatusModelTest::testTimedFields() {
+    StatusModel model;
+    defineFields(model);
+    uint64_t now = 5000;
+    syncModel(model, now);
+
+    // 稳定计时：剩余时间随时间减少、运行时间随时间增加，客户端可以推算，不产生增量
+    for (uint32_t step = 1; step <= 8; step++) {
+        uint64_t t = now + step * 1000;
+        model.set(FIELD_REMAINING, 10000 - step * 1000, t);
+        model.set(FIELD_UPTIME, (int64_t)t, t);
+        if (model.getDirtyMask() != 0) {
+            LOG_TAG_ERROR("StatusModelTest", "稳定计时不应产生增量 (第%lu秒)", (unsigned long)step);
+            return false;
+        }
+    }
+
+    // 倒计时到0后保持0（客户端推算也停在0）
+    model.set(FIELD_REMAINING, 0, now + 15000);
+    if (model.getDirtyMask() != 0) {
+        LOG_TAG_ERROR("StatusModelTest", "倒计时结束后保持0不应产生增量");
+        return false;
+    }
+
+    // 阶段切换：剩余时间跳变
+    now += 15000;
+    model.set(FIELD_REMAINING, 20000, now);
+    if (model.getDirtyMask() != (1u << FIELD_REMAINING)) {
+        LOG_TAG_ERROR("StatusModelTest", "剩余时间跳变应产生增量");
+        return false;
+    }
+    model.markSent(model.poll(now), now);
+
+    // 以新的发出值为起点继续推算；误差在死区内不通知，暂停（剩余时间不再减少）超出死区后通知
+    model.set(FIELD_REMAINING, 20000 - 1000 + 40, now + 1000);
+    if (model.getDirtyMask() != 0) {
+        LOG_TAG_ERROR("StatusModelTest", "死区内的计时误差不应产生增量");
+        return false;
+    }
+    model.set(FIELD_REMAINING, 20000, now + 2000);
+    if (model.getDirtyMask() != (1u << FIELD_REMAINING)) {
+        LOG_TAG_ERROR("StatusModelTest", "计时暂停应产生增量");
+        return false;
+    }
+    return true;
+}
+
+bool StatusModelTest::testIntervals() {
+    StatusModel model;
+    defineFields(model);
+    uint64_t now = 0;
+    syncModel(model, now);
+
+    // 无变化：等到心跳
+    if (model.getMsUntilNextNotify(now) != MAX_INTERVAL_MS) {
+        LOG_TAG_ERROR("StatusModelTest", "无变化时应等到心跳间隔");
+        return false;
+    }
+
+    // 最小间隔内的变化被推迟并合并
+    now += 50;
+    model.set(FIELD_STATE, 1, now);
+    if (model.poll(now) != StatusModel::Notify::NONE || model.getMsUntilNextNotify(now) != MIN_INTERVAL_MS - 50 ||
+        model.getMsUntilAllowed(now) != MIN_INTERVAL_MS - 50) {
+        LOG_TAG_ERROR("StatusModelTest", "最小间隔内不应通知");
+        return false;
+    }
+    now += 100;
+    model.set(FIELD_STATE, 2, now);
+    model.set(FIELD_HEAP, 100000, now);
+    now += 50;
+    if (model.poll(now) != StatusModel::Notify::DELTA ||
+        model.getDirtyMask() != ((1u << FIELD_STATE) | (1u << FIELD_HEAP))) {
+        LOG_TAG_ERROR("StatusModelTest", "最小间隔到期后应发送合并的增量");
+        return false;
+    }
+    model.markSent(StatusModel::Notify::DELTA, now);
+    if (model.get(FIELD_STATE) != 2) {
+        return false;
+    }
+
+    // 长时间无变化：最大间隔到期时发送空的增量作为心跳
+    if (model.poll(now + MAX_INTERVAL_MS - 1) != StatusModel::Notify::NONE ||
+        model.poll(now + MAX_INTERVAL_MS) != StatusModel::Notify::DELTA || model.getDirtyMask() != 0) {
+        LOG_TAG_ERROR("StatusModelTest", "心跳时间错误");
+        return false;
+    }
+    uint16_t sequence = model.getSequence();
+    now += MAX_INTERVAL_MS;
+    model.markSent(StatusModel::Notify::DELTA, now);
+    if (model.getSequence() != (uint16_t)(sequence + 1)) {
+        LOG_TAG_ERROR("StatusModelTest", "心跳也应增加序号");
+        return false;
+    }
+
+    // 不发送心跳时，无变化就不需要唤醒
+    model.setIntervals(MIN_INTERVAL_MS, 0);
+    if (model.getMsUntilNextNotify(now) != StatusModel::NO_NOTIFY ||
+        model.poll(now + 3600000) != StatusModel::Notify::NONE) {
+        LOG_TAG_ERROR("StatusModelTest", "关闭心跳后无变化不应通知");
+        return false;
+    }
+    return true;
+}
+
+bool StatusModelTest::testKeyframes() {
+    const uint16_t KEYFRAME_INTERVAL = 3;
+    StatusModel model;
+    defineFields(model);
+    model.setKeyframeInterval(KEYFRAME_INTERVAL);
+    uint64_t now = 0;
+    syncModel(model, now);
+
+    // 每N次增量后发送一次关键帧
+    for (uint16_t i = 0; i < KEYFRAME_INTERVAL * 2; i++) {
+        now += MIN_INTERVAL_MS;
+        model.set(FIELD_STATE, i + 1, now);
+        StatusModel::Notify expected = (i == KEYFRAME_INTERVAL) ? StatusModel::Notify::KEYFRAME
+                                                                : StatusModel::Notify::DELTA;
+        StatusModel::Notify kind = model.poll(now);
+        if (kind != expected) {
+            LOG_TAG_ERROR("StatusModelTest", "第%u次通知类型错误", (unsigned)i + 1);
+            return false;
+        }
+        model.markSent(kind, now);
+    }
+    if (model.getKeyframeCount() != 2 || model.getDeltaCount() != KEYFRAME_INTERVAL * 2 - 1) {
+        LOG_TAG_ERROR("StatusModelTest", "关键帧/增量计数错误");
+        return false;
+    }
+
+    // 请求关键帧：即使没有变化也在最小间隔后发送
+    model.requestKeyframe();
+    if (model.poll(now) != StatusModel::Notify::NONE || model.poll(now + MIN_INTERVAL_MS) != StatusModel::Notify::KEYFRAME) {
+        LOG_TAG_ERROR("StatusModelTest", "请求的关键帧应在最小间隔后发送");
+        return false;
+    }
+    now += MIN_INTERVAL_MS;
+    model.markSent(StatusModel::Notify::KEYFRAME, now);
+
+    // 重新连接：客户端状态未知，立即发送关键帧，序号延续
+    uint16_t sequence = model.getSequence();
+    model.set(FIELD_STATE, 42, now);
+    model.reset();
+    if (model.getDirtyMask() != 0 || model.poll(now) != StatusModel::Notify::KEYFRAME) {
+        LOG_TAG_ERROR("StatusModelTest", "重置后应立即发送关键帧");
+        return false;
+    }
+    model.markSent(StatusModel::Notify::KEYFRAME, now);
+    model.set(FIELD_STATE, 42, now + MIN_INTERVAL_MS);
+    return model.getSequence() == (uint16_t)(sequence + 1) && model.getDirtyMask() == 0;
+}
+
+bool StatusModelTest::testServerNotifications() {
+    MotorBLEServer& bleServer = MotorBLEServer::getInstance();
+    uint32_t originalRunMs = ConfigManager::getInstance().getConfig().runDurationMs;
+    uint32_t newRunMs = originalRunMs == 7000 ? 8000 : 7000;
+    char json[MotorBLEServer::STATUS_JSON_BUFFER_SIZE];
+    size_t length = 0;
+    bool passed = false;
+
+    do {
+        // 心跳到期：一定有通知（首次为关键帧）
+        NativeHAL::advanceMicros((uint64_t)BLE_STATUS_MAX_NOTIFY_INTERVAL_MS * 1000);
+        if ((length = bleServer.pollStatusNotification(json, sizeof(json))) == 0) {
+            LOG_TAG_ERROR("StatusModelTest", "心跳到期应发送通知");
+            break;
+        }
+        LOG_TAG_INFO("StatusModelTest", "同步通知 %u字节: %s", (unsigned)length, json);
+
+        // 无变化：不通知（运行时间、剩余时间由客户端推算）
+        if (bleServer.pollStatusNotification(json, sizeof(json)) > 0) {
+            LOG_TAG_ERROR("StatusModelTest", "无变化时不应通知: %s", json);
+            break;
+        }
+        NativeHAL::advanceMicros(3000000);
+        if (bleServer.pollStatusNotification(json, sizeof(json)) > 0) {
+            LOG_TAG_ERROR("StatusModelTest", "稳定计时不应通知: %s", json);
+            break;
+        }
+
+        // 修改运行时长：增量只含运行时长字段
+        uint16_t sequence = bleServer.getStatusModel().getSequence();
+        bleServer.handleRunDurationWrite(MotorBLEServer::formatDurationSeconds(newRunMs).c_str());
+        if ((length = bleServer.pollStatusNotification(json, sizeof(json))) == 0) {
+            LOG_TAG_ERROR("StatusModelTest", "配置变化后应发送增量");
+            break;
+        }
+        LOG_TAG_INFO("StatusModelTest", "增量通知 %u字节: %s", (unsigned)length, json);
+
+        DynamicJsonDocument doc(768);
+        if (deserializeJson(doc, json, length) || strcmp(doc["type"] | "", "delta") != 0 ||
+            doc["seq"].as<uint16_t>() != sequence || doc["runDurationMs"].as<uint32_t>() != newRunMs ||
+            doc.containsKey("cycleCount") || doc.containsKey("uptime") || doc.containsKey("stateName")) {
+            LOG_TAG_ERROR("StatusModelTest", "增量内容错误: %s", json);
+            break;
+        }
+
+        // 完整状态JSON仍包含全部字段
+        String full = bleServer.generateStatusJson();
+        if (full.indexOf("\"uptime\"") < 0 || full.indexOf("\"cycleCount\"") < 0 || full.length() <= length) {
+            LOG_TAG_ERROR("StatusModelTest", "完整状态JSON缺少字段");
+            break;
+        }
+        passed = true;
+    } while (false);
+
+    bleServer.handleRunDurationWrite(MotorBLEServer::formatDurationSeconds(originalRunMs).c_str());
+    return passed;
+}
+
+#endif // NATIVE_BUILD
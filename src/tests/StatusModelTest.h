@@ -0,0 +1,52 @@
+#ifndef STATUS_MODEL_TEST_H
+#define STATUS_MODEL_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * 变化驱动状态通知测试（StatusModel和BLE服务器的增量通知，仅在native环境运行）
+ */
+class StatusModelTest {
+public:
+    /**
+     * 运行所有状态通知测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试脏位：首次通知为关键帧，之后只有超出死区的变化才进入增量
+     * @return 测试是否通过
+     */
+    static bool testDirtyTracking();
+
+    /**
+     * 测试计时字段：按经过时间推算的值不产生增量，跳变才产生增量
+     * @return 测试是否通过
+     */
+    static bool testTimedFields();
+
+    /**
+     * 测试通知节奏：最小间隔合并变化，最大间隔发送心跳
+     * @return 测试是否通过
+     */
+    static bool testIntervals();
+
+    /**
+     * 测试关键帧：每N次增量、requestKeyframe()和reset()后发送完整状态
+     * @return 测试是否通过
+     */
+    static bool testKeyframes();
+
+    /**
+     * 测试MotorBLEServer的状态通知：无变化时不通知，配置变化只发送相关字段
+     * @return 测试是否通过
+     */
+    static bool testServerNotifications();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // STATUS_MODEL_TEST_H
@@ -0,0 +1,208 @@
+#include "StatusPacketTest.h"
+
+#ifdef NATIVE_BUILD
+
+#include <NativeHAL.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "../common/Config.h"
+#include "../common/StatusPacket.h"
+#include "../common/Logger.h"
+#include "../controllers/ConfigManager.h"
+#include "../controllers/MotorBLEServer.h"
+#include "../controllers/MotorController.h"
+
+namespace {
+
+// 默认ATT MTU 23，单次通知负载20字节
+const size_t DEFAULT_ATT_PAYLOAD = 20;
+
+} // namespace
+
+bool StatusPacketTest::runAllTests() {
+    LOG_TAG_INFO("StatusPacketTest", "开始二进制状态包测试...");
+
+    bool allPassed = true;
+
+    if (!testEncodeDecode()) {
+        LOG_TAG_ERROR("StatusPacketTest", "❌ 编解码测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("StatusPacketTest", "✅ 编解码测试通过");
+    }
+
+    if (!testVersioning()) {
+        LOG_TAG_ERROR("StatusPacketTest", "❌ 版本兼容测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("StatusPacketTest", "✅ 版本兼容测试通过");
+    }
+
+    if (!testServerPacket()) {
+        LOG_TAG_ERROR("StatusPacketTest", "❌ BLE服务器状态包测试失败");
+        allPassed = false;
+    } else {
+        LOG_TAG_INFO("StatusPacketTest", "✅ BLE服务器状态包测试通过");
+    }
+
+    if (allPassed) {
+        LOG_TAG_INFO("StatusPacketTest", "🎉 所有二进制状态包测试通过!");
+    } else {
+        LOG_TAG_ERROR("StatusPacketTest", "💥 部分二进制状态包测试失败!");
+    }
+
+    return allPassed;
+}
+
+bool StatusPacketTest::testEncodeDecode() {
+    StatusPacket packet = {};
+    packet.version = 0;     // 编码时忽略，固定写入当前版本
+    packet.sequence = 0x1234;
+    packet.state = 1;
+    packet.flags = StatusPacket::FLAG_RUNNING | StatusPacket::FLAG_OUTPUT_VALID;
+    packet.errors = StatusPacket::ERROR_SPEED_CONTROLLER;
+    packet.remainingMs = 0x01020304;
+    packet.cycleCount = 0xA0B0C0D0;
+    packet.frequency = 100000;
+    packet.dutyPermille = 755;
+
+    uint8_t buffer[32];
+    memset(buffer, 0xEE, sizeof(buffer));
+    if (StatusPacketCodec::encode(packet, buffer, sizeof(buffer)) != StatusPacket::SIZE ||
+        StatusPacket::SIZE > DEFAULT_ATT_PAYLOAD) {
+        LOG_TAG_ERROR("StatusPacketTest", "编码长度错误");
+        return false;
+    }
+
+    const uint8_t expected[StatusPacket::SIZE] = {
+        0x01,                       // 版本
+        0x34, 0x12,                 // 序号
+        0x01,                       // 状态
+        0x11,                       // 状态标志
+        0x02,                       // 错误标志
+        0x04, 0x03, 0x02, 0x01,     // 剩余时间
+        0xD0, 0xC0, 0xB0, 0xA0,     // 循环次数
+        0xA0, 0x86, 0x01, 0x00,     // 频率 100000
+        0xF3, 0x02                  // 占空比 75.5%
+    };
+    if (memcmp(buffer, expected, sizeof(expected)) != 0 || buffer[StatusPacket::SIZE] != 0xEE) {
+        LOG_TAG_ERROR("StatusPacketTest", "编码布局错误");
+        return false;
+    }
+
+    StatusPacket decoded;
+    if (!StatusPacketCodec::decode(buffer, StatusPacket::SIZE, decoded) || decoded.version != StatusPacket::VERSION ||
+        decoded.sequence != packet.sequence || decoded.state != packet.state || decoded.flags != packet.flags ||
+        decoded.errors != packet.errors || decoded.remainingMs != packet.remainingMs ||
+        decoded.cycleCount != packet.cycleCount || decoded.frequency != packet.frequency ||
+        decoded.dutyPermille != packet.dutyPermille) {
+        LOG_TAG_ERROR("StatusPacketTest", "解码结果与原值不一致");
+        return false;
+    }
+
+    // 缓冲区不足时不写入
+    uint8_t small[StatusPacket::SIZE - 1];
+    if (StatusPacketCodec::encode(packet, small, sizeof(small)) != 0 ||
+        StatusPacketCodec::encode(packet, nullptr, 64) != 0) {
+        LOG_TAG_ERROR("StatusPacketTest", "缓冲区不足时应返回0");
+        return false;
+    }
+    return true;
+}
+
+bool StatusPacketTest::testVersioning() {
+    StatusPacket packet = {};
+    packet.sequence = 7;
+    packet.frequency = 1000;
+    uint8_t buffer[StatusPacket::SIZE + 4];
+    StatusPacketCodec::encode(packet, buffer, sizeof(buffer));
+
+    // 更高版本在末尾追加字段：已知字段照常解码
+    buffer[0] = StatusPacket::VERSION + 1;
+    buffer[StatusPacket::SIZE] = 0x55;
+    StatusPacket decoded;
+    if (!StatusPacketCodec::decode(buffer, sizeof(buffer), decoded) ||
+        decoded.version != StatusPacket::VERSION + 1 || decoded.sequence != 7 || decoded.frequency != 1000) {
+        LOG_TAG_ERROR("StatusPacketTest", "应接受追加字段的高版本");
+        return false;
+    }
+
+    // 过短（例如被截断）或版本0的数据无效
+    if (StatusPacketCodec::decode(buffer, StatusPacket::SIZE - 1, decoded) ||
+        StatusPacketCodec::decode(nullptr, StatusPacket::SIZE, decoded)) {
+        LOG_TAG_ERROR("StatusPacketTest", "过短的数据应被拒绝");
+        return false;
+    }
+    buffer[0] = 0;
+    if (StatusPacketCodec::decode(buffer, sizeof(buffer), decoded)) {
+        LOG_TAG_ERROR("StatusPacketTest", "版本0应被拒绝");
+        return false;
+    }
+    return true;
+}
+
+bool StatusPacketTest::testServerPacket() {
+    MotorBLEServer& bleServer = MotorBLEServer::getInstance();
+    MotorController& motorController = MotorController::getInstance();
+
+    uint8_t first[StatusPacket::SIZE];
+    uint8_t second[StatusPacket::SIZE];
+    if (bleServer.generateStatusPacket(first, sizeof(first)) != StatusPacket::SIZE ||
+        bleServer.generateStatusPacket(second, sizeof(second)) != StatusPacket::SIZE) {
+        LOG_TAG_ERROR("StatusPacketTest", "状态包长度错误");
+        return false;
+    }
+
+    StatusPacket a;
+    StatusPacket b;
+    if (!StatusPacketCodec::decode(first, sizeof(first), a) || !StatusPacketCodec::decode(second, sizeof(second), b) ||
+        b.sequence != a.sequence) {
+        LOG_TAG_ERROR("StatusPacketTest", "生成状态包（读取）不应推进序号");
+        return false;
+    }
+
+    // 字段与控制器状态一致（虚拟时钟未推进，两次读取之间状态不变）
+    bool running = motorController.isRunning();
+    uint32_t remaining = running ? motorController.getRemainingRunTimeMs() : motorController.getRemainingStopTimeMs();
+    bool pwm = motorController.getPWMController() != nullptr;
+    if (b.state != static_cast<uint8_t>(motorController.getCurrentState()) ||
+        ((b.flags & StatusPacket::FLAG_RUNNING) != 0) != running ||
+        ((b.flags & StatusPacket::FLAG_AUTO_START) != 0) != ConfigManager::getInstance().getConfig().autoStart ||
+        ((b.flags & StatusPacket::FLAG_PWM_OUTPUT) != 0) != pwm ||
+        b.cycleCount != motorController.getCurrentCycleCount() || b.remainingMs != remaining) {
+        LOG_TAG_ERROR("StatusPacketTest", "状态包字段与控制器状态不一致 (状态%u, 标志0x%02X)", b.state, b.flags);
+        return false;
+    }
+
+    // 只有发送通知推进序号，之后读取返回该通知的序号
+    if (!BLEDevice::getInitialized() && !bleServer.init()) {
+        LOG_TAG_ERROR("StatusPacketTest", "BLE服务器初始化失败: %s", bleServer.getLastError());
+        return false;
+    }
+    NativeHAL::bleReset();
+    NativeHAL::bleConnect();
+    NativeHAL::bleTakeNotifications();
+    bleServer.sendStatusPacketNotification();
+    std::vector<NativeHAL::BLENotification> notifications = NativeHAL::bleTakeNotifications();
+    std::string readValue = NativeHAL::bleRead(BLE_STATUS_BINARY_CHAR_UUID);
+    NativeHAL::bleDisconnect();
+    StatusPacket notified;
+    StatusPacket read;
+    if (notifications.size() != 1 || notifications[0].uuid != BLE_STATUS_BINARY_CHAR_UUID ||
+        !StatusPacketCodec::decode((const uint8_t*)notifications[0].value.data(), notifications[0].value.size(),
+                                   notified) ||
+        !StatusPacketCodec::decode((const uint8_t*)readValue.data(), readValue.size(), read) ||
+        (uint16_t)(notified.sequence - b.sequence) != 1 || read.sequence != notified.sequence) {
+        LOG_TAG_ERROR("StatusPacketTest", "通知应推进序号且读取不推进: 通知%u条", (unsigned)notifications.size());
+        return false;
+    }
+
+    // 同样的信息用JSON表示远超默认MTU的单包负载
+    String json = bleServer.generateStatusJson();
+    LOG_TAG_INFO("StatusPacketTest", "状态JSON %u字节，二进制状态包%u字节",
+                 (unsigned)json.length(), (unsigned)StatusPacket::SIZE);
+    return json.length() > DEFAULT_ATT_PAYLOAD;
+}
+
+#endif // NATIVE_BUILD
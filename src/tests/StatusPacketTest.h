@@ -0,0 +1,40 @@
+#ifndef STATUS_PACKET_TEST_H
+#define STATUS_PACKET_TEST_H
+
+#ifdef NATIVE_BUILD
+
+#include <Arduino.h>
+
+/**
+ * 二进制状态包测试（编解码、版本兼容和BLE服务器生成的状态包，仅在native环境运行）
+ */
+class StatusPacketTest {
+public:
+    /**
+     * 运行所有二进制状态包测试
+     * @return 测试是否全部通过
+     */
+    static bool runAllTests();
+
+    /**
+     * 测试编码布局（小端序、字段偏移）与解码往返
+     * @return 测试是否通过
+     */
+    static bool testEncodeDecode();
+
+    /**
+     * 测试版本规则：接受追加字段的高版本，拒绝版本0和过短的数据
+     * @return 测试是否通过
+     */
+    static bool testVersioning();
+
+    /**
+     * 测试MotorBLEServer生成的状态包：长度在默认MTU内、只有通知推进序号、标志与控制器状态一致
+     * @return 测试是否通过
+     */
+    static bool testServerPacket();
+};
+
+#endif // NATIVE_BUILD
+
+#endif // STATUS_PACKET_TEST_H
@@ -123,6 +123,7 @@ bool TimerTest::testTimerAccuracy() {
             continue;
         }
         
+        uint32_t start_time = millis();
         if (!timer_driver.startTimer(TimerDriver::TIMER_0)) {
             LOG_TAG_ERROR("TimerTest", "启动 %lums 定时器失败", interval);
             result = false;
@@ -135,7 +136,7 @@ bool TimerTest::testTimerAccuracy() {
         waitMs(test_duration);
         
         // 检查精度
-        if (!checkTimerAccuracy(TimerDriver::TIMER_0, interval, 10.0f)) {
+        if (!checkTimerAccuracy(TimerDriver::TIMER_0, interval, start_time, 10.0f)) {
             LOG_TAG_ERROR("TimerTest", "%lums 定时器精度测试失败", interval);
             result = false;
         }
@@ -479,6 +480,7 @@ void TimerTest::waitMs(uint32_t wait_ms) {
 
 bool TimerTest::checkTimerAccuracy(TimerDriver::TimerID timer_id, 
                                   uint32_t expected_interval, 
+                                  uint32_t start_time,
                                   float tolerance_percent) {
     uint32_t trigger_count = timer_driver.getTimerTriggerCount(timer_id);
     if (trigger_count < 2) {
@@ -486,7 +488,8 @@ bool TimerTest::checkTimerAccuracy(TimerDriver::TimerID timer_id,
     }
     
     // 计算平均间隔
-    uint32_t total_time = last_callback_time_0; // 简化处理，使用最后回调时间
+    // 从定时器启动到最后一次回调的时间
+    uint32_t total_time = last_callback_time_0 - start_time;
     float average_interval = (float)total_time / trigger_count;
     
     // 计算误差百分比
@@ -133,11 +133,13 @@ private:
      * 检查定时器精度
      * @param timer_id 定时器ID
      * @param expected_interval 期望间隔(毫秒)
+     * @param start_time 定时器启动时刻(毫秒)
      * @param tolerance_percent 容差百分比
      * @return 精度是否在容差范围内
      */
     bool checkTimerAccuracy(TimerDriver::TimerID timer_id, 
                            uint32_t expected_interval, 
+                           uint32_t start_time,
                            float tolerance_percent = 5.0f);
     
     /**
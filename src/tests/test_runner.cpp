@@ -9,11 +9,15 @@
 #include "../src/tests/MotorControllerTest.h"
 #include "../src/tests/MotorBLEServerTest.h"
 #include "../src/tests/EventManagerTest.h"
+#include "../src/tests/StaticEventBusTest.h"
 #include "../src/tests/StateManagerTest.h"
 #include "../src/tests/MotorCycleTest.h"
 #include "../src/tests/BLEInteractionTest.h"
 #include "../src/tests/ErrorHandlingTest.h"
 #include "../src/tests/ModbusTest.h"
+#include "../src/tests/ModbusCRCTest.h"
+#include "../src/tests/ModbusReceiverTest.h"
+#include "../src/tests/ModbusCacheTest.h"
 
 // 全局对象
 GPIODriver gpioDriver;
@@ -54,7 +58,10 @@ enum TestMode {
     MODBUS_START_MOTOR_TEST_MODE = 22,
     MODBUS_STOP_MOTOR_TEST_MODE = 23,
     MODBUS_GET_ALL_CONFIG_TEST_MODE = 24,
-    MODBUS_CONTINUOUS_GET_ALL_CONFIG_TEST_MODE = 25
+    MODBUS_CONTINUOUS_GET_ALL_CONFIG_TEST_MODE = 25,
+    MODBUS_CRC_TEST_MODE = 26,
+    MODBUS_RECEIVER_TEST_MODE = 27,
+    MODBUS_CACHE_TEST_MODE = 28
 };
 
 // 当前测试模式
@@ -87,6 +94,9 @@ void runModbusStartMotorTests();
 void runModbusStopMotorTests();
 void runModbusGetAllConfigTests();
 void runModbusContinuousGetAllConfigTests();
+void runModbusCRCTests();
+void runModbusReceiverTests();
+void runModbusCacheTests();
 
 void showHelp() {
     Serial.println("\n========================================");
@@ -117,6 +127,9 @@ void showHelp() {
     Serial.println("n. MODBUS停止电机测试");
     Serial.println("o. MODBUS一次性读取所有配置测试");
     Serial.println("p. MODBUS连续读取所有配置测试（每秒一次）");
+    Serial.println("q. MODBUS CRC测试及性能基准");
+    Serial.println("r. MODBUS帧接收器测试");
+    Serial.println("s. MODBUS寄存器缓存测试");
     Serial.println("h. 显示此帮助");
     Serial.println("========================================");
 }
@@ -248,6 +261,18 @@ void loop() {
             case 'P':
                 runModbusContinuousGetAllConfigTests();
                 break;
+            case 'q':
+            case 'Q':
+                runModbusCRCTests();
+                break;
+            case 'r':
+            case 'R':
+                runModbusReceiverTests();
+                break;
+            case 's':
+            case 'S':
+                runModbusCacheTests();
+                break;
             case 'h':
             case 'H':
                 showHelp();
@@ -612,6 +637,8 @@ void runBLEServerTests() {
 void runEventManagerTests() {
     printTestHeader("EventManager测试");
     EventManagerTest::runAllTests();
+    StaticEventBusTest::runAllTests();
+    StaticEventBusTest::runBenchmark();
     Serial.println("✅ EventManager测试完成");
     currentTestMode = EVENT_MANAGER_TEST_MODE;
 }
@@ -789,4 +816,31 @@ void runModbusContinuousGetAllConfigTests() {
     Serial.println("将在loop()中每秒读取一次所有配置");
     Serial.println("输入其他命令可停止测试");
     currentTestMode = MODBUS_CONTINUOUS_GET_ALL_CONFIG_TEST_MODE;
-}
\ No newline at end of file
+}
+/**
+ * 运行MODBUS CRC测试及性能基准
+ */
+void runModbusCRCTests() {
+    printTestHeader("MODBUS CRC测试");
+    ModbusCRCTest::runAllTests();
+    ModbusCRCTest::runBenchmark();
+    currentTestMode = MODBUS_CRC_TEST_MODE;
+}
+
+/**
+ * 运行MODBUS帧接收器测试
+ */
+void runModbusReceiverTests() {
+    printTestHeader("MODBUS帧接收器测试");
+    ModbusReceiverTest::runAllTests();
+    currentTestMode = MODBUS_RECEIVER_TEST_MODE;
+}
+
+/**
+ * 运行MODBUS寄存器缓存测试
+ */
+void runModbusCacheTests() {
+    printTestHeader("MODBUS寄存器缓存测试");
+    ModbusCacheTest::runAllTests();
+    currentTestMode = MODBUS_CACHE_TEST_MODE;
+}